@@ -1345,7 +1345,7 @@ _nc_data_cluster_ncount_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
     _Evald2N evald2n = {cad, ncount, clusterz, clusterm, cosmo};
     g_assert (ncount->z_true);
     g_assert (ncount->lnM_true);
-    ncm_func_eval_threaded_loop_full (&_eval_intp_d2n, 0, ncount->np, &evald2n);
+    ncm_func_eval_parallel_for (&_eval_intp_d2n, 0, ncount->np, 0, &evald2n);
   }
   else
   {
@@ -1355,26 +1355,26 @@ _nc_data_cluster_ncount_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
     if (z_p && lnM_p)
     {
       _Evald2N evald2n = {cad, ncount, clusterz, clusterm, cosmo};
-      ncm_func_eval_threaded_loop_full (&_eval_z_p_lnM_p_d2n, 0, ncount->np, &evald2n);
+      ncm_func_eval_parallel_for (&_eval_z_p_lnM_p_d2n, 0, ncount->np, 0, &evald2n);
     }
     else if (z_p && !lnM_p)
     {
       g_assert (ncount->lnM_true);
       _Evald2N evald2n = {cad, ncount, clusterz, clusterm, cosmo};
-      ncm_func_eval_threaded_loop_full (&_eval_z_p_d2n, 0, ncount->np, &evald2n);
+      ncm_func_eval_parallel_for (&_eval_z_p_d2n, 0, ncount->np, 0, &evald2n);
     }
     else if (!z_p && lnM_p)
     {
       g_assert (ncount->z_true);
       _Evald2N evald2n = {cad, ncount, clusterz, clusterm, cosmo};
-      ncm_func_eval_threaded_loop_full (&_eval_lnM_p_d2n, 0, ncount->np, &evald2n);
+      ncm_func_eval_parallel_for (&_eval_lnM_p_d2n, 0, ncount->np, 0, &evald2n);
     }
     else
     {
       g_assert (ncount->z_true);
       g_assert (ncount->lnM_true);
       _Evald2N evald2n = {cad, ncount, clusterz, clusterm, cosmo};
-      ncm_func_eval_threaded_loop_full (&_eval_d2n, 0, ncount->np, &evald2n);
+      ncm_func_eval_parallel_for (&_eval_d2n, 0, ncount->np, 0, &evald2n);
 
     }
   }
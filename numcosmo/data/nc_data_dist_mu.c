@@ -177,14 +177,8 @@ _nc_data_dist_mu_mean_func (NcmDataGaussDiag *diag, NcmMSet *mset, NcmVector *vp
 {
   NcDataDistMu *dist_mu = NC_DATA_DIST_MU (diag);
   NcHICosmo *cosmo = NC_HICOSMO (ncm_mset_peek (mset, nc_hicosmo_id ()));
-  guint i;
 
-  for (i = 0; i < diag->np; i++)
-  {
-    const gdouble z   = ncm_vector_get (dist_mu->x, i);
-    const gdouble dmu = nc_distance_dmodulus (dist_mu->dist, cosmo, z);
-    ncm_vector_set (vp, i, dmu);
-  }
+  nc_distance_dmodulus_vec (dist_mu->dist, cosmo, dist_mu->x, vp);
 }
 
 static void 
@@ -163,14 +163,9 @@ _nc_data_hubble_mean_func (NcmDataGaussDiag *diag, NcmMSet *mset, NcmVector *vp)
 {
   NcDataHubble *hubble = NC_DATA_HUBBLE (diag);
   NcHICosmo *cosmo = NC_HICOSMO (ncm_mset_peek (mset, nc_hicosmo_id ()));
-  guint i;
 
-  for (i = 0; i < diag->np; i++)
-  {
-    const gdouble z = ncm_vector_get (hubble->x, i);
-    const gdouble H = nc_hicosmo_H (cosmo, z); 
-    ncm_vector_set (vp, i, H);
-  }
+  nc_hicosmo_E_vec (cosmo, hubble->x, vp);
+  ncm_vector_scale (vp, nc_hicosmo_H0 (cosmo));
 }
 
 void 
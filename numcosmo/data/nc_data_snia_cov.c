@@ -51,6 +51,8 @@
 #include <gsl/gsl_blas.h>
 #include <gsl/gsl_multifit.h>
 
+#define NC_DATA_SNIA_COV_SHARED_PACKED "nc-data-snia-cov-shared-packed"
+
 enum
 {
   PROP_0,
@@ -117,8 +119,11 @@ nc_data_snia_cov_init (NcDataSNIACov *snia_cov)
   snia_cov->cosmo_resample_ctrl = ncm_model_ctrl_new (NULL);
   snia_cov->dcov_resample_ctrl  = ncm_model_ctrl_new (NULL);
   snia_cov->dcov_cov_full_ctrl  = ncm_model_ctrl_new (NULL);
+  snia_cov->dcov_cov_ctrl       = ncm_model_ctrl_new (NULL);
 }
 
+static void _nc_data_snia_cov_ref_cov_full (NcDataSNIACov *snia_cov, NcmMatrix *cov_full, NcmVector *cov_packed);
+
 static void
 nc_data_snia_cov_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
 {
@@ -162,8 +167,16 @@ nc_data_snia_cov_set_property (GObject *object, guint prop_id, const GValue *val
       break;
     }
     case PROP_COV_FULL:
-      nc_data_snia_cov_set_cov_full (snia_cov, g_value_get_object (value));
+    {
+      NcmMatrix *cov_full   = g_value_get_object (value);
+      NcmVector *cov_packed = (cov_full != NULL) ? g_object_get_data (G_OBJECT (cov_full), NC_DATA_SNIA_COV_SHARED_PACKED) : NULL;
+
+      if ((cov_packed != NULL) && !snia_cov->has_complete_cov)
+        _nc_data_snia_cov_ref_cov_full (snia_cov, cov_full, cov_packed);
+      else
+        nc_data_snia_cov_set_cov_full (snia_cov, cov_full);
       break;
+    }
     case PROP_HAS_COMPLETE_COV:
       snia_cov->has_complete_cov = g_value_get_boolean (value);
       break;
@@ -244,6 +257,7 @@ nc_data_snia_cov_dispose (GObject *object)
   ncm_model_ctrl_clear (&snia_cov->cosmo_resample_ctrl);
   ncm_model_ctrl_clear (&snia_cov->dcov_resample_ctrl);
   ncm_model_ctrl_clear (&snia_cov->dcov_cov_full_ctrl);
+  ncm_model_ctrl_clear (&snia_cov->dcov_cov_ctrl);
     
   /* Chain up : end */
   G_OBJECT_CLASS (nc_data_snia_cov_parent_class)->dispose (object);
@@ -260,6 +274,7 @@ nc_data_snia_cov_finalize (GObject *object)
 
 static void _nc_data_snia_cov_prepare (NcmData *data, NcmMSet *mset);
 static void _nc_data_snia_cov_resample (NcmData *data, NcmMSet *mset, NcmRNG *rng);
+static void _nc_data_snia_cov_share_immutable (NcmData *data, NcmSerialize *ser);
 static void _nc_data_snia_cov_mean_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmVector *vp);
 static gboolean _nc_data_snia_cov_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmMatrix *cov);
 static void _nc_data_snia_cov_set_size (NcmDataGaussCov *gauss, guint np);
@@ -357,8 +372,9 @@ nc_data_snia_cov_class_init (NcDataSNIACovClass *klass)
                                                          FALSE,
                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 
-  data_class->resample   = &_nc_data_snia_cov_resample;
-  data_class->prepare    = &_nc_data_snia_cov_prepare;
+  data_class->resample        = &_nc_data_snia_cov_resample;
+  data_class->prepare         = &_nc_data_snia_cov_prepare;
+  data_class->share_immutable = &_nc_data_snia_cov_share_immutable;
 
   gauss_class->mean_func = &_nc_data_snia_cov_mean_func;
   gauss_class->cov_func  = &_nc_data_snia_cov_func;
@@ -391,9 +407,19 @@ _nc_data_snia_cov_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmMatrix *cov)
 {
   NcDataSNIACov *snia_cov = NC_DATA_SNIA_COV (gauss);
   NcSNIADistCov *dcov = NC_SNIA_DIST_COV (ncm_mset_peek (mset, nc_snia_dist_cov_id ()));
-  nc_snia_dist_cov_calc (dcov, snia_cov, cov);
-  
-  return TRUE;
+
+  /* 
+   * The covariance depends only on the NcSNIADistCov parameters, when they 
+   * did not change since the last call the previous covariance (and its
+   * Cholesky decomposition) can be reused.
+   */
+  if (ncm_model_ctrl_update (snia_cov->dcov_cov_ctrl, NCM_MODEL (dcov)))
+  {
+    nc_snia_dist_cov_calc (dcov, snia_cov, cov);
+    return TRUE;
+  }
+  else
+    return FALSE;
 }
 
 /* EXPERIMENTAL CODE : NOT USED! */
@@ -431,12 +457,12 @@ _nc_data_snia_cov_lnNorma2 (NcmDataGaussCov *gauss, NcmMSet *mset, gdouble *m2ln
     {
       for (j = i; j < mu_len; j++)
       {
-        const gdouble mag_mag       = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_MAG_MAG);
-        const gdouble mag_width     = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_MAG_WIDTH);
-        const gdouble mag_colour    = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_MAG_COLOUR);
-        const gdouble width_width   = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_WIDTH_WIDTH);
-        const gdouble width_colour  = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_WIDTH_COLOUR);
-        const gdouble colour_colour = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_COLOUR_COLOUR);
+        const gdouble mag_mag       = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_MAG_MAG * snia_cov->uppertri_len + ij);
+        const gdouble mag_width     = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_MAG_WIDTH * snia_cov->uppertri_len + ij);
+        const gdouble mag_colour    = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_MAG_COLOUR * snia_cov->uppertri_len + ij);
+        const gdouble width_width   = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_WIDTH_WIDTH * snia_cov->uppertri_len + ij);
+        const gdouble width_colour  = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_WIDTH_COLOUR * snia_cov->uppertri_len + ij);
+        const gdouble colour_colour = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_COLOUR_COLOUR * snia_cov->uppertri_len + ij);
         ncm_matrix_set (snia_cov->inv_cov_mm_LU, i, j, 
                         mag_mag 
                         + alpha2 * width_width
@@ -634,6 +660,7 @@ _nc_data_snia_cov_set_size (NcmDataGaussCov *gauss, guint mu_len)
 
       g_array_set_size (snia_cov->dataset, mu_len);
 
+      ncm_model_ctrl_force_update (snia_cov->dcov_cov_ctrl);
       ncm_data_set_init (NCM_DATA (snia_cov), FALSE);
     }
   }
@@ -655,6 +682,9 @@ static void
 _nc_data_snia_cov_set_data_init (NcDataSNIACov *snia_cov, gint data_bw)
 {
   snia_cov->data_init = snia_cov->data_init | data_bw;
+
+  /* Any change in the data invalidates the last covariance computed. */
+  ncm_model_ctrl_force_update (snia_cov->dcov_cov_ctrl);
   if ((snia_cov->data_init & NC_DATA_SNIA_COV_INIT_ALL) == snia_cov->data_init)
     ncm_data_set_init (NCM_DATA (snia_cov), TRUE);
   else
@@ -1028,12 +1058,12 @@ nc_data_snia_cov_set_cov_full (NcDataSNIACov *snia_cov, NcmMatrix *cov_full)
         const gdouble colour_colour_i = 0.5 * (ncm_matrix_get (snia_cov->cov_full, 2 * mu_len + i, 2 * mu_len + j) + 
                                                ncm_matrix_get (snia_cov->cov_full, 2 * mu_len + j, 2 * mu_len + i));
         
-        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_MAG_MAG,       mag_mag_i);
-        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_MAG_WIDTH,     mag_width_i);
-        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_MAG_COLOUR,    mag_colour_i);
-        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_WIDTH_WIDTH,   width_width_i);
-        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_WIDTH_COLOUR,  width_colour_i);
-        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_COLOUR_COLOUR, colour_colour_i);
+        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_MAG_MAG * snia_cov->uppertri_len + ij,       mag_mag_i);
+        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_MAG_WIDTH * snia_cov->uppertri_len + ij,     mag_width_i);
+        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_MAG_COLOUR * snia_cov->uppertri_len + ij,    mag_colour_i);
+        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_WIDTH_WIDTH * snia_cov->uppertri_len + ij,   width_width_i);
+        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_WIDTH_COLOUR * snia_cov->uppertri_len + ij,  width_colour_i);
+        ncm_vector_set (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_COLOUR_COLOUR * snia_cov->uppertri_len + ij, colour_colour_i);
 
         ij++;
       }
@@ -2062,6 +2092,56 @@ _nc_data_snia_cov_save_cov_lowertri (NcDataSNIACov *snia_cov)
   }
 }
 
+static void
+_nc_data_snia_cov_share_immutable (NcmData *data, NcmSerialize *ser)
+{
+  NcDataSNIACov *snia_cov = NC_DATA_SNIA_COV (data);
+
+  /* Chain up : start */
+  NCM_DATA_CLASS (nc_data_snia_cov_parent_class)->share_immutable (data, ser);
+
+  ncm_data_share_obj (ser, snia_cov->z_cmb);
+  ncm_data_share_obj (ser, snia_cov->z_he);
+  ncm_data_share_obj (ser, snia_cov->sigma_z);
+  ncm_data_share_obj (ser, snia_cov->mag);
+  ncm_data_share_obj (ser, snia_cov->width);
+  ncm_data_share_obj (ser, snia_cov->colour);
+  ncm_data_share_obj (ser, snia_cov->thirdpar);
+  ncm_data_share_obj (ser, snia_cov->sigma_thirdpar);
+
+  /*
+   * Without the complete covariance cov_full is never decomposed and the 
+   * likelihood only reads cov_packed. The packed form travels attached to 
+   * cov_full, see _nc_data_snia_cov_ref_cov_full().
+   */
+  if (!snia_cov->has_complete_cov && (snia_cov->cov_full != NULL))
+  {
+    g_object_set_data_full (G_OBJECT (snia_cov->cov_full), NC_DATA_SNIA_COV_SHARED_PACKED, 
+                            ncm_vector_ref (snia_cov->cov_packed), (GDestroyNotify) &ncm_vector_free);
+    ncm_data_share_obj (ser, snia_cov->cov_full);
+  }
+}
+
+/*
+ * References the shared cov_full and its packed form cov_packed instead of 
+ * copying and repacking them. Both are only read afterwards, the diagonal 
+ * is saved as in _nc_data_snia_cov_save_cov_lowertri().
+ */
+static void
+_nc_data_snia_cov_ref_cov_full (NcDataSNIACov *snia_cov, NcmMatrix *cov_full, NcmVector *cov_packed)
+{
+  const guint tmu_len = 3 * snia_cov->mu_len;
+  guint i;
+
+  ncm_matrix_substitute (&snia_cov->cov_full, cov_full, TRUE);
+  ncm_vector_substitute (&snia_cov->cov_packed, cov_packed, TRUE);
+
+  for (i = 0; i < tmu_len; i++)
+    ncm_vector_set (snia_cov->cov_full_diag, i, ncm_matrix_get (snia_cov->cov_full, i, i));
+
+  _nc_data_snia_cov_set_data_init (snia_cov, NC_DATA_SNIA_COV_INIT_COV_FULL);
+}
+
 static void 
 _nc_data_snia_cov_resample (NcmData *data, NcmMSet *mset, NcmRNG *rng)
 {
@@ -189,7 +189,10 @@ typedef enum _NcDataSNIACovDataInit
  * @NC_DATA_SNIA_COV_ORDER_WIDTH_COLOUR: width-colour.
  * @NC_DATA_SNIA_COV_ORDER_COLOUR_COLOUR: colour-colour.
  * 
- * Data ordering for covariance.
+ * Data ordering for covariance. The packed covariance stores each 
+ * component contiguously (structure of arrays), the component @comp of 
+ * the $ij$-th element of the row-major upper triangle is found at 
+ * @comp $\times$ uppertri_len $+ ij$.
  * 
  */
 typedef enum _NcDataSNIACovOrder
@@ -241,6 +244,7 @@ struct _NcDataSNIACov
   NcmModelCtrl *cosmo_resample_ctrl;
   NcmModelCtrl *dcov_resample_ctrl;
   NcmModelCtrl *dcov_cov_full_ctrl;
+  NcmModelCtrl *dcov_cov_ctrl;
 };
 
 GType nc_data_snia_cov_get_type (void) G_GNUC_CONST;
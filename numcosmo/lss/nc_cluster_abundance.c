@@ -314,16 +314,22 @@ typedef struct _observables_integrand_data
   gdouble *lnM_obs_params;
 } observables_integrand_data;
 
-static gdouble
-_nc_cluster_abundance_z_p_lnM_p_d2n_integrand (gdouble lnM, gdouble z, gpointer userdata)
+static void
+_nc_cluster_abundance_z_p_lnM_p_d2n_integrand (const gdouble *lnM, const gdouble *z, const guint np, gdouble *f, gpointer userdata)
 {
   observables_integrand_data *obs_data = (observables_integrand_data *) userdata;
   NcClusterAbundance *cad = obs_data->cad;
-  const gdouble p_z_zr = nc_cluster_redshift_p (obs_data->clusterz, lnM, z, obs_data->z_obs, obs_data->z_obs_params);
-  const gdouble p_M_Mobs = nc_cluster_mass_p (obs_data->clusterm, obs_data->cosmo, lnM, z, obs_data->lnM_obs, obs_data->lnM_obs_params);
-  gdouble d2NdzdlnM = nc_halo_mass_function_d2n_dzdlnM (cad->mfp, obs_data->cosmo, lnM, z);
+  guint i;
+
+  nc_halo_mass_function_d2n_dzdlnM_vec (cad->mfp, obs_data->cosmo, lnM, z, np, f);
 
-  return p_z_zr * p_M_Mobs * d2NdzdlnM;
+  for (i = 0; i < np; i++)
+  {
+    const gdouble p_z_zr = nc_cluster_redshift_p (obs_data->clusterz, lnM[i], z[i], obs_data->z_obs, obs_data->z_obs_params);
+    const gdouble p_M_Mobs = nc_cluster_mass_p (obs_data->clusterm, obs_data->cosmo, lnM[i], z[i], obs_data->lnM_obs, obs_data->lnM_obs_params);
+
+    f[i] *= p_z_zr * p_M_Mobs;
+  }
 }
 
 /**
@@ -349,7 +355,7 @@ nc_cluster_abundance_z_p_lnM_p_d2n (NcClusterAbundance *cad, NcHICosmo *cosmo, N
 {
   gdouble d2N, zl, zu, lnMl, lnMu, err;
   observables_integrand_data obs_data;
-  NcmIntegrand2dim integ;
+  NcmIntegrand2dimVec integ;
 
   obs_data.cad            = cad;
   obs_data.cosmo          = cosmo;
@@ -366,7 +372,7 @@ nc_cluster_abundance_z_p_lnM_p_d2n (NcClusterAbundance *cad, NcHICosmo *cosmo, N
   nc_cluster_redshift_p_limits (clusterz, z_obs, z_obs_params, &zl, &zu);
   nc_cluster_mass_p_limits (clusterm, cosmo, lnM_obs, lnM_obs_params, &lnMl, &lnMu);
 
-  ncm_integrate_2dim (&integ, lnMl, zl, lnMu, zu, NCM_DEFAULT_PRECISION, 0.0, &d2N, &err);
+  ncm_integrate_2dim_vec (&integ, lnMl, zl, lnMu, zu, NCM_DEFAULT_PRECISION, 0.0, &d2N, &err);
 
   return d2N;
 }
@@ -547,11 +553,21 @@ _nc_cluster_abundance_z_intp_lnM_intp_d2N (NcClusterAbundance *cad, NcHICosmo *c
   return z_intp * lnM_intp * d2NdzdlnM;
 }
 
-static gdouble
-_nc_cluster_abundance_z_intp_lnM_intp_N_integrand (gdouble lnM, gdouble z, gpointer userdata)
+static void
+_nc_cluster_abundance_z_intp_lnM_intp_N_integrand (const gdouble *lnM, const gdouble *z, const guint np, gdouble *f, gpointer userdata)
 {
   observables_integrand_data *obs_data = (observables_integrand_data *) userdata;
-  return _nc_cluster_abundance_z_intp_lnM_intp_d2N (obs_data->cad, obs_data->cosmo, obs_data->clusterz, obs_data->clusterm, lnM, z);
+  guint i;
+
+  nc_halo_mass_function_d2n_dzdlnM_vec (obs_data->cad->mfp, obs_data->cosmo, lnM, z, np, f);
+
+  for (i = 0; i < np; i++)
+  {
+    const gdouble z_intp = nc_cluster_redshift_intp (obs_data->clusterz, lnM[i], z[i]);
+    const gdouble lnM_intp = nc_cluster_mass_intp (obs_data->clusterm, obs_data->cosmo, lnM[i], z[i]);
+
+    f[i] *= z_intp * lnM_intp;
+  }
 }
 
 static gdouble
@@ -559,7 +575,7 @@ _nc_cluster_abundance_z_intp_lnM_intp_N (NcClusterAbundance *cad, NcHICosmo *cos
 {
   gdouble N, zl, zu, lnMl, lnMu, err;
   observables_integrand_data obs_data;
-  NcmIntegrand2dim integ;
+  NcmIntegrand2dimVec integ;
 
   obs_data.cad      = cad;
   obs_data.cosmo    = cosmo;
@@ -572,7 +588,7 @@ _nc_cluster_abundance_z_intp_lnM_intp_N (NcClusterAbundance *cad, NcHICosmo *cos
   nc_cluster_redshift_n_limits (clusterz, &zl, &zu);
   nc_cluster_mass_n_limits (clusterm, cosmo, &lnMl, &lnMu);
 
-  ncm_integrate_2dim (&integ, lnMl, zl, lnMu, zu, NCM_DEFAULT_PRECISION, 0.0, &N, &err);
+  ncm_integrate_2dim_vec (&integ, lnMl, zl, lnMu, zu, NCM_DEFAULT_PRECISION, 0.0, &N, &err);
 
   return N;
 }
@@ -586,11 +602,16 @@ _nc_cluster_abundance_z_intp_d2N (NcClusterAbundance *cad, NcHICosmo *cosmo, NcC
   return z_intp * d2NdzdlnM;
 }
 
-static gdouble
-_nc_cluster_abundance_z_intp_N_integrand (gdouble lnM, gdouble z, gpointer userdata)
+static void
+_nc_cluster_abundance_z_intp_N_integrand (const gdouble *lnM, const gdouble *z, const guint np, gdouble *f, gpointer userdata)
 {
   observables_integrand_data *obs_data = (observables_integrand_data *) userdata;
-  return _nc_cluster_abundance_z_intp_d2N (obs_data->cad, obs_data->cosmo, obs_data->clusterz, obs_data->clusterm, lnM, z);
+  guint i;
+
+  nc_halo_mass_function_d2n_dzdlnM_vec (obs_data->cad->mfp, obs_data->cosmo, lnM, z, np, f);
+
+  for (i = 0; i < np; i++)
+    f[i] *= nc_cluster_redshift_intp (obs_data->clusterz, lnM[i], z[i]);
 }
 
 static gdouble
@@ -598,7 +619,7 @@ _nc_cluster_abundance_z_intp_N (NcClusterAbundance *cad, NcHICosmo *cosmo, NcClu
 {
   gdouble N, zl, zu, lnMl, lnMu, err;
   observables_integrand_data obs_data;
-  NcmIntegrand2dim integ;
+  NcmIntegrand2dimVec integ;
 
   obs_data.cad = cad;
   obs_data.cosmo = cosmo;
@@ -611,7 +632,7 @@ _nc_cluster_abundance_z_intp_N (NcClusterAbundance *cad, NcHICosmo *cosmo, NcClu
   nc_cluster_redshift_n_limits (clusterz, &zl, &zu);
   nc_cluster_mass_n_limits (clusterm, cosmo, &lnMl, &lnMu);
 
-  ncm_integrate_2dim (&integ, lnMl, zl, lnMu, zu, NCM_DEFAULT_PRECISION, 0.0, &N, &err);
+  ncm_integrate_2dim_vec (&integ, lnMl, zl, lnMu, zu, NCM_DEFAULT_PRECISION, 0.0, &N, &err);
 
   return N;
 }
@@ -625,11 +646,16 @@ _nc_cluster_abundance_lnM_intp_d2N (NcClusterAbundance *cad, NcHICosmo *cosmo, N
   return lnM_intp * d2NdzdlnM;
 }
 
-static gdouble
-_nc_cluster_abundance_lnM_intp_N_integrand (gdouble lnM, gdouble z, gpointer userdata)
+static void
+_nc_cluster_abundance_lnM_intp_N_integrand (const gdouble *lnM, const gdouble *z, const guint np, gdouble *f, gpointer userdata)
 {
   observables_integrand_data *obs_data = (observables_integrand_data *) userdata;
-  return _nc_cluster_abundance_lnM_intp_d2N (obs_data->cad, obs_data->cosmo, obs_data->clusterz, obs_data->clusterm, lnM, z);
+  guint i;
+
+  nc_halo_mass_function_d2n_dzdlnM_vec (obs_data->cad->mfp, obs_data->cosmo, lnM, z, np, f);
+
+  for (i = 0; i < np; i++)
+    f[i] *= nc_cluster_mass_intp (obs_data->clusterm, obs_data->cosmo, lnM[i], z[i]);
 }
 
 static gdouble
@@ -637,7 +663,7 @@ _nc_cluster_abundance_lnM_intp_N (NcClusterAbundance *cad, NcHICosmo *cosmo, NcC
 {
   gdouble N, zl, zu, lnMl, lnMu, err;
   observables_integrand_data obs_data;
-  NcmIntegrand2dim integ;
+  NcmIntegrand2dimVec integ;
 
   obs_data.cad = cad;
   obs_data.cosmo = cosmo;
@@ -650,7 +676,7 @@ _nc_cluster_abundance_lnM_intp_N (NcClusterAbundance *cad, NcHICosmo *cosmo, NcC
   nc_cluster_redshift_n_limits (clusterz, &zl, &zu);
   nc_cluster_mass_n_limits (clusterm, cosmo, &lnMl, &lnMu);
 
-  ncm_integrate_2dim (&integ, lnMl, zl, lnMu, zu, NCM_DEFAULT_PRECISION, 0.0, &N, &err);
+  ncm_integrate_2dim_vec (&integ, lnMl, zl, lnMu, zu, NCM_DEFAULT_PRECISION, 0.0, &N, &err);
 
   return N;
 }
@@ -40,6 +40,7 @@
 #include "math/integral.h"
 #include "math/ncm_spline2d_bicubic.h"
 #include "math/ncm_cfg.h"
+#include "math/ncm_func_eval.h"
 
 #include <gsl/gsl_integration.h>
 
@@ -417,6 +418,80 @@ nc_halo_mass_function_dn_dlnM (NcHaloMassFunction *mfp, NcHICosmo *cosmo, gdoubl
   return dn_dlnM;
 }
 
+/**
+ * nc_halo_mass_function_dn_dlnM_vec:
+ * @mfp: a #NcHaloMassFunction
+ * @cosmo: a #NcHICosmo
+ * @lnM: (array length=np): logarithm base e of mass
+ * @z: redshift
+ * @np: number of points
+ * @res: (out caller-allocates) (array length=np): $\frac{\mathrm{d}n}{\mathrm{d}\ln(M)}$
+ *
+ * Computes nc_halo_mass_function_dn_dlnM() at the @np masses @lnM, all at
+ * redshift @z. The filtered variance and its derivative are looked up in
+ * blocks along @lnM and the multiplicity function is called through
+ * nc_multiplicity_func_eval_vec(), so increasing @lnM are the fastest case.
+ *
+ */
+void
+nc_halo_mass_function_dn_dlnM_vec (NcHaloMassFunction *mfp, NcHICosmo *cosmo, const gdouble *lnM, const gdouble z, const guint np, gdouble *res)
+{
+  const gdouble volume_rm3 = ncm_powspec_filter_volume_rm3 (mfp->psf);
+  const gdouble lnM0       = log (nc_hicosmo_Omega_m0h2 (cosmo) * volume_rm3 * ncm_c_crit_mass_density_h2_solar_mass_Mpc3 ());
+  gdouble lnR[NCM_SPLINE_VEC_BLOCK];
+  gdouble sigma[NCM_SPLINE_VEC_BLOCK];
+  gdouble dlnvar_dlnR[NCM_SPLINE_VEC_BLOCK];
+  gdouble f[NCM_SPLINE_VEC_BLOCK];
+  guint k;
+
+  for (k = 0; k < np; k += NCM_SPLINE_VEC_BLOCK)
+  {
+    const guint nb = GSL_MIN (np - k, NCM_SPLINE_VEC_BLOCK);
+    guint l;
+
+    for (l = 0; l < nb; l++)
+      lnR[l] = (lnM[k + l] - lnM0) / 3.0;
+
+    ncm_powspec_filter_eval_var_lnr_vec (mfp->psf, z, lnR, sigma, nb);
+    ncm_powspec_filter_eval_dvar_dlnr_vec (mfp->psf, z, lnR, dlnvar_dlnR, nb);
+
+    for (l = 0; l < nb; l++)
+    {
+      dlnvar_dlnR[l] = dlnvar_dlnR[l] / sigma[l];
+      sigma[l]       = sqrt (sigma[l]);
+    }
+
+    nc_multiplicity_func_eval_vec (mfp->mulf, cosmo, sigma, z, f, nb);
+
+    for (l = 0; l < nb; l++)
+    {
+      const gdouble V = volume_rm3 * exp (3.0 * lnR[l]);
+      res[k + l] = -(1.0 / V) * f[l] * 0.5 * dlnvar_dlnR[l] / 3.0;
+    }
+  }
+}
+
+/**
+ * nc_halo_mass_function_d2n_dzdlnM_vec:
+ * @mfp: a #NcHaloMassFunction
+ * @cosmo: a #NcHICosmo
+ * @lnM: (array length=np): logarithm base e of mass
+ * @z: (array length=np): redshift
+ * @np: number of points
+ * @res: (out caller-allocates) (array length=np): output array
+ *
+ * Evaluates nc_halo_mass_function_d2n_dzdlnM() in the @np points
+ * (@lnM[i], @z[i]) storing the results in @res. This is the block
+ * interface used by the vectorized cluster abundance integrands.
+ *
+ */
+void
+nc_halo_mass_function_d2n_dzdlnM_vec (NcHaloMassFunction *mfp, NcHICosmo *cosmo, const gdouble *lnM, const gdouble *z, const guint np, gdouble *res)
+{
+  NCM_UNUSED (cosmo);
+  ncm_spline2d_eval_vec (mfp->d2NdzdlnM, lnM, z, res, np);
+}
+
 typedef struct _nc_ca_integ
 {
   NcHaloMassFunction *mfp;
@@ -525,6 +600,36 @@ nc_halo_mass_function_set_eval_limits (NcHaloMassFunction *mfp, NcHICosmo *cosmo
   }
 }
 
+typedef struct _NcHaloMassFunctionPrepareRows
+{
+  NcHaloMassFunction *mfp;
+  NcHICosmo *cosmo;
+  const gdouble *dVdz;
+} NcHaloMassFunctionPrepareRows;
+
+static void
+_nc_halo_mass_function_prepare_rows (glong i, glong f, gpointer data)
+{
+  NcHaloMassFunctionPrepareRows *rows = (NcHaloMassFunctionPrepareRows *) data;
+  NcHaloMassFunction *mfp = rows->mfp;
+  NcmSpline2d *s2d        = mfp->d2NdzdlnM;
+  const guint nlnM        = ncm_vector_len (s2d->xv);
+  const gdouble *lnM      = ncm_vector_const_ptr (s2d->xv, 0);
+  glong k;
+
+  for (k = i; k < f; k++)
+  {
+    const gdouble z = ncm_vector_get (s2d->yv, k);
+    gdouble *row    = ncm_matrix_ptr (s2d->zm, k, 0);
+    guint j;
+
+    nc_halo_mass_function_dn_dlnM_vec (mfp, rows->cosmo, lnM, z, nlnM, row);
+
+    for (j = 0; j < nlnM; j++)
+      row[j] = rows->dVdz[k] * row[j];
+  }
+}
+
 /**
  * nc_halo_mass_function_prepare:
  * @mfp: a #NcHaloMassFunction
@@ -536,7 +641,9 @@ nc_halo_mass_function_set_eval_limits (NcHaloMassFunction *mfp, NcHICosmo *cosmo
 void
 nc_halo_mass_function_prepare (NcHaloMassFunction *mfp, NcHICosmo *cosmo)
 {
-  guint i, j;
+  NcHaloMassFunctionPrepareRows rows;
+  gdouble *dVdz;
+  guint nz, i;
 
   nc_distance_prepare_if_needed (mfp->dist, cosmo);
   ncm_powspec_filter_prepare_if_needed (mfp->psf, NCM_MODEL (cosmo));
@@ -544,22 +651,27 @@ nc_halo_mass_function_prepare (NcHaloMassFunction *mfp, NcHICosmo *cosmo)
   if (mfp->d2NdzdlnM == NULL)
     _nc_halo_mass_function_generate_2Dspline_knots (mfp, cosmo, mfp->prec);
 
-#define D2NDZDLNM_Z(cad) ((cad)->d2NdzdlnM->yv)
-#define D2NDZDLNM_LNM(cad) ((cad)->d2NdzdlnM->xv)
-#define D2NDZDLNM_VAL(cad) ((cad)->d2NdzdlnM->zm)
+  nz   = ncm_vector_len (mfp->d2NdzdlnM->yv);
+  dVdz = g_new (gdouble, nz);
 
-  for (i = 0; i < ncm_vector_len (D2NDZDLNM_Z (mfp)); i++)
+  /* 
+   * The volume element goes through NcDistance, compute it serially and 
+   * leave only the spline lookups and multiplicity function to the rows.
+   */
+  for (i = 0; i < nz; i++)
   {
-    const gdouble z = ncm_vector_get (D2NDZDLNM_Z (mfp), i);
-    const gdouble dVdz = mfp->area_survey * nc_halo_mass_function_dv_dzdomega (mfp, cosmo, z);
-
-    for (j = 0; j < ncm_vector_len (D2NDZDLNM_LNM (mfp)); j++)
-    {
-      const gdouble lnM = ncm_vector_get (D2NDZDLNM_LNM (mfp), j);
-      const gdouble d2NdzdlnM_ij = (dVdz * nc_halo_mass_function_dn_dlnM (mfp, cosmo, lnM, z));
-      ncm_matrix_set (D2NDZDLNM_VAL (mfp), i, j, d2NdzdlnM_ij);
-    }
+    const gdouble z = ncm_vector_get (mfp->d2NdzdlnM->yv, i);
+    dVdz[i] = mfp->area_survey * nc_halo_mass_function_dv_dzdomega (mfp, cosmo, z);
   }
+
+  rows.mfp   = mfp;
+  rows.cosmo = cosmo;
+  rows.dVdz  = dVdz;
+
+  ncm_func_eval_parallel_for (&_nc_halo_mass_function_prepare_rows, 0, nz, 1, &rows);
+
+  g_free (dVdz);
+
   ncm_spline2d_prepare (mfp->d2NdzdlnM);
 
   ncm_model_ctrl_update (mfp->ctrl_cosmo, NCM_MODEL (cosmo));
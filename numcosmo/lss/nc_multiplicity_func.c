@@ -77,6 +77,37 @@ nc_multiplicity_func_eval (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, gdouble s
   return NC_MULTIPLICITY_FUNC_GET_CLASS (mulf)->eval (mulf, cosmo, sigma, z);
 }
 
+/**
+ * nc_multiplicity_func_eval_vec:
+ * @mulf: a #NcMultiplicityFunc.
+ * @cosmo: a #NcHICosmo.
+ * @sigma: (array length=n): values of $\sigma$
+ * @z: redshift.
+ * @f: (out caller-allocates) (array length=n): output array
+ * @n: number of points
+ *
+ * Evaluates the multiplicity function at the @n values of @sigma, all at the
+ * same redshift @z, storing the results in @f. Subclasses can override this
+ * to compute the redshift dependent coefficients only once per call; the
+ * default implementation loops over nc_multiplicity_func_eval().
+ *
+*/
+void
+nc_multiplicity_func_eval_vec (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, const gdouble *sigma, const gdouble z, gdouble *f, const guint n)
+{
+  NC_MULTIPLICITY_FUNC_GET_CLASS (mulf)->eval_vec (mulf, cosmo, sigma, z, f, n);
+}
+
+static void
+_nc_multiplicity_func_eval_vec (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, const gdouble *sigma, const gdouble z, gdouble *f, const guint n)
+{
+  NcMultiplicityFuncClass *mulf_class = NC_MULTIPLICITY_FUNC_GET_CLASS (mulf);
+  guint i;
+
+  for (i = 0; i < n; i++)
+    f[i] = mulf_class->eval (mulf, cosmo, sigma[i], z);
+}
+
 /**
  * nc_multiplicity_func_free:
  * @mulf: a #NcMultiplicityFunc.
@@ -126,5 +157,7 @@ nc_multiplicity_func_class_init (NcMultiplicityFuncClass *klass)
   //GObjectClass* parent_class = G_OBJECT_CLASS (klass);
 
   object_class->finalize = _nc_multiplicity_func_finalize;
+
+  klass->eval_vec = &_nc_multiplicity_func_eval_vec;
 }
 
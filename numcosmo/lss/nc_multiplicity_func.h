@@ -48,6 +48,7 @@ struct _NcMultiplicityFuncClass
   /*< private >*/
   GObjectClass parent_class;
   gdouble (*eval) (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, gdouble sigma, gdouble z);
+  void (*eval_vec) (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, const gdouble *sigma, const gdouble z, gdouble *f, const guint n);
 };
 
 struct _NcMultiplicityFunc
@@ -60,6 +61,7 @@ GType nc_multiplicity_func_get_type (void) G_GNUC_CONST;
 
 NcMultiplicityFunc *nc_multiplicity_func_new_from_name (gchar *multiplicity_name);
 gdouble nc_multiplicity_func_eval (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, gdouble sigma, gdouble z);
+void nc_multiplicity_func_eval_vec (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, const gdouble *sigma, const gdouble z, gdouble *f, const guint n);
 void nc_multiplicity_func_free (NcMultiplicityFunc *mulf);
 void nc_multiplicity_func_clear (NcMultiplicityFunc **mulf);
 
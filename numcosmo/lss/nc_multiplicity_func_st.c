@@ -94,6 +94,27 @@ _nc_multiplicity_func_st_eval (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, gdoub
   return f_ST;
 }
 
+static void
+_nc_multiplicity_func_st_eval_vec (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, const gdouble *sigma, const gdouble z, gdouble *f, const guint n)
+{
+  NcMultiplicityFuncST *mulf_st = NC_MULTIPLICITY_FUNC_ST (mulf);
+  const gdouble b = mulf_st->b;
+  const gdouble p = mulf_st->p;
+  const gdouble Abc1 = mulf_st->A * sqrt (2.0 * b / M_PI);
+  const gdouble b2_2 = 0.5 * b * b;
+  const gdouble delta_c = mulf_st->delta_c;
+  guint i;
+
+  NCM_UNUSED (cosmo);
+  NCM_UNUSED (z);
+
+  for (i = 0; i < n; i++)
+  {
+    const gdouble x = delta_c / sigma[i];
+    f[i] = Abc1 * (1.0 + pow (x * b, -p)) * exp (-b2_2 * x * x) * x;
+  }
+}
+
 /**
  * nc_multiplicity_func_st_set_A:
  * @mulf_st: a #NcMultiplicityFuncST.
@@ -278,7 +299,8 @@ nc_multiplicity_func_st_class_init (NcMultiplicityFuncSTClass *klass)
   GObjectClass* object_class = G_OBJECT_CLASS (klass);
   NcMultiplicityFuncClass* parent_class = NC_MULTIPLICITY_FUNC_CLASS (klass);
 
-  parent_class->eval = &_nc_multiplicity_func_st_eval;
+  parent_class->eval     = &_nc_multiplicity_func_st_eval;
+  parent_class->eval_vec = &_nc_multiplicity_func_st_eval_vec;
 
   object_class->finalize = _nc_multiplicity_func_st_finalize;
   object_class->set_property = _nc_multiplicity_func_st_set_property;
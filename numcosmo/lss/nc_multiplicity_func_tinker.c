@@ -92,6 +92,24 @@ _nc_multiplicity_func_tinker_eval (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, g
   return f_Tinker;
 }
 
+static void
+_nc_multiplicity_func_tinker_eval_vec (NcMultiplicityFunc *mulf, NcHICosmo *cosmo, const gdouble *sigma, const gdouble z, gdouble *f, const guint n)
+{
+  NcMultiplicityFuncTinker *mulf_tinker = NC_MULTIPLICITY_FUNC_TINKER (mulf);
+  const gdouble A = mulf_tinker->A0 * pow(1.0 + z, -0.14);
+  const gdouble a = mulf_tinker->a0 * pow(1.0 + z, -0.06);
+  const gdouble log10alpha = -pow(0.75 / log10 (mulf_tinker->Delta / 75.0), 1.2);
+  const gdouble alpha = pow(10.0, log10alpha);
+  const gdouble b = mulf_tinker->b0 * pow(1.0 + z, -alpha);
+  const gdouble c = mulf_tinker->c;
+  guint i;
+
+  NCM_UNUSED (cosmo);
+
+  for (i = 0; i < n; i++)
+    f[i] = A * (pow(sigma[i] / b, -a) + 1.0) * exp(-c / (sigma[i] * sigma[i]));
+}
+
 /**
  * nc_multiplicity_func_tinker_set_A0:
  * @mulf_tinker: a #NcMultiplicityFuncTinker.
@@ -314,7 +332,8 @@ nc_multiplicity_func_tinker_class_init (NcMultiplicityFuncTinkerClass *klass)
   GObjectClass* object_class = G_OBJECT_CLASS (klass);
   NcMultiplicityFuncClass* parent_class = NC_MULTIPLICITY_FUNC_CLASS (klass);
 
-  parent_class->eval = &_nc_multiplicity_func_tinker_eval;
+  parent_class->eval     = &_nc_multiplicity_func_tinker_eval;
+  parent_class->eval_vec = &_nc_multiplicity_func_tinker_eval_vec;
 
   object_class->finalize = _nc_multiplicity_func_tinker_finalize;
   object_class->set_property = _nc_multiplicity_func_tinker_set_property;
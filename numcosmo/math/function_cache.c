@@ -29,7 +29,19 @@
  * @stability: Stable
  * @include: numcosmo/math/function_cache.h
  *
- * FIXME
+ * A cache of the values of a vector function of one real variable. The keys
+ * are kept sorted in a contiguous array and the values, @n per key, in a
+ * second array with the same ordering. Both arrays are allocated with the
+ * maximum size of the cache, when the cache is full the oldest entry is
+ * evicted to make room for a new one.
+ *
+ * The readers (ncm_function_cache_get() and ncm_function_cache_get_near())
+ * do not take any lock. The writers serialize on a mutex and update a
+ * sequence counter before and after each change, the readers copy the
+ * values found to the caller's vector and retry whenever the sequence
+ * counter shows that a writer changed the cache meanwhile (seqlock). Since
+ * the arrays are never reallocated, a reader racing a writer never accesses
+ * invalid memory, at worst it retries.
  * 
  */
 
@@ -42,38 +54,72 @@
 #include "math/ncm_util.h"
 
 #include <gsl/gsl_math.h>
+#include <string.h>
 
-/***************************************************************************
- *
- *
- ****************************************************************************/
+/*
+ * Orders the reads of the cached data before the final read of the
+ * sequence counter.
+ */
+#if defined (__GNUC__)
+#define _NCM_FUNCTION_CACHE_READ_BARRIER(cache) __atomic_thread_fence (__ATOMIC_ACQUIRE)
+#else
+#define _NCM_FUNCTION_CACHE_READ_BARRIER(cache) g_atomic_int_add (&(cache)->seq, 0)
+#endif
 
-static gint gdouble_compare (gconstpointer a, gconstpointer b, gpointer user_data);
-static void gdouble_free (gpointer data);
-static gboolean cache_clean (NcmFunctionCache *cache);
+#define _NCM_FUNCTION_CACHE_KEY_RELTOL (1.0e-15)
 
 /**
  * ncm_function_cache_new: (skip)
- * @n: FIXME
- * @abstol: FIXME
- * @reltol: FIXME
+ * @n: number of values per key
+ * @abstol: absolute tolerance
+ * @reltol: relative tolerance
  *
- * FIXME
+ * Creates a new #NcmFunctionCache with at most
+ * #NCM_FUNCTION_CACHE_DEFAULT_MAX_SIZE keys, see
+ * ncm_function_cache_new_full().
  *
- * Returns: FIXME
+ * Returns: a new #NcmFunctionCache.
  */
 NcmFunctionCache *
 ncm_function_cache_new (guint n, gdouble abstol, gdouble reltol)
+{
+  return ncm_function_cache_new_full (n, NCM_FUNCTION_CACHE_DEFAULT_MAX_SIZE, abstol, reltol);
+}
+
+/**
+ * ncm_function_cache_new_full: (skip)
+ * @n: number of values per key
+ * @max_size: maximum number of keys
+ * @abstol: absolute tolerance
+ * @reltol: relative tolerance
+ *
+ * Creates a new #NcmFunctionCache holding @n values per key and at most
+ * @max_size keys. The tolerances @abstol and @reltol are not used by the
+ * cache itself, they are kept for the functions filling the cache, e.g.,
+ * ncm_integral_cached_x_inf().
+ *
+ * Returns: a new #NcmFunctionCache.
+ */
+NcmFunctionCache *
+ncm_function_cache_new_full (guint n, guint max_size, gdouble abstol, gdouble reltol)
 {
   NcmFunctionCache *cache = g_slice_new (NcmFunctionCache);
-  cache->tree = g_tree_new_full (&gdouble_compare, NULL, &gdouble_free, (GDestroyNotify)&gsl_vector_free);
+
+  g_assert_cmpuint (n, >, 0);
+  g_assert_cmpuint (max_size, >, 0);
 
   g_mutex_init (&cache->lock);
 
-  cache->clear = FALSE;
-  cache->n = n;
-  cache->abstol = abstol;
-  cache->reltol = reltol;
+  cache->seq      = 0;
+  cache->n        = n;
+  cache->max_size = max_size;
+  cache->len      = 0;
+  cache->nstamp   = 0;
+  cache->x        = g_new0 (gdouble, max_size);
+  cache->v        = g_new0 (gdouble, max_size * n);
+  cache->stamp    = g_new0 (guint64, max_size);
+  cache->abstol   = abstol;
+  cache->reltol   = reltol;
 
   return cache;
 }
@@ -82,14 +128,16 @@ ncm_function_cache_new (guint n, gdouble abstol, gdouble reltol)
  * ncm_function_cache_free:
  * @cache: a #NcmFunctionCache
  *
- * FIXME
+ * Frees @cache.
  *
  */
 void
 ncm_function_cache_free (NcmFunctionCache *cache)
 {
   g_mutex_clear (&cache->lock);
-  g_tree_destroy (cache->tree);
+  g_free (cache->x);
+  g_free (cache->v);
+  g_free (cache->stamp);
   g_slice_free (NcmFunctionCache, cache);
   return;
 }
@@ -98,7 +146,7 @@ ncm_function_cache_free (NcmFunctionCache *cache)
  * ncm_function_cache_clear:
  * @cache: a #NcmFunctionCache
  *
- * FIXME
+ * If *@cache is not NULL frees it and sets *@cache to NULL.
  *
  */
 void
@@ -107,205 +155,294 @@ ncm_function_cache_clear (NcmFunctionCache **cache)
   g_clear_pointer (cache, ncm_function_cache_free);
 }
 
-/**
- * ncm_function_cache_insert_vector: (skip)
- * @cache: a #NcmFunctionCache
- * @x: FIXME
- * @p: FIXME
- *
- * FIXME
- *
- */
-void
-ncm_function_cache_insert_vector (NcmFunctionCache *cache, gdouble x, gsl_vector *p)
+static void
+_ncm_function_cache_write_begin (NcmFunctionCache *cache)
 {
-  gdouble *x_ptr = g_slice_new (gdouble);
-  g_assert (cache->n == p->size);
-
-  *x_ptr = x;
   g_mutex_lock (&cache->lock);
-  cache_clean (cache);
-  g_tree_insert (cache->tree, x_ptr, p);
+  g_atomic_int_inc (&cache->seq);
+}
+
+static void
+_ncm_function_cache_write_end (NcmFunctionCache *cache)
+{
+  g_atomic_int_inc (&cache->seq);
   g_mutex_unlock (&cache->lock);
 }
 
-void
-ncm_function_cache_insert (NcmFunctionCache *cache, gdouble x, ...)
+/*
+ * Returns the position of the first key greater than or equal to x among
+ * the first len keys.
+ */
+static guint
+_ncm_function_cache_lower_bound (const gdouble *xa, const guint len, const gdouble x)
 {
-  gdouble *x_ptr;
-  gsl_vector *v;
-  guint i;
-  va_list ap;
-  g_mutex_lock (&cache->lock);
-  cache_clean (cache);
+  guint lo = 0, hi = len;
 
-  if (g_tree_lookup (cache->tree, &x) != NULL)
+  while (lo < hi)
   {
-    g_mutex_unlock (&cache->lock);
-    return;
-  }
+    const guint mid = lo + (hi - lo) / 2;
 
-  v = gsl_vector_alloc (cache->n);
-  x_ptr = g_slice_new (gdouble);
+    if (xa[mid] < x)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
 
-  va_start(ap, x);
+  return lo;
+}
 
-  for (i = 0; i < cache->n; i++)
-    gsl_vector_set (v, i, va_arg(ap, gdouble));
-  *x_ptr = x;
+/*
+ * Finds the key matching the search, returns -1 if there is none. Used both
+ * by the readers (no lock) and the writers (locked), in the first case len
+ * may be inconsistent with the keys, the result is then discarded by the
+ * sequence check.
+ */
+static gint
+_ncm_function_cache_find (const gdouble *xa, const guint len, const gdouble x, NcmFunctionCacheSearchType type)
+{
+  const guint pos = _ncm_function_cache_lower_bound (xa, len, x);
+  const gint lt   = (pos > 0) ? (gint) pos - 1 : -1;
+  const gint gt   = (pos < len) ? (gint) pos : -1;
 
-  g_tree_insert (cache->tree, x_ptr, v);
-  g_mutex_unlock (&cache->lock);
+  switch (type)
+  {
+    case NC_FUNCTION_CACHE_SEARCH_GT:
+      if ((lt >= 0) && (gsl_fcmp (xa[lt], x, _NCM_FUNCTION_CACHE_KEY_RELTOL) == 0))
+        return lt;
+      return gt;
+    case NC_FUNCTION_CACHE_SEARCH_LT:
+      if ((gt >= 0) && (gsl_fcmp (xa[gt], x, _NCM_FUNCTION_CACHE_KEY_RELTOL) == 0))
+        return gt;
+      return lt;
+    case NC_FUNCTION_CACHE_SEARCH_BOTH:
+    default:
+      if (lt < 0)
+        return gt;
+      else if (gt < 0)
+        return lt;
+      else
+        return (fabs (xa[gt] - x) < fabs (x - xa[lt])) ? gt : lt;
+  }
 }
 
-typedef struct _NcParamsCacheSearch
+static gboolean
+_ncm_function_cache_read (NcmFunctionCache *cache, const gdouble x, gdouble *x_found, gsl_vector *v, NcmFunctionCacheSearchType type, gboolean exact)
 {
+  const guint n = cache->n;
   gboolean found;
-  gdouble near_x;
-  gdouble x;
-  gdouble diff;
-  gint dir;
-  NcmFunctionCacheSearchType type;
-} NcParamsCacheSearch;
 
-static gint gdouble_search_near (gconstpointer a, gconstpointer b);
+  g_assert_cmpuint (v->size, ==, n);
 
-/**
- * ncm_function_cache_get_near: (skip)
- * @cache: a #NcmFunctionCache
- * @x: FIXME
- * @x_found_ptr: FIXME
- * @v: FIXME
- * @type: a #NcmFunctionCacheSearchType
- * 
- * 
+  while (TRUE)
+  {
+    const gint seq = g_atomic_int_get (&cache->seq);
+
+    if (seq & 1)
+      continue;
+
+    {
+      const guint len = GSL_MIN (cache->len, cache->max_size);
+      const gint pos  = _ncm_function_cache_find (cache->x, len, x, type);
+
+      found = (pos >= 0);
+      if (found)
+      {
+        const gdouble *v_pos = &cache->v[pos * n];
+        guint i;
+
+        *x_found = cache->x[pos];
+        if (exact && (gsl_fcmp (*x_found, x, _NCM_FUNCTION_CACHE_KEY_RELTOL) != 0))
+          found = FALSE;
+        else
+        {
+          for (i = 0; i < n; i++)
+            gsl_vector_set (v, i, v_pos[i]);
+        }
+      }
+    }
+
+    _NCM_FUNCTION_CACHE_READ_BARRIER (cache);
+
+    if (g_atomic_int_get (&cache->seq) == seq)
+      break;
+  }
+
+  return found;
+}
+
+/*
+ * Must be called between _ncm_function_cache_write_begin/end.
  */
-gboolean
-ncm_function_cache_get_near (NcmFunctionCache *cache, gdouble x, gdouble *x_found_ptr, gsl_vector **v, NcmFunctionCacheSearchType type)
+static void
+_ncm_function_cache_store (NcmFunctionCache *cache, const gdouble x, const gdouble *vals, gboolean overwrite)
 {
-  NcParamsCacheSearch search = {FALSE, x, 0.0, GSL_POSINF, 0, NC_FUNCTION_CACHE_SEARCH_BOTH};
-  gsl_vector *res = NULL;
+  const guint n = cache->n;
+  guint pos     = _ncm_function_cache_lower_bound (cache->x, cache->len, x);
 
-  g_mutex_lock (&cache->lock);
-  search.type = type;
-
-  if (cache_clean (cache))
+  if ((pos < cache->len) && (gsl_fcmp (cache->x[pos], x, _NCM_FUNCTION_CACHE_KEY_RELTOL) == 0))
   {
-      g_mutex_unlock (&cache->lock);
-    return FALSE;
+    if (overwrite)
+    {
+      memcpy (&cache->v[pos * n], vals, sizeof (gdouble) * n);
+      cache->stamp[pos] = cache->nstamp++;
+    }
+    return;
   }
-
-  g_tree_search (cache->tree, &gdouble_search_near, &search);
-  if (search.found)
+  else if ((pos > 0) && (gsl_fcmp (cache->x[pos - 1], x, _NCM_FUNCTION_CACHE_KEY_RELTOL) == 0))
   {
-    res = g_tree_lookup (cache->tree, &search.x);
-    *x_found_ptr = search.x;
-    *v = res;
+    if (overwrite)
+    {
+      memcpy (&cache->v[(pos - 1) * n], vals, sizeof (gdouble) * n);
+      cache->stamp[pos - 1] = cache->nstamp++;
+    }
+    return;
   }
-  if (res == NULL)
+
+  if (cache->len == cache->max_size)
   {
-      g_mutex_unlock (&cache->lock);
-    return FALSE;
+    guint oldest = 0, i;
+
+    for (i = 1; i < cache->len; i++)
+    {
+      if (cache->stamp[i] < cache->stamp[oldest])
+        oldest = i;
+    }
+
+    memmove (&cache->x[oldest], &cache->x[oldest + 1], sizeof (gdouble) * (cache->len - oldest - 1));
+    memmove (&cache->stamp[oldest], &cache->stamp[oldest + 1], sizeof (guint64) * (cache->len - oldest - 1));
+    memmove (&cache->v[oldest * n], &cache->v[(oldest + 1) * n], sizeof (gdouble) * n * (cache->len - oldest - 1));
+    cache->len--;
+
+    if (oldest < pos)
+      pos--;
   }
-  *v = res;
 
-    g_mutex_unlock (&cache->lock);
-  return TRUE;
+  memmove (&cache->x[pos + 1], &cache->x[pos], sizeof (gdouble) * (cache->len - pos));
+  memmove (&cache->stamp[pos + 1], &cache->stamp[pos], sizeof (guint64) * (cache->len - pos));
+  memmove (&cache->v[(pos + 1) * n], &cache->v[pos * n], sizeof (gdouble) * n * (cache->len - pos));
+
+  cache->x[pos]     = x;
+  cache->stamp[pos] = cache->nstamp++;
+  memcpy (&cache->v[pos * n], vals, sizeof (gdouble) * n);
+
+  cache->len++;
 }
 
 /**
- * ncm_function_cache_get: (skip)
+ * ncm_function_cache_empty:
  * @cache: a #NcmFunctionCache
- * @x_ptr: FIXME
- * @v: FIXME
  *
- * FIXME
+ * Removes all keys from @cache.
  *
- * Returns: FIXME
  */
-gboolean
-ncm_function_cache_get (NcmFunctionCache *cache, gdouble *x_ptr, gsl_vector **v)
+void
+ncm_function_cache_empty (NcmFunctionCache *cache)
 {
-  gsl_vector *res;
-
-  g_mutex_lock (&cache->lock);
-
-  if (cache_clean (cache))
-  {
-    g_mutex_unlock (&cache->lock);
-    return FALSE;
-  }
-  res = g_tree_lookup (cache->tree, x_ptr);
-  if (res == NULL)
-  {
-    g_mutex_unlock (&cache->lock);
-    return FALSE;
-  }
-
-  *v = res;
-  g_mutex_unlock (&cache->lock);
-  return TRUE;
+  _ncm_function_cache_write_begin (cache);
+  cache->len = 0;
+  _ncm_function_cache_write_end (cache);
 }
 
-gboolean
-cache_clean (NcmFunctionCache *cache)
+/**
+ * ncm_function_cache_len:
+ * @cache: a #NcmFunctionCache
+ *
+ * Returns: the number of keys currently in @cache.
+ */
+guint
+ncm_function_cache_len (NcmFunctionCache *cache)
 {
-  if (cache->clear)
-  {
-    g_tree_destroy (cache->tree);
-    cache->tree = g_tree_new_full (&gdouble_compare, NULL, &gdouble_free, (GDestroyNotify)&gsl_vector_free);
-    cache->clear = FALSE;
-    return TRUE;
-  }
-  return FALSE;
+  return g_atomic_int_get ((gint *) &cache->len);
 }
 
-static gint
-gdouble_compare (gconstpointer a, gconstpointer b, gpointer user_data)
+/**
+ * ncm_function_cache_insert_vector: (skip)
+ * @cache: a #NcmFunctionCache
+ * @x: key
+ * @p: values
+ *
+ * Copies the values in @p to the cache using the key @x, if @x is already
+ * present its values are replaced.
+ *
+ */
+void
+ncm_function_cache_insert_vector (NcmFunctionCache *cache, gdouble x, gsl_vector *p)
 {
-  //  printf ("BLOB %g %g\n", *((gdouble *)a), *((gdouble *)b));
-  NCM_UNUSED (user_data);
-  return gsl_fcmp ( *((gdouble *)a), *((gdouble *)b), 1e-15);
-}
+  gdouble vals[cache->n];
+  guint i;
 
-#define SX (*((gdouble *)a))
+  g_assert_cmpuint (cache->n, ==, p->size);
 
-static gint
-gdouble_search_near (gconstpointer a, gconstpointer b)
+  for (i = 0; i < cache->n; i++)
+    vals[i] = gsl_vector_get (p, i);
+
+  _ncm_function_cache_write_begin (cache);
+  _ncm_function_cache_store (cache, x, vals, TRUE);
+  _ncm_function_cache_write_end (cache);
+}
+
+/**
+ * ncm_function_cache_insert: (skip)
+ * @cache: a #NcmFunctionCache
+ * @x: key
+ * @...: the n values (gdouble)
+ *
+ * Inserts the values using the key @x, nothing is done if @x is already
+ * present.
+ *
+ */
+void
+ncm_function_cache_insert (NcmFunctionCache *cache, gdouble x, ...)
 {
-  NcParamsCacheSearch *search = (NcParamsCacheSearch *)b;
-  gdouble diff;
-  gboolean found = FALSE;
-  search->dir = gsl_fcmp (search->near_x, SX, NCM_ZERO_LIMIT);
-  diff = fabs (SX - search->near_x);
+  gdouble vals[cache->n];
+  va_list ap;
+  guint i;
 
-  switch (search->type)
-  {
-    case NC_FUNCTION_CACHE_SEARCH_BOTH:
-      found = TRUE;
-      break;
-    case NC_FUNCTION_CACHE_SEARCH_GT:
-      if (search->dir <= 0)
-        found = TRUE;
-      break;
-    case NC_FUNCTION_CACHE_SEARCH_LT:
-      if (search->dir >= 0)
-        found = TRUE;
-      break;
-  }
+  va_start (ap, x);
+  for (i = 0; i < cache->n; i++)
+    vals[i] = va_arg (ap, gdouble);
+  va_end (ap);
 
-  if ((diff < search->diff) && found)
-  {
-    search->found = TRUE;
-    search->x = SX;
-    search->diff = diff;
-  }
+  _ncm_function_cache_write_begin (cache);
+  _ncm_function_cache_store (cache, x, vals, FALSE);
+  _ncm_function_cache_write_end (cache);
+}
 
-  return search->dir;
+/**
+ * ncm_function_cache_get_near: (skip)
+ * @cache: a #NcmFunctionCache
+ * @x: the key
+ * @x_found_ptr: (out): the key found
+ * @v: a gsl_vector of length n
+ * @type: a #NcmFunctionCacheSearchType
+ * 
+ * Looks for the key nearest to @x in the direction @type, if found the key
+ * is copied to @x_found_ptr and its values to @v. This function does not
+ * lock @cache.
+ *
+ * Returns: whether a key was found.
+ */
+gboolean
+ncm_function_cache_get_near (NcmFunctionCache *cache, gdouble x, gdouble *x_found_ptr, gsl_vector *v, NcmFunctionCacheSearchType type)
+{
+  return _ncm_function_cache_read (cache, x, x_found_ptr, v, type, FALSE);
 }
 
-static void
-gdouble_free (gpointer data)
+/**
+ * ncm_function_cache_get: (skip)
+ * @cache: a #NcmFunctionCache
+ * @x_ptr: a pointer to the key
+ * @v: a gsl_vector of length n
+ *
+ * Looks for the key *@x_ptr (up to a relative difference of 1.0e-15), if
+ * found its values are copied to @v. This function does not lock @cache.
+ *
+ * Returns: whether the key was found.
+ */
+gboolean
+ncm_function_cache_get (NcmFunctionCache *cache, gdouble *x_ptr, gsl_vector *v)
 {
-  g_slice_free (gdouble, data);
+  gdouble x_found;
+
+  return _ncm_function_cache_read (cache, *x_ptr, &x_found, v, NC_FUNCTION_CACHE_SEARCH_BOTH, TRUE);
 }
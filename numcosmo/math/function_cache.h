@@ -35,11 +35,11 @@ G_BEGIN_DECLS
 
 /**
  * NcmFunctionCacheSearchType:
- * @NC_FUNCTION_CACHE_SEARCH_BOTH: FIXME
- * @NC_FUNCTION_CACHE_SEARCH_GT: FIXME
- * @NC_FUNCTION_CACHE_SEARCH_LT: FIXME
+ * @NC_FUNCTION_CACHE_SEARCH_BOTH: nearest key on either side
+ * @NC_FUNCTION_CACHE_SEARCH_GT: nearest key greater than or equal to the argument
+ * @NC_FUNCTION_CACHE_SEARCH_LT: nearest key less than or equal to the argument
  *
- * FIXME
+ * Search direction used by ncm_function_cache_get_near().
  */
 typedef enum _NcmFunctionCacheSearchType
 {
@@ -53,21 +53,31 @@ typedef struct _NcmFunctionCache NcmFunctionCache;
 struct _NcmFunctionCache
 {
   /*< private >*/
-  GTree *tree;
   GMutex lock;
-  gboolean clear;
+  volatile gint seq;
   guint n;
+  guint max_size;
+  guint len;
+  guint64 nstamp;
+  gdouble *x;
+  gdouble *v;
+  guint64 *stamp;
   gdouble abstol;
   gdouble reltol;
 };
 
+#define NCM_FUNCTION_CACHE_DEFAULT_MAX_SIZE (1024)
+
 NcmFunctionCache *ncm_function_cache_new (guint n, gdouble abstol, gdouble reltol);
+NcmFunctionCache *ncm_function_cache_new_full (guint n, guint max_size, gdouble abstol, gdouble reltol);
 void ncm_function_cache_free (NcmFunctionCache *cache);
 void ncm_function_cache_clear (NcmFunctionCache **cache);
+void ncm_function_cache_empty (NcmFunctionCache *cache);
+guint ncm_function_cache_len (NcmFunctionCache *cache);
 void ncm_function_cache_insert (NcmFunctionCache *cache, gdouble x, ...);
 void ncm_function_cache_insert_vector (NcmFunctionCache *cache, gdouble x, gsl_vector *p);
-gboolean ncm_function_cache_get (NcmFunctionCache *cache, gdouble *x_ptr, gsl_vector **v);
-gboolean ncm_function_cache_get_near (NcmFunctionCache *cache, gdouble x, gdouble *x_found_ptr, gsl_vector **v, NcmFunctionCacheSearchType type);
+gboolean ncm_function_cache_get (NcmFunctionCache *cache, gdouble *x_ptr, gsl_vector *v);
+gboolean ncm_function_cache_get_near (NcmFunctionCache *cache, gdouble x, gdouble *x_found_ptr, gsl_vector *v, NcmFunctionCacheSearchType type);
 
 #define NC_FUNCTION_CACHE(p) ((NcmFunctionCache *)(p))
 
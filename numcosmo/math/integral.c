@@ -159,12 +159,13 @@ gint
 ncm_integral_cached_0_x (NcmFunctionCache *cache, gsl_function *F, gdouble x, gdouble *result, gdouble *error)
 {
   gdouble x_found = 0.0;
-//  gdouble p_result = 0.0;
-  gsl_vector *p_result;
+  gdouble p_result_val = 0.0;
+  gsl_vector_view p_result_vv = gsl_vector_view_array (&p_result_val, 1);
+  gsl_vector *p_result = &p_result_vv.vector;
   gint error_code = GSL_SUCCESS;
 
 //printf ("[%p]SEARCH! -> %g\n", g_thread_self (), x);
-  if (ncm_function_cache_get_near (cache, x, &x_found, &p_result, NC_FUNCTION_CACHE_SEARCH_BOTH))
+  if (ncm_function_cache_get_near (cache, x, &x_found, p_result, NC_FUNCTION_CACHE_SEARCH_BOTH))
   {
 //printf ("[%p]Found out %g %g [%p]\n", g_thread_self (), x_found, gsl_vector_get (p_result, 0), p_result);
     if (x == x_found)
@@ -202,11 +203,12 @@ gint
 ncm_integral_cached_x_inf (NcmFunctionCache *cache, gsl_function *F, gdouble x, gdouble *result, gdouble *error)
 {
   gdouble x_found = 0.0;
-//  gdouble p_result = 0.0;
-  gsl_vector *p_result;
+  gdouble p_result_val = 0.0;
+  gsl_vector_view p_result_vv = gsl_vector_view_array (&p_result_val, 1);
+  gsl_vector *p_result = &p_result_vv.vector;
   gint error_code = GSL_SUCCESS;
 
-  if (ncm_function_cache_get_near (cache, x, &x_found, &p_result, NC_FUNCTION_CACHE_SEARCH_BOTH))
+  if (ncm_function_cache_get_near (cache, x, &x_found, p_result, NC_FUNCTION_CACHE_SEARCH_BOTH))
   {
     if (x == x_found)
     {
@@ -702,6 +704,313 @@ ncm_integrate_3dim_vegas (NcmIntegrand3dim *integ, gdouble xi, gdouble yi, gdoub
 	return ret;
 }
 
+typedef struct _iCLIntegrand2dimVec
+{
+	NcmIntegrand2dimVec *integ;
+	gdouble xi;
+	gdouble xf;
+	gdouble yi;
+	gdouble yf;
+} iCLIntegrand2dimVec;
+
+static gint
+_integrand_2dim_vec (const gint *ndim, const gdouble x[], const gint *ncomp, gdouble f[], gpointer userdata, const gint *nvec)
+{
+	iCLIntegrand2dimVec *iinteg = (iCLIntegrand2dimVec *) userdata;
+  const gdouble dx = iinteg->xf - iinteg->xi;
+  const gdouble dy = iinteg->yf - iinteg->yi;
+  gdouble xv[NCM_INTEGRAL_NVEC];
+  gdouble yv[NCM_INTEGRAL_NVEC];
+  const gint np = *nvec;
+  gint i;
+  NCM_UNUSED (ndim);
+  NCM_UNUSED (ncomp);
+
+  g_assert_cmpint (np, <=, NCM_INTEGRAL_NVEC);
+
+  for (i = 0; i < np; i++)
+  {
+    xv[i] = dx * x[2 * i + 0] + iinteg->xi;
+    yv[i] = dy * x[2 * i + 1] + iinteg->yi;
+  }
+
+  iinteg->integ->f (xv, yv, np, f, iinteg->integ->userdata);
+	return 0;
+}
+
+#if defined (HAVE_LIBCUBA_3_1) || !(defined (HAVE_LIBCUBA_3_3) || defined (HAVE_LIBCUBA_4_0))
+static gint
+_integrand_2dim_vec1 (const gint *ndim, const gdouble x[], const gint *ncomp, gdouble f[], gpointer userdata)
+{
+  const gint nvec = 1;
+  return _integrand_2dim_vec (ndim, x, ncomp, f, userdata, &nvec);
+}
+#endif
+
+/**
+ * ncm_integrate_2dim_vec:
+ * @integ: a pointer to #NcmIntegrand2dimVec.
+ * @xi: gbouble which is the lower integration limit of variable x.
+ * @yi: gbouble which is the lower integration limit of variable y.
+ * @xf: gbouble which is the upper integration limit of variable x.
+ * @yf: gbouble which is the upper integration limit of variable y.
+ * @epsrel: relative error
+ * @epsabs: absolute error
+ * @result: a pointer to a gdouble in which the function stores the result.
+ * @error: a pointer to a gdouble in which the function stores the estimated error.
+ *
+ * Same as ncm_integrate_2dim() but using a vectorized integrand, Cuhre
+ * passes blocks of up to #NCM_INTEGRAL_NVEC points in each call. When
+ * the libcuba version does not support vectorized integrands the points
+ * are passed one at a time.
+ *
+ * Returns: a gboolean
+ */
+gboolean
+ncm_integrate_2dim_vec (NcmIntegrand2dimVec *integ, gdouble xi, gdouble yi, gdouble xf, gdouble yf, gdouble epsrel, gdouble epsabs, gdouble *result, gdouble *error)
+{
+  gboolean ret = FALSE;
+	const gint mineval = 1;
+	const gint maxeval = 10000000;
+	const gint key = 13; /* 13 points rule */
+  iCLIntegrand2dimVec iinteg = {integ, xi, xf, yi, yf};
+	gint nregions, neval, fail;
+	gdouble prob;
+
+#ifdef HAVE_LIBCUBA_3_1
+	Cuhre (2, 1, &_integrand_2dim_vec1, &iinteg, epsrel, epsabs, 0, mineval, maxeval, key, NULL, &nregions, &neval, &fail, result, error, &prob);
+#elif defined (HAVE_LIBCUBA_3_3)
+	Cuhre (2, 1, (integrand_t) &_integrand_2dim_vec, &iinteg, NCM_INTEGRAL_NVEC, epsrel, epsabs, 0, mineval, maxeval, key, NULL, &nregions, &neval, &fail, result, error, &prob);
+#elif defined (HAVE_LIBCUBA_4_0)
+	Cuhre (2, 1, (integrand_t) &_integrand_2dim_vec, &iinteg, NCM_INTEGRAL_NVEC, epsrel, epsabs, 0, mineval, maxeval, key, NULL, NULL, &nregions, &neval, &fail, result, error, &prob);
+#else
+  Cuhre (2, 1, &_integrand_2dim_vec1, &iinteg, epsrel, epsabs, 0, mineval, maxeval, key, &nregions, &neval, &fail, result, error, &prob);
+#endif /* HAVE_LIBCUBA_3_1 */         
+
+  if (neval >= maxeval)
+    g_warning ("ncm_integrate_2dim_vec: number of evaluations %d >= maximum number of evaluations %d.\n", neval, maxeval);
+  
+	*result *= (xf - xi) * (yf - yi);
+	*error *= (xf - xi) * (yf - yi);
+
+	ret = (fail == 0);
+	return ret;
+}
+
+/**
+ * ncm_integrate_2dim_vec_divonne:
+ * @integ: a pointer to #NcmIntegrand2dimVec
+ * @xi: gbouble which is the lower integration limit of variable x.
+ * @yi: gbouble which is the lower integration limit of variable y.
+ * @xf: gbouble which is the upper integration limit of variable x.
+ * @yf: gbouble which is the upper integration limit of variable y.
+ * @epsrel: relative error
+ * @epsabs: absolute error
+ * @ngiven: number of peaks
+ * @ldxgiven: the leading dimension of xgiven, i.e. the offset between one
+ * point and the next in memory (ref. libcuba documentation)
+ * @xgiven: list of points where the integrand might have peaks (ref. libcuba documentation)
+ * @result: a pointer to a gdouble in which the function stores the result.
+ * @error: a pointer to a gdouble in which the function stores the estimated error.
+ *
+ * Same as ncm_integrate_2dim_divonne() but using a vectorized integrand.
+ *
+ * Returns: a gboolean
+ */
+gboolean
+ncm_integrate_2dim_vec_divonne (NcmIntegrand2dimVec *integ, gdouble xi, gdouble yi, gdouble xf, gdouble yf, gdouble epsrel, gdouble epsabs, const gint ngiven, const gint ldxgiven, gdouble xgiven[], gdouble *result, gdouble *error)
+{
+  gboolean ret = FALSE;
+  const gint nvec = NCM_INTEGRAL_NVEC;
+  const gint seed = 0;
+	const gint mineval = 1;
+	const gint maxeval = G_MAXINT;
+	const gint key1 = 13; /* 13 points rule */
+  const gint key2 = 13;
+  const gint key3 = 1;
+  const int maxpass = 1;
+  const double border = 0.0;
+  const double maxchisq = 0.10;
+  const double mindeviation = 0.25;
+  const int nextra = 0;
+  peakfinder_t peakfinder = NULL;
+  
+  iCLIntegrand2dimVec iinteg = {integ, xi, xf, yi, yf};
+	gint nregions, neval, fail, i;
+	gdouble prob;
+
+  for (i = 0; i < ngiven; i++)
+  {
+    xgiven[i * ldxgiven + 0] = (xgiven[i * ldxgiven + 0] - xi) / (xf - xi);
+    xgiven[i * ldxgiven + 1] = (xgiven[i * ldxgiven + 1] - yi) / (yf - yi);
+  }
+
+#ifdef HAVE_LIBCUBA_4_0
+	Divonne (2, 1, (integrand_t) &_integrand_2dim_vec, &iinteg, nvec, epsrel, epsabs, 0, seed, mineval, maxeval, key1, key2, key3, maxpass, border, 
+           maxchisq, mindeviation, ngiven, ldxgiven, xgiven, nextra, peakfinder, NULL, NULL, &nregions, &neval, &fail, 
+           result, error, &prob);  
+#else
+  g_error ("ncm_integrate_2dim_vec_divonne: Needs libcuba > 4.0.");
+#endif //HAVE_LIBCUBA_4_0  
+
+  if (neval >= maxeval)
+    g_warning ("ncm_integrate_2dim_vec_divonne: number of evaluations %d >= maximum number of evaluations %d.\n", neval, maxeval);
+ 
+	*result *= (xf - xi) * (yf - yi);
+	*error  *= (xf - xi) * (yf - yi);
+
+	ret = (fail == 0);
+	return ret;
+}
+
+/**
+ * ncm_integrate_2dim_vec_vegas:
+ * @integ: a pointer to #NcmIntegrand2dimVec
+ * @xi: gbouble which is the lower integration limit of variable x.
+ * @yi: gbouble which is the lower integration limit of variable y.
+ * @xf: gbouble which is the upper integration limit of variable x.
+ * @yf: gbouble which is the upper integration limit of variable y.
+ * @epsrel: relative error
+ * @epsabs: absolute error
+ * @nstart: number of samples to start the first round of integration with.
+ * @result: a pointer to a gdouble in which the function stores the result.
+ * @error: a pointer to a gdouble in which the function stores the estimated error.
+ *
+ * Same as ncm_integrate_2dim_vegas() but using a vectorized integrand.
+ *
+ * Returns: a gboolean
+ */
+gboolean
+ncm_integrate_2dim_vec_vegas (NcmIntegrand2dimVec *integ, gdouble xi, gdouble yi, gdouble xf, gdouble yf, gdouble epsrel, gdouble epsabs, const gint nstart, gdouble *result, gdouble *error)
+{
+  gboolean ret = FALSE;
+  const gint nvec = NCM_INTEGRAL_NVEC;
+  const gint seed = 0;
+	const gint mineval = 1;
+	const gint maxeval = 10000;
+	const gint nincrease = 500;
+  const int nbatch = 1000;
+  const int gridno = 0;
+  
+  iCLIntegrand2dimVec iinteg = {integ, xi, xf, yi, yf};
+	gint neval, fail;
+	gdouble prob;
+  
+#ifdef HAVE_LIBCUBA_4_0
+	Vegas (2, 1, (integrand_t) &_integrand_2dim_vec, &iinteg, nvec, epsrel, epsabs, 0, seed, mineval, maxeval, 
+         nstart, nincrease, nbatch, gridno, NULL, NULL, &neval, &fail, result, error, &prob);  
+#else
+  g_error ("ncm_integrate_2dim_vec_vegas: Needs libcuba > 4.0.");
+#endif //HAVE_LIBCUBA_4_0  
+
+  if (neval >= maxeval)
+    g_warning ("ncm_integrate_2dim_vec_vegas: number of evaluations %d >= maximum number of evaluations %d.\n", neval, maxeval);
+    
+	*result *= (xf - xi) * (yf - yi);
+	*error  *= (xf - xi) * (yf - yi);
+
+	ret = (fail == 0);
+	return ret;
+}
+
+typedef struct _iCLIntegrand3dimVec
+{
+	NcmIntegrand3dimVec *integ;
+	gdouble xi;
+	gdouble xf;
+	gdouble yi;
+	gdouble yf;
+  gdouble zi;
+	gdouble zf;
+} iCLIntegrand3dimVec;
+
+static gint
+_integrand_3dim_vec (const gint *ndim, const gdouble x[], const gint *ncomp, gdouble f[], gpointer userdata, const gint *nvec)
+{
+	iCLIntegrand3dimVec *iinteg = (iCLIntegrand3dimVec *) userdata;
+  const gdouble dx = iinteg->xf - iinteg->xi;
+  const gdouble dy = iinteg->yf - iinteg->yi;
+  const gdouble dz = iinteg->zf - iinteg->zi;
+  gdouble xv[NCM_INTEGRAL_NVEC];
+  gdouble yv[NCM_INTEGRAL_NVEC];
+  gdouble zv[NCM_INTEGRAL_NVEC];
+  const gint np = *nvec;
+  gint i;
+  NCM_UNUSED (ndim);
+  NCM_UNUSED (ncomp);
+
+  g_assert_cmpint (np, <=, NCM_INTEGRAL_NVEC);
+
+  for (i = 0; i < np; i++)
+  {
+    xv[i] = dx * x[3 * i + 0] + iinteg->xi;
+    yv[i] = dy * x[3 * i + 1] + iinteg->yi;
+    zv[i] = dz * x[3 * i + 2] + iinteg->zi;
+  }
+
+  iinteg->integ->f (xv, yv, zv, np, f, iinteg->integ->userdata);
+	return 0;
+}
+
+#if defined (HAVE_LIBCUBA_3_1) || !(defined (HAVE_LIBCUBA_3_3) || defined (HAVE_LIBCUBA_4_0))
+static gint
+_integrand_3dim_vec1 (const gint *ndim, const gdouble x[], const gint *ncomp, gdouble f[], gpointer userdata)
+{
+  const gint nvec = 1;
+  return _integrand_3dim_vec (ndim, x, ncomp, f, userdata, &nvec);
+}
+#endif
+
+/**
+ * ncm_integrate_3dim_vec:
+ * @integ: a pointer to #NcmIntegrand3dimVec.
+ * @xi: gbouble which is the lower integration limit of variable x.
+ * @yi: gbouble which is the lower integration limit of variable y.
+ * @zi: gbouble which is the lower integration limit of variable z.
+ * @xf: gbouble which is the upper integration limit of variable x.
+ * @yf: gbouble which is the upper integration limit of variable y.
+ * @zf: gbouble which is the upper integration limit of variable z.
+ * @epsrel: relative error
+ * @epsabs: absolute error
+ * @result: a pointer to a gdouble in which the function stores the result.
+ * @error: a pointer to a gdouble in which the function stores the estimated error.
+ *
+ * Same as ncm_integrate_3dim() but using a vectorized integrand, see
+ * ncm_integrate_2dim_vec().
+ *
+ * Returns: a gboolean
+ */
+gboolean
+ncm_integrate_3dim_vec (NcmIntegrand3dimVec *integ, gdouble xi, gdouble yi, gdouble zi, gdouble xf, gdouble yf, gdouble zf, gdouble epsrel, gdouble epsabs, gdouble *result, gdouble *error)
+{
+  gboolean ret = FALSE;
+	const gint mineval = 1;
+	const gint maxeval = 10000000;
+	const gint key = 11; /* 11 points rule */
+  iCLIntegrand3dimVec iinteg = {integ, xi, xf, yi, yf, zi, zf};
+	gint nregions, neval, fail;
+	gdouble prob;
+
+#ifdef HAVE_LIBCUBA_3_1
+	Cuhre (3, 1, &_integrand_3dim_vec1, &iinteg, epsrel, epsabs, 0, mineval, maxeval, key, NULL, &nregions, &neval, &fail, result, error, &prob);
+#elif defined (HAVE_LIBCUBA_3_3)
+	Cuhre (3, 1, (integrand_t) &_integrand_3dim_vec, &iinteg, NCM_INTEGRAL_NVEC, epsrel, epsabs, 0, mineval, maxeval, key, NULL, &nregions, &neval, &fail, result, error, &prob);
+#elif defined (HAVE_LIBCUBA_4_0)
+	Cuhre (3, 1, (integrand_t) &_integrand_3dim_vec, &iinteg, NCM_INTEGRAL_NVEC, epsrel, epsabs, 0, mineval, maxeval, key, NULL, NULL, &nregions, &neval, &fail, result, error, &prob);
+#else
+  Cuhre (3, 1, &_integrand_3dim_vec1, &iinteg, epsrel, epsabs, 0, mineval, maxeval, key, &nregions, &neval, &fail, result, error, &prob);
+#endif /* HAVE_LIBCUBA_3_1 */         
+
+  if (neval >= maxeval)
+    g_warning ("ncm_integrate_3dim_vec: number of evaluations %d >= maximum number of evaluations %d.\n", neval, maxeval);
+    
+	*result *= (xf - xi) * (yf - yi) * (zf - zi);
+	*error *= (xf - xi) * (yf - yi) * (zf - zi);
+
+	ret = (fail == 0);
+	return ret;
+}
+
 /**
  * ncm_integral_fixed_new: (skip)
  * @n_nodes: number of nodes in the full interval.
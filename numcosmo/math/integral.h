@@ -67,6 +67,40 @@ struct _NcmIntegrand3dim
   _NcmIntegrand3dimFunc f;
 };
 
+typedef struct _NcmIntegrand2dimVec NcmIntegrand2dimVec;
+typedef void (*_NcmIntegrand2dimVecFunc) (const gdouble *x, const gdouble *y, const guint np, gdouble *f, gpointer userdata);
+
+/**
+ * NcmIntegrand2dimVec:
+ *
+ * Vectorized two dimensional integrand, the function receives
+ * blocks of up to #NCM_INTEGRAL_NVEC points (x[i], y[i]) and
+ * must fill f[i] for i = 0, ..., np - 1.
+ */
+struct _NcmIntegrand2dimVec
+{
+  /*< private >*/
+  gpointer userdata;
+  _NcmIntegrand2dimVecFunc f;
+};
+
+typedef struct _NcmIntegrand3dimVec NcmIntegrand3dimVec;
+typedef void (*_NcmIntegrand3dimVecFunc) (const gdouble *x, const gdouble *y, const gdouble *z, const guint np, gdouble *f, gpointer userdata);
+
+/**
+ * NcmIntegrand3dimVec:
+ *
+ * Vectorized three dimensional integrand, the function receives
+ * blocks of up to #NCM_INTEGRAL_NVEC points (x[i], y[i], z[i]) and
+ * must fill f[i] for i = 0, ..., np - 1.
+ */
+struct _NcmIntegrand3dimVec
+{
+  /*< private >*/
+  gpointer userdata;
+  _NcmIntegrand3dimVecFunc f;
+};
+
 typedef struct _NcmIntegralFixed NcmIntegralFixed;
 
 /**
@@ -102,6 +136,11 @@ gboolean ncm_integrate_3dim (NcmIntegrand3dim *integ, gdouble xi, gdouble yi, gd
 gboolean ncm_integrate_3dim_divonne (NcmIntegrand3dim *integ, gdouble xi, gdouble yi, gdouble zi, gdouble xf, gdouble yf, gdouble zf, gdouble epsrel, gdouble epsabs, const gint ngiven, const gint ldxgiven, gdouble xgiven[], gdouble *result, gdouble *error);
 gboolean ncm_integrate_3dim_vegas (NcmIntegrand3dim *integ, gdouble xi, gdouble yi, gdouble zi, gdouble xf, gdouble yf, gdouble zf, gdouble epsrel, gdouble epsabs, const gint nstart, gdouble *result, gdouble *error);
 
+gboolean ncm_integrate_2dim_vec (NcmIntegrand2dimVec *integ, gdouble xi, gdouble yi, gdouble xf, gdouble yf, gdouble epsrel, gdouble epsabs, gdouble *result, gdouble *error);
+gboolean ncm_integrate_2dim_vec_divonne (NcmIntegrand2dimVec *integ, gdouble xi, gdouble yi, gdouble xf, gdouble yf, gdouble epsrel, gdouble epsabs, const gint ngiven, const gint ldxgiven, gdouble xgiven[], gdouble *result, gdouble *error);
+gboolean ncm_integrate_2dim_vec_vegas (NcmIntegrand2dimVec *integ, gdouble xi, gdouble yi, gdouble xf, gdouble yf, gdouble epsrel, gdouble epsabs, const gint nstart, gdouble *result, gdouble *error);
+gboolean ncm_integrate_3dim_vec (NcmIntegrand3dimVec *integ, gdouble xi, gdouble yi, gdouble zi, gdouble xf, gdouble yf, gdouble zf, gdouble epsrel, gdouble epsabs, gdouble *result, gdouble *error);
+
 NcmIntegralFixed *ncm_integral_fixed_new (gulong n_nodes, gulong rule_n, gdouble xl, gdouble xu);
 void ncm_integral_fixed_free (NcmIntegralFixed *intf);
 void ncm_integral_fixed_calc_nodes (NcmIntegralFixed *intf, gsl_function *F);
@@ -113,6 +152,7 @@ gdouble ncm_integral_fixed_integ_posdef_mult (NcmIntegralFixed *intf, gsl_functi
 #define NCM_INTEGRAL_ALG 6
 #define NCM_INTEGRAL_ERROR 1e-13
 #define NCM_INTEGRAL_ABS_ERROR 0.0
+#define NCM_INTEGRAL_NVEC 128
 
 G_END_DECLS
 
@@ -148,6 +148,32 @@ ncm_memory_pool_add (NcmMemoryPool *mp, gpointer p)
   g_mutex_unlock (&mp->update);
 }
 
+/**
+ * ncm_memory_pool_foreach: (skip)
+ * @mp: a #NcmMemoryPool
+ * @func: a #GFunc
+ * @user_data: user data passed to @func
+ *
+ * Calls @func for each pointer allocated by or added to the pool, passing it
+ * as the first argument of @func. The slices in use are also visited, so
+ * the caller must make sure they are not being modified, e.g., after all
+ * threads using the pool have finished.
+ *
+ */
+void
+ncm_memory_pool_foreach (NcmMemoryPool *mp, GFunc func, gpointer user_data)
+{
+  guint i;
+
+  g_mutex_lock (&mp->update);
+  for (i = 0; i < mp->slices->len; i++)
+  {
+    NcmMemoryPoolSlice *slice = (NcmMemoryPoolSlice *)g_ptr_array_index (mp->slices, i);
+    func (slice->p, user_data);
+  }
+  g_mutex_unlock (&mp->update);
+}
+
 /**
  * ncm_memory_pool_get:
  * @mp: a #NcmMemoryPool
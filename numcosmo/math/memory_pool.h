@@ -72,6 +72,7 @@ NcmMemoryPool *ncm_memory_pool_new (NcmMemoryPoolAlloc mp_alloc, gpointer userda
 void ncm_memory_pool_free (NcmMemoryPool *mp, gboolean free_slices);
 void ncm_memory_pool_set_min_size (NcmMemoryPool *mp, gsize n);
 void ncm_memory_pool_add (NcmMemoryPool *mp, gpointer p);
+void ncm_memory_pool_foreach (NcmMemoryPool *mp, GFunc func, gpointer user_data);
 gpointer ncm_memory_pool_get (NcmMemoryPool *mp);
 void ncm_memory_pool_return (gpointer p);
 
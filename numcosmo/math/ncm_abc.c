@@ -39,8 +39,15 @@
 
 #include "math/ncm_abc.h"
 #include "math/ncm_func_eval.h"
+#include "math/ncm_mset_trans_kern_gauss.h"
+#include "math/ncm_c.h"
 
 #include <gsl/gsl_statistics_double.h>
+#include <gsl/gsl_blas.h>
+#include <gsl/gsl_sort.h>
+
+#define NCM_ABC_WEIGHT_BLOCK_Z (64)
+#define NCM_ABC_WEIGHT_BLOCK_Y (256)
 
 enum
 {
@@ -78,6 +85,16 @@ ncm_abc_init (NcmABC *abc)
   abc->epsilon       = 0.0;
   abc->depsilon      = 0.0;
   abc->wran          = NULL;
+  abc->wY            = NULL;
+  abc->wY_n2         = NULL;
+  abc->wY_w          = NULL;
+  abc->acc_theta     = NULL;
+  abc->acc_wZ        = NULL;
+  abc->acc_dist      = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  abc->acc_prior     = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  abc->acc_denom     = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  abc->acc_order     = g_array_new (FALSE, FALSE, sizeof (gsize));
+  abc->wtrunc        = 0.0;
   abc->started       = FALSE;
   abc->started_up    = FALSE;
   abc->cur_sample_id = -1; /* Represents that no samples were calculated yet. */
@@ -196,6 +213,16 @@ _ncm_abc_dispose (GObject *object)
   g_clear_pointer (&abc->dists, g_array_unref);
   g_clear_pointer (&abc->wran, gsl_ran_discrete_free);
 
+  ncm_matrix_clear (&abc->wY);
+  ncm_vector_clear (&abc->wY_n2);
+  ncm_vector_clear (&abc->wY_w);
+  ncm_matrix_clear (&abc->acc_theta);
+  ncm_matrix_clear (&abc->acc_wZ);
+  g_clear_pointer (&abc->acc_dist, g_array_unref);
+  g_clear_pointer (&abc->acc_prior, g_array_unref);
+  g_clear_pointer (&abc->acc_denom, g_array_unref);
+  g_clear_pointer (&abc->acc_order, g_array_unref);
+
   if (abc->mp != NULL)
   {
     ncm_memory_pool_free (abc->mp, TRUE);
@@ -473,6 +500,26 @@ ncm_abc_set_trans_kern (NcmABC *abc, NcmMSetTransKern *tkern)
   abc->tkern = ncm_mset_trans_kern_ref (tkern);
 }
 
+/**
+ * ncm_abc_set_weight_trunc:
+ * @abc: a #NcmABC
+ * @nsigma: truncation radius in units of the kernel standard deviation
+ * 
+ * When the transition kernel is a #NcmMSetTransKernGauss the importance
+ * weights of a new population are computed in a batch, using the
+ * previous population whitened by the kernel Cholesky factor. If @nsigma
+ * is positive, the kernel contributions of the previous particles farther
+ * than @nsigma (in the whitened space) from a new particle are neglected.
+ * Use zero (default) to disable the truncation.
+ *
+ */
+void 
+ncm_abc_set_weight_trunc (NcmABC *abc, gdouble nsigma)
+{
+  g_assert_cmpfloat (nsigma, >=, 0.0);
+  abc->wtrunc = nsigma;
+}
+
 static gint 
 _compare (gconstpointer a, gconstpointer b)
 {
@@ -924,6 +971,7 @@ typedef struct _NcmABCThread
   NcmMSet *mset;
   NcmDataset *dset;
   NcmVector *thetastar;
+  NcmVector *theta;
   NcmRNG *rng;
 } NcmABCThread;
 
@@ -939,6 +987,7 @@ _ncm_abc_dup_thread (gpointer userdata)
     abct->mset      = ncm_mset_dup (abc->mcat->mset, abc->ser);
     abct->dset      = ncm_dataset_dup (abc->dset, abc->ser);
     abct->thetastar = ncm_vector_dup (abc->thetastar);
+    abct->theta     = NULL;
     abct->rng       = ncm_rng_new (NULL);
 
     ncm_rng_set_seed (abct->rng, gsl_rng_get (abc->mcat->rng->r));
@@ -958,6 +1007,7 @@ _ncm_abc_free_thread (gpointer data)
   ncm_mset_clear (&abct->mset);
   ncm_dataset_clear (&abct->dset);
   ncm_vector_clear (&abct->thetastar);
+  ncm_vector_clear (&abct->theta);
   ncm_rng_clear (&abct->rng);
   g_free (abct);
 }
@@ -1017,7 +1067,7 @@ _ncm_abc_run_mt (NcmABC *abc)
   
   g_assert_cmpuint (abc->nthreads, >, 1);
 
-  ncm_func_eval_threaded_loop_full (&_ncm_abc_thread_eval, 0, abc->n, abc);
+  ncm_func_eval_parallel_for (&_ncm_abc_thread_eval, 0, abc->n, 1, abc);
 }
 
 /**
@@ -1234,6 +1284,7 @@ ncm_abc_end_update (NcmABC *abc)
 
 static void _ncm_abc_update_single (NcmABC *abc);
 static void _ncm_abc_update_mt (NcmABC *abc);
+static void _ncm_abc_prepare_batch_weights (NcmABC *abc);
 
 /**
  * ncm_abc_update:
@@ -1274,6 +1325,9 @@ ncm_abc_update (NcmABC *abc)
   if (abc->mtype > NCM_FIT_RUN_MSGS_NONE)
     ncm_timer_task_log_start_datetime (abc->nt);
 
+  if (NCM_IS_MSET_TRANS_KERN_GAUSS (abc->tkern))
+    _ncm_abc_prepare_batch_weights (abc);
+
   if (abc->nthreads <= 1)
     _ncm_abc_update_single (abc);
   else
@@ -1283,18 +1337,293 @@ ncm_abc_update (NcmABC *abc)
   ncm_timer_task_pause (abc->nt);
 }
 
+/*
+ * Batched importance weights for Gaussian kernels.
+ *
+ * The previous population is whitened once using the kernel Cholesky
+ * factor L, y_k = L^{-1} theta_k, and sorted in its first whitened
+ * coordinate. The accepted particles of the current update are stored
+ * in slots and whitened in the same way at the end of the update, the
+ * kernel sums are then computed blockwise through
+ * |z - y|^2 = |z|^2 + |y|^2 - 2 z.y using dgemm.
+ */
+
+static void
+_ncm_abc_prepare_batch_weights (NcmABC *abc)
+{
+  NcmMSetTransKernGauss *tkerng = NCM_MSET_TRANS_KERN_GAUSS (abc->tkern);
+  const guint d                 = ncm_mset_fparams_len (abc->mcat->mset);
+  const guint np                = abc->nparticles;
+  NcmMatrix *Y                  = ncm_matrix_new (np, d);
+  GArray *order                 = g_array_sized_new (FALSE, FALSE, sizeof (gsize), np);
+  guint k, l;
+  gint ret;
+
+  g_assert_cmpuint (tkerng->len, ==, d);
+
+  for (k = 0; k < np; k++)
+  {
+    NcmVector *row = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + k);
+
+    for (l = 0; l < d; l++)
+      ncm_matrix_set (Y, k, l, ncm_vector_get (row, 2 + l));
+  }
+
+  ret = gsl_blas_dtrsm (CblasRight, CblasLower, CblasTrans, CblasNonUnit, 1.0, 
+                        ncm_matrix_gsl (tkerng->LLT), ncm_matrix_gsl (Y));
+  NCM_TEST_GSL_RESULT ("_ncm_abc_prepare_batch_weights", ret);
+
+  g_array_set_size (order, np);
+  gsl_sort_index ((gsize *) order->data, ncm_matrix_data (Y), ncm_matrix_tda (Y), np);
+
+  if ((abc->wY == NULL) || (ncm_matrix_nrows (abc->wY) != np) || (ncm_matrix_ncols (abc->wY) != d))
+  {
+    ncm_matrix_clear (&abc->wY);
+    ncm_vector_clear (&abc->wY_n2);
+    ncm_vector_clear (&abc->wY_w);
+
+    abc->wY    = ncm_matrix_new (np, d);
+    abc->wY_n2 = ncm_vector_new (np);
+    abc->wY_w  = ncm_vector_new (np);
+  }
+
+  for (k = 0; k < np; k++)
+  {
+    const gsize ok = g_array_index (order, gsize, k);
+    gdouble n2     = 0.0;
+
+    for (l = 0; l < d; l++)
+    {
+      const gdouble y_kl = ncm_matrix_get (Y, ok, l);
+      ncm_matrix_set (abc->wY, k, l, y_kl);
+      n2 += y_kl * y_kl;
+    }
+
+    ncm_vector_set (abc->wY_n2, k, n2);
+    ncm_vector_set (abc->wY_w, k, g_array_index (abc->weights_tm1, gdouble, ok));
+  }
+
+  if ((abc->acc_theta == NULL) || (ncm_matrix_nrows (abc->acc_theta) != abc->n) || (ncm_matrix_ncols (abc->acc_theta) != d))
+  {
+    ncm_matrix_clear (&abc->acc_theta);
+    ncm_matrix_clear (&abc->acc_wZ);
+
+    abc->acc_theta = ncm_matrix_new (abc->n, d);
+    abc->acc_wZ    = ncm_matrix_new (abc->n, d);
+  }
+
+  g_array_set_size (abc->acc_dist,  abc->n);
+  g_array_set_size (abc->acc_prior, abc->n);
+  g_array_set_size (abc->acc_denom, abc->n);
+  g_array_set_size (abc->acc_order, abc->n);
+
+  g_array_unref (order);
+  ncm_matrix_free (Y);
+}
+
+static void
+_ncm_abc_store_accepted (NcmABC *abc, guint j, NcmVector *thetastar, gdouble dist)
+{
+  const guint d = ncm_matrix_ncols (abc->acc_theta);
+  guint l;
+
+  for (l = 0; l < d; l++)
+    ncm_matrix_set (abc->acc_theta, j, l, ncm_vector_get (thetastar, l));
+
+  g_array_index (abc->acc_dist,  gdouble, j) = dist;
+  g_array_index (abc->acc_prior, gdouble, j) = ncm_mset_trans_kern_prior_pdf (abc->prior, thetastar);
+}
+
+static guint
+_ncm_abc_wY_lower_bound (NcmABC *abc, const gdouble y0)
+{
+  guint lo = 0;
+  guint hi = ncm_matrix_nrows (abc->wY);
+
+  while (lo < hi)
+  {
+    const guint mid = (lo + hi) / 2;
+
+    if (ncm_matrix_get (abc->wY, mid, 0) < y0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+static void
+_ncm_abc_batch_weights_block (glong i, glong f, gpointer data)
+{
+  NcmABC *abc         = NCM_ABC (data);
+  const guint nz      = ncm_matrix_nrows (abc->acc_wZ);
+  const guint ny      = ncm_matrix_nrows (abc->wY);
+  const guint d       = ncm_matrix_ncols (abc->wY);
+  const gdouble r2max = gsl_pow_2 (abc->wtrunc);
+  gsl_matrix *G       = gsl_matrix_alloc (NCM_ABC_WEIGHT_BLOCK_Z, NCM_ABC_WEIGHT_BLOCK_Y);
+  gdouble zn2[NCM_ABC_WEIGHT_BLOCK_Z];
+  gdouble denom[NCM_ABC_WEIGHT_BLOCK_Z];
+  glong b;
+
+  for (b = i; b < f; b++)
+  {
+    const guint z0 = b * NCM_ABC_WEIGHT_BLOCK_Z;
+    const guint z1 = GSL_MIN (z0 + NCM_ABC_WEIGHT_BLOCK_Z, nz);
+    const guint bz = z1 - z0;
+    guint y0       = 0;
+    guint y1       = ny;
+    guint a, k, l;
+
+    /* Both populations are sorted in the first whitened coordinate. */
+    if (abc->wtrunc > 0.0)
+    {
+      y0 = _ncm_abc_wY_lower_bound (abc, ncm_matrix_get (abc->acc_wZ, z0, 0) - abc->wtrunc);
+      y1 = _ncm_abc_wY_lower_bound (abc, ncm_matrix_get (abc->acc_wZ, z1 - 1, 0) + abc->wtrunc);
+    }
+
+    for (a = 0; a < bz; a++)
+    {
+      zn2[a]   = 0.0;
+      denom[a] = 0.0;
+
+      for (l = 0; l < d; l++)
+        zn2[a] += gsl_pow_2 (ncm_matrix_get (abc->acc_wZ, z0 + a, l));
+    }
+
+    for (k = y0; k < y1; k += NCM_ABC_WEIGHT_BLOCK_Y)
+    {
+      const guint by = GSL_MIN (k + NCM_ABC_WEIGHT_BLOCK_Y, y1) - k;
+      gsl_matrix_const_view Zb = gsl_matrix_const_submatrix (ncm_matrix_gsl (abc->acc_wZ), z0, 0, bz, d);
+      gsl_matrix_const_view Yb = gsl_matrix_const_submatrix (ncm_matrix_gsl (abc->wY), k, 0, by, d);
+      gsl_matrix_view Gb       = gsl_matrix_submatrix (G, 0, 0, bz, by);
+
+      gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1.0, &Zb.matrix, &Yb.matrix, 0.0, &Gb.matrix);
+
+      for (a = 0; a < bz; a++)
+      {
+        for (l = 0; l < by; l++)
+        {
+          const gdouble r2 = GSL_MAX (zn2[a] + ncm_vector_fast_get (abc->wY_n2, k + l) - 2.0 * gsl_matrix_get (&Gb.matrix, a, l), 0.0);
+
+          if ((r2max > 0.0) && (r2 > r2max))
+            continue;
+
+          denom[a] += ncm_vector_fast_get (abc->wY_w, k + l) * exp (-0.5 * r2);
+        }
+      }
+    }
+
+    /* Each block owns its slots, no locking necessary. */
+    for (a = 0; a < bz; a++)
+      g_array_index (abc->acc_denom, gdouble, z0 + a) = denom[a];
+  }
+
+  gsl_matrix_free (G);
+}
+
+static void
+_ncm_abc_flush_batch_weights (NcmABC *abc)
+{
+  NcmMSetTransKernGauss *tkerng = NCM_MSET_TRANS_KERN_GAUSS (abc->tkern);
+  const guint nz                = abc->n;
+  const guint d                 = ncm_matrix_ncols (abc->acc_theta);
+  const guint nblocks           = (nz + NCM_ABC_WEIGHT_BLOCK_Z - 1) / NCM_ABC_WEIGHT_BLOCK_Z;
+  NcmMatrix *Z                  = ncm_matrix_dup (abc->acc_theta);
+  gdouble lnnorm                = -0.5 * d * ncm_c_ln2pi ();
+  guint j, l;
+  gint ret;
+
+  ret = gsl_blas_dtrsm (CblasRight, CblasLower, CblasTrans, CblasNonUnit, 1.0, 
+                        ncm_matrix_gsl (tkerng->LLT), ncm_matrix_gsl (Z));
+  NCM_TEST_GSL_RESULT ("_ncm_abc_flush_batch_weights", ret);
+
+  gsl_sort_index ((gsize *) abc->acc_order->data, ncm_matrix_data (Z), ncm_matrix_tda (Z), nz);
+
+  for (j = 0; j < nz; j++)
+  {
+    const gsize oj = g_array_index (abc->acc_order, gsize, j);
+
+    for (l = 0; l < d; l++)
+      ncm_matrix_set (abc->acc_wZ, j, l, ncm_matrix_get (Z, oj, l));
+  }
+  ncm_matrix_free (Z);
+
+  if ((abc->nthreads > 1) && (nblocks > 1))
+    ncm_func_eval_parallel_for (&_ncm_abc_batch_weights_block, 0, nblocks, 1, abc);
+  else
+    _ncm_abc_batch_weights_block (0, nblocks, abc);
+
+  for (l = 0; l < d; l++)
+    lnnorm -= log (ncm_matrix_get (tkerng->LLT, l, l));
+
+  /* acc_prior[oj] becomes the new weight of the particle in slot oj. */
+  for (j = 0; j < nz; j++)
+  {
+    const gsize oj = g_array_index (abc->acc_order, gsize, j);
+    gdouble denom  = g_array_index (abc->acc_denom, gdouble, j);
+
+    if ((denom == 0.0) && (abc->wtrunc > 0.0))
+    {
+      /* Every previous particle was truncated, fall back to the full sum. */
+      const guint ny = ncm_matrix_nrows (abc->wY);
+      guint k;
+
+      for (k = 0; k < ny; k++)
+      {
+        gdouble r2 = 0.0;
+
+        for (l = 0; l < d; l++)
+          r2 += gsl_pow_2 (ncm_matrix_get (abc->acc_wZ, j, l) - ncm_matrix_get (abc->wY, k, l));
+
+        denom += ncm_vector_get (abc->wY_w, k) * exp (-0.5 * r2);
+      }
+    }
+
+    g_array_index (abc->acc_prior, gdouble, oj) = g_array_index (abc->acc_prior, gdouble, oj) / (denom * exp (lnnorm));
+  }
+
+  for (j = 0; j < nz; j++)
+  {
+    ncm_mset_fparams_set_array (abc->mcat->mset, ncm_matrix_ptr (abc->acc_theta, j, 0));
+
+    abc->naccepted++;
+    abc->cur_sample_id++;
+    _ncm_abc_update (abc, abc->mcat->mset, g_array_index (abc->acc_dist, gdouble, j), g_array_index (abc->acc_prior, gdouble, j));
+  }
+}
+
+/*
+ * Points *theta to the parameters of the particle np of the last update,
+ * the vector is created in the first call and reused afterwards.
+ */
+static NcmVector *
+_ncm_abc_peek_particle_theta (NcmABC *abc, NcmVector **theta, const guint np)
+{
+  NcmVector *row           = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + np);
+  NcmVectorView theta_view = ncm_vector_get_subvector_view (row, 2, ncm_vector_len (row) - 2);
+
+  if (*theta == NULL)
+    *theta = ncm_vector_new_view (&theta_view);
+  else
+    ncm_vector_set_view (*theta, &theta_view);
+
+  return *theta;
+}
+
 static void 
 _ncm_abc_update_single (NcmABC *abc)
 {
+  const gboolean batch = NCM_IS_MSET_TRANS_KERN_GAUSS (abc->tkern);
+  NcmVector *theta = NULL;
   guint i = 0;
-  
+
   for (i = 0; i < abc->n;)
   {
     gdouble dist = 0.0, prob = 0.0;
     gsize np = gsl_ran_discrete (abc->mcat->rng->r, abc->wran);
 
-    NcmVector *row = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + np);
-    NcmVector *theta = ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2);
+    _ncm_abc_peek_particle_theta (abc, &theta, np);
     
     ncm_mset_trans_kern_generate (abc->tkern, theta, abc->thetastar, abc->mcat->rng);
     ncm_mset_fparams_set_vector (abc->mcat->mset, abc->thetastar);
@@ -1302,30 +1631,39 @@ _ncm_abc_update_single (NcmABC *abc)
     
     dist = ncm_abc_mock_distance (abc, abc->dset_mock, abc->theta, abc->thetastar, abc->mcat->rng);
     prob = ncm_abc_distance_prob (abc, dist);
-    ncm_vector_free (theta);
 
     abc->ntotal++;
     
     if (prob == 1.0 || (prob != 0.0 && gsl_rng_uniform (abc->mcat->rng->r) < prob))
     {
-      gdouble new_weight = ncm_mset_trans_kern_prior_pdf (abc->prior, abc->thetastar);
-      gdouble denom = 0.0;
-      guint j;
-      for (j = 0; j < abc->nparticles; j++)
-      {        
-        row    = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + j);
-        theta  = ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2);
-        denom += g_array_index (abc->weights_tm1, gdouble, j) * ncm_mset_trans_kern_pdf (abc->tkern, theta, abc->thetastar);
-        ncm_vector_free (theta);
+      if (batch)
+      {
+        _ncm_abc_store_accepted (abc, i, abc->thetastar, dist);
+      }
+      else
+      {
+        gdouble new_weight = ncm_mset_trans_kern_prior_pdf (abc->prior, abc->thetastar);
+        gdouble denom = 0.0;
+        guint j;
+        for (j = 0; j < abc->nparticles; j++)
+        {        
+          _ncm_abc_peek_particle_theta (abc, &theta, j);
+          denom += g_array_index (abc->weights_tm1, gdouble, j) * ncm_mset_trans_kern_pdf (abc->tkern, theta, abc->thetastar);
+        }
+        new_weight = new_weight / denom; 
+
+        abc->naccepted++;
+        abc->cur_sample_id++;
+        _ncm_abc_update (abc, abc->mcat->mset, dist, new_weight);
       }
-      new_weight = new_weight / denom; 
-
-      abc->naccepted++;
-      abc->cur_sample_id++;
-      _ncm_abc_update (abc, abc->mcat->mset, dist, new_weight);
       i++;
     }
   }
+
+  if (batch)
+    _ncm_abc_flush_batch_weights (abc);
+
+  ncm_vector_clear (&theta);
 }
 
 static void 
@@ -1335,15 +1673,14 @@ _ncm_abc_thread_update_eval (glong i, glong f, gpointer data)
   NcmABC *abc = NCM_ABC (data);
   NcmABCThread **abct_ptr = ncm_memory_pool_get (abc->mp);
   NcmABCThread *abct = *abct_ptr;
+  const gboolean batch = NCM_IS_MSET_TRANS_KERN_GAUSS (abc->tkern);
   guint j;
 
   for (j = i; j < f;)
   {
     gdouble dist = 0.0, prob = 0.0;
     gsize np = gsl_ran_discrete (abct->rng->r, abc->wran);
-
-    NcmVector *row = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + np);
-    NcmVector *theta = ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2);
+    NcmVector *theta = _ncm_abc_peek_particle_theta (abc, &abct->theta, np);
 
     ncm_mset_trans_kern_generate (abc->tkern, theta, abct->thetastar, abct->rng);
 
@@ -1360,32 +1697,36 @@ _ncm_abc_thread_update_eval (glong i, glong f, gpointer data)
     printf ("# dist % 20.15g prob % 20.15g\n", dist, prob);
     G_UNLOCK (update_lock);
 */
-    ncm_vector_free (theta);
     
-    G_LOCK (update_lock);
-    abc->ntotal++;
-    G_UNLOCK (update_lock);
+    g_atomic_int_inc ((gint *) &abc->ntotal);
     
     if (prob == 1.0 || (prob != 0.0 && gsl_rng_uniform (abct->rng->r) < prob))
     {
-      gdouble new_weight = ncm_mset_trans_kern_prior_pdf (abc->prior, abct->thetastar);
-      gdouble denom = 0.0;
-      guint k;
-      for (k = 0; k < abc->nparticles; k++)
+      if (batch)
       {
-        row    = ncm_mset_catalog_peek_row (abc->mcat, abc->nparticles * abc->nupdates + k);
-        theta  = ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2);
-        denom += g_array_index (abc->weights_tm1, gdouble, k) * ncm_mset_trans_kern_pdf (abc->tkern, theta, abct->thetastar);
-        ncm_vector_free (theta);
+        /* The slot j belongs to this thread, the weights are computed at the end of the update. */
+        _ncm_abc_store_accepted (abc, j, abct->thetastar, dist);
+        j++;
+      }
+      else
+      {
+        gdouble new_weight = ncm_mset_trans_kern_prior_pdf (abc->prior, abct->thetastar);
+        gdouble denom = 0.0;
+        guint k;
+        for (k = 0; k < abc->nparticles; k++)
+        {
+          theta  = _ncm_abc_peek_particle_theta (abc, &abct->theta, k);
+          denom += g_array_index (abc->weights_tm1, gdouble, k) * ncm_mset_trans_kern_pdf (abc->tkern, theta, abct->thetastar);
+        }
+        new_weight = new_weight / denom; 
+
+        G_LOCK (update_lock);
+        abc->cur_sample_id++;
+        abc->naccepted++;
+        _ncm_abc_update (abc, abct->mset, dist, new_weight);
+        j++;
+        G_UNLOCK (update_lock);
       }
-      new_weight = new_weight / denom; 
-
-      G_LOCK (update_lock);
-      abc->cur_sample_id++;
-      abc->naccepted++;
-      _ncm_abc_update (abc, abct->mset, dist, new_weight);
-      j++;
-      G_UNLOCK (update_lock);
     }
   }
 
@@ -1410,6 +1751,9 @@ _ncm_abc_update_mt (NcmABC *abc)
   
   g_assert_cmpuint (abc->nthreads, >, 1);
 
-  ncm_func_eval_threaded_loop_full (&_ncm_abc_thread_update_eval, 0, abc->n, abc);
+  ncm_func_eval_parallel_for (&_ncm_abc_thread_update_eval, 0, abc->n, 1, abc);
+
+  if (NCM_IS_MSET_TRANS_KERN_GAUSS (abc->tkern))
+    _ncm_abc_flush_batch_weights (abc);
 }
 
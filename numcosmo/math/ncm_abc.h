@@ -83,6 +83,16 @@ struct _NcmABC
   gdouble depsilon;
   gboolean dists_sorted;
   gsl_ran_discrete_t *wran;
+  NcmMatrix *wY;
+  NcmVector *wY_n2;
+  NcmVector *wY_w;
+  NcmMatrix *acc_theta;
+  NcmMatrix *acc_wZ;
+  GArray *acc_dist;
+  GArray *acc_prior;
+  GArray *acc_denom;
+  GArray *acc_order;
+  gdouble wtrunc;
   gboolean started;
   gboolean started_up;
   gint cur_sample_id;
@@ -111,6 +121,7 @@ void ncm_abc_set_data_file (NcmABC *abc, const gchar *filename);
 void ncm_abc_set_nthreads (NcmABC *abc, guint nthreads);
 void ncm_abc_set_rng (NcmABC *abc, NcmRNG *rng);
 void ncm_abc_set_trans_kern (NcmABC *abc, NcmMSetTransKern *tkern);
+void ncm_abc_set_weight_trunc (NcmABC *abc, gdouble nsigma);
 
 gdouble ncm_abc_get_dist_quantile (NcmABC *abc, gdouble p);
 gdouble ncm_abc_get_accept_ratio (NcmABC *abc);
@@ -282,6 +282,9 @@ ncm_cfg_init (void)
 
 #ifdef NUMCOSMO_HAVE_FFTW3
   fftw_set_timelimit (10.0);
+#ifdef HAVE_FFTW3_THREADS
+  fftw_init_threads ();
+#endif /* HAVE_FFTW3_THREADS */
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 #ifdef HAVE_FFTW3F
   fftwf_set_timelimit (10.0);
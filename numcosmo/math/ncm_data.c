@@ -234,6 +234,9 @@ ncm_data_class_init (NcmDataClass *klass)
   data_class->m2lnL_val          = NULL;
   data_class->m2lnL_grad         = NULL;
   data_class->m2lnL_val_grad     = NULL;
+  data_class->m2lnL_val_batch_add  = NULL;
+  data_class->m2lnL_val_batch_eval = NULL;
+  data_class->share_immutable    = NULL;
 }
 
 /**
@@ -291,6 +294,49 @@ ncm_data_dup (NcmData *data, NcmSerialize *ser_obj)
   return NCM_DATA (ncm_serialize_dup_obj (ser_obj, G_OBJECT (data)));
 }
 
+/**
+ * ncm_data_share_immutable: (virtual share_immutable)
+ * @data: a #NcmData
+ * @ser: a #NcmSerialize
+ *
+ * Registers the immutable objects of @data (data vectors, fixed covariances,
+ * loaded tables, etc) as named instances in @ser. A subsequent duplication of
+ * @data through @ser, e.g., ncm_data_dup(), will then reference these objects
+ * instead of creating copies. Implementations must register only objects
+ * which are never modified by the likelihood evaluation, note that the
+ * replicas created this way must not be resampled, since the resampling
+ * modifies the shared data. Implementations that do not provide this method
+ * are fully copied.
+ *
+ */
+void
+ncm_data_share_immutable (NcmData *data, NcmSerialize *ser)
+{
+  if (NCM_DATA_GET_CLASS (data)->share_immutable != NULL)
+    NCM_DATA_GET_CLASS (data)->share_immutable (data, ser);
+}
+
+/**
+ * ncm_data_share_obj:
+ * @ser: a #NcmSerialize
+ * @obj: (type GObject) (allow-none): a #GObject
+ *
+ * Registers @obj as a named instance in @ser using a name derived from its
+ * address, it does nothing if @obj is NULL or already registered. This is the
+ * helper to be used by the #NcmDataClass.share_immutable implementations.
+ *
+ */
+void
+ncm_data_share_obj (NcmSerialize *ser, gpointer obj)
+{
+  if ((obj != NULL) && !ncm_serialize_contain_instance (ser, obj))
+  {
+    gchar *name = g_strdup_printf ("NcmDataShared:%" G_GSIZE_MODIFIER "x", GPOINTER_TO_SIZE (obj));
+    ncm_serialize_set (ser, obj, name, FALSE);
+    g_free (name);
+  }
+}
+
 /**
  * ncm_data_new_from_file:
  * @filename: file containing a serialized #NcmData child.
@@ -731,3 +777,63 @@ void ncm_data_m2lnL_val_grad (NcmData *data, NcmMSet *mset, gdouble *m2lnL, NcmV
 
   NCM_DATA_GET_CLASS (data)->m2lnL_val_grad (data, mset, m2lnL, grad);
 }
+
+/**
+ * ncm_data_has_m2lnL_val_batch:
+ * @data: a #NcmData.
+ *
+ * Checks whether @data implements the batched evaluation of $-2\ln(L)$,
+ * see ncm_data_m2lnL_val_batch_add().
+ * 
+ * Returns: TRUE if @data implements the batched evaluation.
+ */
+gboolean 
+ncm_data_has_m2lnL_val_batch (NcmData *data)
+{
+  return (NCM_DATA_GET_CLASS (data)->m2lnL_val_batch_add != NULL) && (NCM_DATA_GET_CLASS (data)->m2lnL_val_batch_eval != NULL);
+}
+
+/**
+ * ncm_data_m2lnL_val_batch_add: (virtual m2lnL_val_batch_add)
+ * @data: a #NcmData.
+ * @mset: a #NcmMSet.
+ *
+ * Queues the evaluation of $-2\ln(L)$ at the current parameters of @mset.
+ * The implementation may postpone the expensive part of the calculation 
+ * in order to perform it for all queued points at once (e.g., one 
+ * triangular solve with several right-hand sides). The results are 
+ * obtained with ncm_data_m2lnL_val_batch_eval().
+ * 
+ */
+void 
+ncm_data_m2lnL_val_batch_add (NcmData *data, NcmMSet *mset)
+{
+  ncm_data_prepare (data, mset);
+
+  if (NCM_DATA_GET_CLASS (data)->m2lnL_val_batch_add == NULL)
+    g_error ("ncm_data_m2lnL_val_batch_add: The data (%s) does not implement m2lnL_val_batch_add.", 
+             ncm_data_get_desc (data));
+
+  NCM_DATA_GET_CLASS (data)->m2lnL_val_batch_add (data, mset);
+}
+
+/**
+ * ncm_data_m2lnL_val_batch_eval: (virtual m2lnL_val_batch_eval)
+ * @data: a #NcmData.
+ * @mset: a #NcmMSet.
+ * @m2lnL: a #NcmVector.
+ *
+ * Adds $-2\ln(L)$ of the $i$-th point queued by ncm_data_m2lnL_val_batch_add()
+ * to the $i$-th component of @m2lnL and empties the queue. The length of 
+ * @m2lnL must match the number of queued points.
+ * 
+ */
+void 
+ncm_data_m2lnL_val_batch_eval (NcmData *data, NcmMSet *mset, NcmVector *m2lnL)
+{
+  if (NCM_DATA_GET_CLASS (data)->m2lnL_val_batch_eval == NULL)
+    g_error ("ncm_data_m2lnL_val_batch_eval: The data (%s) does not implement m2lnL_val_batch_eval.", 
+             ncm_data_get_desc (data));
+
+  NCM_DATA_GET_CLASS (data)->m2lnL_val_batch_eval (data, mset, m2lnL);
+}
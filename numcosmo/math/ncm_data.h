@@ -67,6 +67,12 @@ typedef struct _NcmData NcmData;
  * @m2lnL_grad: evaluate the gradient of $-2\ln(L)$ with respect to the free
  * parameters in @mset.
  * @m2lnL_val_grad: evaluate the value and the gradient of $-2\ln(L)$.
+ * @m2lnL_val_batch_add: queues the evaluation of $-2\ln(L)$ at the current
+ * point of @mset, see ncm_data_m2lnL_val_batch_add().
+ * @m2lnL_val_batch_eval: adds $-2\ln(L)$ of every queued point to the output
+ * vector, see ncm_data_m2lnL_val_batch_eval().
+ * @share_immutable: registers in the #NcmSerialize the objects which are not
+ * modified after the data is loaded, see ncm_data_share_immutable().
  * 
  * Virtual table for the #NcmData abstract class.
  * 
@@ -89,6 +95,9 @@ struct _NcmDataClass
   void (*m2lnL_val) (NcmData *data, NcmMSet *mset, gdouble *m2lnL);
   void (*m2lnL_grad) (NcmData *data, NcmMSet *mset, NcmVector *grad);
   void (*m2lnL_val_grad) (NcmData *data, NcmMSet *mset, gdouble *m2lnL, NcmVector *grad);
+  void (*m2lnL_val_batch_add) (NcmData *data, NcmMSet *mset);
+  void (*m2lnL_val_batch_eval) (NcmData *data, NcmMSet *mset, NcmVector *m2lnL);
+  void (*share_immutable) (NcmData *data, NcmSerialize *ser);
 };
 
 struct _NcmData
@@ -109,6 +118,8 @@ void ncm_data_free (NcmData *data);
 void ncm_data_clear (NcmData **data);
 
 NcmData *ncm_data_dup (NcmData *data, NcmSerialize *ser_obj);
+void ncm_data_share_immutable (NcmData *data, NcmSerialize *ser);
+void ncm_data_share_obj (NcmSerialize *ser, gpointer obj);
 NcmData *ncm_data_new_from_file (const gchar *filename);
 
 guint ncm_data_get_length (NcmData *data);
@@ -136,6 +147,10 @@ void ncm_data_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL);
 void ncm_data_m2lnL_grad (NcmData *data, NcmMSet *mset, NcmVector *grad);
 void ncm_data_m2lnL_val_grad (NcmData *data, NcmMSet *mset, gdouble *m2lnL, NcmVector *grad);
 
+gboolean ncm_data_has_m2lnL_val_batch (NcmData *data);
+void ncm_data_m2lnL_val_batch_add (NcmData *data, NcmMSet *mset);
+void ncm_data_m2lnL_val_batch_eval (NcmData *data, NcmMSet *mset, NcmVector *m2lnL);
+
 #define NCM_DATA_RESAMPLE_RNG_NAME "data_resample"
 
 G_END_DECLS
@@ -144,6 +144,7 @@ ncm_data_gauss_get_property (GObject *object, guint prop_id, GValue *value, GPar
 static guint _ncm_data_gauss_get_length (NcmData *data); 
 /* static void _ncm_data_gauss_begin (NcmData *data); */
 static void _ncm_data_gauss_resample (NcmData *data, NcmMSet *mset, NcmRNG *rng);
+static void _ncm_data_gauss_share_immutable (NcmData *data, NcmSerialize *ser);
 static void _ncm_data_gauss_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL);
 static void _ncm_data_gauss_leastsquares_f (NcmData *data, NcmMSet *mset, NcmVector *v);
 static void _ncm_data_gauss_set_size (NcmDataGauss *gauss, guint np);
@@ -186,13 +187,14 @@ ncm_data_gauss_class_init (NcmDataGaussClass *klass)
                                                         NCM_TYPE_MATRIX,
                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   
-  data_class->bootstrap      = TRUE;
-  data_class->get_length     = &_ncm_data_gauss_get_length;
-  data_class->begin          = NULL;
+  data_class->bootstrap       = TRUE;
+  data_class->get_length      = &_ncm_data_gauss_get_length;
+  data_class->begin           = NULL;
 
-  data_class->resample       = &_ncm_data_gauss_resample;
-  data_class->m2lnL_val      = &_ncm_data_gauss_m2lnL_val;
-  data_class->leastsquares_f = &_ncm_data_gauss_leastsquares_f;
+  data_class->resample        = &_ncm_data_gauss_resample;
+  data_class->m2lnL_val       = &_ncm_data_gauss_m2lnL_val;
+  data_class->leastsquares_f  = &_ncm_data_gauss_leastsquares_f;
+  data_class->share_immutable = &_ncm_data_gauss_share_immutable;
 
   gauss_class->mean_func     = NULL;
   gauss_class->inv_cov_func  = NULL;
@@ -224,6 +226,18 @@ _ncm_data_gauss_prepare_LLT (NcmData *data)
   gauss->prepared_LLT = TRUE;
 }
 
+static void
+_ncm_data_gauss_share_immutable (NcmData *data, NcmSerialize *ser)
+{
+  NcmDataGauss *gauss = NCM_DATA_GAUSS (data);
+
+  ncm_data_share_obj (ser, gauss->y);
+
+  /* The inverse covariance is only constant when there is no inv_cov_func */
+  if (NCM_DATA_GAUSS_GET_CLASS (gauss)->inv_cov_func == NULL)
+    ncm_data_share_obj (ser, gauss->inv_cov);
+}
+
 static void
 _ncm_data_gauss_resample (NcmData *data, NcmMSet *mset, NcmRNG *rng)
 {
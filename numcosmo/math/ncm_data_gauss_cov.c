@@ -30,6 +30,16 @@
  *
  * Generic gaussian distribution which uses the covariance matrix as input.
  * 
+ * When the covariance has the structure $C(\theta) = C_0 + U S(\theta) U^T$,
+ * where $U$ is a fixed $n \times r$ matrix with $r \ll n$ and only the
+ * $r \times r$ matrix $S$ changes, the subclass can implement
+ * #NcmDataGaussCovClass.cov_lowrank_func and set $U$ through
+ * ncm_data_gauss_cov_set_lowrank(). In this case #NcmDataGaussCovClass.cov_func
+ * computes only $C_0$, its Cholesky decomposition is kept while
+ * #NcmDataGaussCovClass.cov_func returns FALSE, and $-2\ln(L)$ and the
+ * normalization are computed through the Woodbury identity and the matrix 
+ * determinant lemma in $O(n^2 + nr + r^3)$ operations.
+ * 
  */
 
 #ifdef HAVE_CONFIG_H
@@ -53,6 +63,7 @@ enum
   PROP_USE_NORMA,
   PROP_MEAN,
   PROP_COV,
+  PROP_LOWRANK,
   PROP_SIZE,
 };
 
@@ -66,6 +77,18 @@ ncm_data_gauss_cov_init (NcmDataGaussCov *gauss)
   gauss->v                = NULL;
   gauss->cov              = NULL;
   gauss->LLT              = NULL;
+  gauss->lr_U             = NULL;
+  gauss->lr_S             = NULL;
+  gauss->lr_W             = NULL;
+  gauss->lr_G             = NULL;
+  gauss->lr_M             = NULL;
+  gauss->lr_z             = NULL;
+  gauss->lr_t             = NULL;
+  gauss->lr_p             = NULL;
+  gauss->batch_R          = NULL;
+  gauss->batch_r          = NULL;
+  gauss->batch_len        = 0;
+  gauss->batch_m2lnL      = g_array_new (FALSE, FALSE, sizeof (gdouble));
   gauss->prepared_LLT     = FALSE;
   gauss->use_norma        = FALSE;
 }
@@ -102,6 +125,9 @@ _ncm_data_gauss_cov_set_property (GObject *object, guint prop_id, const GValue *
     case PROP_COV:
       ncm_matrix_substitute (&gauss->cov, g_value_get_object (value), TRUE);
       break;
+    case PROP_LOWRANK:
+      ncm_data_gauss_cov_set_lowrank (gauss, g_value_get_object (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -128,6 +154,9 @@ _ncm_data_gauss_cov_get_property (GObject *object, guint prop_id, GValue *value,
     case PROP_COV:
       g_value_set_object (value, gauss->cov);
       break;
+    case PROP_LOWRANK:
+      g_value_set_object (value, gauss->lr_U);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -144,6 +173,10 @@ _ncm_data_gauss_cov_dispose (GObject *object)
   ncm_matrix_clear (&gauss->cov);
   ncm_matrix_clear (&gauss->LLT);
 
+  ncm_data_gauss_cov_set_lowrank (gauss, NULL);
+  ncm_matrix_clear (&gauss->batch_R);
+  ncm_vector_clear (&gauss->batch_r);
+
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_data_gauss_cov_parent_class)->dispose (object);
 }
@@ -151,7 +184,10 @@ _ncm_data_gauss_cov_dispose (GObject *object)
 static void
 _ncm_data_gauss_cov_finalize (GObject *object)
 {
-  
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (object);
+
+  g_array_unref (gauss->batch_m2lnL);
+
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_data_gauss_cov_parent_class)->finalize (object);
 }
@@ -161,7 +197,10 @@ static guint _ncm_data_gauss_cov_get_length (NcmData *data);
 static void _ncm_data_gauss_cov_resample (NcmData *data, NcmMSet *mset, NcmRNG *rng);
 static void _ncm_data_gauss_cov_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL);
 static void _ncm_data_gauss_cov_leastsquares_f (NcmData *data, NcmMSet *mset, NcmVector *v);
+static void _ncm_data_gauss_cov_m2lnL_val_batch_add (NcmData *data, NcmMSet *mset);
+static void _ncm_data_gauss_cov_m2lnL_val_batch_eval (NcmData *data, NcmMSet *mset, NcmVector *m2lnL);
 static void _ncm_data_gauss_cov_set_size (NcmDataGaussCov *gauss, guint np);
+static void _ncm_data_gauss_cov_share_immutable (NcmData *data, NcmSerialize *ser);
 static guint _ncm_data_gauss_cov_get_size (NcmDataGaussCov *gauss);
 static void _ncm_data_gauss_cov_lnNorma2 (NcmDataGaussCov *gauss, NcmMSet *mset, gdouble *m2lnL);
 static void _ncm_data_gauss_cov_lnNorma2_bs (NcmDataGaussCov *gauss, NcmMSet *mset, NcmBootstrap *bstrap, gdouble *m2lnL);
@@ -210,6 +249,14 @@ ncm_data_gauss_cov_class_init (NcmDataGaussCovClass *klass)
                                                         "Data covariance",
                                                         NCM_TYPE_MATRIX,
                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+  g_object_class_install_property (object_class,
+                                   PROP_LOWRANK,
+                                   g_param_spec_object ("lowrank",
+                                                        NULL,
+                                                        "Covariance low-rank update basis",
+                                                        NCM_TYPE_MATRIX,
+                                                        G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   
   data_class->bootstrap          = TRUE;
   
@@ -220,9 +267,13 @@ ncm_data_gauss_cov_class_init (NcmDataGaussCovClass *klass)
   data_class->resample           = &_ncm_data_gauss_cov_resample;
   data_class->m2lnL_val          = &_ncm_data_gauss_cov_m2lnL_val;
   data_class->leastsquares_f     = &_ncm_data_gauss_cov_leastsquares_f;
+  data_class->m2lnL_val_batch_add  = &_ncm_data_gauss_cov_m2lnL_val_batch_add;
+  data_class->m2lnL_val_batch_eval = &_ncm_data_gauss_cov_m2lnL_val_batch_eval;
+  data_class->share_immutable    = &_ncm_data_gauss_cov_share_immutable;
 
   gauss_cov_class->mean_func    = NULL;
   gauss_cov_class->cov_func     = NULL;
+  gauss_cov_class->cov_lowrank_func = NULL;
   gauss_cov_class->lnNorma2     = &_ncm_data_gauss_cov_lnNorma2;
   gauss_cov_class->lnNorma2_bs  = &_ncm_data_gauss_cov_lnNorma2_bs;
   gauss_cov_class->set_size     = &_ncm_data_gauss_cov_set_size;
@@ -254,19 +305,105 @@ _ncm_data_gauss_cov_prepare_LLT (NcmData *data)
 }
 
 static void
-_ncm_data_gauss_cov_resample (NcmData *data, NcmMSet *mset, NcmRNG *rng)
+_ncm_data_gauss_cov_prepare_lowrank (NcmDataGaussCov *gauss)
+{
+  gint ret;
+
+  /* W = L_0^{-1} U and G = W^T W, CblasLower, CblasNoTrans => CblasUpper, CblasTrans */
+  ncm_matrix_memcpy (gauss->lr_W, gauss->lr_U);
+  ret = gsl_blas_dtrsm (CblasLeft, CblasUpper, CblasTrans, CblasNonUnit, 1.0,
+                        ncm_matrix_gsl (gauss->LLT), ncm_matrix_gsl (gauss->lr_W));
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_prepare_lowrank", ret);
+
+  ret = gsl_blas_dsyrk (CblasUpper, CblasTrans, 1.0, ncm_matrix_gsl (gauss->lr_W), 0.0, ncm_matrix_gsl (gauss->lr_G));
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_prepare_lowrank", ret);
+  ncm_matrix_copy_triangle (gauss->lr_G, 'U');
+}
+
+static void
+_ncm_data_gauss_cov_prepare_LLT_lowrank_full (NcmDataGaussCov *gauss)
+{
+  const guint r = ncm_matrix_ncols (gauss->lr_U);
+  NcmMatrix *US = ncm_matrix_new (gauss->np, r);
+  gint ret;
+
+  /* LLT <= C_0 + U S U^T, the cached factorization of C_0 is lost. */
+  if (gauss->LLT == NULL)
+    gauss->LLT = ncm_matrix_dup (gauss->cov);
+  else
+    ncm_matrix_memcpy (gauss->LLT, gauss->cov);
+
+  ret = gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1.0, ncm_matrix_gsl (gauss->lr_U), ncm_matrix_gsl (gauss->lr_S), 0.0, ncm_matrix_gsl (US));
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_prepare_LLT_lowrank_full", ret);
+  ret = gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1.0, ncm_matrix_gsl (US), ncm_matrix_gsl (gauss->lr_U), 1.0, ncm_matrix_gsl (gauss->LLT));
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_prepare_LLT_lowrank_full", ret);
+
+  ret = ncm_matrix_cholesky_decomp (gauss->LLT, 'U');
+  if (ret != 0)
+    g_error ("_ncm_data_gauss_cov_prepare_LLT_lowrank_full[ncm_matrix_cholesky_decomp]: %d.", ret);
+
+  gauss->prepared_LLT = FALSE;
+  ncm_matrix_free (US);
+}
+
+/*
+ * Updates the covariance and its Cholesky decomposition. With a low-rank
+ * basis LLT holds the decomposition of C_0 and lr_S the current S, unless 
+ * full_LLT is TRUE, in which case LLT holds the decomposition of the 
+ * complete covariance.
+ */
+static void
+_ncm_data_gauss_cov_prepare_cov (NcmDataGaussCov *gauss, NcmMSet *mset, gboolean full_LLT)
 {
-  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (data);
   NcmDataGaussCovClass *gauss_cov_class = NCM_DATA_GAUSS_COV_GET_CLASS (gauss);
   gboolean cov_update = FALSE;
-  gint ret;
-  guint i;
 
   if (gauss_cov_class->cov_func != NULL)
     cov_update = gauss_cov_class->cov_func (gauss, mset, gauss->cov);
 
-  if (cov_update || !gauss->prepared_LLT)
-    _ncm_data_gauss_cov_prepare_LLT (data);
+  if (gauss->lr_U == NULL)
+  {
+    if (cov_update || !gauss->prepared_LLT)
+      _ncm_data_gauss_cov_prepare_LLT (NCM_DATA (gauss));
+  }
+  else
+  {
+    gauss_cov_class->cov_lowrank_func (gauss, mset, gauss->lr_S);
+
+    if (full_LLT)
+      _ncm_data_gauss_cov_prepare_LLT_lowrank_full (gauss);
+    else if (cov_update || !gauss->prepared_LLT)
+    {
+      _ncm_data_gauss_cov_prepare_LLT (NCM_DATA (gauss));
+      _ncm_data_gauss_cov_prepare_lowrank (gauss);
+    }
+  }
+}
+
+static void
+_ncm_data_gauss_cov_share_immutable (NcmData *data, NcmSerialize *ser)
+{
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (data);
+
+  ncm_data_share_obj (ser, gauss->y);
+
+  /* The covariance is only constant when there is no cov_func */
+  if (NCM_DATA_GAUSS_COV_GET_CLASS (gauss)->cov_func == NULL)
+    ncm_data_share_obj (ser, gauss->cov);
+
+  if (gauss->lr_U != NULL)
+    ncm_data_share_obj (ser, gauss->lr_U);
+}
+
+static void
+_ncm_data_gauss_cov_resample (NcmData *data, NcmMSet *mset, NcmRNG *rng)
+{
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (data);
+  NcmDataGaussCovClass *gauss_cov_class = NCM_DATA_GAUSS_COV_GET_CLASS (gauss);
+  gint ret;
+  guint i;
+
+  _ncm_data_gauss_cov_prepare_cov (gauss, mset, TRUE);
 
   ncm_rng_lock (rng);
   for (i = 0; i < gauss->np; i++)
@@ -326,12 +463,72 @@ _ncm_data_gauss_cov_lnNorma2_bs (NcmDataGaussCov *gauss, NcmMSet *mset, NcmBoots
   *m2lnL += gauss->np * ncm_c_ln2pi () + 2.0 * log (detL);  
 }
 
+/*
+ * C = L_0 (I + W S W^T) L_0^T with W = L_0^{-1} U, thus, using y = L_0^{-1} v,
+ * z = W^T y, G = W^T W and M = I + S G,
+ * 
+ * v^T C^{-1} v = y^T y - z^T M^{-1} S z,
+ * ln det C     = ln det C_0 + ln det M.
+ * 
+ */
+static void
+_ncm_data_gauss_cov_m2lnL_val_lowrank (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
+{
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (data);
+  NcmDataGaussCovClass *gauss_cov_class = NCM_DATA_GAUSS_COV_GET_CLASS (gauss);
+  gdouble zt = 0.0;
+  gint signum, ret;
+  guint i;
+
+  if (ncm_data_bootstrap_enabled (data))
+    g_error ("NcmDataGaussCov: does not support bootstrap with low-rank covariance updates");
+
+  _ncm_data_gauss_cov_prepare_cov (gauss, mset, FALSE);
+
+  /* CblasLower, CblasNoTrans => CblasUpper, CblasTrans */
+  ret = gsl_blas_dtrsv (CblasUpper, CblasTrans, CblasNonUnit, 
+                        ncm_matrix_gsl (gauss->LLT), ncm_vector_gsl (gauss->v));
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_m2lnL_val_lowrank", ret);
+
+  ret = gsl_blas_ddot (ncm_vector_gsl (gauss->v), ncm_vector_gsl (gauss->v), m2lnL);
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_m2lnL_val_lowrank", ret);
+
+  ret = gsl_blas_dgemv (CblasTrans, 1.0, ncm_matrix_gsl (gauss->lr_W), ncm_vector_gsl (gauss->v), 0.0, ncm_vector_gsl (gauss->lr_z));
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_m2lnL_val_lowrank", ret);
+  ret = gsl_blas_dgemv (CblasNoTrans, 1.0, ncm_matrix_gsl (gauss->lr_S), ncm_vector_gsl (gauss->lr_z), 0.0, ncm_vector_gsl (gauss->lr_t));
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_m2lnL_val_lowrank", ret);
+
+  ret = gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1.0, ncm_matrix_gsl (gauss->lr_S), ncm_matrix_gsl (gauss->lr_G), 0.0, ncm_matrix_gsl (gauss->lr_M));
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_m2lnL_val_lowrank", ret);
+  for (i = 0; i < ncm_matrix_nrows (gauss->lr_M); i++)
+    ncm_matrix_addto (gauss->lr_M, i, i, 1.0);
+
+  ret = gsl_linalg_LU_decomp (ncm_matrix_gsl (gauss->lr_M), gauss->lr_p, &signum);
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_m2lnL_val_lowrank[gsl_linalg_LU_decomp]", ret);
+  ret = gsl_linalg_LU_svx (ncm_matrix_gsl (gauss->lr_M), gauss->lr_p, ncm_vector_gsl (gauss->lr_t));
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_m2lnL_val_lowrank[gsl_linalg_LU_svx]", ret);
+
+  ret = gsl_blas_ddot (ncm_vector_gsl (gauss->lr_z), ncm_vector_gsl (gauss->lr_t), &zt);
+  NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_m2lnL_val_lowrank", ret);
+
+  *m2lnL -= zt;
+
+  if (gauss->use_norma)
+  {
+    /* det C / det C_0 = det M must be positive for a positive definite C. */
+    if (gsl_linalg_LU_sgndet (ncm_matrix_gsl (gauss->lr_M), signum) <= 0.0)
+      g_error ("_ncm_data_gauss_cov_m2lnL_val_lowrank: covariance is not positive definite.");
+
+    gauss_cov_class->lnNorma2 (gauss, mset, m2lnL);
+    *m2lnL += gsl_linalg_LU_lndet (ncm_matrix_gsl (gauss->lr_M));
+  }
+}
+
 static void
 _ncm_data_gauss_cov_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
 {
   NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (data);
   NcmDataGaussCovClass *gauss_cov_class = NCM_DATA_GAUSS_COV_GET_CLASS (gauss);
-  gboolean cov_update = FALSE;
   gint ret;
 
   *m2lnL = 0.0;
@@ -339,12 +536,14 @@ _ncm_data_gauss_cov_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
   gauss_cov_class->mean_func (gauss, mset, gauss->v);
 
   ncm_vector_sub (gauss->v, gauss->y);
-  
-  if (gauss_cov_class->cov_func != NULL)
-    cov_update = gauss_cov_class->cov_func (gauss, mset, gauss->cov);
 
-  if (cov_update || !gauss->prepared_LLT)
-    _ncm_data_gauss_cov_prepare_LLT (data);
+  if (gauss->lr_U != NULL)
+  {
+    _ncm_data_gauss_cov_m2lnL_val_lowrank (data, mset, m2lnL);
+    return;
+  }
+
+  _ncm_data_gauss_cov_prepare_cov (gauss, mset, FALSE);
 
   /* CblasLower, CblasNoTrans => CblasUpper, CblasTrans */
   ret = gsl_blas_dtrsv (CblasUpper, CblasTrans, CblasNonUnit, 
@@ -380,12 +579,136 @@ _ncm_data_gauss_cov_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL)
   }
 }
 
+/*
+ * Computes -2lnL of the queued residuals, the i-th row of batch_R, all 
+ * sharing the current Cholesky decomposition, i.e., R (L^T)^{-1} in one 
+ * triangular solve.
+ */
+static void
+_ncm_data_gauss_cov_m2lnL_val_batch_flush (NcmDataGaussCov *gauss, NcmMSet *mset)
+{
+  if (gauss->batch_len > 0)
+  {
+    NcmMatrix *R      = ncm_matrix_get_submatrix (gauss->batch_R, 0, 0, gauss->batch_len, gauss->np);
+    const guint first = gauss->batch_m2lnL->len - gauss->batch_len;
+    gdouble lnNorma2  = 0.0;
+    gint ret;
+    guint i;
+
+    /* CblasLower, CblasNoTrans => CblasUpper, CblasTrans */
+    ret = gsl_blas_dtrsm (CblasRight, CblasUpper, CblasNoTrans, CblasNonUnit, 1.0,
+                          ncm_matrix_gsl (gauss->LLT), ncm_matrix_gsl (R));
+    NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_m2lnL_val_batch_flush", ret);
+
+    if (gauss->use_norma)
+      NCM_DATA_GAUSS_COV_GET_CLASS (gauss)->lnNorma2 (gauss, mset, &lnNorma2);
+
+    for (i = 0; i < gauss->batch_len; i++)
+    {
+      gsl_vector_view r_i = gsl_matrix_row (ncm_matrix_gsl (R), i);
+      gdouble m2lnL_i;
+
+      ret = gsl_blas_ddot (&r_i.vector, &r_i.vector, &m2lnL_i);
+      NCM_TEST_GSL_RESULT ("_ncm_data_gauss_cov_m2lnL_val_batch_flush", ret);
+
+      g_array_index (gauss->batch_m2lnL, gdouble, first + i) = m2lnL_i + lnNorma2;
+    }
+
+    ncm_matrix_free (R);
+    gauss->batch_len = 0;
+  }
+}
+
+static void
+_ncm_data_gauss_cov_m2lnL_val_batch_add (NcmData *data, NcmMSet *mset)
+{
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (data);
+  NcmDataGaussCovClass *gauss_cov_class = NCM_DATA_GAUSS_COV_GET_CLASS (gauss);
+  const gdouble zero = 0.0;
+
+  /* 
+   * Subclasses overriding m2lnL_val, bootstrap and low-rank updates are 
+   * evaluated point by point.
+   */
+  if ((NCM_DATA_GET_CLASS (data)->m2lnL_val != &_ncm_data_gauss_cov_m2lnL_val) || 
+      ncm_data_bootstrap_enabled (data) || (gauss->lr_U != NULL))
+  {
+    gdouble m2lnL;
+
+    _ncm_data_gauss_cov_m2lnL_val_batch_flush (gauss, mset);
+    NCM_DATA_GET_CLASS (data)->m2lnL_val (data, mset, &m2lnL);
+    g_array_append_val (gauss->batch_m2lnL, m2lnL);
+    return;
+  }
+
+  /* 
+   * The queued residuals are solved with the current decomposition before
+   * the covariance changes, when the covariance does not depend on the 
+   * varying parameters all points are solved at once.
+   */
+  {
+    gboolean cov_update = FALSE;
+
+    if (gauss_cov_class->cov_func != NULL)
+      cov_update = gauss_cov_class->cov_func (gauss, mset, gauss->cov);
+
+    if (cov_update || !gauss->prepared_LLT)
+    {
+      _ncm_data_gauss_cov_m2lnL_val_batch_flush (gauss, mset);
+      _ncm_data_gauss_cov_prepare_LLT (data);
+    }
+  }
+
+  if ((gauss->batch_R == NULL) || (ncm_matrix_nrows (gauss->batch_R) == gauss->batch_len))
+  {
+    const guint nrows = (gauss->batch_R == NULL) ? 8 : 2 * ncm_matrix_nrows (gauss->batch_R);
+    NcmMatrix *batch_R = ncm_matrix_new (nrows, gauss->np);
+    guint i;
+
+    for (i = 0; i < gauss->batch_len; i++)
+      memcpy (ncm_matrix_ptr (batch_R, i, 0), ncm_matrix_const_ptr (gauss->batch_R, i, 0), sizeof (gdouble) * gauss->np);
+
+    ncm_matrix_clear (&gauss->batch_R);
+    gauss->batch_R = batch_R;
+  }
+
+  {
+    NcmVectorView r = ncm_matrix_get_row_view (gauss->batch_R, gauss->batch_len);
+
+    if (gauss->batch_r == NULL)
+      gauss->batch_r = ncm_vector_new_view (&r);
+    else
+      ncm_vector_set_view (gauss->batch_r, &r);
+
+    gauss_cov_class->mean_func (gauss, mset, gauss->batch_r);
+    ncm_vector_sub (gauss->batch_r, gauss->y);
+  }
+
+  gauss->batch_len++;
+  g_array_append_val (gauss->batch_m2lnL, zero);
+}
+
+static void
+_ncm_data_gauss_cov_m2lnL_val_batch_eval (NcmData *data, NcmMSet *mset, NcmVector *m2lnL)
+{
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (data);
+  guint i;
+
+  _ncm_data_gauss_cov_m2lnL_val_batch_flush (gauss, mset);
+
+  g_assert_cmpuint (ncm_vector_len (m2lnL), ==, gauss->batch_m2lnL->len);
+
+  for (i = 0; i < gauss->batch_m2lnL->len; i++)
+    ncm_vector_addto (m2lnL, i, g_array_index (gauss->batch_m2lnL, gdouble, i));
+
+  g_array_set_size (gauss->batch_m2lnL, 0);
+}
+
 static void
 _ncm_data_gauss_cov_leastsquares_f (NcmData *data, NcmMSet *mset, NcmVector *v)
 {
   NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (data);
   NcmDataGaussCovClass *gauss_cov_class = NCM_DATA_GAUSS_COV_GET_CLASS (gauss);
-  gboolean cov_update = FALSE;
   gint ret;
 
   if (ncm_data_bootstrap_enabled (data))
@@ -393,12 +716,9 @@ _ncm_data_gauss_cov_leastsquares_f (NcmData *data, NcmMSet *mset, NcmVector *v)
   
   gauss_cov_class->mean_func (gauss, mset, v);
   ncm_vector_sub (v, gauss->y);
-  
-  if (gauss_cov_class->cov_func != NULL)
-    cov_update = gauss_cov_class->cov_func (gauss, mset, gauss->cov);
 
-  if (cov_update || !gauss->prepared_LLT)
-    _ncm_data_gauss_cov_prepare_LLT (data);
+  /* The residuals need the complete Cholesky decomposition. */
+  _ncm_data_gauss_cov_prepare_cov (gauss, mset, TRUE);
 
   /* CblasLower, CblasNoTrans => CblasUpper, CblasTrans */
   ret = gsl_blas_dtrsv (CblasUpper, CblasTrans, CblasNonUnit, 
@@ -417,6 +737,11 @@ _ncm_data_gauss_cov_set_size (NcmDataGaussCov *gauss, guint np)
     ncm_vector_clear (&gauss->v);
     ncm_matrix_clear (&gauss->cov);
     ncm_matrix_clear (&gauss->LLT);
+    ncm_matrix_clear (&gauss->batch_R);
+    ncm_vector_clear (&gauss->batch_r);
+    ncm_data_gauss_cov_set_lowrank (gauss, NULL);
+    gauss->batch_len = 0;
+    g_array_set_size (gauss->batch_m2lnL, 0);
     data->init = FALSE;
   }
   if ((np != 0) && (np != gauss->np))
@@ -468,3 +793,65 @@ ncm_data_gauss_cov_get_size (NcmDataGaussCov *gauss)
 {
   return NCM_DATA_GAUSS_COV_GET_CLASS (gauss)->get_size (gauss);
 }
+
+/**
+ * ncm_data_gauss_cov_set_lowrank:
+ * @gauss: a #NcmDataGaussCov
+ * @U: (allow-none): a #NcmMatrix
+ *
+ * Sets the low-rank update basis $U$, a $n \times r$ matrix where $n$ is
+ * the data size. The covariance becomes $C_0 + U S U^T$ where $C_0$ is
+ * computed by #NcmDataGaussCovClass.cov_func and the $r \times r$ matrix
+ * $S$ by #NcmDataGaussCovClass.cov_lowrank_func, which must be implemented.
+ * If @U is NULL the low-rank update is disabled.
+ * 
+ */
+void 
+ncm_data_gauss_cov_set_lowrank (NcmDataGaussCov *gauss, NcmMatrix *U)
+{
+  ncm_matrix_clear (&gauss->lr_U);
+  ncm_matrix_clear (&gauss->lr_S);
+  ncm_matrix_clear (&gauss->lr_W);
+  ncm_matrix_clear (&gauss->lr_G);
+  ncm_matrix_clear (&gauss->lr_M);
+  ncm_vector_clear (&gauss->lr_z);
+  ncm_vector_clear (&gauss->lr_t);
+  g_clear_pointer (&gauss->lr_p, gsl_permutation_free);
+
+  gauss->prepared_LLT = FALSE;
+
+  if (U != NULL)
+  {
+    const guint r = ncm_matrix_ncols (U);
+
+    if (NCM_DATA_GAUSS_COV_GET_CLASS (gauss)->cov_lowrank_func == NULL)
+      g_error ("ncm_data_gauss_cov_set_lowrank: the data (%s) does not implement cov_lowrank_func.",
+               G_OBJECT_TYPE_NAME (gauss));
+
+    g_assert_cmpuint (ncm_matrix_nrows (U), ==, gauss->np);
+    g_assert_cmpuint (r, >, 0);
+
+    gauss->lr_U = ncm_matrix_ref (U);
+    gauss->lr_S = ncm_matrix_new (r, r);
+    gauss->lr_W = ncm_matrix_new (gauss->np, r);
+    gauss->lr_G = ncm_matrix_new (r, r);
+    gauss->lr_M = ncm_matrix_new (r, r);
+    gauss->lr_z = ncm_vector_new (r);
+    gauss->lr_t = ncm_vector_new (r);
+    gauss->lr_p = gsl_permutation_alloc (r);
+  }
+}
+
+/**
+ * ncm_data_gauss_cov_peek_lowrank:
+ * @gauss: a #NcmDataGaussCov
+ *
+ * Gets the low-rank update basis, see ncm_data_gauss_cov_set_lowrank().
+ * 
+ * Returns: (transfer none) (allow-none): the low-rank basis $U$ or NULL.
+ */
+NcmMatrix *
+ncm_data_gauss_cov_peek_lowrank (NcmDataGaussCov *gauss)
+{
+  return gauss->lr_U;
+}
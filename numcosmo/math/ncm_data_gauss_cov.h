@@ -31,6 +31,7 @@
 #include <numcosmo/build_cfg.h>
 #include <numcosmo/math/ncm_data.h>
 #include <numcosmo/math/ncm_bootstrap.h>
+#include <gsl/gsl_permutation.h>
 
 G_BEGIN_DECLS
 
@@ -50,6 +51,7 @@ struct _NcmDataGaussCovClass
   NcmDataClass parent_class;
   void (*mean_func) (NcmDataGaussCov *gauss, NcmMSet *mset, NcmVector *vp);
   gboolean (*cov_func) (NcmDataGaussCov *gauss, NcmMSet *mset, NcmMatrix *cov);
+  void (*cov_lowrank_func) (NcmDataGaussCov *gauss, NcmMSet *mset, NcmMatrix *S);
   void (*lnNorma2) (NcmDataGaussCov *gauss, NcmMSet *mset, gdouble *m2lnL);
   void (*lnNorma2_bs) (NcmDataGaussCov *gauss, NcmMSet *mset, NcmBootstrap *bstrap, gdouble *m2lnL);
   void (*set_size) (NcmDataGaussCov *gauss, guint np);
@@ -65,6 +67,18 @@ struct _NcmDataGaussCov
   NcmVector *v;
   NcmMatrix *cov;
   NcmMatrix *LLT;
+  NcmMatrix *lr_U;
+  NcmMatrix *lr_S;
+  NcmMatrix *lr_W;
+  NcmMatrix *lr_G;
+  NcmMatrix *lr_M;
+  NcmVector *lr_z;
+  NcmVector *lr_t;
+  gsl_permutation *lr_p;
+  NcmMatrix *batch_R;
+  NcmVector *batch_r;
+  guint batch_len;
+  GArray *batch_m2lnL;
   gboolean prepared_LLT;
   gboolean use_norma;
 };
@@ -74,6 +88,9 @@ GType ncm_data_gauss_cov_get_type (void) G_GNUC_CONST;
 void ncm_data_gauss_cov_set_size (NcmDataGaussCov *gauss, guint np);
 guint ncm_data_gauss_cov_get_size (NcmDataGaussCov *gauss);
 
+void ncm_data_gauss_cov_set_lowrank (NcmDataGaussCov *gauss, NcmMatrix *U);
+NcmMatrix *ncm_data_gauss_cov_peek_lowrank (NcmDataGaussCov *gauss);
+
 G_END_DECLS
 
 #endif /* _NCM_DATA_GAUSS_COV_H_ */
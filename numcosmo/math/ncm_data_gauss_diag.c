@@ -156,6 +156,7 @@ static guint _ncm_data_gauss_diag_get_length (NcmData *data);
 static guint _ncm_data_gauss_diag_get_dof (NcmData *data);
 /* static void _ncm_data_gauss_diag_begin (NcmData *data); */
 static void _ncm_data_gauss_diag_resample (NcmData *data, NcmMSet *mset, NcmRNG *rng);
+static void _ncm_data_gauss_diag_share_immutable (NcmData *data, NcmSerialize *ser);
 static void _ncm_data_gauss_diag_m2lnL_val (NcmData *data, NcmMSet *mset, gdouble *m2lnL);
 static void _ncm_data_gauss_diag_leastsquares_f (NcmData *data, NcmMSet *mset, NcmVector *v);
 static void _ncm_data_gauss_diag_set_size (NcmDataGaussDiag *diag, guint np);
@@ -212,6 +213,7 @@ ncm_data_gauss_diag_class_init (NcmDataGaussDiagClass *klass)
   data_class->resample         = &_ncm_data_gauss_diag_resample;
   data_class->m2lnL_val        = &_ncm_data_gauss_diag_m2lnL_val;
   data_class->leastsquares_f   = &_ncm_data_gauss_diag_leastsquares_f;
+  data_class->share_immutable  = &_ncm_data_gauss_diag_share_immutable;
 
   gauss_diag_class->mean_func  = NULL;
   gauss_diag_class->sigma_func = NULL;
@@ -255,6 +257,18 @@ _ncm_data_gauss_prepare_weight (NcmData *data)
   diag->prepared_w = TRUE;
 }
 
+static void
+_ncm_data_gauss_diag_share_immutable (NcmData *data, NcmSerialize *ser)
+{
+  NcmDataGaussDiag *diag = NCM_DATA_GAUSS_DIAG (data);
+
+  ncm_data_share_obj (ser, diag->y);
+
+  /* The standard deviations are only constant when there is no sigma_func */
+  if (NCM_DATA_GAUSS_DIAG_GET_CLASS (diag)->sigma_func == NULL)
+    ncm_data_share_obj (ser, diag->sigma);
+}
+
 static void
 _ncm_data_gauss_diag_resample (NcmData *data, NcmMSet *mset, NcmRNG *rng)
 {
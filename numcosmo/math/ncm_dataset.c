@@ -233,6 +233,28 @@ ncm_dataset_dup (NcmDataset *dset, NcmSerialize *ser)
   return NCM_DATASET (ncm_serialize_dup_obj (ser, G_OBJECT (dset)));
 }
 
+/**
+ * ncm_dataset_share_immutable:
+ * @dset: a #NcmDataset
+ * @ser: a #NcmSerialize
+ *
+ * Calls ncm_data_share_immutable() for every #NcmData in @dset. After this
+ * call, ncm_dataset_dup() (or the duplication of any object containing @dset)
+ * through @ser creates replicas which share the immutable data with @dset.
+ *
+ */
+void
+ncm_dataset_share_immutable (NcmDataset *dset, NcmSerialize *ser)
+{
+  guint i;
+
+  for (i = 0; i < dset->oa->len; i++)
+  {
+    NcmData *data = ncm_dataset_peek_data (dset, i);
+    ncm_data_share_immutable (data, ser);
+  }
+}
+
 /**
  * ncm_dataset_copy:
  * @dset: pointer to type defined by #NcmDataset
@@ -980,6 +1002,63 @@ ncm_dataset_m2lnL_vec (NcmDataset *dset, NcmMSet *mset, NcmVector *m2lnL_v)
   return;
 }
 
+/**
+ * ncm_dataset_m2lnL_val_batch_add:
+ * @dset: a #NcmDataset
+ * @mset: a #NcmMSet
+ * @m2lnL: (out): the contribution of the data which do not support batching
+ *
+ * Queues the evaluation of $-2\ln(L)$ at the current parameters of @mset 
+ * for each #NcmData supporting batched evaluation, see 
+ * ncm_data_m2lnL_val_batch_add(). The remaining #NcmData are evaluated 
+ * immediately and their sum is returned in @m2lnL.
+ * 
+ */
+void
+ncm_dataset_m2lnL_val_batch_add (NcmDataset *dset, NcmMSet *mset, gdouble *m2lnL)
+{
+  guint i;
+  *m2lnL = 0.0;
+
+  for (i = 0; i < dset->oa->len; i++)
+  {
+    NcmData *data = ncm_dataset_peek_data (dset, i);
+
+    if (ncm_data_has_m2lnL_val_batch (data))
+      ncm_data_m2lnL_val_batch_add (data, mset);
+    else
+    {
+      gdouble m2lnL_i;
+      ncm_data_m2lnL_val (data, mset, &m2lnL_i);
+      *m2lnL += m2lnL_i;
+    }
+  }
+}
+
+/**
+ * ncm_dataset_m2lnL_val_batch_eval:
+ * @dset: a #NcmDataset
+ * @mset: a #NcmMSet
+ * @m2lnL: a #NcmVector
+ *
+ * Adds to the $i$-th component of @m2lnL the batched contributions to
+ * $-2\ln(L)$ of the $i$-th point queued with ncm_dataset_m2lnL_val_batch_add().
+ * 
+ */
+void
+ncm_dataset_m2lnL_val_batch_eval (NcmDataset *dset, NcmMSet *mset, NcmVector *m2lnL)
+{
+  guint i;
+
+  for (i = 0; i < dset->oa->len; i++)
+  {
+    NcmData *data = ncm_dataset_peek_data (dset, i);
+
+    if (ncm_data_has_m2lnL_val_batch (data))
+      ncm_data_m2lnL_val_batch_eval (data, mset, m2lnL);
+  }
+}
+
 /**
  * ncm_dataset_m2lnL_i_val:
  * @dset: a #NcmLikelihood
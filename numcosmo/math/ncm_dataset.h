@@ -84,6 +84,7 @@ GType ncm_dataset_get_type (void) G_GNUC_CONST;
 
 NcmDataset *ncm_dataset_new (void);
 NcmDataset *ncm_dataset_dup (NcmDataset *dset, NcmSerialize *ser);
+void ncm_dataset_share_immutable (NcmDataset *dset, NcmSerialize *ser);
 NcmDataset *ncm_dataset_ref (NcmDataset *dset);
 NcmDataset *ncm_dataset_copy (NcmDataset *dset);
 void ncm_dataset_free (NcmDataset *dset);
@@ -122,6 +123,8 @@ void ncm_dataset_leastsquares_f_J (NcmDataset *dset, NcmMSet *mset, NcmVector *f
 
 void ncm_dataset_m2lnL_val (NcmDataset *dset, NcmMSet *mset, gdouble *m2lnL);
 void ncm_dataset_m2lnL_vec (NcmDataset *dset, NcmMSet *mset, NcmVector *m2lnL_v);
+void ncm_dataset_m2lnL_val_batch_add (NcmDataset *dset, NcmMSet *mset, gdouble *m2lnL);
+void ncm_dataset_m2lnL_val_batch_eval (NcmDataset *dset, NcmMSet *mset, NcmVector *m2lnL);
 void ncm_dataset_m2lnL_grad (NcmDataset *dset, NcmMSet *mset, NcmVector *grad);
 void ncm_dataset_m2lnL_val_grad (NcmDataset *dset, NcmMSet *mset, gdouble *m2lnL, NcmVector *grad);
 
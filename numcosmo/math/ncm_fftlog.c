@@ -124,6 +124,8 @@ ncm_fftlog_init (NcmFftlog *fftlog)
   fftlog->prepared  = FALSE;
   fftlog->evaluated = FALSE;
 
+  fftlog->fft_nthreads = 1;
+
   fftlog->lnr_vec = NULL;
   fftlog->Gr_vec  = g_ptr_array_new ();
   fftlog->Gr_s    = g_ptr_array_new ();
@@ -139,6 +141,15 @@ ncm_fftlog_init (NcmFftlog *fftlog)
   fftlog->CmYm      = NULL;
   fftlog->p_Fk2Cm   = NULL;
   fftlog->p_CmYm2Gr = NULL;
+
+  fftlog->many_len       = 0;
+  fftlog->many_nthreads  = 0;
+  fftlog->many_Fk        = NULL;
+  fftlog->many_Cm        = NULL;
+  fftlog->many_CmYm      = NULL;
+  fftlog->many_Gr        = NULL;
+  fftlog->p_many_Fk2Cm   = NULL;
+  fftlog->p_many_CmYm2Gr = NULL;
   g_ptr_array_set_free_func (fftlog->Ym, (GDestroyNotify)fftw_free);
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 }
@@ -217,9 +228,26 @@ _ncm_fftlog_get_property (GObject *object, guint prop_id, GValue *value, GParamS
 }
 
 #ifdef NUMCOSMO_HAVE_FFTW3
+static void
+_ncm_fftlog_free_many (NcmFftlog *fftlog)
+{
+  g_clear_pointer (&fftlog->p_many_Fk2Cm, fftw_destroy_plan);
+  g_clear_pointer (&fftlog->p_many_CmYm2Gr, fftw_destroy_plan);
+
+  g_clear_pointer (&fftlog->many_Fk, fftw_free);
+  g_clear_pointer (&fftlog->many_Cm, fftw_free);
+  g_clear_pointer (&fftlog->many_CmYm, fftw_free);
+  g_clear_pointer (&fftlog->many_Gr, fftw_free);
+
+  fftlog->many_len      = 0;
+  fftlog->many_nthreads = 0;
+}
+
 static void
 _ncm_fftlog_free_all (NcmFftlog *fftlog)
 {
+  _ncm_fftlog_free_many (fftlog);
+
   g_clear_pointer (&fftlog->Fk, fftw_free);
   g_clear_pointer (&fftlog->Cm, fftw_free);
   g_clear_pointer (&fftlog->CmYm, fftw_free);
@@ -619,15 +647,47 @@ ncm_fftlog_set_length (NcmFftlog *fftlog, gdouble Lk)
   }
 }
 
+/**
+ * ncm_fftlog_set_fft_nthreads:
+ * @fftlog: a #NcmFftlog
+ * @nthreads: number of threads
+ * 
+ * Sets the number of threads used by the batched transforms of
+ * ncm_fftlog_eval_by_matrix(). This has effect only when FFTW was 
+ * compiled with threads support.
+ * 
+ */
+void
+ncm_fftlog_set_fft_nthreads (NcmFftlog *fftlog, guint nthreads)
+{
+  g_assert_cmpuint (nthreads, >, 0);
+#ifndef HAVE_FFTW3_THREADS
+  if (nthreads > 1)
+    g_warning ("ncm_fftlog_set_fft_nthreads: FFTW threads not available, ignoring.");
+  nthreads = 1;
+#endif /* HAVE_FFTW3_THREADS */
+  fftlog->fft_nthreads = nthreads;
+}
+
+/**
+ * ncm_fftlog_get_fft_nthreads:
+ * @fftlog: a #NcmFftlog
+ * 
+ * Returns: the number of threads used by the batched transforms.
+ */
+guint
+ncm_fftlog_get_fft_nthreads (NcmFftlog *fftlog)
+{
+  return fftlog->fft_nthreads;
+}
+
 #ifdef NUMCOSMO_HAVE_FFTW3
 static void
-_ncm_fftlog_eval (NcmFftlog *fftlog)
+_ncm_fftlog_prepare_Ym (NcmFftlog *fftlog)
 {
   guint nd;
   gint i;
 
-  fftw_execute (fftlog->p_Fk2Cm);
-  
   if (!fftlog->prepared)
   {
     const gdouble twopi_Lt = 2.0 * M_PI / ncm_fftlog_get_full_length (fftlog);
@@ -661,6 +721,17 @@ _ncm_fftlog_eval (NcmFftlog *fftlog)
     
     ncm_vector_set (fftlog->lnr_vec, i, lnr);
   }
+}
+
+static void
+_ncm_fftlog_eval (NcmFftlog *fftlog)
+{
+  guint nd;
+  gint i;
+
+  fftw_execute (fftlog->p_Fk2Cm);
+
+  _ncm_fftlog_prepare_Ym (fftlog);
   
   for (nd = 0; nd <= fftlog->nderivs; nd++)
   {
@@ -697,6 +768,47 @@ _ncm_fftlog_eval (NcmFftlog *fftlog)
 
   fftlog->evaluated = TRUE;
 }
+
+static void
+_ncm_fftlog_many_alloc (NcmFftlog *fftlog, const guint len)
+{
+  if ((fftlog->many_len != len) || (fftlog->many_nthreads != fftlog->fft_nthreads))
+  {
+    const gint n[1] = {fftlog->Nf};
+
+    _ncm_fftlog_free_many (fftlog);
+
+    /* One transform per row, each of them contiguous. */
+    fftlog->many_Fk   = fftw_alloc_complex (fftlog->Nf * len);
+    fftlog->many_Cm   = fftw_alloc_complex (fftlog->Nf * len);
+    fftlog->many_CmYm = fftw_alloc_complex (fftlog->Nf * len);
+    fftlog->many_Gr   = fftw_alloc_complex (fftlog->Nf * len);
+
+    ncm_cfg_load_fftw_wisdom ("ncm_fftlog_%s", NCM_FFTLOG_GET_CLASS (fftlog)->name);
+
+    ncm_cfg_lock_plan_fftw ();
+#ifdef HAVE_FFTW3_THREADS
+    fftw_plan_with_nthreads (fftlog->fft_nthreads);
+#endif /* HAVE_FFTW3_THREADS */
+    fftlog->p_many_Fk2Cm   = fftw_plan_many_dft (1, n, len, 
+                                                 fftlog->many_Fk, NULL, 1, fftlog->Nf,
+                                                 fftlog->many_Cm, NULL, 1, fftlog->Nf,
+                                                 FFTW_FORWARD, fftw_default_flags | FFTW_DESTROY_INPUT);
+    fftlog->p_many_CmYm2Gr = fftw_plan_many_dft (1, n, len, 
+                                                 fftlog->many_CmYm, NULL, 1, fftlog->Nf,
+                                                 fftlog->many_Gr,   NULL, 1, fftlog->Nf,
+                                                 FFTW_FORWARD, fftw_default_flags | FFTW_DESTROY_INPUT);
+#ifdef HAVE_FFTW3_THREADS
+    fftw_plan_with_nthreads (1);
+#endif /* HAVE_FFTW3_THREADS */
+    ncm_cfg_unlock_plan_fftw ();
+
+    ncm_cfg_save_fftw_wisdom ("ncm_fftlog_%s", NCM_FFTLOG_GET_CLASS (fftlog)->name);
+
+    fftlog->many_len      = len;
+    fftlog->many_nthreads = fftlog->fft_nthreads;
+  }
+}
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 
 /**
@@ -754,6 +866,85 @@ ncm_fftlog_eval_by_function (NcmFftlog *fftlog, gsl_function *Fk)
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 }
 
+/**
+ * ncm_fftlog_eval_by_matrix:
+ * @fftlog: a #NcmFftlog
+ * @Fk: a #NcmMatrix
+ * @Gr: (element-type NcmMatrix): output matrices
+ * 
+ * Batched version of ncm_fftlog_eval_by_vector(), each row of @Fk contains
+ * the values of one function at the knots $\ln k_m$, see 
+ * ncm_fftlog_get_lnk_vector(). All rows are transformed together through
+ * FFTW advanced interface plans (see ncm_fftlog_set_fft_nthreads()). 
+ * 
+ * The array @Gr must contain #NcmFftlog:nderivs + 1 matrices with the same 
+ * number of rows as @Fk and ncm_fftlog_get_size() columns, the @nd-th 
+ * matrix receives $G(r)$ ($nd = 0$) or its @nd-th derivative with respect 
+ * to $\ln r$ at the knots ncm_fftlog_get_vector_lnr(). The internal output
+ * vectors and splines are not changed.
+ * 
+ */
+void 
+ncm_fftlog_eval_by_matrix (NcmFftlog *fftlog, NcmMatrix *Fk, GPtrArray *Gr)
+{
+#ifdef NUMCOSMO_HAVE_FFTW3
+  const guint len     = ncm_matrix_nrows (Fk);
+  const gdouble norma = ncm_fftlog_get_norma (fftlog);
+  guint nd, b;
+  gint i;
+
+  g_assert_cmpuint (ncm_matrix_ncols (Fk), ==, fftlog->N);
+  g_assert_cmpuint (Gr->len, ==, fftlog->nderivs + 1);
+
+  _ncm_fftlog_many_alloc (fftlog, len);
+
+  memset (fftlog->many_Fk, 0, sizeof (complex double) * fftlog->Nf * len);
+
+  for (b = 0; b < len; b++)
+  {
+    fftw_complex *Fk_b = &fftlog->many_Fk[b * fftlog->Nf + fftlog->pad];
+    
+    for (i = 0; i < fftlog->N; i++)
+      Fk_b[i] = ncm_matrix_get (Fk, b, i);
+  }
+
+  fftw_execute (fftlog->p_many_Fk2Cm);
+
+  _ncm_fftlog_prepare_Ym (fftlog);
+
+  for (nd = 0; nd <= fftlog->nderivs; nd++)
+  {
+    NcmMatrix *Gr_nd    = g_ptr_array_index (Gr, nd);
+    fftw_complex *Ym_nd = g_ptr_array_index (fftlog->Ym, nd);
+
+    g_assert_cmpuint (ncm_matrix_nrows (Gr_nd), ==, len);
+    g_assert_cmpuint (ncm_matrix_ncols (Gr_nd), ==, fftlog->N);
+
+    for (b = 0; b < len; b++)
+    {
+      const fftw_complex *Cm_b = &fftlog->many_Cm[b * fftlog->Nf];
+      fftw_complex *CmYm_b     = &fftlog->many_CmYm[b * fftlog->Nf];
+
+      for (i = 0; i < fftlog->Nf; i++)
+        CmYm_b[i] = Cm_b[i] * Ym_nd[i];
+
+      CmYm_b[fftlog->Nf_2]     = creal (CmYm_b[fftlog->Nf_2]);
+      CmYm_b[fftlog->Nf_2 + 1] = creal (CmYm_b[fftlog->Nf_2 + 1]);
+    }
+
+    fftw_execute (fftlog->p_many_CmYm2Gr);
+
+    for (i = 0; i < fftlog->N; i++)
+    {
+      const gdouble rm1_norma = exp (-ncm_vector_get (fftlog->lnr_vec, i)) / norma;
+
+      for (b = 0; b < len; b++)
+        ncm_matrix_set (Gr_nd, b, i, creal (fftlog->many_Gr[b * fftlog->Nf + i + fftlog->pad]) * rm1_norma);
+    }
+  }
+#endif /* NUMCOSMO_HAVE_FFTW3 */
+}
+
 /**
  * ncm_fftlog_prepare_splines:
  * @fftlog: a #NcmFftlog
@@ -787,6 +978,30 @@ ncm_fftlog_get_vector_lnr (NcmFftlog *fftlog)
   return ncm_vector_ref (fftlog->lnr_vec);
 }
 
+/**
+ * ncm_fftlog_get_lnk_vector:
+ * @fftlog: a #NcmFftlog
+ * @lnk: a #NcmVector
+ * 
+ * Fills @lnk with the ncm_fftlog_get_size() knots $\ln k_m$ of the 
+ * fundamental interval, i.e., the points where the rows of the input of 
+ * ncm_fftlog_eval_by_matrix() must be computed.
+ * 
+ */
+void
+ncm_fftlog_get_lnk_vector (NcmFftlog *fftlog, NcmVector *lnk)
+{
+  gint i;
+
+  g_assert_cmpuint (ncm_vector_len (lnk), ==, fftlog->N);
+
+  for (i = 0; i < fftlog->N; i++)
+  {
+    const gint phys_i = i - fftlog->N_2;
+    ncm_vector_set (lnk, i, fftlog->lnk0 + fftlog->Lk_N * phys_i);
+  }
+}
+
 /**
  * ncm_fftlog_get_vector_Gr:
  * @fftlog: a #NcmFftlog
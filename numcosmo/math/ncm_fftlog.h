@@ -30,6 +30,7 @@
 #include <glib-object.h>
 #include <numcosmo/build_cfg.h>
 #include <numcosmo/math/ncm_vector.h>
+#include <numcosmo/math/ncm_matrix.h>
 #include <numcosmo/math/ncm_spline.h>
 #include <gsl/gsl_math.h>
 #ifndef NUMCOSMO_GIR_SCAN
@@ -79,6 +80,7 @@ struct _NcmFftlog
   gdouble pad_p;
   gboolean prepared;
   gboolean evaluated;
+  guint fft_nthreads;
   NcmVector *lnr_vec;
   GPtrArray *Gr_vec;
   GPtrArray *Gr_s;
@@ -90,6 +92,14 @@ struct _NcmFftlog
   GPtrArray *Ym;
   fftw_plan p_Fk2Cm;
   fftw_plan p_CmYm2Gr;
+  guint many_len;
+  guint many_nthreads;
+  fftw_complex *many_Fk;
+  fftw_complex *many_Cm;
+  fftw_complex *many_CmYm;
+  fftw_complex *many_Gr;
+  fftw_plan p_many_Fk2Cm;
+  fftw_plan p_many_CmYm2Gr;
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 };
 
@@ -118,12 +128,17 @@ gdouble ncm_fftlog_get_padding (NcmFftlog *fftlog);
 
 void ncm_fftlog_set_length (NcmFftlog *fftlog, gdouble Lk);
 
+void ncm_fftlog_set_fft_nthreads (NcmFftlog *fftlog, guint nthreads);
+guint ncm_fftlog_get_fft_nthreads (NcmFftlog *fftlog);
+
 void ncm_fftlog_eval_by_vector (NcmFftlog *fftlog, NcmVector *Fk);
 void ncm_fftlog_eval_by_function (NcmFftlog *fftlog, gsl_function *Fk);
+void ncm_fftlog_eval_by_matrix (NcmFftlog *fftlog, NcmMatrix *Fk, GPtrArray *Gr);
 
 void ncm_fftlog_prepare_splines (NcmFftlog *fftlog);
 
 NcmVector *ncm_fftlog_get_vector_lnr (NcmFftlog *fftlog);
+void ncm_fftlog_get_lnk_vector (NcmFftlog *fftlog, NcmVector *lnk);
 NcmVector *ncm_fftlog_get_vector_Gr (NcmFftlog *fftlog, guint nderiv);
 
 NcmSpline *ncm_fftlog_peek_spline_Gr (NcmFftlog *fftlog, guint nderiv);
@@ -1127,6 +1127,62 @@ _ncm_fit_run_empty (NcmFit *fit, NcmFitRunMsgs mtype)
   return TRUE;
 }
 
+/**
+ * ncm_fit_measure_model_costs:
+ * @fit: a #NcmFit
+ * @nrep: number of evaluations per model
+ *
+ * Measures the cost of each model with free parameters in the #NcmMSet
+ * of @fit. For each of these models the likelihood is evaluated @nrep
+ * times, each time after marking only that model as updated, see
+ * ncm_model_params_update(). Therefore, only what depends on the model
+ * is recomputed. The mean wall time of these evaluations is set as the
+ * model cost using ncm_mset_set_model_cost().
+ *
+ */
+void
+ncm_fit_measure_model_costs (NcmFit *fit, guint nrep)
+{
+  const guint fparam_len = ncm_mset_fparam_len (fit->mset);
+  GArray *mids           = g_array_new (FALSE, FALSE, sizeof (NcmModelID));
+  gdouble m2lnL;
+  guint i, j;
+
+  g_assert_cmpuint (nrep, >, 0);
+
+  for (i = 0; i < fparam_len; i++)
+  {
+    const NcmMSetPIndex *pi = ncm_mset_fparam_get_pi (fit->mset, i);
+    gboolean found = FALSE;
+
+    for (j = 0; j < mids->len; j++)
+      found = found || (g_array_index (mids, NcmModelID, j) == pi->mid);
+
+    if (!found)
+      g_array_append_val (mids, pi->mid);
+  }
+
+  /* Everything computed at the current point, the first timing is not a full evaluation. */
+  ncm_fit_m2lnL_val (fit, &m2lnL);
+
+  for (j = 0; j < mids->len; j++)
+  {
+    const NcmModelID mid = g_array_index (mids, NcmModelID, j);
+    NcmModel *model      = ncm_mset_peek (fit->mset, mid);
+    const gint64 t0      = g_get_monotonic_time ();
+
+    for (i = 0; i < nrep; i++)
+    {
+      ncm_model_params_update (model);
+      ncm_fit_m2lnL_val (fit, &m2lnL);
+    }
+
+    ncm_mset_set_model_cost (fit->mset, mid, (g_get_monotonic_time () - t0) * 1.0e-6 / nrep);
+  }
+
+  g_array_unref (mids);
+}
+
 /**
  * ncm_fit_reset:
  * @fit: a #NcmFit
@@ -1536,27 +1592,69 @@ ncm_fit_m2lnL_grad_nd_ce (NcmFit *fit, NcmVector *grad)
   guint i;
   guint fparam_len = ncm_mset_fparam_len (fit->mset);
 
-  for (i = 0; i < fparam_len; i++)
+  if (fit->sub_fit == NULL)
   {
-    const gdouble p = ncm_mset_fparam_get (fit->mset, i);
-    const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (fit->mset, i));
-    const gdouble h = p_scale * GSL_ROOT3_DBL_EPSILON;
-    const gdouble pph = p + h;
-    const gdouble pmh = p - h;
-    const gdouble twoh = pph - pmh;
-    const gdouble one_2h = 1.0 / twoh;
-    gdouble m2lnL_pph, m2lnL_pmh;
+    /* All 2 x fparam_len points are evaluated in one batch. */
+    NcmMatrix *x     = ncm_matrix_new (2 * fparam_len, fparam_len);
+    NcmVector *m2lnL = ncm_vector_new (2 * fparam_len);
+    NcmVector *x0    = ncm_vector_new (fparam_len);
+    NcmVector *twoh  = ncm_vector_new (fparam_len);
 
-    ncm_fit_params_set (fit, i, pph);
-    ncm_likelihood_m2lnL_val (fit->lh, fit->mset, &m2lnL_pph);
-    /*ncm_fit_m2lnL_val (fit, &m2lnL_pph);*/
+    ncm_mset_fparams_get_vector (fit->mset, x0);
 
-    ncm_fit_params_set (fit, i, pmh);
-    ncm_likelihood_m2lnL_val (fit->lh, fit->mset, &m2lnL_pmh);
-    /*ncm_fit_m2lnL_val (fit, &m2lnL_pmh);*/
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble p       = ncm_vector_get (x0, i);
+      const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (fit->mset, i));
+      const gdouble h       = p_scale * GSL_ROOT3_DBL_EPSILON;
+      const gdouble pph     = p + h;
+      const gdouble pmh     = p - h;
+
+      ncm_matrix_set_row (x, 2 * i + 0, x0);
+      ncm_matrix_set_row (x, 2 * i + 1, x0);
+      ncm_matrix_set (x, 2 * i + 0, i, pph);
+      ncm_matrix_set (x, 2 * i + 1, i, pmh);
+      ncm_vector_set (twoh, i, pph - pmh);
+    }
 
-    ncm_vector_set (grad, i, (m2lnL_pph - m2lnL_pmh) * one_2h);
-    ncm_fit_params_set (fit, i, p);
+    ncm_likelihood_m2lnL_val_batch (fit->lh, fit->mset, x, m2lnL);
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble m2lnL_pph = ncm_vector_get (m2lnL, 2 * i + 0);
+      const gdouble m2lnL_pmh = ncm_vector_get (m2lnL, 2 * i + 1);
+      ncm_vector_set (grad, i, (m2lnL_pph - m2lnL_pmh) / ncm_vector_get (twoh, i));
+    }
+
+    ncm_vector_free (twoh);
+    ncm_vector_free (x0);
+    ncm_vector_free (m2lnL);
+    ncm_matrix_free (x);
+  }
+  else
+  {
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble p = ncm_mset_fparam_get (fit->mset, i);
+      const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (fit->mset, i));
+      const gdouble h = p_scale * GSL_ROOT3_DBL_EPSILON;
+      const gdouble pph = p + h;
+      const gdouble pmh = p - h;
+      const gdouble twoh = pph - pmh;
+      const gdouble one_2h = 1.0 / twoh;
+      gdouble m2lnL_pph, m2lnL_pmh;
+
+      ncm_fit_params_set (fit, i, pph);
+      ncm_likelihood_m2lnL_val (fit->lh, fit->mset, &m2lnL_pph);
+      /*ncm_fit_m2lnL_val (fit, &m2lnL_pph);*/
+
+      ncm_fit_params_set (fit, i, pmh);
+      ncm_likelihood_m2lnL_val (fit->lh, fit->mset, &m2lnL_pmh);
+      /*ncm_fit_m2lnL_val (fit, &m2lnL_pmh);*/
+
+      ncm_vector_set (grad, i, (m2lnL_pph - m2lnL_pmh) * one_2h);
+      ncm_fit_params_set (fit, i, p);
+    }
   }
 
   fit->fstate->grad_eval++;
@@ -1696,21 +1794,60 @@ ncm_fit_m2lnL_val_grad_nd_fo (NcmFit *fit, gdouble *m2lnL, NcmVector *grad)
   guint i;
   guint fparam_len = ncm_mset_fparam_len (fit->mset);
 
-  ncm_fit_m2lnL_val (fit, m2lnL);
+  if (fit->sub_fit == NULL)
+  {
+    /* The central point and the fparam_len displaced points are evaluated in one batch. */
+    NcmMatrix *x      = ncm_matrix_new (fparam_len + 1, fparam_len);
+    NcmVector *m2lnLv = ncm_vector_new (fparam_len + 1);
+    NcmVector *x0     = ncm_vector_new (fparam_len);
+    NcmVector *hv     = ncm_vector_new (fparam_len);
 
-  for (i = 0; i < fparam_len; i++)
+    ncm_mset_fparams_get_vector (fit->mset, x0);
+    ncm_matrix_set_row (x, 0, x0);
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble p       = ncm_vector_get (x0, i);
+      const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (fit->mset, i));
+      const gdouble htilde  = GSL_SQRT_DBL_EPSILON * p_scale;
+      const gdouble pph     = p + htilde;
+
+      ncm_matrix_set_row (x, i + 1, x0);
+      ncm_matrix_set (x, i + 1, i, pph);
+      ncm_vector_set (hv, i, pph - p);
+    }
+
+    ncm_likelihood_m2lnL_val_batch (fit->lh, fit->mset, x, m2lnLv);
+    *m2lnL = ncm_vector_get (m2lnLv, 0);
+
+    for (i = 0; i < fparam_len; i++)
+      ncm_vector_set (grad, i, (ncm_vector_get (m2lnLv, i + 1) - *m2lnL) / ncm_vector_get (hv, i));
+
+    ncm_vector_free (hv);
+    ncm_vector_free (x0);
+    ncm_vector_free (m2lnLv);
+    ncm_matrix_free (x);
+
+    fit->fstate->func_eval += fparam_len + 1;
+  }
+  else
   {
-    const gdouble p = ncm_mset_fparam_get (fit->mset, i);
-    const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (fit->mset, i));
-    const gdouble htilde = GSL_SQRT_DBL_EPSILON * p_scale;
-    const gdouble pph = p + htilde;
-    const gdouble h = pph - p;
-    const gdouble one_h = 1.0 / h;
-    gdouble m2lnL_pph;
-    ncm_fit_params_set (fit, i, pph);
-    ncm_fit_m2lnL_val (fit, &m2lnL_pph);
-    ncm_vector_set (grad, i, (m2lnL_pph - *m2lnL) * one_h);
-    ncm_fit_params_set (fit, i, p);
+    ncm_fit_m2lnL_val (fit, m2lnL);
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      const gdouble p = ncm_mset_fparam_get (fit->mset, i);
+      const gdouble p_scale = GSL_MAX (fabs (p), ncm_mset_fparam_get_scale (fit->mset, i));
+      const gdouble htilde = GSL_SQRT_DBL_EPSILON * p_scale;
+      const gdouble pph = p + htilde;
+      const gdouble h = pph - p;
+      const gdouble one_h = 1.0 / h;
+      gdouble m2lnL_pph;
+      ncm_fit_params_set (fit, i, pph);
+      ncm_fit_m2lnL_val (fit, &m2lnL_pph);
+      ncm_vector_set (grad, i, (m2lnL_pph - *m2lnL) * one_h);
+      ncm_fit_params_set (fit, i, p);
+    }
   }
   fit->fstate->func_eval++;
   fit->fstate->grad_eval++;
@@ -278,6 +278,7 @@ gdouble ncm_fit_lr_test (NcmFit *fit, NcmModelID mid, guint pid, gdouble val, gi
 gdouble ncm_fit_prob (NcmFit *fit, NcmModelID mid, guint pid, gdouble a, gdouble b);
 gdouble ncm_fit_chisq_test (NcmFit *fit, size_t bins);
 
+void ncm_fit_measure_model_costs (NcmFit *fit, guint nrep);
 void ncm_fit_reset (NcmFit *fit);
 gboolean ncm_fit_run (NcmFit *fit, NcmFitRunMsgs mtype);
 
@@ -29,6 +29,21 @@
  * @short_description: Ensemble sampler Markov Chain Monte Carlo analysis.
  *
  * FIXME
+ *
+ * When some models are much cheaper to recompute than the others, each walker
+ * can perform several fast steps after its full step, see
+ * ncm_fit_esmcmc_set_fast_steps(). The fast parameters are those whose model
+ * cost, see ncm_mset_set_model_cost() and ncm_fit_measure_model_costs(), is
+ * at most #NCM_MSET_FAST_COST_RATIO times the largest cost. A fast step is a
+ * stretch move restricted to the fast parameters, using a walker of the
+ * complementary half of the ensemble, and it does not change the slow
+ * parameters, so their models are not recomputed. The catalog receives one
+ * row per walker full step, i.e., after its fast steps.
+ *
+ * The run ncm_fit_esmcmc_run_lre() stops when the largest relative error of
+ * the parameter means is attained and, for catalogs with more than one chain,
+ * the Gelman-Rubin shrink factor is not larger than the value set with
+ * ncm_fit_esmcmc_set_max_shrink_factor().
  * 
  */
 
@@ -53,13 +68,17 @@ enum
   PROP_WALKER,
   PROP_AUTO_TRIM,
   PROP_AUTO_TRIM_DIV,
+  PROP_AUTO_TRIM_DOUBLING,
   PROP_TRIM_TYPE,
   PROP_MIN_RUNS,
   PROP_MAX_RUNS_TIME,
+  PROP_MAX_SHRINK_FACTOR,
   PROP_MTYPE,
   PROP_NTHREADS,
   PROP_DATA_FILE,
   PROP_FUNCS_ARRAY,
+  PROP_SHARE_DATA,
+  PROP_FAST_STEPS,
 };
 
 G_DEFINE_TYPE (NcmFitESMCMC, ncm_fit_esmcmc, G_TYPE_OBJECT);
@@ -82,9 +101,12 @@ ncm_fit_esmcmc_init (NcmFitESMCMC *esmcmc)
   esmcmc->walker          = NULL;
   esmcmc->auto_trim       = FALSE;
   esmcmc->auto_trim_div   = 0;
+  esmcmc->auto_trim_len   = 0;
+  esmcmc->auto_trim_dbl   = FALSE;
   esmcmc->trim_type       = 0;
   esmcmc->min_runs        = 0;
   esmcmc->max_runs_time   = 0.0;
+  esmcmc->max_shrink      = 0.0;
   esmcmc->nadd_vals       = 0;
   esmcmc->fparam_len      = 0;
 
@@ -103,6 +125,13 @@ ncm_fit_esmcmc_init (NcmFitESMCMC *esmcmc)
   esmcmc->accepted        = g_array_new (TRUE, TRUE, sizeof (gboolean));
   esmcmc->offboard        = g_array_new (TRUE, TRUE, sizeof (gboolean));
 
+  esmcmc->fast_steps      = 0;
+  esmcmc->fast_fpi        = g_array_new (FALSE, FALSE, sizeof (guint));
+  esmcmc->fast_rand       = NULL;
+  esmcmc->fast_accepted   = g_array_new (TRUE, TRUE, sizeof (guint));
+  esmcmc->nfast_total     = 0;
+  esmcmc->nfast_accepted  = 0;
+
   esmcmc->funcs_oa        = NULL;
   esmcmc->funcs_oa_file   = NULL;
   
@@ -114,10 +143,18 @@ ncm_fit_esmcmc_init (NcmFitESMCMC *esmcmc)
   esmcmc->naccepted       = 0;
   esmcmc->noffboard       = 0;
   esmcmc->started         = FALSE;
+  esmcmc->share_data      = FALSE;
+  esmcmc->writer          = NULL;
+  esmcmc->write_queue     = g_async_queue_new ();
+  esmcmc->row_pool        = g_async_queue_new_full ((GDestroyNotify) &ncm_vector_free);
+  esmcmc->write_pending   = FALSE;
+  esmcmc->busy_time       = 0;
+  esmcmc->core_usage      = 0.0;
 
   g_mutex_init (&esmcmc->dup_fit);
   g_mutex_init (&esmcmc->resample_lock);
   g_mutex_init (&esmcmc->update_lock);
+  g_mutex_init (&esmcmc->write_lock);
   g_cond_init (&esmcmc->write_cond);
 }
 
@@ -188,6 +225,7 @@ _ncm_fit_esmcmc_constructed (GObject *object)
     esmcmc->jumps = ncm_vector_new (esmcmc->nwalkers);
     g_array_set_size (esmcmc->accepted, esmcmc->nwalkers);
     g_array_set_size (esmcmc->offboard, esmcmc->nwalkers);
+    g_array_set_size (esmcmc->fast_accepted, esmcmc->nwalkers);
     
     if (esmcmc->walker == NULL)
       esmcmc->walker = ncm_fit_esmcmc_walker_new_from_name ("NcmFitESMCMCWalkerStretch");
@@ -225,6 +263,9 @@ ncm_fit_esmcmc_set_property (GObject *object, guint prop_id, const GValue *value
     case PROP_AUTO_TRIM_DIV:
       esmcmc->auto_trim_div = g_value_get_uint (value);
       break;
+    case PROP_AUTO_TRIM_DOUBLING:
+      ncm_fit_esmcmc_set_auto_trim_doubling (esmcmc, g_value_get_boolean (value));
+      break;
     case PROP_TRIM_TYPE:
       esmcmc->trim_type = g_value_get_flags (value);
       break;
@@ -234,6 +275,9 @@ ncm_fit_esmcmc_set_property (GObject *object, guint prop_id, const GValue *value
     case PROP_MAX_RUNS_TIME:
       esmcmc->max_runs_time = g_value_get_double (value);
       break;
+    case PROP_MAX_SHRINK_FACTOR:
+      ncm_fit_esmcmc_set_max_shrink_factor (esmcmc, g_value_get_double (value));
+      break;
     case PROP_MTYPE:
       ncm_fit_esmcmc_set_mtype (esmcmc, g_value_get_enum (value));
       break;
@@ -259,6 +303,12 @@ ncm_fit_esmcmc_set_property (GObject *object, guint prop_id, const GValue *value
       }
       break;
     }
+    case PROP_SHARE_DATA:
+      ncm_fit_esmcmc_set_share_data (esmcmc, g_value_get_boolean (value));
+      break;
+    case PROP_FAST_STEPS:
+      ncm_fit_esmcmc_set_fast_steps (esmcmc, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -291,6 +341,9 @@ ncm_fit_esmcmc_get_property (GObject *object, guint prop_id, GValue *value, GPar
     case PROP_AUTO_TRIM_DIV:
       g_value_set_uint (value, esmcmc->auto_trim_div);
       break;
+    case PROP_AUTO_TRIM_DOUBLING:
+      g_value_set_boolean (value, esmcmc->auto_trim_dbl);
+      break;
     case PROP_TRIM_TYPE:
       g_value_set_flags (value, esmcmc->trim_type);
       break;
@@ -300,6 +353,9 @@ ncm_fit_esmcmc_get_property (GObject *object, guint prop_id, GValue *value, GPar
     case PROP_MAX_RUNS_TIME:
       g_value_set_double (value, esmcmc->max_runs_time);
       break;
+    case PROP_MAX_SHRINK_FACTOR:
+      g_value_set_double (value, esmcmc->max_shrink);
+      break;
     case PROP_MTYPE:
       g_value_set_enum (value, esmcmc->mtype);
       break;
@@ -312,6 +368,12 @@ ncm_fit_esmcmc_get_property (GObject *object, guint prop_id, GValue *value, GPar
     case PROP_FUNCS_ARRAY:
       g_value_set_boxed (value, esmcmc->funcs_oa);
       break;
+    case PROP_SHARE_DATA:
+      g_value_set_boolean (value, esmcmc->share_data);
+      break;
+    case PROP_FAST_STEPS:
+      g_value_set_uint (value, esmcmc->fast_steps);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -346,6 +408,14 @@ ncm_fit_esmcmc_dispose (GObject *object)
   g_clear_pointer (&esmcmc->accepted, g_array_unref);
   g_clear_pointer (&esmcmc->offboard, g_array_unref);
 
+  ncm_matrix_clear (&esmcmc->fast_rand);
+  g_clear_pointer (&esmcmc->fast_fpi, g_array_unref);
+  g_clear_pointer (&esmcmc->fast_accepted, g_array_unref);
+
+  g_assert (esmcmc->writer == NULL);
+  g_clear_pointer (&esmcmc->write_queue, g_async_queue_unref);
+  g_clear_pointer (&esmcmc->row_pool, g_async_queue_unref);
+
   if (esmcmc->walker_pool != NULL)
   {
     ncm_memory_pool_free (esmcmc->walker_pool, TRUE);
@@ -364,6 +434,7 @@ ncm_fit_esmcmc_finalize (GObject *object)
   g_mutex_clear (&esmcmc->dup_fit);
   g_mutex_clear (&esmcmc->resample_lock);
   g_mutex_clear (&esmcmc->update_lock);
+  g_mutex_clear (&esmcmc->write_lock);
   g_cond_clear (&esmcmc->write_cond);
   
   /* Chain up : end */
@@ -425,6 +496,13 @@ ncm_fit_esmcmc_class_init (NcmFitESMCMCClass *klass)
                                                       "Automatically trim divisor",
                                                       1, G_MAXUINT, 100,
                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_AUTO_TRIM_DOUBLING,
+                                   g_param_spec_boolean ("auto-trim-doubling",
+                                                         NULL,
+                                                         "Whether to auto-trim only when the catalog size doubled",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   g_object_class_install_property (object_class,
                                    PROP_TRIM_TYPE,
                                    g_param_spec_flags ("trim-type",
@@ -446,6 +524,13 @@ ncm_fit_esmcmc_class_init (NcmFitESMCMCClass *klass)
                                                         "Maximum time between runs",
                                                         1.0, G_MAXDOUBLE, 2.0 * 60.0 * 60.0,
                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_MAX_SHRINK_FACTOR,
+                                   g_param_spec_double ("max-shrink-factor",
+                                                        NULL,
+                                                        "Maximum Gelman-Rubin shrink factor, zero disables the test",
+                                                        0.0, G_MAXDOUBLE, 0.0,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   g_object_class_install_property (object_class,
                                    PROP_MTYPE,
                                    g_param_spec_enum ("mtype",
@@ -474,6 +559,20 @@ ncm_fit_esmcmc_class_init (NcmFitESMCMCClass *klass)
                                                        "Functions array",
                                                        NCM_TYPE_OBJ_ARRAY,
                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_SHARE_DATA,
+                                   g_param_spec_boolean ("share-data",
+                                                         NULL,
+                                                         "Whether the thread replicas share the immutable data",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_FAST_STEPS,
+                                   g_param_spec_uint ("fast-steps",
+                                                      NULL,
+                                                      "Number of fast steps per walker full step",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 typedef struct _NcmFitESMCMCWorker
@@ -491,6 +590,13 @@ _ncm_fit_esmcmc_worker_dup (gpointer userdata)
   G_LOCK (dup_thread);
   {
     NcmFitESMCMCWorker *fw = g_new (NcmFitESMCMCWorker, 1);
+
+    /* 
+     * The shared objects are named instances in esmcmc->ser, they survive the
+     * autosave reset below and are referenced by every replica.
+     */
+    if (esmcmc->share_data)
+      ncm_dataset_share_immutable (esmcmc->fit->lh->dset, esmcmc->ser);
     
     fw->fit = ncm_fit_dup (esmcmc->fit, esmcmc->ser);
 
@@ -715,7 +821,8 @@ ncm_fit_esmcmc_set_rng (NcmFitESMCMC *esmcmc, NcmRNG *rng)
  * @enable: a boolean
  *
  * If @enable is TRUE turns on the auto-trimming when performing a
- * run_lre.
+ * run_lre. By default the catalog is trimmed after every run, see
+ * ncm_fit_esmcmc_set_auto_trim_doubling().
  *
  */
 void 
@@ -738,6 +845,23 @@ ncm_fit_esmcmc_set_auto_trim_div (NcmFitESMCMC *esmcmc, guint div)
   esmcmc->auto_trim_div = div;
 }
 
+/**
+ * ncm_fit_esmcmc_set_auto_trim_doubling:
+ * @esmcmc: a #NcmFitESMCMC
+ * @enable: a boolean
+ *
+ * If @enable is TRUE the auto-trimming in run_lre is applied only when
+ * the catalog size doubled since the last trimming, so the whole-catalog
+ * tests amount to an amortized constant cost per sample. Between two
+ * trimmings the relative errors are computed with the untrimmed catalog.
+ *
+ */
+void 
+ncm_fit_esmcmc_set_auto_trim_doubling (NcmFitESMCMC *esmcmc, gboolean enable)
+{
+  esmcmc->auto_trim_dbl = enable;
+}
+
 /**
  * ncm_fit_esmcmc_set_min_runs:
  * @esmcmc: a #NcmFitESMCMC
@@ -768,6 +892,64 @@ ncm_fit_esmcmc_set_max_runs_time (NcmFitESMCMC *esmcmc, gdouble max_runs_time)
   esmcmc->max_runs_time = max_runs_time;
 }
 
+/**
+ * ncm_fit_esmcmc_set_max_shrink_factor:
+ * @esmcmc: a #NcmFitESMCMC
+ * @max_shrink: the maximum shrink factor
+ * 
+ * Sets the maximum Gelman-Rubin shrink factor, see
+ * ncm_mset_catalog_get_shrink_factor(). When @max_shrink is positive and
+ * the catalog has more than one chain, run_lre keeps running until the
+ * shrink factor is not larger than @max_shrink. Zero disables the test.
+ *
+ */
+void 
+ncm_fit_esmcmc_set_max_shrink_factor (NcmFitESMCMC *esmcmc, gdouble max_shrink)
+{
+  g_assert_cmpfloat (max_shrink, >=, 0.0);
+  esmcmc->max_shrink = max_shrink;
+}
+
+/**
+ * ncm_fit_esmcmc_set_share_data:
+ * @esmcmc: a #NcmFitESMCMC
+ * @share_data: a boolean
+ * 
+ * Sets whether the thread replicas of the #NcmFit should share the
+ * immutable data, see ncm_data_share_immutable(). In this mode each thread
+ * still has its own #NcmMSet and mutable workspaces, but the data vectors,
+ * constant covariances and loaded tables are not duplicated, reducing the
+ * startup time and the memory footprint. This must be set before the
+ * first threaded evaluation, since the replicas are created on demand and
+ * reused afterwards.
+ *
+ */
+void 
+ncm_fit_esmcmc_set_share_data (NcmFitESMCMC *esmcmc, gboolean share_data)
+{
+  esmcmc->share_data = share_data;
+}
+
+/**
+ * ncm_fit_esmcmc_set_fast_steps:
+ * @esmcmc: a #NcmFitESMCMC
+ * @fast_steps: number of fast steps
+ *
+ * Sets the number of fast steps each walker performs after its full step,
+ * zero disables the fast steps. The fast parameters are determined at
+ * ncm_fit_esmcmc_start_run() from the model costs, see
+ * ncm_mset_fparams_get_fast().
+ *
+ */
+void
+ncm_fit_esmcmc_set_fast_steps (NcmFitESMCMC *esmcmc, guint fast_steps)
+{
+  if (esmcmc->started)
+    g_error ("ncm_fit_esmcmc_set_fast_steps: Cannot change the number of fast steps during a run, call ncm_fit_esmcmc_end_run() first.");
+
+  esmcmc->fast_steps = fast_steps;
+}
+
 /**
  * ncm_fit_esmcmc_has_rng:
  * @esmcmc: a #NcmFitESMCMC
@@ -814,6 +996,143 @@ ncm_fit_esmcmc_get_offboard_ratio (NcmFitESMCMC *esmcmc)
   return offboard_ratio;
 }
 
+/**
+ * ncm_fit_esmcmc_get_fast_accept_ratio:
+ * @esmcmc: a #NcmFitESMCMC
+ *
+ * Gets the acceptance ratio of the fast steps, see
+ * ncm_fit_esmcmc_set_fast_steps(). It is zero when no fast step was done.
+ * 
+ * Returns: the fast steps acceptance ratio.
+ */
+gdouble 
+ncm_fit_esmcmc_get_fast_accept_ratio (NcmFitESMCMC *esmcmc)
+{
+  if (esmcmc->nfast_total == 0)
+    return 0.0;
+  else
+    return esmcmc->nfast_accepted * 1.0 / (esmcmc->nfast_total * 1.0);
+}
+
+/**
+ * ncm_fit_esmcmc_get_core_usage:
+ * @esmcmc: a #NcmFitESMCMC
+ *
+ * Computes the fraction of the available worker time spent evaluating
+ * walkers during the last ensemble iteration of a multithreaded run, i.e.,
+ * the total walker evaluation time divided by the iteration wall time
+ * times the number of workers. The remaining fraction corresponds to the
+ * time the cores spent idle waiting on the half-ensemble barriers.
+ * 
+ * Returns: the core usage of the last iteration (between 0 and 1).
+ */
+gdouble 
+ncm_fit_esmcmc_get_core_usage (NcmFitESMCMC *esmcmc)
+{
+  return esmcmc->core_usage;
+}
+
+/*
+ * Catalog writer thread: during a multithreaded run the catalog appends and
+ * the disk syncs are done by a dedicated thread, so the walkers of the next
+ * half-ensemble are evaluated while the last one is being written. The main
+ * thread sends copies of the rows (recycled through row_pool) and the
+ * messages below through write_queue.
+ */
+static gchar _ncm_fit_esmcmc_writer_msg[3];
+#define NCM_FIT_ESMCMC_WRITER_SYNC  ((gpointer) &_ncm_fit_esmcmc_writer_msg[0])
+#define NCM_FIT_ESMCMC_WRITER_FLUSH ((gpointer) &_ncm_fit_esmcmc_writer_msg[1])
+#define NCM_FIT_ESMCMC_WRITER_STOP  ((gpointer) &_ncm_fit_esmcmc_writer_msg[2])
+
+static gpointer
+_ncm_fit_esmcmc_writer (gpointer data)
+{
+  NcmFitESMCMC *esmcmc = NCM_FIT_ESMCMC (data);
+
+  while (TRUE)
+  {
+    gpointer msg = g_async_queue_pop (esmcmc->write_queue);
+
+    if (msg == NCM_FIT_ESMCMC_WRITER_SYNC)
+    {
+      ncm_mset_catalog_timed_sync (esmcmc->mcat, FALSE);
+    }
+    else if ((msg == NCM_FIT_ESMCMC_WRITER_FLUSH) || (msg == NCM_FIT_ESMCMC_WRITER_STOP))
+    {
+      g_mutex_lock (&esmcmc->write_lock);
+      esmcmc->write_pending = FALSE;
+      g_cond_signal (&esmcmc->write_cond);
+      g_mutex_unlock (&esmcmc->write_lock);
+
+      if (msg == NCM_FIT_ESMCMC_WRITER_STOP)
+        break;
+    }
+    else
+    {
+      NcmVector *row = NCM_VECTOR (msg);
+      ncm_mset_catalog_add_from_vector (esmcmc->mcat, row);
+      g_async_queue_push (esmcmc->row_pool, row);
+    }
+  }
+
+  return NULL;
+}
+
+static void
+_ncm_fit_esmcmc_writer_wait (NcmFitESMCMC *esmcmc, gpointer msg)
+{
+  g_mutex_lock (&esmcmc->write_lock);
+  esmcmc->write_pending = TRUE;
+  g_async_queue_push (esmcmc->write_queue, msg);
+  while (esmcmc->write_pending)
+    g_cond_wait (&esmcmc->write_cond, &esmcmc->write_lock);
+  g_mutex_unlock (&esmcmc->write_lock);
+}
+
+static void
+_ncm_fit_esmcmc_writer_start (NcmFitESMCMC *esmcmc)
+{
+  g_assert (esmcmc->writer == NULL);
+  esmcmc->writer = g_thread_new ("NcmFitESMCMC:writer", &_ncm_fit_esmcmc_writer, esmcmc);
+}
+
+static void
+_ncm_fit_esmcmc_writer_flush (NcmFitESMCMC *esmcmc)
+{
+  if (esmcmc->writer != NULL)
+    _ncm_fit_esmcmc_writer_wait (esmcmc, NCM_FIT_ESMCMC_WRITER_FLUSH);
+}
+
+static void
+_ncm_fit_esmcmc_writer_stop (NcmFitESMCMC *esmcmc)
+{
+  g_assert (esmcmc->writer != NULL);
+  _ncm_fit_esmcmc_writer_wait (esmcmc, NCM_FIT_ESMCMC_WRITER_STOP);
+  g_thread_join (esmcmc->writer);
+  esmcmc->writer = NULL;
+}
+
+static void
+_ncm_fit_esmcmc_add_row (NcmFitESMCMC *esmcmc, NcmVector *full_theta_k)
+{
+  if (esmcmc->writer != NULL)
+  {
+    NcmVector *row = g_async_queue_try_pop (esmcmc->row_pool);
+
+    if ((row != NULL) && (ncm_vector_len (row) != ncm_vector_len (full_theta_k)))
+      ncm_vector_clear (&row);
+
+    if (row == NULL)
+      row = ncm_vector_dup (full_theta_k);
+    else
+      ncm_vector_memcpy (row, full_theta_k);
+
+    g_async_queue_push (esmcmc->write_queue, row);
+  }
+  else
+    ncm_mset_catalog_add_from_vector (esmcmc->mcat, full_theta_k);
+}
+
 void
 _ncm_fit_esmcmc_update (NcmFitESMCMC *esmcmc, guint ki, guint kf)
 {
@@ -828,7 +1147,7 @@ _ncm_fit_esmcmc_update (NcmFitESMCMC *esmcmc, guint ki, guint kf)
   {
     NcmVector *full_theta_k = g_ptr_array_index (esmcmc->full_theta, k);
 
-    ncm_mset_catalog_add_from_vector (esmcmc->mcat, full_theta_k);
+    _ncm_fit_esmcmc_add_row (esmcmc, full_theta_k);
 
     esmcmc->cur_sample_id++;
     ncm_timer_task_increment (esmcmc->nt);
@@ -844,6 +1163,10 @@ _ncm_fit_esmcmc_update (NcmFitESMCMC *esmcmc, guint ki, guint kf)
       esmcmc->noffboard++;
       g_array_index (esmcmc->offboard, gboolean, k) = FALSE;
     }
+
+    esmcmc->nfast_total    += esmcmc->fast_fpi->len > 0 ? esmcmc->fast_steps : 0;
+    esmcmc->nfast_accepted += g_array_index (esmcmc->fast_accepted, guint, k);
+    g_array_index (esmcmc->fast_accepted, guint, k) = 0;
     
   }
 
@@ -863,6 +1186,7 @@ _ncm_fit_esmcmc_update (NcmFitESMCMC *esmcmc, guint ki, guint kf)
     
       if (log_timeout || (stepi == 0) || (esmcmc->nt->task_pos == esmcmc->nt->task_len))
       {
+        _ncm_fit_esmcmc_writer_flush (esmcmc);
         /* guint acc = stepi == 0 ? step : stepi; */
         ncm_mset_catalog_log_current_stats (esmcmc->mcat);
         ncm_mset_catalog_log_current_chain_stats (esmcmc->mcat);
@@ -883,7 +1207,10 @@ _ncm_fit_esmcmc_update (NcmFitESMCMC *esmcmc, guint ki, guint kf)
     {
       if ((esmcmc->cur_sample_id + 1) % esmcmc->nwalkers == 0)
       {
-        NcmVector *e_mean = ncm_mset_catalog_peek_current_e_mean (esmcmc->mcat);
+        NcmVector *e_mean;
+
+        _ncm_fit_esmcmc_writer_flush (esmcmc);
+        e_mean = ncm_mset_catalog_peek_current_e_mean (esmcmc->mcat);
         esmcmc->fit->mtype = esmcmc->mtype;
 
         if (e_mean != NULL)
@@ -967,7 +1294,7 @@ _ncm_fit_esmcmc_gen_init_points (NcmFitESMCMC *esmcmc)
   if (esmcmc->nthreads > 1)
   {
     ncm_mset_catalog_set_sync_mode (esmcmc->mcat, NCM_MSET_CATALOG_SYNC_DISABLE);
-    ncm_func_eval_threaded_loop_full (&_ncm_fit_esmcmc_gen_init_points_mt_eval, esmcmc->cur_sample_id + 1, esmcmc->nwalkers, esmcmc);
+    ncm_func_eval_parallel_for (&_ncm_fit_esmcmc_gen_init_points_mt_eval, esmcmc->cur_sample_id + 1, esmcmc->nwalkers, 1, esmcmc);
   }
   else
   {
@@ -1039,6 +1366,27 @@ ncm_fit_esmcmc_start_run (NcmFitESMCMC *esmcmc)
   esmcmc->noffboard = 0;
   g_mutex_unlock (&esmcmc->update_lock);
 
+  esmcmc->nfast_total    = 0;
+  esmcmc->nfast_accepted = 0;
+  ncm_matrix_clear (&esmcmc->fast_rand);
+  g_array_set_size (esmcmc->fast_fpi, 0);
+
+  if (esmcmc->fast_steps > 0)
+  {
+    ncm_mset_fparams_get_fast (esmcmc->fit->mset, NCM_MSET_FAST_COST_RATIO, esmcmc->fast_fpi);
+    if (esmcmc->fast_fpi->len > 0)
+      esmcmc->fast_rand = ncm_matrix_new (esmcmc->nwalkers, 3 * esmcmc->fast_steps);
+
+    if (esmcmc->mtype > NCM_FIT_RUN_MSGS_NONE)
+    {
+      guint i;
+
+      g_message ("# NcmFitESMCMC: Using %u fast steps per full step, %u fast parameter(s):\n", esmcmc->fast_steps, esmcmc->fast_fpi->len);
+      for (i = 0; i < esmcmc->fast_fpi->len; i++)
+        g_message ("#   - %s\n", ncm_mset_fparam_full_name (esmcmc->fit->mset, g_array_index (esmcmc->fast_fpi, guint, i)));
+    }
+  }
+
   if (mcat_cur_id > esmcmc->cur_sample_id)
   {
     ncm_fit_esmcmc_intern_skip (esmcmc, mcat_cur_id - esmcmc->cur_sample_id);
@@ -1145,6 +1493,7 @@ ncm_fit_esmcmc_reset (NcmFitESMCMC *esmcmc)
   esmcmc->ntotal          = 0;
   esmcmc->naccepted       = 0;
   esmcmc->noffboard       = 0;
+  esmcmc->auto_trim_len   = 0;
   esmcmc->started         = FALSE;  
   ncm_mset_catalog_reset (esmcmc->mcat);
 }
@@ -1235,10 +1584,89 @@ ncm_fit_esmcmc_run (NcmFitESMCMC *esmcmc, guint n)
   ncm_timer_task_pause (esmcmc->nt);
 }
 
+static void
+_ncm_fit_esmcmc_eval_funcs (NcmFitESMCMCWorker *fk, NcmVector *full_thetastar)
+{
+  if (fk->funcs_array != NULL)
+  {
+    guint j;
+    for (j = 0; j < fk->funcs_array->len; j++)
+    {
+      NcmMSetFunc *func = NCM_MSET_FUNC (ncm_obj_array_peek (fk->funcs_array, j));
+      const gdouble a_j = ncm_mset_func_eval0 (func, fk->fit->mset);
+
+      ncm_vector_set (full_thetastar, j + 1, a_j);
+    }
+  }
+}
+
+/*
+ * Fast steps of walker k: stretch moves restricted to the fast parameters
+ * using the walkers of the complementary half, which are not modified while
+ * this half is evaluated. The random numbers are drawn beforehand in
+ * _ncm_fit_esmcmc_get_jumps(). Only the fast parameters are set in the
+ * worker NcmMSet, therefore, the slow models are recomputed only when the
+ * worker was last used with different slow parameters.
+ */
+static void
+_ncm_fit_esmcmc_fast_steps (NcmFitESMCMC *esmcmc, NcmFitESMCMCWorker *fk, guint k)
+{
+  const guint nwalkers_2    = esmcmc->nwalkers / 2;
+  const guint j0            = (k < nwalkers_2) ? nwalkers_2 : 0;
+  const guint nj            = (k < nwalkers_2) ? (esmcmc->nwalkers - nwalkers_2) : nwalkers_2;
+  const guint nfast         = esmcmc->fast_fpi->len;
+  const gdouble a           = NCM_FIT_ESMCMC_FAST_STRETCH;
+  NcmVector *full_theta_k   = g_ptr_array_index (esmcmc->full_theta, k);
+  NcmVector *full_thetastar = g_ptr_array_index (esmcmc->full_thetastar, k);
+  NcmVector *theta_k        = g_ptr_array_index (esmcmc->theta, k);
+  NcmVector *thetastar      = g_ptr_array_index (esmcmc->thetastar, k);
+  gdouble *m2lnL_cur        = ncm_vector_ptr (full_theta_k, NCM_FIT_ESMCMC_M2LNL_ID);
+  gdouble *m2lnL_star       = ncm_vector_ptr (full_thetastar, NCM_FIT_ESMCMC_M2LNL_ID);
+  guint s, i;
+
+  for (s = 0; s < esmcmc->fast_steps; s++)
+  {
+    const gdouble u_z  = ncm_matrix_get (esmcmc->fast_rand, k, 3 * s + 0);
+    const guint j      = j0 + GSL_MIN ((guint) (ncm_matrix_get (esmcmc->fast_rand, k, 3 * s + 1) * nj), nj - 1);
+    const gdouble jump = ncm_matrix_get (esmcmc->fast_rand, k, 3 * s + 2);
+    const gdouble z    = gsl_pow_2 ((a - 1.0) * u_z + 1.0) / a;
+    NcmVector *theta_j = g_ptr_array_index (esmcmc->theta, j);
+    gdouble prob       = 0.0;
+
+    ncm_vector_memcpy (thetastar, theta_k);
+    for (i = 0; i < nfast; i++)
+    {
+      const guint fpi         = g_array_index (esmcmc->fast_fpi, guint, i);
+      const gdouble theta_j_i = ncm_vector_get (theta_j, fpi);
+
+      ncm_vector_set (thetastar, fpi, theta_j_i + z * (ncm_vector_get (theta_k, fpi) - theta_j_i));
+    }
+
+    if (ncm_mset_fparam_valid_bounds (fk->fit->mset, thetastar))
+    {
+      ncm_mset_fparams_update_vector (fk->fit->mset, thetastar);
+      ncm_fit_m2lnL_val (fk->fit, m2lnL_star);
+
+      if (gsl_finite (m2lnL_star[0]))
+        prob = GSL_MIN (exp ((nfast - 1.0) * log (z) + 0.5 * (m2lnL_cur[0] - m2lnL_star[0])), 1.0);
+    }
+
+    if (jump < prob)
+    {
+      _ncm_fit_esmcmc_eval_funcs (fk, full_thetastar);
+
+      ncm_vector_memcpy (full_theta_k, full_thetastar);
+      g_array_index (esmcmc->fast_accepted, guint, k)++;
+    }
+  }
+}
+
 static void 
 _ncm_fit_esmcmc_mt_eval (glong i, glong f, gpointer data)
 {
+  G_LOCK_DEFINE_STATIC (busy_lock);
   NcmFitESMCMC *esmcmc        = NCM_FIT_ESMCMC (data);
+  const gint64 t0             = g_get_monotonic_time ();
   NcmFitESMCMCWorker **fk_ptr = ncm_memory_pool_get (esmcmc->walker_pool);
   NcmFit *fit_k               = fk_ptr[0]->fit;
   guint k = i;
@@ -1274,25 +1702,23 @@ _ncm_fit_esmcmc_mt_eval (glong i, glong f, gpointer data)
     
     if (jump < prob)
     {
-      if (fk_ptr[0]->funcs_array != NULL)
-      {
-        guint j;
-        for (j = 0; j < fk_ptr[0]->funcs_array->len; j++)
-        {
-          NcmMSetFunc *func = NCM_MSET_FUNC (ncm_obj_array_peek (fk_ptr[0]->funcs_array, j));
-          const gdouble a_j = ncm_mset_func_eval0 (func, fit_k->mset);
-
-          ncm_vector_set (full_thetastar, j + 1, a_j);
-        }
-      }
+      _ncm_fit_esmcmc_eval_funcs (fk_ptr[0], full_thetastar);
 
       ncm_vector_memcpy (full_theta_k, full_thetastar);
       g_array_index (esmcmc->accepted, gboolean, k) = TRUE;
     }
+
+    if (esmcmc->fast_rand != NULL)
+      _ncm_fit_esmcmc_fast_steps (esmcmc, fk_ptr[0], k);
+
     k++;
   }
 
   ncm_memory_pool_return (fk_ptr);
+
+  G_LOCK (busy_lock);
+  esmcmc->busy_time += g_get_monotonic_time () - t0;
+  G_UNLOCK (busy_lock);
 }
 
 static void
@@ -1306,59 +1732,91 @@ _ncm_fit_esmcmc_get_jumps (NcmFitESMCMC *esmcmc, guint ki, guint kf)
     const gdouble jump = gsl_rng_uniform (rng->r);; 
     ncm_vector_set (esmcmc->jumps, k, jump);
   }
+
+  if (esmcmc->fast_rand != NULL)
+  {
+    const guint nrand = ncm_matrix_ncols (esmcmc->fast_rand);
+    guint j;
+
+    for (k = ki; k < kf; k++)
+    {
+      for (j = 0; j < nrand; j++)
+        ncm_matrix_set (esmcmc->fast_rand, k, j, gsl_rng_uniform (rng->r));
+    }
+  }
 }
 
 
+/*
+ * One multithreaded ensemble iteration starting at walker ki. As soon as the
+ * first half is final its rows are sent to the writer thread and the second
+ * half (whose proposals depend only on the first half) starts, the catalog
+ * append and the timed sync are then done concurrently with the walkers
+ * evaluation.
+ */
+static void
+_ncm_fit_esmcmc_mt_iteration (NcmFitESMCMC *esmcmc, guint ki)
+{
+  const guint nwalkers_2 = esmcmc->nwalkers / 2;
+  const gint64 t0        = g_get_monotonic_time ();
+  NcmRNG *rng            = ncm_mset_catalog_peek_rng (esmcmc->mcat);
+
+  esmcmc->busy_time = 0;
+
+  _ncm_fit_esmcmc_get_jumps (esmcmc, ki, esmcmc->nwalkers);
+  ncm_fit_esmcmc_walker_setup (esmcmc->walker, esmcmc->theta, ki, esmcmc->nwalkers, rng);
+
+  if (ki < nwalkers_2)
+  {
+    ncm_func_eval_parallel_for (&_ncm_fit_esmcmc_mt_eval, ki, nwalkers_2, 1, esmcmc);
+    _ncm_fit_esmcmc_update (esmcmc, ki, nwalkers_2);
+
+    ncm_func_eval_parallel_for (&_ncm_fit_esmcmc_mt_eval, nwalkers_2, esmcmc->nwalkers, 1, esmcmc);
+    ncm_fit_esmcmc_walker_clean (esmcmc->walker, ki, esmcmc->nwalkers);
+    _ncm_fit_esmcmc_update (esmcmc, nwalkers_2, esmcmc->nwalkers);
+  }
+  else
+  {
+    ncm_func_eval_parallel_for (&_ncm_fit_esmcmc_mt_eval, ki, esmcmc->nwalkers, 1, esmcmc);
+    ncm_fit_esmcmc_walker_clean (esmcmc->walker, ki, esmcmc->nwalkers);
+    _ncm_fit_esmcmc_update (esmcmc, ki, esmcmc->nwalkers);
+  }
+
+  g_async_queue_push (esmcmc->write_queue, NCM_FIT_ESMCMC_WRITER_SYNC);
+
+  {
+    const gint64 wall = g_get_monotonic_time () - t0;
+    const guint nw    = GSL_MAX (GSL_MIN (ncm_func_eval_get_nworkers (), nwalkers_2), 1);
+    esmcmc->core_usage = (wall > 0) ? (esmcmc->busy_time * 1.0) / (wall * 1.0 * nw) : 0.0;
+  }
+}
+
 static void
 _ncm_fit_esmcmc_run (NcmFitESMCMC *esmcmc)
 {
-  NcmRNG *rng      = ncm_mset_catalog_peek_rng (esmcmc->mcat);
   gboolean mthread = (esmcmc->nthreads > 1);
   guint i;
 
   if (mthread)
   {
-    const guint nwalkers_2 = esmcmc->nwalkers / 2;
     guint ki = (esmcmc->cur_sample_id + 1) % esmcmc->nwalkers;
 
     ncm_mset_catalog_set_sync_mode (esmcmc->mcat, NCM_MSET_CATALOG_SYNC_DISABLE);
     if (esmcmc->n > 0)
     {
-      _ncm_fit_esmcmc_get_jumps (esmcmc, ki, esmcmc->nwalkers);
-      ncm_fit_esmcmc_walker_setup (esmcmc->walker, esmcmc->theta, ki, esmcmc->nwalkers, rng);
-      
-      if (ki < nwalkers_2)
-      {
-        ncm_func_eval_threaded_loop_full (&_ncm_fit_esmcmc_mt_eval, ki, nwalkers_2, esmcmc);
-        ncm_func_eval_threaded_loop_full (&_ncm_fit_esmcmc_mt_eval, nwalkers_2, esmcmc->nwalkers, esmcmc);
-      }
-      else
-      {
-        ncm_func_eval_threaded_loop_full (&_ncm_fit_esmcmc_mt_eval, ki, esmcmc->nwalkers, esmcmc);
-      }
+      _ncm_fit_esmcmc_writer_start (esmcmc);
 
-      ncm_fit_esmcmc_walker_clean (esmcmc->walker, ki, esmcmc->nwalkers);
-
-      _ncm_fit_esmcmc_update (esmcmc, ki, esmcmc->nwalkers);
-      ncm_mset_catalog_timed_sync (esmcmc->mcat, FALSE);
+      _ncm_fit_esmcmc_mt_iteration (esmcmc, ki);
 
       for (i = 1; i < esmcmc->n; i++)
-      {
-        _ncm_fit_esmcmc_get_jumps (esmcmc, 0, esmcmc->nwalkers);
-        ncm_fit_esmcmc_walker_setup (esmcmc->walker, esmcmc->theta, 0, esmcmc->nwalkers, rng);
-        
-        ncm_func_eval_threaded_loop_full (&_ncm_fit_esmcmc_mt_eval, 0, nwalkers_2, esmcmc);
-        ncm_func_eval_threaded_loop_full (&_ncm_fit_esmcmc_mt_eval, nwalkers_2, esmcmc->nwalkers, esmcmc);
-
-        ncm_fit_esmcmc_walker_clean (esmcmc->walker, 0, esmcmc->nwalkers);
+        _ncm_fit_esmcmc_mt_iteration (esmcmc, 0);
 
-        _ncm_fit_esmcmc_update (esmcmc, 0, esmcmc->nwalkers);
-        ncm_mset_catalog_timed_sync (esmcmc->mcat, FALSE);
-      }
+      _ncm_fit_esmcmc_writer_stop (esmcmc);
     }
   }
   else
   {
+    NcmRNG *rng            = ncm_mset_catalog_peek_rng (esmcmc->mcat);
     const guint nwalkers_2 = esmcmc->nwalkers / 2;
     guint ki = (esmcmc->cur_sample_id + 1) % esmcmc->nwalkers;
 
@@ -1400,6 +1858,20 @@ _ncm_fit_esmcmc_run (NcmFitESMCMC *esmcmc)
   }
 }
 
+static gboolean
+_ncm_fit_esmcmc_shrink_attained (NcmFitESMCMC *esmcmc, gdouble *shrink)
+{
+  if ((esmcmc->max_shrink == 0.0) || (ncm_mset_catalog_nchains (esmcmc->mcat) == 1))
+  {
+    shrink[0] = 1.0;
+    return TRUE;
+  }
+
+  shrink[0] = ncm_mset_catalog_get_shrink_factor (esmcmc->mcat);
+
+  return (shrink[0] <= esmcmc->max_shrink);
+}
+
 /**
  * ncm_fit_esmcmc_run_lre:
  * @esmcmc: a #NcmFitESMCMC
@@ -1407,12 +1879,15 @@ _ncm_fit_esmcmc_run (NcmFitESMCMC *esmcmc)
  * @lre: FIXME
  *
  * FIXME
+ *
+ * If a maximum shrink factor was set, see ncm_fit_esmcmc_set_max_shrink_factor(),
+ * the runs also continue while the Gelman-Rubin shrink factor is larger than it.
  * 
  */
 void 
 ncm_fit_esmcmc_run_lre (NcmFitESMCMC *esmcmc, guint prerun, gdouble lre)
 {
-  gdouble lerror;
+  gdouble lerror, shrink;
   const gdouble lre2 = lre * lre;
   const guint catlen = ncm_mset_catalog_len (esmcmc->mcat) / esmcmc->nwalkers;
 
@@ -1431,11 +1906,11 @@ ncm_fit_esmcmc_run_lre (NcmFitESMCMC *esmcmc, guint prerun, gdouble lre)
   ncm_mset_catalog_estimate_autocorrelation_tau (esmcmc->mcat, FALSE);
   lerror = ncm_mset_catalog_largest_error (esmcmc->mcat);
 
-  while (lerror > lre)
+  while (!_ncm_fit_esmcmc_shrink_attained (esmcmc, &shrink) || (lerror > lre))
   {
     const gdouble lerror2 = lerror * lerror;
     gdouble n             = ncm_mset_catalog_len (esmcmc->mcat);
-    gdouble m             = n * lerror2 / lre2;
+    gdouble m             = GSL_MAX (n * lerror2 / lre2, n);
     guint runs            = ((m - n) > 1000.0) ? ceil ((m - n) * 1.0e-1) : ceil (m - n);
     guint ti              = (esmcmc->cur_sample_id + 1) / esmcmc->nwalkers;
 
@@ -1444,14 +1919,18 @@ ncm_fit_esmcmc_run_lre (NcmFitESMCMC *esmcmc, guint prerun, gdouble lre)
     
     if (esmcmc->mtype >= NCM_FIT_RUN_MSGS_SIMPLE)
     {
-      g_message ("# NcmFitESMCMC: Largest relative error %e not attained: %e\n", lre, lerror);
+      if (lerror > lre)
+        g_message ("# NcmFitESMCMC: Largest relative error %e not attained: %e\n", lre, lerror);
+      else
+        g_message ("# NcmFitESMCMC: Shrink factor %e not attained: %e\n", esmcmc->max_shrink, shrink);
       g_message ("# NcmFitESMCMC: Running more %u runs...\n", runs);
     }
 
     ncm_fit_esmcmc_run (esmcmc, ti + runs);
-    if (esmcmc->auto_trim)
+    if (esmcmc->auto_trim && (!esmcmc->auto_trim_dbl || (ncm_mset_catalog_len (esmcmc->mcat) >= 2 * esmcmc->auto_trim_len)))
     {
       ncm_mset_catalog_trim_by_type (esmcmc->mcat, esmcmc->auto_trim_div, esmcmc->trim_type, esmcmc->mtype);
+      esmcmc->auto_trim_len = ncm_mset_catalog_len (esmcmc->mcat);
     }
 
     ncm_mset_catalog_estimate_autocorrelation_tau (esmcmc->mcat, FALSE);
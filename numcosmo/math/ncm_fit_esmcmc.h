@@ -72,9 +72,12 @@ struct _NcmFitESMCMC
   NcmFitESMCMCWalker *walker;
   gboolean auto_trim;
   guint auto_trim_div;
+  guint auto_trim_len;
+  gboolean auto_trim_dbl;
   NcmMSetCatalogTrimType trim_type;
   guint min_runs;
   gdouble max_runs_time;
+  gdouble max_shrink;
   GPtrArray *full_theta;
   GPtrArray *full_thetastar;
   GPtrArray *theta;
@@ -82,6 +85,12 @@ struct _NcmFitESMCMC
   NcmVector *jumps;
   GArray *accepted;
   GArray *offboard;
+  guint fast_steps;
+  GArray *fast_fpi;
+  NcmMatrix *fast_rand;
+  GArray *fast_accepted;
+  guint nfast_total;
+  guint nfast_accepted;
   NcmObjArray *funcs_oa;
   gchar *funcs_oa_file;
   guint nadd_vals;
@@ -94,9 +103,17 @@ struct _NcmFitESMCMC
   guint naccepted;
   guint noffboard;
   gboolean started;
+  gboolean share_data;
+  GThread *writer;
+  GAsyncQueue *write_queue;
+  GAsyncQueue *row_pool;
+  gboolean write_pending;
+  gint64 busy_time;
+  gdouble core_usage;
   GMutex dup_fit;
   GMutex resample_lock;
   GMutex update_lock;
+  GMutex write_lock;
   GCond write_cond;
 };
 
@@ -116,13 +133,19 @@ void ncm_fit_esmcmc_set_nthreads (NcmFitESMCMC *esmcmc, guint nthreads);
 void ncm_fit_esmcmc_set_rng (NcmFitESMCMC *esmcmc, NcmRNG *rng);
 void ncm_fit_esmcmc_set_auto_trim (NcmFitESMCMC *esmcmc, gboolean enable);
 void ncm_fit_esmcmc_set_auto_trim_div (NcmFitESMCMC *esmcmc, guint div);
+void ncm_fit_esmcmc_set_auto_trim_doubling (NcmFitESMCMC *esmcmc, gboolean enable);
 void ncm_fit_esmcmc_set_min_runs (NcmFitESMCMC *esmcmc, guint min_runs);
 void ncm_fit_esmcmc_set_max_runs_time (NcmFitESMCMC *esmcmc, gdouble max_runs_time);
+void ncm_fit_esmcmc_set_max_shrink_factor (NcmFitESMCMC *esmcmc, gdouble max_shrink);
+void ncm_fit_esmcmc_set_share_data (NcmFitESMCMC *esmcmc, gboolean share_data);
+void ncm_fit_esmcmc_set_fast_steps (NcmFitESMCMC *esmcmc, guint fast_steps);
 
 gboolean ncm_fit_esmcmc_has_rng (NcmFitESMCMC *esmcmc);
 
 gdouble ncm_fit_esmcmc_get_accept_ratio (NcmFitESMCMC *esmcmc);
 gdouble ncm_fit_esmcmc_get_offboard_ratio (NcmFitESMCMC *esmcmc);
+gdouble ncm_fit_esmcmc_get_fast_accept_ratio (NcmFitESMCMC *esmcmc);
+gdouble ncm_fit_esmcmc_get_core_usage (NcmFitESMCMC *esmcmc);
 
 void ncm_fit_esmcmc_start_run (NcmFitESMCMC *esmcmc);
 void ncm_fit_esmcmc_end_run (NcmFitESMCMC *esmcmc);
@@ -138,6 +161,7 @@ gboolean ncm_fit_esmcmc_validate (NcmFitESMCMC *esmcmc, gulong pi, gulong pf);
 
 #define NCM_FIT_ESMCMC_MIN_SYNC_INTERVAL (10.0)
 #define NCM_FIT_ESMCMC_M2LNL_ID (0)
+#define NCM_FIT_ESMCMC_FAST_STRETCH (2.0)
 
 G_END_DECLS
 
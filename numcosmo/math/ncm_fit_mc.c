@@ -866,9 +866,9 @@ _ncm_fit_mc_run_mt (NcmFitMC *mc)
   g_assert_cmpuint (mc->nthreads, >, 1);
 
   if (mc->keep_order)
-    ncm_func_eval_threaded_loop_full (&_ncm_fit_mc_mt_eval_keep_order, 0, mc->n, mc);
+    ncm_func_eval_parallel_for (&_ncm_fit_mc_mt_eval_keep_order, 0, mc->n, 1, mc);
   else
-    ncm_func_eval_threaded_loop_full (&_ncm_fit_mc_mt_eval, 0, mc->n, mc);  
+    ncm_func_eval_parallel_for (&_ncm_fit_mc_mt_eval, 0, mc->n, 1, mc);  
 }
 
 /**
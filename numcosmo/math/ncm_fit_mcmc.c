@@ -31,6 +31,16 @@
  * FIXME 
  * 
  * Metropolis–Hastings sampler.
+ *
+ * When the likelihood has parameters whose models are much cheaper to
+ * recompute than the others (e.g. nuisance parameters), the sampler can
+ * perform several fast steps after each full step, see
+ * ncm_fit_mcmc_set_fast_steps(). The fast parameters are those whose model
+ * cost, see ncm_mset_set_model_cost() and ncm_fit_measure_model_costs(), is
+ * at most #NCM_MSET_FAST_COST_RATIO times the largest cost. A fast step
+ * proposes a new point using the same transition kernel but moves only the
+ * fast parameters. The catalog receives one row per full step, i.e., after
+ * its fast steps.
  * 
  */
 
@@ -54,6 +64,7 @@ enum
   PROP_MTYPE,
   PROP_NTHREADS,
   PROP_DATA_FILE,
+  PROP_FAST_STEPS,
 };
 
 G_DEFINE_TYPE (NcmFitMCMC, ncm_fit_mcmc, G_TYPE_OBJECT);
@@ -68,6 +79,11 @@ ncm_fit_mcmc_init (NcmFitMCMC *mcmc)
   mcmc->ser             = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
   mcmc->theta           = NULL;
   mcmc->thetastar       = NULL;
+  mcmc->thetafast       = NULL;
+  mcmc->fast_fpi        = g_array_new (FALSE, FALSE, sizeof (guint));
+  mcmc->fast_steps      = 0;
+  mcmc->nfast_accepted  = 0;
+  mcmc->nfast_total     = 0;
   mcmc->nthreads        = 0;
   mcmc->n               = 0;
   mcmc->mp              = NULL;
@@ -108,6 +124,9 @@ ncm_fit_mcmc_set_property (GObject *object, guint prop_id, const GValue *value,
     case PROP_DATA_FILE:
       ncm_fit_mcmc_set_data_file (mcmc, g_value_get_string (value));
       break;    
+    case PROP_FAST_STEPS:
+      ncm_fit_mcmc_set_fast_steps (mcmc, g_value_get_uint (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -137,6 +156,9 @@ ncm_fit_mcmc_get_property (GObject *object, guint prop_id, GValue *value, GParam
     case PROP_DATA_FILE:
       g_value_set_string (value, ncm_mset_catalog_peek_filename (mcmc->mcat));
       break;
+    case PROP_FAST_STEPS:
+      g_value_set_uint (value, mcmc->fast_steps);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -155,6 +177,7 @@ ncm_fit_mcmc_dispose (GObject *object)
   ncm_mset_catalog_clear (&mcmc->mcat);
   ncm_vector_clear (&mcmc->theta);
   ncm_vector_clear (&mcmc->thetastar);
+  ncm_vector_clear (&mcmc->thetafast);
 
   if (mcmc->mp != NULL)
   {
@@ -175,6 +198,7 @@ ncm_fit_mcmc_finalize (GObject *object)
   g_mutex_clear (&mcmc->resample_lock);
   g_mutex_clear (&mcmc->update_lock);
   g_cond_clear (&mcmc->write_cond);
+  g_array_unref (mcmc->fast_fpi);
   
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_fit_mcmc_parent_class)->finalize (object);
@@ -219,6 +243,13 @@ ncm_fit_mcmc_class_init (NcmFitMCMCClass *klass)
                                                       "Number of threads to run",
                                                       0, 100, 0,
                                                       G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_FAST_STEPS,
+                                   g_param_spec_uint ("fast-steps",
+                                                      NULL,
+                                                      "Number of fast steps per full step",
+                                                      0, G_MAXUINT, 0,
+                                                      G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 static void 
@@ -351,6 +382,26 @@ ncm_fit_mcmc_set_nthreads (NcmFitMCMC *mcmc, guint nthreads)
   mcmc->nthreads = nthreads;
 }
 
+/**
+ * ncm_fit_mcmc_set_fast_steps:
+ * @mcmc: a #NcmFitMCMC
+ * @fast_steps: number of fast steps
+ *
+ * Sets the number of fast steps performed after each full step, zero
+ * disables the fast steps. The fast parameters are determined at
+ * ncm_fit_mcmc_start_run() from the model costs, see
+ * ncm_mset_fparams_get_fast().
+ *
+ */
+void
+ncm_fit_mcmc_set_fast_steps (NcmFitMCMC *mcmc, guint fast_steps)
+{
+  if (mcmc->started)
+    g_error ("ncm_fit_mcmc_set_fast_steps: Cannot change the number of fast steps during a run, call ncm_fit_mcmc_end_run() first.");
+
+  mcmc->fast_steps = fast_steps;
+}
+
 /**
  * ncm_fit_mcmc_set_rng:
  * @mcmc: a #NcmFitMCMC
@@ -382,6 +433,24 @@ ncm_fit_mcmc_get_accept_ratio (NcmFitMCMC *mcmc)
   return mcmc->naccepted * 1.0 / (mcmc->ntotal * 1.0);
 }
 
+/**
+ * ncm_fit_mcmc_get_fast_accept_ratio:
+ * @mcmc: a #NcmFitMCMC
+ *
+ * Gets the acceptance ratio of the fast steps, see
+ * ncm_fit_mcmc_set_fast_steps(). It is zero when no fast step was done.
+ *
+ * Returns: the fast steps acceptance ratio.
+ */
+gdouble
+ncm_fit_mcmc_get_fast_accept_ratio (NcmFitMCMC *mcmc)
+{
+  if (mcmc->nfast_total == 0)
+    return 0.0;
+  else
+    return mcmc->nfast_accepted * 1.0 / (mcmc->nfast_total * 1.0);
+}
+
 void
 _ncm_fit_mcmc_update (NcmFitMCMC *mcmc, NcmFit *fit)
 {
@@ -490,6 +559,26 @@ ncm_fit_mcmc_start_run (NcmFitMCMC *mcmc)
 
   mcmc->naccepted = 0;
   mcmc->ntotal = 0;
+  mcmc->nfast_accepted = 0;
+  mcmc->nfast_total = 0;
+
+  g_array_set_size (mcmc->fast_fpi, 0);
+  if (mcmc->fast_steps > 0)
+  {
+    ncm_vector_clear (&mcmc->thetafast);
+    mcmc->thetafast = ncm_vector_new (ncm_mset_fparam_len (mcmc->fit->mset));
+
+    ncm_mset_fparams_get_fast (mcmc->fit->mset, NCM_MSET_FAST_COST_RATIO, mcmc->fast_fpi);
+
+    if (mcmc->mtype > NCM_FIT_RUN_MSGS_NONE)
+    {
+      guint i;
+
+      g_message ("# NcmFitMCMC: Using %u fast steps per full step, %u fast parameter(s):\n", mcmc->fast_steps, mcmc->fast_fpi->len);
+      for (i = 0; i < mcmc->fast_fpi->len; i++)
+        g_message ("#   - %s\n", ncm_mset_fparam_full_name (mcmc->fit->mset, g_array_index (mcmc->fast_fpi, guint, i)));
+    }
+  }
   
   ncm_mset_catalog_set_sync_mode (mcmc->mcat, NCM_MSET_CATALOG_SYNC_TIMED);
   ncm_mset_catalog_set_sync_interval (mcmc->mcat, NCM_FIT_MCMC_MIN_SYNC_INTERVAL);
@@ -676,9 +765,52 @@ ncm_fit_mcmc_run (NcmFitMCMC *mcmc, guint n)
   ncm_timer_task_pause (mcmc->nt);
 }
 
+/*
+ * Fast steps: the proposal is generated by the transition kernel as in the
+ * full steps, but only its fast components are used. Since only the fast
+ * parameters are set, the slow models keep their pkeys and are not
+ * recomputed.
+ */
+static void
+_ncm_fit_mcmc_fast_steps (NcmFitMCMC *mcmc)
+{
+  guint i, j;
+
+  for (i = 0; i < mcmc->fast_steps; i++)
+  {
+    gdouble m2lnL_cur = ncm_fit_state_get_m2lnL_curval (mcmc->fit->fstate);
+    gdouble m2lnL_star, prob;
+
+    ncm_mset_fparams_get_vector (mcmc->fit->mset, mcmc->theta);
+    ncm_mset_trans_kern_generate (mcmc->tkern, mcmc->theta, mcmc->thetastar, mcmc->mcat->rng);
+
+    ncm_vector_memcpy (mcmc->thetafast, mcmc->theta);
+    for (j = 0; j < mcmc->fast_fpi->len; j++)
+    {
+      const guint fpi = g_array_index (mcmc->fast_fpi, guint, j);
+      ncm_vector_set (mcmc->thetafast, fpi, ncm_vector_get (mcmc->thetastar, fpi));
+    }
+
+    ncm_mset_fparams_update_vector (mcmc->fit->mset, mcmc->thetafast);
+    ncm_fit_m2lnL_val (mcmc->fit, &m2lnL_star);
+    mcmc->nfast_total++;
+
+    prob = GSL_MIN (exp ((m2lnL_cur - m2lnL_star) * 0.5), 1.0);
+
+    if ((prob == 1.0) || (gsl_rng_uniform (mcmc->mcat->rng->r) <= prob))
+    {
+      ncm_fit_state_set_m2lnL_curval (mcmc->fit->fstate, m2lnL_star);
+      mcmc->nfast_accepted++;
+    }
+    else
+      ncm_mset_fparams_update_vector (mcmc->fit->mset, mcmc->theta);
+  }
+}
+
 static void 
 _ncm_fit_mcmc_run_single (NcmFitMCMC *mcmc)
 {
+  const gboolean has_fast = (mcmc->fast_fpi->len > 0);
   guint i = 0;
   
   for (i = 0; i < mcmc->n; i++)
@@ -712,6 +844,9 @@ _ncm_fit_mcmc_run_single (NcmFitMCMC *mcmc)
         mcmc->naccepted--;
       }
     }
+
+    if (has_fast)
+      _ncm_fit_mcmc_fast_steps (mcmc);
     
     _ncm_fit_mcmc_update (mcmc, mcmc->fit);
     mcmc->write_index++;
@@ -793,7 +928,7 @@ _ncm_fit_mcmc_run_mt (NcmFitMCMC *mcmc)
 
   g_assert_cmpuint (mcmc->nthreads, >, 1);
 
-  ncm_func_eval_threaded_loop_full (&_ncm_fit_mcmc_mt_eval, 0, mcmc->n, mcmc);  
+  ncm_func_eval_parallel_for (&_ncm_fit_mcmc_mt_eval, 0, mcmc->n, 1, mcmc);  
 }
 
 /**
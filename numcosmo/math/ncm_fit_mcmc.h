@@ -69,6 +69,11 @@ struct _NcmFitMCMC
   NcmMSetTransKern *tkern;
   NcmVector *theta;
   NcmVector *thetastar;
+  NcmVector *thetafast;
+  GArray *fast_fpi;
+  guint fast_steps;
+  guint nfast_accepted;
+  guint nfast_total;
   guint nthreads;
   guint n;
   NcmMemoryPool *mp;
@@ -96,8 +101,10 @@ void ncm_fit_mcmc_set_trans_kern (NcmFitMCMC *mcmc, NcmMSetTransKern *tkern);
 void ncm_fit_mcmc_set_nthreads (NcmFitMCMC *mcmc, guint nthreads);
 void ncm_fit_mcmc_set_fiducial (NcmFitMCMC *mcmc, NcmMSet *fiduc);
 void ncm_fit_mcmc_set_rng (NcmFitMCMC *mcmc, NcmRNG *rng);
+void ncm_fit_mcmc_set_fast_steps (NcmFitMCMC *mcmc, guint fast_steps);
 
 gdouble ncm_fit_mcmc_get_accept_ratio (NcmFitMCMC *mcmc);
+gdouble ncm_fit_mcmc_get_fast_accept_ratio (NcmFitMCMC *mcmc);
 
 void ncm_fit_mcmc_start_run (NcmFitMCMC *mcmc);
 void ncm_fit_mcmc_end_run (NcmFitMCMC *mcmc);
@@ -27,7 +27,20 @@
  * @title: NcmFuncEval
  * @short_description: A general purpose multi-threaded function evaluator.
  *
- * FIXME
+ * This module evaluates loops in parallel using a global #GThreadPool. The
+ * main entry point is ncm_func_eval_parallel_for(), it divides the index range
+ * among the pool workers (the calling thread included). Each worker consumes
+ * its own range in adaptively sized chunks, never smaller than the grain size
+ * hint, and when its range is exhausted it steals half of the remaining work
+ * of another worker. Only one task per worker is pushed to the pool and the
+ * completion is tracked by an atomic counter, therefore, the scheduling cost
+ * does not grow with the number of indexes.
+ *
+ * Since the calling thread also consumes work, nested calls (e.g., a
+ * likelihood evaluated inside a threaded loop that itself calls
+ * ncm_func_eval_parallel_for()) always progress even when all pool threads
+ * are busy.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -39,45 +52,222 @@
 #include "math/ncm_cfg.h"
 #include "math/ncm_util.h"
 #include <stdio.h>
+#include <gsl/gsl_math.h>
 
-typedef struct _NcmFuncEvalCtrl
+typedef struct _NcmFuncEvalRange
 {
-  gint active_threads;
-  GMutex update;
-  GCond finish;
-} NcmFuncEvalCtrl;
+  GMutex lock;
+  glong begin;
+  glong end;
+} NcmFuncEvalRange;
 
-typedef struct _NcmFuncEvalLoopEval
+typedef struct _NcmFuncEvalPFor
 {
   NcmFuncEvalLoop lfunc;
-  glong i;
-  glong f;
   gpointer data;
-  NcmFuncEvalCtrl *ctrl;
-} NcmFuncEvalLoopEval;
+  glong grain;
+  guint nworkers;
+  gint next_slot;
+  volatile gssize remaining;
+  gint ref_count;
+  NcmFuncEvalRange *ranges;
+  GMutex done_lock;
+  GCond done_cond;
+} NcmFuncEvalPFor;
+
+/*
+ * At each step the owner of a range consumes 1/NCM_FUNC_EVAL_CHUNK_DIV of it
+ * (at least grain indexes). The automatic grain gives at least
+ * NCM_FUNC_EVAL_AUTO_GRAIN_DIV chunks per worker.
+ */
+#define NCM_FUNC_EVAL_CHUNK_DIV (4)
+#define NCM_FUNC_EVAL_AUTO_GRAIN_DIV (32)
 
 static GThreadPool *_function_thread_pool = NULL;
 
+static NcmFuncEvalPFor *
+_ncm_func_eval_pfor_new (NcmFuncEvalLoop lfunc, glong i, glong f, glong grain, gpointer data, guint nworkers)
+{
+  NcmFuncEvalPFor *pfor = g_slice_new (NcmFuncEvalPFor);
+  const glong n         = f - i;
+  const glong delta     = n / nworkers;
+  const glong res       = n % nworkers;
+  glong li              = i;
+  guint w;
+
+  pfor->lfunc     = lfunc;
+  pfor->data      = data;
+  pfor->grain     = grain;
+  pfor->nworkers  = nworkers;
+  pfor->next_slot = 0;
+  pfor->remaining = n;
+  pfor->ref_count = 1;
+  pfor->ranges    = g_new (NcmFuncEvalRange, nworkers);
+
+  g_mutex_init (&pfor->done_lock);
+  g_cond_init (&pfor->done_cond);
+
+  for (w = 0; w < nworkers; w++)
+  {
+    const glong lf = li + delta + ((w < res) ? 1 : 0);
+    g_mutex_init (&pfor->ranges[w].lock);
+    pfor->ranges[w].begin = li;
+    pfor->ranges[w].end   = lf;
+    li = lf;
+  }
+
+  return pfor;
+}
+
+static void
+_ncm_func_eval_pfor_unref (NcmFuncEvalPFor *pfor)
+{
+  if (g_atomic_int_dec_and_test (&pfor->ref_count))
+  {
+    guint w;
+    for (w = 0; w < pfor->nworkers; w++)
+      g_mutex_clear (&pfor->ranges[w].lock);
+    g_free (pfor->ranges);
+    g_mutex_clear (&pfor->done_lock);
+    g_cond_clear (&pfor->done_cond);
+    g_slice_free (NcmFuncEvalPFor, pfor);
+  }
+}
+
+static gboolean
+_ncm_func_eval_pfor_pop (NcmFuncEvalPFor *pfor, guint slot, glong *li, glong *lf)
+{
+  NcmFuncEvalRange *r = &pfor->ranges[slot];
+  gboolean found      = FALSE;
+
+  g_mutex_lock (&r->lock);
+  {
+    const glong len = r->end - r->begin;
+    if (len > 0)
+    {
+      const glong chunk = GSL_MIN (GSL_MAX (pfor->grain, len / NCM_FUNC_EVAL_CHUNK_DIV), len);
+      *li       = r->begin;
+      *lf       = r->begin + chunk;
+      r->begin  = *lf;
+      found     = TRUE;
+    }
+  }
+  g_mutex_unlock (&r->lock);
+
+  return found;
+}
+
+static gboolean
+_ncm_func_eval_pfor_steal (NcmFuncEvalPFor *pfor, guint slot)
+{
+  guint k;
+
+  for (k = 1; k < pfor->nworkers; k++)
+  {
+    NcmFuncEvalRange *v = &pfor->ranges[(slot + k) % pfor->nworkers];
+    glong sb = 0, se = 0;
+
+    g_mutex_lock (&v->lock);
+    {
+      const glong len = v->end - v->begin;
+      if (len > 0)
+      {
+        const glong take = (len > pfor->grain) ? GSL_MAX (len / 2, pfor->grain) : len;
+        se     = v->end;
+        sb     = v->end - take;
+        v->end = sb;
+      }
+    }
+    g_mutex_unlock (&v->lock);
+
+    if (se > sb)
+    {
+      NcmFuncEvalRange *r = &pfor->ranges[slot];
+      g_mutex_lock (&r->lock);
+      r->begin = sb;
+      r->end   = se;
+      g_mutex_unlock (&r->lock);
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+static void
+_ncm_func_eval_pfor_work (NcmFuncEvalPFor *pfor, guint slot)
+{
+  while (TRUE)
+  {
+    glong li, lf;
+
+    if (!_ncm_func_eval_pfor_pop (pfor, slot, &li, &lf))
+    {
+      if (_ncm_func_eval_pfor_steal (pfor, slot))
+        continue;
+      else
+        break;
+    }
+
+    pfor->lfunc (li, lf, pfor->data);
+
+    /* Pointer sized counter, the index range does not need to fit in a gint. */
+    if (g_atomic_pointer_add (&pfor->remaining, - (gssize) (lf - li)) == (gssize) (lf - li))
+    {
+      g_mutex_lock (&pfor->done_lock);
+      g_cond_broadcast (&pfor->done_cond);
+      g_mutex_unlock (&pfor->done_lock);
+    }
+  }
+}
+
 static void
 func (gpointer data, gpointer empty)
 {
-  NcmFuncEvalLoopEval *arg = (NcmFuncEvalLoopEval *)data;
-  NcmFuncEvalCtrl *ctrl = arg->ctrl;
+  NcmFuncEvalPFor *pfor = (NcmFuncEvalPFor *) data;
+  const guint slot      = g_atomic_int_add (&pfor->next_slot, 1);
   NCM_UNUSED (empty);
-  arg->lfunc (arg->i, arg->f, arg->data);
-  g_slice_free (NcmFuncEvalLoopEval, arg);
-
-  g_mutex_lock (&ctrl->update);
 
-  ctrl->active_threads--;
-  if (ctrl->active_threads == 0)
-    g_cond_signal (&ctrl->finish);
+  /* 
+   * A late worker (started after all work was done) finds nothing to do,
+   * the pfor is kept alive by its own reference.
+   */
+  if (slot < pfor->nworkers)
+    _ncm_func_eval_pfor_work (pfor, slot);
 
-  g_mutex_unlock (&ctrl->update);
+  _ncm_func_eval_pfor_unref (pfor);
 
   return;
 }
 
+static void
+_ncm_func_eval_pfor_run (NcmFuncEvalLoop lfunc, glong i, glong f, glong grain, gpointer data, guint nworkers)
+{
+  NcmFuncEvalPFor *pfor = _ncm_func_eval_pfor_new (lfunc, i, f, grain, data, nworkers);
+  GError *err = NULL;
+  guint w;
+
+  /* The calling thread is the worker in slot 0 */
+  pfor->next_slot  = 1;
+  pfor->ref_count += nworkers - 1;
+
+  for (w = 1; w < nworkers; w++)
+  {
+    g_thread_pool_push (_function_thread_pool, pfor, &err);
+    if (err != NULL)
+      g_error ("_ncm_func_eval_pfor_run: %s", err->message);
+  }
+
+  _ncm_func_eval_pfor_work (pfor, 0);
+
+  g_mutex_lock (&pfor->done_lock);
+  while ((gssize) g_atomic_pointer_get (&pfor->remaining) != 0)
+    g_cond_wait (&pfor->done_cond, &pfor->done_lock);
+  g_mutex_unlock (&pfor->done_lock);
+
+  _ncm_func_eval_pfor_unref (pfor);
+}
+
 /**
  * ncm_func_eval_get_pool: (skip)
  *
@@ -124,6 +314,23 @@ ncm_func_eval_set_max_threads (gint mt)
     g_error ("ncm_func_eval_set_max_threads: %s", err->message);
 }
 
+/**
+ * ncm_func_eval_get_nworkers:
+ *
+ * Returns: the number of workers used by ncm_func_eval_parallel_for(), i.e.,
+ * the maximum number of threads in the pool.
+ */
+guint
+ncm_func_eval_get_nworkers (void)
+{
+  gint mt;
+
+  ncm_func_eval_get_pool ();
+  mt = g_thread_pool_get_max_threads (_function_thread_pool);
+
+  return (mt > 0) ? mt : NCM_THREAD_POOL_MAX;
+}
+
 /**
  * ncm_func_eval_threaded_loop_nw:
  * @lfunc: (scope notified): #NcmFuncEvalLoop to be evaluated in threads
@@ -138,52 +345,16 @@ ncm_func_eval_set_max_threads (gint mt)
 void
 ncm_func_eval_threaded_loop_nw (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data, guint nworkers)
 {
-  NcmFuncEvalCtrl ctrl = {0, {NULL}, {NULL}, };
-  guint delta, res;
-
   ncm_func_eval_get_pool ();
-  
-  g_mutex_init (&ctrl.update);
-  g_cond_init (&ctrl.finish);
 
   g_assert_cmpuint (f, >, i);
   g_assert_cmpuint (f - i, >, nworkers);
   g_assert_cmpuint (nworkers, >, 0);
 
-  delta = (f - i) / nworkers;
-  res = (f - i) % nworkers;
-
-  if (delta == 0)
-  {
+  if (nworkers == 1)
     lfunc (i, f, data);
-  }
   else
-  {
-    GError *err = NULL;
-    glong li = i;
-    glong lf = i + delta + res;
-    ctrl.active_threads = nworkers;
-
-    do {
-      NcmFuncEvalLoopEval *arg = g_slice_new (NcmFuncEvalLoopEval);
-      arg->lfunc = lfunc;
-      arg->i = li;
-      arg->f = lf;
-      arg->data = data;
-      arg->ctrl = &ctrl;
-      g_thread_pool_push (_function_thread_pool, arg, &err);
-      li = lf;
-      lf += delta;
-    } while (--nworkers);
-  }
-
-  g_mutex_lock (&ctrl.update);
-  while (ctrl.active_threads != 0)
-    g_cond_wait (&ctrl.finish, &ctrl.update);
-  g_mutex_unlock (&ctrl.update);
-
-  g_mutex_clear (&ctrl.update);
-  g_cond_clear (&ctrl.finish);
+    _ncm_func_eval_pfor_run (lfunc, i, f, (f - i) / nworkers, data, nworkers);
 }
 
 /**
@@ -199,68 +370,69 @@ ncm_func_eval_threaded_loop_nw (NcmFuncEvalLoop lfunc, glong i, glong f, gpointe
 void
 ncm_func_eval_threaded_loop (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data)
 {
-  ncm_func_eval_get_pool ();
-  {
-    guint nthreads = g_thread_pool_get_max_threads (_function_thread_pool);
-    ncm_func_eval_threaded_loop_nw (lfunc, i, f, data, nthreads);
-  }
+  ncm_func_eval_threaded_loop_nw (lfunc, i, f, data, ncm_func_eval_get_nworkers ());
 }
 
 /**
- * ncm_func_eval_threaded_loop_full:
- * @lfunc: (scope notified): #NcmFuncEvalLoop to be evaluated in threads
+ * ncm_func_eval_parallel_for:
+ * @lfunc: (scope call): #NcmFuncEvalLoop to be evaluated in threads
  * @i: initial index
  * @f: final index
- * @data: pointer to be passed to @fl
+ * @grain: minimum number of indexes per call of @lfunc, 0 means automatic
+ * @data: pointer to be passed to @lfunc
  *
- * Using the thread pool, evaluate @fl sending one worker per index.
+ * Using the thread pool, evaluate @lfunc over [@i, @f) dividing the work in
+ * chunks of at least @grain indexes (except the last of each range). The
+ * chunks are balanced among the workers through work-stealing. Use @grain
+ * equal to one when each index is expensive (e.g., a full likelihood
+ * evaluation) and zero to let the scheduler choose it based on the number of
+ * indexes and workers.
  *
  */
 #if NCM_THREAD_POOL_MAX > 1
 void
-ncm_func_eval_threaded_loop_full (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data)
+ncm_func_eval_parallel_for (NcmFuncEvalLoop lfunc, glong i, glong f, glong grain, gpointer data)
 {
-  NcmFuncEvalCtrl ctrl = {0, {NULL}, {NULL}, };
-
-  ncm_func_eval_get_pool ();
-  g_mutex_init (&ctrl.update);
-  g_cond_init (&ctrl.finish);
+  const guint nworkers = ncm_func_eval_get_nworkers ();
+  const glong n        = f - i;
 
-  g_assert_cmpuint (f, >, i);
+  g_assert_cmpint (f, >, i);
+  g_assert_cmpint (grain, >=, 0);
 
-  {
-    GError *err = NULL;
-    glong l;
-    ctrl.active_threads = f - i;
+  if (grain == 0)
+    grain = GSL_MAX (n / (nworkers * NCM_FUNC_EVAL_AUTO_GRAIN_DIV), 1);
 
-    for (l = i; l < f; l++)
-    {
-      NcmFuncEvalLoopEval *arg = g_slice_new (NcmFuncEvalLoopEval);
-      arg->lfunc = lfunc;
-      arg->i     = l;
-      arg->f     = l + 1;
-      arg->data  = data;
-      arg->ctrl  = &ctrl;
-      g_thread_pool_push (_function_thread_pool, arg, &err);
-    }
-  }
-
-  g_mutex_lock (&ctrl.update);
-  while (ctrl.active_threads != 0)
-    g_cond_wait (&ctrl.finish, &ctrl.update);
-  g_mutex_unlock (&ctrl.update);
-
-  g_mutex_clear (&ctrl.update);
-  g_cond_clear (&ctrl.finish);
+  if ((nworkers == 1) || (n <= grain))
+    lfunc (i, f, data);
+  else
+    _ncm_func_eval_pfor_run (lfunc, i, f, grain, data, GSL_MIN (nworkers, (n + grain - 1) / grain));
 }
 #else
 void
-ncm_func_eval_threaded_loop_full (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data)
+ncm_func_eval_parallel_for (NcmFuncEvalLoop lfunc, glong i, glong f, glong grain, gpointer data)
 {
+  NCM_UNUSED (grain);
   lfunc (i, f, data);
 }
 #endif
 
+/**
+ * ncm_func_eval_threaded_loop_full:
+ * @lfunc: (scope notified): #NcmFuncEvalLoop to be evaluated in threads
+ * @i: initial index
+ * @f: final index
+ * @data: pointer to be passed to @fl
+ *
+ * Using the thread pool, evaluate @fl one index at a time, this is
+ * equivalent to ncm_func_eval_parallel_for() with grain equal to one.
+ *
+ */
+void
+ncm_func_eval_threaded_loop_full (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data)
+{
+  ncm_func_eval_parallel_for (lfunc, i, f, 1, data);
+}
+
 void 
 ncm_func_eval_log_pool_stats ()
 {
@@ -33,6 +33,8 @@ G_BEGIN_DECLS
 typedef void (*NcmFuncEvalLoop) (glong i, glong f, gpointer data);
 
 void ncm_func_eval_set_max_threads (gint mt);
+guint ncm_func_eval_get_nworkers (void);
+void ncm_func_eval_parallel_for (NcmFuncEvalLoop lfunc, glong i, glong f, glong grain, gpointer data);
 void ncm_func_eval_threaded_loop_nw (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data, guint nworkers);
 void ncm_func_eval_threaded_loop (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data);
 void ncm_func_eval_threaded_loop_full (NcmFuncEvalLoop lfunc, glong i, glong f, gpointer data);
@@ -742,6 +742,58 @@ ncm_likelihood_m2lnL_val (NcmLikelihood *lh, NcmMSet *mset, gdouble *m2lnL)
   return;
 }
 
+/**
+ * ncm_likelihood_m2lnL_val_batch:
+ * @lh: a #NcmLikelihood.
+ * @mset: a #NcmMSet.
+ * @fparams: a #NcmMatrix
+ * @m2lnL: a #NcmVector
+ * 
+ * Computes $-2\ln(L)$ for each row of @fparams, where each row contains 
+ * the free parameters of @mset, and stores the results in @m2lnL. The 
+ * #NcmData which support it are evaluated in a single batch, see 
+ * ncm_data_m2lnL_val_batch_add(). The free parameters of @mset are restored 
+ * at the end.
+ *
+ */
+void 
+ncm_likelihood_m2lnL_val_batch (NcmLikelihood *lh, NcmMSet *mset, NcmMatrix *fparams, NcmVector *m2lnL)
+{
+  const guint k       = ncm_matrix_nrows (fparams);
+  NcmVector *fparams0 = ncm_vector_new (ncm_mset_fparams_len (mset));
+  NcmVector *x_i      = NULL;
+  guint i;
+
+  g_assert_cmpuint (ncm_matrix_ncols (fparams), ==, ncm_mset_fparams_len (mset));
+  g_assert_cmpuint (ncm_vector_len (m2lnL), ==, k);
+
+  ncm_mset_fparams_get_vector (mset, fparams0);
+
+  for (i = 0; i < k; i++)
+  {
+    NcmVectorView x_i_view = ncm_matrix_get_row_view (fparams, i);
+    gdouble data_m2lnL_i, priors_m2lnL_i;
+
+    if (x_i == NULL)
+      x_i = ncm_vector_new_view (&x_i_view);
+    else
+      ncm_vector_set_view (x_i, &x_i_view);
+
+    ncm_mset_fparams_set_vector (mset, x_i);
+
+    ncm_dataset_m2lnL_val_batch_add (lh->dset, mset, &data_m2lnL_i);
+    ncm_likelihood_priors_m2lnL_val (lh, mset, &priors_m2lnL_i);
+
+    ncm_vector_set (m2lnL, i, data_m2lnL_i + priors_m2lnL_i);
+  }
+
+  ncm_dataset_m2lnL_val_batch_eval (lh->dset, mset, m2lnL);
+
+  ncm_mset_fparams_set_vector (mset, fparams0);
+  ncm_vector_free (fparams0);
+  ncm_vector_clear (&x_i);
+}
+
 /**
  * ncm_likelihood_m2lnL_grad:
  * @lh: a #NcmLikelihood.
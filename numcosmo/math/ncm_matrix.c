@@ -1062,6 +1062,36 @@ ncm_matrix_log_vals (NcmMatrix *cm, gchar *prefix, gchar *format)
  * The length of the vector must be the same as the length of the column.
  *
  */
+/**
+ * ncm_matrix_set_row:
+ * @cm: a #NcmMatrix
+ * @n: row index
+ * @cv: a constant #NcmVector
+ *
+ * This function copies the elements of the vector @cv into the @n-th row of the matrix @cm.
+ * The length of the vector must be the same as the length of the row.
+ *
+ */
+/**
+ * ncm_matrix_get_col_view: (skip)
+ * @cm: a #NcmMatrix
+ * @col: column index
+ *
+ * Same as ncm_matrix_get_col() but returns a #NcmVectorView, no object
+ * is created and no reference to @cm is taken.
+ *
+ * Returns: a #NcmVectorView of the @col column.
+ */
+/**
+ * ncm_matrix_get_row_view: (skip)
+ * @cm: a #NcmMatrix
+ * @row: row index
+ *
+ * Same as ncm_matrix_get_row() but returns a #NcmVectorView, no object
+ * is created and no reference to @cm is taken.
+ *
+ * Returns: a #NcmVectorView of the @row row.
+ */
 /**
  * ncm_matrix_get_array:
  * @cm: a #NcmMatrix
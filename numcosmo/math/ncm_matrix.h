@@ -129,6 +129,9 @@ G_INLINE_FUNC void ncm_matrix_set_all (NcmMatrix *cm, const gdouble val);
 G_INLINE_FUNC void ncm_matrix_scale (NcmMatrix *cm, const gdouble val);
 G_INLINE_FUNC void ncm_matrix_memcpy (NcmMatrix *cm1, const NcmMatrix *cm2);
 G_INLINE_FUNC void ncm_matrix_set_col (NcmMatrix *cm, const guint n, const NcmVector *cv);
+G_INLINE_FUNC void ncm_matrix_set_row (NcmMatrix *cm, const guint n, const NcmVector *cv);
+G_INLINE_FUNC NcmVectorView ncm_matrix_get_col_view (NcmMatrix *cm, const guint col);
+G_INLINE_FUNC NcmVectorView ncm_matrix_get_row_view (NcmMatrix *cm, const guint row);
 G_INLINE_FUNC gdouble ncm_matrix_fast_get (NcmMatrix *cm, const guint ij);
 G_INLINE_FUNC void ncm_matrix_fast_set (NcmMatrix *cm, const guint ij, const gdouble val);
 
@@ -275,6 +278,32 @@ ncm_matrix_set_col (NcmMatrix *cm, const guint n, const NcmVector *cv)
   gsl_matrix_set_col (ncm_matrix_gsl (cm), n, ncm_vector_const_gsl (cv));
 }
 
+G_INLINE_FUNC void
+ncm_matrix_set_row (NcmMatrix *cm, const guint n, const NcmVector *cv)
+{
+  gsl_matrix_set_row (ncm_matrix_gsl (cm), n, ncm_vector_const_gsl (cv));
+}
+
+G_INLINE_FUNC NcmVectorView
+ncm_matrix_get_col_view (NcmMatrix *cm, const guint col)
+{
+  NcmVectorView view;
+
+  view.vv = gsl_matrix_column (ncm_matrix_gsl (cm), col);
+
+  return view;
+}
+
+G_INLINE_FUNC NcmVectorView
+ncm_matrix_get_row_view (NcmMatrix *cm, const guint row)
+{
+  NcmVectorView view;
+
+  view.vv = gsl_matrix_row (ncm_matrix_gsl (cm), row);
+
+  return view;
+}
+
 G_INLINE_FUNC GArray *
 ncm_matrix_get_array (NcmMatrix *cm)
 {
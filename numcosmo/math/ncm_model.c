@@ -326,6 +326,13 @@ enum
 
 G_DEFINE_ABSTRACT_TYPE (NcmModel, ncm_model, G_TYPE_OBJECT);
 
+/*
+ * Serial numbers are never reused, so that a (serial, pkey) pair identifies
+ * a model state even after the model is destroyed and its memory recycled,
+ * see NcmModelCtrl.
+ */
+static volatile gsize _ncm_model_serial = 0;
+
 static void
 ncm_model_init (NcmModel *model)
 {
@@ -337,6 +344,7 @@ ncm_model_init (NcmModel *model)
   model->vparam_len = g_array_sized_new (TRUE, TRUE, sizeof (guint), 0);
   model->vparam_pos = g_array_sized_new (TRUE, TRUE, sizeof (guint), 0);
 
+  model->serial  = (guint64) g_atomic_pointer_add (&_ncm_model_serial, 1) + 1;
   model->pkey    = 1;
   model->skey    = 0;
   model->reparam = NULL;
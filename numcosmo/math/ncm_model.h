@@ -92,6 +92,7 @@ struct _NcmModel
   GHashTable *submodel_mid_pos;
   GPtrArray *submodel_array;
   guint total_len;
+  guint64 serial;
   guint64 pkey;
   guint64 skey;
 };
@@ -27,7 +27,14 @@
  * @title: NcmModelCtrl
  * @short_description: Control object for testing updates on model status.
  *
- * FIXME
+ * The control object keeps track of a model (and its submodels) and
+ * reports whether it changed since the last check. A model is identified by
+ * its serial number, which is unique during the whole program execution,
+ * and its state by the parameter key, which is increased each time its
+ * parameters are changed. Therefore, ncm_model_ctrl_update() only compares
+ * integers and does not access the weak reference to the model, which is
+ * only used by ncm_model_ctrl_get_model(). No allocation is done unless the
+ * model or the number of submodels change.
  *
  */
 
@@ -51,7 +58,10 @@ static void
 ncm_model_ctrl_init (NcmModelCtrl *ctrl)
 {
   g_weak_ref_init (&ctrl->model_wr, NULL);
-  ctrl->pkey = 0;
+  ctrl->model_serial = 0;
+  ctrl->pkey         = 0;
+  ctrl->mid          = -1;
+  ctrl->last_update  = FALSE;
 
   ctrl->submodel_ctrl = g_ptr_array_new ();
   g_ptr_array_set_free_func (ctrl->submodel_ctrl, (GDestroyNotify) ncm_model_ctrl_free);
@@ -222,13 +232,14 @@ gboolean
 ncm_model_ctrl_set_model (NcmModelCtrl *ctrl, NcmModel *model)
 {
   gboolean up = FALSE;
-  NcmModel *ctrl_model = ncm_model_ctrl_get_model (ctrl);
 
-  if (model != ctrl_model)
+  if (model->serial != ctrl->model_serial)
   {
     g_weak_ref_set (&ctrl->model_wr, model);
-    ctrl->pkey  = model->pkey;
-    up          = TRUE;
+    ctrl->model_serial = model->serial;
+    ctrl->pkey         = model->pkey;
+    ctrl->mid          = ncm_model_id (model);
+    up                 = TRUE;
   }
 
   {
@@ -255,7 +266,6 @@ ncm_model_ctrl_set_model (NcmModelCtrl *ctrl, NcmModel *model)
     g_ptr_array_set_size (ctrl->submodel_ctrl, n);
   }
   
-  ncm_model_clear (&ctrl_model);
   return up;
 }
 
@@ -271,12 +281,7 @@ ncm_model_ctrl_set_model (NcmModelCtrl *ctrl, NcmModel *model)
 gboolean
 ncm_model_ctrl_has_model (NcmModelCtrl *ctrl, NcmModel *model)
 {
-  NcmModel *ctrl_model = ncm_model_ctrl_get_model (ctrl);
-  gboolean is_model = (model == ctrl_model);
-
-  ncm_model_clear (&ctrl_model);
-
-  return is_model;
+  return (ctrl->model_serial != 0) && (model->serial == ctrl->model_serial);
 }
 
 /**
@@ -290,6 +295,8 @@ void
 ncm_model_ctrl_force_update (NcmModelCtrl *ctrl)
 {
   g_weak_ref_set (&ctrl->model_wr, NULL);
+  ctrl->model_serial = 0;
+  ctrl->mid          = -1;
   g_ptr_array_set_size (ctrl->submodel_ctrl, 0);
   g_array_set_size (ctrl->submodel_last_update, 0);
   return;
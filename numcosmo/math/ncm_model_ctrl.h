@@ -54,7 +54,9 @@ struct _NcmModelCtrl
   /*< private >*/
   GObject parent_instance;
   GWeakRef model_wr;
-  gulong pkey;
+  guint64 model_serial;
+  guint64 pkey;
+  NcmModelID mid;
   gboolean last_update;
   GPtrArray *submodel_ctrl;
   GArray *submodel_last_update;
@@ -76,6 +78,8 @@ G_INLINE_FUNC gboolean ncm_model_ctrl_model_last_update (NcmModelCtrl *ctrl);
 G_INLINE_FUNC gboolean ncm_model_ctrl_model_has_submodel (NcmModelCtrl *ctrl, NcmModelID mid);
 G_INLINE_FUNC gboolean ncm_model_ctrl_submodel_last_update (NcmModelCtrl *ctrl, NcmModelID mid);
 
+G_INLINE_FUNC gint _ncm_model_ctrl_submodel_pos (NcmModelCtrl *ctrl, NcmModelID mid);
+
 G_END_DECLS
 
 #endif /* _NCM_MODEL_CTRL_H_ */
@@ -95,11 +99,12 @@ ncm_model_ctrl_get_model (NcmModelCtrl *ctrl)
 G_INLINE_FUNC gboolean
 ncm_model_ctrl_update (NcmModelCtrl *ctrl, NcmModel *model)
 {
-  NcmModel *ctrl_model = ncm_model_ctrl_get_model (ctrl);
-  gboolean up = FALSE;
+  const guint n = ncm_model_get_submodel_len (model);
+  gboolean up;
+  guint i;
 
   ctrl->last_update = FALSE;
-  if (ctrl_model != model)
+  if (ctrl->model_serial != model->serial)
   {
     ncm_model_ctrl_set_model (ctrl, model);
     ctrl->last_update = TRUE;
@@ -109,88 +114,72 @@ ncm_model_ctrl_update (NcmModelCtrl *ctrl, NcmModel *model)
     ctrl->pkey = model->pkey;
     ctrl->last_update = TRUE;
   }
-  up = up || ctrl->last_update;
+  up = ctrl->last_update;
+
+  if (ctrl->submodel_last_update->len != n)
+    g_array_set_size (ctrl->submodel_last_update, n);
 
+  for (i = 0; i < n; i++)
   {
-    const guint n = ncm_model_get_submodel_len (model);
-    guint i;
+    NcmModel *submodel = ncm_model_peek_submodel (model, i);
+    gboolean sub_up;
 
-    g_array_set_size (ctrl->submodel_last_update, n);
-    for (i = 0; i < n; i++)
+    if (i >= ctrl->submodel_ctrl->len)
     {
-      NcmModel *submodel = ncm_model_peek_submodel (model, i);
-      g_array_index (ctrl->submodel_last_update, gboolean, i) = FALSE;
-      
-      if (i >= ctrl->submodel_ctrl->len)
-      {
-        NcmModelCtrl *sub_ctrl = ncm_model_ctrl_new (submodel);
-        g_ptr_array_add (ctrl->submodel_ctrl, sub_ctrl);
-        
-        g_array_index (ctrl->submodel_last_update, gboolean, i) = TRUE;
-      }
-      else
-      {
-        NcmModelCtrl *sub_ctrl = g_ptr_array_index (ctrl->submodel_ctrl, i);
-        if (ncm_model_ctrl_update (sub_ctrl, submodel))
-        {
-          g_array_index (ctrl->submodel_last_update, gboolean, i) = TRUE;
-        }
-      }
-      up = up || g_array_index (ctrl->submodel_last_update, gboolean, i);
+      g_ptr_array_add (ctrl->submodel_ctrl, ncm_model_ctrl_new (submodel));
+      sub_up = TRUE;
     }
-    g_ptr_array_set_size (ctrl->submodel_ctrl, n);
+    else
+      sub_up = ncm_model_ctrl_update (g_ptr_array_index (ctrl->submodel_ctrl, i), submodel);
+
+    g_array_index (ctrl->submodel_last_update, gboolean, i) = sub_up;
+    up = up || sub_up;
   }
 
-  ncm_model_clear (&ctrl_model);
+  if (ctrl->submodel_ctrl->len != n)
+    g_ptr_array_set_size (ctrl->submodel_ctrl, n);
+
   return up;
 }
 
 G_INLINE_FUNC gboolean
 ncm_model_ctrl_model_update (NcmModelCtrl *ctrl, NcmModel *model)
 {
-  NcmModel *ctrl_model = ncm_model_ctrl_get_model (ctrl);
-  gboolean up = FALSE;
+  const guint n = ncm_model_get_submodel_len (model);
+  gboolean up;
+  guint i;
 
   ctrl->last_update = FALSE;
-  if (ctrl_model != model)
+  if (ctrl->model_serial != model->serial)
   {
     ncm_model_ctrl_set_model (ctrl, model);
     ctrl->last_update = TRUE;
   }
-  up = up || ctrl->last_update;
-  
-  {
-    const guint n = ncm_model_get_submodel_len (model);
-    guint i;
+  up = ctrl->last_update;
 
+  if (ctrl->submodel_last_update->len != n)
     g_array_set_size (ctrl->submodel_last_update, n);
-    
-    for (i = 0; i < n; i++)
+
+  for (i = 0; i < n; i++)
+  {
+    NcmModel *submodel = ncm_model_peek_submodel (model, i);
+    gboolean sub_up;
+
+    if (i >= ctrl->submodel_ctrl->len)
     {
-      NcmModel *submodel = ncm_model_peek_submodel (model, i);
-      g_array_index (ctrl->submodel_last_update, gboolean, i) = FALSE;
-      
-      if (i >= ctrl->submodel_ctrl->len)
-      {
-        NcmModelCtrl *sub_ctrl = ncm_model_ctrl_new (submodel);
-        g_ptr_array_add (ctrl->submodel_ctrl, sub_ctrl);
-        
-        g_array_index (ctrl->submodel_last_update, gboolean, i) = TRUE;
-      }
-      else
-      {
-        NcmModelCtrl *sub_ctrl = g_ptr_array_index (ctrl->submodel_ctrl, i);
-        if (ncm_model_ctrl_model_update (sub_ctrl, submodel))
-        {
-          g_array_index (ctrl->submodel_last_update, gboolean, i) = TRUE;
-        }
-      }
-      up = up || g_array_index (ctrl->submodel_last_update, gboolean, i);
+      g_ptr_array_add (ctrl->submodel_ctrl, ncm_model_ctrl_new (submodel));
+      sub_up = TRUE;
     }
-    g_ptr_array_set_size (ctrl->submodel_ctrl, n);
+    else
+      sub_up = ncm_model_ctrl_model_update (g_ptr_array_index (ctrl->submodel_ctrl, i), submodel);
+
+    g_array_index (ctrl->submodel_last_update, gboolean, i) = sub_up;
+    up = up || sub_up;
   }
-  
-  ncm_model_clear (&ctrl_model);  
+
+  if (ctrl->submodel_ctrl->len != n)
+    g_ptr_array_set_size (ctrl->submodel_ctrl, n);
+
   return up;
 }
 
@@ -200,57 +189,55 @@ ncm_model_ctrl_model_last_update (NcmModelCtrl *ctrl)
   return ctrl->last_update;
 }
 
+G_INLINE_FUNC gint
+_ncm_model_ctrl_submodel_pos (NcmModelCtrl *ctrl, NcmModelID mid)
+{
+  guint i;
+
+  for (i = 0; i < ctrl->submodel_ctrl->len; i++)
+  {
+    NcmModelCtrl *sub_ctrl = g_ptr_array_index (ctrl->submodel_ctrl, i);
+    if (sub_ctrl->mid == mid)
+      return i;
+  }
+
+  return -1;
+}
+
 G_INLINE_FUNC gboolean 
 ncm_model_ctrl_model_has_submodel (NcmModelCtrl *ctrl, NcmModelID mid)
 {
-  NcmModel *ctrl_model = ncm_model_ctrl_get_model (ctrl);
-  if (ctrl_model == NULL)
+  if (ctrl->model_serial == 0)
   {
     g_error ("ncm_model_ctrl_model_has_submodel: empty ctrl object.");
     return FALSE;
   }
   else
-  {
-    NcmModel *submodel = ncm_model_peek_submodel_by_mid (ctrl_model, mid);
-    gboolean has_submodel = FALSE;
-
-    if (submodel != NULL)
-      has_submodel = TRUE;
-
-    ncm_model_clear (&ctrl_model);
-
-    return has_submodel;
-  }
+    return (_ncm_model_ctrl_submodel_pos (ctrl, mid) >= 0);
 }
 
 G_INLINE_FUNC gboolean 
 ncm_model_ctrl_submodel_last_update (NcmModelCtrl *ctrl, NcmModelID mid)
 {
-  NcmModel *ctrl_model = ncm_model_ctrl_get_model (ctrl);
-  if (ctrl_model == NULL)
+  if (ctrl->model_serial == 0)
   {
     g_error ("ncm_model_ctrl_submodel_last_update: empty ctrl object.");
     return FALSE;
   }
   else
   {
-    gint pos = ncm_model_peek_submodel_pos_by_mid (ctrl_model, mid);
-    gboolean up = FALSE;
+    const gint pos = _ncm_model_ctrl_submodel_pos (ctrl, mid);
 
     if (pos < 0)
       g_error ("ncm_model_ctrl_submodel_last_update: submodel `%s' not found in the main model `%s'.",
                ncm_mset_get_ns_by_id (mid),
-               G_OBJECT_TYPE_NAME (ctrl_model));
+               ncm_mset_get_ns_by_id (ctrl->mid));
     if (pos >= ctrl->submodel_last_update->len)
       g_error ("ncm_model_ctrl_submodel_last_update: submodel `%s' not found in ctrl object.\n" 
                "ncm_model_ctrl_update() must always be called before ncm_model_ctrl_model_last_update_submodel().",
                ncm_mset_get_ns_by_id (mid));
 
-    up = up || g_array_index (ctrl->submodel_last_update, gboolean, pos);
-
-    ncm_model_clear (&ctrl_model);
-
-    return up;
+    return g_array_index (ctrl->submodel_last_update, gboolean, pos);
   }
 }
 
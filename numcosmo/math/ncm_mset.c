@@ -48,15 +48,19 @@ enum
   PROP_VALID_MAP,
   PROP_MARRAY,
   PROP_FMAP,
+  PROP_MODEL_COSTS,
   PROP_SIZE,
 };
 
+#define NCM_MSET_MODEL_COSTS_DICT_TYPE "a{sd}"
+
 typedef struct _NcmMSetItem
 {
   NcmModelID mid;
   NcmModel *model;
   gboolean dup;
   gint added_total_params;
+  gdouble cost;
 } NcmMSetItem;
 
 G_DEFINE_TYPE (NcmMSet, ncm_mset, G_TYPE_OBJECT);
@@ -78,6 +82,7 @@ _ncm_mset_item_new (NcmModel *model, NcmModelID mid)
   item->model = ncm_model_ref (model);
   item->mid   = mid;
   item->dup   = FALSE;
+  item->cost  = 1.0;
   item->added_total_params = ncm_model_len (model);
   return item;
 }
@@ -112,6 +117,9 @@ ncm_mset_init (NcmMSet *mset)
   mset->total_len = 0;
 }
 
+static GVariant *_ncm_mset_get_model_costs (NcmMSet *mset);
+static void _ncm_mset_set_model_costs (NcmMSet *mset, GVariant *costs);
+
 static void
 _ncm_mset_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
 {
@@ -139,6 +147,9 @@ _ncm_mset_get_property (GObject *object, guint prop_id, GValue *value, GParamSpe
     case PROP_FMAP:
       g_value_take_boxed (value, ncm_mset_get_fmap (mset));
       break;
+    case PROP_MODEL_COSTS:
+      g_value_take_variant (value, _ncm_mset_get_model_costs (mset));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -189,6 +200,13 @@ _ncm_mset_set_property (GObject *object, guint prop_id, const GValue *value, GPa
         ncm_mset_set_fmap (mset, fmap, FALSE);
       break;
     }
+    case PROP_MODEL_COSTS:
+    {
+      GVariant *costs = g_value_get_variant (value);
+      if (costs != NULL)
+        _ncm_mset_set_model_costs (mset, costs);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -257,6 +275,13 @@ ncm_mset_class_init (NcmMSetClass *klass)
                                                        "Free params map",
                                                        G_TYPE_STRV,
                                                        G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_MODEL_COSTS,
+                                   g_param_spec_variant ("model-costs",
+                                                         NULL,
+                                                         "Models costs",
+                                                         G_VARIANT_TYPE (NCM_MSET_MODEL_COSTS_DICT_TYPE), NULL,
+                                                         G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
 
 
@@ -512,6 +537,11 @@ ncm_mset_shallow_copy (NcmMSet *mset)
     if (!ncm_model_is_submodel (model))
       ncm_mset_push (mset_sc, model);
   }
+  for (i = 0; i < nmodels; i++)
+  {
+    NcmMSetItem *item = g_ptr_array_index (mset->model_array, i);
+    ncm_mset_set_model_cost (mset_sc, item->mid, item->cost);
+  }
   if (mset->valid_map)
     ncm_mset_prepare_fparam_map (mset_sc);
 
@@ -1245,6 +1275,158 @@ ncm_mset_nmodels (NcmMSet *mset)
   return mset->model_array->len;
 }
 
+/**
+ * ncm_mset_set_model_cost:
+ * @mset: a #NcmMSet
+ * @mid: a #NcmModelID
+ * @cost: the model cost
+ *
+ * Sets the cost of recomputing the likelihood when only the parameters
+ * of the model @mid change. Only the ratio between the costs of different
+ * models is meaningful, all models start with cost 1.0. The costs can be
+ * measured using ncm_fit_measure_model_costs().
+ *
+ */
+void
+ncm_mset_set_model_cost (NcmMSet *mset, NcmModelID mid, gdouble cost)
+{
+  NcmMSetItem *item = g_hash_table_lookup (mset->mid_item_hash, GINT_TO_POINTER (mid));
+
+  if (item == NULL)
+    g_error ("ncm_mset_set_model_cost: model id %d not found in NcmMSet.", mid);
+  g_assert_cmpfloat (cost, >=, 0.0);
+
+  item->cost = cost;
+}
+
+/**
+ * ncm_mset_get_model_cost:
+ * @mset: a #NcmMSet
+ * @mid: a #NcmModelID
+ *
+ * Gets the cost of the model @mid, see ncm_mset_set_model_cost().
+ *
+ * Returns: the cost of the model @mid.
+ */
+gdouble
+ncm_mset_get_model_cost (NcmMSet *mset, NcmModelID mid)
+{
+  NcmMSetItem *item = g_hash_table_lookup (mset->mid_item_hash, GINT_TO_POINTER (mid));
+
+  if (item == NULL)
+    g_error ("ncm_mset_get_model_cost: model id %d not found in NcmMSet.", mid);
+
+  return item->cost;
+}
+
+/*
+ * The costs are stored by model namespace, followed by the stack position
+ * when it is not zero, e.g., {'NcHICosmo': 100.0, 'NcClusterMass:01': 1.0}.
+ */
+static GVariant *
+_ncm_mset_get_model_costs (NcmMSet *mset)
+{
+  GVariantBuilder builder;
+  guint i;
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE (NCM_MSET_MODEL_COSTS_DICT_TYPE));
+
+  for (i = 0; i < mset->model_array->len; i++)
+  {
+    NcmMSetItem *item       = g_ptr_array_index (mset->model_array, i);
+    const gchar *model_ns   = ncm_mset_get_ns_by_id (item->mid);
+    const guint stackpos_id = item->mid % NCM_MSET_MAX_STACKSIZE;
+    gchar *key;
+
+    if (stackpos_id > 0)
+      key = g_strdup_printf ("%s:%02u", model_ns, stackpos_id);
+    else
+      key = g_strdup (model_ns);
+
+    g_variant_builder_add (&builder, "{sd}", key, item->cost);
+    g_free (key);
+  }
+
+  return g_variant_ref_sink (g_variant_builder_end (&builder));
+}
+
+static void
+_ncm_mset_set_model_costs (NcmMSet *mset, GVariant *costs)
+{
+  GVariantIter iter;
+  gchar *key;
+  gdouble cost;
+
+  g_variant_iter_init (&iter, costs);
+  while (g_variant_iter_next (&iter, "{sd}", &key, &cost))
+  {
+    gchar **ns_pos = g_strsplit (key, ":", 2);
+    NcmModelID mid = ncm_mset_get_id_by_ns (ns_pos[0]);
+    guint stackpos = 0;
+
+    if (mid < 0)
+      g_error ("_ncm_mset_set_model_costs: namespace `%s' not found.", ns_pos[0]);
+
+    if (ns_pos[1] != NULL)
+    {
+      gchar *endptr = NULL;
+      stackpos = g_ascii_strtoll (ns_pos[1], &endptr, 10);
+      if (*endptr != '\0')
+        g_error ("_ncm_mset_set_model_costs: invalid stackpos number `%s'.", ns_pos[1]);
+    }
+
+    ncm_mset_set_model_cost (mset, NCM_MSET_MID (mid, stackpos), cost);
+
+    g_strfreev (ns_pos);
+    g_free (key);
+  }
+}
+
+/**
+ * ncm_mset_fparams_get_fast:
+ * @mset: a #NcmMSet
+ * @ratio: maximum cost ratio
+ * @fast_fpi: (element-type guint): a #GArray
+ *
+ * Splits the free parameters in a fast and a slow block. A free parameter
+ * is fast when the cost of its model is at most @ratio times the largest
+ * cost among the models with free parameters. The indexes of the fast free
+ * parameters are stored in @fast_fpi, which is resized to the number of
+ * fast parameters. Thus, for @ratio < 1, no parameter is fast when all
+ * models have the same cost.
+ *
+ * Returns: the number of fast free parameters.
+ */
+guint
+ncm_mset_fparams_get_fast (NcmMSet *mset, gdouble ratio, GArray *fast_fpi)
+{
+  gdouble max_cost = 0.0;
+  guint fpi;
+
+  g_assert (mset->valid_map);
+  g_assert_cmpuint (g_array_get_element_size (fast_fpi), ==, sizeof (guint));
+
+  for (fpi = 0; fpi < mset->fparam_len; fpi++)
+  {
+    const NcmMSetPIndex pi = g_array_index (mset->pi_array, NcmMSetPIndex, fpi);
+    max_cost = GSL_MAX (max_cost, ncm_mset_get_model_cost (mset, pi.mid));
+  }
+
+  g_array_set_size (fast_fpi, 0);
+  if (max_cost > 0.0)
+  {
+    for (fpi = 0; fpi < mset->fparam_len; fpi++)
+    {
+      const NcmMSetPIndex pi = g_array_index (mset->pi_array, NcmMSetPIndex, fpi);
+
+      if (ncm_mset_get_model_cost (mset, pi.mid) <= ratio * max_cost)
+        g_array_append_val (fast_fpi, fpi);
+    }
+  }
+
+  return fast_fpi->len;
+}
+
 /**
  * ncm_mset_pretty_log:
  * @mset: a #NcmMSet
@@ -2047,6 +2229,33 @@ ncm_mset_fparams_set_vector_offset (NcmMSet *mset, const NcmVector *x, guint off
   }
 }
 
+/**
+ * ncm_mset_fparams_update_vector:
+ * @mset: a #NcmMSet
+ * @x: a #NcmVector
+ *
+ * Sets the free parameters of @mset to the values in @x, like
+ * ncm_mset_fparams_set_vector(), but only the parameters whose values
+ * differ from @x are set. In this way the models whose parameters did not
+ * change keep their pkey and everything computed from them remains valid,
+ * see #NcmModelCtrl.
+ *
+ */
+void
+ncm_mset_fparams_update_vector (NcmMSet *mset, const NcmVector *x)
+{
+  guint fpi;
+
+  for (fpi = 0; fpi < mset->fparam_len; fpi++)
+  {
+    const NcmMSetPIndex pi = g_array_index (mset->pi_array, NcmMSetPIndex, fpi);
+    const gdouble x_i      = ncm_vector_get (x, fpi);
+
+    if (ncm_mset_param_get (mset, pi.mid, pi.pid) != x_i)
+      ncm_mset_param_set (mset, pi.mid, pi.pid, x_i);
+  }
+}
+
 /**
  * ncm_mset_fparams_set_array:
  * @mset: a #NcmMSet
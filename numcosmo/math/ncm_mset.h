@@ -52,6 +52,7 @@ typedef struct _NcmMSetModelDesc NcmMSetModelDesc;
 
 #define NCM_MSET_MAX_STACKSIZE 1000
 #define NCM_MSET_INIT_MARRAY 32
+#define NCM_MSET_FAST_COST_RATIO (0.1)
 #define NCM_MSET_GET_BASE_MID(mid) (mid / NCM_MSET_MAX_STACKSIZE)
 #define NCM_MSET_MID(id,pos) ((id) + pos)
 
@@ -192,6 +193,10 @@ guint ncm_mset_max_fparam_name (NcmMSet *mset);
 guint ncm_mset_max_model_nick (NcmMSet *mset);
 guint ncm_mset_nmodels (NcmMSet *mset);
 
+void ncm_mset_set_model_cost (NcmMSet *mset, NcmModelID mid, gdouble cost);
+gdouble ncm_mset_get_model_cost (NcmMSet *mset, NcmModelID mid);
+guint ncm_mset_fparams_get_fast (NcmMSet *mset, gdouble ratio, GArray *fast_fpi);
+
 void ncm_mset_pretty_log (NcmMSet *mset);
 void ncm_mset_params_pretty_print (NcmMSet *mset, FILE *out, const gchar *header);
 void ncm_mset_params_log_vals (NcmMSet *mset);
@@ -229,6 +234,7 @@ void ncm_mset_fparams_get_vector (NcmMSet *mset, NcmVector *x);
 void ncm_mset_fparams_get_vector_offset (NcmMSet *mset, NcmVector *x, guint offset);
 void ncm_mset_fparams_set_vector (NcmMSet *mset, const NcmVector *x);
 void ncm_mset_fparams_set_vector_offset (NcmMSet *mset, const NcmVector *x, guint offset);
+void ncm_mset_fparams_update_vector (NcmMSet *mset, const NcmVector *x);
 void ncm_mset_fparams_set_array (NcmMSet *mset, const gdouble *x);
 void ncm_mset_fparams_set_gsl_vector (NcmMSet *mset, const gsl_vector *x);
 
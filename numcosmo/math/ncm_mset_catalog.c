@@ -31,6 +31,19 @@
  * This class defines a catalog type object. This object can automatically synchronize
  * with a fits file (thought cfitsio).
  *
+ * Alternatively, when the file name ends with #NCM_MSET_CATALOG_COL_EXT, the catalog
+ * is kept in a columnar memory-mapped file. Its header contains the catalog metadata
+ * and the serialized #NcmMSet (no separate .mset file is used) and the data is stored
+ * in blocks of contiguous per-column arrays. Rows are appended in place and read
+ * directly from the mapped file, i.e., no per-row I/O is done. The autocorrelation
+ * times (see ncm_mset_catalog_estimate_autocorrelation_tau()), the parameter
+ * distributions (ncm_mset_catalog_calc_param_distrib(),
+ * ncm_mset_catalog_calc_add_param_distrib(), ncm_mset_catalog_param_pdf()) and
+ * the ensemble evolutions are computed reading the columns in place. The rows are
+ * still kept in memory, since ncm_mset_catalog_peek_row() returns them to the
+ * samplers. Columnar files cannot be prepended and their columns must match the
+ * free parameters of the #NcmMSet.
+ *
  * For Mote Carlo studies, like resampling from a fiducial model or bootstrap, it is used
  * to save the best-fitting values of each realization. Since the order of the
  * resampling is important, due to the fact that we use the same pseudo-random number
@@ -54,10 +67,22 @@
 #include "math/ncm_mset_catalog.h"
 #include "math/ncm_cfg.h"
 #include "math/ncm_func_eval.h"
+#include "math/memory_pool.h"
 #include "ncm_enum_types.h"
 
 #include <gsl/gsl_statistics_double.h>
 #include <gsl/gsl_sort.h>
+#include <string.h>
+#include <errno.h>
+#include <glib/gstdio.h>
+
+#if defined (HAVE_SYS_MMAN_H) && defined (HAVE_MMAP) && defined (HAVE_FTRUNCATE)
+#define NCM_MSET_CATALOG_HAVE_COL 1
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif /* defined (HAVE_SYS_MMAN_H) && defined (HAVE_MMAP) && defined (HAVE_FTRUNCATE) */
 
 G_DEFINE_TYPE (NcmMSetCatalog, ncm_mset_catalog, G_TYPE_OBJECT);
 
@@ -108,6 +133,7 @@ ncm_mset_catalog_init (NcmMSetCatalog *mcat)
   mcat->chain_sM_ws    = NULL;
   mcat->chain_sM_ev    = NULL;
   mcat->tau            = NULL;
+  mcat->fft_nthreads   = 1;
 
   mcat->rng_inis       = NULL;
   mcat->rng_stat       = NULL;
@@ -121,10 +147,10 @@ ncm_mset_catalog_init (NcmMSetCatalog *mcat)
   mcat->mset_file      = NULL;
   mcat->rtype_str      = NULL;
   mcat->porder         = g_array_new (FALSE, FALSE, sizeof (gint));
-  mcat->quantile_ws    = NULL;
 #ifdef NUMCOSMO_HAVE_CFITSIO
   mcat->fptr           = NULL;
 #endif /* NUMCOSMO_HAVE_CFITSIO */
+  mcat->cfile          = NULL;
   mcat->pdf_i          = -1;
   mcat->h              = NULL;
   mcat->h_pdf          = NULL;
@@ -138,6 +164,46 @@ ncm_mset_catalog_init (NcmMSetCatalog *mcat)
 static void _ncm_mset_catalog_open_create_file (NcmMSetCatalog *mcat, gboolean load_from_cat);
 static void _ncm_mset_catalog_flush_file (NcmMSetCatalog *mcat);
 #endif /* NUMCOSMO_HAVE_CFITSIO */
+static gboolean _ncm_mset_catalog_is_col_file (const gchar *filename);
+static void _ncm_mset_catalog_open_file (NcmMSetCatalog *mcat, gboolean load_from_cat);
+
+static void
+_ncm_mset_catalog_set_online_diag_svec (NcmStatsVec *pstats, gboolean online)
+{
+  if (pstats == NULL)
+    return;
+
+  if (online && !ncm_stats_vec_online_diag_enabled (pstats))
+    ncm_stats_vec_enable_online_diag (pstats, 0, 0);
+  else if (!online && ncm_stats_vec_online_diag_enabled (pstats))
+    ncm_stats_vec_disable_online_diag (pstats);
+}
+
+static void
+_ncm_mset_catalog_set_online_diag (NcmMSetCatalog *mcat)
+{
+  const gboolean online = (mcat->tau_method == NCM_MSET_CATALOG_TAU_METHOD_ONLINE_ACOR) ||
+    (mcat->tau_method == NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS);
+
+  _ncm_mset_catalog_set_online_diag_svec (mcat->pstats, online);
+  if (mcat->nchains > 1)
+    _ncm_mset_catalog_set_online_diag_svec (mcat->e_mean_stats, online);
+}
+
+static void
+_ncm_mset_catalog_set_fft_nthreads (NcmMSetCatalog *mcat)
+{
+  guint i;
+
+  if (mcat->pstats == NULL)
+    return;
+
+  ncm_stats_vec_set_fft_nthreads (mcat->pstats, mcat->fft_nthreads);
+  for (i = 0; i < mcat->chain_pstats->len; i++)
+    ncm_stats_vec_set_fft_nthreads (g_ptr_array_index (mcat->chain_pstats, i), mcat->fft_nthreads);
+  if (mcat->e_mean_stats != NULL)
+    ncm_stats_vec_set_fft_nthreads (mcat->e_mean_stats, mcat->fft_nthreads);
+}
 
 static void
 _ncm_mset_catalog_constructed_alloc_chains (NcmMSetCatalog *mcat)
@@ -173,6 +239,9 @@ _ncm_mset_catalog_constructed_alloc_chains (NcmMSetCatalog *mcat)
   }
   mcat->tau = ncm_vector_new (total);
   ncm_vector_set_all (mcat->tau, 1.0);
+
+  _ncm_mset_catalog_set_online_diag (mcat);
+  _ncm_mset_catalog_set_fft_nthreads (mcat);
 }
 
 static void
@@ -197,7 +266,15 @@ _ncm_mset_catalog_constructed (GObject *object)
       g_free (file);
     }
 
-    if (mcat->mset == NULL)
+    if ((mcat->mset == NULL) && (mcat->file != NULL) && _ncm_mset_catalog_is_col_file (mcat->file))
+    {
+      /* Columnar catalog files carry the serialized mset in their header. */
+      _ncm_mset_catalog_open_file (mcat, TRUE);
+      _ncm_mset_catalog_constructed_alloc_chains (mcat);
+
+      ncm_mset_catalog_sync (mcat, TRUE);
+    }
+    else if (mcat->mset == NULL)
     {
 #ifdef NUMCOSMO_HAVE_CFITSIO
       if (mcat->mset_file == NULL)
@@ -248,7 +325,7 @@ _ncm_mset_catalog_constructed (GObject *object)
 
       if (mcat->file != NULL)
       {
-        _ncm_mset_catalog_open_create_file (mcat, FALSE);
+        _ncm_mset_catalog_open_file (mcat, FALSE);
         ncm_mset_catalog_sync (mcat, TRUE);
       }
       
@@ -406,6 +483,19 @@ _ncm_mset_catalog_dispose (GObject *object)
     ncm_serialize_free (ser);
   }
 
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+  if ((mcat->cfile != NULL) && (mcat->mset != NULL) && (mcat->pstats != NULL))
+  {
+    ncm_mset_catalog_sync (mcat, FALSE);
+
+    if (!mcat->readonly)
+    {
+      _ncm_mset_catalog_col_set_mset (mcat);
+      _ncm_mset_catalog_col_file_write_meta (mcat->cfile);
+    }
+  }
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
+
   ncm_mset_clear (&mcat->mset);
   ncm_rng_clear (&mcat->rng);
   ncm_stats_vec_clear (&mcat->pstats);
@@ -426,15 +516,12 @@ _ncm_mset_catalog_dispose (GObject *object)
   g_clear_pointer (&mcat->chain_sM_ws, gsl_eigen_nonsymm_free);
   g_clear_pointer (&mcat->chain_sM_ev, gsl_vector_complex_free);
   ncm_vector_clear (&mcat->tau);
-  ncm_vector_clear (&mcat->quantile_ws);
 
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_mset_catalog_parent_class)->dispose (object);
 }
 
-#ifdef NUMCOSMO_HAVE_CFITSIO
 static void _ncm_mset_catalog_close_file (NcmMSetCatalog *mcat);
-#endif /* NUMCOSMO_HAVE_CFITSIO */
 
 static void
 _ncm_mset_catalog_finalize (GObject *object)
@@ -446,9 +533,7 @@ _ncm_mset_catalog_finalize (GObject *object)
   if (mcat->h_pdf != NULL)
     gsl_histogram_pdf_free (mcat->h_pdf);
 
-#ifdef NUMCOSMO_HAVE_CFITSIO
   _ncm_mset_catalog_close_file (mcat);
-#endif /* NUMCOSMO_HAVE_CFITSIO */
 
   g_clear_pointer (&mcat->rtype_str, g_free);
 
@@ -1340,243 +1425,980 @@ _ncm_mset_catalog_open_create_file (NcmMSetCatalog *mcat, gboolean load_from_cat
 
 #endif /* NUMCOSMO_HAVE_CFITSIO */
 
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+
+/*
+ * Columnar catalog files (NCM_MSET_CATALOG_COL_EXT).
+ *
+ * The file starts with a fixed binary header followed by a reserved region
+ * containing the catalog metadata as a #GKeyFile (run type, chains,
+ * additional values, column names, RNG state and the serialized #NcmMSet).
+ * The data region starts at a page-aligned offset and is divided in blocks
+ * of block_rows rows, each block stores its columns contiguously
+ * (column-major). New blocks are appended with ftruncate and mapped
+ * separately, so existing mappings never move. Rows are read through strided
+ * views of the mapped memory and the columns of each block can be read in
+ * place, see _ncm_mset_catalog_col_file_peek_col().
+ */
+
+#define NCM_MSET_CATALOG_COL_MAGIC "NcmMCat1"
+#define NCM_MSET_CATALOG_COL_ENDIAN (0x01020304)
+#define NCM_MSET_CATALOG_COL_BLOCK_ROWS (16384)
+#define NCM_MSET_CATALOG_COL_META_SLACK (65536)
+#define NCM_MSET_CATALOG_COL_GROUP "NcmMSetCatalog"
+#define NCM_MSET_CATALOG_COL_COLUMNS_LABEL "COLUMNS"
+#define NCM_MSET_CATALOG_COL_MSET_LABEL "MSET"
+
+typedef struct _NcmMSetCatalogColHeader
+{
+  gchar magic[8];
+  guint32 endian;
+  guint32 ncols;
+  guint64 block_rows;
+  guint64 nrows;
+  guint64 meta_len;
+  guint64 data_offset;
+} NcmMSetCatalogColHeader;
+
+typedef struct _NcmMSetCatalogColBlock
+{
+  gdouble *data;
+  gsize size;
+} NcmMSetCatalogColBlock;
+
+struct _NcmMSetCatalogColFile
+{
+  gint fd;
+  gboolean readonly;
+  NcmMSetCatalogColHeader *header;
+  gchar *meta;
+  gsize meta_size;
+  gsize block_size;
+  guint64 nrows;
+  GPtrArray *blocks;
+  GKeyFile *kf;
+};
+
 static void
-_ncm_mset_catalog_set_add_val_name_array (NcmMSetCatalog *mcat, gchar **names)
+_ncm_mset_catalog_col_block_free (NcmMSetCatalogColBlock *block)
 {
-  if (names != NULL)
-  {
-    const guint len = g_strv_length (names);
-    guint i;
+  munmap (block->data, block->size);
+  g_slice_free (NcmMSetCatalogColBlock, block);
+}
 
-    g_ptr_array_set_size (mcat->add_vals_names, len);
+static gpointer
+_ncm_mset_catalog_col_file_mmap (NcmMSetCatalogColFile *cf, gsize size, off_t offset)
+{
+  const gint flags = cf->readonly ? MAP_PRIVATE : MAP_SHARED;
+  gpointer data    = mmap (NULL, size, PROT_READ | PROT_WRITE, flags, cf->fd, offset);
 
-    for (i = 0; i < len; i++)
-    {
-      g_clear_pointer (&g_ptr_array_index (mcat->add_vals_names, i), g_free);
-      g_ptr_array_index (mcat->add_vals_names, i) = g_strdup (names[i]);
-    }
-  }
-  else
-    g_ptr_array_set_size (mcat->add_vals_names, 0);
+  if (data == MAP_FAILED)
+    g_error ("_ncm_mset_catalog_col_file_mmap: cannot map %"G_GSIZE_FORMAT" bytes at %"G_GINT64_FORMAT": %s.",
+             size, (gint64) offset, g_strerror (errno));
+
+  return data;
 }
 
 static void
-_ncm_mset_catalog_set_add_val_symbol_array (NcmMSetCatalog *mcat, gchar **symbols)
+_ncm_mset_catalog_col_file_map_block (NcmMSetCatalogColFile *cf)
 {
-  if (symbols != NULL)
-  {
-    const guint len = g_strv_length (symbols);
-    guint i;
+  NcmMSetCatalogColBlock *block = g_slice_new (NcmMSetCatalogColBlock);
+  const off_t offset            = cf->header->data_offset + (off_t) cf->blocks->len * cf->block_size;
 
-    g_ptr_array_set_size (mcat->add_vals_symbs, len);
+  block->size      = cf->block_size;
+  block->data      = _ncm_mset_catalog_col_file_mmap (cf, cf->block_size, offset);
 
-    for (i = 0; i < len; i++)
-    {
-      g_clear_pointer (&g_ptr_array_index (mcat->add_vals_symbs, i), g_free);
-      g_ptr_array_index (mcat->add_vals_symbs, i) = g_strdup (symbols[i]);
-    }
-  }
-  else
-    g_ptr_array_set_size (mcat->add_vals_symbs, 0);
+  g_ptr_array_add (cf->blocks, block);
 }
 
-/**
- * ncm_mset_catalog_set_file:
- * @mcat: a #NcmMSetCatalog
- * @filename: a filename
- *
- * Sets the data filename to be used to sync/save data.
- *
- */
-void
-ncm_mset_catalog_set_file (NcmMSetCatalog *mcat, const gchar *filename)
+static NcmMSetCatalogColFile *
+_ncm_mset_catalog_col_file_alloc (gint fd, gboolean readonly)
 {
-#ifdef NUMCOSMO_HAVE_CFITSIO
-  if (!mcat->constructed)
-  {
-    if (mcat->file != NULL)
-      g_error ("ncm_mset_catalog_set_file: Unknown error.");
-    mcat->file = g_strdup (filename);
-  }
-  
-  if ((mcat->file != NULL) && (filename != NULL) && (strcmp (mcat->file, filename) == 0))
-    return;
+  NcmMSetCatalogColFile *cf = g_slice_new0 (NcmMSetCatalogColFile);
 
-  _ncm_mset_catalog_close_file (mcat);
+  cf->fd       = fd;
+  cf->readonly = readonly;
+  cf->blocks   = g_ptr_array_new_with_free_func ((GDestroyNotify) &_ncm_mset_catalog_col_block_free);
 
-  g_clear_pointer (&mcat->file, g_free);
-  g_clear_pointer (&mcat->mset_file, g_free);
+  return cf;
+}
 
-  if (filename == NULL)
+static void
+_ncm_mset_catalog_col_file_map_header (NcmMSetCatalogColFile *cf, gsize data_offset, guint ncols, guint64 block_rows)
+{
+  cf->header     = _ncm_mset_catalog_col_file_mmap (cf, data_offset, 0);
+  cf->meta       = ((gchar *) cf->header) + sizeof (NcmMSetCatalogColHeader);
+  cf->meta_size  = data_offset - sizeof (NcmMSetCatalogColHeader);
+  cf->block_size = sizeof (gdouble) * ncols * block_rows;
+}
+
+static void
+_ncm_mset_catalog_col_file_write_meta (NcmMSetCatalogColFile *cf)
+{
+  gsize meta_len = 0;
+  gchar *meta    = NULL;
+
+  if (cf->readonly)
     return;
 
-  mcat->file = g_strdup (filename);
-  {
-    gchar *base_name = ncm_util_basename_fits (mcat->file);
-    mcat->mset_file  = g_strdup_printf ("%s.mset", base_name);
-    g_free (base_name);
-  }
+  meta = g_key_file_to_data (cf->kf, &meta_len, NULL);
 
-  if (mcat->mset != NULL)
-  {
-    _ncm_mset_catalog_open_create_file (mcat, FALSE);
-    ncm_mset_catalog_sync (mcat, TRUE);
-  }
-#else
-  g_error ("ncm_mset_catalog_set_file: cannot set file without cfitsio.");
-#endif /* NUMCOSMO_HAVE_CFITSIO */
+  if (meta_len > cf->meta_size)
+    g_error ("_ncm_mset_catalog_col_file_write_meta: catalog metadata (%"G_GSIZE_FORMAT" bytes) does not fit in the file header (%"G_GSIZE_FORMAT" bytes).",
+             meta_len, cf->meta_size);
 
-  mcat->first_flush = TRUE;
-}
+  memcpy (cf->meta, meta, meta_len);
+  cf->header->meta_len = meta_len;
 
-/**
- * ncm_mset_catalog_set_sync_mode:
- * @mcat: a #NcmMSetCatalog
- * @smode: sync mode
- *
- * Sets the sync mode to @smode.
- *
- */
-void
-ncm_mset_catalog_set_sync_mode (NcmMSetCatalog *mcat, NcmMSetCatalogSync smode)
-{
-  mcat->smode = smode;
+  g_free (meta);
 }
 
-/**
- * ncm_mset_catalog_set_sync_interval:
- * @mcat: a #NcmMSetCatalog
- * @interval: Minimum time interval between syncs
- *
- * Sets the minimum time interval between syncs.
- *
- */
-void
-ncm_mset_catalog_set_sync_interval (NcmMSetCatalog *mcat, gdouble interval)
+static NcmMSetCatalogColFile *
+_ncm_mset_catalog_col_file_create (const gchar *filename, guint ncols, GKeyFile *kf)
 {
-  mcat->sync_interval = interval;
+  const gsize page_size = sysconf (_SC_PAGESIZE);
+  gint fd               = g_open (filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  NcmMSetCatalogColFile *cf;
+  gsize data_offset;
+  gsize meta_len;
+  gchar *meta;
+
+  if (fd < 0)
+    g_error ("_ncm_mset_catalog_col_file_create: cannot create file `%s': %s.", filename, g_strerror (errno));
+
+  meta        = g_key_file_to_data (kf, &meta_len, NULL);
+  data_offset = sizeof (NcmMSetCatalogColHeader) + 2 * meta_len + NCM_MSET_CATALOG_COL_META_SLACK;
+  data_offset = ((data_offset + page_size - 1) / page_size) * page_size;
+  g_free (meta);
+
+  if (ftruncate (fd, data_offset) != 0)
+    g_error ("_ncm_mset_catalog_col_file_create: cannot resize file `%s': %s.", filename, g_strerror (errno));
+
+  cf     = _ncm_mset_catalog_col_file_alloc (fd, FALSE);
+  cf->kf = g_key_file_ref (kf);
+  _ncm_mset_catalog_col_file_map_header (cf, data_offset, ncols, NCM_MSET_CATALOG_COL_BLOCK_ROWS);
+
+  memcpy (cf->header->magic, NCM_MSET_CATALOG_COL_MAGIC, sizeof (cf->header->magic));
+  cf->header->endian      = NCM_MSET_CATALOG_COL_ENDIAN;
+  cf->header->ncols       = ncols;
+  cf->header->block_rows  = NCM_MSET_CATALOG_COL_BLOCK_ROWS;
+  cf->header->nrows       = 0;
+  cf->header->data_offset = data_offset;
+
+  _ncm_mset_catalog_col_file_write_meta (cf);
+
+  return cf;
 }
 
-/**
- * ncm_mset_catalog_set_first_id:
- * @mcat: a #NcmMSetCatalog
- * @first_id: the id of the first item in the sample
- *
- * Sets the first id of the catalog, mainly used to inform in which realization the catalog starts.
- *
- */
-void
-ncm_mset_catalog_set_first_id (NcmMSetCatalog *mcat, gint first_id)
+static NcmMSetCatalogColFile *
+_ncm_mset_catalog_col_file_open (const gchar *filename, gboolean readonly)
 {
-  if (first_id == mcat->first_id)
-    return;
+  gint fd       = g_open (filename, readonly ? O_RDONLY : O_RDWR, 0);
+  GError *error = NULL;
+  NcmMSetCatalogColHeader header;
+  NcmMSetCatalogColFile *cf;
+  guint64 nblocks;
+  guint64 b;
 
-  g_assert_cmpint (mcat->file_first_id, ==, mcat->first_id);
-  g_assert_cmpint (mcat->file_cur_id,   ==, mcat->cur_id);
+  if (fd < 0)
+    g_error ("_ncm_mset_catalog_col_file_open: cannot open file `%s': %s.", filename, g_strerror (errno));
 
-  if (!ncm_mset_catalog_is_empty (mcat))
-    g_error ("ncm_mset_catalog_set_first_id: cannot modify first_id to %d in a non-empty catalog, catalog first id: %d, catalog current id: %d.",
-             first_id, mcat->first_id, mcat->cur_id);
+  if (pread (fd, &header, sizeof (header), 0) != sizeof (header))
+    g_error ("_ncm_mset_catalog_col_file_open: cannot read header from `%s'.", filename);
 
-  mcat->first_id = first_id;
-  mcat->cur_id   = first_id - 1;
+  if (memcmp (header.magic, NCM_MSET_CATALOG_COL_MAGIC, sizeof (header.magic)) != 0)
+    g_error ("_ncm_mset_catalog_col_file_open: `%s' is not a columnar catalog file.", filename);
 
-  mcat->file_first_id = first_id;
-  mcat->file_cur_id   = first_id - 1;
-#ifdef NUMCOSMO_HAVE_CFITSIO
-  if (mcat->fptr != NULL)
-  {
-    _ncm_fits_update_key_int (mcat->fptr, NCM_MSET_CATALOG_FIRST_ID_LABEL, mcat->file_first_id, "Id of the first element.", !mcat->readonly);
-    ncm_mset_catalog_sync (mcat, TRUE);
-  }
-#endif /* NUMCOSMO_HAVE_CFITSIO */
+  if (header.endian != NCM_MSET_CATALOG_COL_ENDIAN)
+    g_error ("_ncm_mset_catalog_col_file_open: `%s' was written with a different byte order.", filename);
+
+  cf        = _ncm_mset_catalog_col_file_alloc (fd, readonly);
+  cf->kf    = g_key_file_new ();
+  _ncm_mset_catalog_col_file_map_header (cf, header.data_offset, header.ncols, header.block_rows);
+  cf->nrows = cf->header->nrows;
+
+  if (!g_key_file_load_from_data (cf->kf, cf->meta, cf->header->meta_len, G_KEY_FILE_NONE, &error))
+    g_error ("_ncm_mset_catalog_col_file_open: invalid metadata in `%s': %s.", filename, error->message);
+
+  nblocks = (cf->nrows + header.block_rows - 1) / header.block_rows;
+  for (b = 0; b < nblocks; b++)
+    _ncm_mset_catalog_col_file_map_block (cf);
+
+  return cf;
 }
 
-/**
- * ncm_mset_catalog_set_run_type:
- * @mcat: a #NcmMSetCatalog
- * @rtype_str: the run type string
- *
- * Sets the run type string.
- *
- */
-void
-ncm_mset_catalog_set_run_type (NcmMSetCatalog *mcat, const gchar *rtype_str)
+static void
+_ncm_mset_catalog_col_file_flush (NcmMSetCatalogColFile *cf, gboolean wait)
 {
-  g_assert (rtype_str != NULL);
+  const gint flags = wait ? MS_SYNC : MS_ASYNC;
+  guint b;
 
-  if (mcat->rtype_str != NULL)
-  {
-    if (strcmp (mcat->rtype_str, rtype_str) != 0)
-    {
-      if (!ncm_mset_catalog_is_empty (mcat))
-        g_error ("ncm_mset_catalog_set_run_type: cannot change run type string in a non-empty catalog, actual: `%s' new: `%s'.",
-                 mcat->rtype_str, rtype_str);
-      else
-      {
-        g_clear_pointer (&mcat->rtype_str, g_free);
-      }
-    }
-    else
-      return;
-  }
+  if (cf->readonly)
+    return;
 
-  mcat->rtype_str = g_strdup (rtype_str);
-#ifdef NUMCOSMO_HAVE_CFITSIO
-  if (mcat->fptr != NULL)
+  for (b = 0; b < cf->blocks->len; b++)
   {
-    _ncm_fits_update_key_str (mcat->fptr, NCM_MSET_CATALOG_RTYPE_LABEL, mcat->rtype_str, NULL, !mcat->readonly);
+    NcmMSetCatalogColBlock *block = g_ptr_array_index (cf->blocks, b);
+    msync (block->data, block->size, flags);
   }
-#endif /* NUMCOSMO_HAVE_CFITSIO */
+
+  cf->header->nrows = cf->nrows;
+  msync (cf->header, cf->header->data_offset, flags);
 }
 
-/**
- * ncm_mset_catalog_set_rng:
- * @mcat: a #NcmMSetCatalog
- * @rng: a #NcmRNG
- *
- * Sets the random number generator.
- *
- */
-void
-ncm_mset_catalog_set_rng (NcmMSetCatalog *mcat, NcmRNG *rng)
+static void
+_ncm_mset_catalog_col_file_close (NcmMSetCatalogColFile *cf)
 {
-  if (!ncm_mset_catalog_is_empty (mcat))
-    g_warning ("ncm_mset_catalog_set_rng: setting RNG in a non-empty catalog, catalog first id: %d, catalog current id: %d.",
-             mcat->first_id, mcat->cur_id);
-
-  mcat->rng = ncm_rng_ref (rng);
+  _ncm_mset_catalog_col_file_flush (cf, TRUE);
 
-  g_clear_pointer (&mcat->rng_inis, g_free);
-  g_clear_pointer (&mcat->rng_stat, g_free);
-  
-  mcat->rng_inis = ncm_rng_get_state (rng);
-  mcat->rng_stat = g_strdup (mcat->rng_inis);
-#ifdef NUMCOSMO_HAVE_CFITSIO
-  if (mcat->fptr != NULL)
-  {
-    _ncm_mset_catalog_sync_rng (mcat);
+  g_ptr_array_unref (cf->blocks);
+  munmap (cf->header, cf->header->data_offset);
+  close (cf->fd);
+  g_key_file_unref (cf->kf);
 
-    if (!mcat->readonly)
-    {
-      gint status = 0;
-      fits_flush_file (mcat->fptr, &status);
-      NCM_FITS_ERROR (status);
-    }
-  }
-#endif /* NUMCOSMO_HAVE_CFITSIO */
+  g_slice_free (NcmMSetCatalogColFile, cf);
 }
 
-#ifdef NUMCOSMO_HAVE_CFITSIO
 static void
-_ncm_mset_catalog_flush_file (NcmMSetCatalog *mcat)
+_ncm_mset_catalog_col_file_append (NcmMSetCatalogColFile *cf, NcmVector *row)
 {
-  gint status = 0;
-  /*gint64 nrows = mcat->file_cur_id - mcat->file_first_id + 1;*/
+  const guint64 block_rows = cf->header->block_rows;
+  const guint64 b          = cf->nrows / block_rows;
+  const guint64 r          = cf->nrows % block_rows;
+  const guint ncols        = cf->header->ncols;
+  NcmMSetCatalogColBlock *block;
+  guint c;
 
-  /*printf ("# Flush: Updating to %ld nrows AXIS2!\n", nrows);*/
-  /*fits_update_key (mcat->fptr, TLONGLONG, NCM_MSET_CATALOG_NROWS_LABEL, &nrows, NULL, &status);*/
-  /*NCM_FITS_ERROR (status);*/
+  g_assert_cmpuint (ncm_vector_len (row), ==, ncols);
+
+  if (b == cf->blocks->len)
+  {
+    if (ftruncate (cf->fd, cf->header->data_offset + (b + 1) * cf->block_size) != 0)
+      g_error ("_ncm_mset_catalog_col_file_append: cannot resize file: %s.", g_strerror (errno));
+    _ncm_mset_catalog_col_file_map_block (cf);
+  }
+
+  block = g_ptr_array_index (cf->blocks, b);
+  for (c = 0; c < ncols; c++)
+    block->data[c * block_rows + r] = ncm_vector_get (row, c);
+
+  cf->nrows++;
+}
+
+static NcmVectorView
+_ncm_mset_catalog_col_file_peek_row (NcmMSetCatalogColFile *cf, guint64 i)
+{
+  const guint64 block_rows      = cf->header->block_rows;
+  NcmMSetCatalogColBlock *block = g_ptr_array_index (cf->blocks, i / block_rows);
+  NcmVectorView row;
+
+  g_assert_cmpuint (i, <, cf->nrows);
+
+  row.vv = gsl_vector_view_array_with_stride (&block->data[i % block_rows], block_rows, cf->header->ncols);
+
+  return row;
+}
+
+/*
+ * Column p of the catalog rows, i.e., starting after the burnin. It is only
+ * valid when the file contains all the catalog rows, see
+ * _ncm_mset_catalog_col_file_synced().
+ */
+static const gdouble *
+_ncm_mset_catalog_col_file_peek_col (gpointer userdata, guint p, guint i, guint *n)
+{
+  NcmMSetCatalog *mcat          = NCM_MSET_CATALOG (userdata);
+  NcmMSetCatalogColFile *cf     = mcat->cfile;
+  const guint64 block_rows      = cf->header->block_rows;
+  const guint64 fi              = (guint64) i + mcat->burnin;
+  const guint64 r               = fi % block_rows;
+  NcmMSetCatalogColBlock *block = g_ptr_array_index (cf->blocks, fi / block_rows);
+
+  g_assert_cmpuint (fi, <, cf->nrows);
+
+  n[0] = GSL_MIN (block_rows - r, cf->nrows - fi);
+
+  return &block->data[p * block_rows + r];
+}
+
+static gboolean
+_ncm_mset_catalog_col_file_synced (NcmMSetCatalog *mcat)
+{
+  return (mcat->cfile != NULL) && (mcat->cfile->nrows == (guint64) mcat->pstats->nitens + mcat->burnin);
+}
+
+static gint
+_ncm_mset_catalog_col_get_integer (GKeyFile *kf, const gchar *key)
+{
+  GError *error = NULL;
+  gint val      = g_key_file_get_integer (kf, NCM_MSET_CATALOG_COL_GROUP, key, &error);
+
+  if (error != NULL)
+    g_error ("_ncm_mset_catalog_col_get_integer: %s", error->message);
+
+  return val;
+}
+
+static gchar *
+_ncm_mset_catalog_col_get_string (GKeyFile *kf, const gchar *key)
+{
+  GError *error = NULL;
+  gchar *val    = g_key_file_get_string (kf, NCM_MSET_CATALOG_COL_GROUP, key, &error);
+
+  if (error != NULL)
+    g_error ("_ncm_mset_catalog_col_get_string: %s", error->message);
+
+  return val;
+}
+
+static gchar **
+_ncm_mset_catalog_col_get_string_list (GKeyFile *kf, const gchar *key, gsize *len)
+{
+  GError *error = NULL;
+  gchar **val   = g_key_file_get_string_list (kf, NCM_MSET_CATALOG_COL_GROUP, key, len, &error);
+
+  if (error != NULL)
+    g_error ("_ncm_mset_catalog_col_get_string_list: %s", error->message);
+
+  return val;
+}
+
+static void
+_ncm_mset_catalog_col_set_mset (NcmMSetCatalog *mcat)
+{
+  NcmSerialize *ser = ncm_serialize_new (NCM_SERIALIZE_OPT_NONE);
+  gchar *mset_ser   = ncm_serialize_to_string (ser, G_OBJECT (mcat->mset), TRUE);
+
+  g_key_file_set_string (mcat->cfile->kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_COL_MSET_LABEL, mset_ser);
+
+  g_free (mset_ser);
+  ncm_serialize_free (ser);
+}
+
+static void
+_ncm_mset_catalog_col_sync_rng (NcmMSetCatalog *mcat)
+{
+  GKeyFile *kf = mcat->cfile->kf;
+
+  if (g_key_file_has_key (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_RNG_ALGO_LABEL, NULL))
+  {
+    gchar *algo = _ncm_mset_catalog_col_get_string (kf, NCM_MSET_CATALOG_RNG_ALGO_LABEL);
+    gchar *inis = _ncm_mset_catalog_col_get_string (kf, NCM_MSET_CATALOG_RNG_INIS_LABEL);
+
+    if (mcat->rng != NULL)
+    {
+      const gchar *cat_algo = ncm_rng_get_algo (mcat->rng);
+      g_assert_cmpstr (cat_algo, ==, algo);
+      g_assert_cmpstr (inis, ==, mcat->rng_inis);
+    }
+    else
+    {
+      NcmRNG *rng = ncm_rng_new (algo);
+      ncm_rng_set_state (rng, inis);
+      ncm_mset_catalog_set_rng (mcat, rng);
+      ncm_rng_free (rng);
+    }
+
+    g_free (algo);
+    g_free (inis);
+  }
+  else if (mcat->rng != NULL)
+  {
+    gchar *seed = g_strdup_printf ("%lu", ncm_rng_get_seed (mcat->rng));
+
+    g_key_file_set_string (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_RNG_ALGO_LABEL, ncm_rng_get_algo (mcat->rng));
+    g_key_file_set_string (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_RNG_SEED_LABEL, seed);
+    g_key_file_set_string (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_RNG_INIS_LABEL, mcat->rng_inis);
+    _ncm_mset_catalog_col_file_write_meta (mcat->cfile);
+
+    g_free (seed);
+  }
+}
+
+static void
+_ncm_mset_catalog_open_create_col_file (NcmMSetCatalog *mcat, gboolean load_from_cat)
+{
+  guint i;
+
+  g_assert (mcat->file != NULL);
+  g_assert (mcat->cfile == NULL);
+
+  if (g_file_test (mcat->file, G_FILE_TEST_EXISTS))
+  {
+    NcmMSetCatalogColFile *cf = _ncm_mset_catalog_col_file_open (mcat->file, mcat->readonly);
+    GKeyFile *kf              = cf->kf;
+    gchar *rtype_str          = _ncm_mset_catalog_col_get_string (kf, NCM_MSET_CATALOG_RTYPE_LABEL);
+    const gint nchains        = _ncm_mset_catalog_col_get_integer (kf, NCM_MSET_CATALOG_NCHAINS_LABEL);
+    const gint nadd_vals      = _ncm_mset_catalog_col_get_integer (kf, NCM_MSET_CATALOG_NADDVAL_LABEL);
+    const gboolean weighted   = _ncm_mset_catalog_col_get_integer (kf, NCM_MSET_CATALOG_WEIGHTED_LABEL) ? TRUE : FALSE;
+    gsize ncolumns            = 0;
+    gsize nasymbs             = 0;
+    gchar **columns           = _ncm_mset_catalog_col_get_string_list (kf, NCM_MSET_CATALOG_COL_COLUMNS_LABEL, &ncolumns);
+    gchar **asymbs            = _ncm_mset_catalog_col_get_string_list (kf, NCM_MSET_CATALOG_ASYMB_LABEL, &nasymbs);
+    glong nrows;
+
+    mcat->cfile         = cf;
+    mcat->file_first_id = _ncm_mset_catalog_col_get_integer (kf, NCM_MSET_CATALOG_FIRST_ID_LABEL);
+
+    g_assert_cmpint (nchains, >, 0);
+    g_assert_cmpuint (nasymbs, ==, nadd_vals);
+    g_assert_cmpuint (ncolumns, ==, cf->header->ncols);
+
+    if (load_from_cat)
+    {
+      NcmSerialize *ser = ncm_serialize_global ();
+      gchar *mset_ser   = _ncm_mset_catalog_col_get_string (kf, NCM_MSET_CATALOG_COL_MSET_LABEL);
+
+      mcat->mset = NCM_MSET (ncm_serialize_from_string (ser, mset_ser));
+      ncm_mset_prepare_fparam_map (mcat->mset);
+
+      ncm_mset_catalog_set_run_type (mcat, rtype_str);
+      mcat->nchains   = nchains;
+      mcat->nadd_vals = nadd_vals;
+      mcat->weighted  = weighted;
+
+      for (i = 0; i < nadd_vals; i++)
+      {
+        g_ptr_array_add (mcat->add_vals_names, g_strdup (columns[i]));
+        g_ptr_array_add (mcat->add_vals_symbs, g_strdup (asymbs[i]));
+      }
+
+      g_free (mset_ser);
+      ncm_serialize_free (ser);
+    }
+    else
+    {
+      if (strcmp (mcat->rtype_str, rtype_str) != 0)
+        g_error ("_ncm_mset_catalog_open_create_col_file: incompatible run type strings from catalog and file, catalog: `%s' file: `%s'.",
+                 mcat->rtype_str, rtype_str);
+      if (nchains != mcat->nchains)
+        g_error ("_ncm_mset_catalog_open_create_col_file: catalog has %d chains and file contains %d.", mcat->nchains, nchains);
+      if (nadd_vals != mcat->nadd_vals)
+        g_error ("_ncm_mset_catalog_open_create_col_file: catalog has %d additional values and file contains %d.", mcat->nadd_vals, nadd_vals);
+      if ((weighted && !mcat->weighted) || (!weighted && mcat->weighted))
+        g_error ("_ncm_mset_catalog_open_create_col_file: catalog %s weighted and file %s.",
+                 mcat->weighted ? "is" : "is not",
+                 weighted ? "is" : "is not");
+
+      for (i = 0; i < nadd_vals; i++)
+      {
+        if ((strcmp (g_ptr_array_index (mcat->add_vals_names, i), columns[i]) != 0) ||
+            (strcmp (g_ptr_array_index (mcat->add_vals_symbs, i), asymbs[i]) != 0))
+          g_error ("_ncm_mset_catalog_open_create_col_file: additional column %d does not match, catalog: `%s' file: `%s'.",
+                   i + 1, (gchar *) g_ptr_array_index (mcat->add_vals_names, i), columns[i]);
+      }
+    }
+
+    /*
+     * The columnar backend does not remap columns, the free parameters in
+     * the file must match the ones in the mset.
+     */
+    {
+      const guint fparam_len = ncm_mset_fparam_len (mcat->mset);
+      
+      if (fparam_len + mcat->nadd_vals != ncolumns)
+        g_error ("_ncm_mset_catalog_open_create_col_file: file has %"G_GSIZE_FORMAT" columns and catalog %u.",
+                 ncolumns, fparam_len + mcat->nadd_vals);
+        
+      for (i = 0; i < fparam_len; i++)
+      {
+        const gchar *fparam_fullname = ncm_mset_fparam_full_name (mcat->mset, i);
+        if (strcmp (fparam_fullname, columns[mcat->nadd_vals + i]) != 0)
+          g_error ("_ncm_mset_catalog_open_create_col_file: column `%s' does not match the free parameter `%s'.",
+                   columns[mcat->nadd_vals + i], fparam_fullname);
+      }
+
+      g_array_set_size (mcat->porder, ncolumns);
+      for (i = 0; i < ncolumns; i++)
+        g_array_index (mcat->porder, gint, i) = i + 1;
+    }
+
+    nrows = cf->nrows;
+    if (nrows < mcat->burnin)
+    {
+      g_error ("_ncm_mset_catalog_open_create_col_file: burnin larger than the catalogue size %ld <=> %ld",
+               mcat->burnin, nrows);
+    }
+    else
+    {
+      nrows -= mcat->burnin;
+    }
+
+    if (mcat->file_first_id != mcat->first_id)
+    {
+      if (nrows == 0)
+      {
+        mcat->file_first_id = mcat->first_id;
+      }
+      else if (ncm_mset_catalog_is_empty (mcat))
+      {
+        mcat->first_id = mcat->file_first_id;
+        mcat->cur_id   = mcat->file_first_id - 1;
+      }
+    }
+    mcat->file_cur_id = mcat->file_first_id + nrows - 1;
+
+    g_free (rtype_str);
+    g_strfreev (columns);
+    g_strfreev (asymbs);
+  }
+  else
+  {
+    const guint fparam_len = ncm_mset_fparam_len (mcat->mset);
+    const guint ncols      = fparam_len + mcat->nadd_vals;
+    GKeyFile *kf           = g_key_file_new ();
+    GPtrArray *columns     = g_ptr_array_sized_new (ncols + 1);
+    GPtrArray *fsymbs      = g_ptr_array_sized_new (fparam_len + 1);
+    
+    for (i = 0; i < mcat->nadd_vals; i++)
+    {
+      g_ptr_array_add (columns, g_ptr_array_index (mcat->add_vals_names, i));
+      g_array_index (mcat->porder, gint, i) = columns->len;
+    }
+
+    for (i = 0; i < fparam_len; i++)
+    {
+      g_ptr_array_add (columns, (gchar *) ncm_mset_fparam_full_name (mcat->mset, i));
+      g_ptr_array_add (fsymbs, (gchar *) ncm_mset_fparam_symbol (mcat->mset, i));
+      g_array_index (mcat->porder, gint, i + mcat->nadd_vals) = columns->len;
+    }
+
+    g_key_file_set_string (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_RTYPE_LABEL, mcat->rtype_str);
+    g_key_file_set_integer (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_NCHAINS_LABEL, mcat->nchains);
+    g_key_file_set_integer (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_NADDVAL_LABEL, mcat->nadd_vals);
+    g_key_file_set_integer (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_WEIGHTED_LABEL, mcat->weighted ? 1 : 0);
+    g_key_file_set_integer (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_FIRST_ID_LABEL, mcat->first_id);
+    g_key_file_set_string_list (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_COL_COLUMNS_LABEL, (const gchar * const *) columns->pdata, columns->len);
+    g_key_file_set_string_list (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_ASYMB_LABEL, (const gchar * const *) mcat->add_vals_symbs->pdata, mcat->nadd_vals);
+    g_key_file_set_string_list (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_FSYMB_LABEL, (const gchar * const *) fsymbs->pdata, fsymbs->len);
+
+    mcat->cfile = _ncm_mset_catalog_col_file_create (mcat->file, ncols, kf);
+    _ncm_mset_catalog_col_set_mset (mcat);
+
+    mcat->file_first_id = mcat->first_id;
+    mcat->file_cur_id   = mcat->first_id - 1;
+
+    g_ptr_array_unref (columns);
+    g_ptr_array_unref (fsymbs);
+    g_key_file_unref (kf);
+  }
+
+  _ncm_mset_catalog_col_sync_rng (mcat);
+
+  g_key_file_set_integer (mcat->cfile->kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_FIRST_ID_LABEL, mcat->file_first_id);
+  _ncm_mset_catalog_col_file_write_meta (mcat->cfile);
+  _ncm_mset_catalog_col_file_flush (mcat->cfile, TRUE);
+}
+
+static void
+_ncm_mset_catalog_col_close_file (NcmMSetCatalog *mcat)
+{
+  /* After dispose the data and the mset were already saved. */
+  if ((mcat->pstats != NULL) && (mcat->mset != NULL))
+  {
+    ncm_mset_catalog_sync (mcat, FALSE);
+
+    if (!mcat->readonly)
+    {
+      _ncm_mset_catalog_col_set_mset (mcat);
+      _ncm_mset_catalog_col_file_write_meta (mcat->cfile);
+    }
+  }
+
+  _ncm_mset_catalog_col_file_close (mcat->cfile);
+  mcat->cfile = NULL;
+}
+
+static void _ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x);
+
+static void
+_ncm_mset_catalog_col_sync (NcmMSetCatalog *mcat, gboolean check)
+{
+  NcmMSetCatalogColFile *cf = mcat->cfile;
+  GKeyFile *kf              = cf->kf;
+  gboolean need_flush       = FALSE;
+  guint i;
+
+  if (check)
+  {
+    if ((mcat->file_cur_id < mcat->first_id - 1) || (mcat->cur_id < mcat->file_first_id - 1))
+      g_error ("ncm_mset_catalog_sync: file data & catalog mismatch, they do not intersect each other: file data [%d, %d] catalog [%d, %d]",
+               mcat->file_first_id, mcat->file_cur_id,
+               mcat->first_id, mcat->cur_id);
+  }
+
+  if (mcat->file_first_id != mcat->first_id)
+    g_error ("ncm_mset_catalog_sync: columnar catalog files cannot be prepended, file data [%d, %d] catalog [%d, %d]",
+             mcat->file_first_id, mcat->file_cur_id,
+             mcat->first_id, mcat->cur_id);
+
+  if (mcat->file_cur_id < mcat->cur_id)
+  {
+    const guint rows_to_add = mcat->cur_id - mcat->file_cur_id;
+    const guint offset      = mcat->file_cur_id + 1 - mcat->file_first_id;
+
+    g_assert_cmpuint (offset + mcat->burnin, ==, cf->nrows);
+
+    for (i = 0; i < rows_to_add; i++)
+    {
+      NcmVector *row = ncm_stats_vec_peek_row (mcat->pstats, offset + i);
+      _ncm_mset_catalog_col_file_append (cf, row);
+    }
+    mcat->file_cur_id = mcat->cur_id;
+
+    if (mcat->rng != NULL)
+    {
+      g_clear_pointer (&mcat->rng_stat, g_free);
+      mcat->rng_stat = ncm_rng_get_state (mcat->rng);
+
+      g_key_file_set_string (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_RNG_STAT_LABEL, mcat->rng_stat);
+      _ncm_mset_catalog_col_file_write_meta (cf);
+    }
+    need_flush = TRUE;
+  }
+  else if (mcat->file_cur_id > mcat->cur_id)
+  {
+    const guint rows_to_add        = mcat->file_cur_id - mcat->cur_id;
+    const guint offset             = mcat->cur_id + 1 - mcat->first_id;
+    const NcmMSetCatalogSync smode = mcat->smode;
+
+    /*
+     * Each row is copied from its view of the mapped block to the contiguous
+     * row kept by the #NcmStatsVec's, as for FITS files.
+     */
+    mcat->smode = NCM_MSET_CATALOG_SYNC_DISABLE;
+    for (i = 0; i < rows_to_add; i++)
+    {
+      NcmVectorView row_i = _ncm_mset_catalog_col_file_peek_row (cf, offset + i + mcat->burnin);
+      NcmVector *row      = ncm_vector_new (ncm_vector_view_len (&row_i));
+
+      gsl_vector_memcpy (ncm_vector_gsl (row), ncm_vector_view_gsl (&row_i));
+      _ncm_mset_catalog_post_update (mcat, row);
+      ncm_vector_free (row);
+    }
+    mcat->smode = smode;
+
+    g_assert_cmpint (mcat->cur_id, ==, mcat->file_cur_id);
+
+    if ((mcat->rng != NULL) && g_key_file_has_key (kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_RNG_STAT_LABEL, NULL))
+    {
+      g_clear_pointer (&mcat->rng_stat, g_free);
+      mcat->rng_stat = _ncm_mset_catalog_col_get_string (kf, NCM_MSET_CATALOG_RNG_STAT_LABEL);
+
+      ncm_rng_set_state (mcat->rng, mcat->rng_stat);
+    }
+  }
+
+  if (need_flush)
+  {
+    _ncm_mset_catalog_col_file_flush (cf, mcat->first_flush);
+    mcat->first_flush = FALSE;
+  }
+}
+
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
+
+/*
+ * Values of the column p starting at the catalog row i. When all rows are in
+ * a columnar file the n values up to the end of the block are read in place
+ * from the mapping, otherwise n is one and the value comes from the saved
+ * row.
+ */
+static const gdouble *
+_ncm_mset_catalog_peek_col_run (NcmMSetCatalog *mcat, guint p, guint i, guint *n)
+{
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+  if (_ncm_mset_catalog_col_file_synced (mcat))
+    return _ncm_mset_catalog_col_file_peek_col (mcat, p, i, n);
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
+
+  n[0] = 1;
+  return ncm_vector_const_ptr (ncm_stats_vec_peek_row (mcat->pstats, i), p);
+}
+
+static gboolean
+_ncm_mset_catalog_is_col_file (const gchar *filename)
+{
+  return g_str_has_suffix (filename, NCM_MSET_CATALOG_COL_EXT);
+}
+
+static void
+_ncm_mset_catalog_open_file (NcmMSetCatalog *mcat, gboolean load_from_cat)
+{
+  if (_ncm_mset_catalog_is_col_file (mcat->file))
+  {
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+    _ncm_mset_catalog_open_create_col_file (mcat, load_from_cat);
+#else
+    g_error ("_ncm_mset_catalog_open_file: columnar catalogs require mmap support.");
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
+  }
+  else
+  {
+#ifdef NUMCOSMO_HAVE_CFITSIO
+    _ncm_mset_catalog_open_create_file (mcat, load_from_cat);
+#else
+    g_error ("_ncm_mset_catalog_open_file: cannot open fits catalogs without cfitsio.");
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+  }
+}
+
+static void
+_ncm_mset_catalog_set_add_val_name_array (NcmMSetCatalog *mcat, gchar **names)
+{
+  if (names != NULL)
+  {
+    const guint len = g_strv_length (names);
+    guint i;
+
+    g_ptr_array_set_size (mcat->add_vals_names, len);
+
+    for (i = 0; i < len; i++)
+    {
+      g_clear_pointer (&g_ptr_array_index (mcat->add_vals_names, i), g_free);
+      g_ptr_array_index (mcat->add_vals_names, i) = g_strdup (names[i]);
+    }
+  }
+  else
+    g_ptr_array_set_size (mcat->add_vals_names, 0);
+}
+
+static void
+_ncm_mset_catalog_set_add_val_symbol_array (NcmMSetCatalog *mcat, gchar **symbols)
+{
+  if (symbols != NULL)
+  {
+    const guint len = g_strv_length (symbols);
+    guint i;
+
+    g_ptr_array_set_size (mcat->add_vals_symbs, len);
+
+    for (i = 0; i < len; i++)
+    {
+      g_clear_pointer (&g_ptr_array_index (mcat->add_vals_symbs, i), g_free);
+      g_ptr_array_index (mcat->add_vals_symbs, i) = g_strdup (symbols[i]);
+    }
+  }
+  else
+    g_ptr_array_set_size (mcat->add_vals_symbs, 0);
+}
+
+/**
+ * ncm_mset_catalog_set_file:
+ * @mcat: a #NcmMSetCatalog
+ * @filename: a filename
+ *
+ * Sets the data filename to be used to sync/save data.
+ *
+ */
+void
+ncm_mset_catalog_set_file (NcmMSetCatalog *mcat, const gchar *filename)
+{
+  if (!mcat->constructed)
+  {
+    if (mcat->file != NULL)
+      g_error ("ncm_mset_catalog_set_file: Unknown error.");
+    mcat->file = g_strdup (filename);
+  }
+  
+  if ((mcat->file != NULL) && (filename != NULL) && (strcmp (mcat->file, filename) == 0))
+    return;
+
+  _ncm_mset_catalog_close_file (mcat);
+
+  g_clear_pointer (&mcat->file, g_free);
+  g_clear_pointer (&mcat->mset_file, g_free);
+
+  if (filename == NULL)
+    return;
+
+  mcat->file = g_strdup (filename);
+  if (!_ncm_mset_catalog_is_col_file (mcat->file))
+  {
+    gchar *base_name = ncm_util_basename_fits (mcat->file);
+    mcat->mset_file  = g_strdup_printf ("%s.mset", base_name);
+    g_free (base_name);
+  }
+
+  if (mcat->mset != NULL)
+  {
+    _ncm_mset_catalog_open_file (mcat, FALSE);
+    ncm_mset_catalog_sync (mcat, TRUE);
+  }
+
+  mcat->first_flush = TRUE;
+}
+
+/**
+ * ncm_mset_catalog_set_sync_mode:
+ * @mcat: a #NcmMSetCatalog
+ * @smode: sync mode
+ *
+ * Sets the sync mode to @smode.
+ *
+ */
+void
+ncm_mset_catalog_set_sync_mode (NcmMSetCatalog *mcat, NcmMSetCatalogSync smode)
+{
+  mcat->smode = smode;
+}
+
+/**
+ * ncm_mset_catalog_set_sync_interval:
+ * @mcat: a #NcmMSetCatalog
+ * @interval: Minimum time interval between syncs
+ *
+ * Sets the minimum time interval between syncs.
+ *
+ */
+void
+ncm_mset_catalog_set_sync_interval (NcmMSetCatalog *mcat, gdouble interval)
+{
+  mcat->sync_interval = interval;
+}
+
+/**
+ * ncm_mset_catalog_set_first_id:
+ * @mcat: a #NcmMSetCatalog
+ * @first_id: the id of the first item in the sample
+ *
+ * Sets the first id of the catalog, mainly used to inform in which realization the catalog starts.
+ *
+ */
+void
+ncm_mset_catalog_set_first_id (NcmMSetCatalog *mcat, gint first_id)
+{
+  if (first_id == mcat->first_id)
+    return;
+
+  g_assert_cmpint (mcat->file_first_id, ==, mcat->first_id);
+  g_assert_cmpint (mcat->file_cur_id,   ==, mcat->cur_id);
+
+  if (!ncm_mset_catalog_is_empty (mcat))
+    g_error ("ncm_mset_catalog_set_first_id: cannot modify first_id to %d in a non-empty catalog, catalog first id: %d, catalog current id: %d.",
+             first_id, mcat->first_id, mcat->cur_id);
+
+  mcat->first_id = first_id;
+  mcat->cur_id   = first_id - 1;
+
+  mcat->file_first_id = first_id;
+  mcat->file_cur_id   = first_id - 1;
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  if (mcat->fptr != NULL)
+  {
+    _ncm_fits_update_key_int (mcat->fptr, NCM_MSET_CATALOG_FIRST_ID_LABEL, mcat->file_first_id, "Id of the first element.", !mcat->readonly);
+    ncm_mset_catalog_sync (mcat, TRUE);
+  }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+  if (mcat->cfile != NULL)
+  {
+    g_key_file_set_integer (mcat->cfile->kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_FIRST_ID_LABEL, mcat->file_first_id);
+    _ncm_mset_catalog_col_file_write_meta (mcat->cfile);
+    ncm_mset_catalog_sync (mcat, TRUE);
+  }
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
+}
+
+/**
+ * ncm_mset_catalog_set_run_type:
+ * @mcat: a #NcmMSetCatalog
+ * @rtype_str: the run type string
+ *
+ * Sets the run type string.
+ *
+ */
+void
+ncm_mset_catalog_set_run_type (NcmMSetCatalog *mcat, const gchar *rtype_str)
+{
+  g_assert (rtype_str != NULL);
+
+  if (mcat->rtype_str != NULL)
+  {
+    if (strcmp (mcat->rtype_str, rtype_str) != 0)
+    {
+      if (!ncm_mset_catalog_is_empty (mcat))
+        g_error ("ncm_mset_catalog_set_run_type: cannot change run type string in a non-empty catalog, actual: `%s' new: `%s'.",
+                 mcat->rtype_str, rtype_str);
+      else
+      {
+        g_clear_pointer (&mcat->rtype_str, g_free);
+      }
+    }
+    else
+      return;
+  }
+
+  mcat->rtype_str = g_strdup (rtype_str);
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  if (mcat->fptr != NULL)
+  {
+    _ncm_fits_update_key_str (mcat->fptr, NCM_MSET_CATALOG_RTYPE_LABEL, mcat->rtype_str, NULL, !mcat->readonly);
+  }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+  if (mcat->cfile != NULL)
+  {
+    g_key_file_set_string (mcat->cfile->kf, NCM_MSET_CATALOG_COL_GROUP, NCM_MSET_CATALOG_RTYPE_LABEL, mcat->rtype_str);
+    _ncm_mset_catalog_col_file_write_meta (mcat->cfile);
+  }
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
+}
+
+/**
+ * ncm_mset_catalog_set_rng:
+ * @mcat: a #NcmMSetCatalog
+ * @rng: a #NcmRNG
+ *
+ * Sets the random number generator.
+ *
+ */
+void
+ncm_mset_catalog_set_rng (NcmMSetCatalog *mcat, NcmRNG *rng)
+{
+  if (!ncm_mset_catalog_is_empty (mcat))
+    g_warning ("ncm_mset_catalog_set_rng: setting RNG in a non-empty catalog, catalog first id: %d, catalog current id: %d.",
+             mcat->first_id, mcat->cur_id);
+
+  mcat->rng = ncm_rng_ref (rng);
+
+  g_clear_pointer (&mcat->rng_inis, g_free);
+  g_clear_pointer (&mcat->rng_stat, g_free);
+  
+  mcat->rng_inis = ncm_rng_get_state (rng);
+  mcat->rng_stat = g_strdup (mcat->rng_inis);
+#ifdef NUMCOSMO_HAVE_CFITSIO
+  if (mcat->fptr != NULL)
+  {
+    _ncm_mset_catalog_sync_rng (mcat);
+
+    if (!mcat->readonly)
+    {
+      gint status = 0;
+      fits_flush_file (mcat->fptr, &status);
+      NCM_FITS_ERROR (status);
+    }
+  }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+  if (mcat->cfile != NULL)
+  {
+    _ncm_mset_catalog_col_sync_rng (mcat);
+    _ncm_mset_catalog_col_file_flush (mcat->cfile, TRUE);
+  }
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
+}
+
+#ifdef NUMCOSMO_HAVE_CFITSIO
+static void
+_ncm_mset_catalog_flush_file (NcmMSetCatalog *mcat)
+{
+  gint status = 0;
+  /*gint64 nrows = mcat->file_cur_id - mcat->file_first_id + 1;*/
+
+  /*printf ("# Flush: Updating to %ld nrows AXIS2!\n", nrows);*/
+  /*fits_update_key (mcat->fptr, TLONGLONG, NCM_MSET_CATALOG_NROWS_LABEL, &nrows, NULL, &status);*/
+  /*NCM_FITS_ERROR (status);*/
 
   if (G_UNLIKELY (mcat->first_flush))
   {
@@ -1591,12 +2413,23 @@ _ncm_mset_catalog_flush_file (NcmMSetCatalog *mcat)
   }
 }
 
+#endif /* NUMCOSMO_HAVE_CFITSIO */
+
 static void
 _ncm_mset_catalog_close_file (NcmMSetCatalog *mcat)
 {
-  gint status = 0;
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+  if (mcat->cfile != NULL)
+  {
+    _ncm_mset_catalog_col_close_file (mcat);
+    g_clear_pointer (&mcat->file, g_free);
+  }
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
+#ifdef NUMCOSMO_HAVE_CFITSIO
   if (mcat->fptr != NULL)
   {
+    gint status = 0;
+
     ncm_mset_catalog_sync (mcat, FALSE);
     fits_close_file (mcat->fptr, &status);
     NCM_FITS_ERROR (status);
@@ -1604,8 +2437,11 @@ _ncm_mset_catalog_close_file (NcmMSetCatalog *mcat)
     
     g_clear_pointer (&mcat->file, g_free);
   }
+#endif /* NUMCOSMO_HAVE_CFITSIO */
 }
 
+#ifdef NUMCOSMO_HAVE_CFITSIO
+
 static void
 _ncm_mset_catalog_write_row (NcmMSetCatalog *mcat, NcmVector *row, guint row_index)
 {
@@ -1655,6 +2491,13 @@ static void _ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x);
 void
 ncm_mset_catalog_sync (NcmMSetCatalog *mcat, gboolean check)
 {
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+  if (mcat->cfile != NULL)
+  {
+    _ncm_mset_catalog_col_sync (mcat, check);
+    return;
+  }
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
 #ifdef NUMCOSMO_HAVE_CFITSIO
   gint status = 0;
   guint i;
@@ -1902,11 +2745,9 @@ ncm_mset_catalog_reset (NcmMSetCatalog *mcat)
   ncm_vector_set_all (mcat->params_max, GSL_NEGINF);
   ncm_vector_set_all (mcat->params_min, GSL_POSINF);
 
-  mcat->cur_id    = mcat->first_id - 1;
-#ifdef NUMCOSMO_HAVE_CFITSIO
+  mcat->cur_id      = mcat->first_id - 1;
   mcat->file_cur_id = mcat->file_first_id - 1;
   _ncm_mset_catalog_close_file (mcat);
-#endif /* NUMCOSMO_HAVE_CFITSIO */
 }
 
 /**
@@ -1936,6 +2777,15 @@ ncm_mset_catalog_erase_data (NcmMSetCatalog *mcat)
     }
   }
 #endif /* NUMCOSMO_HAVE_CFITSIO */
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+  if (mcat->cfile != NULL)
+  {
+    /* The blocks are kept mapped, they may still be referenced by row views. */
+    mcat->cfile->nrows = mcat->burnin;
+    mcat->file_cur_id  = mcat->file_first_id - 1;
+    _ncm_mset_catalog_col_file_flush (mcat->cfile, TRUE);
+  }
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
 }
 
 /**
@@ -2158,7 +3008,7 @@ ncm_mset_catalog_get_cur_id (NcmMSetCatalog *mcat)
 void 
 ncm_mset_catalog_set_burnin (NcmMSetCatalog *mcat, glong burnin)
 {
-  if (mcat->fptr != NULL)
+  if ((mcat->fptr != NULL) || (mcat->cfile != NULL))
     g_error ("ncm_mset_catalog_set_burnin: cannot set burnin with an already loaded catalog");
   mcat->burnin = burnin;
 }
@@ -2183,12 +3033,20 @@ ncm_mset_catalog_get_burnin (NcmMSetCatalog *mcat)
  * @tau_method: a #NcmMSetCatalogTauMethod
  * 
  * Sets the autocorrelation time method to @tau_method.
+ * 
+ * The methods #NCM_MSET_CATALOG_TAU_METHOD_ONLINE_ACOR and
+ * #NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS enable the online diagnostics
+ * of the parameters statistics (and of the ensemble means when there is
+ * more than one chain), see ncm_stats_vec_enable_online_diag(). In
+ * this case ncm_mset_catalog_estimate_autocorrelation_tau() costs
+ * $O(1)$ in the catalog size.
  *
  */
 void 
 ncm_mset_catalog_set_tau_method (NcmMSetCatalog *mcat, NcmMSetCatalogTauMethod tau_method)
 {
   mcat->tau_method = tau_method;
+  _ncm_mset_catalog_set_online_diag (mcat);
 }
 
 /**
@@ -2203,6 +3061,40 @@ ncm_mset_catalog_get_tau_method (NcmMSetCatalog *mcat)
   return mcat->tau_method;
 }
 
+/**
+ * ncm_mset_catalog_set_fft_nthreads:
+ * @mcat: a #NcmMSetCatalog
+ * @nthreads: number of threads
+ * 
+ * Sets the number of threads used by the batched FFTs of the full catalog
+ * and of each chain, see ncm_stats_vec_set_fft_nthreads(). They are used by
+ * ncm_mset_catalog_estimate_autocorrelation_tau(), ncm_mset_catalog_calc_max_ess_time(),
+ * ncm_mset_catalog_calc_heidel_diag(), ncm_mset_catalog_trim_by_type(),
+ * ncm_mset_catalog_max_ess_time_by_chain() and ncm_mset_catalog_heidel_diag_by_chain().
+ * The transforms are batched over the parameters, each chain and each
+ * test window still runs its own transform.
+ * 
+ */
+void 
+ncm_mset_catalog_set_fft_nthreads (NcmMSetCatalog *mcat, guint nthreads)
+{
+  g_assert_cmpuint (nthreads, >, 0);
+  mcat->fft_nthreads = nthreads;
+  _ncm_mset_catalog_set_fft_nthreads (mcat);
+}
+
+/**
+ * ncm_mset_catalog_get_fft_nthreads:
+ * @mcat: a #NcmMSetCatalog
+ * 
+ * Returns: the number of threads used by the batched FFTs of @mcat.
+ */
+guint 
+ncm_mset_catalog_get_fft_nthreads (NcmMSetCatalog *mcat)
+{
+  return mcat->fft_nthreads;
+}
+
 static void
 _ncm_mset_catalog_post_update (NcmMSetCatalog *mcat, NcmVector *x)
 {
@@ -2689,12 +3581,15 @@ ncm_mset_catalog_log_full_covar (NcmMSetCatalog *mcat)
  * @force_single_chain: whether to force the catalog to be treated as a single chain
  *
  * Updates the internal estimates of the integrate autocorrelation time.
+ * For #NCM_MSET_CATALOG_TAU_METHOD_ACOR and a columnar catalog file
+ * containing all rows, the columns are read in place from the file.
  *
  */
 void
 ncm_mset_catalog_estimate_autocorrelation_tau (NcmMSetCatalog *mcat, gboolean force_single_chain)
 {
   const guint total = ncm_vector_len (mcat->tau);
+  NcmVector *tau_v  = NULL;
   guint p;
   
   if (mcat->nchains == 1 || force_single_chain)
@@ -2702,20 +3597,26 @@ ncm_mset_catalog_estimate_autocorrelation_tau (NcmMSetCatalog *mcat, gboolean fo
     switch (mcat->tau_method)
     {
       case NCM_MSET_CATALOG_TAU_METHOD_ACOR:
-        for (p = 0; p < total; p++)
-        {
-          const gdouble tau = ncm_stats_vec_get_autocorr_tau (mcat->pstats, p, 0);
-          ncm_vector_set (mcat->tau, p, tau);
-        }
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+        if (_ncm_mset_catalog_col_file_synced (mcat))
+          tau_v = ncm_stats_vec_get_autocorr_tau_all_cols (mcat->pstats, &_ncm_mset_catalog_col_file_peek_col, mcat, 1, 0);
+        else
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
+          tau_v = ncm_stats_vec_get_autocorr_tau_all (mcat->pstats, 0);
+        ncm_vector_memcpy (mcat->tau, tau_v);
         break;
       case NCM_MSET_CATALOG_TAU_METHOD_AR_MODEL:
+        tau_v = ncm_stats_vec_ar_ess_all (mcat->pstats, NCM_STATS_VEC_AR_AICC, NULL, NULL);
         for (p = 0; p < total; p++)
-        {
-          gdouble spec0;
-          guint c_order = 0;
-          const gdouble ess = ncm_stats_vec_ar_ess (mcat->pstats, p, NCM_STATS_VEC_AR_AICC, &spec0, &c_order);
-          ncm_vector_set (mcat->tau, p, mcat->pstats->nitens / ess);
-        }
+          ncm_vector_set (mcat->tau, p, mcat->pstats->nitens / ncm_vector_get (tau_v, p));
+        break;
+      case NCM_MSET_CATALOG_TAU_METHOD_ONLINE_ACOR:
+        for (p = 0; p < total; p++)
+          ncm_vector_set (mcat->tau, p, ncm_stats_vec_get_online_autocorr_tau (mcat->pstats, p));
+        break;
+      case NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS:
+        for (p = 0; p < total; p++)
+          ncm_vector_set (mcat->tau, p, ncm_stats_vec_get_online_bm_tau (mcat->pstats, p));
         break;
       default:
         g_assert_not_reached ();
@@ -2727,26 +3628,34 @@ ncm_mset_catalog_estimate_autocorrelation_tau (NcmMSetCatalog *mcat, gboolean fo
     switch (mcat->tau_method)
     {
       case NCM_MSET_CATALOG_TAU_METHOD_ACOR:
-        for (p = 0; p < total; p++)
-        {
-          const gdouble tau = ncm_stats_vec_get_subsample_autocorr_tau (mcat->pstats, p, mcat->nchains, 0);
-          ncm_vector_set (mcat->tau, p, tau);
-        }
+#ifdef NCM_MSET_CATALOG_HAVE_COL
+        if (_ncm_mset_catalog_col_file_synced (mcat))
+          tau_v = ncm_stats_vec_get_autocorr_tau_all_cols (mcat->pstats, &_ncm_mset_catalog_col_file_peek_col, mcat, mcat->nchains, 0);
+        else
+#endif /* NCM_MSET_CATALOG_HAVE_COL */
+          tau_v = ncm_stats_vec_get_subsample_autocorr_tau_all (mcat->pstats, mcat->nchains, 0);
+        ncm_vector_memcpy (mcat->tau, tau_v);
         break;
       case NCM_MSET_CATALOG_TAU_METHOD_AR_MODEL:
+        tau_v = ncm_stats_vec_ar_ess_all (mcat->e_mean_stats, NCM_STATS_VEC_AR_AICC, NULL, NULL);
         for (p = 0; p < total; p++)
-        {
-          gdouble spec0;
-          guint c_order = 0;
-          const gdouble ess = ncm_stats_vec_ar_ess (mcat->e_mean_stats, p, NCM_STATS_VEC_AR_AICC, &spec0, &c_order);
-          ncm_vector_set (mcat->tau, p, mcat->pstats->nitens / (ess * mcat->nchains));
-        }
+          ncm_vector_set (mcat->tau, p, mcat->pstats->nitens / (ncm_vector_get (tau_v, p) * mcat->nchains));
+        break;
+      case NCM_MSET_CATALOG_TAU_METHOD_ONLINE_ACOR:
+        for (p = 0; p < total; p++)
+          ncm_vector_set (mcat->tau, p, ncm_stats_vec_get_online_autocorr_tau (mcat->e_mean_stats, p));
+        break;
+      case NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS:
+        for (p = 0; p < total; p++)
+          ncm_vector_set (mcat->tau, p, ncm_stats_vec_get_online_bm_tau (mcat->e_mean_stats, p));
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   }
+
+  ncm_vector_clear (&tau_v);
 }
 
 /**
@@ -2858,131 +3767,420 @@ ncm_mset_catalog_get_shrink_factor (NcmMSetCatalog *mcat)
 
     ncm_stats_vec_update (mcat->mean_pstats);
 
-    ncm_matrix_add_mul (mcat->chain_cov, 1.0, cov);
+    ncm_matrix_add_mul (mcat->chain_cov, 1.0, cov);
+  }
+  ncm_matrix_scale (mcat->chain_cov, 1.0 / (1.0 * mcat->nchains));
+
+  {
+    NcmMatrix *cov = ncm_stats_vec_peek_cov_matrix (mcat->mean_pstats, 0);
+/*
+    ncm_matrix_log_vals (mcat->chain_cov, "# mean cov", "% 10.5g");
+    ncm_matrix_log_vals (cov, "# cov mean", "% 10.5g");
+*/
+    if (gsl_finite (ncm_matrix_get (mcat->chain_cov, 0, 0)))
+    {
+      do 
+      {
+        gdouble lev = 0.0;
+
+        ret = ncm_matrix_cholesky_decomp (mcat->chain_cov, 'U');
+        if (ret != 0)
+          break;
+
+        ret = ncm_matrix_cholesky_inverse (mcat->chain_cov, 'U');
+        if (ret != 0)
+          break;
+
+        ncm_matrix_dsymm (mcat->chain_cov, 'U', 1.0, cov, 0.0, mcat->chain_sM);
+
+        gsl_eigen_nonsymm_params (0, 1, mcat->chain_sM_ws);
+        gsl_eigen_nonsymm (ncm_matrix_gsl (mcat->chain_sM), mcat->chain_sM_ev, mcat->chain_sM_ws);
+
+        for (i = 0; i < free_params_len; i++)
+        {
+          lev = GSL_MAX (lev, GSL_VECTOR_REAL (mcat->chain_sM_ev, i));
+
+          if (GSL_VECTOR_IMAG (mcat->chain_sM_ev, i) != 0.0)
+            g_warning ("ncm_mset_catalog_get_shrink_factor: complex eigenvalue in SM matrix, unreliable shrink factor, try using more chains.");
+        }
+        shrink_factor = sqrt ((n - 1.0) / (1.0 * n) + (mcat->nchains + 1.0) * lev / (mcat->nchains * 1.0));
+      } while (FALSE);
+    }
+  }
+  return shrink_factor;
+}
+
+/**
+ * ncm_mset_catalog_param_pdf:
+ * @mcat: a #NcmMSetCatalog
+ * @i: parameter index.
+ *
+ * Bins and calculates the pdf associated with the parameter @i.
+ * (not ready yet FIXME)
+ *
+ */
+void
+ncm_mset_catalog_param_pdf (NcmMSetCatalog *mcat, guint i)
+{
+  const guint n = mcat->pstats->nitens;
+  const guint nbins = n / 10 >= 10 ? n / 10 : 10;
+  const gdouble p_max = ncm_vector_get (mcat->params_max, i);
+  const gdouble p_min = ncm_vector_get (mcat->params_min, i);
+  guint k;
+
+  mcat->pdf_i = i;
+
+  if (mcat->h != NULL && mcat->h->n != nbins)
+  {
+    gsl_histogram_free (mcat->h);
+    mcat->h = NULL;
+  }
+  if (mcat->h == NULL)
+    mcat->h = gsl_histogram_alloc (nbins);
+
+  if (mcat->h_pdf != NULL && mcat->h_pdf->n != nbins)
+  {
+    gsl_histogram_pdf_free (mcat->h_pdf);
+    mcat->h_pdf = NULL;
+  }
+  if (mcat->h_pdf == NULL)
+    mcat->h_pdf = gsl_histogram_pdf_alloc (nbins);
+
+  gsl_histogram_set_ranges_uniform (mcat->h, p_min, p_max);
+
+  for (k = 0; k < n; )
+  {
+    guint l, nrun;
+    const gdouble *p_i = _ncm_mset_catalog_peek_col_run (mcat, i, k, &nrun);
+
+    nrun = GSL_MIN (nrun, n - k);
+    for (l = 0; l < nrun; l++)
+      gsl_histogram_increment (mcat->h, p_i[l]);
+
+    k += nrun;
+  }
+
+  gsl_histogram_pdf_init (mcat->h_pdf, mcat->h);
+}
+
+/**
+ * ncm_mset_catalog_param_pdf_pvalue:
+ * @mcat: a #NcmMSetCatalog
+ * @pvalue: parameter value
+ * @both: one or both sides p-value
+ *
+ * Calculates the p-value associated with the parameter value @pvalue.
+ *
+ * Returns: the p-value.
+ */
+gdouble
+ncm_mset_catalog_param_pdf_pvalue (NcmMSetCatalog *mcat, gdouble pvalue, gboolean both)
+{
+  g_assert_cmpint (mcat->pdf_i, >=, 0);
+  g_assert (mcat->h_pdf != NULL);
+
+  {
+    const gdouble p_max = ncm_vector_get (mcat->params_max, mcat->pdf_i);
+    const gdouble p_min = ncm_vector_get (mcat->params_min, mcat->pdf_i);
+    gsize i = 0;
+
+    NCM_UNUSED (both);
+    if (pvalue < p_min || pvalue > p_max)
+    {
+      g_warning ("ncm_mset_catalog_param_pdf_pvalue: value % 20.15g outside mc obtained interval [% 20.15g % 20.15g]. Assuming 0 pvalue.",
+                 pvalue, p_min, p_max);
+      return 0.0;
+    }
+    gsl_histogram_find (mcat->h, pvalue, &i);
+    g_assert_cmpint (i, <=, mcat->h_pdf->n);
+    if (i == 0)
+      return 1.0;
+    else
+      return (1.0 - mcat->h_pdf->sum[i - 1]);
+  }
+}
+
+typedef struct _NcmMSetCatalogEvalWorker
+{
+  NcmMSet *mset;
+  NcmMSetFunc *func;
+  NcmVector *res_v;
+  NcmVector *res_l;
+  GPtrArray *qs_a;
+} NcmMSetCatalogEvalWorker;
+
+typedef struct _NcmMSetCatalogEval
+{
+  NcmMSetCatalog *mcat;
+  NcmMSetFunc *func;
+  NcmVector *x_v;
+  NcmSerialize *ser;
+  NcmMemoryPool *mp;
+  NcmMatrix *res;
+  guint row0;
+  NcmFitRunMsgs mtype;
+  guint cat_len;
+  guint nprinted;
+  guint dim;
+  gdouble compression;
+} NcmMSetCatalogEval;
+
+#define NCM_MSET_CATALOG_EVAL_BLOCK_SIZE 4096
+
+static gpointer
+_ncm_mset_catalog_eval_worker_dup (gpointer userdata)
+{
+  G_LOCK_DEFINE_STATIC (dup_worker);
+  NcmMSetCatalogEval *ev = (NcmMSetCatalogEval *) userdata;
+  NcmMSetCatalogEvalWorker *w = g_new (NcmMSetCatalogEvalWorker, 1);
+
+  G_LOCK (dup_worker);
+
+  /* 
+   * Each worker owns a full copy of the mset and of the function (including
+   * the objects it depends on, e.g., NcDistance), therefore, the rows can be
+   * evaluated concurrently without any locking.
+   */
+  w->mset = ncm_mset_dup (ev->mcat->mset, ev->ser);
+  w->func = NCM_MSET_FUNC (ncm_serialize_dup_obj (ev->ser, G_OBJECT (ev->func)));
+  ncm_serialize_reset (ev->ser, TRUE);
+
+  /* Reused (see ncm_vector_set_view()) as the output row of ev->res. */
+  w->res_l = NULL;
+
+  if (ev->compression > 0.0)
+  {
+    guint i;
+
+    w->res_v = ncm_vector_new (ev->dim);
+    w->qs_a  = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_stats_qsketch_free);
+
+    for (i = 0; i < ev->dim; i++)
+      g_ptr_array_add (w->qs_a, ncm_stats_qsketch_new (ev->compression));
+  }
+  else
+  {
+    w->res_v = NULL;
+    w->qs_a  = NULL;
+  }
+
+  G_UNLOCK (dup_worker);
+
+  return w;
+}
+
+static void
+_ncm_mset_catalog_eval_worker_free (gpointer userdata)
+{
+  NcmMSetCatalogEvalWorker *w = (NcmMSetCatalogEvalWorker *) userdata;
+
+  ncm_mset_clear (&w->mset);
+  ncm_mset_func_clear (&w->func);
+  ncm_vector_clear (&w->res_v);
+  ncm_vector_clear (&w->res_l);
+  g_clear_pointer (&w->qs_a, g_ptr_array_unref);
+
+  g_free (w);
+}
+
+static void
+_ncm_mset_catalog_eval_init (NcmMSetCatalogEval *ev, NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector *x_v, NcmFitRunMsgs mtype)
+{
+  if (ncm_mset_catalog_len (mcat) == 0)
+    g_error ("_ncm_mset_catalog_eval_init: cannot evaluate a function over an empty catalog.");
+
+  ev->mcat        = mcat;
+  ev->func        = func;
+  ev->x_v         = x_v;
+  ev->ser         = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  ev->mp          = ncm_memory_pool_new (&_ncm_mset_catalog_eval_worker_dup, ev, &_ncm_mset_catalog_eval_worker_free);
+  ev->res         = NULL;
+  ev->row0        = 0;
+  ev->mtype       = mtype;
+  ev->cat_len     = ncm_mset_catalog_len (mcat);
+  ev->nprinted    = 0;
+  ev->dim         = (x_v != NULL) ? ncm_vector_len (x_v) : 1;
+  ev->compression = 0.0;
+
+  if (mtype > NCM_FIT_RUN_MSGS_NONE)
+  {
+    guint i;
+    ncm_message ("# Calculating %u models in catalog: \n# - |", ev->cat_len);
+    for (i = 0; i < 100; i++)
+      ncm_message ("-");
+    ncm_message ("|\n# - |");
+  }
+}
+
+static void
+_ncm_mset_catalog_eval_clear (NcmMSetCatalogEval *ev)
+{
+  if (ev->mtype > NCM_FIT_RUN_MSGS_NONE)
+  {
+    guint i;
+    for (; ev->nprinted < 100; ev->nprinted++)
+      ncm_message ("=");
+    ncm_message ("|\n");
+    ncm_message ("# - |");
+    for (i = 0; i < 100; i++)
+      ncm_message ("-");
+    ncm_message ("|\n");
+  }
+
+  ncm_memory_pool_free (ev->mp, TRUE);
+  ncm_serialize_clear (&ev->ser);
+}
+
+static void
+_ncm_mset_catalog_eval_loop (glong i, glong f, gpointer data)
+{
+  NcmMSetCatalogEval *ev          = (NcmMSetCatalogEval *) data;
+  NcmMSetCatalogEvalWorker **w_ptr = ncm_memory_pool_get (ev->mp);
+  NcmMSetCatalogEvalWorker *w      = *w_ptr;
+  glong l;
+
+  for (l = i; l < f; l++)
+  {
+    NcmVector *row = ncm_mset_catalog_peek_row (ev->mcat, ev->row0 + l);
+
+    ncm_mset_fparams_set_vector_offset (w->mset, row, ev->mcat->nadd_vals);
+
+    if (ev->res == NULL)
+    {
+      guint j;
+
+      if (ev->x_v != NULL)
+        ncm_mset_func_eval_vector (w->func, w->mset, ev->x_v, w->res_v);
+      else
+        ncm_vector_set (w->res_v, 0, ncm_mset_func_eval0 (w->func, w->mset));
+
+      for (j = 0; j < ev->dim; j++)
+        ncm_stats_qsketch_add (g_ptr_array_index (w->qs_a, j), ncm_vector_get (w->res_v, j));
+    }
+    else if (ev->x_v != NULL)
+    {
+      NcmVectorView res_l = ncm_matrix_get_row_view (ev->res, l);
+
+      if (w->res_l == NULL)
+        w->res_l = ncm_vector_new_view (&res_l);
+      else
+        ncm_vector_set_view (w->res_l, &res_l);
+
+      ncm_mset_func_eval_vector (w->func, w->mset, ev->x_v, w->res_l);
+    }
+    else
+      ncm_matrix_set (ev->res, l, 0, ncm_mset_func_eval0 (w->func, w->mset));
+  }
+
+  ncm_memory_pool_return (w_ptr);
+}
+
+static void
+_ncm_mset_catalog_eval_progress (NcmMSetCatalogEval *ev, guint rows_done)
+{
+  if (ev->mtype > NCM_FIT_RUN_MSGS_NONE)
+  {
+    const guint ndone = (100 * (gulong) rows_done) / ev->cat_len;
+    for (; ev->nprinted < ndone; ev->nprinted++)
+      ncm_message ("=");
   }
-  ncm_matrix_scale (mcat->chain_cov, 1.0 / (1.0 * mcat->nchains));
+}
 
-  {
-    NcmMatrix *cov = ncm_stats_vec_peek_cov_matrix (mcat->mean_pstats, 0);
 /*
-    ncm_matrix_log_vals (mcat->chain_cov, "# mean cov", "% 10.5g");
-    ncm_matrix_log_vals (cov, "# cov mean", "% 10.5g");
-*/
-    if (gsl_finite (ncm_matrix_get (mcat->chain_cov, 0, 0)))
-    {
-      do 
-      {
-        gdouble lev = 0.0;
+ * Evaluates the function in the rows [row0, row0 + nrows(res)) of the catalog
+ * using all workers of the thread pool, the l-th line of res receives the
+ * result of the row row0 + l.
+ */
+static void
+_ncm_mset_catalog_eval_rows (NcmMSetCatalogEval *ev, guint row0, NcmMatrix *res)
+{
+  const guint nrows = ncm_matrix_nrows (res);
 
-        ret = ncm_matrix_cholesky_decomp (mcat->chain_cov, 'U');
-        if (ret != 0)
-          break;
+  ev->row0 = row0;
+  ev->res  = res;
 
-        ret = ncm_matrix_cholesky_inverse (mcat->chain_cov, 'U');
-        if (ret != 0)
-          break;
+  ncm_func_eval_parallel_for (&_ncm_mset_catalog_eval_loop, 0, nrows, 1, ev);
 
-        ncm_matrix_dsymm (mcat->chain_cov, 'U', 1.0, cov, 0.0, mcat->chain_sM);
+  ev->res = NULL;
 
-        gsl_eigen_nonsymm_params (0, 1, mcat->chain_sM_ws);
-        gsl_eigen_nonsymm (ncm_matrix_gsl (mcat->chain_sM), mcat->chain_sM_ev, mcat->chain_sM_ws);
+  _ncm_mset_catalog_eval_progress (ev, row0 + nrows);
+}
 
-        for (i = 0; i < free_params_len; i++)
-        {
-          lev = GSL_MAX (lev, GSL_VECTOR_REAL (mcat->chain_sM_ev, i));
+static void
+_ncm_mset_catalog_eval_merge_sketch (gpointer data, gpointer userdata)
+{
+  NcmMSetCatalogEvalWorker *w = (NcmMSetCatalogEvalWorker *) data;
+  GPtrArray *qs_a             = (GPtrArray *) userdata;
+  guint j;
 
-          if (GSL_VECTOR_IMAG (mcat->chain_sM_ev, i) != 0.0)
-            g_warning ("ncm_mset_catalog_get_shrink_factor: complex eigenvalue in SM matrix, unreliable shrink factor, try using more chains.");
-        }
-        shrink_factor = sqrt ((n - 1.0) / (1.0 * n) + (mcat->nchains + 1.0) * lev / (mcat->nchains * 1.0));
-      } while (FALSE);
-    }
-  }
-  return shrink_factor;
+  for (j = 0; j < qs_a->len; j++)
+    ncm_stats_qsketch_merge (g_ptr_array_index (qs_a, j), g_ptr_array_index (w->qs_a, j));
 }
 
-/**
- * ncm_mset_catalog_param_pdf:
- * @mcat: a #NcmMSetCatalog
- * @i: parameter index.
- *
- * Bins and calculates the pdf associated with the parameter @i.
- * (not ready yet FIXME)
- *
+/*
+ * Evaluates the function in all rows accumulating the results in the workers'
+ * quantile sketches, which are merged at the end in qs_a. The rows are
+ * processed in blocks of NCM_MSET_CATALOG_EVAL_BLOCK_SIZE to update the
+ * progress.
  */
-void
-ncm_mset_catalog_param_pdf (NcmMSetCatalog *mcat, guint i)
+static void
+_ncm_mset_catalog_eval_sketch (NcmMSetCatalogEval *ev, gdouble compression, GPtrArray *qs_a)
 {
-  const guint n = mcat->pstats->nitens;
-  const guint nbins = n / 10 >= 10 ? n / 10 : 10;
-  const gdouble p_max = ncm_vector_get (mcat->params_max, i);
-  const gdouble p_min = ncm_vector_get (mcat->params_min, i);
-  guint k;
+  guint row0, j;
 
-  mcat->pdf_i = i;
-
-  if (mcat->h != NULL && mcat->h->n != nbins)
-  {
-    gsl_histogram_free (mcat->h);
-    mcat->h = NULL;
-  }
-  if (mcat->h == NULL)
-    mcat->h = gsl_histogram_alloc (nbins);
+  ev->compression = compression;
+  ev->res         = NULL;
 
-  if (mcat->h_pdf != NULL && mcat->h_pdf->n != nbins)
+  for (row0 = 0; row0 < ev->cat_len; row0 += NCM_MSET_CATALOG_EVAL_BLOCK_SIZE)
   {
-    gsl_histogram_pdf_free (mcat->h_pdf);
-    mcat->h_pdf = NULL;
-  }
-  if (mcat->h_pdf == NULL)
-    mcat->h_pdf = gsl_histogram_pdf_alloc (nbins);
+    const guint nrows = GSL_MIN (ev->cat_len - row0, NCM_MSET_CATALOG_EVAL_BLOCK_SIZE);
 
-  gsl_histogram_set_ranges_uniform (mcat->h, p_min, p_max);
+    ev->row0 = row0;
+    ncm_func_eval_parallel_for (&_ncm_mset_catalog_eval_loop, 0, nrows, 1, ev);
 
-  for (k = 0; k < mcat->pstats->nitens; k++)
-  {
-    NcmVector *row = ncm_stats_vec_peek_row (mcat->pstats, k);
-    gsl_histogram_increment (mcat->h, ncm_vector_get (row, i));
+    _ncm_mset_catalog_eval_progress (ev, row0 + nrows);
   }
 
-  gsl_histogram_pdf_init (mcat->h_pdf, mcat->h);
+  for (j = 0; j < ev->dim; j++)
+    g_ptr_array_add (qs_a, ncm_stats_qsketch_new (compression));
+
+  ncm_memory_pool_foreach (ev->mp, &_ncm_mset_catalog_eval_merge_sketch, qs_a);
 }
 
-/**
- * ncm_mset_catalog_param_pdf_pvalue:
- * @mcat: a #NcmMSetCatalog
- * @pvalue: parameter value
- * @both: one or both sides p-value
- *
- * Calculates the p-value associated with the parameter value @pvalue.
- *
- * Returns: the p-value.
+/*
+ * Streams the catalog through blocks of NCM_MSET_CATALOG_EVAL_BLOCK_SIZE
+ * rows, each block is evaluated in parallel and then passed to the
+ * accumulators in the catalog order (serially), so the memory used does not
+ * depend on the catalog size.
  */
-gdouble
-ncm_mset_catalog_param_pdf_pvalue (NcmMSetCatalog *mcat, gdouble pvalue, gboolean both)
+static void
+_ncm_mset_catalog_eval_stream_epdf (NcmMSetCatalogEval *ev, GPtrArray *epdf_a, const guint dim)
 {
-  g_assert_cmpint (mcat->pdf_i, >=, 0);
-  g_assert (mcat->h_pdf != NULL);
+  const guint bsize = GSL_MIN (ev->cat_len, NCM_MSET_CATALOG_EVAL_BLOCK_SIZE);
+  NcmMatrix *block  = ncm_matrix_new (bsize, dim);
+  guint row0;
 
+  for (row0 = 0; row0 < ev->cat_len; row0 += bsize)
   {
-    const gdouble p_max = ncm_vector_get (mcat->params_max, mcat->pdf_i);
-    const gdouble p_min = ncm_vector_get (mcat->params_min, mcat->pdf_i);
-    gsize i = 0;
+    const guint nrows = GSL_MIN (bsize, ev->cat_len - row0);
+    NcmMatrix *sblock = (nrows == bsize) ? ncm_matrix_ref (block) : ncm_matrix_get_submatrix (block, 0, 0, nrows, dim);
+    guint l, j;
 
-    NCM_UNUSED (both);
-    if (pvalue < p_min || pvalue > p_max)
+    _ncm_mset_catalog_eval_rows (ev, row0, sblock);
+
+    for (l = 0; l < nrows; l++)
     {
-      g_warning ("ncm_mset_catalog_param_pdf_pvalue: value % 20.15g outside mc obtained interval [% 20.15g % 20.15g]. Assuming 0 pvalue.",
-                 pvalue, p_min, p_max);
-      return 0.0;
+      for (j = 0; j < dim; j++)
+      {
+        NcmStatsDist1dEPDF *epdf = g_ptr_array_index (epdf_a, j);
+        ncm_stats_dist1d_epdf_add_obs (epdf, ncm_matrix_get (sblock, l, j));
+      }
     }
-    gsl_histogram_find (mcat->h, pvalue, &i);
-    g_assert_cmpint (i, <=, mcat->h_pdf->n);
-    if (i == 0)
-      return 1.0;
-    else
-      return (1.0 - mcat->h_pdf->sum[i - 1]);
+
+    ncm_matrix_free (sblock);
   }
+
+  ncm_matrix_free (block);
 }
 
 /**
@@ -3000,7 +4198,11 @@ ncm_mset_catalog_param_pdf_pvalue (NcmMSetCatalog *mcat, gdouble pvalue, gboolea
  * This function calculates the quantiles directly using:
  * gsl_stats_quantile_from_sorted_data for this reason it must allocates the
  * catalog size times the number of elements in @x, for a less memory intensive
- * version use ncm_mset_catalog_calc_ci_interp().
+ * version use ncm_mset_catalog_calc_ci_interp() or ncm_mset_catalog_calc_ci_sketch().
+ *
+ * The catalog rows are evaluated in parallel by the threads in the pool, see
+ * ncm_func_eval_parallel_for(), each thread using its own copy of the
+ * #NcmMSet and of @func.
  *
  * The #NcmMSetFunc @func must be of dimension one.
  *
@@ -3020,33 +4222,24 @@ ncm_mset_catalog_calc_ci_direct (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVec
   
   g_assert_cmpuint (p_val->len, >, 1);
   {
-    const guint nelem      = p_val->len * 2 + 1;
-    NcmMatrix *res         = ncm_matrix_new (dim, nelem);
-    NcmVector *save_params = ncm_vector_new (ncm_mset_fparams_len (mcat->mset));
-    const guint cat_len    = ncm_mset_catalog_len (mcat);
+    const guint nelem   = p_val->len * 2 + 1;
+    NcmMatrix *res      = ncm_matrix_new (dim, nelem);
+    const guint cat_len = ncm_mset_catalog_len (mcat);
+    NcmMatrix *qws;
+    NcmMSetCatalogEval ev;
     guint i, j;
 
-    ncm_mset_fparams_get_vector (mcat->mset, save_params);
-
-    ncm_vector_clear (&mcat->quantile_ws);
-    mcat->quantile_ws = ncm_vector_new (cat_len * dim);
+    _ncm_mset_catalog_eval_init (&ev, mcat, func, x_v, NCM_FIT_RUN_MSGS_NONE);
 
-    for (i = 0; i < cat_len; i++)
-    {
-      NcmVector *row = ncm_mset_catalog_peek_row (mcat, i);
-      NcmVector *qws = ncm_vector_get_subvector (mcat->quantile_ws, i * dim, dim);
-      ncm_mset_fparams_set_vector_offset (mcat->mset, row, mcat->nadd_vals);
-
-      ncm_mset_func_eval_vector (func, mcat->mset, x_v, qws);
-
-      ncm_vector_free (qws);
-    }
+    qws = ncm_matrix_new (cat_len, dim);
+    _ncm_mset_catalog_eval_rows (&ev, 0, qws);
+    _ncm_mset_catalog_eval_clear (&ev);
 
     for (i = 0; i < dim; i++)
     {
-      gdouble *ret_i = ncm_vector_ptr (mcat->quantile_ws, i);
-      gsl_sort (ret_i, dim, cat_len);
-      ncm_matrix_set (res, i, 0, gsl_stats_mean (ret_i, dim, cat_len));
+      gdouble *ret_i = ncm_matrix_ptr (qws, 0, i);
+      gsl_sort (ret_i, ncm_matrix_tda (qws), cat_len);
+      ncm_matrix_set (res, i, 0, gsl_stats_mean (ret_i, ncm_matrix_tda (qws), cat_len));
     }
 
     for (j = 0; j < p_val->len; j++)
@@ -3056,19 +4249,17 @@ ncm_mset_catalog_calc_ci_direct (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVec
       g_assert_cmpfloat (p, <, 1.0);
       for (i = 0; i < dim; i++)
       {
-        gdouble *ret_i = ncm_vector_ptr (mcat->quantile_ws, i);
+        gdouble *ret_i = ncm_matrix_ptr (qws, 0, i);
         const gdouble lb_prob = (1.0 - p) / 2.0;
         const gdouble ub_prob = (1.0 + p) / 2.0;
-        const gdouble lb = gsl_stats_quantile_from_sorted_data (ret_i, dim, cat_len, lb_prob);
-        const gdouble ub = gsl_stats_quantile_from_sorted_data (ret_i, dim, cat_len, ub_prob);
+        const gdouble lb = gsl_stats_quantile_from_sorted_data (ret_i, ncm_matrix_tda (qws), cat_len, lb_prob);
+        const gdouble ub = gsl_stats_quantile_from_sorted_data (ret_i, ncm_matrix_tda (qws), cat_len, ub_prob);
         ncm_matrix_set (res, i, 1 + j * 2 + 0, lb);
         ncm_matrix_set (res, i, 1 + j * 2 + 1, ub);
       }
     }
 
-    ncm_vector_clear (&mcat->quantile_ws);
-    ncm_mset_fparams_set_vector (mcat->mset, save_params);
-    ncm_vector_free (save_params);
+    ncm_matrix_free (qws);
     return res;
   }
 }
@@ -3088,7 +4279,10 @@ ncm_mset_catalog_calc_ci_direct (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVec
  * upper bounds for each p-value in @p_val.
  *
  * This function creates an approximation of the distribution for each value of
- * the function @func and calculates the quantiles from this approximation.
+ * the function @func and calculates the quantiles from this approximation. The
+ * catalog is processed in blocks of rows evaluated in parallel (see
+ * ncm_mset_catalog_calc_ci_direct()), thus, the memory used does not depend on
+ * the catalog size.
  *
  * The #NcmMSetFunc @func must be of dimension one.
  *
@@ -3110,23 +4304,10 @@ ncm_mset_catalog_calc_ci_interp (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVec
   {
     const guint nelem      = p_val->len * 2 + 1;
     NcmMatrix *res         = ncm_matrix_new (dim, nelem);
-    NcmVector *save_params = ncm_vector_new (ncm_mset_fparams_len (mcat->mset));
-    const guint cat_len    = ncm_mset_catalog_len (mcat);
     GPtrArray *epdf_a      = g_ptr_array_sized_new (dim);
+    NcmMSetCatalogEval ev;
     guint i, j;
 
-    ncm_mset_fparams_get_vector (mcat->mset, save_params);
-
-    if (mcat->quantile_ws == NULL)
-    {
-      mcat->quantile_ws = ncm_vector_new (dim);
-    }
-    else if (ncm_vector_len (mcat->quantile_ws) != dim)
-    {
-      ncm_vector_clear (&mcat->quantile_ws);
-      mcat->quantile_ws = ncm_vector_new (dim);
-    }
-
     g_ptr_array_set_free_func (epdf_a, (GDestroyNotify) ncm_stats_dist1d_free);
     for (i = 0; i < dim; i++)
     {
@@ -3134,45 +4315,9 @@ ncm_mset_catalog_calc_ci_interp (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVec
       g_ptr_array_add (epdf_a, epdf);
     }
 
-    if (mtype > NCM_FIT_RUN_MSGS_NONE)
-    {
-      ncm_message ("# Calculating %u models in catalog: \n# - |", cat_len);
-      for (i = 0; i < 100; i++)
-        ncm_message ("-");
-      ncm_message ("|\n# - |");
-    }
-
-    for (i = 0; i < cat_len; i++)
-    {
-      NcmVector *row = ncm_mset_catalog_peek_row (mcat, i);
-
-      ncm_mset_fparams_set_vector_offset (mcat->mset, row, mcat->nadd_vals);
-
-      ncm_mset_func_eval_vector (func, mcat->mset, x_v, mcat->quantile_ws);
-
-      for (j = 0; j < dim; j++)
-      {
-        NcmStatsDist1dEPDF *epdf = g_ptr_array_index (epdf_a, j);
-        ncm_stats_dist1d_epdf_add_obs (epdf, ncm_vector_get (mcat->quantile_ws, j));
-      }
-      if (i % (cat_len / 100) == 0)
-      {
-        if (mtype > NCM_FIT_RUN_MSGS_NONE)
-        {
-          ncm_message ("=");
-        }
-      }
-    }
-    if (mtype > NCM_FIT_RUN_MSGS_NONE)
-    {
-      if (i % (cat_len / 100) != 0)
-        ncm_message ("=");
-      ncm_message ("|\n");
-      ncm_message ("# - |");
-      for (i = 0; i < 100; i++)
-        ncm_message ("-");
-      ncm_message ("|\n");
-    }
+    _ncm_mset_catalog_eval_init (&ev, mcat, func, x_v, mtype);
+    _ncm_mset_catalog_eval_stream_epdf (&ev, epdf_a, dim);
+    _ncm_mset_catalog_eval_clear (&ev);
 
     for (i = 0; i < dim; i++)
     {
@@ -3198,8 +4343,68 @@ ncm_mset_catalog_calc_ci_interp (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVec
     }
 
     g_ptr_array_unref (epdf_a);
-    ncm_mset_fparams_set_vector (mcat->mset, save_params);
-    ncm_vector_free (save_params);
+    return res;
+  }
+}
+
+/**
+ * ncm_mset_catalog_calc_ci_sketch:
+ * @mcat: a #NcmMSetCatalog
+ * @func: a #NcmMSetFunc of type n-n
+ * @x_v: #NcmVector of arguments of @func
+ * @p_val: (element-type double): p-values for the confidence intervals
+ * @compression: the quantile sketch compression, see ncm_stats_qsketch_new()
+ * @mtype: #NcmFitRunMsgs log level
+ *
+ * Calculates the mean and the confidence interval (CI) for the value of @func
+ * for each p-value in @p_val, the results are organized as in
+ * ncm_mset_catalog_calc_ci_direct().
+ *
+ * The quantiles are estimated using a #NcmStatsQSketch for each element of
+ * @x_v, so the memory used is proportional to the number of elements times
+ * @compression and does not depend on the catalog size. Each thread
+ * accumulates its own sketches which are merged at the end. The mean is
+ * computed exactly.
+ *
+ * Returns: (transfer full): a #NcmMatrix containing the mean and lower/upper bound of the confidence interval for @func.
+ */
+NcmMatrix *
+ncm_mset_catalog_calc_ci_sketch (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector *x_v, GArray *p_val, gdouble compression, NcmFitRunMsgs mtype)
+{
+  const guint dim = ncm_vector_len (x_v);
+
+  g_assert_cmpuint (p_val->len, >, 1);
+  {
+    const guint nelem = p_val->len * 2 + 1;
+    NcmMatrix *res    = ncm_matrix_new (dim, nelem);
+    GPtrArray *qs_a   = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_stats_qsketch_free);
+    NcmMSetCatalogEval ev;
+    guint i, j;
+
+    _ncm_mset_catalog_eval_init (&ev, mcat, func, x_v, mtype);
+    _ncm_mset_catalog_eval_sketch (&ev, compression, qs_a);
+    _ncm_mset_catalog_eval_clear (&ev);
+
+    for (i = 0; i < dim; i++)
+    {
+      NcmStatsQSketch *qs = g_ptr_array_index (qs_a, i);
+
+      ncm_matrix_set (res, i, 0, ncm_stats_qsketch_get_mean (qs));
+      for (j = 0; j < p_val->len; j++)
+      {
+        const gdouble p       = g_array_index (p_val, gdouble, j);
+        const gdouble lb_prob = (1.0 - p) / 2.0;
+        const gdouble ub_prob = (1.0 + p) / 2.0;
+
+        g_assert_cmpfloat (p, >, 0.0);
+        g_assert_cmpfloat (p, <, 1.0);
+
+        ncm_matrix_set (res, i, 1 + j * 2 + 0, ncm_stats_qsketch_get_quantile (qs, lb_prob));
+        ncm_matrix_set (res, i, 1 + j * 2 + 1, ncm_stats_qsketch_get_quantile (qs, ub_prob));
+      }
+    }
+
+    g_ptr_array_unref (qs_a);
     return res;
   }
 }
@@ -3233,23 +4438,10 @@ ncm_mset_catalog_calc_pvalue (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector
   {
     const guint nelem      = lim->len * 2 + 1;
     NcmMatrix *res         = ncm_matrix_new (dim, nelem);
-    NcmVector *save_params = ncm_vector_new (ncm_mset_fparams_len (mcat->mset));
-    const guint cat_len    = ncm_mset_catalog_len (mcat);
     GPtrArray *epdf_a      = g_ptr_array_sized_new (dim);
+    NcmMSetCatalogEval ev;
     guint i, j;
 
-    ncm_mset_fparams_get_vector (mcat->mset, save_params);
-
-    if (mcat->quantile_ws == NULL)
-    {
-      mcat->quantile_ws = ncm_vector_new (dim);
-    }
-    else if (ncm_vector_len (mcat->quantile_ws) != dim)
-    {
-      ncm_vector_clear (&mcat->quantile_ws);
-      mcat->quantile_ws = ncm_vector_new (dim);
-    }
-
     g_ptr_array_set_free_func (epdf_a, (GDestroyNotify) ncm_stats_dist1d_free);
     for (i = 0; i < dim; i++)
     {
@@ -3257,45 +4449,9 @@ ncm_mset_catalog_calc_pvalue (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector
       g_ptr_array_add (epdf_a, epdf);
     }
 
-    if (mtype > NCM_FIT_RUN_MSGS_NONE)
-    {
-      ncm_message ("# Calculating %u models in catalog: \n# - |", cat_len);
-      for (i = 0; i < 100; i++)
-        ncm_message ("-");
-      ncm_message ("|\n# - |");
-    }
-
-    for (i = 0; i < cat_len; i++)
-    {
-      NcmVector *row = ncm_mset_catalog_peek_row (mcat, i);
-
-      ncm_mset_fparams_set_vector_offset (mcat->mset, row, mcat->nadd_vals);
-
-      ncm_mset_func_eval_vector (func, mcat->mset, x_v, mcat->quantile_ws);
-
-      for (j = 0; j < dim; j++)
-      {
-        NcmStatsDist1dEPDF *epdf = g_ptr_array_index (epdf_a, j);
-        ncm_stats_dist1d_epdf_add_obs (epdf, ncm_vector_get (mcat->quantile_ws, j));
-      }
-      if (i % (cat_len / 100) == 0)
-      {
-        if (mtype > NCM_FIT_RUN_MSGS_NONE)
-        {
-          ncm_message ("=");
-        }
-      }
-    }
-    if (mtype > NCM_FIT_RUN_MSGS_NONE)
-    {
-      if (i % (cat_len / 100) != 0)
-        ncm_message ("=");
-      ncm_message ("|\n");
-      ncm_message ("# - |");
-      for (i = 0; i < 100; i++)
-        ncm_message ("-");
-      ncm_message ("|\n");
-    }
+    _ncm_mset_catalog_eval_init (&ev, mcat, func, x_v, mtype);
+    _ncm_mset_catalog_eval_stream_epdf (&ev, epdf_a, dim);
+    _ncm_mset_catalog_eval_clear (&ev);
 
     for (i = 0; i < dim; i++)
     {
@@ -3322,8 +4478,6 @@ ncm_mset_catalog_calc_pvalue (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector
     }
 
     g_ptr_array_unref (epdf_a);
-    ncm_mset_fparams_set_vector (mcat->mset, save_params);
-    ncm_vector_free (save_params);
     return res;
   }
 }
@@ -3337,7 +4491,8 @@ ncm_mset_catalog_calc_pvalue (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector
  * Calculates the distribution of @func.
  *
  * This function creates an approximation of the distribution for each value of
- * the function @func calculated in each model in @mcat.
+ * the function @func calculated in each model in @mcat. The models are
+ * evaluated in parallel as in ncm_mset_catalog_calc_ci_interp().
  *
  * Returns: (transfer full): a #NcmStatsDist1d describing the distribution.
  */
@@ -3348,52 +4503,19 @@ ncm_mset_catalog_calc_distrib (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmFitRu
   g_assert_cmpuint (dim, ==, 1);
   {
     NcmStatsDist1dEPDF *epdf1d = ncm_stats_dist1d_epdf_new (NCM_MSET_CATALOG_DIST_EST_SD_SCALE);
-    NcmVector *save_params = ncm_vector_new (ncm_mset_fparams_len (mcat->mset));
-    const guint cat_len = ncm_mset_catalog_len (mcat);
-    guint i;
-
-    ncm_mset_fparams_get_vector (mcat->mset, save_params);
-
-    if (mtype > NCM_FIT_RUN_MSGS_NONE)
-    {
-      ncm_message ("# Calculating %u models in catalog: \n# - |", cat_len);
-      for (i = 0; i < 100; i++)
-        ncm_message ("-");
-      ncm_message ("|\n# - |");
-    }
+    GPtrArray *epdf_a          = g_ptr_array_sized_new (1);
+    NcmMSetCatalogEval ev;
 
-    for (i = 0; i < cat_len; i++)
-    {
-      NcmVector *row = ncm_mset_catalog_peek_row (mcat, i);
-      gdouble x;
+    g_ptr_array_add (epdf_a, epdf1d);
 
-      ncm_mset_fparams_set_vector_offset (mcat->mset, row, mcat->nadd_vals);
-      x = ncm_mset_func_eval0 (func, mcat->mset);
-      ncm_stats_dist1d_epdf_add_obs (epdf1d, x);
+    _ncm_mset_catalog_eval_init (&ev, mcat, func, NULL, mtype);
+    _ncm_mset_catalog_eval_stream_epdf (&ev, epdf_a, 1);
+    _ncm_mset_catalog_eval_clear (&ev);
 
-      if (i % (cat_len / 100) == 0)
-      {
-        if (mtype > NCM_FIT_RUN_MSGS_NONE)
-        {
-          ncm_message ("=");
-        }
-      }
-    }
-    if (mtype > NCM_FIT_RUN_MSGS_NONE)
-    {
-      if (i % (cat_len / 100) != 0)
-        ncm_message ("=");
-      ncm_message ("|\n");
-      ncm_message ("# - |");
-      for (i = 0; i < 100; i++)
-        ncm_message ("-");
-      ncm_message ("|\n");
-    }
+    g_ptr_array_unref (epdf_a);
 
     ncm_stats_dist1d_prepare (NCM_STATS_DIST1D (epdf1d));
 
-    ncm_mset_fparams_set_vector (mcat->mset, save_params);
-    ncm_vector_free (save_params);
     return NCM_STATS_DIST1D (epdf1d);
   }
 }
@@ -3416,18 +4538,22 @@ _ncm_mset_catalog_calc_distrib (NcmMSetCatalog *mcat, guint vi, NcmFitRunMsgs mt
     ncm_message ("|\n# - |");
   }
 
-  for (i = 0; i < cat_len; i++)
+  for (i = 0; i < cat_len; )
   {
-    NcmVector *row = ncm_mset_catalog_peek_row (mcat, i);
-    gdouble x      = ncm_vector_get (row, vi);
+    guint l, nrun;
+    const gdouble *x = _ncm_mset_catalog_peek_col_run (mcat, vi, i, &nrun);
 
-    ncm_stats_dist1d_epdf_add_obs (epdf1d, x);
-
-    if (i % (cat_len / 100) == 0)
+    nrun = GSL_MIN (nrun, cat_len - i);
+    for (l = 0; l < nrun; l++, i++)
     {
-      if (mtype > NCM_FIT_RUN_MSGS_NONE)
+      ncm_stats_dist1d_epdf_add_obs (epdf1d, x[l]);
+
+      if (i % (cat_len / 100) == 0)
       {
-        ncm_message ("=");
+        if (mtype > NCM_FIT_RUN_MSGS_NONE)
+        {
+          ncm_message ("=");
+        }
       }
     }
   }
@@ -3529,11 +4655,16 @@ _ncm_mset_catalog_calc_ensemble_evol (NcmMSetCatalog *mcat, guint vi, guint nste
 
   for (t = 0; t < max_t; t++)
   {
-    for (i = 0; i < mcat->nchains; i++)
+    for (i = 0; i < mcat->nchains; )
     {
-      NcmVector *row = ncm_mset_catalog_peek_row (mcat, t * mcat->nchains + i);
-      gdouble x = ncm_vector_get (row, vi);
-      ncm_stats_dist1d_epdf_add_obs (epdf1d, x);
+      guint l, nrun;
+      const gdouble *x = _ncm_mset_catalog_peek_col_run (mcat, vi, t * mcat->nchains + i, &nrun);
+
+      nrun = GSL_MIN (nrun, mcat->nchains - i);
+      for (l = 0; l < nrun; l++)
+        ncm_stats_dist1d_epdf_add_obs (epdf1d, x[l]);
+
+      i += nrun;
     }
     
     ncm_stats_dist1d_prepare (NCM_STATS_DIST1D (epdf1d));
@@ -50,6 +50,7 @@ G_BEGIN_DECLS
 
 typedef struct _NcmMSetCatalogClass NcmMSetCatalogClass;
 typedef struct _NcmMSetCatalog NcmMSetCatalog;
+typedef struct _NcmMSetCatalogColFile NcmMSetCatalogColFile;
 
 struct _NcmMSetCatalogClass
 {
@@ -94,6 +95,8 @@ typedef enum _NcmMSetCatalogTrimType
  * NcmMSetCatalogTauMethod:
  * @NCM_MSET_CATALOG_TAU_METHOD_ACOR: uses the autocorrelation to estimate $\tau$.
  * @NCM_MSET_CATALOG_TAU_METHOD_AR_MODEL: uses an autoregressive model fitting to estimate $\tau$.
+ * @NCM_MSET_CATALOG_TAU_METHOD_ONLINE_ACOR: uses the autocorrelation up to a fixed lag accumulated online to estimate $\tau$.
+ * @NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS: uses the batch means accumulated online to estimate $\tau$.
  * 
  * Method used to estimate the autocorrelation time $\tau$.
  * 
@@ -101,8 +104,10 @@ typedef enum _NcmMSetCatalogTrimType
 typedef enum _NcmMSetCatalogTauMethod
 {
   NCM_MSET_CATALOG_TAU_METHOD_ACOR = 0,
-  NCM_MSET_CATALOG_TAU_METHOD_AR_MODEL, /*< private >*/
-  NCM_MSET_CATALOG_TAU_METHOD_LEN,      /*< skip >*/
+  NCM_MSET_CATALOG_TAU_METHOD_AR_MODEL,
+  NCM_MSET_CATALOG_TAU_METHOD_ONLINE_ACOR,
+  NCM_MSET_CATALOG_TAU_METHOD_BATCH_MEANS, /*< private >*/
+  NCM_MSET_CATALOG_TAU_METHOD_LEN,         /*< skip >*/
 } NcmMSetCatalogTauMethod;
 
 struct _NcmMSetCatalog
@@ -133,6 +138,7 @@ struct _NcmMSetCatalog
   gsl_vector_complex *chain_sM_ev;
   NcmMSetCatalogTauMethod tau_method;
   NcmVector *tau;
+  guint fft_nthreads;
   gchar *rng_inis;
   gchar *rng_stat;
   GTimer *sync_timer;
@@ -141,7 +147,6 @@ struct _NcmMSetCatalog
   gchar *mset_file;
   gchar *rtype_str;
   GArray *porder;
-  NcmVector *quantile_ws;
   gint first_id;
   gint cur_id;
   gint file_first_id;
@@ -150,6 +155,7 @@ struct _NcmMSetCatalog
 #ifdef NUMCOSMO_HAVE_CFITSIO
   fitsfile *fptr;
 #endif /* NUMCOSMO_HAVE_CFITSIO */
+  NcmMSetCatalogColFile *cfile;
   NcmVector *params_max;
   NcmVector *params_min;
   glong pdf_i;
@@ -200,6 +206,9 @@ glong ncm_mset_catalog_get_burnin (NcmMSetCatalog *mcat);
 void ncm_mset_catalog_set_tau_method (NcmMSetCatalog *mcat, NcmMSetCatalogTauMethod tau_method);
 NcmMSetCatalogTauMethod ncm_mset_catalog_get_tau_method (NcmMSetCatalog *mcat);
 
+void ncm_mset_catalog_set_fft_nthreads (NcmMSetCatalog *mcat, guint nthreads);
+guint ncm_mset_catalog_get_fft_nthreads (NcmMSetCatalog *mcat);
+
 void ncm_mset_catalog_add_from_mset (NcmMSetCatalog *mcat, NcmMSet *mset, ...) G_GNUC_NULL_TERMINATED;
 void ncm_mset_catalog_add_from_mset_array (NcmMSetCatalog *mcat, NcmMSet *mset, gdouble *ax);
 void ncm_mset_catalog_add_from_vector (NcmMSetCatalog *mcat, NcmVector *vals);
@@ -231,6 +240,7 @@ gdouble ncm_mset_catalog_param_pdf_pvalue (NcmMSetCatalog *mcat, gdouble pvalue,
 
 NcmMatrix *ncm_mset_catalog_calc_ci_direct (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector *x_v, GArray *p_val);
 NcmMatrix *ncm_mset_catalog_calc_ci_interp (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector *x_v, GArray *p_val, guint nodes, NcmFitRunMsgs mtype);
+NcmMatrix *ncm_mset_catalog_calc_ci_sketch (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector *x_v, GArray *p_val, gdouble compression, NcmFitRunMsgs mtype);
 NcmMatrix *ncm_mset_catalog_calc_pvalue (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmVector *x_v, GArray *lim, guint nodes, NcmFitRunMsgs mtype);
 NcmStatsDist1d *ncm_mset_catalog_calc_distrib (NcmMSetCatalog *mcat, NcmMSetFunc *func, NcmFitRunMsgs mtype);
 NcmStatsDist1d *ncm_mset_catalog_calc_param_distrib (NcmMSetCatalog *mcat, const NcmMSetPIndex *pi, NcmFitRunMsgs mtype);
@@ -250,6 +260,7 @@ guint ncm_mset_catalog_max_ess_time_by_chain (NcmMSetCatalog *mcat, const guint
 guint ncm_mset_catalog_heidel_diag_by_chain (NcmMSetCatalog *mcat, const guint ntests, const gdouble pvalue, gdouble *wp_pvalue, NcmFitRunMsgs mtype);
 
 #define NCM_MSET_CATALOG_EXTNAME "NcmMSetCatalog:DATA"
+#define NCM_MSET_CATALOG_COL_EXT ".mcat"
 #define NCM_MSET_CATALOG_M2LNL_COLNAME "NcmFit:m2lnL"
 #define NCM_MSET_CATALOG_M2LNL_SYMBOL "-2\\ln(L)"
 #define NCM_MSET_CATALOG_FIRST_ID_LABEL "FIRST_ID"
@@ -450,6 +450,46 @@ ncm_powspec_get_nknots (NcmPowspec *powspec, guint *Nz, guint *Nk)
   NCM_POWSPEC_GET_CLASS (powspec)->get_nknots (powspec, Nz, Nk);
 }
 
+/**
+ * ncm_powspec_is_separable:
+ * @powspec: a #NcmPowspec
+ * 
+ * Checks whether the power spectrum can be written as 
+ * $P(k, z) = G(z) P_0(k)$, i.e., whether the subclass implements the
+ * growth2 virtual, see ncm_powspec_eval_growth2().
+ *
+ * Returns: whether @powspec is separable.
+ */
+gboolean 
+ncm_powspec_is_separable (NcmPowspec *powspec)
+{
+  return NCM_POWSPEC_GET_CLASS (powspec)->growth2 != NULL;
+}
+
+/**
+ * ncm_powspec_eval_growth2: (virtual growth2)
+ * @powspec: a #NcmPowspec
+ * @model: a #NcmModel
+ * @z: redshift $z$
+ * 
+ * For a separable power spectrum (see ncm_powspec_is_separable()) computes
+ * the time dependent factor $G(z)$ of $P(k, z) = G(z) P_0(k)$, for linear 
+ * spectra this is the square of the growth function. Its normalization is 
+ * arbitrary, only ratios $G(z_1)/G(z_2)$ are meaningful.
+ *
+ * Returns: $G(z)$.
+ */
+gdouble 
+ncm_powspec_eval_growth2 (NcmPowspec *powspec, NcmModel *model, const gdouble z)
+{
+  NcmPowspecClass *ps_class = NCM_POWSPEC_GET_CLASS (powspec);
+
+  if (ps_class->growth2 == NULL)
+    g_error ("ncm_powspec_eval_growth2: %s is not separable.", G_OBJECT_TYPE_NAME (powspec));
+
+  return ps_class->growth2 (powspec, model, z);
+}
+
 /**
  * ncm_powspec_prepare:
  * @powspec: a #NcmPowspec
@@ -62,6 +62,8 @@
 #include "math/ncm_spline2d_bicubic.h"
 #include "ncm_enum_types.h"
 
+#include <gsl/gsl_math.h>
+
 enum
 {
   PROP_0,
@@ -70,6 +72,7 @@ enum
   PROP_ZI,
   PROP_ZF,
   PROP_RELTOL,
+  PROP_FFT_NTHREADS,
   PROP_POWERSPECTRUM
 };
 
@@ -78,20 +81,21 @@ G_DEFINE_TYPE (NcmPowspecFilter, ncm_powspec_filter, G_TYPE_OBJECT);
 static void
 ncm_powspec_filter_init (NcmPowspecFilter *psf)
 {
-  psf->ps          = NULL;
-  psf->lnr0        = 0.0;
-  psf->lnk0        = 0.0;
-  psf->Lk          = 0.0;
-  psf->zi          = 0.0;
-  psf->zf          = 0.0;
-  psf->reltol      = 0.0;
-  psf->type        = NCM_POWSPEC_FILTER_TYPE_LEN;
-  psf->fftlog      = NULL;
-  psf->calibrated  = FALSE;
-  psf->var         = ncm_spline2d_bicubic_notaknot_new ();
-  psf->dvar        = ncm_spline2d_bicubic_notaknot_new ();
-  psf->ctrl        = ncm_model_ctrl_new (NULL);
-  psf->constructed = FALSE;
+  psf->ps           = NULL;
+  psf->lnr0         = 0.0;
+  psf->lnk0         = 0.0;
+  psf->Lk           = 0.0;
+  psf->zi           = 0.0;
+  psf->zf           = 0.0;
+  psf->reltol       = 0.0;
+  psf->fft_nthreads = 1;
+  psf->type         = NCM_POWSPEC_FILTER_TYPE_LEN;
+  psf->fftlog       = NULL;
+  psf->calibrated   = FALSE;
+  psf->var          = ncm_spline2d_bicubic_notaknot_new ();
+  psf->dvar         = ncm_spline2d_bicubic_notaknot_new ();
+  psf->ctrl         = ncm_model_ctrl_new (NULL);
+  psf->constructed  = FALSE;
 }
 
 static void
@@ -117,6 +121,9 @@ _ncm_powspec_filter_set_property (GObject *object, guint prop_id, const GValue *
     case PROP_RELTOL:
       psf->reltol = g_value_get_double (value);
       break;
+    case PROP_FFT_NTHREADS:
+      ncm_powspec_filter_set_fft_nthreads (psf, g_value_get_uint (value));
+      break;
     case PROP_POWERSPECTRUM:
       psf->ps = g_value_dup_object (value);
       psf->zi = ncm_powspec_get_zi (psf->ps);
@@ -151,6 +158,9 @@ _ncm_powspec_filter_get_property (GObject *object, guint prop_id, GValue *value,
     case PROP_RELTOL:
       g_value_set_double (value, psf->reltol);
       break;
+    case PROP_FFT_NTHREADS:
+      g_value_set_uint (value, ncm_powspec_filter_get_fft_nthreads (psf));
+      break;
     case PROP_POWERSPECTRUM:
       g_value_set_object (value, psf->ps);
       break;
@@ -240,6 +250,13 @@ ncm_powspec_filter_class_init (NcmPowspecFilterClass *klass)
                                                         "Relative tolerance for calibration",
                                                         GSL_DBL_EPSILON, 1.0, 1.0e-3,
                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+  g_object_class_install_property (object_class,
+                                   PROP_FFT_NTHREADS,
+                                   g_param_spec_uint ("fft-nthreads",
+                                                      NULL,
+                                                      "Number of threads used by the batched transforms",
+                                                      1, G_MAXUINT, 1,
+                                                      G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
   g_object_class_install_property (object_class,
                                    PROP_TYPE,
                                    g_param_spec_enum ("type",
@@ -358,6 +375,7 @@ ncm_powspec_filter_set_type (NcmPowspecFilter *psf, NcmPowspecFilterType type)
 
     ncm_fftlog_set_padding (psf->fftlog, 1.0);
     ncm_fftlog_set_nderivs (psf->fftlog, 1);
+    ncm_fftlog_set_fft_nthreads (psf->fftlog, psf->fft_nthreads);
 
     ncm_powspec_filter_set_best_lnr0 (psf);
     
@@ -399,6 +417,81 @@ _ncm_powspec_filter_dummy_z (gdouble z, gpointer userdata)
   return ncm_vector_get (ncm_fftlog_peek_output_vector (arg->psf->fftlog, 0), 0);
 }
 
+/*
+ * Fills the rows of var and dvar with the filtered variance and its 
+ * derivative at the redshift knots z_vec. A separable spectrum requires 
+ * a single transform rescaled by G(z), otherwise all redshifts are 
+ * transformed together by ncm_fftlog_eval_by_matrix().
+ */
+static void
+_ncm_powspec_filter_eval_z_knots (NcmPowspecFilter *psf, NcmModel *model, NcmVector *z_vec, NcmMatrix *var, NcmMatrix *dvar)
+{
+  const guint N_z   = ncm_vector_len (z_vec);
+  const guint N_k   = ncm_fftlog_get_size (psf->fftlog);
+  NcmVector *k_vec  = ncm_vector_new (N_k);
+  NcmVector *Pk_vec = ncm_vector_new (N_k);
+  guint i, j;
+
+  ncm_fftlog_get_lnk_vector (psf->fftlog, k_vec);
+  for (j = 0; j < N_k; j++)
+    ncm_vector_set (k_vec, j, exp (ncm_vector_get (k_vec, j)));
+
+  if (ncm_powspec_is_separable (psf->ps))
+  {
+    const gdouble z0  = ncm_vector_get (z_vec, 0);
+    const gdouble G0  = ncm_powspec_eval_growth2 (psf->ps, model, z0);
+    NcmVector *var0, *dvar0;
+
+    ncm_powspec_eval_vec (psf->ps, model, z0, k_vec, Pk_vec);
+    for (j = 0; j < N_k; j++)
+    {
+      const gdouble k = ncm_vector_get (k_vec, j);
+      ncm_vector_set (Pk_vec, j, ncm_vector_get (Pk_vec, j) * k * k / (2.0 * M_PI * M_PI));
+    }
+
+    ncm_fftlog_eval_by_vector (psf->fftlog, Pk_vec);
+    var0  = ncm_fftlog_peek_output_vector (psf->fftlog, 0);
+    dvar0 = ncm_fftlog_peek_output_vector (psf->fftlog, 1);
+
+    for (i = 0; i < N_z; i++)
+    {
+      const gdouble G_G0 = ncm_powspec_eval_growth2 (psf->ps, model, ncm_vector_get (z_vec, i)) / G0;
+
+      for (j = 0; j < N_k; j++)
+      {
+        ncm_matrix_set (var,  i, j, G_G0 * ncm_vector_get (var0, j));
+        ncm_matrix_set (dvar, i, j, G_G0 * ncm_vector_get (dvar0, j));
+      }
+    }
+  }
+  else
+  {
+    NcmMatrix *Fk  = ncm_matrix_new (N_z, N_k);
+    GPtrArray *Gr  = g_ptr_array_new ();
+
+    for (i = 0; i < N_z; i++)
+    {
+      ncm_powspec_eval_vec (psf->ps, model, ncm_vector_get (z_vec, i), k_vec, Pk_vec);
+      for (j = 0; j < N_k; j++)
+      {
+        const gdouble k = ncm_vector_get (k_vec, j);
+        ncm_matrix_set (Fk, i, j, ncm_vector_get (Pk_vec, j) * k * k / (2.0 * M_PI * M_PI));
+      }
+    }
+
+    g_ptr_array_add (Gr, var);
+    g_ptr_array_add (Gr, dvar);
+
+    ncm_fftlog_eval_by_matrix (psf->fftlog, Fk, Gr);
+
+    g_ptr_array_unref (Gr);
+    ncm_matrix_free (Fk);
+  }
+
+  ncm_vector_free (k_vec);
+  ncm_vector_free (Pk_vec);
+}
+
 /**
  * ncm_powspec_filter_prepare:
  * @psf: a #NcmPowspecFilter
@@ -442,7 +535,6 @@ ncm_powspec_filter_prepare (NcmPowspecFilter *psf, NcmModel *model)
     NcmMatrix *lnvar, *dlnvar;
     NcmVector *z_vec, *lnr_vec;
     guint N_k = 0, N_z = 0;
-    guint i;
 
     ncm_powspec_get_nknots (psf->ps, &N_z, &N_k);
     
@@ -476,23 +568,8 @@ ncm_powspec_filter_prepare (NcmPowspecFilter *psf, NcmModel *model)
     lnvar   = ncm_matrix_new (N_z, N_k);
     dlnvar  = ncm_matrix_new (N_z, N_k);
     lnr_vec = ncm_fftlog_get_vector_lnr (psf->fftlog);
-        
-    for (i = 0; i < N_z; i++)
-    {
-      NcmVector *var_z  = ncm_matrix_get_row (lnvar, i);
-      NcmVector *dvar_z = ncm_matrix_get_row (dlnvar, i);
-
-      arg.z = ncm_vector_get (z_vec, i);
-      ncm_fftlog_eval_by_function (psf->fftlog, &F);
 
-      ncm_vector_memcpy (var_z, ncm_fftlog_peek_output_vector (psf->fftlog, 0));
-      ncm_vector_memcpy (dvar_z, ncm_fftlog_peek_output_vector (psf->fftlog, 1));
-
-      /*ncm_vector_log_vals (var_z, "NADA: ", "% 11.5e");*/
-
-      ncm_vector_free (var_z);
-      ncm_vector_free (dvar_z);
-    }
+    _ncm_powspec_filter_eval_z_knots (psf, model, z_vec, lnvar, dlnvar);
 
     ncm_spline2d_set (psf->var, lnr_vec, z_vec, lnvar, TRUE);
     ncm_spline2d_set (psf->dvar, lnr_vec, z_vec, dlnvar, TRUE);
@@ -508,21 +585,8 @@ ncm_powspec_filter_prepare (NcmPowspecFilter *psf, NcmModel *model)
   {
     NcmMatrix *lnvar  = psf->var->zm;
     NcmMatrix *dlnvar = psf->dvar->zm;
-    
-    guint N_z = ncm_matrix_nrows (lnvar);
-    guint i;
 
-    for (i = 0; i < N_z; i++)
-    {
-      NcmVector *var_z  = ncm_matrix_get_row (lnvar, i);
-      NcmVector *dvar_z = ncm_matrix_get_row (dlnvar, i);
-
-      arg.z = ncm_vector_get (psf->var->yv, i);
-      ncm_fftlog_eval_by_function (psf->fftlog, &F);
-
-      ncm_vector_memcpy (var_z, ncm_fftlog_peek_output_vector (psf->fftlog, 0));
-      ncm_vector_memcpy (dvar_z, ncm_fftlog_peek_output_vector (psf->fftlog, 1));
-    }
+    _ncm_powspec_filter_eval_z_knots (psf, model, psf->var->yv, lnvar, dlnvar);
 
     ncm_spline2d_prepare (psf->var);
     ncm_spline2d_prepare (psf->dvar);
@@ -600,6 +664,41 @@ ncm_powspec_filter_set_best_lnr0 (NcmPowspecFilter *psf)
   ncm_powspec_filter_set_lnr0 (psf, -psf->lnk0);
 }
 
+/**
+ * ncm_powspec_filter_set_fft_nthreads:
+ * @psf: a #NcmPowspecFilter
+ * @nthreads: number of threads
+ * 
+ * Sets the number of threads used by the batched transforms, these are 
+ * used when the power spectrum is not separable, see
+ * ncm_fftlog_set_fft_nthreads().
+ * 
+ */
+void
+ncm_powspec_filter_set_fft_nthreads (NcmPowspecFilter *psf, guint nthreads)
+{
+  g_assert_cmpuint (nthreads, >, 0);
+  psf->fft_nthreads = nthreads;
+
+  if (psf->fftlog != NULL)
+  {
+    ncm_fftlog_set_fft_nthreads (psf->fftlog, nthreads);
+    psf->fft_nthreads = ncm_fftlog_get_fft_nthreads (psf->fftlog);
+  }
+}
+
+/**
+ * ncm_powspec_filter_get_fft_nthreads:
+ * @psf: a #NcmPowspecFilter
+ * 
+ * Returns: the number of threads used by the batched transforms.
+ */
+guint
+ncm_powspec_filter_get_fft_nthreads (NcmPowspecFilter *psf)
+{
+  return psf->fft_nthreads;
+}
+
 /**
  * ncm_powspec_filter_set_zi:
  * @psf: a #NcmPowspecFilter
@@ -796,6 +895,57 @@ ncm_powspec_filter_eval_dlnvar_dr (NcmPowspecFilter *psf, const gdouble z, const
   return ncm_powspec_filter_eval_dlnvar_dlnr (psf, z, lnr) * exp (-lnr);
 }
 
+static void
+_ncm_powspec_filter_eval_z_row (NcmSpline2d *s2d, const gdouble z, const gdouble *lnr, gdouble *res, const guint n)
+{
+  gdouble zv[NCM_SPLINE_VEC_BLOCK];
+  guint k;
+
+  for (k = 0; k < GSL_MIN (n, NCM_SPLINE_VEC_BLOCK); k++)
+    zv[k] = z;
+
+  for (k = 0; k < n; k += NCM_SPLINE_VEC_BLOCK)
+    ncm_spline2d_eval_vec (s2d, &lnr[k], zv, &res[k], GSL_MIN (n - k, NCM_SPLINE_VEC_BLOCK));
+}
+
+/**
+ * ncm_powspec_filter_eval_var_lnr_vec:
+ * @psf: a #NcmPowspecFilter
+ * @z: redshift
+ * @lnr: (array length=n): logarithm base e of $r$
+ * @var: (out caller-allocates) (array length=n): filtered variance
+ * @n: number of points
+ *
+ * Block version of ncm_powspec_filter_eval_var_lnr(), evaluates the
+ * filtered power spectrum at the @n values of @lnr and the same redshift @z.
+ * Sorted @lnr are located faster.
+ *
+ */
+void
+ncm_powspec_filter_eval_var_lnr_vec (NcmPowspecFilter *psf, const gdouble z, const gdouble *lnr, gdouble *var, const guint n)
+{
+  _ncm_powspec_filter_eval_z_row (psf->var, z, lnr, var, n);
+}
+
+/**
+ * ncm_powspec_filter_eval_dvar_dlnr_vec:
+ * @psf: a #NcmPowspecFilter
+ * @z: redshift
+ * @lnr: (array length=n): logarithm base e of $r$
+ * @dvar: (out caller-allocates) (array length=n): derivative of the filtered variance
+ * @n: number of points
+ *
+ * Block version of ncm_powspec_filter_eval_dvar_dlnr(), evaluates the
+ * derivative of the filtered variance with respect to $\ln(r)$ at the @n
+ * values of @lnr and the same redshift @z.
+ *
+ */
+void
+ncm_powspec_filter_eval_dvar_dlnr_vec (NcmPowspecFilter *psf, const gdouble z, const gdouble *lnr, gdouble *dvar, const guint n)
+{
+  _ncm_powspec_filter_eval_z_row (psf->dvar, z, lnr, dvar, n);
+}
+
 /**
  * ncm_powspec_filter_eval_dnvar_dlnrn:
  * @psf: a #NcmPowspecFilter
@@ -82,6 +82,7 @@ struct _NcmPowspecFilter
   gdouble zf;
   gboolean calibrated;
   gdouble reltol;
+  guint fft_nthreads;
   NcmSpline2d *var;
   NcmSpline2d *dvar;
   NcmModelCtrl *ctrl;
@@ -105,6 +106,9 @@ void ncm_powspec_filter_set_best_lnr0 (NcmPowspecFilter *psf);
 void ncm_powspec_filter_set_zi (NcmPowspecFilter *psf, gdouble zi);
 void ncm_powspec_filter_set_zf (NcmPowspecFilter *psf, gdouble zf);
 
+void ncm_powspec_filter_set_fft_nthreads (NcmPowspecFilter *psf, guint nthreads);
+guint ncm_powspec_filter_get_fft_nthreads (NcmPowspecFilter *psf);
+
 gdouble ncm_powspec_filter_get_r_min (NcmPowspecFilter *psf);
 gdouble ncm_powspec_filter_get_r_max (NcmPowspecFilter *psf);
 
@@ -118,6 +122,9 @@ gdouble ncm_powspec_filter_eval_dvar_dlnr (NcmPowspecFilter *psf, const gdouble
 gdouble ncm_powspec_filter_eval_dlnvar_dlnr (NcmPowspecFilter *psf, const gdouble z, const gdouble lnr);
 gdouble ncm_powspec_filter_eval_dlnvar_dr (NcmPowspecFilter *psf, const gdouble z, const gdouble lnr);
 
+void ncm_powspec_filter_eval_var_lnr_vec (NcmPowspecFilter *psf, const gdouble z, const gdouble *lnr, gdouble *var, const guint n);
+void ncm_powspec_filter_eval_dvar_dlnr_vec (NcmPowspecFilter *psf, const gdouble z, const gdouble *lnr, gdouble *dvar, const guint n);
+
 gdouble ncm_powspec_filter_eval_dnvar_dlnrn (NcmPowspecFilter *psf, const gdouble z, const gdouble lnr, guint n);
 gdouble ncm_powspec_filter_eval_dnlnvar_dlnrn (NcmPowspecFilter *psf, const gdouble z, const gdouble lnr, guint n);
 
@@ -57,8 +57,12 @@ ncm_spline_init (NcmSpline *s)
   s->len   = 0;
   s->xv    = NULL;
   s->yv    = NULL;
-  s->empty = TRUE;
-  s->acc   = NULL;
+  s->empty  = TRUE;
+  s->acc    = TRUE;
+  s->bucket = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  s->bucket_x0     = 0.0;
+  s->bucket_inv_dx = 0.0;
 }
 
 static void
@@ -131,7 +135,7 @@ _ncm_spline_get_property (GObject *object, guint prop_id, GValue *value, GParamS
       g_value_set_object (value, s->yv);
       break;
     case PROP_ACC:
-      g_value_set_boolean (value, s->acc != NULL ? TRUE : FALSE);
+      g_value_set_boolean (value, s->acc);
       break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -158,12 +162,52 @@ _ncm_spline_finalize (GObject *object)
 {
   NcmSpline *s = NCM_SPLINE (object);
 
-  g_clear_pointer (&s->acc, gsl_interp_accel_free);
+  g_clear_pointer (&s->bucket, g_array_unref);
 
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_spline_parent_class)->finalize (object);
 }
 
+static void
+_ncm_spline_eval_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n)
+{
+  NcmSplineClass *spline_class = NCM_SPLINE_GET_CLASS (s);
+  guint k;
+
+  for (k = 0; k < n; k++)
+    y[k] = spline_class->eval (s, x[k]);
+}
+
+static void
+_ncm_spline_deriv_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n)
+{
+  NcmSplineClass *spline_class = NCM_SPLINE_GET_CLASS (s);
+  guint k;
+
+  for (k = 0; k < n; k++)
+    y[k] = spline_class->deriv (s, x[k]);
+}
+
+static void
+_ncm_spline_deriv2_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n)
+{
+  NcmSplineClass *spline_class = NCM_SPLINE_GET_CLASS (s);
+  guint k;
+
+  for (k = 0; k < n; k++)
+    y[k] = spline_class->deriv2 (s, x[k]);
+}
+
+static void
+_ncm_spline_integ_vec (const NcmSpline *s, const gdouble *x0, const gdouble *x1, gdouble *res, const guint n)
+{
+  NcmSplineClass *spline_class = NCM_SPLINE_GET_CLASS (s);
+  guint k;
+
+  for (k = 0; k < n; k++)
+    res[k] = spline_class->integ (s, x0[k], x1[k]);
+}
+
 static void
 ncm_spline_class_init (NcmSplineClass *klass)
 {
@@ -208,6 +252,11 @@ ncm_spline_class_init (NcmSplineClass *klass)
   klass->deriv = NULL;
   klass->deriv2 = NULL;
   klass->integ = NULL;  
+
+  klass->eval_vec   = &_ncm_spline_eval_vec;
+  klass->deriv_vec  = &_ncm_spline_deriv_vec;
+  klass->deriv2_vec = &_ncm_spline_deriv2_vec;
+  klass->integ_vec  = &_ncm_spline_integ_vec;
 }
 
 /**
@@ -361,16 +410,11 @@ ncm_spline_set (NcmSpline *s, NcmVector *xv, NcmVector *yv, gboolean init)
 	NCM_SPLINE_GET_CLASS (s)->reset (s);
 
 	s->empty = FALSE;
+  g_array_set_size (s->bucket, 0);
 
 	if (init)
 		ncm_spline_prepare (s);
 
-  if (s->acc != NULL)
-  {
-    ncm_spline_acc (s, FALSE);
-    ncm_spline_acc (s, TRUE);
-  }
-
 	return s;
 }
 
@@ -419,28 +463,23 @@ ncm_spline_clear (NcmSpline **s)
  * @s: a #NcmSpline
  * @enable: a boolean
  *
- * Enables or disables spline accelerator. Note that, if 
- * enabled, the spline becomes non-reentrant. In other words, 
- * if @enable is TRUE, the spline evaluation is not thread safe. 
- * Therefore, it should not be called concomitantly by two different threads. 
- *
- * Warning: the accelerator must be reset if the spline's size changes, otherwise, 
- * it can accessan out-of-bound index. 
+ * Enables or disables the spline accelerator. The accelerator is a
+ * read-only bucket index over the knots, built by ncm_spline_prepare().
+ * Each bucket stores the first knot below its lower edge, so for
+ * near-uniform knots the interval search takes O(1) steps. Since the
+ * index is never modified during evaluation, the spline remains
+ * thread safe when the accelerator is enabled.
  *
  */
 void 
 ncm_spline_acc (NcmSpline *s, gboolean enable)
 {
-  if (enable)
-  {
-    if (s->acc == NULL)
-      s->acc = gsl_interp_accel_alloc ();
-  }
-  else if (s->acc != NULL)
-  {
-    gsl_interp_accel_free (s->acc);
-    s->acc = NULL;
-  }
+  s->acc = enable;
+
+  if (enable && s->init && !s->empty)
+    _ncm_spline_build_index (s);
+  else
+    g_array_set_size (s->bucket, 0);
 }
 
 /**
@@ -627,6 +666,209 @@ ncm_spline_get_bounds (NcmSpline *s, gdouble *lb, gdouble *ub)
  * bidimensional spline.
  *
  */
+/**
+ * _ncm_spline_util_index_vec: (skip)
+ * @xa: knots array
+ * @len: length of @xa
+ * @x: (array length=n): abscissa values
+ * @idx: (out caller-allocates) (array length=n): knot indexes
+ * @n: number of points
+ *
+ * Finds, for each @x[k], the index of the lower knot of the interval it
+ * belongs to, with the same clamping as gsl_interp_bsearch(). The search
+ * starts from the previous result, so sorted (or nearly sorted) inputs are
+ * resolved in a single merged pass and only out-of-order points fall back
+ * to a bisection.
+ *
+ */
+void
+_ncm_spline_util_index_vec (const gdouble *xa, const guint len, const gdouble *x, guint *idx, const guint n)
+{
+  const guint last = len - 1;
+  guint i = 0;
+  guint k;
+
+  for (k = 0; k < n; k++)
+  {
+    const gdouble xk = x[k];
+
+    if (xk < xa[i])
+      i = gsl_interp_bsearch (xa, xk, 0, i);
+    else if ((i + 1 < last) && (xk >= xa[i + 1]))
+    {
+      if ((i + 2 == last) || (xk < xa[i + 2]))
+        i++;
+      else
+        i = gsl_interp_bsearch (xa, xk, i + 2, last);
+    }
+
+    idx[k] = i;
+  }
+}
+
+/**
+ * _ncm_spline_util_bucket_build: (skip)
+ * @bucket: a #GArray of guint
+ * @xa: knots array
+ * @len: length of @xa
+ * @x0: (out): lower edge of the first bucket
+ * @inv_dx: (out): inverse of the bucket width
+ *
+ * Builds a uniform bucket index over the knots @xa. It uses 2 (@len - 1)
+ * buckets and entry $b$ holds the index of the lower knot of the point
+ * @x0 + $b$ / @inv_dx. The array gets one extra entry for the upper edge.
+ *
+ * Returns: whether the index could be built (at least two strictly increasing knots).
+ */
+gboolean
+_ncm_spline_util_bucket_build (GArray *bucket, const gdouble *xa, const guint len, gdouble *x0, gdouble *inv_dx)
+{
+  const guint last = len - 1;
+  guint nb, b, i;
+  gdouble dx;
+
+  if (len < 2)
+  {
+    g_array_set_size (bucket, 0);
+    return FALSE;
+  }
+
+  nb = 2 * last;
+  dx = (xa[last] - xa[0]) / nb;
+
+  if (!(dx > 0.0))
+  {
+    g_array_set_size (bucket, 0);
+    return FALSE;
+  }
+
+  g_array_set_size (bucket, nb + 1);
+
+  i = 0;
+  for (b = 0; b <= nb; b++)
+  {
+    const gdouble xb = xa[0] + b * dx;
+    while ((i + 2 <= last) && (xa[i + 1] <= xb))
+      i++;
+    g_array_index (bucket, guint, b) = i;
+  }
+
+  *x0     = xa[0];
+  *inv_dx = 1.0 / dx;
+
+  return TRUE;
+}
+
+/**
+ * _ncm_spline_build_index: (skip)
+ * @s: a #NcmSpline
+ *
+ * Builds the accelerator index of @s, see ncm_spline_acc().
+ *
+ */
+void
+_ncm_spline_build_index (NcmSpline *s)
+{
+  if (ncm_vector_stride (s->xv) != 1)
+    g_array_set_size (s->bucket, 0);
+  else
+    _ncm_spline_util_bucket_build (s->bucket, ncm_vector_const_ptr (s->xv, 0), s->len, &s->bucket_x0, &s->bucket_inv_dx);
+}
+
+/**
+ * ncm_spline_get_index_vec:
+ * @s: a constant #NcmSpline
+ * @x: (array length=n): abscissa values
+ * @idx: (out caller-allocates) (array length=n): knot indexes
+ * @n: number of points
+ *
+ * Computes ncm_spline_get_index() for the @n points in @x. The search
+ * is thread safe. The input does not need to be sorted, though sorted
+ * inputs are faster when the knots are contiguous.
+ *
+ */
+void
+ncm_spline_get_index_vec (const NcmSpline *s, const gdouble *x, guint *idx, const guint n)
+{
+  if (ncm_vector_stride (s->xv) == 1)
+    _ncm_spline_util_index_vec (ncm_vector_const_ptr (s->xv, 0), s->len, x, idx, n);
+  else
+  {
+    /* No block search for strided knots, one ncm_spline_get_index() per point. */
+    guint k;
+    for (k = 0; k < n; k++)
+      idx[k] = ncm_spline_get_index (s, x[k]);
+  }
+}
+
+/**
+ * ncm_spline_eval_vec: (virtual eval_vec)
+ * @s: a constant #NcmSpline
+ * @x: (array length=n): x-coordinate values
+ * @y: (out caller-allocates) (array length=n): interpolated values
+ * @n: number of points
+ *
+ * Evaluates the spline in all @n points of @x, i.e., @y[k] = ncm_spline_eval (@s, @x[k]).
+ * Subclasses can provide a block implementation, otherwise it falls back
+ * to point by point evaluation.
+ *
+ */
+void
+ncm_spline_eval_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n)
+{
+  NCM_SPLINE_GET_CLASS (s)->eval_vec (s, x, y, n);
+}
+
+/**
+ * ncm_spline_eval_deriv_vec: (virtual deriv_vec)
+ * @s: a constant #NcmSpline
+ * @x: (array length=n): x-coordinate values
+ * @y: (out caller-allocates) (array length=n): derivative values
+ * @n: number of points
+ *
+ * Vector version of ncm_spline_eval_deriv(), see ncm_spline_eval_vec().
+ *
+ */
+void
+ncm_spline_eval_deriv_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n)
+{
+  NCM_SPLINE_GET_CLASS (s)->deriv_vec (s, x, y, n);
+}
+
+/**
+ * ncm_spline_eval_deriv2_vec: (virtual deriv2_vec)
+ * @s: a constant #NcmSpline
+ * @x: (array length=n): x-coordinate values
+ * @y: (out caller-allocates) (array length=n): second derivative values
+ * @n: number of points
+ *
+ * Vector version of ncm_spline_eval_deriv2(), see ncm_spline_eval_vec().
+ *
+ */
+void
+ncm_spline_eval_deriv2_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n)
+{
+  NCM_SPLINE_GET_CLASS (s)->deriv2_vec (s, x, y, n);
+}
+
+/**
+ * ncm_spline_eval_integ_vec: (virtual integ_vec)
+ * @s: a constant #NcmSpline
+ * @x0: (array length=n): lower integration limits
+ * @x1: (array length=n): upper integration limits
+ * @res: (out caller-allocates) (array length=n): integrals
+ * @n: number of intervals
+ *
+ * Computes @res[k] = ncm_spline_eval_integ (@s, @x0[k], @x1[k]) for all
+ * @n intervals.
+ *
+ */
+void
+ncm_spline_eval_integ_vec (const NcmSpline *s, const gdouble *x0, const gdouble *x1, gdouble *res, const guint n)
+{
+  NCM_SPLINE_GET_CLASS (s)->integ_vec (s, x0, x1, res, n);
+}
+
 /**
  * ncm_spline_eval:
  * @s: a constant #NcmSpline
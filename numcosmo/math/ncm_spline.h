@@ -58,6 +58,10 @@ struct _NcmSplineClass
   gdouble (*deriv_nmax) (const NcmSpline *s, const gdouble x);
   gdouble (*integ) (const NcmSpline *s, const gdouble xi, const gdouble xf);
   NcmSpline *(*copy_empty) (const NcmSpline *s);
+  void (*eval_vec) (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n);
+  void (*deriv_vec) (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n);
+  void (*deriv2_vec) (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n);
+  void (*integ_vec) (const NcmSpline *s, const gdouble *x0, const gdouble *x1, gdouble *res, const guint n);
 };
 
 struct _NcmSpline
@@ -67,7 +71,10 @@ struct _NcmSpline
   gsize len;
   NcmVector *xv;
   NcmVector *yv;
-  gsl_interp_accel *acc;
+  gboolean acc;
+  GArray *bucket;
+  gdouble bucket_x0;
+  gdouble bucket_inv_dx;
   gboolean init;
   gboolean empty;
 };
@@ -99,6 +106,12 @@ void ncm_spline_get_bounds (NcmSpline *s, gdouble *lb, gdouble *ub);
 void ncm_spline_free (NcmSpline *s);
 void ncm_spline_clear (NcmSpline **s);
 
+void ncm_spline_get_index_vec (const NcmSpline *s, const gdouble *x, guint *idx, const guint n);
+void ncm_spline_eval_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n);
+void ncm_spline_eval_deriv_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n);
+void ncm_spline_eval_deriv2_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n);
+void ncm_spline_eval_integ_vec (const NcmSpline *s, const gdouble *x0, const gdouble *x1, gdouble *res, const guint n);
+
 G_INLINE_FUNC void ncm_spline_prepare (NcmSpline *s);
 G_INLINE_FUNC void ncm_spline_prepare_base (NcmSpline *s);
 G_INLINE_FUNC gdouble ncm_spline_eval (const NcmSpline *s, const gdouble x);
@@ -112,8 +125,14 @@ G_INLINE_FUNC guint ncm_spline_get_index (const NcmSpline *s, const gdouble x);
 
 /* Utilities -- internal use */
 
+void _ncm_spline_util_index_vec (const gdouble *xa, const guint len, const gdouble *x, guint *idx, const guint n);
+gboolean _ncm_spline_util_bucket_build (GArray *bucket, const gdouble *xa, const guint len, gdouble *x0, gdouble *inv_dx);
+G_INLINE_FUNC guint _ncm_spline_util_bucket_find (const GArray *bucket, const gdouble x0, const gdouble inv_dx, const gdouble *xa, const guint len, const gdouble x);
+void _ncm_spline_build_index (NcmSpline *s);
 G_INLINE_FUNC gdouble _ncm_spline_util_integ_eval (const gdouble ai, const gdouble bi, const gdouble ci, const gdouble di, const gdouble xi, const gdouble a, const gdouble b);
 
+#define NCM_SPLINE_VEC_BLOCK (256)
+
 G_END_DECLS
 
 #endif /* _NCM_SPLINE_H_ */
@@ -128,7 +147,10 @@ G_INLINE_FUNC void
 ncm_spline_prepare (NcmSpline *s)
 {
   s->init = TRUE;
+  g_array_set_size (s->bucket, 0);
   NCM_SPLINE_GET_CLASS (s)->prepare (s);
+  if (s->acc)
+    _ncm_spline_build_index (s);
 }
 
 G_INLINE_FUNC void
@@ -183,14 +205,51 @@ ncm_spline_min_size (const NcmSpline *s)
 G_INLINE_FUNC guint
 ncm_spline_get_index (const NcmSpline *s, const gdouble x)
 {
-  if (s->acc && ncm_vector_stride (s->xv) == 1)
-  	return gsl_interp_accel_find (s->acc, ncm_vector_ptr (s->xv, 0), s->len, x);
+  if (s->bucket->len > 0)
+    return _ncm_spline_util_bucket_find (s->bucket, s->bucket_x0, s->bucket_inv_dx, ncm_vector_const_ptr (s->xv, 0), s->len, x);
 	else
-		return gsl_interp_bsearch (ncm_vector_ptr (s->xv, 0), x, 0, ncm_vector_len (s->xv) - 1);
+		return gsl_interp_bsearch (ncm_vector_const_ptr (s->xv, 0), x, 0, ncm_vector_len (s->xv) - 1);
 }
 
 /* Utilities -- internal use */
 
+G_INLINE_FUNC guint
+_ncm_spline_util_bucket_find (const GArray *bucket, const gdouble x0, const gdouble inv_dx, const gdouble *xa, const guint len, const gdouble x)
+{
+  const guint *bidx = (const guint *) bucket->data;
+  const guint nb    = bucket->len - 1;
+  const guint last  = len - 1;
+  const gdouble t   = (x - x0) * inv_dx;
+
+  if (!(t >= 0.0))
+    return 0;
+  else if (t >= nb)
+    return gsl_interp_bsearch (xa, x, bidx[nb - 1], last);
+  else
+  {
+    const guint b = (guint) t;
+    guint lo = bidx[b];
+    guint hi = bidx[b + 1] + 1;
+
+    /* Rounding in t can move x just outside its bucket. */
+    if (x < xa[lo])
+      lo = 0;
+    if ((hi < last) && (x >= xa[hi]))
+      hi = last;
+
+    while (hi > lo + 1)
+    {
+      const guint i = (hi + lo) / 2;
+      if (xa[i] > x)
+        hi = i;
+      else
+        lo = i;
+    }
+
+    return lo;
+  }
+}
+
 G_INLINE_FUNC gdouble
 _ncm_spline_util_integ_eval (const gdouble ai, const gdouble bi, const gdouble ci, const gdouble di, const gdouble xi, const gdouble a, const gdouble b)
 {
@@ -63,13 +63,18 @@ ncm_spline2d_init (NcmSpline2d *s2d)
   s2d->empty     = TRUE;
   s2d->init      = FALSE;
   s2d->to_init   = FALSE;
-  s2d->acc_x     = gsl_interp_accel_alloc ();
-  s2d->acc_y     = gsl_interp_accel_alloc ();
+  s2d->bucket_x  = g_array_new (FALSE, FALSE, sizeof (guint));
+  s2d->bucket_y  = g_array_new (FALSE, FALSE, sizeof (guint));
+  s2d->bucket_x0     = 0.0;
+  s2d->bucket_inv_dx = 0.0;
+  s2d->bucket_y0     = 0.0;
+  s2d->bucket_inv_dy = 0.0;
   s2d->use_acc   = FALSE;
   s2d->no_stride = FALSE;
 }
 
 static void _ncm_spline2d_makeup (NcmSpline2d *s2d);
+static void _ncm_spline2d_build_index (NcmSpline2d *s2d);
 
 static void
 _ncm_spline2d_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
@@ -165,13 +170,43 @@ ncm_spline2d_finalize (GObject *object)
 {
   NcmSpline2d *s2d = NCM_SPLINE2D (object);
 
-  g_clear_pointer (&s2d->acc_x, gsl_interp_accel_free);
-  g_clear_pointer (&s2d->acc_y, gsl_interp_accel_free);
+  g_clear_pointer (&s2d->bucket_x, g_array_unref);
+  g_clear_pointer (&s2d->bucket_y, g_array_unref);
   
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_spline2d_parent_class)->finalize (object);
 }
 
+static void
+_ncm_spline2d_eval_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n)
+{
+  NcmSpline2dClass *s2d_class = NCM_SPLINE2D_GET_CLASS (s2d);
+  guint k;
+
+  for (k = 0; k < n; k++)
+    z[k] = s2d_class->eval (s2d, x[k], y[k]);
+}
+
+static void
+_ncm_spline2d_dzdx_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n)
+{
+  NcmSpline2dClass *s2d_class = NCM_SPLINE2D_GET_CLASS (s2d);
+  guint k;
+
+  for (k = 0; k < n; k++)
+    z[k] = s2d_class->dzdx (s2d, x[k], y[k]);
+}
+
+static void
+_ncm_spline2d_dzdy_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n)
+{
+  NcmSpline2dClass *s2d_class = NCM_SPLINE2D_GET_CLASS (s2d);
+  guint k;
+
+  for (k = 0; k < n; k++)
+    z[k] = s2d_class->dzdy (s2d, x[k], y[k]);
+}
+
 static void
 ncm_spline2d_class_init (NcmSpline2dClass *klass)
 {
@@ -196,6 +231,9 @@ ncm_spline2d_class_init (NcmSpline2dClass *klass)
   klass->int_dxdy      = NULL;
   klass->int_dx_spline = NULL;
   klass->int_dy_spline = NULL;
+  klass->eval_vec      = &_ncm_spline2d_eval_vec;
+  klass->dzdx_vec      = &_ncm_spline2d_dzdx_vec;
+  klass->dzdy_vec      = &_ncm_spline2d_dzdy_vec;
 
   /**
    * NcmSpline2d:spline:
@@ -267,7 +305,7 @@ ncm_spline2d_class_init (NcmSpline2dClass *klass)
                                    PROP_USE_ACC,
                                    g_param_spec_boolean ("use-acc",
                                                          NULL,
-                                                         "Use accelerated bsearch",
+                                                         "Use bucket index knot search",
                                                          FALSE,
                                                          G_PARAM_READWRITE | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
@@ -296,6 +334,8 @@ _ncm_spline2d_makeup (NcmSpline2d *s2d)
     }
 
     NCM_SPLINE2D_GET_CLASS (s2d)->reset (s2d);
+    g_array_set_size (s2d->bucket_x, 0);
+    g_array_set_size (s2d->bucket_y, 0);
 
     if (s2d->to_init)
       ncm_spline2d_prepare (s2d);
@@ -414,6 +454,23 @@ ncm_spline2d_min_size (NcmSpline2d *s2d)
 void ncm_spline2d_prepare (NcmSpline2d *s2d)
 {
   NCM_SPLINE2D_GET_CLASS (s2d)->prepare (s2d);
+  _ncm_spline2d_build_index (s2d);
+}
+
+static void
+_ncm_spline2d_build_index (NcmSpline2d *s2d)
+{
+  if (s2d->use_acc && s2d->no_stride)
+  {
+    gboolean built_x = _ncm_spline_util_bucket_build (s2d->bucket_x, ncm_vector_const_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), &s2d->bucket_x0, &s2d->bucket_inv_dx);
+    gboolean built_y = _ncm_spline_util_bucket_build (s2d->bucket_y, ncm_vector_const_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), &s2d->bucket_y0, &s2d->bucket_inv_dy);
+
+    if (built_x && built_y)
+      return;
+  }
+
+  g_array_set_size (s2d->bucket_x, 0);
+  g_array_set_size (s2d->bucket_y, 0);
 }
 
 /**
@@ -447,9 +504,10 @@ ncm_spline2d_clear (NcmSpline2d **s2d)
  * @s2d: a #NcmSpline2d
  * @use_acc: a boolean
  * 
- * Whether to use accelerated bsearch to find the
- * right knots. When enabled evalulation functions
- * are not reentrant.
+ * Whether to use a read-only bucket index to find the
+ * right knots, see ncm_spline_acc(). The index is built
+ * by ncm_spline2d_prepare() and the evaluation functions
+ * remain reentrant.
  * 
  */
 void 
@@ -464,6 +522,8 @@ ncm_spline2d_use_acc (NcmSpline2d *s2d, gboolean use_acc)
       s2d->use_acc = FALSE;
     }
   }
+  if (s2d->init)
+    _ncm_spline2d_build_index (s2d);
 }
 
 /**
@@ -648,6 +708,107 @@ ncm_spline2d_integ_dxdy_spline_y (NcmSpline2d *s2d, gdouble xl, gdouble xu, gdou
   return ncm_spline_eval_integ (NCM_SPLINE2D_GET_CLASS (s2d)->int_dy_spline (s2d, yl, yu), xl, xu);
 }
 
+/**
+ * ncm_spline2d_eval_vec: (virtual eval_vec)
+ * @s2d: a #NcmSpline2d
+ * @x: (array length=n): x-coordinate values
+ * @y: (array length=n): y-coordinate values
+ * @z: (out caller-allocates) (array length=n): interpolated values
+ * @n: number of points
+ *
+ * Evaluates @s2d in the @n points (@x[k], @y[k]), the points do not need
+ * to be sorted. Subclasses can provide a block implementation, otherwise
+ * it falls back to point by point evaluation.
+ *
+ */
+void
+ncm_spline2d_eval_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n)
+{
+  if (!s2d->init)
+    ncm_spline2d_prepare (s2d);
+  NCM_SPLINE2D_GET_CLASS (s2d)->eval_vec (s2d, x, y, z, n);
+}
+
+/**
+ * ncm_spline2d_deriv_dzdx_vec: (virtual dzdx_vec)
+ * @s2d: a #NcmSpline2d
+ * @x: (array length=n): x-coordinate values
+ * @y: (array length=n): y-coordinate values
+ * @z: (out caller-allocates) (array length=n): derivative values
+ * @n: number of points
+ *
+ * Vector version of ncm_spline2d_deriv_dzdx(), see ncm_spline2d_eval_vec().
+ *
+ */
+void
+ncm_spline2d_deriv_dzdx_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n)
+{
+  if (!s2d->init)
+    ncm_spline2d_prepare (s2d);
+  NCM_SPLINE2D_GET_CLASS (s2d)->dzdx_vec (s2d, x, y, z, n);
+}
+
+/**
+ * ncm_spline2d_deriv_dzdy_vec: (virtual dzdy_vec)
+ * @s2d: a #NcmSpline2d
+ * @x: (array length=n): x-coordinate values
+ * @y: (array length=n): y-coordinate values
+ * @z: (out caller-allocates) (array length=n): derivative values
+ * @n: number of points
+ *
+ * Vector version of ncm_spline2d_deriv_dzdy(), see ncm_spline2d_eval_vec().
+ *
+ */
+void
+ncm_spline2d_deriv_dzdy_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n)
+{
+  if (!s2d->init)
+    ncm_spline2d_prepare (s2d);
+  NCM_SPLINE2D_GET_CLASS (s2d)->dzdy_vec (s2d, x, y, z, n);
+}
+
+/**
+ * ncm_spline2d_integ_dx_spline_vec:
+ * @s2d: a #NcmSpline2d
+ * @xl: lower limit of integration
+ * @xu: upper limit of integration
+ * @y: (array length=n): y-coordinate values
+ * @res: (out caller-allocates) (array length=n): integrals
+ * @n: number of points
+ *
+ * Vector version of ncm_spline2d_integ_dx_spline_val(), the x-integrated
+ * spline is computed once and evaluated in all @n points of @y.
+ *
+ */
+void
+ncm_spline2d_integ_dx_spline_vec (NcmSpline2d *s2d, gdouble xl, gdouble xu, const gdouble *y, gdouble *res, const guint n)
+{
+  if (!s2d->init)
+    ncm_spline2d_prepare (s2d);
+  ncm_spline_eval_vec (NCM_SPLINE2D_GET_CLASS (s2d)->int_dx_spline (s2d, xl, xu), y, res, n);
+}
+
+/**
+ * ncm_spline2d_integ_dy_spline_vec:
+ * @s2d: a #NcmSpline2d
+ * @x: (array length=n): x-coordinate values
+ * @yl: lower limit of integration
+ * @yu: upper limit of integration
+ * @res: (out caller-allocates) (array length=n): integrals
+ * @n: number of points
+ *
+ * Vector version of ncm_spline2d_integ_dy_spline_val(), the y-integrated
+ * spline is computed once and evaluated in all @n points of @x.
+ *
+ */
+void
+ncm_spline2d_integ_dy_spline_vec (NcmSpline2d *s2d, const gdouble *x, gdouble yl, gdouble yu, gdouble *res, const guint n)
+{
+  if (!s2d->init)
+    ncm_spline2d_prepare (s2d);
+  ncm_spline_eval_vec (NCM_SPLINE2D_GET_CLASS (s2d)->int_dy_spline (s2d, yl, yu), x, res, n);
+}
+
 /**
  * ncm_spline2d_eval:
  * @s2d: a #NcmSpline2d
@@ -61,6 +61,9 @@ struct _NcmSpline2dClass
   gdouble (*int_dxdy) (NcmSpline2d *s2d, gdouble xl, gdouble xu, gdouble yl, gdouble yu);
   NcmSpline *(*int_dx_spline) (NcmSpline2d *s2d, gdouble xl, gdouble xu);
   NcmSpline *(*int_dy_spline) (NcmSpline2d *s2d, gdouble yl, gdouble yu);
+  void (*eval_vec) (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n);
+  void (*dzdx_vec) (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n);
+  void (*dzdy_vec) (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n);
 };
 
 struct _NcmSpline2d
@@ -74,8 +77,12 @@ struct _NcmSpline2d
   NcmVector *xv;
   NcmVector *yv;
   NcmMatrix *zm;
-  gsl_interp_accel *acc_x;
-  gsl_interp_accel *acc_y;
+  GArray *bucket_x;
+  GArray *bucket_y;
+  gdouble bucket_x0;
+  gdouble bucket_inv_dx;
+  gdouble bucket_y0;
+  gdouble bucket_inv_dy;
   gboolean use_acc;
   gboolean no_stride;
 };
@@ -108,6 +115,12 @@ gdouble ncm_spline2d_integ_dy_spline_val (NcmSpline2d *s2d, gdouble x, gdouble y
 gdouble ncm_spline2d_integ_dxdy_spline_x (NcmSpline2d *s2d, gdouble xl, gdouble xu, gdouble yl, gdouble yu);
 gdouble ncm_spline2d_integ_dxdy_spline_y (NcmSpline2d *s2d, gdouble xl, gdouble xu, gdouble yl, gdouble yu);
 
+void ncm_spline2d_eval_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n);
+void ncm_spline2d_deriv_dzdx_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n);
+void ncm_spline2d_deriv_dzdy_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n);
+void ncm_spline2d_integ_dx_spline_vec (NcmSpline2d *s2d, gdouble xl, gdouble xu, const gdouble *y, gdouble *res, const guint n);
+void ncm_spline2d_integ_dy_spline_vec (NcmSpline2d *s2d, const gdouble *x, gdouble yl, gdouble yu, gdouble *res, const guint n);
+
 G_INLINE_FUNC gdouble ncm_spline2d_deriv_dzdx (NcmSpline2d *s2d, gdouble x, gdouble y);
 G_INLINE_FUNC gdouble ncm_spline2d_deriv_dzdy (NcmSpline2d *s2d, gdouble x, gdouble y);
 G_INLINE_FUNC gdouble ncm_spline2d_deriv_d2zdxy (NcmSpline2d *s2d, gdouble x, gdouble y);
@@ -40,6 +40,8 @@
 #include "math/ncm_spline_cubic_notaknot.h"
 #include "math/ncm_util.h"
 
+#include <gsl/gsl_math.h>
+
 G_DEFINE_TYPE (NcmSpline2dBicubic, ncm_spline2d_bicubic, NCM_TYPE_SPLINE2D);
 
 static void
@@ -104,6 +106,9 @@ static gdouble _ncm_spline2d_bicubic_int_dy (NcmSpline2d *s2d, gdouble x, gdoubl
 static gdouble _ncm_spline2d_bicubic_int_dxdy (NcmSpline2d *s2d, gdouble xl, gdouble xu, gdouble yl, gdouble yu);
 static NcmSpline *_ncm_spline2d_bicubic_int_dx_spline (NcmSpline2d *s2d, gdouble xl, gdouble xu);
 static NcmSpline *_ncm_spline2d_bicubic_int_dy_spline (NcmSpline2d *s2d, gdouble yl, gdouble yu);
+static void _ncm_spline2d_bicubic_eval_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n);
+static void _ncm_spline2d_bicubic_dzdx_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n);
+static void _ncm_spline2d_bicubic_dzdy_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n);
 
 static void
 ncm_spline2d_bicubic_class_init (NcmSpline2dBicubicClass *klass)
@@ -125,6 +130,9 @@ ncm_spline2d_bicubic_class_init (NcmSpline2dBicubicClass *klass)
   parent_class->int_dxdy      = &_ncm_spline2d_bicubic_int_dxdy;
   parent_class->int_dx_spline = &_ncm_spline2d_bicubic_int_dx_spline;
   parent_class->int_dy_spline = &_ncm_spline2d_bicubic_int_dy_spline;
+  parent_class->eval_vec      = &_ncm_spline2d_bicubic_eval_vec;
+  parent_class->dzdx_vec      = &_ncm_spline2d_bicubic_dzdx_vec;
+  parent_class->dzdy_vec      = &_ncm_spline2d_bicubic_dzdy_vec;
 
   object_class->dispose  = &_ncm_spline2d_bicubic_dispose;
   object_class->finalize = &_ncm_spline2d_bicubic_finalize;
@@ -555,7 +563,7 @@ _ncm_spline2d_bicubic_eval (NcmSpline2d *s2d, gdouble x, gdouble y)
 {
   NcmSpline2dBicubic *s2dbc = NCM_SPLINE2D_BICUBIC (s2d);
 
-  if (!s2d->use_acc)
+  if (s2d->bucket_x->len == 0)
   {
     const gsize j = gsl_interp_bsearch (ncm_vector_ptr (s2d->xv, 0), x, 0, ncm_vector_len (s2d->xv) - 1);
     const gsize i = gsl_interp_bsearch (ncm_vector_ptr (s2d->yv, 0), y, 0, ncm_vector_len (s2d->yv) - 1);
@@ -566,8 +574,8 @@ _ncm_spline2d_bicubic_eval (NcmSpline2d *s2d, gdouble x, gdouble y)
   }
   else
   {
-    const gsize j    = gsl_interp_accel_find (s2d->acc_x, ncm_vector_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
-    const gsize i    = gsl_interp_accel_find (s2d->acc_y, ncm_vector_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
+    const gsize j    = _ncm_spline_util_bucket_find (s2d->bucket_x, s2d->bucket_x0, s2d->bucket_inv_dx, ncm_vector_const_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
+    const gsize i    = _ncm_spline_util_bucket_find (s2d->bucket_y, s2d->bucket_y0, s2d->bucket_inv_dy, ncm_vector_const_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
     const gdouble x0 = ncm_vector_fast_get (s2d->xv, j);
     const gdouble y0 = ncm_vector_fast_get (s2d->yv, i);
 
@@ -575,12 +583,55 @@ _ncm_spline2d_bicubic_eval (NcmSpline2d *s2d, gdouble x, gdouble y)
   }
 }
 
+#define _NCM_SPLINE2D_BICUBIC_VEC_LOOP(poly) \
+  G_STMT_START { \
+    NcmSpline2dBicubic *s2dbc = NCM_SPLINE2D_BICUBIC (s2d); \
+    const gdouble *xa = ncm_vector_const_ptr (s2d->xv, 0); \
+    const gdouble *ya = ncm_vector_const_ptr (s2d->yv, 0); \
+    const guint xlen  = ncm_vector_len (s2d->xv); \
+    const guint ylen  = ncm_vector_len (s2d->yv); \
+    guint jx[NCM_SPLINE_VEC_BLOCK]; \
+    guint iy[NCM_SPLINE_VEC_BLOCK]; \
+    guint k0; \
+    for (k0 = 0; k0 < n; k0 += NCM_SPLINE_VEC_BLOCK) \
+    { \
+      const guint nb = GSL_MIN (NCM_SPLINE_VEC_BLOCK, n - k0); \
+      guint k; \
+      _ncm_spline_util_index_vec (xa, xlen, &x[k0], jx, nb); \
+      _ncm_spline_util_index_vec (ya, ylen, &y[k0], iy, nb); \
+      for (k = 0; k < nb; k++) \
+      { \
+        const guint j = jx[k]; \
+        const guint i = iy[k]; \
+        z[k0 + k] = poly (&NCM_SPLINE2D_BICUBIC_STRUCT (s2dbc, i, j), x[k0 + k] - xa[j], y[k0 + k] - ya[i]); \
+      } \
+    } \
+  } G_STMT_END
+
+static void
+_ncm_spline2d_bicubic_eval_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n)
+{
+  _NCM_SPLINE2D_BICUBIC_VEC_LOOP (ncm_spline2d_bicubic_eval_poly);
+}
+
+static void
+_ncm_spline2d_bicubic_dzdx_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n)
+{
+  _NCM_SPLINE2D_BICUBIC_VEC_LOOP (ncm_spline2d_bicubic_eval_poly_dzdx);
+}
+
+static void
+_ncm_spline2d_bicubic_dzdy_vec (NcmSpline2d *s2d, const gdouble *x, const gdouble *y, gdouble *z, const guint n)
+{
+  _NCM_SPLINE2D_BICUBIC_VEC_LOOP (ncm_spline2d_bicubic_eval_poly_dzdy);
+}
+
 static gdouble 
 _ncm_spline2d_bicubic_dzdx (NcmSpline2d *s2d, gdouble x, gdouble y) 
 { 
   NcmSpline2dBicubic *s2dbc = NCM_SPLINE2D_BICUBIC (s2d);
 
-  if (!s2d->use_acc)
+  if (s2d->bucket_x->len == 0)
   {
     const gsize j = gsl_interp_bsearch (ncm_vector_ptr (s2d->xv, 0), x, 0, ncm_vector_len (s2d->xv) - 1);
     const gsize i = gsl_interp_bsearch (ncm_vector_ptr (s2d->yv, 0), y, 0, ncm_vector_len (s2d->yv) - 1);
@@ -591,8 +642,8 @@ _ncm_spline2d_bicubic_dzdx (NcmSpline2d *s2d, gdouble x, gdouble y)
   }
   else
   {
-    const gsize j    = gsl_interp_accel_find (s2d->acc_x, ncm_vector_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
-    const gsize i    = gsl_interp_accel_find (s2d->acc_y, ncm_vector_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
+    const gsize j    = _ncm_spline_util_bucket_find (s2d->bucket_x, s2d->bucket_x0, s2d->bucket_inv_dx, ncm_vector_const_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
+    const gsize i    = _ncm_spline_util_bucket_find (s2d->bucket_y, s2d->bucket_y0, s2d->bucket_inv_dy, ncm_vector_const_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
     const gdouble x0 = ncm_vector_fast_get (s2d->xv, j);
     const gdouble y0 = ncm_vector_fast_get (s2d->yv, i);
 
@@ -605,7 +656,7 @@ _ncm_spline2d_bicubic_dzdy (NcmSpline2d *s2d, gdouble x, gdouble y)
 { 
   NcmSpline2dBicubic *s2dbc = NCM_SPLINE2D_BICUBIC (s2d);
 
-  if (!s2d->use_acc)
+  if (s2d->bucket_x->len == 0)
   {
     const gsize j = gsl_interp_bsearch (ncm_vector_ptr (s2d->xv, 0), x, 0, ncm_vector_len (s2d->xv) - 1);
     const gsize i = gsl_interp_bsearch (ncm_vector_ptr (s2d->yv, 0), y, 0, ncm_vector_len (s2d->yv) - 1);
@@ -616,8 +667,8 @@ _ncm_spline2d_bicubic_dzdy (NcmSpline2d *s2d, gdouble x, gdouble y)
   }
   else
   {
-    const gsize j    = gsl_interp_accel_find (s2d->acc_x, ncm_vector_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
-    const gsize i    = gsl_interp_accel_find (s2d->acc_y, ncm_vector_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
+    const gsize j    = _ncm_spline_util_bucket_find (s2d->bucket_x, s2d->bucket_x0, s2d->bucket_inv_dx, ncm_vector_const_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
+    const gsize i    = _ncm_spline_util_bucket_find (s2d->bucket_y, s2d->bucket_y0, s2d->bucket_inv_dy, ncm_vector_const_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
     const gdouble x0 = ncm_vector_fast_get (s2d->xv, j);
     const gdouble y0 = ncm_vector_fast_get (s2d->yv, i);
 
@@ -630,7 +681,7 @@ _ncm_spline2d_bicubic_d2zdx2 (NcmSpline2d *s2d, gdouble x, gdouble y)
 { 
   NcmSpline2dBicubic *s2dbc = NCM_SPLINE2D_BICUBIC (s2d);
 
-  if (!s2d->use_acc)
+  if (s2d->bucket_x->len == 0)
   {
     const gsize j = gsl_interp_bsearch (ncm_vector_ptr (s2d->xv, 0), x, 0, ncm_vector_len (s2d->xv) - 1);
     const gsize i = gsl_interp_bsearch (ncm_vector_ptr (s2d->yv, 0), y, 0, ncm_vector_len (s2d->yv) - 1);
@@ -641,8 +692,8 @@ _ncm_spline2d_bicubic_d2zdx2 (NcmSpline2d *s2d, gdouble x, gdouble y)
   }
   else
   {
-    const gsize j    = gsl_interp_accel_find (s2d->acc_x, ncm_vector_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
-    const gsize i    = gsl_interp_accel_find (s2d->acc_y, ncm_vector_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
+    const gsize j    = _ncm_spline_util_bucket_find (s2d->bucket_x, s2d->bucket_x0, s2d->bucket_inv_dx, ncm_vector_const_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
+    const gsize i    = _ncm_spline_util_bucket_find (s2d->bucket_y, s2d->bucket_y0, s2d->bucket_inv_dy, ncm_vector_const_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
     const gdouble x0 = ncm_vector_fast_get (s2d->xv, j);
     const gdouble y0 = ncm_vector_fast_get (s2d->yv, i);
 
@@ -655,7 +706,7 @@ _ncm_spline2d_bicubic_d2zdy2 (NcmSpline2d *s2d, gdouble x, gdouble y)
 { 
   NcmSpline2dBicubic *s2dbc = NCM_SPLINE2D_BICUBIC (s2d);
 
-  if (!s2d->use_acc)
+  if (s2d->bucket_x->len == 0)
   {
     const gsize j = gsl_interp_bsearch (ncm_vector_ptr (s2d->xv, 0), x, 0, ncm_vector_len (s2d->xv) - 1);
     const gsize i = gsl_interp_bsearch (ncm_vector_ptr (s2d->yv, 0), y, 0, ncm_vector_len (s2d->yv) - 1);
@@ -666,8 +717,8 @@ _ncm_spline2d_bicubic_d2zdy2 (NcmSpline2d *s2d, gdouble x, gdouble y)
   }
   else
   {
-    const gsize j    = gsl_interp_accel_find (s2d->acc_x, ncm_vector_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
-    const gsize i    = gsl_interp_accel_find (s2d->acc_y, ncm_vector_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
+    const gsize j    = _ncm_spline_util_bucket_find (s2d->bucket_x, s2d->bucket_x0, s2d->bucket_inv_dx, ncm_vector_const_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
+    const gsize i    = _ncm_spline_util_bucket_find (s2d->bucket_y, s2d->bucket_y0, s2d->bucket_inv_dy, ncm_vector_const_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
     const gdouble x0 = ncm_vector_fast_get (s2d->xv, j);
     const gdouble y0 = ncm_vector_fast_get (s2d->yv, i);
 
@@ -680,7 +731,7 @@ _ncm_spline2d_bicubic_d2zdxy (NcmSpline2d *s2d, gdouble x, gdouble y)
 { 
   NcmSpline2dBicubic *s2dbc = NCM_SPLINE2D_BICUBIC (s2d);
 
-  if (!s2d->use_acc)
+  if (s2d->bucket_x->len == 0)
   {
     const gsize j = gsl_interp_bsearch (ncm_vector_ptr (s2d->xv, 0), x, 0, ncm_vector_len (s2d->xv) - 1);
     const gsize i = gsl_interp_bsearch (ncm_vector_ptr (s2d->yv, 0), y, 0, ncm_vector_len (s2d->yv) - 1);
@@ -691,8 +742,8 @@ _ncm_spline2d_bicubic_d2zdxy (NcmSpline2d *s2d, gdouble x, gdouble y)
   }
   else
   {
-    const gsize j    = gsl_interp_accel_find (s2d->acc_x, ncm_vector_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
-    const gsize i    = gsl_interp_accel_find (s2d->acc_y, ncm_vector_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
+    const gsize j    = _ncm_spline_util_bucket_find (s2d->bucket_x, s2d->bucket_x0, s2d->bucket_inv_dx, ncm_vector_const_ptr (s2d->xv, 0), ncm_vector_len (s2d->xv), x);
+    const gsize i    = _ncm_spline_util_bucket_find (s2d->bucket_y, s2d->bucket_y0, s2d->bucket_inv_dy, ncm_vector_const_ptr (s2d->yv, 0), ncm_vector_len (s2d->yv), y);
     const gdouble x0 = ncm_vector_fast_get (s2d->xv, j);
     const gdouble y0 = ncm_vector_fast_get (s2d->yv, i);
 
@@ -39,6 +39,7 @@
 
 #include "math/ncm_spline_cubic.h"
 #include <math.h>
+#include <gsl/gsl_math.h>
 
 G_DEFINE_ABSTRACT_TYPE (NcmSplineCubic, ncm_spline_cubic, NCM_TYPE_SPLINE);
 
@@ -74,6 +75,10 @@ static gdouble _ncm_spline_cubic_deriv (const NcmSpline *s, const gdouble x);
 static gdouble _ncm_spline_cubic_deriv2 (const NcmSpline *s, const gdouble x);
 static gdouble _ncm_spline_cubic_deriv_nmax (const NcmSpline *s, const gdouble x);
 static gdouble _ncm_spline_cubic_integ (const NcmSpline *s, const gdouble x0, const gdouble x1);
+static void _ncm_spline_cubic_eval_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n);
+static void _ncm_spline_cubic_deriv_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n);
+static void _ncm_spline_cubic_deriv2_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n);
+static void _ncm_spline_cubic_integ_vec (const NcmSpline *s, const gdouble *x0, const gdouble *x1, gdouble *res, const guint n);
 
 static void
 ncm_spline_cubic_class_init (NcmSplineCubicClass *klass)
@@ -89,6 +94,10 @@ ncm_spline_cubic_class_init (NcmSplineCubicClass *klass)
 	s_class->deriv2       = &_ncm_spline_cubic_deriv2;
   s_class->deriv_nmax   = &_ncm_spline_cubic_deriv_nmax;
 	s_class->integ        = &_ncm_spline_cubic_integ;
+	s_class->eval_vec     = &_ncm_spline_cubic_eval_vec;
+	s_class->deriv_vec    = &_ncm_spline_cubic_deriv_vec;
+	s_class->deriv2_vec   = &_ncm_spline_cubic_deriv2_vec;
+	s_class->integ_vec    = &_ncm_spline_cubic_integ_vec;
 }
 
 static void
@@ -222,12 +231,10 @@ _ncm_spline_cubic_deriv_nmax (const NcmSpline *s, const gdouble x)
 }
 
 static gdouble
-_ncm_spline_cubic_integ (const NcmSpline *s, const gdouble x0, const gdouble x1)
+_ncm_spline_cubic_integ_index (const NcmSpline *s, const gdouble x0, const gdouble x1, const size_t index_a, const size_t index_b)
 {
 	const NcmSplineCubic *sc = NCM_SPLINE_CUBIC (s);
 	size_t i;
-	const size_t index_a = ncm_spline_get_index (s, x0);
-	const size_t index_b = ncm_spline_get_index (s, x1);
 	gdouble result = 0.0;
 
 	for (i = index_a; i <= index_b; i++)
@@ -257,3 +264,132 @@ _ncm_spline_cubic_integ (const NcmSpline *s, const gdouble x0, const gdouble x1)
 
 	return result;
 }
+
+static gdouble
+_ncm_spline_cubic_integ (const NcmSpline *s, const gdouble x0, const gdouble x1)
+{
+	const size_t index_a = ncm_spline_get_index (s, x0);
+	const size_t index_b = ncm_spline_get_index (s, x1);
+
+	return _ncm_spline_cubic_integ_index (s, x0, x1, index_a, index_b);
+}
+
+static void
+_ncm_spline_cubic_eval_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n)
+{
+	const NcmSplineCubic *sc = NCM_SPLINE_CUBIC (s);
+	const gdouble *b = ncm_vector_const_ptr (sc->b, 0);
+	const gdouble *c = ncm_vector_const_ptr (sc->c, 0);
+	const gdouble *d = ncm_vector_const_ptr (sc->d, 0);
+	guint idx[NCM_SPLINE_VEC_BLOCK];
+	guint k0;
+
+	for (k0 = 0; k0 < n; k0 += NCM_SPLINE_VEC_BLOCK)
+	{
+		const guint nb = GSL_MIN (NCM_SPLINE_VEC_BLOCK, n - k0);
+		const gdouble *xb = &x[k0];
+		gdouble *yb = &y[k0];
+		guint k;
+
+		ncm_spline_get_index_vec (s, xb, idx, nb);
+
+		for (k = 0; k < nb; k++)
+		{
+			const guint i      = idx[k];
+			const gdouble delx = xb[k] - ncm_vector_get (s->xv, i);
+			const gdouble a_i  = ncm_vector_get (s->yv, i);
+#ifdef HAVE_FMA
+			yb[k] = fma (fma (fma (d[i], delx, c[i]), delx, b[i]), delx, a_i);
+#else
+			yb[k] = a_i + delx * (b[i] + delx * (c[i] + delx * d[i]));
+#endif /* HAVE_FMA */
+		}
+	}
+}
+
+static void
+_ncm_spline_cubic_deriv_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n)
+{
+	const NcmSplineCubic *sc = NCM_SPLINE_CUBIC (s);
+	const gdouble *b = ncm_vector_const_ptr (sc->b, 0);
+	const gdouble *c = ncm_vector_const_ptr (sc->c, 0);
+	const gdouble *d = ncm_vector_const_ptr (sc->d, 0);
+	guint idx[NCM_SPLINE_VEC_BLOCK];
+	guint k0;
+
+	for (k0 = 0; k0 < n; k0 += NCM_SPLINE_VEC_BLOCK)
+	{
+		const guint nb = GSL_MIN (NCM_SPLINE_VEC_BLOCK, n - k0);
+		const gdouble *xb = &x[k0];
+		gdouble *yb = &y[k0];
+		guint k;
+
+		ncm_spline_get_index_vec (s, xb, idx, nb);
+
+		for (k = 0; k < nb; k++)
+		{
+			const guint i      = idx[k];
+			const gdouble delx = xb[k] - ncm_vector_get (s->xv, i);
+			const gdouble c2_i = 2.0 * c[i];
+			const gdouble d3_i = 3.0 * d[i];
+#ifdef HAVE_FMA
+			yb[k] = fma (fma (delx, d3_i, c2_i), delx, b[i]);
+#else
+			yb[k] = b[i] + delx * (c2_i + delx * d3_i);
+#endif /* HAVE_FMA */
+		}
+	}
+}
+
+static void
+_ncm_spline_cubic_deriv2_vec (const NcmSpline *s, const gdouble *x, gdouble *y, const guint n)
+{
+	const NcmSplineCubic *sc = NCM_SPLINE_CUBIC (s);
+	const gdouble *c = ncm_vector_const_ptr (sc->c, 0);
+	const gdouble *d = ncm_vector_const_ptr (sc->d, 0);
+	guint idx[NCM_SPLINE_VEC_BLOCK];
+	guint k0;
+
+	for (k0 = 0; k0 < n; k0 += NCM_SPLINE_VEC_BLOCK)
+	{
+		const guint nb = GSL_MIN (NCM_SPLINE_VEC_BLOCK, n - k0);
+		const gdouble *xb = &x[k0];
+		gdouble *yb = &y[k0];
+		guint k;
+
+		ncm_spline_get_index_vec (s, xb, idx, nb);
+
+		for (k = 0; k < nb; k++)
+		{
+			const guint i      = idx[k];
+			const gdouble delx = xb[k] - ncm_vector_get (s->xv, i);
+			const gdouble c2_i = 2.0 * c[i];
+			const gdouble d6_i = 6.0 * d[i];
+#ifdef HAVE_FMA
+			yb[k] = fma (delx, d6_i, c2_i);
+#else
+			yb[k] = c2_i + delx * d6_i;
+#endif /* HAVE_FMA */
+		}
+	}
+}
+
+static void
+_ncm_spline_cubic_integ_vec (const NcmSpline *s, const gdouble *x0, const gdouble *x1, gdouble *res, const guint n)
+{
+	guint idx_a[NCM_SPLINE_VEC_BLOCK];
+	guint idx_b[NCM_SPLINE_VEC_BLOCK];
+	guint k0;
+
+	for (k0 = 0; k0 < n; k0 += NCM_SPLINE_VEC_BLOCK)
+	{
+		const guint nb = GSL_MIN (NCM_SPLINE_VEC_BLOCK, n - k0);
+		guint k;
+
+		ncm_spline_get_index_vec (s, &x0[k0], idx_a, nb);
+		ncm_spline_get_index_vec (s, &x1[k0], idx_b, nb);
+
+		for (k = 0; k < nb; k++)
+			res[k0 + k] = _ncm_spline_cubic_integ_index (s, x0[k0 + k], x1[k0 + k], idx_a[k], idx_b[k]);
+	}
+}
@@ -229,21 +229,21 @@ static gdouble
 _ncm_spline_gsl_eval (const NcmSpline *s, const gdouble x)
 { 
   NcmSplineGsl *sg = NCM_SPLINE_GSL (s);
-  return gsl_interp_eval (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x, s->acc); 
+  return gsl_interp_eval (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x, NULL); 
 }
 
 static gdouble 
 _ncm_spline_gsl_deriv (const NcmSpline *s, const gdouble x) 
 { 
   NcmSplineGsl *sg = NCM_SPLINE_GSL (s);
-  return gsl_interp_eval_deriv (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x, s->acc);
+  return gsl_interp_eval_deriv (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x, NULL);
 }
 
 static gdouble 
 _ncm_spline_gsl_deriv2 (const NcmSpline *s, const gdouble x)
 { 
   NcmSplineGsl *sg = NCM_SPLINE_GSL (s);
-  return gsl_interp_eval_deriv2 (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x, s->acc); 
+  return gsl_interp_eval_deriv2 (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x, NULL); 
 }
 
 static gdouble 
@@ -252,7 +252,7 @@ _ncm_spline_gsl_deriv_nmax (const NcmSpline *s, const gdouble x)
   NcmSplineGsl *sg = NCM_SPLINE_GSL (s);
   if (sg->type == gsl_interp_linear)
   {
-    return gsl_interp_eval_deriv (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x, s->acc);
+    return gsl_interp_eval_deriv (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x, NULL);
   }
   else if (sg->type == gsl_interp_cspline || sg->type == gsl_interp_cspline_periodic || 
            sg->type == gsl_interp_akima || sg->type == gsl_interp_akima_periodic)
@@ -261,8 +261,8 @@ _ncm_spline_gsl_deriv_nmax (const NcmSpline *s, const gdouble x)
     const gdouble x_i = ncm_vector_get (s->xv, knot_i);
     const gdouble x_ip1 = ncm_vector_get (s->xv, knot_i + 1);
     const gdouble dx = x_ip1 - x_i; 
-    gdouble two_c_i = gsl_interp_eval_deriv2 (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x_i, s->acc);
-    gdouble two_c_i_p_6d_i_dx = gsl_interp_eval_deriv2 (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x_ip1, s->acc);
+    gdouble two_c_i = gsl_interp_eval_deriv2 (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x_i, NULL);
+    gdouble two_c_i_p_6d_i_dx = gsl_interp_eval_deriv2 (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x_ip1, NULL);
     return (two_c_i_p_6d_i_dx - two_c_i) / dx;
   }
   else
@@ -276,7 +276,7 @@ static gdouble
 _ncm_spline_gsl_integ (const NcmSpline *s, const gdouble x0, const gdouble x1)
 { 
   NcmSplineGsl *sg = NCM_SPLINE_GSL (s);
-  return gsl_interp_eval_integ (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x0, x1, s->acc); 
+  return gsl_interp_eval_integ (sg->interp, ncm_vector_ptr (s->xv, 0), ncm_vector_ptr (s->yv, 0), x0, x1, NULL); 
 }
 
 static void
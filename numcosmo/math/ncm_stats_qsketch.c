@@ -0,0 +1,504 @@
+/***************************************************************************
+ *            ncm_stats_qsketch.c
+ *
+ *  Thu October 15 18:21:07 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * SECTION:ncm_stats_qsketch
+ * @title: NcmStatsQSketch
+ * @short_description: Mergeable streaming quantile sketch.
+ *
+ * This object estimates arbitrary quantiles of a stream of (weighted) samples
+ * using bounded memory. It implements the merging t-digest algorithm
+ * (Dunning & Ertl, arXiv:1902.04023), the samples are summarized by a set
+ * of centroids (mean and weight) whose sizes are controlled by the scale
+ * function $k(q) = \delta \arcsin(2q - 1) / (2\pi)$, where $\delta$ is the
+ * compression parameter. This produces small centroids close to the tails,
+ * where the accuracy is needed for the confidence intervals, and the number
+ * of centroids is bounded by $\approx\delta$ regardless of the number of
+ * samples.
+ *
+ * New samples are kept in a buffer that is merged into the centroids when it
+ * is full or when the sketch is queried. Two sketches can be combined using
+ * ncm_stats_qsketch_merge(), so different threads or chains can accumulate
+ * their own sketch and merge them afterwards.
+ *
+ * Contrary to the $P^2$ algorithm used by ncm_stats_vec_enable_quantile(),
+ * which follows a single quantile fixed beforehand, any quantile can be
+ * obtained from the sketch at any time and weighted samples are supported.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif /* HAVE_CONFIG_H */
+#include "build_cfg.h"
+
+#include "math/ncm_stats_qsketch.h"
+
+#include <math.h>
+#include <gsl/gsl_math.h>
+
+G_DEFINE_BOXED_TYPE (NcmStatsQSketch, ncm_stats_qsketch, ncm_stats_qsketch_dup, ncm_stats_qsketch_free);
+
+typedef struct _NcmStatsQSketchCentroid
+{
+  gdouble mean;
+  gdouble weight;
+} NcmStatsQSketchCentroid;
+
+#define NCM_STATS_QSKETCH_BUFFER_FACTOR (5.0)
+
+/**
+ * ncm_stats_qsketch_new: (constructor)
+ * @compression: compression parameter $\delta$
+ *
+ * Creates a new empty #NcmStatsQSketch. The number of centroids is bounded by
+ * approximately @compression, larger values increase both the memory used and
+ * the accuracy, see #NCM_STATS_QSKETCH_DEFAULT_COMPRESSION.
+ *
+ * Returns: (transfer full): a new #NcmStatsQSketch.
+ */
+NcmStatsQSketch *
+ncm_stats_qsketch_new (const gdouble compression)
+{
+  NcmStatsQSketch *qs = g_new (NcmStatsQSketch, 1);
+
+  g_assert_cmpfloat (compression, >=, 10.0);
+
+  qs->compression = compression;
+  qs->buffer_size = ceil (NCM_STATS_QSKETCH_BUFFER_FACTOR * compression);
+  qs->centroids   = g_array_sized_new (FALSE, FALSE, sizeof (NcmStatsQSketchCentroid), ceil (compression));
+  qs->buffer      = g_array_sized_new (FALSE, FALSE, sizeof (NcmStatsQSketchCentroid), qs->buffer_size + ceil (compression));
+
+  ncm_stats_qsketch_reset (qs);
+
+  return qs;
+}
+
+/**
+ * ncm_stats_qsketch_dup:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Duplicates @qs including all accumulated samples.
+ *
+ * Returns: (transfer full): a copy of @qs.
+ */
+NcmStatsQSketch *
+ncm_stats_qsketch_dup (NcmStatsQSketch *qs)
+{
+  NcmStatsQSketch *qs_dup = ncm_stats_qsketch_new (qs->compression);
+
+  g_array_append_vals (qs_dup->centroids, qs->centroids->data, qs->centroids->len);
+  g_array_append_vals (qs_dup->buffer, qs->buffer->data, qs->buffer->len);
+
+  qs_dup->weight        = qs->weight;
+  qs_dup->buffer_weight = qs->buffer_weight;
+  qs_dup->wsum          = qs->wsum;
+  qs_dup->min           = qs->min;
+  qs_dup->max           = qs->max;
+  qs_dup->n             = qs->n;
+
+  return qs_dup;
+}
+
+/**
+ * ncm_stats_qsketch_free:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Frees @qs.
+ *
+ */
+void
+ncm_stats_qsketch_free (NcmStatsQSketch *qs)
+{
+  g_array_unref (qs->centroids);
+  g_array_unref (qs->buffer);
+  g_free (qs);
+}
+
+/**
+ * ncm_stats_qsketch_clear:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Frees *@qs and sets it to NULL.
+ *
+ */
+void
+ncm_stats_qsketch_clear (NcmStatsQSketch **qs)
+{
+  g_clear_pointer (qs, ncm_stats_qsketch_free);
+}
+
+/**
+ * ncm_stats_qsketch_reset:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Removes all samples from @qs.
+ *
+ */
+void
+ncm_stats_qsketch_reset (NcmStatsQSketch *qs)
+{
+  g_array_set_size (qs->centroids, 0);
+  g_array_set_size (qs->buffer, 0);
+
+  qs->weight        = 0.0;
+  qs->buffer_weight = 0.0;
+  qs->wsum          = 0.0;
+  qs->min           = GSL_POSINF;
+  qs->max           = GSL_NEGINF;
+  qs->n             = 0;
+}
+
+/**
+ * ncm_stats_qsketch_add:
+ * @qs: a #NcmStatsQSketch
+ * @x: sample value
+ *
+ * Adds the sample @x with unit weight to @qs.
+ *
+ */
+void
+ncm_stats_qsketch_add (NcmStatsQSketch *qs, const gdouble x)
+{
+  ncm_stats_qsketch_add_weight (qs, x, 1.0);
+}
+
+/**
+ * ncm_stats_qsketch_add_weight:
+ * @qs: a #NcmStatsQSketch
+ * @x: sample value
+ * @w: sample weight
+ *
+ * Adds the sample @x with weight @w to @qs. Samples with zero
+ * weight are ignored.
+ *
+ */
+void
+ncm_stats_qsketch_add_weight (NcmStatsQSketch *qs, const gdouble x, const gdouble w)
+{
+  NcmStatsQSketchCentroid c = {x, w};
+
+  g_assert_cmpfloat (w, >=, 0.0);
+
+  if (w == 0.0)
+    return;
+
+  qs->min            = GSL_MIN (qs->min, x);
+  qs->max            = GSL_MAX (qs->max, x);
+  qs->wsum          += w * x;
+  qs->buffer_weight += w;
+  qs->n++;
+
+  g_array_append_val (qs->buffer, c);
+
+  if (qs->buffer->len >= qs->buffer_size)
+    ncm_stats_qsketch_compress (qs);
+}
+
+/**
+ * ncm_stats_qsketch_merge:
+ * @qs: a #NcmStatsQSketch
+ * @qs_other: a #NcmStatsQSketch
+ *
+ * Adds all samples summarized in @qs_other to @qs, @qs_other is not
+ * modified. The result is (up to the sketch accuracy) equivalent to
+ * adding the samples of @qs_other directly to @qs.
+ *
+ */
+void
+ncm_stats_qsketch_merge (NcmStatsQSketch *qs, NcmStatsQSketch *qs_other)
+{
+  g_assert (qs != qs_other);
+
+  if (qs_other->n == 0)
+    return;
+
+  g_array_append_vals (qs->buffer, qs_other->centroids->data, qs_other->centroids->len);
+  g_array_append_vals (qs->buffer, qs_other->buffer->data, qs_other->buffer->len);
+
+  qs->buffer_weight += qs_other->weight + qs_other->buffer_weight;
+  qs->wsum          += qs_other->wsum;
+  qs->min            = GSL_MIN (qs->min, qs_other->min);
+  qs->max            = GSL_MAX (qs->max, qs_other->max);
+  qs->n             += qs_other->n;
+
+  ncm_stats_qsketch_compress (qs);
+}
+
+static gint
+_ncm_stats_qsketch_centroid_cmp (gconstpointer a, gconstpointer b)
+{
+  const gdouble ma = ((const NcmStatsQSketchCentroid *) a)->mean;
+  const gdouble mb = ((const NcmStatsQSketchCentroid *) b)->mean;
+
+  return (ma < mb) ? -1 : ((ma > mb) ? 1 : 0);
+}
+
+static gdouble
+_ncm_stats_qsketch_k (const gdouble delta, const gdouble q)
+{
+  return delta * asin (2.0 * GSL_MIN (q, 1.0) - 1.0) / (2.0 * M_PI);
+}
+
+static gdouble
+_ncm_stats_qsketch_q (const gdouble delta, const gdouble k)
+{
+  if (k >= 0.25 * delta)
+    return 1.0;
+  else
+    return 0.5 * (1.0 + sin (2.0 * M_PI * k / delta));
+}
+
+/**
+ * ncm_stats_qsketch_compress:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Merges the buffered samples into the centroids of @qs. This is done
+ * automatically when the buffer is full and before any query.
+ *
+ */
+void
+ncm_stats_qsketch_compress (NcmStatsQSketch *qs)
+{
+  if (qs->buffer->len == 0)
+    return;
+
+  g_array_append_vals (qs->buffer, qs->centroids->data, qs->centroids->len);
+  g_array_sort (qs->buffer, &_ncm_stats_qsketch_centroid_cmp);
+  g_array_set_size (qs->centroids, 0);
+
+  {
+    const gdouble total          = qs->weight + qs->buffer_weight;
+    NcmStatsQSketchCentroid *buf = (NcmStatsQSketchCentroid *) qs->buffer->data;
+    NcmStatsQSketchCentroid cur  = buf[0];
+    gdouble wsofar               = 0.0;
+    gdouble q_limit              = _ncm_stats_qsketch_q (qs->compression, _ncm_stats_qsketch_k (qs->compression, 0.0) + 1.0);
+    guint i;
+
+    for (i = 1; i < qs->buffer->len; i++)
+    {
+      const NcmStatsQSketchCentroid *c = &buf[i];
+      const gdouble q                  = (wsofar + cur.weight + c->weight) / total;
+
+      if (q <= q_limit)
+      {
+        cur.weight += c->weight;
+        cur.mean   += (c->mean - cur.mean) * c->weight / cur.weight;
+      }
+      else
+      {
+        g_array_append_val (qs->centroids, cur);
+        wsofar += cur.weight;
+        q_limit = _ncm_stats_qsketch_q (qs->compression, _ncm_stats_qsketch_k (qs->compression, wsofar / total) + 1.0);
+        cur     = *c;
+      }
+    }
+    g_array_append_val (qs->centroids, cur);
+
+    qs->weight        = total;
+    qs->buffer_weight = 0.0;
+  }
+
+  g_array_set_size (qs->buffer, 0);
+}
+
+/**
+ * ncm_stats_qsketch_get_compression:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Returns: the compression parameter of @qs.
+ */
+gdouble
+ncm_stats_qsketch_get_compression (NcmStatsQSketch *qs)
+{
+  return qs->compression;
+}
+
+/**
+ * ncm_stats_qsketch_get_n:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Returns: the number of samples added to @qs.
+ */
+gulong
+ncm_stats_qsketch_get_n (NcmStatsQSketch *qs)
+{
+  return qs->n;
+}
+
+/**
+ * ncm_stats_qsketch_get_weight:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Returns: the total weight of the samples added to @qs.
+ */
+gdouble
+ncm_stats_qsketch_get_weight (NcmStatsQSketch *qs)
+{
+  return qs->weight + qs->buffer_weight;
+}
+
+/**
+ * ncm_stats_qsketch_get_mean:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Returns: the (exact) weighted mean of the samples added to @qs.
+ */
+gdouble
+ncm_stats_qsketch_get_mean (NcmStatsQSketch *qs)
+{
+  return qs->wsum / ncm_stats_qsketch_get_weight (qs);
+}
+
+/**
+ * ncm_stats_qsketch_get_min:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Returns: the smallest sample added to @qs.
+ */
+gdouble
+ncm_stats_qsketch_get_min (NcmStatsQSketch *qs)
+{
+  return qs->min;
+}
+
+/**
+ * ncm_stats_qsketch_get_max:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Returns: the largest sample added to @qs.
+ */
+gdouble
+ncm_stats_qsketch_get_max (NcmStatsQSketch *qs)
+{
+  return qs->max;
+}
+
+/**
+ * ncm_stats_qsketch_get_ncentroids:
+ * @qs: a #NcmStatsQSketch
+ *
+ * Compresses @qs and returns the number of centroids used to summarize the
+ * samples.
+ *
+ * Returns: the number of centroids in @qs.
+ */
+guint
+ncm_stats_qsketch_get_ncentroids (NcmStatsQSketch *qs)
+{
+  ncm_stats_qsketch_compress (qs);
+  return qs->centroids->len;
+}
+
+/**
+ * ncm_stats_qsketch_get_quantile:
+ * @qs: a #NcmStatsQSketch
+ * @p: probability $p \in [0, 1]$
+ *
+ * Estimates the @p quantile of the samples added to @qs, the value is
+ * linearly interpolated between the centroids and between the extreme
+ * centroids and the sample minimum/maximum.
+ *
+ * Returns: the estimated @p quantile or NaN if @qs is empty.
+ */
+gdouble
+ncm_stats_qsketch_get_quantile (NcmStatsQSketch *qs, const gdouble p)
+{
+  ncm_stats_qsketch_compress (qs);
+
+  if (qs->n == 0)
+    return GSL_NAN;
+  else if (p <= 0.0)
+    return qs->min;
+  else if (p >= 1.0)
+    return qs->max;
+  else
+  {
+    const NcmStatsQSketchCentroid *c = (const NcmStatsQSketchCentroid *) qs->centroids->data;
+    const guint nc                   = qs->centroids->len;
+    const gdouble t                  = p * qs->weight;
+    gdouble cum                      = 0.5 * c[0].weight;
+    guint i;
+
+    if (t < cum)
+      return qs->min + (c[0].mean - qs->min) * t / cum;
+
+    for (i = 0; i + 1 < nc; i++)
+    {
+      const gdouble dw = 0.5 * (c[i].weight + c[i + 1].weight);
+
+      if (t < cum + dw)
+        return c[i].mean + (c[i + 1].mean - c[i].mean) * (t - cum) / dw;
+
+      cum += dw;
+    }
+
+    return c[nc - 1].mean + (qs->max - c[nc - 1].mean) * GSL_MIN ((t - cum) / (0.5 * c[nc - 1].weight), 1.0);
+  }
+}
+
+/**
+ * ncm_stats_qsketch_get_cdf:
+ * @qs: a #NcmStatsQSketch
+ * @x: a value
+ *
+ * Estimates the fraction of the (weighted) samples smaller than @x, this
+ * is the inverse of ncm_stats_qsketch_get_quantile().
+ *
+ * Returns: the estimated cumulative distribution at @x or NaN if @qs is empty.
+ */
+gdouble
+ncm_stats_qsketch_get_cdf (NcmStatsQSketch *qs, const gdouble x)
+{
+  ncm_stats_qsketch_compress (qs);
+
+  if (qs->n == 0)
+    return GSL_NAN;
+  else if (x < qs->min)
+    return 0.0;
+  else if (x >= qs->max)
+    return 1.0;
+  else
+  {
+    const NcmStatsQSketchCentroid *c = (const NcmStatsQSketchCentroid *) qs->centroids->data;
+    const guint nc                   = qs->centroids->len;
+    gdouble cum                      = 0.5 * c[0].weight;
+    guint i;
+
+    if (x < c[0].mean)
+      return cum * (x - qs->min) / (c[0].mean - qs->min) / qs->weight;
+
+    for (i = 0; i + 1 < nc; i++)
+    {
+      const gdouble dw = 0.5 * (c[i].weight + c[i + 1].weight);
+
+      if (x < c[i + 1].mean)
+        return (cum + dw * (x - c[i].mean) / (c[i + 1].mean - c[i].mean)) / qs->weight;
+
+      cum += dw;
+    }
+
+    return (cum + 0.5 * c[nc - 1].weight * (x - c[nc - 1].mean) / (qs->max - c[nc - 1].mean)) / qs->weight;
+  }
+}
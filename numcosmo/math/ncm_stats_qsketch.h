@@ -0,0 +1,87 @@
+/***************************************************************************
+ *            ncm_stats_qsketch.h
+ *
+ *  Thu October 15 18:21:07 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NCM_STATS_QSKETCH_H_
+#define _NCM_STATS_QSKETCH_H_
+
+#include <glib.h>
+#include <glib-object.h>
+#include <numcosmo/build_cfg.h>
+
+G_BEGIN_DECLS
+
+#define NCM_TYPE_STATS_QSKETCH (ncm_stats_qsketch_get_type ())
+
+typedef struct _NcmStatsQSketch NcmStatsQSketch;
+
+/**
+ * NcmStatsQSketch:
+ *
+ * Mergeable quantile sketch (merging t-digest).
+ *
+ */
+struct _NcmStatsQSketch
+{
+  /*< private >*/
+  gdouble compression;
+  guint buffer_size;
+  GArray *centroids;
+  GArray *buffer;
+  gdouble weight;
+  gdouble buffer_weight;
+  gdouble wsum;
+  gdouble min;
+  gdouble max;
+  gulong n;
+};
+
+GType ncm_stats_qsketch_get_type (void) G_GNUC_CONST;
+
+NcmStatsQSketch *ncm_stats_qsketch_new (const gdouble compression);
+NcmStatsQSketch *ncm_stats_qsketch_dup (NcmStatsQSketch *qs);
+void ncm_stats_qsketch_free (NcmStatsQSketch *qs);
+void ncm_stats_qsketch_clear (NcmStatsQSketch **qs);
+
+void ncm_stats_qsketch_reset (NcmStatsQSketch *qs);
+void ncm_stats_qsketch_add (NcmStatsQSketch *qs, const gdouble x);
+void ncm_stats_qsketch_add_weight (NcmStatsQSketch *qs, const gdouble x, const gdouble w);
+void ncm_stats_qsketch_merge (NcmStatsQSketch *qs, NcmStatsQSketch *qs_other);
+void ncm_stats_qsketch_compress (NcmStatsQSketch *qs);
+
+gdouble ncm_stats_qsketch_get_compression (NcmStatsQSketch *qs);
+gulong ncm_stats_qsketch_get_n (NcmStatsQSketch *qs);
+gdouble ncm_stats_qsketch_get_weight (NcmStatsQSketch *qs);
+gdouble ncm_stats_qsketch_get_mean (NcmStatsQSketch *qs);
+gdouble ncm_stats_qsketch_get_min (NcmStatsQSketch *qs);
+gdouble ncm_stats_qsketch_get_max (NcmStatsQSketch *qs);
+guint ncm_stats_qsketch_get_ncentroids (NcmStatsQSketch *qs);
+
+gdouble ncm_stats_qsketch_get_quantile (NcmStatsQSketch *qs, const gdouble p);
+gdouble ncm_stats_qsketch_get_cdf (NcmStatsQSketch *qs, const gdouble x);
+
+#define NCM_STATS_QSKETCH_DEFAULT_COMPRESSION (200.0)
+
+G_END_DECLS
+
+#endif /* _NCM_STATS_QSKETCH_H_ */
@@ -128,6 +128,22 @@ ncm_stats_vec_init (NcmStatsVec *svec)
 
   svec->q_array  = g_ptr_array_new ();
   g_ptr_array_set_free_func (svec->q_array, (GDestroyNotify) gsl_rstat_quantile_free);
+
+  svec->qs_array = g_ptr_array_new ();
+  g_ptr_array_set_free_func (svec->qs_array, (GDestroyNotify) ncm_stats_qsketch_free);
+
+  svec->online_lag      = 0;
+  svec->online_nbatches = 0;
+  svec->online_n        = 0;
+  svec->online_ring     = NULL;
+  svec->online_xy       = NULL;
+  svec->online_xa       = NULL;
+  svec->online_xb       = NULL;
+  svec->online_bm       = NULL;
+  svec->online_bm_cur   = NULL;
+  svec->online_bm_size  = 0;
+  svec->online_bm_len   = 0;
+  svec->online_bm_cur_n = 0;
   
 #ifdef NUMCOSMO_HAVE_FFTW3
   svec->fft_size       = 0;
@@ -136,6 +152,15 @@ ncm_stats_vec_init (NcmStatsVec *svec)
   svec->param_fft      = NULL;
   svec->param_r2c      = NULL;
   svec->param_c2r      = NULL;
+
+  svec->fft_nthreads       = 1;
+  svec->many_plan_size     = 0;
+  svec->many_plan_len      = 0;
+  svec->many_plan_nthreads = 0;
+  svec->many_data          = NULL;
+  svec->many_fft           = NULL;
+  svec->many_r2c           = NULL;
+  svec->many_c2r           = NULL;
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 }
 
@@ -160,6 +185,9 @@ _ncm_stats_vec_dispose (GObject *object)
   }
 
   g_clear_pointer (&svec->q_array, g_ptr_array_unref);
+  g_clear_pointer (&svec->qs_array, g_ptr_array_unref);
+
+  ncm_stats_vec_disable_online_diag (svec);
 
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_stats_vec_parent_class)->dispose (object);
@@ -175,6 +203,11 @@ _ncm_stats_vec_finalize (GObject *object)
   g_clear_pointer (&svec->param_data, fftw_free);
   g_clear_pointer (&svec->param_c2r,  fftw_destroy_plan);
   g_clear_pointer (&svec->param_r2c,  fftw_destroy_plan);
+
+  g_clear_pointer (&svec->many_fft,  fftw_free);
+  g_clear_pointer (&svec->many_data, fftw_free);
+  g_clear_pointer (&svec->many_c2r,  fftw_destroy_plan);
+  g_clear_pointer (&svec->many_r2c,  fftw_destroy_plan);
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 
   /* Chain up : end */
@@ -401,6 +434,22 @@ ncm_stats_vec_clear (NcmStatsVec **svec)
   g_clear_object (svec);
 }
 
+static void
+_ncm_stats_vec_reset_online_diag (NcmStatsVec *svec)
+{
+  ncm_matrix_set_zero (svec->online_ring);
+  ncm_matrix_set_zero (svec->online_xy);
+  ncm_matrix_set_zero (svec->online_xa);
+  ncm_matrix_set_zero (svec->online_xb);
+  ncm_matrix_set_zero (svec->online_bm);
+  ncm_vector_set_zero (svec->online_bm_cur);
+
+  svec->online_n        = 0;
+  svec->online_bm_size  = 1;
+  svec->online_bm_len   = 0;
+  svec->online_bm_cur_n = 0;
+}
+
 /**
  * ncm_stats_vec_reset:
  * @svec: a #NcmStatsVec
@@ -457,6 +506,90 @@ ncm_stats_vec_reset (NcmStatsVec *svec, gboolean rm_saved)
       g_ptr_array_add (svec->q_array, qws_i);
     }
   }
+
+  if (svec->qs_array->len == svec->len)
+  {
+    guint i;
+
+    for (i = 0; i < svec->len; i++)
+      ncm_stats_qsketch_reset (g_ptr_array_index (svec->qs_array, i));
+  }
+
+  if (svec->online_lag > 0)
+    _ncm_stats_vec_reset_online_diag (svec);
+}
+
+static void
+_ncm_stats_vec_update_qsketch (NcmStatsVec *svec, const gdouble w, NcmVector *x)
+{
+  guint i;
+
+  for (i = 0; i < svec->len; i++)
+    ncm_stats_qsketch_add_weight (g_ptr_array_index (svec->qs_array, i), ncm_vector_fast_get (x, i), w);
+}
+
+static void
+_ncm_stats_vec_update_online_diag (NcmStatsVec *svec, NcmVector *x)
+{
+  const gulong n     = svec->online_n;
+  const guint L      = svec->online_lag;
+  const guint nlag   = GSL_MIN (n, L);
+  const guint ring_i = n % L;
+  guint i, k;
+
+  /* Lagged sums: xy_k = sum_t x_t x_{t-k}, xa_k = sum_t x_t, xb_k = sum_t x_{t-k}, all for t >= k. */
+  for (i = 0; i < svec->len; i++)
+  {
+    const gdouble x_i = ncm_vector_fast_get (x, i);
+
+    ncm_matrix_addto (svec->online_xy, 0, i, x_i * x_i);
+    ncm_matrix_addto (svec->online_xa, 0, i, x_i);
+    ncm_matrix_addto (svec->online_xb, 0, i, x_i);
+
+    for (k = 1; k <= nlag; k++)
+    {
+      const gdouble xl_i = ncm_matrix_get (svec->online_ring, (n - k) % L, i);
+
+      ncm_matrix_addto (svec->online_xy, k, i, x_i * xl_i);
+      ncm_matrix_addto (svec->online_xa, k, i, x_i);
+      ncm_matrix_addto (svec->online_xb, k, i, xl_i);
+    }
+
+    /* The oldest value (lag L) was just used, it can be overwritten. */
+    ncm_matrix_set (svec->online_ring, ring_i, i, x_i);
+    ncm_vector_addto (svec->online_bm_cur, i, x_i);
+  }
+
+  svec->online_n++;
+  svec->online_bm_cur_n++;
+
+  /* Batch means with batch size doubling: keeps between nbatches and 2 * nbatches full batches. */
+  if (svec->online_bm_cur_n == svec->online_bm_size)
+  {
+    for (i = 0; i < svec->len; i++)
+      ncm_matrix_set (svec->online_bm, svec->online_bm_len, i, ncm_vector_fast_get (svec->online_bm_cur, i) / svec->online_bm_size);
+
+    ncm_vector_set_zero (svec->online_bm_cur);
+    svec->online_bm_cur_n = 0;
+    svec->online_bm_len++;
+
+    if (svec->online_bm_len == 2 * svec->online_nbatches)
+    {
+      guint j;
+
+      for (j = 0; j < svec->online_nbatches; j++)
+      {
+        for (i = 0; i < svec->len; i++)
+        {
+          const gdouble bm_ji = 0.5 * (ncm_matrix_get (svec->online_bm, 2 * j, i) + ncm_matrix_get (svec->online_bm, 2 * j + 1, i));
+          ncm_matrix_set (svec->online_bm, j, i, bm_ji);
+        }
+      }
+
+      svec->online_bm_len   = svec->online_nbatches;
+      svec->online_bm_size *= 2;
+    }
+  }
 }
 
 static void
@@ -509,6 +642,12 @@ _ncm_stats_vec_update_from_vec_weight_cov (NcmStatsVec *svec, const gdouble w, N
       gsl_rstat_quantile_add (x_i, qws_i);
     }
   }
+
+  if (svec->qs_array->len == svec->len)
+    _ncm_stats_vec_update_qsketch (svec, w, x);
+
+  if (svec->online_lag > 0)
+    _ncm_stats_vec_update_online_diag (svec, x);
 }
 
 static void
@@ -547,6 +686,12 @@ _ncm_stats_vec_update_from_vec_weight_var (NcmStatsVec *svec, const gdouble w, N
       gsl_rstat_quantile_add (x_i, qws_i);
     }
   }
+
+  if (svec->qs_array->len == svec->len)
+    _ncm_stats_vec_update_qsketch (svec, w, x);
+
+  if (svec->online_lag > 0)
+    _ncm_stats_vec_update_online_diag (svec, x);
 }
 
 static void
@@ -582,6 +727,12 @@ _ncm_stats_vec_update_from_vec_weight_mean (NcmStatsVec *svec, const gdouble w,
       gsl_rstat_quantile_add (x_i, qws_i);
     }
   }
+
+  if (svec->qs_array->len == svec->len)
+    _ncm_stats_vec_update_qsketch (svec, w, x);
+
+  if (svec->online_lag > 0)
+    _ncm_stats_vec_update_online_diag (svec, x);
 }
 
 /**
@@ -892,6 +1043,308 @@ ncm_stats_vec_get_quantile_spread (NcmStatsVec *svec, guint i)
   }
 }
 
+/**
+ * ncm_stats_vec_enable_qsketch:
+ * @svec: a #NcmStatsVec
+ * @compression: the sketch compression, see ncm_stats_qsketch_new()
+ * 
+ * Enables the streaming quantile sketch of each component, see
+ * #NcmStatsQSketch. Contrary to ncm_stats_vec_enable_quantile(), any
+ * quantile can be obtained afterwards and the weights are taken into
+ * account. If @svec already contains data it is added to the sketches
+ * when available, i.e., when @svec saves the data.
+ * 
+ */
+void 
+ncm_stats_vec_enable_qsketch (NcmStatsVec *svec, gdouble compression)
+{
+  guint i;
+
+  g_ptr_array_set_size (svec->qs_array, 0);
+    
+  for (i = 0; i < svec->len; i++)
+    g_ptr_array_add (svec->qs_array, ncm_stats_qsketch_new (compression));
+
+  if (svec->nitens > 0)
+  {
+    if (!svec->save_x)
+    {
+      g_warning ("ncm_stats_vec_enable_qsketch: Enabling quantile sketch in a non-empty NcmStatsVec,"
+                 " all previous data will be ignored in the quantiles.");
+    }
+    else
+    {
+      if (svec->weight != svec->nitens)
+        g_warning ("ncm_stats_vec_enable_qsketch: the weights of the saved data are not available,"
+                   " using unit weights for the previous data.");
+
+      for (i = 0; i < svec->saved_x->len; i++)
+        _ncm_stats_vec_update_qsketch (svec, 1.0, g_ptr_array_index (svec->saved_x, i));
+    }
+  }
+}
+
+/**
+ * ncm_stats_vec_disable_qsketch:
+ * @svec: a #NcmStatsVec
+ * 
+ * Disables the quantile sketches.
+ * 
+ */
+void 
+ncm_stats_vec_disable_qsketch (NcmStatsVec *svec)
+{
+  g_ptr_array_set_size (svec->qs_array, 0);
+}
+
+/**
+ * ncm_stats_vec_peek_qsketch:
+ * @svec: a #NcmStatsVec
+ * @i: a variable index
+ * 
+ * Gets the quantile sketch of the @i-th component enabled through
+ * ncm_stats_vec_enable_qsketch(). It can be merged with the sketches
+ * of other #NcmStatsVec, e.g., from different chains, using
+ * ncm_stats_qsketch_merge().
+ * 
+ * Returns: (transfer none): the #NcmStatsQSketch of the @i-th component.
+ */
+NcmStatsQSketch *
+ncm_stats_vec_peek_qsketch (NcmStatsVec *svec, guint i)
+{
+  g_assert_cmpuint (i, <, svec->qs_array->len);
+  
+  return g_ptr_array_index (svec->qs_array, i);
+}
+
+/**
+ * ncm_stats_vec_get_qsketch_quantile:
+ * @svec: a #NcmStatsVec
+ * @i: a variable index
+ * @p: probability $p \in [0, 1]$
+ * 
+ * Estimates the @p quantile of the @i-th component using the
+ * sketch enabled through ncm_stats_vec_enable_qsketch().
+ * 
+ * Returns: the current estimate of the @p quantile.
+ */
+gdouble
+ncm_stats_vec_get_qsketch_quantile (NcmStatsVec *svec, guint i, gdouble p)
+{
+  return ncm_stats_qsketch_get_quantile (ncm_stats_vec_peek_qsketch (svec, i), p);
+}
+
+/**
+ * ncm_stats_vec_enable_online_diag:
+ * @svec: a #NcmStatsVec
+ * @max_lag: maximum lag kept, if zero uses #NCM_STATS_VEC_ONLINE_DEFAULT_LAG
+ * @nbatches: minimum number of batches, if zero uses #NCM_STATS_VEC_ONLINE_DEFAULT_NBATCHES
+ * 
+ * Enables the online convergence diagnostics. For each component it keeps
+ * the last @max_lag values in a ring buffer and accumulates the lagged
+ * sums necessary to compute the autocovariance up to @max_lag, see
+ * ncm_stats_vec_get_online_autocorr_tau(). It also keeps between @nbatches
+ * and $2 \times$ @nbatches batch means, doubling the batch size whenever
+ * the upper limit is reached, see ncm_stats_vec_get_online_bm_var().
+ * 
+ * The cost per update is $O(\text{@max\_lag})$ and does not depend on
+ * the number of items. The weights are not taken into account. If @svec
+ * already contains saved data it is added to the diagnostics.
+ * 
+ */
+void 
+ncm_stats_vec_enable_online_diag (NcmStatsVec *svec, guint max_lag, guint nbatches)
+{
+  max_lag  = (max_lag == 0)  ? NCM_STATS_VEC_ONLINE_DEFAULT_LAG : max_lag;
+  nbatches = (nbatches == 0) ? NCM_STATS_VEC_ONLINE_DEFAULT_NBATCHES : nbatches;
+
+  ncm_stats_vec_disable_online_diag (svec);
+
+  svec->online_lag      = max_lag;
+  svec->online_nbatches = nbatches;
+  svec->online_ring     = ncm_matrix_new (max_lag, svec->len);
+  svec->online_xy       = ncm_matrix_new (max_lag + 1, svec->len);
+  svec->online_xa       = ncm_matrix_new (max_lag + 1, svec->len);
+  svec->online_xb       = ncm_matrix_new (max_lag + 1, svec->len);
+  svec->online_bm       = ncm_matrix_new (2 * nbatches, svec->len);
+  svec->online_bm_cur   = ncm_vector_new (svec->len);
+
+  _ncm_stats_vec_reset_online_diag (svec);
+
+  if (svec->nitens > 0)
+  {
+    if (!svec->save_x)
+    {
+      g_warning ("ncm_stats_vec_enable_online_diag: Enabling online diagnostics in a non-empty NcmStatsVec,"
+                 " all previous data will be ignored.");
+    }
+    else
+    {
+      guint i;
+
+      for (i = 0; i < svec->saved_x->len; i++)
+        _ncm_stats_vec_update_online_diag (svec, g_ptr_array_index (svec->saved_x, i));
+    }
+  }
+}
+
+/**
+ * ncm_stats_vec_disable_online_diag:
+ * @svec: a #NcmStatsVec
+ * 
+ * Disables the online convergence diagnostics.
+ * 
+ */
+void 
+ncm_stats_vec_disable_online_diag (NcmStatsVec *svec)
+{
+  ncm_matrix_clear (&svec->online_ring);
+  ncm_matrix_clear (&svec->online_xy);
+  ncm_matrix_clear (&svec->online_xa);
+  ncm_matrix_clear (&svec->online_xb);
+  ncm_matrix_clear (&svec->online_bm);
+  ncm_vector_clear (&svec->online_bm_cur);
+
+  svec->online_lag      = 0;
+  svec->online_nbatches = 0;
+  svec->online_n        = 0;
+}
+
+/**
+ * ncm_stats_vec_online_diag_enabled:
+ * @svec: a #NcmStatsVec
+ * 
+ * Returns: whether the online diagnostics are enabled, see ncm_stats_vec_enable_online_diag().
+ */
+gboolean
+ncm_stats_vec_online_diag_enabled (NcmStatsVec *svec)
+{
+  return (svec->online_lag > 0);
+}
+
+static gdouble
+_ncm_stats_vec_online_autocov (NcmStatsVec *svec, guint i, guint k)
+{
+  const gdouble nk = svec->online_n - k;
+  const gdouble xy = ncm_matrix_get (svec->online_xy, k, i) / nk;
+  const gdouble xa = ncm_matrix_get (svec->online_xa, k, i) / nk;
+  const gdouble xb = ncm_matrix_get (svec->online_xb, k, i) / nk;
+
+  return xy - xa * xb;
+}
+
+/**
+ * ncm_stats_vec_get_online_autocorr_tau:
+ * @svec: a #NcmStatsVec
+ * @i: a variable index
+ * 
+ * Calculates the integrated autocorrelation time of the @i-th component
+ * from the lagged sums accumulated online, see
+ * ncm_stats_vec_enable_online_diag(). The sum over the autocorrelations
+ * $\rho_k$ is truncated at the first negative $\rho_k$ or at the
+ * maximum lag.
+ * 
+ * Returns: the integrated autocorrelation time.
+ */
+gdouble
+ncm_stats_vec_get_online_autocorr_tau (NcmStatsVec *svec, guint i)
+{
+  g_assert (ncm_stats_vec_online_diag_enabled (svec));
+  g_assert_cmpuint (i, <, svec->len);
+
+  if (svec->online_n < 2)
+    return 1.0;
+  else
+  {
+    const guint max_k  = GSL_MIN (svec->online_lag, svec->online_n - 1);
+    const gdouble C_0  = _ncm_stats_vec_online_autocov (svec, i, 0);
+    gdouble tau        = 0.0;
+    guint k;
+
+    if (C_0 <= 0.0)
+      return 1.0;
+
+    for (k = 1; k <= max_k; k++)
+    {
+      const gdouble rho_k = _ncm_stats_vec_online_autocov (svec, i, k) / C_0;
+
+      if (rho_k < 0.0)
+        break;
+
+      tau += rho_k;
+    }
+
+    return 1.0 + 2.0 * tau;
+  }
+}
+
+/**
+ * ncm_stats_vec_get_online_bm_var:
+ * @svec: a #NcmStatsVec
+ * @i: a variable index
+ * 
+ * Calculates the batch means estimate of the asymptotic variance
+ * $\sigma^2_\text{as}$ of the @i-th component, i.e., the variance
+ * of its mean is approximately $\sigma^2_\text{as} / n$. It uses the
+ * $a$ full batches of size $b$ kept online, see
+ * ncm_stats_vec_enable_online_diag(),
+ * $$\sigma^2_\text{as} = \frac{b}{a - 1}\sum_{j=1}^{a}\left(\bar{x}_j - \bar{x}\right)^2.$$
+ * 
+ * Returns: the batch means estimate of the asymptotic variance or
+ * GSL_POSINF if there are less than two full batches.
+ */
+gdouble
+ncm_stats_vec_get_online_bm_var (NcmStatsVec *svec, guint i)
+{
+  g_assert (ncm_stats_vec_online_diag_enabled (svec));
+  g_assert_cmpuint (i, <, svec->len);
+
+  if (svec->online_bm_len < 2)
+    return GSL_POSINF;
+  else
+  {
+    const guint a  = svec->online_bm_len;
+    gdouble mean   = 0.0;
+    gdouble var    = 0.0;
+    guint j;
+
+    for (j = 0; j < a; j++)
+      mean += ncm_matrix_get (svec->online_bm, j, i);
+    mean = mean / a;
+
+    for (j = 0; j < a; j++)
+      var += gsl_pow_2 (ncm_matrix_get (svec->online_bm, j, i) - mean);
+
+    return svec->online_bm_size * var / (a - 1.0);
+  }
+}
+
+/**
+ * ncm_stats_vec_get_online_bm_tau:
+ * @svec: a #NcmStatsVec
+ * @i: a variable index
+ * 
+ * Calculates the integrated autocorrelation time of the @i-th component
+ * as the ratio between the batch means asymptotic variance, see
+ * ncm_stats_vec_get_online_bm_var(), and the sample variance.
+ * 
+ * Returns: the batch means estimate of the integrated autocorrelation time.
+ */
+gdouble
+ncm_stats_vec_get_online_bm_tau (NcmStatsVec *svec, guint i)
+{
+  const gdouble bm_var = ncm_stats_vec_get_online_bm_var (svec, i);
+
+  if (!gsl_finite (bm_var))
+    return bm_var;
+  else
+  {
+    const gdouble C_0 = _ncm_stats_vec_online_autocov (svec, i, 0);
+
+    return (C_0 > 0.0) ? (bm_var / C_0) : 1.0;
+  }
+}
+
 static void
 _ncm_stats_vec_get_autocorr_alloc (NcmStatsVec *svec, guint size)
 {
@@ -993,6 +1446,157 @@ _ncm_stats_vec_get_autocov (NcmStatsVec *svec, guint p, guint subsample, guint p
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 }
 
+static void
+_ncm_stats_vec_get_autocorr_many_alloc (NcmStatsVec *svec, guint size)
+{
+#ifdef NUMCOSMO_HAVE_FFTW3
+  const guint effsize = ncm_util_fact_size (2 * size);
+
+  if ((svec->many_plan_size != effsize) || (svec->many_plan_len != svec->len) || (svec->many_plan_nthreads != svec->fft_nthreads))
+  {
+    const guint csize = effsize / 2 + 1;
+    const gint n[1]   = {effsize};
+
+    g_clear_pointer (&svec->many_c2r,  fftw_destroy_plan);
+    g_clear_pointer (&svec->many_r2c,  fftw_destroy_plan);
+    g_clear_pointer (&svec->many_fft,  fftw_free);
+    g_clear_pointer (&svec->many_data, fftw_free);
+
+    /* One column per parameter, each column is contiguous. */
+    svec->many_fft  = (fftw_complex *) fftw_malloc (sizeof (fftw_complex) * csize * svec->len);
+    svec->many_data = (gdouble *) fftw_malloc (sizeof (gdouble) * effsize * svec->len);
+
+    ncm_cfg_load_fftw_wisdom ("ncm_stats_vec_autocorr_%u_%u", effsize, svec->len);
+
+    ncm_cfg_lock_plan_fftw ();
+#ifdef HAVE_FFTW3_THREADS
+    fftw_plan_with_nthreads (svec->fft_nthreads);
+#endif /* HAVE_FFTW3_THREADS */
+    svec->many_r2c = fftw_plan_many_dft_r2c (1, n, svec->len,
+                                             svec->many_data, NULL, 1, effsize,
+                                             svec->many_fft,  NULL, 1, csize,
+                                             fftw_default_flags | FFTW_DESTROY_INPUT);
+    svec->many_c2r = fftw_plan_many_dft_c2r (1, n, svec->len,
+                                             svec->many_fft,  NULL, 1, csize,
+                                             svec->many_data, NULL, 1, effsize,
+                                             fftw_default_flags | FFTW_DESTROY_INPUT);
+#ifdef HAVE_FFTW3_THREADS
+    fftw_plan_with_nthreads (1);
+#endif /* HAVE_FFTW3_THREADS */
+    ncm_cfg_unlock_plan_fftw ();
+
+    ncm_cfg_save_fftw_wisdom ("ncm_stats_vec_autocorr_%u_%u", effsize, svec->len);
+
+    svec->many_plan_size     = effsize;
+    svec->many_plan_len      = svec->len;
+    svec->many_plan_nthreads = svec->fft_nthreads;
+  }
+#endif /* NUMCOSMO_HAVE_FFTW3 */
+}
+
+/*
+ * Same as _ncm_stats_vec_get_autocov but for all parameters at once, the
+ * autocovariance of the parameter p is left in
+ * svec->many_data + p * svec->many_plan_size. When peek_col is not NULL the
+ * data is read in place from the columns it returns instead of the saved rows.
+ */
+static void
+_ncm_stats_vec_get_autocov_all (NcmStatsVec *svec, NcmStatsVecPeekCol peek_col, gpointer user_data, guint subsample, guint pad)
+{
+#ifdef NUMCOSMO_HAVE_FFTW3
+  guint eff_nitens = svec->nitens / subsample - pad;
+
+  g_assert_cmpuint (svec->nitens / subsample, >, pad);
+
+  if ((peek_col == NULL) && !svec->save_x)
+    g_error ("_ncm_stats_vec_get_autocov_all: NcmStatsVec must have saved data to calculate autocorrelation.");
+
+  if (eff_nitens == 0)
+    g_error ("_ncm_stats_vec_get_autocov_all: too few itens to calculate.");
+
+  _ncm_stats_vec_get_autocorr_many_alloc (svec, eff_nitens);
+  {
+    const guint effsize = svec->many_plan_size;
+    const guint ntot    = (effsize / 2 + 1) * svec->len;
+    guint i, k;
+
+    for (k = 0; k < svec->len; k++)
+      memset (&svec->many_data[k * effsize + eff_nitens], 0, sizeof (gdouble) * (effsize - eff_nitens));
+
+    if (peek_col != NULL)
+    {
+      const guint row_f = (eff_nitens + pad) * subsample;
+
+      /* One pass over each column, summing the subsamples in the same order as below. */
+      for (k = 0; k < svec->len; k++)
+      {
+        gdouble *col_k       = &svec->many_data[k * effsize];
+        const gdouble mean_k = ncm_stats_vec_get_mean (svec, k);
+        guint row            = pad * subsample;
+
+        memset (col_k, 0, sizeof (gdouble) * eff_nitens);
+
+        while (row < row_f)
+        {
+          guint n;
+          const gdouble *run = peek_col (user_data, k, row, &n);
+          const guint row_e  = GSL_MIN (row + n, row_f);
+
+          g_assert_cmpuint (n, >, 0);
+
+          for (; row < row_e; row++, run++)
+            col_k[row / subsample - pad] += run[0];
+        }
+
+        for (i = 0; i < eff_nitens; i++)
+          col_k[i] = col_k[i] / (1.0 * subsample) - mean_k;
+      }
+    }
+    else
+    {
+      /* Single pass over the saved rows, scattering into the columns. */
+      for (i = 0; i < eff_nitens; i++)
+      {
+        if (subsample > 1)
+        {
+          guint j;
+
+          for (k = 0; k < svec->len; k++)
+            svec->many_data[k * effsize + i] = 0.0;
+
+          for (j = 0; j < subsample; j++)
+          {
+            NcmVector *row = g_ptr_array_index (svec->saved_x, (i + pad) * subsample + j);
+
+            for (k = 0; k < svec->len; k++)
+              svec->many_data[k * effsize + i] += ncm_vector_get (row, k);
+          }
+
+          for (k = 0; k < svec->len; k++)
+            svec->many_data[k * effsize + i] = svec->many_data[k * effsize + i] / (1.0 * subsample) - ncm_stats_vec_get_mean (svec, k);
+        }
+        else
+        {
+          NcmVector *row = g_ptr_array_index (svec->saved_x, i + pad);
+
+          for (k = 0; k < svec->len; k++)
+            svec->many_data[k * effsize + i] = ncm_vector_get (row, k) - ncm_stats_vec_get_mean (svec, k);
+        }
+      }
+    }
+
+    fftw_execute (svec->many_r2c);
+
+    for (i = 0; i < ntot; i++)
+    {
+      svec->many_fft[i] = svec->many_fft[i] * conj (svec->many_fft[i]);
+    }
+
+    fftw_execute (svec->many_c2r);
+  }
+#endif /* NUMCOSMO_HAVE_FFTW3 */
+}
+
 /**
  * ncm_stats_vec_get_autocorr:
  * @svec: a #NcmStatsVec
@@ -1053,27 +1657,10 @@ ncm_stats_vec_get_subsample_autocorr (NcmStatsVec *svec, guint p, guint subsampl
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 }
 
-/**
- * ncm_stats_vec_fit_ar_model:
- * @svec: a #NcmStatsVec
- * @p: parameter id
- * @order: max order
- * @ar_crit: a #NcmStatsVecARType
- * @rho: (inout) (nullable): the vector containing the ar(@p) model parameters
- * @pacf: (inout) (nullable):  the vector containing the partial autocorrelations
- * @ivar: (out): innovations variance
- * @c_order: (out): the actual order calculated 
- *
- * If order is zero the value of floor $\left[10 log_{10}(s) \right]$, where $s$ 
- * is the number of points.
- * 
- * Returns: TRUE if @c_order is equal to @order.
- */
-gboolean
-ncm_stats_vec_fit_ar_model (NcmStatsVec *svec, guint p, const guint order, NcmStatsVecARType ar_crit, NcmVector **rho, NcmVector **pacf, gdouble *ivar, guint *c_order)
-{
 #ifdef NUMCOSMO_HAVE_FFTW3
-  _ncm_stats_vec_get_autocov (svec, p, 1, 0);
+static gboolean
+_ncm_stats_vec_fit_ar_model_autocov (NcmStatsVec *svec, guint p, gdouble *autocov, const guint order, NcmStatsVecARType ar_crit, NcmVector **rho, NcmVector **pacf, gdouble *ivar, guint *c_order)
+{
   {
     const guint aorder = (order == 0) ? GSL_MIN (svec->nitens - 1, floor (10 * log10 (svec->nitens))) : order;
     NcmVector *M = ncm_vector_new (2 * aorder + 1);
@@ -1099,18 +1686,18 @@ ncm_stats_vec_fit_ar_model (NcmStatsVec *svec, guint p, const guint order, NcmSt
       allocated_here[1] = TRUE;
     }
 
-    ncm_vector_fast_set (M, aorder, svec->param_data[0]);
+    ncm_vector_fast_set (M, aorder, autocov[0]);
 
     for (i = 0; i < aorder; i++)
     {
-      const gdouble a_i = svec->param_data[i + 1];
+      const gdouble a_i = autocov[i + 1];
       ncm_vector_fast_set (M, aorder + i + 1, a_i);
       ncm_vector_fast_set (M, aorder - i - 1, a_i);
     }
 
     d_lev_inner (ncm_vector_data (*rho), 
                  ncm_vector_ptr (M, aorder), 
-                 aorder, svec->param_data + 1, dlev_tol, dlev_tol, 6, 0, 
+                 aorder, autocov + 1, dlev_tol, dlev_tol, 6, 0, 
                  ncm_vector_data (*pacf));
 
     {
@@ -1221,7 +1808,7 @@ ncm_stats_vec_fit_ar_model (NcmStatsVec *svec, guint p, const guint order, NcmSt
 
       d_lev_inner (ncm_vector_data (c_rho), 
                    ncm_vector_ptr (M, aorder), 
-                   c_order[0], svec->param_data + 1, dlev_tol, dlev_tol, 6, 0, 
+                   c_order[0], autocov + 1, dlev_tol, dlev_tol, 6, 0, 
                    ncm_vector_data (c_pacf));
     }
 
@@ -1229,6 +1816,58 @@ ncm_stats_vec_fit_ar_model (NcmStatsVec *svec, guint p, const guint order, NcmSt
     
     return (aorder == c_order[0]);
   }
+}
+
+static gdouble
+_ncm_stats_vec_ar_ess_autocov (NcmStatsVec *svec, guint p, gdouble *autocov, NcmStatsVecARType ar_crit, gdouble *spec0, guint *c_order)
+{
+  NcmVector *rho = NULL, *pacf = NULL;
+  gdouble ivar   = 0.0;
+  guint order    = 0;
+
+  g_assert_cmpuint (p, <, svec->len);
+  
+  while (_ncm_stats_vec_fit_ar_model_autocov (svec, p, autocov, order, ar_crit, &rho, &pacf, &ivar, c_order) && (2 * c_order[0] + 1 < svec->nitens))
+  {
+    ncm_vector_clear (&rho);
+    ncm_vector_clear (&pacf);
+
+    order = 2 * c_order[0];
+  }
+
+  spec0[0] = ivar;
+  if (c_order[0] > 0)
+    spec0[0] *= 1.0 / gsl_pow_2 (1.0 - ncm_vector_sum_cpts (rho));
+
+  ncm_vector_clear (&rho);
+  ncm_vector_clear (&pacf);
+
+  return svec->nitens * ncm_stats_vec_get_var (svec, p) / spec0[0];
+}
+#endif /* NUMCOSMO_HAVE_FFTW3 */
+
+/**
+ * ncm_stats_vec_fit_ar_model:
+ * @svec: a #NcmStatsVec
+ * @p: parameter id
+ * @order: max order
+ * @ar_crit: a #NcmStatsVecARType
+ * @rho: (inout) (nullable): the vector containing the ar(@p) model parameters
+ * @pacf: (inout) (nullable):  the vector containing the partial autocorrelations
+ * @ivar: (out): innovations variance
+ * @c_order: (out): the actual order calculated 
+ *
+ * If order is zero the value of floor $\left[10 log_{10}(s) \right]$, where $s$ 
+ * is the number of points.
+ * 
+ * Returns: TRUE if @c_order is equal to @order.
+ */
+gboolean
+ncm_stats_vec_fit_ar_model (NcmStatsVec *svec, guint p, const guint order, NcmStatsVecARType ar_crit, NcmVector **rho, NcmVector **pacf, gdouble *ivar, guint *c_order)
+{
+#ifdef NUMCOSMO_HAVE_FFTW3
+  _ncm_stats_vec_get_autocov (svec, p, 1, 0);
+  return _ncm_stats_vec_fit_ar_model_autocov (svec, p, svec->param_data, order, ar_crit, rho, pacf, ivar, c_order);
 #else
   g_error ("ncm_stats_vec_get_autocorr: recompile NumCosmo with fftw support.");
   return FALSE;
@@ -1250,28 +1889,64 @@ ncm_stats_vec_fit_ar_model (NcmStatsVec *svec, guint p, const guint order, NcmSt
 gdouble 
 ncm_stats_vec_ar_ess (NcmStatsVec *svec, guint p, NcmStatsVecARType ar_crit, gdouble *spec0, guint *c_order)
 {
-  NcmVector *rho = NULL, *pacf = NULL;
-  gdouble ivar  = 0.0;
-  guint order = 0;
-
+#ifdef NUMCOSMO_HAVE_FFTW3
   g_assert_cmpuint (p, <, svec->len);
-  
-  while (ncm_stats_vec_fit_ar_model (svec, p, order, ar_crit, &rho, &pacf, &ivar, c_order) && (2 * c_order[0] + 1 < svec->nitens))
-  {
-    ncm_vector_clear (&rho);
-    ncm_vector_clear (&pacf);
 
-    order = 2 * c_order[0];
-  }
+  /* The autocovariance does not depend on the AR order, compute it only once. */
+  _ncm_stats_vec_get_autocov (svec, p, 1, 0);
+  return _ncm_stats_vec_ar_ess_autocov (svec, p, svec->param_data, ar_crit, spec0, c_order);
+#else
+  g_error ("ncm_stats_vec_ar_ess: recompile NumCosmo with fftw support.");
+  return 0.0;
+#endif /* NUMCOSMO_HAVE_FFTW3 */
+}
 
-  spec0[0] = ivar;
-  if (c_order[0] > 0)
-    spec0[0] *= 1.0 / gsl_pow_2 (1.0 - ncm_vector_sum_cpts (rho));
+/**
+ * ncm_stats_vec_ar_ess_all:
+ * @svec: a #NcmStatsVec
+ * @ar_crit: a #NcmStatsVecARType
+ * @spec0: (nullable): a #NcmVector to store the spectral densities at zero or NULL
+ * @c_order: (element-type guint) (nullable): a #GArray to store the @ar_crit determined orders or NULL
+ *
+ * Calculates the effective sample size for all parameters, see
+ * ncm_stats_vec_ar_ess(). The autocovariances of all parameters are
+ * computed using a single batched FFT, see ncm_stats_vec_set_fft_nthreads().
+ *
+ * Returns: (transfer full): a #NcmVector containing the effective sample sizes.
+ */
+NcmVector *
+ncm_stats_vec_ar_ess_all (NcmStatsVec *svec, NcmStatsVecARType ar_crit, NcmVector *spec0, GArray *c_order)
+{
+#ifdef NUMCOSMO_HAVE_FFTW3
+  NcmVector *ess = ncm_vector_new (svec->len);
+  guint p;
 
-  ncm_vector_clear (&rho);
-  ncm_vector_clear (&pacf);
+  if (spec0 != NULL)
+    g_assert_cmpuint (ncm_vector_len (spec0), ==, svec->len);
+  if (c_order != NULL)
+    g_array_set_size (c_order, svec->len);
 
-  return svec->nitens * ncm_stats_vec_get_var (svec, p) / spec0[0];
+  _ncm_stats_vec_get_autocov_all (svec, NULL, NULL, 1, 0);
+
+  for (p = 0; p < svec->len; p++)
+  {
+    gdouble spec0_p = 0.0;
+    guint c_order_p = 0;
+    const gdouble ess_p = _ncm_stats_vec_ar_ess_autocov (svec, p, &svec->many_data[p * svec->many_plan_size], ar_crit, &spec0_p, &c_order_p);
+
+    ncm_vector_set (ess, p, ess_p);
+
+    if (spec0 != NULL)
+      ncm_vector_set (spec0, p, spec0_p);
+    if (c_order != NULL)
+      g_array_index (c_order, guint, p) = c_order_p;
+  }
+
+  return ess;
+#else
+  g_error ("ncm_stats_vec_ar_ess_all: recompile NumCosmo with fftw support.");
+  return NULL;
+#endif /* NUMCOSMO_HAVE_FFTW3 */
 }
 
 static gdouble
@@ -1340,7 +2015,6 @@ ncm_stats_vec_heidel_diag (NcmStatsVec *svec, const guint ntests, const gdouble
   NcmVector *spec0     = ncm_vector_new (svec->len);
   NcmVector *cumsum    = ncm_vector_new (svec->len);
   GArray *ar_order     = g_array_new (FALSE, FALSE, sizeof (guint));
-  guint c_order        = 0;
   gint i;
   
   g_assert_cmpuint (svec->nitens, >=, 10);
@@ -1353,10 +2027,9 @@ ncm_stats_vec_heidel_diag (NcmStatsVec *svec, const guint ntests, const gdouble
     ncm_stats_vec_append (chunk, row, FALSE);
   }
 
-  for (i = 0; i < svec->len; i++)
   {
-    ncm_stats_vec_ar_ess (chunk, i, NCM_STATS_VEC_AR_AICC, ncm_vector_ptr (spec0, i), &c_order);
-    g_array_append_val (ar_order, c_order);
+    NcmVector *ess = ncm_stats_vec_ar_ess_all (chunk, NCM_STATS_VEC_AR_AICC, spec0, ar_order);
+    ncm_vector_free (ess);
   }
 
   bindex[0] = -1;
@@ -1427,6 +2100,7 @@ ncm_stats_vec_heidel_diag (NcmStatsVec *svec, const guint ntests, const gdouble
   wp_pvalue[0] = ncm_vector_get (pvals, wp[0]);
   wp_order[0]  = g_array_index (ar_order, guint, wp[0]);
   
+  g_array_unref (ar_order);
   ncm_vector_clear (&spec0);
   ncm_vector_clear (&cumsum);
   ncm_vector_clear (&Ivals);
@@ -1512,6 +2186,7 @@ ncm_stats_vec_max_ess_time (NcmStatsVec *svec, const guint ntests, gint *bindex,
   const gint block    = (ntests == 0) ? ((size - 1) / 10 + 1) : ((size - 1) / ntests + 1);
   NcmVector *esss_tmp = ncm_vector_new (svec->len);
   NcmVector *esss     = ncm_vector_new (svec->len);
+  GArray *ar_order    = g_array_new (FALSE, FALSE, sizeof (guint));
   gdouble max_t_ess   = 0.0;
   gint i, j = 0;
   
@@ -1528,27 +2203,27 @@ ncm_stats_vec_max_ess_time (NcmStatsVec *svec, const guint ntests, gint *bindex,
     {
       gdouble min_ess = GSL_POSINF;
       guint cur_size  = size - i;
-      guint lwp_order = 0;
+      NcmVector *ess  = ncm_stats_vec_ar_ess_all (chunk, NCM_STATS_VEC_AR_AICC, NULL, ar_order);
       guint k, lwp    = 0;
 
       for (k = 0; k < svec->len; k++)
       {
-        gdouble spec0       = 0.0;
-        const gdouble ess   = ncm_stats_vec_ar_ess (chunk, k, NCM_STATS_VEC_AR_AICC, &spec0, &lwp_order);
-        const gdouble c_ess = GSL_MIN (cur_size, ess);
+        const gdouble c_ess = GSL_MIN (cur_size, ncm_vector_get (ess, k));
 
-        ncm_vector_set (esss_tmp, k, ess);
         if (c_ess < min_ess)
         {
           min_ess = c_ess;
           lwp     = k;
         }
       }
+      ncm_vector_memcpy (esss_tmp, ess);
+      ncm_vector_free (ess);
+
       if (min_ess > max_t_ess)
       {
         max_t_ess   = min_ess;
         bindex[0]   = i;
-        wp_order[0] = lwp_order;
+        wp_order[0] = g_array_index (ar_order, guint, lwp);
         wp[0]       = lwp;
 
         ncm_vector_memcpy (esss, esss_tmp);
@@ -1559,6 +2234,7 @@ ncm_stats_vec_max_ess_time (NcmStatsVec *svec, const guint ntests, gint *bindex,
 
   wp_ess[0] = ncm_vector_get (esss, wp[0]);
 
+  g_array_unref (ar_order);
   ncm_vector_clear (&esss_tmp);
   ncm_stats_vec_clear (&chunk);
 
@@ -1686,6 +2362,130 @@ ncm_stats_vec_get_subsample_autocorr_tau (NcmStatsVec *svec, const guint p, cons
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 }
 
+static NcmVector *
+_ncm_stats_vec_get_tau_all (NcmStatsVec *svec, const guint eff_nitens, const guint max_lag)
+{
+#ifdef NUMCOSMO_HAVE_FFTW3
+  const guint Imax_lag = (max_lag == 0) ? eff_nitens / 10 : max_lag;
+  const guint Fmax_lag = (Imax_lag > 1000) ? 1000 : Imax_lag;
+  NcmVector *tau_v     = ncm_vector_new (svec->len);
+  guint i, k;
+
+  g_assert_cmpuint (Fmax_lag, >, 0);
+  g_assert_cmpuint (Fmax_lag, <, eff_nitens);
+
+  for (k = 0; k < svec->len; k++)
+  {
+    const gdouble *autocov = &svec->many_data[k * svec->many_plan_size];
+    gdouble tau            = 0.0;
+
+    for (i = 1; i < Fmax_lag + 1; i++)
+    {
+      const gdouble rho_i = autocov[i] / autocov[0];
+
+      tau += rho_i;
+    }
+
+    ncm_vector_set (tau_v, k, 1.0 + 2.0 * tau);
+  }
+
+  return tau_v;
+#else
+  g_error ("_ncm_stats_vec_get_tau_all: recompile NumCosmo with fftw support.");
+  return NULL;
+#endif /* NUMCOSMO_HAVE_FFTW3 */
+}
+
+/**
+ * ncm_stats_vec_get_autocorr_tau_all:
+ * @svec: a #NcmStatsVec
+ * @max_lag: max lag in the computation
+ *
+ * Calculates the integrated autocorrelation time for all parameters
+ * using all rows of data, see ncm_stats_vec_get_autocorr_tau(). The
+ * autocorrelations are computed using a single batched FFT.
+ *
+ * Returns: (transfer full): a #NcmVector containing the integrated autocorrelation times.
+ */
+NcmVector *
+ncm_stats_vec_get_autocorr_tau_all (NcmStatsVec *svec, const guint max_lag)
+{
+  _ncm_stats_vec_get_autocov_all (svec, NULL, NULL, 1, 0);
+
+  return _ncm_stats_vec_get_tau_all (svec, svec->nitens, max_lag);
+}
+
+/**
+ * ncm_stats_vec_get_subsample_autocorr_tau_all:
+ * @svec: a #NcmStatsVec
+ * @subsample: size of the subsample ($>0$)
+ * @max_lag: max lag in the computation
+ *
+ * Calculates the integrated autocorrelation time for all parameters
+ * using the @subsample parameter, see ncm_stats_vec_get_subsample_autocorr_tau().
+ *
+ * Returns: (transfer full): a #NcmVector containing the integrated autocorrelation times.
+ */
+NcmVector *
+ncm_stats_vec_get_subsample_autocorr_tau_all (NcmStatsVec *svec, const guint subsample, const guint max_lag)
+{
+  _ncm_stats_vec_get_autocov_all (svec, NULL, NULL, subsample, 0);
+
+  return _ncm_stats_vec_get_tau_all (svec, svec->nitens / subsample, max_lag);
+}
+
+/**
+ * ncm_stats_vec_get_autocorr_tau_all_cols:
+ * @svec: a #NcmStatsVec
+ * @peek_col: (scope call): a #NcmStatsVecPeekCol
+ * @user_data: (closure): user data passed to @peek_col
+ * @subsample: size of the subsample ($>0$)
+ * @max_lag: max lag in the computation
+ *
+ * Same as ncm_stats_vec_get_subsample_autocorr_tau_all() but the data is read
+ * in place from the columns returned by @peek_col instead of the saved rows.
+ * The columns must contain the same #NcmStatsVec:nitens rows used to update
+ * @svec, e.g., a columnar copy kept by the caller, @svec does not need to
+ * save its rows.
+ *
+ * Returns: (transfer full): a #NcmVector containing the integrated autocorrelation times.
+ */
+NcmVector *
+ncm_stats_vec_get_autocorr_tau_all_cols (NcmStatsVec *svec, NcmStatsVecPeekCol peek_col, gpointer user_data, const guint subsample, const guint max_lag)
+{
+  _ncm_stats_vec_get_autocov_all (svec, peek_col, user_data, subsample, 0);
+
+  return _ncm_stats_vec_get_tau_all (svec, svec->nitens / subsample, max_lag);
+}
+
+/**
+ * ncm_stats_vec_set_fft_nthreads:
+ * @svec: a #NcmStatsVec
+ * @nthreads: number of threads
+ *
+ * Sets the number of threads used by the batched FFTs, see
+ * ncm_stats_vec_get_autocorr_tau_all() and ncm_stats_vec_ar_ess_all().
+ * Each call transforms all parameters at once, so
+ * ncm_stats_vec_max_ess_time() and ncm_stats_vec_heidel_diag() still run
+ * one transform per test window. This has effect only when FFTW was
+ * compiled with threads support. #NcmMSetCatalog forwards its value, see
+ * ncm_mset_catalog_set_fft_nthreads().
+ *
+ */
+void
+ncm_stats_vec_set_fft_nthreads (NcmStatsVec *svec, guint nthreads)
+{
+#ifdef NUMCOSMO_HAVE_FFTW3
+  g_assert_cmpuint (nthreads, >, 0);
+#ifndef HAVE_FFTW3_THREADS
+  if (nthreads > 1)
+    g_warning ("ncm_stats_vec_set_fft_nthreads: FFTW threads not available, ignoring.");
+  nthreads = 1;
+#endif /* HAVE_FFTW3_THREADS */
+  svec->fft_nthreads = nthreads;
+#endif /* NUMCOSMO_HAVE_FFTW3 */
+}
+
 /**
  * ncm_stats_vec_peek_x:
  * @svec: a #NcmStatsVec
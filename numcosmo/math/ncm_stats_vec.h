@@ -31,6 +31,7 @@
 #include <numcosmo/build_cfg.h>
 #include <numcosmo/math/ncm_vector.h>
 #include <numcosmo/math/ncm_matrix.h>
+#include <numcosmo/math/ncm_stats_qsketch.h>
 
 #include <math.h>
 #ifndef NUMCOSMO_GIR_SCAN
@@ -79,6 +80,20 @@ typedef enum
 
 typedef void (*NcmStatsVecUpdateFunc) (NcmStatsVec *svec, const gdouble w, NcmVector *x);
 
+/**
+ * NcmStatsVecPeekCol:
+ * @user_data: user data
+ * @p: parameter index
+ * @i: row index
+ * @n: (out): number of contiguous elements returned
+ *
+ * Gives direct access to the column @p of external data ordered as the rows
+ * of a #NcmStatsVec, see ncm_stats_vec_get_autocorr_tau_all_cols().
+ *
+ * Returns: a pointer to the elements $i, \dots, i + n - 1$ of the column @p, $n \geq 1$.
+ */
+typedef const gdouble *(*NcmStatsVecPeekCol) (gpointer user_data, guint p, guint i, guint *n);
+
 struct _NcmStatsVec
 {
   /*< private >*/
@@ -99,6 +114,19 @@ struct _NcmStatsVec
   NcmMatrix *real_cov;
   GPtrArray *saved_x;
   GPtrArray *q_array;
+  GPtrArray *qs_array;
+  guint online_lag;
+  guint online_nbatches;
+  gulong online_n;
+  NcmMatrix *online_ring;
+  NcmMatrix *online_xy;
+  NcmMatrix *online_xa;
+  NcmMatrix *online_xb;
+  NcmMatrix *online_bm;
+  NcmVector *online_bm_cur;
+  guint online_bm_size;
+  guint online_bm_len;
+  guint online_bm_cur_n;
 #ifdef NUMCOSMO_HAVE_FFTW3
   guint fft_size;
   guint fft_plan_size;
@@ -106,6 +134,14 @@ struct _NcmStatsVec
   fftw_complex *param_fft;
   fftw_plan param_r2c;
   fftw_plan param_c2r;
+  guint fft_nthreads;
+  guint many_plan_size;
+  guint many_plan_len;
+  guint many_plan_nthreads;
+  gdouble *many_data;
+  fftw_complex *many_fft;
+  fftw_plan many_r2c;
+  fftw_plan many_c2r;
 #endif /* NUMCOSMO_HAVE_FFTW3 */
 };
 
@@ -151,11 +187,29 @@ void ncm_stats_vec_disable_quantile (NcmStatsVec *svec);
 gdouble ncm_stats_vec_get_quantile (NcmStatsVec *svec, guint i);
 gdouble ncm_stats_vec_get_quantile_spread (NcmStatsVec *svec, guint i);
 
+void ncm_stats_vec_enable_qsketch (NcmStatsVec *svec, gdouble compression);
+void ncm_stats_vec_disable_qsketch (NcmStatsVec *svec);
+NcmStatsQSketch *ncm_stats_vec_peek_qsketch (NcmStatsVec *svec, guint i);
+gdouble ncm_stats_vec_get_qsketch_quantile (NcmStatsVec *svec, guint i, gdouble p);
+
+void ncm_stats_vec_enable_online_diag (NcmStatsVec *svec, guint max_lag, guint nbatches);
+void ncm_stats_vec_disable_online_diag (NcmStatsVec *svec);
+gboolean ncm_stats_vec_online_diag_enabled (NcmStatsVec *svec);
+gdouble ncm_stats_vec_get_online_autocorr_tau (NcmStatsVec *svec, guint i);
+gdouble ncm_stats_vec_get_online_bm_var (NcmStatsVec *svec, guint i);
+gdouble ncm_stats_vec_get_online_bm_tau (NcmStatsVec *svec, guint i);
+
 NcmVector *ncm_stats_vec_get_autocorr (NcmStatsVec *svec, guint p);
 NcmVector *ncm_stats_vec_get_subsample_autocorr (NcmStatsVec *svec, guint p, guint subsample);
 gdouble ncm_stats_vec_get_autocorr_tau (NcmStatsVec *svec, guint p, const guint max_lag);
 gdouble ncm_stats_vec_get_subsample_autocorr_tau (NcmStatsVec *svec, guint p, guint subsample, const guint max_lag);
 
+void ncm_stats_vec_set_fft_nthreads (NcmStatsVec *svec, guint nthreads);
+NcmVector *ncm_stats_vec_get_autocorr_tau_all (NcmStatsVec *svec, const guint max_lag);
+NcmVector *ncm_stats_vec_get_subsample_autocorr_tau_all (NcmStatsVec *svec, const guint subsample, const guint max_lag);
+NcmVector *ncm_stats_vec_get_autocorr_tau_all_cols (NcmStatsVec *svec, NcmStatsVecPeekCol peek_col, gpointer user_data, const guint subsample, const guint max_lag);
+NcmVector *ncm_stats_vec_ar_ess_all (NcmStatsVec *svec, NcmStatsVecARType ar_crit, NcmVector *spec0, GArray *c_order);
+
 gboolean ncm_stats_vec_fit_ar_model (NcmStatsVec *svec, guint p, const guint order, NcmStatsVecARType ar_crit, NcmVector **rho, NcmVector **pacf, gdouble *ivar, guint *c_order);
 gdouble ncm_stats_vec_ar_ess (NcmStatsVec *svec, guint p, NcmStatsVecARType ar_crit, gdouble *spec0, guint *c_order);
 
@@ -186,6 +240,8 @@ G_INLINE_FUNC NcmVector *ncm_stats_vec_peek_row (NcmStatsVec *svec, guint i);
 G_INLINE_FUNC gdouble ncm_stats_vec_get_param_at (NcmStatsVec *svec, guint i, guint p);
 
 #define NCM_STATS_VEC_HEIDEL_PVAL_COR(pvalue,n) (1.0 - pow (1.0 - (pvalue), 1.0 / ((gdouble)(n))))
+#define NCM_STATS_VEC_ONLINE_DEFAULT_LAG (100)
+#define NCM_STATS_VEC_ONLINE_DEFAULT_NBATCHES (32)
 
 G_END_DECLS
 
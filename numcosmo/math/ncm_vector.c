@@ -403,6 +403,24 @@ ncm_vector_substitute (NcmVector **cv, NcmVector *nv, gboolean check_size)
     *cv = ncm_vector_ref (nv);
 }
 
+/**
+ * ncm_vector_new_view: (skip)
+ * @view: a #NcmVectorView
+ *
+ * Creates a #NcmVector pointing to the same data as @view, no reference
+ * to the viewed object is kept. The returned vector can be moved to other
+ * views with ncm_vector_set_view(), which allows hot loops to pass rows and
+ * subvectors to functions expecting a #NcmVector without allocating a new
+ * object for each of them.
+ *
+ * Returns: (transfer full): A new #NcmVector.
+ */
+NcmVector *
+ncm_vector_new_view (NcmVectorView *view)
+{
+  return ncm_vector_new_data_static (view->vv.vector.data, view->vv.vector.size, view->vv.vector.stride);
+}
+
 /**
  * ncm_vector_get_subvector:
  * @cv: a #NcmVector.
@@ -797,6 +815,62 @@ ncm_vector_log_vals_func (const NcmVector *v, const gchar *prestr, const gchar *
  *
  * Returns: FIXME
  */
+/**
+ * ncm_vector_get_subvector_view: (skip)
+ * @cv: a #NcmVector
+ * @k: component index of the original vector
+ * @size: number of components of the subvector
+ *
+ * Same as ncm_vector_get_subvector() but returns a #NcmVectorView, no
+ * object is created and no reference to @cv is taken.
+ *
+ * Returns: a #NcmVectorView of the subvector.
+ */
+/**
+ * ncm_vector_set_view: (skip)
+ * @cv: a #NcmVector created by ncm_vector_new_view()
+ * @view: a #NcmVectorView
+ *
+ * Points @cv to the data of @view. The vector @cv must not own its
+ * data, e.g., it was created with ncm_vector_new_view() or
+ * ncm_vector_new_data_static().
+ *
+ */
+/**
+ * ncm_vector_view_gsl: (skip)
+ * @view: a #NcmVectorView
+ *
+ * Returns: the #gsl_vector of @view, it can be used directly in the gsl_blas calls.
+ */
+/**
+ * ncm_vector_view_len: (skip)
+ * @view: a #NcmVectorView
+ *
+ * Returns: the length of @view.
+ */
+/**
+ * ncm_vector_view_get: (skip)
+ * @view: a #NcmVectorView
+ * @i: component index
+ *
+ * Returns: the @i-th component of @view.
+ */
+/**
+ * ncm_vector_view_set: (skip)
+ * @view: a #NcmVectorView
+ * @i: component index
+ * @val: a double
+ *
+ * Sets the @i-th component of @view to @val.
+ *
+ */
+/**
+ * ncm_vector_view_ptr: (skip)
+ * @view: a #NcmVectorView
+ * @i: component index
+ *
+ * Returns: a pointer to the @i-th component of @view.
+ */
 /**
  * ncm_vector_gsl: (skip)
  * @cv: a #NcmVector.
@@ -80,6 +80,19 @@ struct _NcmVector
   NcmVectorInternal type;
 };
 
+/**
+ * NcmVectorView:
+ *
+ * A plain (non #GObject) view of the data of a #NcmVector or of a row/column
+ * of a #NcmMatrix. It can be allocated on the stack and does not hold any
+ * reference to the viewed object.
+ */
+typedef struct _NcmVectorView
+{
+  /*< private >*/
+  gsl_vector_view vv;
+} NcmVectorView;
+
 typedef gdouble (*NcmVectorCompFunc) (gdouble v_i, guint i, gpointer user_data);
 
 GType ncm_vector_get_type (void) G_GNUC_CONST;
@@ -102,6 +115,8 @@ const NcmVector *ncm_vector_const_ref (const NcmVector *cv);
 const NcmVector *ncm_vector_const_new_variant (GVariant *var);
 const NcmVector *ncm_vector_const_new_data (const gdouble *d, const gsize size, const gsize stride);
 
+NcmVector *ncm_vector_new_view (NcmVectorView *view);
+
 NcmVector *ncm_vector_get_subvector (NcmVector *cv, const gsize k, const gsize size);
 GVariant *ncm_vector_get_variant (const NcmVector *v);
 GVariant *ncm_vector_peek_variant (const NcmVector *v);
@@ -157,6 +172,14 @@ G_INLINE_FUNC gsize ncm_vector_get_min_index (const NcmVector *cv);
 
 G_INLINE_FUNC void ncm_vector_get_minmax (const NcmVector *cv, gdouble *min, gdouble *max);
 
+G_INLINE_FUNC NcmVectorView ncm_vector_get_subvector_view (NcmVector *cv, const gsize k, const gsize size);
+G_INLINE_FUNC void ncm_vector_set_view (NcmVector *cv, NcmVectorView *view);
+G_INLINE_FUNC gsl_vector *ncm_vector_view_gsl (NcmVectorView *view);
+G_INLINE_FUNC guint ncm_vector_view_len (const NcmVectorView *view);
+G_INLINE_FUNC gdouble ncm_vector_view_get (const NcmVectorView *view, const guint i);
+G_INLINE_FUNC void ncm_vector_view_set (NcmVectorView *view, const guint i, const gdouble val);
+G_INLINE_FUNC gdouble *ncm_vector_view_ptr (NcmVectorView *view, const guint i);
+
 void ncm_vector_get_absminmax (const NcmVector *cv, gdouble *absmin, gdouble *absmax);
 
 NcmVector *ncm_vector_dup (const NcmVector *cv);
@@ -432,6 +455,53 @@ ncm_vector_get_minmax (const NcmVector *cv, gdouble *min, gdouble *max)
   gsl_vector_minmax (ncm_vector_const_gsl (cv), min, max);
 }
 
+G_INLINE_FUNC NcmVectorView
+ncm_vector_get_subvector_view (NcmVector *cv, const gsize k, const gsize size)
+{
+  NcmVectorView view;
+
+  view.vv = gsl_vector_subvector (ncm_vector_gsl (cv), k, size);
+
+  return view;
+}
+
+G_INLINE_FUNC void
+ncm_vector_set_view (NcmVector *cv, NcmVectorView *view)
+{
+  g_assert ((cv->type == NCM_VECTOR_DERIVED) && (cv->pdata == NULL));
+  cv->vv = view->vv;
+}
+
+G_INLINE_FUNC gsl_vector *
+ncm_vector_view_gsl (NcmVectorView *view)
+{
+  return &(view->vv.vector);
+}
+
+G_INLINE_FUNC guint
+ncm_vector_view_len (const NcmVectorView *view)
+{
+  return view->vv.vector.size;
+}
+
+G_INLINE_FUNC gdouble
+ncm_vector_view_get (const NcmVectorView *view, const guint i)
+{
+  return gsl_vector_get (&(view->vv.vector), i);
+}
+
+G_INLINE_FUNC void
+ncm_vector_view_set (NcmVectorView *view, const guint i, const gdouble val)
+{
+  gsl_vector_set (&(view->vv.vector), i, val);
+}
+
+G_INLINE_FUNC gdouble *
+ncm_vector_view_ptr (NcmVectorView *view, const guint i)
+{
+  return gsl_vector_ptr (&(view->vv.vector), i);
+}
+
 G_END_DECLS
 
 #endif /* NUMCOSMO_HAVE_INLINE */
@@ -234,6 +234,13 @@ static gdouble _nc_hicosmo_de_dE2Omega_de_dz (NcHICosmoDE *cosmo_de, gdouble z);
 static gdouble _nc_hicosmo_de_d2E2Omega_de_dz2 (NcHICosmoDE *cosmo_de, gdouble z);
 static gdouble _nc_hicosmo_de_w_de (NcHICosmoDE *cosmo_de, gdouble z);
 
+static void _nc_hicosmo_de_E2_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len);
+static void _nc_hicosmo_de_dE2_dz_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len);
+static void _nc_hicosmo_de_E2Omega_m_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len);
+
+static void _nc_hicosmo_de_E2Omega_de_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len);
+static void _nc_hicosmo_de_dE2Omega_de_dz_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len);
+
 static void
 nc_hicosmo_de_class_init (NcHICosmoDEClass *klass)
 {
@@ -353,11 +360,18 @@ nc_hicosmo_de_class_init (NcHICosmoDEClass *klass)
 
   nc_hicosmo_set_E2Omega_m_impl   (parent_class, &_nc_hicosmo_de_E2Omega_m);
   nc_hicosmo_set_E2Omega_r_impl   (parent_class, &_nc_hicosmo_de_E2Omega_r);
+
+  /* Vector implementations, must come after the scalar ones */
+  nc_hicosmo_set_E2_vec_impl        (parent_class, &_nc_hicosmo_de_E2_vec);
+  nc_hicosmo_set_dE2_dz_vec_impl    (parent_class, &_nc_hicosmo_de_dE2_dz_vec);
+  nc_hicosmo_set_E2Omega_m_vec_impl (parent_class, &_nc_hicosmo_de_E2Omega_m_vec);
   
-  klass->E2Omega_de       = &_nc_hicosmo_de_E2Omega_de;
-  klass->dE2Omega_de_dz   = &_nc_hicosmo_de_dE2Omega_de_dz;
-  klass->d2E2Omega_de_dz2 = &_nc_hicosmo_de_d2E2Omega_de_dz2;
-  klass->w_de             = &_nc_hicosmo_de_w_de;
+  klass->E2Omega_de         = &_nc_hicosmo_de_E2Omega_de;
+  klass->dE2Omega_de_dz     = &_nc_hicosmo_de_dE2Omega_de_dz;
+  klass->d2E2Omega_de_dz2   = &_nc_hicosmo_de_d2E2Omega_de_dz2;
+  klass->w_de               = &_nc_hicosmo_de_w_de;
+  klass->E2Omega_de_vec     = &_nc_hicosmo_de_E2Omega_de_vec;
+  klass->dE2Omega_de_dz_vec = &_nc_hicosmo_de_dE2Omega_de_dz_vec;
 }
 
 static gdouble _nc_hicosmo_de_Omega_mnu0_n (NcHICosmo *cosmo, const guint n);
@@ -500,6 +514,83 @@ _nc_hicosmo_de_dE2_dz (NcHICosmo *cosmo, gdouble z)
     + dE2Omega_mnu_dz;
 }
 
+/****************************************************************************
+ * Vector versions, the redshift independent terms are computed only once
+ * and the massive neutrinos terms only when they are present.
+ ****************************************************************************/
+
+static void
+_nc_hicosmo_de_E2_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len)
+{
+  const guint nmassnu   = ncm_model_vparam_len (NCM_MODEL (cosmo), NC_HICOSMO_DE_MASSNU_M);
+  const gdouble Omega_r = OMEGA_R;
+  const gdouble Omega_m = OMEGA_M;
+  const gdouble Omega_k = OMEGA_K;
+  guint i;
+
+  NC_HICOSMO_DE_GET_CLASS (cosmo)->E2Omega_de_vec (NC_HICOSMO_DE (cosmo), z, f, len);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x  = 1.0 + z[i];
+    const gdouble x2 = x * x;
+
+    f[i] += x2 * ((Omega_r * x + Omega_m) * x + Omega_k);
+  }
+
+  if (nmassnu > 0)
+  {
+    for (i = 0; i < len; i++)
+      f[i] += _nc_hicosmo_de_E2Omega_mnu (cosmo, z[i]);
+  }
+}
+
+static void
+_nc_hicosmo_de_dE2_dz_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len)
+{
+  const guint nmassnu   = ncm_model_vparam_len (NCM_MODEL (cosmo), NC_HICOSMO_DE_MASSNU_M);
+  const gdouble Omega_r = OMEGA_R;
+  const gdouble Omega_m = OMEGA_M;
+  const gdouble Omega_k = OMEGA_K;
+  guint i;
+
+  NC_HICOSMO_DE_GET_CLASS (cosmo)->dE2Omega_de_dz_vec (NC_HICOSMO_DE (cosmo), z, f, len);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x = 1.0 + z[i];
+
+    f[i] += x * ((4.0 * Omega_r * x + 3.0 * Omega_m) * x + 2.0 * Omega_k);
+  }
+
+  if (nmassnu > 0)
+  {
+    for (i = 0; i < len; i++)
+      f[i] += 3.0 * (_nc_hicosmo_de_E2Omega_mnu (cosmo, z[i]) + _nc_hicosmo_de_E2Press_mnu (cosmo, z[i])) / (1.0 + z[i]);
+  }
+}
+
+static void
+_nc_hicosmo_de_E2Omega_m_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len)
+{
+  const guint nmassnu   = ncm_model_vparam_len (NCM_MODEL (cosmo), NC_HICOSMO_DE_MASSNU_M);
+  const gdouble Omega_m = OMEGA_M;
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x = 1.0 + z[i];
+
+    f[i] = Omega_m * x * x * x;
+  }
+
+  if (nmassnu > 0)
+  {
+    for (i = 0; i < len; i++)
+      f[i] += _nc_hicosmo_de_E2Omega_mnu (cosmo, z[i]) - 3.0 * _nc_hicosmo_de_E2Press_mnu (cosmo, z[i]);
+  }
+}
+
 /****************************************************************************
  * d2E2_dz2
  ****************************************************************************/
@@ -932,6 +1023,26 @@ _nc_hicosmo_de_w_de (NcHICosmoDE *cosmo_de, gdouble z)
   return 0.0;
 }
 
+static void
+_nc_hicosmo_de_E2Omega_de_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len)
+{
+  NcHICosmoDEFunc1 E2Omega_de = NC_HICOSMO_DE_GET_CLASS (cosmo_de)->E2Omega_de;
+  guint i;
+
+  for (i = 0; i < len; i++)
+    f[i] = E2Omega_de (cosmo_de, z[i]);
+}
+
+static void
+_nc_hicosmo_de_dE2Omega_de_dz_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len)
+{
+  NcHICosmoDEFunc1 dE2Omega_de_dz = NC_HICOSMO_DE_GET_CLASS (cosmo_de)->dE2Omega_de_dz;
+  guint i;
+
+  for (i = 0; i < len; i++)
+    f[i] = dE2Omega_de_dz (cosmo_de, z[i]);
+}
+
 #define NC_HICOSMO_DE_SET_IMPL_FUNC(name)                                                                    \
 	void                                                                                                       \
 	nc_hicosmo_de_set_##name##_impl (NcHICosmoDEClass *cosmo_de_class, NcmFuncF f, NcmFuncPF pf, NcmFuncDF df) \
@@ -952,7 +1063,14 @@ _nc_hicosmo_de_w_de (NcHICosmoDE *cosmo_de, gdouble z)
  * FIXME
  *
  */
-NCM_MODEL_SET_IMPL_FUNC (NC_HICOSMO_DE, NcHICosmoDE, nc_hicosmo_de, NcHICosmoDEFunc1, E2Omega_de)
+void
+nc_hicosmo_de_set_E2Omega_de_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1 f)
+{
+  ncm_model_class_add_impl_opts (NCM_MODEL_CLASS (cosmo_de_class), NC_HICOSMO_DE_IMPL_E2Omega_de, -1);
+  cosmo_de_class->E2Omega_de     = f;
+  cosmo_de_class->E2Omega_de_vec = &_nc_hicosmo_de_E2Omega_de_vec;
+}
+
 /**
  * nc_hicosmo_de_set_dE2Omega_de_dz_impl: (skip)
  * @cosmo_de_class: FIXME
@@ -961,7 +1079,14 @@ NCM_MODEL_SET_IMPL_FUNC (NC_HICOSMO_DE, NcHICosmoDE, nc_hicosmo_de, NcHICosmoDEF
  * FIXME
  *
  */
-NCM_MODEL_SET_IMPL_FUNC (NC_HICOSMO_DE, NcHICosmoDE, nc_hicosmo_de, NcHICosmoDEFunc1, dE2Omega_de_dz)
+void
+nc_hicosmo_de_set_dE2Omega_de_dz_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1 f)
+{
+  ncm_model_class_add_impl_opts (NCM_MODEL_CLASS (cosmo_de_class), NC_HICOSMO_DE_IMPL_dE2Omega_de_dz, -1);
+  cosmo_de_class->dE2Omega_de_dz     = f;
+  cosmo_de_class->dE2Omega_de_dz_vec = &_nc_hicosmo_de_dE2Omega_de_dz_vec;
+}
+
 /**
  * nc_hicosmo_de_set_d2E2Omega_de_dz2_impl: (skip)
  * @cosmo_de_class: FIXME
@@ -980,6 +1105,39 @@ NCM_MODEL_SET_IMPL_FUNC (NC_HICOSMO_DE, NcHICosmoDE, nc_hicosmo_de, NcHICosmoDEF
  *
  */
 NCM_MODEL_SET_IMPL_FUNC (NC_HICOSMO_DE, NcHICosmoDE, nc_hicosmo_de, NcHICosmoDEFunc1, w_de)
+
+/**
+ * nc_hicosmo_de_set_E2Omega_de_vec_impl: (skip)
+ * @cosmo_de_class: a #NcHICosmoDEClass
+ * @f: a #NcHICosmoDEFunc1Vec
+ *
+ * Sets the vector version of $E^2\Omega_{de}(z)$ used by
+ * nc_hicosmo_E2_vec(). It is optional and must be set after
+ * nc_hicosmo_de_set_E2Omega_de_impl(), which resets it to the generic loop
+ * over the scalar implementation.
+ *
+ */
+void
+nc_hicosmo_de_set_E2Omega_de_vec_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1Vec f)
+{
+  cosmo_de_class->E2Omega_de_vec = f;
+}
+
+/**
+ * nc_hicosmo_de_set_dE2Omega_de_dz_vec_impl: (skip)
+ * @cosmo_de_class: a #NcHICosmoDEClass
+ * @f: a #NcHICosmoDEFunc1Vec
+ *
+ * Sets the vector version of $dE^2\Omega_{de}(z)/dz$ used by
+ * nc_hicosmo_dE2_dz_vec(). It is optional and must be set after
+ * nc_hicosmo_de_set_dE2Omega_de_dz_impl().
+ *
+ */
+void
+nc_hicosmo_de_set_dE2Omega_de_dz_vec_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1Vec f)
+{
+  cosmo_de_class->dE2Omega_de_dz_vec = f;
+}
 /**
  * nc_hicosmo_E2Omega_de:
  * @cosmo_de: a #NcHICosmoDE
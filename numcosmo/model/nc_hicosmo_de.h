@@ -66,6 +66,7 @@ typedef enum _NcHICosmoDEImpl
 } NcHICosmoDEImpl;
 
 typedef gdouble (*NcHICosmoDEFunc1) (NcHICosmoDE *cosmo_de, gdouble z);
+typedef void (*NcHICosmoDEFunc1Vec) (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len);
 
 /**
  * NcHICosmoDEParams:
@@ -131,6 +132,8 @@ struct _NcHICosmoDEClass
   NcHICosmoDEFunc1 dE2Omega_de_dz;
   NcHICosmoDEFunc1 d2E2Omega_de_dz2;
   NcHICosmoDEFunc1 w_de;
+  NcHICosmoDEFunc1Vec E2Omega_de_vec;
+  NcHICosmoDEFunc1Vec dE2Omega_de_dz_vec;
 };
 
 struct _NcHICosmoDE
@@ -152,6 +155,9 @@ void nc_hicosmo_de_set_dE2Omega_de_dz_impl (NcHICosmoDEClass *cosmo_de_class, Nc
 void nc_hicosmo_de_set_d2E2Omega_de_dz2_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1 f);
 void nc_hicosmo_de_set_w_de_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1 f);
 
+void nc_hicosmo_de_set_E2Omega_de_vec_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1Vec f);
+void nc_hicosmo_de_set_dE2Omega_de_dz_vec_impl (NcHICosmoDEClass *cosmo_de_class, NcHICosmoDEFunc1Vec f);
+
 G_INLINE_FUNC gdouble nc_hicosmo_de_E2Omega_de (NcHICosmoDE *cosmo_de, gdouble z);
 G_INLINE_FUNC gdouble nc_hicosmo_de_dE2Omega_de_dz (NcHICosmoDE *cosmo_de, gdouble z);
 G_INLINE_FUNC gdouble nc_hicosmo_de_d2E2Omega_de_dz2 (NcHICosmoDE *cosmo_de, gdouble z);
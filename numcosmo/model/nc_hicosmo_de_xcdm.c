@@ -74,6 +74,28 @@ _nc_hicosmo_de_xcdm_d2E2Omega_de_dz2 (NcHICosmoDE *cosmo_de, gdouble z)
 
 static gdouble _nc_hicosmo_de_xcdm_w_de (NcHICosmoDE *cosmo_de, gdouble z) { return W; }
 
+static void
+_nc_hicosmo_de_xcdm_E2Omega_de_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len)
+{
+  const gdouble Omega_x = OMEGA_X;
+  const gdouble n3      = 3.0 * (1.0 + W);
+  guint i;
+
+  for (i = 0; i < len; i++)
+    f[i] = Omega_x * exp (n3 * log1p (z[i]));
+}
+
+static void
+_nc_hicosmo_de_xcdm_dE2Omega_de_dz_vec (NcHICosmoDE *cosmo_de, const gdouble *z, gdouble *f, const guint len)
+{
+  const gdouble Omega_x = OMEGA_X;
+  const gdouble n3      = 3.0 * (1.0 + W);
+  guint i;
+
+  for (i = 0; i < len; i++)
+    f[i] = n3 * Omega_x * exp ((n3 - 1.0) * log1p (z[i]));
+}
+
 /**
  * nc_hicosmo_de_xcdm_new:
  *
@@ -121,6 +143,9 @@ nc_hicosmo_de_xcdm_class_init (NcHICosmoDEXcdmClass *klass)
   nc_hicosmo_de_set_d2E2Omega_de_dz2_impl (parent_class, &_nc_hicosmo_de_xcdm_d2E2Omega_de_dz2);
   nc_hicosmo_de_set_w_de_impl (parent_class, &_nc_hicosmo_de_xcdm_w_de);
 
+  nc_hicosmo_de_set_E2Omega_de_vec_impl (parent_class, &_nc_hicosmo_de_xcdm_E2Omega_de_vec);
+  nc_hicosmo_de_set_dE2Omega_de_dz_vec_impl (parent_class, &_nc_hicosmo_de_xcdm_dE2Omega_de_dz_vec);
+
   ncm_model_class_set_name_nick (model_class, "XCDM - Constant EOS", "XCDM");
   ncm_model_class_add_params (model_class, 1, 0, PROP_SIZE);
   /* Set w_0 param info */
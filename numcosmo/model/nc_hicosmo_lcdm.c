@@ -87,6 +87,40 @@ _nc_hicosmo_lcdm_dE2_dz (NcHICosmo *cosmo, gdouble z)
   return poly;
 }
 
+static void
+_nc_hicosmo_lcdm_E2_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len)
+{
+  const gdouble Omega_r = OMEGA_R;
+  const gdouble Omega_m = OMEGA_M;
+  const gdouble Omega_x = OMEGA_X;
+  const gdouble omega_k = 1.0 - (Omega_m + Omega_r + Omega_x);
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x  = 1.0 + z[i];
+    const gdouble x2 = x * x;
+
+    f[i] = x2 * ((Omega_r * x + Omega_m) * x + omega_k) + Omega_x;
+  }
+}
+
+static void
+_nc_hicosmo_lcdm_dE2_dz_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len)
+{
+  const gdouble Omega_r = OMEGA_R;
+  const gdouble Omega_m = OMEGA_M;
+  const gdouble omega_k = 1.0 - (Omega_m + Omega_r + OMEGA_X);
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble x = 1.0 + z[i];
+
+    f[i] = x * ((4.0 * Omega_r * x + 3.0 * Omega_m) * x + 2.0 * omega_k);
+  }
+}
+
 static gdouble
 _nc_hicosmo_lcdm_d2E2_dz2 (NcHICosmo *cosmo, gdouble z)
 {
@@ -235,4 +269,7 @@ nc_hicosmo_lcdm_class_init (NcHICosmoLCDMClass *klass)
   nc_hicosmo_set_d2E2_dz2_impl  (parent_class, &_nc_hicosmo_lcdm_d2E2_dz2);
 
   nc_hicosmo_set_bgp_cs2_impl   (parent_class, &_nc_hicosmo_lcdm_bgp_cs2);
+
+  nc_hicosmo_set_E2_vec_impl     (parent_class, &_nc_hicosmo_lcdm_E2_vec);
+  nc_hicosmo_set_dE2_dz_vec_impl (parent_class, &_nc_hicosmo_lcdm_dE2_dz_vec);
 }
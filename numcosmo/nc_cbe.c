@@ -37,6 +37,15 @@
  * - [Lesgourgues (2011) CLASS IV][XLesgourgues2011b] and
  * - [CLASS website](http://class-code.net/).
  *
+ * The CLASS modules are computed in stages (background, thermodynamics,
+ * perturbations, primordial, nonlinear, transfer, spectra and lensing).
+ * The #NcHICosmo, #NcHIReion and #NcHIPrim models are tracked separately
+ * by nc_cbe_prepare_if_needed(), a change in one of them invalidates only
+ * the stages that depend on it. For instance, a change in the primordial
+ * parameters reruns the primordial, nonlinear, spectra and lensing stages
+ * keeping the background, thermodynamics, perturbations and transfer
+ * structures.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -77,6 +86,22 @@ enum
   PROP_VERBOSE
 };
 
+typedef enum _NcCBEStage
+{
+	NC_CBE_STAGE_BG = 0,
+	NC_CBE_STAGE_THERMO,
+	NC_CBE_STAGE_PERT,
+	NC_CBE_STAGE_PRIM,
+	NC_CBE_STAGE_NONLIN,
+	NC_CBE_STAGE_TRANSFER,
+	NC_CBE_STAGE_SPECTRA,
+	NC_CBE_STAGE_LENSING,
+	NC_CBE_STAGE_LEN,
+} NcCBEStage;
+
+#define NC_CBE_STAGE_MASK(s) (1 << (s))
+#define NC_CBE_STAGE_MASK_THERMODYN (NC_CBE_STAGE_MASK (NC_CBE_STAGE_BG) | NC_CBE_STAGE_MASK (NC_CBE_STAGE_THERMO))
+
 struct _NcCBEPrivate
 {
 	struct background pba;
@@ -98,6 +123,7 @@ nc_cbe_init (NcCBE *cbe)
 	cbe->priv               = G_TYPE_INSTANCE_GET_PRIVATE (cbe, NC_TYPE_CBE, NcCBEPrivate);
 	cbe->prec               = NULL;
 	cbe->ctrl_cosmo         = ncm_model_ctrl_new (NULL);
+	cbe->ctrl_reion         = ncm_model_ctrl_new (NULL);
 	cbe->ctrl_prim          = ncm_model_ctrl_new (NULL);
 	cbe->a                  = NULL;
 
@@ -109,10 +135,8 @@ nc_cbe_init (NcCBE *cbe)
 	cbe->vector_lmax        = 0;
 	cbe->tensor_lmax        = 0;
 
-	cbe->call               = NULL;
-	cbe->free               = NULL;
-	cbe->allocated          = FALSE;
-	cbe->thermodyn_prepared = FALSE;
+	cbe->target_stages      = NC_CBE_STAGE_MASK_THERMODYN;
+	cbe->ready_stages       = 0;
 
 	/* background structure */
   
@@ -512,31 +536,21 @@ _nc_cbe_dispose (GObject* object)
 	nc_cbe_precision_clear (&cbe->prec);
 	nc_scalefactor_clear (&cbe->a);
 	ncm_model_ctrl_clear (&cbe->ctrl_cosmo);
+	ncm_model_ctrl_clear (&cbe->ctrl_reion);
 	ncm_model_ctrl_clear (&cbe->ctrl_prim);
 
 	/* Chain up : end */
 	G_OBJECT_CLASS (nc_cbe_parent_class)->dispose (object);
 }
 
-static void _nc_cbe_free_thermo (NcCBE* cbe);
+static void _nc_cbe_free_stages (NcCBE* cbe, guint stages);
 
 static void
 _nc_cbe_finalize (GObject* object)
 {
 	NcCBE* cbe = NC_CBE (object);
 
-	if (cbe->allocated)
-	{
-		g_assert (cbe->free != NULL);
-		cbe->free (cbe);
-		cbe->allocated = FALSE;
-	}
-
-	if (cbe->thermodyn_prepared)
-	{
-		_nc_cbe_free_thermo (cbe);
-		cbe->thermodyn_prepared = FALSE;
-	}
+	_nc_cbe_free_stages (cbe, cbe->ready_stages);
 
 	/* Chain up : end */
 	G_OBJECT_CLASS (nc_cbe_parent_class)->finalize (object);
@@ -774,8 +788,11 @@ void nc_cbe_set_calc_transfer (NcCBE* cbe, gboolean calc_transfer)
  */
 void nc_cbe_set_lensed_Cls (NcCBE* cbe, gboolean use_lensed_Cls)
 {
-	cbe->use_lensed_Cls = use_lensed_Cls;
-	_nc_cbe_update_callbacks (cbe);
+	if ((use_lensed_Cls && !cbe->use_lensed_Cls) || (!use_lensed_Cls && cbe->use_lensed_Cls))
+	{
+		cbe->use_lensed_Cls = use_lensed_Cls;
+		_nc_cbe_update_callbacks (cbe);
+	}
 }
 
 /**
@@ -788,8 +805,11 @@ void nc_cbe_set_lensed_Cls (NcCBE* cbe, gboolean use_lensed_Cls)
  */
 void nc_cbe_set_tensor (NcCBE* cbe, gboolean use_tensor)
 {
-	cbe->use_tensor = use_tensor;
-	ncm_model_ctrl_force_update (cbe->ctrl_cosmo);
+	if ((use_tensor && !cbe->use_tensor) || (!use_tensor && cbe->use_tensor))
+	{
+		cbe->use_tensor = use_tensor;
+		ncm_model_ctrl_force_update (cbe->ctrl_cosmo);
+	}
 }
 
 /**
@@ -802,8 +822,11 @@ void nc_cbe_set_tensor (NcCBE* cbe, gboolean use_tensor)
  */
 void nc_cbe_set_thermodyn (NcCBE* cbe, gboolean use_thermodyn)
 {
-	cbe->use_thermodyn = use_thermodyn;
-	ncm_model_ctrl_force_update (cbe->ctrl_cosmo);
+	if ((use_thermodyn && !cbe->use_thermodyn) || (!use_thermodyn && cbe->use_thermodyn))
+	{
+		cbe->use_thermodyn = use_thermodyn;
+		ncm_model_ctrl_force_update (cbe->ctrl_cosmo);
+	}
 }
 
 /**
@@ -1527,15 +1550,6 @@ _nc_cbe_set_nonlin (NcCBE* cbe, NcHICosmo* cosmo)
 	cbe->priv->pnl.nonlinear_verbose = cbe->nonlin_verbose;
 }
 
-static void _nc_cbe_free_bg (NcCBE* cbe);
-static void _nc_cbe_free_thermo (NcCBE* cbe);
-static void _nc_cbe_free_pert (NcCBE* cbe);
-static void _nc_cbe_free_prim (NcCBE* cbe);
-static void _nc_cbe_free_nonlin (NcCBE* cbe);
-static void _nc_cbe_free_transfer (NcCBE* cbe);
-static void _nc_cbe_free_spectra (NcCBE* cbe);
-static void _nc_cbe_free_lensing (NcCBE* cbe);
-
 static void
 _nc_cbe_call_bg (NcCBE* cbe, NcHICosmo* cosmo)
 {
@@ -1551,8 +1565,6 @@ _nc_cbe_call_thermo (NcCBE* cbe, NcHICosmo* cosmo)
 {
 	struct precision* ppr = (struct precision*)cbe->prec->priv;
 
-	_nc_cbe_call_bg (cbe, cosmo);
-
 	_nc_cbe_set_thermo (cbe, cosmo);
 	if (thermodynamics_init (ppr, &cbe->priv->pba, &cbe->priv->pth) == _FAILURE_)
 		g_error ("_nc_cbe_call_thermo: Error running thermodynamics_init `%s'\n", cbe->priv->pth.error_message);
@@ -1563,9 +1575,6 @@ _nc_cbe_call_pert (NcCBE* cbe, NcHICosmo* cosmo)
 {
 	struct precision* ppr = (struct precision*)cbe->prec->priv;
 
-	/*_nc_cbe_call_thermo (cbe, cosmo);*/
-	cbe->free = &_nc_cbe_free_pert;
-
 	_nc_cbe_set_pert (cbe, cosmo);
 	if (perturb_init (ppr, &cbe->priv->pba, &cbe->priv->pth, &cbe->priv->ppt) == _FAILURE_)
 		g_error ("_nc_cbe_call_pert: Error running perturb_init `%s'\n", cbe->priv->ppt.error_message);
@@ -1576,9 +1585,6 @@ _nc_cbe_call_prim (NcCBE* cbe, NcHICosmo* cosmo)
 {
 	struct precision* ppr = (struct precision*)cbe->prec->priv;
 
-	_nc_cbe_call_pert (cbe, cosmo);
-	cbe->free = &_nc_cbe_free_prim;
-
 	_nc_cbe_set_prim (cbe, cosmo);
 	if (primordial_init (ppr, &cbe->priv->ppt, &cbe->priv->ppm) == _FAILURE_)
 		g_error ("_nc_cbe_call_prim: Error running primordial_init `%s'\n", cbe->priv->ppm.error_message);
@@ -1589,9 +1595,6 @@ _nc_cbe_call_nonlin (NcCBE* cbe, NcHICosmo* cosmo)
 {
 	struct precision* ppr = (struct precision*)cbe->prec->priv;
 
-	_nc_cbe_call_prim (cbe, cosmo);
-	cbe->free = &_nc_cbe_free_nonlin;
-
 	_nc_cbe_set_nonlin (cbe, cosmo);
 	if (nonlinear_init (ppr, &cbe->priv->pba, &cbe->priv->pth, &cbe->priv->ppt, &cbe->priv->ppm, &cbe->priv->pnl) == _FAILURE_)
 		g_error ("_nc_cbe_call_nonlin: Error running nonlinear_init `%s'\n", cbe->priv->pnl.error_message);
@@ -1602,9 +1605,6 @@ _nc_cbe_call_transfer (NcCBE* cbe, NcHICosmo* cosmo)
 {
 	struct precision* ppr = (struct precision*)cbe->prec->priv;
 
-	_nc_cbe_call_nonlin (cbe, cosmo);
-	cbe->free = &_nc_cbe_free_transfer;
-
 	_nc_cbe_set_transfer (cbe, cosmo);
 	if (transfer_init (ppr, &cbe->priv->pba, &cbe->priv->pth, &cbe->priv->ppt, &cbe->priv->pnl, &cbe->priv->ptr) == _FAILURE_)
 		g_error ("_nc_cbe_call_transfer: Error running transfer_init `%s'\n", cbe->priv->ptr.error_message);
@@ -1615,9 +1615,6 @@ _nc_cbe_call_spectra (NcCBE* cbe, NcHICosmo* cosmo)
 {
 	struct precision* ppr = (struct precision*)cbe->prec->priv;
 
-	_nc_cbe_call_transfer (cbe, cosmo);
-	cbe->free = &_nc_cbe_free_spectra;
-
 	_nc_cbe_set_spectra (cbe, cosmo);
 	if (spectra_init (ppr, &cbe->priv->pba, &cbe->priv->ppt, &cbe->priv->ppm, &cbe->priv->pnl, &cbe->priv->ptr, &cbe->priv->psp) == _FAILURE_)
 		g_error ("_nc_cbe_call_spectra: Error running spectra_init `%s'\n", cbe->priv->psp.error_message);
@@ -1628,9 +1625,6 @@ _nc_cbe_call_lensing (NcCBE* cbe, NcHICosmo* cosmo)
 {
 	struct precision* ppr = (struct precision*)cbe->prec->priv;
 
-	_nc_cbe_call_spectra (cbe, cosmo);
-	cbe->free = &_nc_cbe_free_lensing;
-
 	_nc_cbe_set_lensing (cbe, cosmo);
 	if (lensing_init (ppr, &cbe->priv->ppt, &cbe->priv->psp, &cbe->priv->pnl, &cbe->priv->ple) == _FAILURE_)
 		g_error ("_nc_cbe_call_lensing: Error running lensing_init `%s'\n", cbe->priv->ple.error_message);
@@ -1648,8 +1642,6 @@ _nc_cbe_free_thermo (NcCBE* cbe)
 {
 	if (thermodynamics_free (&cbe->priv->pth) == _FAILURE_)
 		g_error ("_nc_cbe_free_thermo: Error running thermodynamics_free `%s'\n", cbe->priv->pth.error_message);
-
-	_nc_cbe_free_bg (cbe);
 }
 
 static void
@@ -1657,8 +1649,6 @@ _nc_cbe_free_pert (NcCBE* cbe)
 {
 	if (perturb_free (&cbe->priv->ppt) == _FAILURE_)
 		g_error ("_nc_cbe_free_pert: Error running perturb_free `%s'\n", cbe->priv->ppt.error_message);
-
-	/*_nc_cbe_free_thermo (cbe);*/
 }
 
 static void
@@ -1666,8 +1656,6 @@ _nc_cbe_free_prim (NcCBE* cbe)
 {
 	if (primordial_free (&cbe->priv->ppm) == _FAILURE_)
 		g_error ("_nc_cbe_free_prim: Error running primordial_free `%s'\n", cbe->priv->ppm.error_message);
-
-	_nc_cbe_free_pert (cbe);
 }
 
 static void
@@ -1675,8 +1663,6 @@ _nc_cbe_free_nonlin (NcCBE* cbe)
 {
 	if (nonlinear_free (&cbe->priv->pnl) == _FAILURE_)
 		g_error ("_nc_cbe_free_nonlin: Error running nonlinear_free `%s'\n", cbe->priv->pnl.error_message);
-
-	_nc_cbe_free_prim (cbe);
 }
 
 static void
@@ -1684,17 +1670,13 @@ _nc_cbe_free_transfer (NcCBE* cbe)
 {
 	if (transfer_free (&cbe->priv->ptr) == _FAILURE_)
 		g_error ("_nc_cbe_free_transfer: Error running transfer_free `%s'\n", cbe->priv->ptr.error_message);
-
-	_nc_cbe_free_nonlin (cbe);
 }
 
 static void
 _nc_cbe_free_spectra (NcCBE* cbe)
 {
 	if (spectra_free (&cbe->priv->psp) == _FAILURE_)
-		g_error ("_nc_cbe_free_lensing: Error running spectra_free `%s'\n", cbe->priv->psp.error_message);
-
-	_nc_cbe_free_transfer (cbe);
+		g_error ("_nc_cbe_free_spectra: Error running spectra_free `%s'\n", cbe->priv->psp.error_message);
 }
 
 static void
@@ -1702,30 +1684,144 @@ _nc_cbe_free_lensing (NcCBE* cbe)
 {
 	if (lensing_free (&cbe->priv->ple) == _FAILURE_)
 		g_error ("_nc_cbe_free_lensing: Error running lensing_free `%s'\n", cbe->priv->ple.error_message);
+}
+
+typedef void (*NcCBEStageCall) (NcCBE* cbe, NcHICosmo* cosmo);
+typedef void (*NcCBEStageFree) (NcCBE* cbe);
+
+#define _S(s) NC_CBE_STAGE_MASK (NC_CBE_STAGE_##s)
+
+/*
+ * The stages are listed in the order they must be computed, deps contains
+ * the stages whose structures are used by each *_init function. The transfer
+ * module reads the nonlinear structure only when pnl.method != nl_none, since
+ * _nc_cbe_set_nonlin always uses nl_none it does not depend on the primordial
+ * spectrum.
+ */
+static const struct
+{
+	NcCBEStageCall call;
+	NcCBEStageFree free;
+	guint deps;
+} _nc_cbe_stages[NC_CBE_STAGE_LEN] = {
+	{&_nc_cbe_call_bg,       &_nc_cbe_free_bg,       0},
+	{&_nc_cbe_call_thermo,   &_nc_cbe_free_thermo,   _S (BG)},
+	{&_nc_cbe_call_pert,     &_nc_cbe_free_pert,     _S (BG) | _S (THERMO)},
+	{&_nc_cbe_call_prim,     &_nc_cbe_free_prim,     _S (PERT)},
+	{&_nc_cbe_call_nonlin,   &_nc_cbe_free_nonlin,   _S (BG) | _S (THERMO) | _S (PERT) | _S (PRIM)},
+	{&_nc_cbe_call_transfer, &_nc_cbe_free_transfer, _S (BG) | _S (THERMO) | _S (PERT)},
+	{&_nc_cbe_call_spectra,  &_nc_cbe_free_spectra,  _S (BG) | _S (PERT) | _S (PRIM) | _S (NONLIN) | _S (TRANSFER)},
+	{&_nc_cbe_call_lensing,  &_nc_cbe_free_lensing,  _S (PERT) | _S (NONLIN) | _S (SPECTRA)},
+};
+
+#undef _S
+
+/* Adds to stages all stages that depend on them, directly or not. */
+static guint
+_nc_cbe_stages_dependents (guint stages)
+{
+	gint s;
+
+	for (s = 0; s < NC_CBE_STAGE_LEN; s++)
+	{
+		if (_nc_cbe_stages[s].deps & stages)
+			stages |= NC_CBE_STAGE_MASK (s);
+	}
 
-	_nc_cbe_free_spectra (cbe);
+	return stages;
+}
+
+/* Returns the stage last and all stages required to compute it. */
+static guint
+_nc_cbe_stages_required (NcCBEStage last)
+{
+	guint stages = NC_CBE_STAGE_MASK (last);
+	gint s;
+
+	for (s = last; s >= 0; s--)
+	{
+		if (stages & NC_CBE_STAGE_MASK (s))
+			stages |= _nc_cbe_stages[s].deps;
+	}
+
+	return stages;
 }
 
 static void
-_nc_cbe_update_callbacks (NcCBE* cbe)
+_nc_cbe_free_stages (NcCBE* cbe, guint stages)
 {
-	gboolean has_Cls = cbe->target_Cls & NC_DATA_CMB_TYPE_ALL;
+	gint s;
 
-	ncm_model_ctrl_force_update (cbe->ctrl_cosmo);
+	stages &= cbe->ready_stages;
+	for (s = NC_CBE_STAGE_LEN - 1; s >= 0; s--)
+	{
+		if (stages & NC_CBE_STAGE_MASK (s))
+		{
+			_nc_cbe_stages[s].free (cbe);
+			cbe->ready_stages &= ~NC_CBE_STAGE_MASK (s);
+		}
+	}
+}
+
+static void
+_nc_cbe_call_stages (NcCBE* cbe, NcHICosmo* cosmo, guint stages)
+{
+	gint s;
 
-	if (cbe->allocated)
+	stages &= ~cbe->ready_stages;
+	for (s = 0; s < NC_CBE_STAGE_LEN; s++)
 	{
-		g_assert (cbe->free != NULL);
-		cbe->free (cbe);
-		cbe->call = NULL;
-		cbe->free = NULL;
-		cbe->allocated = FALSE;
+		if (stages & NC_CBE_STAGE_MASK (s))
+		{
+			g_assert_cmpuint (_nc_cbe_stages[s].deps & cbe->ready_stages, ==, _nc_cbe_stages[s].deps);
+
+			_nc_cbe_stages[s].call (cbe, cosmo);
+			cbe->ready_stages |= NC_CBE_STAGE_MASK (s);
+		}
 	}
+}
+
+/*
+ * Updates the model controls and frees the stages invalidated by the models
+ * that changed: NcHICosmo invalidates everything, NcHIReion the
+ * thermodynamics and NcHIPrim the primordial stage, and in both cases
+ * the stages that depend on them.
+ */
+static void
+_nc_cbe_invalidate_stages (NcCBE* cbe, NcHICosmo* cosmo)
+{
+	NcHIReion* reion = nc_hicosmo_peek_reion (cosmo);
+	NcHIPrim* prim   = nc_hicosmo_peek_prim (cosmo);
+	guint stale      = 0;
+
+	ncm_model_ctrl_update (cbe->ctrl_cosmo, NCM_MODEL (cosmo));
+	if (ncm_model_ctrl_model_last_update (cbe->ctrl_cosmo))
+		stale |= NC_CBE_STAGE_MASK (NC_CBE_STAGE_BG);
+
+	if ((reion != NULL) && ncm_model_ctrl_update (cbe->ctrl_reion, NCM_MODEL (reion)))
+		stale |= NC_CBE_STAGE_MASK (NC_CBE_STAGE_THERMO);
+
+	if ((prim != NULL) && ncm_model_ctrl_update (cbe->ctrl_prim, NCM_MODEL (prim)))
+		stale |= NC_CBE_STAGE_MASK (NC_CBE_STAGE_PRIM);
+
+	if (stale != 0)
+		_nc_cbe_free_stages (cbe, _nc_cbe_stages_dependents (stale));
+}
+
+static void
+_nc_cbe_update_callbacks (NcCBE* cbe)
+{
+	gboolean has_Cls = cbe->target_Cls & NC_DATA_CMB_TYPE_ALL;
+
+	ncm_model_ctrl_force_update (cbe->ctrl_cosmo);
+	_nc_cbe_free_stages (cbe, cbe->ready_stages & ~NC_CBE_STAGE_MASK_THERMODYN);
 
 	if (has_Cls && cbe->use_lensed_Cls)
-		cbe->call = _nc_cbe_call_lensing;
+		cbe->target_stages = _nc_cbe_stages_required (NC_CBE_STAGE_LENSING);
 	else if (has_Cls || cbe->calc_transfer)
-		cbe->call = _nc_cbe_call_spectra;
+		cbe->target_stages = _nc_cbe_stages_required (NC_CBE_STAGE_SPECTRA);
+	else
+		cbe->target_stages = NC_CBE_STAGE_MASK_THERMODYN;
 }
 
 /**
@@ -1738,14 +1834,8 @@ _nc_cbe_update_callbacks (NcCBE* cbe)
  */
 void nc_cbe_thermodyn_prepare (NcCBE* cbe, NcHICosmo* cosmo)
 {
-	if (cbe->thermodyn_prepared)
-	{
-		_nc_cbe_free_thermo (cbe);
-		cbe->thermodyn_prepared = FALSE;
-	}
-
-	_nc_cbe_call_thermo (cbe, cosmo);
-	cbe->thermodyn_prepared = TRUE;
+	_nc_cbe_free_stages (cbe, cbe->ready_stages);
+	_nc_cbe_call_stages (cbe, cosmo, NC_CBE_STAGE_MASK_THERMODYN);
 }
 
 /**
@@ -1753,16 +1843,14 @@ void nc_cbe_thermodyn_prepare (NcCBE* cbe, NcHICosmo* cosmo)
  * @cbe: a #NcCBE
  * @cosmo: a #NcHICosmo
  *
- * Prepares the thermodynamic Class structure.
+ * Prepares the thermodynamic Class structure if @cosmo or its #NcHIReion
+ * submodel changed since the last preparation.
  *
  */
 void nc_cbe_thermodyn_prepare_if_needed (NcCBE* cbe, NcHICosmo* cosmo)
 {
-	if (ncm_model_ctrl_update (cbe->ctrl_cosmo, NCM_MODEL (cosmo)))
-	{
-		nc_cbe_thermodyn_prepare (cbe, cosmo);
-		ncm_model_ctrl_force_update (cbe->ctrl_prim);
-	}
+	_nc_cbe_invalidate_stages (cbe, cosmo);
+	_nc_cbe_call_stages (cbe, cosmo, NC_CBE_STAGE_MASK_THERMODYN);
 }
 
 /**
@@ -1775,33 +1863,14 @@ void nc_cbe_thermodyn_prepare_if_needed (NcCBE* cbe, NcHICosmo* cosmo)
  */
 void nc_cbe_prepare (NcCBE* cbe, NcHICosmo* cosmo)
 {
-	/*printf ("Preparing CLASS!\n");*/
 	if (ncm_model_peek_submodel_by_mid (NCM_MODEL (cosmo), nc_hiprim_id ()) == NULL)
 	{
 		g_error ("nc_cbe_prepare: cosmo model must contain a NcHIPrim submodel.");
 	}
 
-  if (cbe->allocated)
-	{
-		g_assert (cbe->free != NULL);
-		cbe->free (cbe);
-		cbe->allocated = FALSE;
-	}
-
-	if (cbe->thermodyn_prepared)
-	{
-		_nc_cbe_free_thermo (cbe);
-		cbe->thermodyn_prepared = FALSE;
-	}
-
-	_nc_cbe_call_thermo (cbe, cosmo);
-	cbe->thermodyn_prepared = TRUE;
-
-	if (cbe->call != NULL)
-	{
-		cbe->call (cbe, cosmo);
-		cbe->allocated = TRUE;
-	}
+	_nc_cbe_invalidate_stages (cbe, cosmo);
+	_nc_cbe_free_stages (cbe, cbe->ready_stages);
+	_nc_cbe_call_stages (cbe, cosmo, cbe->target_stages);
 }
 
 /**
@@ -1809,43 +1878,20 @@ void nc_cbe_prepare (NcCBE* cbe, NcHICosmo* cosmo)
  * @cbe: a #NcCBE
  * @cosmo: a #NcHICosmo
  *
- * Prepares all necessary Class structures.
+ * Prepares the necessary Class structures, recomputing only the stages
+ * invalidated by the models (@cosmo, its #NcHIReion and #NcHIPrim
+ * submodels) that changed since the last preparation.
  *
  */
 void nc_cbe_prepare_if_needed (NcCBE* cbe, NcHICosmo* cosmo)
 {
-	ncm_model_ctrl_update (cbe->ctrl_cosmo, NCM_MODEL (cosmo));
-
-	if (!ncm_model_ctrl_model_has_submodel (cbe->ctrl_cosmo, nc_hiprim_id ()))
+	if (ncm_model_peek_submodel_by_mid (NCM_MODEL (cosmo), nc_hiprim_id ()) == NULL)
 	{
 		g_error ("nc_cbe_prepare_if_needed: cosmo model must contain a NcHIPrim submodel.");
 	}
-	else
-	{
-		gboolean cosmo_up = ncm_model_ctrl_model_last_update (cbe->ctrl_cosmo);
-		gboolean prim_up = ncm_model_ctrl_submodel_last_update (cbe->ctrl_cosmo, nc_hiprim_id ());
-
-		/*printf ("cosmo_up %d prim_up %d [%p]\n", cosmo_up, prim_up, cosmo);*/
 
-		if (cosmo_up)
-		{
-			nc_cbe_prepare (cbe, cosmo);
-		}
-		else if (prim_up)
-		{
-			if (cbe->allocated)
-			{
-				g_assert (cbe->free != NULL);
-				cbe->free (cbe);
-				cbe->allocated = FALSE;
-			}
-			if (cbe->call != NULL)
-			{
-				cbe->call (cbe, cosmo);
-				cbe->allocated = TRUE;
-			}
-		}
-	}
+	_nc_cbe_invalidate_stages (cbe, cosmo);
+	_nc_cbe_call_stages (cbe, cosmo, cbe->target_stages);
 }
 
 /**
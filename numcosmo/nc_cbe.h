@@ -58,9 +58,6 @@ struct _NcCBEClass
   GObjectClass parent_class;
 };
 
-typedef void (*NcCBECall) (NcCBE *cbe, NcHICosmo *cosmo);
-typedef void (*NcCBEFree) (NcCBE *cbe);
-
 struct _NcCBE
 {
   /*< private >*/
@@ -85,11 +82,10 @@ struct _NcCBE
   guint vector_lmax;
   guint tensor_lmax;
   NcmModelCtrl *ctrl_cosmo;
+  NcmModelCtrl *ctrl_reion;
   NcmModelCtrl *ctrl_prim;
-  NcCBECall call;
-  NcCBEFree free;
-  gboolean allocated;
-  gboolean thermodyn_prepared;
+  guint target_stages;
+  guint ready_stages;
 };
 
 GType nc_cbe_get_type (void) G_GNUC_CONST;
@@ -93,6 +93,14 @@
  * $$\mu(z) = \delta\mu(z) + 5\log_{10}[\RH_0/(1\,\text{Mpc})],$$ 
  * where $\text{Mpc}$ is megaparsec [ncm_c_Mpc()].
  *
+ * The comoving distance is tabulated up to $z_f$ [#NcDistance:zf] and
+ * evaluated through the spline. When a redshift beyond the tabulated range is
+ * requested the table is extended on demand, to at least twice the previous
+ * range and up to $z = 10^4$, provided that $E^2(z)$ is positive in the new
+ * interval; otherwise the integral is computed directly. The extension is
+ * thread safe, the readers never block on it. The functions with the suffix
+ * _vec evaluate the same quantities for a whole #NcmVector of redshifts,
+ * extending the table at most once per call.
  *
  */
 
@@ -108,6 +116,10 @@
 #include "math/ncm_spline_cubic_notaknot.h"
 #include "math/ncm_mset_func_list.h"
 
+#define NC_DISTANCE_EXTEND_ZF_MAX (1.0e4)
+#define NC_DISTANCE_EXTEND_FACTOR (2.0)
+#define NC_DISTANCE_EXTEND_NCHECK (64)
+
 typedef struct _ComovingDistanceArgument{
   NcHICosmo *cosmo;
   gint diff;
@@ -143,6 +155,7 @@ nc_distance_dispose (GObject *object)
   ncm_function_cache_clear (&dist->sound_horizon_cache);
 
   ncm_ode_spline_clear (&dist->comoving_distance_spline);
+  g_clear_pointer (&dist->retired_splines, g_ptr_array_unref);
 
   ncm_model_ctrl_clear (&dist->ctrl);
 
@@ -153,6 +166,9 @@ nc_distance_dispose (GObject *object)
 static void
 nc_distance_finalize (GObject *object)
 {
+  NcDistance *dist = NC_DISTANCE (object);
+
+  g_mutex_clear (&dist->extend_lock);
 
   /* Chain up : end */
   G_OBJECT_CLASS (nc_distance_parent_class)->finalize (object);
@@ -283,7 +299,8 @@ nc_distance_require_zf (NcDistance *dist, const gdouble zf)
 {
   if (zf > dist->zf)
   {
-    ncm_ode_spline_clear (&dist->comoving_distance_spline);
+    if ((dist->comoving_distance_spline != NULL) && (dist->comoving_distance_spline->xf < zf))
+      ncm_ode_spline_clear (&dist->comoving_distance_spline);
     dist->zf = zf;
 
     ncm_model_ctrl_force_update (dist->ctrl);
@@ -292,6 +309,89 @@ nc_distance_require_zf (NcDistance *dist, const gdouble zf)
 
 static gdouble dcddz (gdouble y, gdouble x, gpointer userdata);
 
+static gboolean
+_nc_distance_comoving_integrand_is_regular (NcHICosmo *cosmo, const gdouble z0, const gdouble z1)
+{
+  NcmVector *z_v      = ncm_vector_new (NC_DISTANCE_EXTEND_NCHECK);
+  NcmVector *E2_v     = ncm_vector_new (NC_DISTANCE_EXTEND_NCHECK);
+  const gdouble lnx0  = log1p (z0);
+  const gdouble dlnx  = (log1p (z1) - lnx0) / NC_DISTANCE_EXTEND_NCHECK;
+  gboolean regular    = TRUE;
+  guint i;
+
+  for (i = 0; i < NC_DISTANCE_EXTEND_NCHECK; i++)
+    ncm_vector_set (z_v, i, expm1 (lnx0 + (i + 1.0) * dlnx));
+
+  nc_hicosmo_E2_vec (cosmo, z_v, E2_v);
+
+  for (i = 0; i < NC_DISTANCE_EXTEND_NCHECK; i++)
+  {
+    const gdouble E2 = ncm_vector_get (E2_v, i);
+    if (!gsl_finite (E2) || (E2 <= 0.0))
+    {
+      regular = FALSE;
+      break;
+    }
+  }
+
+  ncm_vector_free (z_v);
+  ncm_vector_free (E2_v);
+
+  return regular;
+}
+
+/*
+ * Returns the comoving distance spline covering @z, extending it if
+ * necessary, or NULL when the integral must be computed directly. The
+ * published spline is never modified, an extension builds a new one and
+ * keeps the old one alive until the next nc_distance_prepare(). A failed
+ * extension is remembered in ext_fail_z, any later extension reaching it
+ * would contain the same irregular interval and is refused without
+ * checking E^2 again.
+ */
+static NcmOdeSpline *
+_nc_distance_peek_comoving_spline (NcDistance *dist, NcHICosmo *cosmo, const gdouble z)
+{
+  NcmOdeSpline *os = g_atomic_pointer_get (&dist->comoving_distance_spline);
+
+  if (z <= os->xf)
+    return os;
+  else if (!(z <= NC_DISTANCE_EXTEND_ZF_MAX))
+    return NULL;
+
+  g_mutex_lock (&dist->extend_lock);
+
+  os = dist->comoving_distance_spline;
+  if (z > os->xf)
+  {
+    const gdouble zf = GSL_MIN (GSL_MAX (z, NC_DISTANCE_EXTEND_FACTOR * os->xf), NC_DISTANCE_EXTEND_ZF_MAX);
+
+    if (zf >= dist->ext_fail_z)
+      os = NULL;
+    else if (_nc_distance_comoving_integrand_is_regular (cosmo, os->xf, zf))
+    {
+      NcmSpline *s         = ncm_spline_cubic_notaknot_new ();
+      NcmOdeSpline *os_ext = ncm_ode_spline_new_full (s, dcddz, 0.0, 0.0, zf);
+
+      ncm_ode_spline_prepare (os_ext, cosmo);
+      ncm_spline_free (s);
+
+      g_ptr_array_add (dist->retired_splines, os);
+      g_atomic_pointer_set (&dist->comoving_distance_spline, os_ext);
+      os = os_ext;
+    }
+    else
+    {
+      dist->ext_fail_z = zf;
+      os               = NULL;
+    }
+  }
+
+  g_mutex_unlock (&dist->extend_lock);
+
+  return os;
+}
+
 /**
  * nc_distance_prepare:
  * @dist: a #NcDistance
@@ -303,12 +403,21 @@ static gdouble dcddz (gdouble y, gdouble x, gpointer userdata);
 void
 nc_distance_prepare (NcDistance *dist, NcHICosmo *cosmo)
 {
-  dist->comoving_distance_cache->clear = TRUE;
-  dist->time_cache->clear = TRUE;
-  dist->lookback_time_cache->clear = TRUE;
-  dist->conformal_time_cache->clear = TRUE;
+  ncm_function_cache_empty (dist->comoving_distance_cache);
+  ncm_function_cache_empty (dist->time_cache);
+  ncm_function_cache_empty (dist->lookback_time_cache);
+  ncm_function_cache_empty (dist->conformal_time_cache);
+
+  ncm_function_cache_empty (dist->sound_horizon_cache);
 
-  dist->sound_horizon_cache->clear = TRUE;
+  g_ptr_array_set_size (dist->retired_splines, 0);
+  dist->ext_fail_z = GSL_POSINF;
+
+  /* Keeps the extended range when it is still valid for the new model. */
+  if ((dist->comoving_distance_spline != NULL) &&
+      (dist->comoving_distance_spline->xf > dist->zf) &&
+      !_nc_distance_comoving_integrand_is_regular (cosmo, dist->zf, dist->comoving_distance_spline->xf))
+    ncm_ode_spline_clear (&dist->comoving_distance_spline);
 
   if (dist->comoving_distance_spline == NULL)
   {
@@ -348,6 +457,9 @@ nc_distance_init (NcDistance *dist)
   dist->sound_horizon_cache = ncm_function_cache_new (1, NCM_INTEGRAL_ABS_ERROR, NCM_INTEGRAL_ERROR);
 
   dist->comoving_distance_spline = NULL;
+  dist->retired_splines          = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_ode_spline_free);
+  dist->ext_fail_z               = GSL_POSINF;
+  g_mutex_init (&dist->extend_lock);
 
   dist->ctrl = ncm_model_ctrl_new (NULL);
 }
@@ -392,8 +504,11 @@ nc_distance_comoving (NcDistance *dist, NcHICosmo *cosmo, gdouble z)
   if (ncm_model_check_impl_opt (NCM_MODEL (cosmo), NC_HICOSMO_IMPL_Dc))
     return nc_hicosmo_Dc (cosmo, z);
 
-  if (z <= dist->zf)
-    return ncm_spline_eval (dist->comoving_distance_spline->s, z);
+  {
+    NcmOdeSpline *os = _nc_distance_peek_comoving_spline (dist, cosmo, z);
+    if (os != NULL)
+      return ncm_spline_eval (os->s, z);
+  }
 
   F.function = &comoving_distance_integral_argument;
   F.params = cosmo;
@@ -425,23 +540,9 @@ dcddz (gdouble cd, gdouble z, gpointer userdata)
   return 1.0 / sqrt (E2);
 }
 
-/**
- * nc_distance_transverse:
- * @dist: a #NcDistance
- * @cosmo: a #NcHICosmo
- * @z: redshift $z$
- *
- * Compute the transverse comoving distance $D_t (z)$ defined in Eq. $\eqref{eq:def:Dt}$.
- *
- * Returns: $D_t(z)$
- */
-gdouble
-nc_distance_transverse (NcDistance *dist, NcHICosmo *cosmo, gdouble z)
+static gdouble
+_nc_distance_comoving_to_transverse (const gint k, const gdouble sqrt_Omega_k0, const gdouble comoving_dist)
 {
-  const gdouble Omega_k0 = nc_hicosmo_Omega_k0 (cosmo);
-  const gdouble sqrt_Omega_k0 = sqrt (fabs (Omega_k0));
-  const gdouble comoving_dist = nc_distance_comoving (dist, cosmo, z);
-  const gint k = fabs (Omega_k0) < NCM_ZERO_LIMIT ? 0 : (Omega_k0 > 0.0 ? -1 : 1);
   gdouble Dt;
 
   if (gsl_isinf (comoving_dist))
@@ -467,6 +568,27 @@ nc_distance_transverse (NcDistance *dist, NcHICosmo *cosmo, gdouble z)
   return Dt;
 }
 
+/**
+ * nc_distance_transverse:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: redshift $z$
+ *
+ * Compute the transverse comoving distance $D_t (z)$ defined in Eq. $\eqref{eq:def:Dt}$.
+ *
+ * Returns: $D_t(z)$
+ */
+gdouble
+nc_distance_transverse (NcDistance *dist, NcHICosmo *cosmo, gdouble z)
+{
+  const gdouble Omega_k0 = nc_hicosmo_Omega_k0 (cosmo);
+  const gdouble sqrt_Omega_k0 = sqrt (fabs (Omega_k0));
+  const gdouble comoving_dist = nc_distance_comoving (dist, cosmo, z);
+  const gint k = fabs (Omega_k0) < NCM_ZERO_LIMIT ? 0 : (Omega_k0 > 0.0 ? -1 : 1);
+
+  return _nc_distance_comoving_to_transverse (k, sqrt_Omega_k0, comoving_dist);
+}
+
 /**
  * nc_distance_dtransverse_dz:
  * @dist: a #NcDistance
@@ -607,6 +729,185 @@ nc_distance_dmodulus_hef (NcDistance *dist, NcHICosmo *cosmo, gdouble z_he, gdou
   return (5.0 * log10 (Dl) + 25.0);
 }
 
+/**
+ * nc_distance_comoving_vec:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: redshifts $z_i$
+ * @Dc: (out caller-allocates): output vector $D_c(z_i)$
+ *
+ * Computes the comoving distance $D_c(z_i)$ [nc_distance_comoving()] for
+ * every element of @z. The spline range is extended once, to the largest
+ * element of @z, before the evaluation.
+ *
+ */
+void
+nc_distance_comoving_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dc)
+{
+  const guint len = ncm_vector_len (z);
+  guint i;
+
+  g_assert_cmpuint (ncm_vector_len (Dc), ==, len);
+
+  if (len == 0)
+    return;
+
+  nc_distance_prepare_if_needed (dist, cosmo);
+
+  if (ncm_model_check_impl_opt (NCM_MODEL (cosmo), NC_HICOSMO_IMPL_Dc))
+  {
+    for (i = 0; i < len; i++)
+      ncm_vector_set (Dc, i, nc_hicosmo_Dc (cosmo, ncm_vector_get (z, i)));
+  }
+  else
+  {
+    NcmOdeSpline *os = _nc_distance_peek_comoving_spline (dist, cosmo, ncm_vector_get_max (z));
+
+    if (os != NULL)
+    {
+      for (i = 0; i < len; i++)
+        ncm_vector_set (Dc, i, ncm_spline_eval (os->s, ncm_vector_get (z, i)));
+    }
+    else
+    {
+      for (i = 0; i < len; i++)
+        ncm_vector_set (Dc, i, nc_distance_comoving (dist, cosmo, ncm_vector_get (z, i)));
+    }
+  }
+}
+
+/**
+ * nc_distance_transverse_vec:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: redshifts $z_i$
+ * @Dt: (out caller-allocates): output vector $D_t(z_i)$
+ *
+ * Computes the transverse comoving distance $D_t(z_i)$ [nc_distance_transverse()]
+ * for every element of @z.
+ *
+ */
+void
+nc_distance_transverse_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dt)
+{
+  const gdouble Omega_k0      = nc_hicosmo_Omega_k0 (cosmo);
+  const gdouble sqrt_Omega_k0 = sqrt (fabs (Omega_k0));
+  const gint k                = fabs (Omega_k0) < NCM_ZERO_LIMIT ? 0 : (Omega_k0 > 0.0 ? -1 : 1);
+  const guint len             = ncm_vector_len (z);
+  guint i;
+
+  nc_distance_comoving_vec (dist, cosmo, z, Dt);
+
+  if (k == 0)
+    return;
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (Dt, i, _nc_distance_comoving_to_transverse (k, sqrt_Omega_k0, ncm_vector_get (Dt, i)));
+}
+
+/**
+ * nc_distance_luminosity_vec:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: redshifts $z_i$
+ * @Dl: (out caller-allocates): output vector $D_l(z_i)$
+ *
+ * Computes the luminosity distance $D_l(z_i)$ [nc_distance_luminosity()]
+ * for every element of @z. The vectors @z and @Dl must not share data.
+ *
+ */
+void
+nc_distance_luminosity_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dl)
+{
+  const guint len = ncm_vector_len (z);
+  guint i;
+
+  nc_distance_transverse_vec (dist, cosmo, z, Dl);
+
+  for (i = 0; i < len; i++)
+    ncm_vector_mulby (Dl, i, 1.0 + ncm_vector_get (z, i));
+}
+
+/**
+ * nc_distance_angular_diameter_vec:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: redshifts $z_i$
+ * @DA: (out caller-allocates): output vector $D_A(z_i)$
+ *
+ * Computes the angular diameter distance $D_A(z_i)$ [nc_distance_angular_diameter()]
+ * for every element of @z. The vectors @z and @DA must not share data.
+ *
+ */
+void
+nc_distance_angular_diameter_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *DA)
+{
+  const guint len = ncm_vector_len (z);
+  guint i;
+
+  nc_distance_transverse_vec (dist, cosmo, z, DA);
+
+  for (i = 0; i < len; i++)
+    ncm_vector_mulby (DA, i, 1.0 / (1.0 + ncm_vector_get (z, i)));
+}
+
+/**
+ * nc_distance_dmodulus_vec:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z: redshifts $z_i$
+ * @dmu: (out caller-allocates): output vector $\delta\mu(z_i)$
+ *
+ * Computes the distance modulus $\delta\mu(z_i)$ [nc_distance_dmodulus()]
+ * for every element of @z. The vectors @z and @dmu must not share data.
+ *
+ */
+void
+nc_distance_dmodulus_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *dmu)
+{
+  const guint len = ncm_vector_len (z);
+  guint i;
+
+  nc_distance_luminosity_vec (dist, cosmo, z, dmu);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble Dl = ncm_vector_get (dmu, i);
+    if (gsl_finite (Dl))
+      ncm_vector_set (dmu, i, 5.0 * log10 (Dl) + 25.0);
+  }
+}
+
+/**
+ * nc_distance_dmodulus_hef_vec:
+ * @dist: a #NcDistance
+ * @cosmo: a #NcHICosmo
+ * @z_he: redshifts $z_{he,i}$ in our local frame
+ * @z_cmb: redshifts $z_{CMB,i}$ in the CMB frame
+ * @dmu: (out caller-allocates): output vector $\delta\mu(z_{he,i},z_{CMB,i})$
+ *
+ * Computes the frame corrected distance modulus [nc_distance_dmodulus_hef()]
+ * for every pair of elements of @z_he and @z_cmb. The vector @dmu must not
+ * share data with @z_he.
+ *
+ */
+void
+nc_distance_dmodulus_hef_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z_he, NcmVector *z_cmb, NcmVector *dmu)
+{
+  const guint len = ncm_vector_len (z_cmb);
+  guint i;
+
+  g_assert_cmpuint (ncm_vector_len (z_he), ==, len);
+
+  nc_distance_transverse_vec (dist, cosmo, z_cmb, dmu);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble Dl = (1.0 + ncm_vector_get (z_he, i)) * ncm_vector_get (dmu, i);
+    ncm_vector_set (dmu, i, gsl_finite (Dl) ? (5.0 * log10 (Dl) + 25.0) : Dl);
+  }
+}
+
 /**
  * nc_distance_angular_diameter_curvature_scale:
  * @dist: a #NcDistance
@@ -64,6 +64,9 @@ struct _NcDistance
   NcmFunctionCache *conformal_time_cache;
   NcmFunctionCache *sound_horizon_cache;
   NcmModelCtrl *ctrl;
+  GMutex extend_lock;
+  GPtrArray *retired_splines;
+  gdouble ext_fail_z;
   gdouble zf;
   gboolean use_cache;
 };
@@ -133,6 +136,17 @@ gdouble nc_distance_bao_r_Dv (NcDistance *dist, NcHICosmo *cosmo, gdouble z);
 gdouble nc_distance_DH_r (NcDistance *dist, NcHICosmo *cosmo, gdouble z);
 gdouble nc_distance_DA_r (NcDistance *dist, NcHICosmo *cosmo, gdouble z);
 
+/***************************************************************************
+ * Vector evaluation of the redshift dependent 'distances'
+ ****************************************************************************/
+
+void nc_distance_comoving_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dc);
+void nc_distance_transverse_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dt);
+void nc_distance_luminosity_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *Dl);
+void nc_distance_angular_diameter_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *DA);
+void nc_distance_dmodulus_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z, NcmVector *dmu);
+void nc_distance_dmodulus_hef_vec (NcDistance *dist, NcHICosmo *cosmo, NcmVector *z_he, NcmVector *z_cmb, NcmVector *dmu);
+
 /***************************************************************************
  *            cosmic_time.h
  *
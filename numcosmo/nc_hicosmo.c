@@ -129,6 +129,10 @@ static gdouble _nc_hicosmo_E2Omega_m (NcHICosmo *cosmo, const gdouble z);
 static gdouble _nc_hicosmo_E2Omega_r (NcHICosmo *cosmo, const gdouble z);
 static gdouble _nc_hicosmo_E2Omega_t (NcHICosmo *cosmo, const gdouble z);
 
+static void _nc_hicosmo_E2_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len);
+static void _nc_hicosmo_dE2_dz_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len);
+static void _nc_hicosmo_E2Omega_m_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len);
+
 /* End methods */
 
 static void
@@ -185,6 +189,10 @@ nc_hicosmo_class_init (NcHICosmoClass *klass)
   klass->NMassNu      = &_nc_hicosmo_NMassNu;
   klass->MassNuInfo   = &_nc_hicosmo_MassNuInfo;
 
+  klass->E2_vec        = &_nc_hicosmo_E2_vec;
+  klass->dE2_dz_vec    = &_nc_hicosmo_dE2_dz_vec;
+  klass->E2Omega_m_vec = &_nc_hicosmo_E2Omega_m_vec;
+
   nc_hicosmo_set_Omega_m0_impl (klass, &_nc_hicosmo_Omega_m0);
   nc_hicosmo_set_Omega_r0_impl (klass, &_nc_hicosmo_Omega_r0);
 
@@ -240,6 +248,41 @@ _nc_hicosmo_Omega_r0 (NcHICosmo *cosmo)
   return (nc_hicosmo_Omega_g0 (cosmo) + nc_hicosmo_Omega_nu0 (cosmo));
 }
 
+/*
+ * Generic vector implementations, they simply loop over the scalar
+ * implementation. The class method is fetched once for the whole array.
+ */
+
+static void
+_nc_hicosmo_E2_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len)
+{
+  NcHICosmoFunc1Z E2 = NC_HICOSMO_GET_CLASS (cosmo)->E2;
+  guint i;
+
+  for (i = 0; i < len; i++)
+    f[i] = E2 (cosmo, z[i]);
+}
+
+static void
+_nc_hicosmo_dE2_dz_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len)
+{
+  NcHICosmoFunc1Z dE2_dz = NC_HICOSMO_GET_CLASS (cosmo)->dE2_dz;
+  guint i;
+
+  for (i = 0; i < len; i++)
+    f[i] = dE2_dz (cosmo, z[i]);
+}
+
+static void
+_nc_hicosmo_E2Omega_m_vec (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len)
+{
+  NcHICosmoFunc1Z E2Omega_m = NC_HICOSMO_GET_CLASS (cosmo)->E2Omega_m;
+  guint i;
+
+  for (i = 0; i < len; i++)
+    f[i] = E2Omega_m (cosmo, z[i]);
+}
+
 static gdouble
 _nc_hicosmo_E2Omega_b (NcHICosmo *cosmo, const gdouble z)
 {
@@ -592,7 +635,13 @@ NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoVFunc1Z,E2Press
  * Total matter density $E^2\Omega_{m} = \rho_m(z) / \rho_{\mathrm{crit}0}$.
  *
  */
-NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,E2Omega_m)
+void
+nc_hicosmo_set_E2Omega_m_impl (NcHICosmoClass *model_class, NcHICosmoFunc1Z f)
+{
+  ncm_model_class_add_impl_opts (NCM_MODEL_CLASS (model_class), NC_HICOSMO_IMPL_E2Omega_m, -1);
+  model_class->E2Omega_m     = f;
+  model_class->E2Omega_m_vec = &_nc_hicosmo_E2Omega_m_vec;
+}
 
 /**
  * nc_hicosmo_set_E2Omega_r_impl: (skip)
@@ -622,7 +671,13 @@ NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,E2Omega_
  * Normalized Hubble function squared, $E^2(z)$.
  *
  */
-NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,E2)
+void
+nc_hicosmo_set_E2_impl (NcHICosmoClass *model_class, NcHICosmoFunc1Z f)
+{
+  ncm_model_class_add_impl_opts (NCM_MODEL_CLASS (model_class), NC_HICOSMO_IMPL_E2, -1);
+  model_class->E2     = f;
+  model_class->E2_vec = &_nc_hicosmo_E2_vec;
+}
 
 /**
  * nc_hicosmo_set_dE2_dz_impl: (skip)
@@ -632,7 +687,13 @@ NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,E2)
  * First derivative with respect to the redshift of the normalized Hubble function squared, $\frac{dE^2(z)}{dz}$. 
  *
  */
-NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFunc1Z,dE2_dz)
+void
+nc_hicosmo_set_dE2_dz_impl (NcHICosmoClass *model_class, NcHICosmoFunc1Z f)
+{
+  ncm_model_class_add_impl_opts (NCM_MODEL_CLASS (model_class), NC_HICOSMO_IMPL_dE2_dz, -1);
+  model_class->dE2_dz     = f;
+  model_class->dE2_dz_vec = &_nc_hicosmo_dE2_dz_vec;
+}
 
 /**
  * nc_hicosmo_set_d2E2_dz2_impl: (skip)
@@ -684,6 +745,53 @@ NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFuncNMassNu,NMa
  */
 NCM_MODEL_SET_IMPL_FUNC(NC_HICOSMO,NcHICosmo,nc_hicosmo,NcHICosmoFuncMassNuInfo,MassNuInfo)
 
+/**
+ * nc_hicosmo_set_E2_vec_impl: (skip)
+ * @model_class: a #NcmModelClass
+ * @f: a #NcHICosmoFunc1ZVec
+ *
+ * Sets the vector version of $E^2(z)$, see nc_hicosmo_E2_vec(). It is
+ * optional and must be set after nc_hicosmo_set_E2_impl(), which resets it
+ * to the generic loop over the scalar implementation.
+ *
+ */
+void
+nc_hicosmo_set_E2_vec_impl (NcHICosmoClass *model_class, NcHICosmoFunc1ZVec f)
+{
+  model_class->E2_vec = f;
+}
+
+/**
+ * nc_hicosmo_set_dE2_dz_vec_impl: (skip)
+ * @model_class: a #NcmModelClass
+ * @f: a #NcHICosmoFunc1ZVec
+ *
+ * Sets the vector version of $dE^2(z)/dz$, see nc_hicosmo_dE2_dz_vec(). It
+ * is optional and must be set after nc_hicosmo_set_dE2_dz_impl().
+ *
+ */
+void
+nc_hicosmo_set_dE2_dz_vec_impl (NcHICosmoClass *model_class, NcHICosmoFunc1ZVec f)
+{
+  model_class->dE2_dz_vec = f;
+}
+
+/**
+ * nc_hicosmo_set_E2Omega_m_vec_impl: (skip)
+ * @model_class: a #NcmModelClass
+ * @f: a #NcHICosmoFunc1ZVec
+ *
+ * Sets the vector version of $E^2\Omega_m(z)$, see
+ * nc_hicosmo_E2Omega_m_vec(). It is optional and must be set after
+ * nc_hicosmo_set_E2Omega_m_impl().
+ *
+ */
+void
+nc_hicosmo_set_E2Omega_m_vec_impl (NcHICosmoClass *model_class, NcHICosmoFunc1ZVec f)
+{
+  model_class->E2Omega_m_vec = f;
+}
+
 /**
  * nc_hicosmo_new_from_name:
  * @parent_type: parent's #GType
@@ -792,6 +900,99 @@ _nc_hicosmo_zt_func (gdouble z, void *params)
   return nc_hicosmo_q (p->cosmo, z);
 }
 
+static void
+_nc_hicosmo_eval_vec (NcHICosmo *cosmo, NcHICosmoFunc1ZVec f_vec, NcHICosmoFunc1Z f, NcmVector *z, NcmVector *res)
+{
+  const guint len = ncm_vector_len (z);
+
+  g_assert_cmpuint (ncm_vector_len (res), ==, len);
+
+  if ((ncm_vector_stride (z) == 1) && (ncm_vector_stride (res) == 1))
+    f_vec (cosmo, ncm_vector_const_data (z), ncm_vector_data (res), len);
+  else
+  {
+    guint i;
+    for (i = 0; i < len; i++)
+      ncm_vector_set (res, i, f (cosmo, ncm_vector_get (z, i)));
+  }
+}
+
+/**
+ * nc_hicosmo_E2_vec:
+ * @cosmo: a #NcHICosmo
+ * @z: redshifts $z_i$
+ * @E2: output vector $E^2(z_i)$
+ *
+ * Computes the normalized Hubble function squared for all redshifts
+ * in @z, see nc_hicosmo_E2(). Models implementing the vector interface
+ * compute the redshift independent terms only once and evaluate the
+ * remaining terms in a single loop, the others fall back to a loop over
+ * nc_hicosmo_E2(). Both vectors must have the same length and must not
+ * share their data.
+ *
+ */
+void
+nc_hicosmo_E2_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *E2)
+{
+  NcHICosmoClass *klass = NC_HICOSMO_GET_CLASS (cosmo);
+  _nc_hicosmo_eval_vec (cosmo, klass->E2_vec, klass->E2, z, E2);
+}
+
+/**
+ * nc_hicosmo_dE2_dz_vec:
+ * @cosmo: a #NcHICosmo
+ * @z: redshifts $z_i$
+ * @dE2_dz: output vector $dE^2(z_i)/dz$
+ *
+ * Computes $dE^2/dz$ for all redshifts in @z, see nc_hicosmo_dE2_dz()
+ * and nc_hicosmo_E2_vec().
+ *
+ */
+void
+nc_hicosmo_dE2_dz_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *dE2_dz)
+{
+  NcHICosmoClass *klass = NC_HICOSMO_GET_CLASS (cosmo);
+  _nc_hicosmo_eval_vec (cosmo, klass->dE2_dz_vec, klass->dE2_dz, z, dE2_dz);
+}
+
+/**
+ * nc_hicosmo_E2Omega_m_vec:
+ * @cosmo: a #NcHICosmo
+ * @z: redshifts $z_i$
+ * @E2Omega_m: output vector $E^2\Omega_m(z_i)$
+ *
+ * Computes the total matter density $E^2\Omega_m$ for all redshifts in
+ * @z, see nc_hicosmo_E2Omega_m() and nc_hicosmo_E2_vec().
+ *
+ */
+void
+nc_hicosmo_E2Omega_m_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *E2Omega_m)
+{
+  NcHICosmoClass *klass = NC_HICOSMO_GET_CLASS (cosmo);
+  _nc_hicosmo_eval_vec (cosmo, klass->E2Omega_m_vec, klass->E2Omega_m, z, E2Omega_m);
+}
+
+/**
+ * nc_hicosmo_E_vec:
+ * @cosmo: a #NcHICosmo
+ * @z: redshifts $z_i$
+ * @E: output vector $E(z_i)$
+ *
+ * Computes the normalized Hubble function for all redshifts in @z, see
+ * nc_hicosmo_E() and nc_hicosmo_E2_vec().
+ *
+ */
+void
+nc_hicosmo_E_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *E)
+{
+  const guint len = ncm_vector_len (E);
+  guint i;
+
+  nc_hicosmo_E2_vec (cosmo, z, E);
+  for (i = 0; i < len; i++)
+    ncm_vector_set (E, i, sqrt (ncm_vector_get (E, i)));
+}
+
 /**
  * nc_hicosmo_zt:
  * @cosmo: a #NcHICosmo
@@ -162,6 +162,8 @@ typedef gdouble (*NcHICosmoVFunc0) (NcHICosmo *cosmo, const guint n);
 typedef gdouble (*NcHICosmoVFunc1Z) (NcHICosmo *cosmo, const guint n, const gdouble z);
 typedef gdouble (*NcHICosmoVFunc1K) (NcHICosmo *cosmo, const guint n, const gdouble k);
 
+typedef void (*NcHICosmoFunc1ZVec) (NcHICosmo *cosmo, const gdouble *z, gdouble *f, const guint len);
+
 typedef guint (*NcHICosmoFuncNMassNu) (NcHICosmo *cosmo);
 typedef void (*NcHICosmoFuncMassNuInfo) (NcHICosmo *cosmo, const guint nu_i, gdouble *mass_eV, gdouble *T_0, gdouble *xi, gdouble *g);
 
@@ -225,6 +227,9 @@ struct _NcHICosmoClass
   NcHICosmoVFunc1Z E2Press_mnu_n;
   NcHICosmoFuncNMassNu NMassNu;
   NcHICosmoFuncMassNuInfo MassNuInfo;
+  NcHICosmoFunc1ZVec E2_vec;
+  NcHICosmoFunc1ZVec dE2_dz_vec;
+  NcHICosmoFunc1ZVec E2Omega_m_vec;
 };
 
 /**
@@ -286,6 +291,10 @@ void nc_hicosmo_set_Dc_impl (NcHICosmoClass *model_class, NcHICosmoFunc1Z f);
 void nc_hicosmo_set_NMassNu_impl (NcHICosmoClass *model_class, NcHICosmoFuncNMassNu f);
 void nc_hicosmo_set_MassNuInfo_impl (NcHICosmoClass *model_class, NcHICosmoFuncMassNuInfo f);
 
+void nc_hicosmo_set_E2_vec_impl (NcHICosmoClass *model_class, NcHICosmoFunc1ZVec f);
+void nc_hicosmo_set_dE2_dz_vec_impl (NcHICosmoClass *model_class, NcHICosmoFunc1ZVec f);
+void nc_hicosmo_set_E2Omega_m_vec_impl (NcHICosmoClass *model_class, NcHICosmoFunc1ZVec f);
+
 NcHICosmo *nc_hicosmo_new_from_name (GType parent_type, gchar *cosmo_name);
 NcHICosmo *nc_hicosmo_ref (NcHICosmo *cosmo);
 void nc_hicosmo_free (NcHICosmo *cosmo);
@@ -294,6 +303,11 @@ void nc_hicosmo_clear (NcHICosmo **cosmo);
 void nc_hicosmo_log_all_models (GType parent);
 gdouble nc_hicosmo_zt (NcHICosmo *cosmo, const gdouble z_max);
 
+void nc_hicosmo_E2_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *E2);
+void nc_hicosmo_dE2_dz_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *dE2_dz);
+void nc_hicosmo_E2Omega_m_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *E2Omega_m);
+void nc_hicosmo_E_vec (NcHICosmo *cosmo, NcmVector *z, NcmVector *E);
+
 /*
  * Cosmological model constant functions
  */
@@ -140,6 +140,7 @@ static void _nc_powspec_ml_transfer_prepare (NcmPowspec *powspec, NcmModel *mode
 static gdouble _nc_powspec_ml_transfer_eval (NcmPowspec *powspec, NcmModel *model, const gdouble z, const gdouble k);
 static void _nc_powspec_ml_transfer_eval_vec (NcmPowspec* powspec, NcmModel* model, const gdouble z, NcmVector* k, NcmVector* Pk);
 static void _nc_powspec_ml_transfer_get_nknots (NcmPowspec *powspec, guint *Nz, guint *Nk);
+static gdouble _nc_powspec_ml_transfer_growth2 (NcmPowspec *powspec, NcmModel *model, const gdouble z);
 
 static void
 nc_powspec_ml_transfer_class_init (NcPowspecMLTransferClass *klass)
@@ -175,6 +176,7 @@ nc_powspec_ml_transfer_class_init (NcPowspecMLTransferClass *klass)
   powspec_class->eval       = &_nc_powspec_ml_transfer_eval;
   powspec_class->eval_vec   = &_nc_powspec_ml_transfer_eval_vec;
   powspec_class->get_nknots = &_nc_powspec_ml_transfer_get_nknots;
+  powspec_class->growth2    = &_nc_powspec_ml_transfer_growth2;
 }
 
 static void 
@@ -236,6 +238,14 @@ _nc_powspec_ml_transfer_eval_vec (NcmPowspec* powspec, NcmModel* model, const gd
   }
 }
 
+static gdouble 
+_nc_powspec_ml_transfer_growth2 (NcmPowspec *powspec, NcmModel *model, const gdouble z)
+{
+  NcPowspecMLTransfer *ps_mlt = NC_POWSPEC_ML_TRANSFER (powspec);
+
+  return gsl_pow_2 (nc_growth_func_eval (ps_mlt->gf, NC_HICOSMO (model), z));
+}
+
 static void 
 _nc_powspec_ml_transfer_get_nknots (NcmPowspec *powspec, guint *Nz, guint *Nk)
 {
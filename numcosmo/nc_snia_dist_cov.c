@@ -122,7 +122,7 @@ _nc_snia_dist_cov_set_property (GObject * object, guint prop_id, const GValue *
       break;
     }
     case PROP_EMPTY_FAC:
-      dcov->empty_fac = g_value_get_boolean (value);
+      nc_snia_dist_cov_set_empty_fac (dcov, g_value_get_boolean (value));
       break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -324,7 +324,12 @@ nc_snia_dist_cov_clear (NcSNIADistCov **dcov)
 void
 nc_snia_dist_cov_set_empty_fac (NcSNIADistCov *dcov, gboolean enable)
 {
-  dcov->empty_fac = enable;
+  if (dcov->empty_fac != enable)
+  {
+    dcov->empty_fac = enable;
+    /* The covariance depends on this option, objects caching it must be notified. */
+    ncm_model_params_update (NCM_MODEL (dcov));
+  }
 }
 
 /**
@@ -384,6 +389,41 @@ _nc_snia_dist_cov_calc_empty_fac (NcSNIADistCov *dcov, gdouble z_cmb)
     return zfac / z_cmb;
 }
 
+/*
+ * Upper triangle part of the i-th row of the covariance, the six
+ * components are contiguous arrays and cov_i is the row itself, i.e., the
+ * layout read by ncm_matrix_cholesky_decomp() with 'U'. The loop has no
+ * dependencies between iterations and is left to the compiler
+ * auto-vectorization (AVX2/AVX-512 with FMA when available).
+ */
+static void
+_nc_snia_dist_cov_calc_row (gdouble *cov_i,
+                            const gdouble *mag_mag, const gdouble *mag_width, const gdouble *mag_colour,
+                            const gdouble *width_width, const gdouble *width_colour, const gdouble *colour_colour,
+                            const gdouble alpha2, const gdouble beta2, const gdouble two_alpha, const gdouble m_two_beta, const gdouble m_two_alpha_beta,
+                            const guint n)
+{
+  guint k;
+
+  for (k = 0; k < n; k++)
+  {
+#ifdef HAVE_FMA
+    cov_i[k] = fma (m_two_alpha_beta, width_colour[k],
+                    fma (m_two_beta, mag_colour[k],
+                         fma (two_alpha, mag_width[k],
+                              fma (beta2, colour_colour[k],
+                                   fma (alpha2, width_width[k], mag_mag[k])))));
+#else
+    cov_i[k] = mag_mag[k]
+      + alpha2 * width_width[k]
+      + beta2 * colour_colour[k]
+      + two_alpha * mag_width[k]
+      + m_two_beta * mag_colour[k]
+      + m_two_alpha_beta * width_colour[k];
+#endif /* HAVE_FMA */
+  }
+}
+
 /**
  * nc_snia_dist_cov_calc:
  * @dcov: a #NcSNIADistCov
@@ -407,9 +447,18 @@ nc_snia_dist_cov_calc (NcSNIADistCov *dcov, NcDataSNIACov *snia_cov, NcmMatrix *
   const gdouble var_pecz       = exp (2.0 * LNSIGMA_PECZ);
   const gdouble var_lens       = exp (2.0 * LNSIGMA_LENS);
   const guint mu_len           = snia_cov->mu_len;
-  register guint i, j, ij;
+  const guint tri_len          = snia_cov->uppertri_len;
+  const gdouble *packed        = ncm_vector_const_ptr (snia_cov->cov_packed, 0);
+  const gdouble *mag_mag       = &packed[NC_DATA_SNIA_COV_ORDER_MAG_MAG       * tri_len];
+  const gdouble *mag_width     = &packed[NC_DATA_SNIA_COV_ORDER_MAG_WIDTH     * tri_len];
+  const gdouble *mag_colour    = &packed[NC_DATA_SNIA_COV_ORDER_MAG_COLOUR    * tri_len];
+  const gdouble *width_width   = &packed[NC_DATA_SNIA_COV_ORDER_WIDTH_WIDTH   * tri_len];
+  const gdouble *width_colour  = &packed[NC_DATA_SNIA_COV_ORDER_WIDTH_COLOUR  * tri_len];
+  const gdouble *colour_colour = &packed[NC_DATA_SNIA_COV_ORDER_COLOUR_COLOUR * tri_len];
+  guint i, ij;
 
   g_assert (NCM_DATA (snia_cov)->init);
+  g_assert_cmpuint (ncm_vector_stride (snia_cov->cov_packed), ==, 1);
 
   if (ncm_model_vparam_len (model, NC_SNIA_DIST_COV_LNSIGMA_INT) > snia_cov->dataset_len)
     g_warning ("nc_snia_dist_cov_calc: model dataset is larger then the used by the data: %u > %u.",
@@ -426,24 +475,13 @@ nc_snia_dist_cov_calc (NcSNIADistCov *dcov, NcDataSNIACov *snia_cov, NcmMatrix *
 
   for (i = 0; i < mu_len; i++)
   {
-    for (j = i; j < mu_len; j++)
-    {
-      const gdouble mag_mag       = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_MAG_MAG);
-      const gdouble mag_width     = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_MAG_WIDTH);
-      const gdouble mag_colour    = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_MAG_COLOUR);
-      const gdouble width_width   = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_WIDTH_WIDTH);
-      const gdouble width_colour  = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_WIDTH_COLOUR);
-      const gdouble colour_colour = ncm_vector_fast_get (snia_cov->cov_packed, NC_DATA_SNIA_COV_ORDER_LENGTH * ij + NC_DATA_SNIA_COV_ORDER_COLOUR_COLOUR);
-      ncm_matrix_set (cov, i, j,
-                      mag_mag
-                      + alpha2 * width_width
-                      + beta2 * colour_colour
-                      + two_alpha * mag_width
-                      - two_beta * mag_colour
-                      - two_alpha_beta * width_colour
-                      );
-      ij++;
-    }
+    const guint n = mu_len - i;
+
+    _nc_snia_dist_cov_calc_row (ncm_matrix_ptr (cov, i, i),
+                                &mag_mag[ij], &mag_width[ij], &mag_colour[ij],
+                                &width_width[ij], &width_colour[ij], &colour_colour[ij],
+                                alpha2, beta2, two_alpha, -two_beta, -two_alpha_beta, n);
+    ij += n;
 
     {
       const guint dset_id      = g_array_index (snia_cov->dataset, guint32, i);
@@ -510,14 +548,15 @@ nc_snia_dist_cov_mean (NcSNIADistCov *dcov, NcHICosmo *cosmo, NcDataSNIACov *sni
 
     g_assert (NCM_DATA (snia_cov)->init);
 
+    /* All distance moduli at once, y is then updated in place. */
+    nc_distance_dmodulus_hef_vec (dcov->dist, cosmo, snia_cov->z_he, snia_cov->z_cmb, y);
+
     for (i = 0; i < snia_cov->mu_len; i++)
     {
-      const gdouble z_cmb    = ncm_vector_get (snia_cov->z_cmb, i);
-      const gdouble z_he     = ncm_vector_get (snia_cov->z_he, i);
       const gdouble width    = ncm_vector_get (snia_cov->width, i);
       const gdouble colour   = ncm_vector_get (snia_cov->colour, i);
       const gdouble thirdpar = ncm_vector_get (snia_cov->thirdpar, i);
-      const gdouble dmu      = nc_distance_dmodulus_hef (dcov->dist, cosmo, z_he, z_cmb);
+      const gdouble dmu      = ncm_vector_get (y, i);
       const gdouble mag_th   = dmu - alpha * (width - 1.0) + beta * colour + ((thirdpar < 10.0) ? Mcal1 : Mcal2);
       const gdouble y_i      = mag_th;
 
@@ -594,14 +633,19 @@ nc_snia_dist_cov_mag_to_width_colour (NcSNIADistCov *dcov, NcHICosmo *cosmo, NcD
 
   ncm_matrix_set_zero (X);
 
+  /* Distance moduli in the first block of obs, each one is read before being overwritten. */
+  {
+    NcmVector *dmu_v = ncm_vector_get_subvector (obs, 0, mu_len);
+    nc_distance_dmodulus_hef_vec (dcov->dist, cosmo, snia_cov->z_he, snia_cov->z_cmb, dmu_v);
+    ncm_vector_free (dmu_v);
+  }
+
   if (colmajor)
   {
     for (i = 0; i < mu_len; i++)
     {
-      const gdouble z_cmb    = ncm_vector_get (snia_cov->z_cmb, i);
-      const gdouble z_he     = ncm_vector_get (snia_cov->z_he, i);
       const gdouble thirdpar = ncm_vector_get (snia_cov->thirdpar, i);
-      const gdouble dmu      = nc_distance_dmodulus_hef (dcov->dist, cosmo, z_he, z_cmb);
+      const gdouble dmu      = ncm_vector_get (obs, i);
       const gdouble M        = ((thirdpar < 10.0) ? Mcal1 : Mcal2);
       const gdouble m_obs_i  = ncm_vector_get (snia_cov->mag, i);
       const gdouble w_obs_i  = ncm_vector_get (snia_cov->width, i);
@@ -621,10 +665,8 @@ nc_snia_dist_cov_mag_to_width_colour (NcSNIADistCov *dcov, NcHICosmo *cosmo, NcD
   {
     for (i = 0; i < mu_len; i++)
     {
-      const gdouble z_cmb    = ncm_vector_get (snia_cov->z_cmb, i);
-      const gdouble z_he     = ncm_vector_get (snia_cov->z_he, i);
       const gdouble thirdpar = ncm_vector_get (snia_cov->thirdpar, i);
-      const gdouble dmu      = nc_distance_dmodulus_hef (dcov->dist, cosmo, z_he, z_cmb);
+      const gdouble dmu      = ncm_vector_get (obs, i);
       const gdouble M        = ((thirdpar < 10.0) ? Mcal1 : Mcal2);
       const gdouble m_obs_i  = ncm_vector_get (snia_cov->mag, i);
       const gdouble w_obs_i  = ncm_vector_get (snia_cov->width, i);
@@ -41,6 +41,7 @@
 #include <numcosmo/math/ncm_integral1d_ptr.h>
 #include <numcosmo/math/ncm_rng.h>
 #include <numcosmo/math/ncm_stats_vec.h>
+#include <numcosmo/math/ncm_stats_qsketch.h>
 #include <numcosmo/math/ncm_stats_dist1d.h>
 #include <numcosmo/math/ncm_stats_dist1d_spline.h>
 #include <numcosmo/math/ncm_stats_dist1d_epdf.h>
@@ -28,7 +28,24 @@
  * @title: Cross-correlations
  * @short_description: Cross-spectra using the Limber approximation
  *
- * FIXME
+ * The angular spectra are computed in the Limber approximation,
+ * $$C_\ell = \int_{z_l}^{z_u} dz\, E(z) \frac{K_1(z)K_2(z)}{\chi^2(z)} P\left(k = \frac{\ell + 1/2}{\chi(z)}, z\right),$$
+ * where $K_i(z)$ are the kernels [nc_xcor_limber_eval_kernel()] and $\chi(z)$
+ * is the comoving distance [nc_distance_comoving()].
+ *
+ * All multipoles share the same redshift quadrature grid, a composite
+ * Gauss-Legendre rule with approximately #NcXcor:npanels panels of
+ * #NC_XCOR_GL_ORDER nodes on $[z_l, z_u]$. The panels are uniform in
+ * $\ln(1+z)$ and their edges include the limits of the support of the kernels
+ * [nc_xcor_limber_get_z_lim()], such that no panel integrates across a kernel
+ * discontinuity. The comoving distance, $E(z)$ and the growth function are
+ * tabulated on this grid in nc_xcor_prepare(), the power spectrum is then
+ * computed for every pair $(\ell, z)$ and kept while the model and the
+ * multipoles do not change, such that it is shared between the auto and cross
+ * spectra of all tracers. Each spectrum reduces to tabulating the kernels on
+ * the grid and a matrix-vector product. The kernels are evaluated once per
+ * node, so they must not depend on $\ell$. The power spectrum rows can be
+ * computed in parallel over blocks of multipoles, see #NcXcor:threaded.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -36,13 +53,18 @@
 #endif /* HAVE_CONFIG_H */
 #include "build_cfg.h"
 
-#include "math/integral.h"
-#include "math/memory_pool.h"
 #include "math/ncm_serialize.h"
 #include "math/ncm_cfg.h"
+#include "math/ncm_func_eval.h"
 #include "lss/nc_window_tophat.h"
 #include "xcor/nc_xcor.h"
 
+#include <gsl/gsl_math.h>
+#include <gsl/gsl_integration.h>
+#include <gsl/gsl_blas.h>
+
+#define NC_XCOR_ELL_BLOCK (8)
+
 enum
 {
 	PROP_0,
@@ -51,6 +73,8 @@ enum
 	PROP_GROWTH_FUNC,
 	PROP_ZL,
 	PROP_ZU,
+	PROP_NPANELS,
+	PROP_THREADED,
 };
 
 G_DEFINE_TYPE (NcXcor, nc_xcor, G_TYPE_OBJECT);
@@ -110,45 +134,278 @@ void nc_xcor_clear (NcXcor** xcl)
 	g_clear_object (xcl);
 }
 
+/**
+ * nc_xcor_set_npanels:
+ * @xc: a #NcXcor
+ * @npanels: number of panels
+ *
+ * Sets the number of panels of the redshift quadrature grid. The panels are
+ * distributed among the intervals delimited by the kernel support limits
+ * proportionally to their length in $\ln(1+z)$, with at least one panel in
+ * each, so the grid has approximately @npanels $\times$ #NC_XCOR_GL_ORDER
+ * nodes.
+ *
+ */
+void nc_xcor_set_npanels (NcXcor* xc, guint npanels)
+{
+	g_assert_cmpuint (npanels, >, 0);
+	if (npanels != xc->npanels)
+	{
+		xc->npanels = npanels;
+		ncm_model_ctrl_force_update (xc->ctrlcosmo);
+	}
+}
+
+/**
+ * nc_xcor_set_threaded:
+ * @xc: a #NcXcor
+ * @threaded: whether to compute the power spectrum in parallel
+ *
+ * When @threaded is TRUE the power spectrum is computed in blocks of
+ * multipoles using ncm_func_eval_parallel_for().
+ *
+ */
+void nc_xcor_set_threaded (NcXcor* xc, gboolean threaded)
+{
+	xc->threaded = threaded;
+}
+
+static void _nc_xcor_add_z_lim (NcXcor* xc, NcXcorLimber* xcl)
+{
+	gdouble z_lim[2];
+	guint k;
+
+	if (!nc_xcor_limber_get_z_lim (xcl, &z_lim[0], &z_lim[1]))
+		return;
+
+	for (k = 0; k < 2; k++)
+	{
+		guint i;
+
+		for (i = 0; i < xc->z_lim->len; i++)
+		{
+			if (g_array_index (xc->z_lim, gdouble, i) >= z_lim[k])
+				break;
+		}
+
+		if ((i < xc->z_lim->len) && (g_array_index (xc->z_lim, gdouble, i) == z_lim[k]))
+			continue;
+
+		/* A new panel edge, the grid must be rebuilt. */
+		g_array_insert_val (xc->z_lim, i, z_lim[k]);
+		ncm_model_ctrl_force_update (xc->ctrlcosmo);
+	}
+}
+
+static void _nc_xcor_grid_prepare (NcXcor* xc, NcHICosmo* cosmo)
+{
+	const gdouble ul = log1p (xc->zl);
+	const gdouble uu = log1p (xc->zu);
+	GArray* u_edges = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	GArray* seg_np = g_array_new (FALSE, FALSE, sizeof (guint));
+	gsl_integration_glfixed_table* glt = gsl_integration_glfixed_table_alloc (NC_XCOR_GL_ORDER);
+	guint np = 0;
+	guint nz, s, p, i, n;
+
+	/* The panels are uniform in u = ln(1 + z), the kernel support limits inside (zl, zu) are also edges. */
+	g_array_append_val (u_edges, ul);
+	for (i = 0; i < xc->z_lim->len; i++)
+	{
+		const gdouble z_i = g_array_index (xc->z_lim, gdouble, i);
+
+		if ((z_i > xc->zl) && (z_i < xc->zu))
+		{
+			const gdouble u_i = log1p (z_i);
+			g_array_append_val (u_edges, u_i);
+		}
+	}
+	g_array_append_val (u_edges, uu);
+
+	for (s = 0; s + 1 < u_edges->len; s++)
+	{
+		const gdouble du_s = g_array_index (u_edges, gdouble, s + 1) - g_array_index (u_edges, gdouble, s);
+		const guint np_s = GSL_MAX (1, lround (xc->npanels * du_s / (uu - ul)));
+
+		g_array_append_val (seg_np, np_s);
+		np += np_s;
+	}
+
+	nz = np * NC_XCOR_GL_ORDER;
+
+	if ((xc->z_nodes == NULL) || (ncm_vector_len (xc->z_nodes) != nz))
+	{
+		ncm_vector_clear (&xc->z_nodes);
+		ncm_vector_clear (&xc->w_nodes);
+		ncm_vector_clear (&xc->xi_z);
+		ncm_vector_clear (&xc->E_z);
+		ncm_vector_clear (&xc->D2_z);
+		ncm_vector_clear (&xc->g_z);
+
+		xc->z_nodes = ncm_vector_new (nz);
+		xc->w_nodes = ncm_vector_new (nz);
+		xc->xi_z = ncm_vector_new (nz);
+		xc->E_z = ncm_vector_new (nz);
+		xc->D2_z = ncm_vector_new (nz);
+		xc->g_z = ncm_vector_new (nz);
+	}
+
+	n = 0;
+	for (s = 0; s < seg_np->len; s++)
+	{
+		const guint np_s = g_array_index (seg_np, guint, s);
+		const gdouble u_s = g_array_index (u_edges, gdouble, s);
+		const gdouble du = (g_array_index (u_edges, gdouble, s + 1) - u_s) / np_s;
+
+		for (p = 0; p < np_s; p++)
+		{
+			const gdouble ua = u_s + p * du;
+
+			for (i = 0; i < NC_XCOR_GL_ORDER; i++)
+			{
+				gdouble u_i, w_i, z_i;
+
+				gsl_integration_glfixed_point (ua, ua + du, i, &u_i, &w_i, glt);
+				z_i = expm1 (u_i);
+
+				/* dz = (1 + z) du */
+				ncm_vector_set (xc->z_nodes, n, z_i);
+				ncm_vector_set (xc->w_nodes, n, w_i * (1.0 + z_i));
+				n++;
+			}
+		}
+	}
+
+	g_array_unref (u_edges);
+	g_array_unref (seg_np);
+	gsl_integration_glfixed_table_free (glt);
+
+	/* dimensionless, ie it's in unit of hubble radius */
+	nc_distance_comoving_vec (xc->dist, cosmo, xc->z_nodes, xc->xi_z);
+	nc_hicosmo_E_vec (cosmo, xc->z_nodes, xc->E_z);
+
+	for (i = 0; i < nz; i++)
+	{
+		const gdouble D_z = nc_growth_func_eval (xc->gf, cosmo, ncm_vector_get (xc->z_nodes, i));
+		ncm_vector_set (xc->D2_z, i, D_z * D_z);
+	}
+
+	xc->T2_stale = TRUE;
+}
+
+/**
+ * nc_xcor_prepare:
+ * @xc: a #NcXcor
+ * @cosmo: a #NcHICosmo
+ *
+ * Prepares the transfer, growth and distance objects and tabulates the
+ * background quantities on the redshift quadrature grid.
+ *
+ */
 void nc_xcor_prepare (NcXcor *xc, NcHICosmo *cosmo)
 {
 	nc_transfer_func_prepare (xc->tf, cosmo);
 	nc_growth_func_prepare (xc->gf, cosmo);
 	nc_distance_prepare_if_needed (xc->dist, cosmo);
+
+	_nc_xcor_grid_prepare (xc, cosmo);
+
+	ncm_model_ctrl_update (xc->ctrlcosmo, NCM_MODEL (cosmo));
 }
 
-typedef struct _xcor_limber_cross_cl_int
+typedef struct _NcXcorPowerRows
 {
+	NcXcor* xc;
 	NcHICosmo* cosmo;
-	NcTransferFunc* tf;
-	NcDistance* dist;
-	NcGrowthFunc* gf;
+} NcXcorPowerRows;
 
-	NcXcorLimber* xcl1;
-	NcXcorLimber* xcl2;
-	gint l;
+static void _nc_xcor_power_rows (glong i, glong f, gpointer data)
+{
+	NcXcorPowerRows* rows = (NcXcorPowerRows*) data;
+	NcXcor* xc = rows->xc;
+	const guint nz = ncm_vector_len (xc->z_nodes);
+	const gdouble RH = ncm_c_hubble_radius_hm1_Mpc ();
+	glong l;
+	guint j;
+
+	for (l = i; l < f; l++)
+	{
+		/* the +0.5 is not to be forgotten, cf. LoVerde, M., & Afshordi, N. (2008). Extended Limber approximation. Physical Review D, 78(1), 123506. http://doi.org/10.1103/PhysRevD.78.123506 */
+		const gdouble ell_p_1_2 = ncm_vector_get (xc->ell_T2, l) + 0.5;
+		gdouble* row = ncm_matrix_ptr (xc->T2_ell_z, l, 0);
 
-} xcor_limber_cross_cl_int;
+		for (j = 0; j < nz; j++)
+		{
+			const gdouble kh = ell_p_1_2 / (ncm_vector_get (xc->xi_z, j) * RH); // in h Mpc-1
+			const gdouble t_k = nc_transfer_func_eval (xc->tf, rows->cosmo, kh);
 
-static gdouble _xcor_limber_cross_cl_int_z (gdouble z, gpointer ptr)
+			row[j] = t_k * t_k;
+		}
+	}
+}
+
+static void _nc_xcor_power_prepare (NcXcor* xc, NcHICosmo* cosmo, NcmVector* ell)
+{
+	const guint nell = ncm_vector_len (ell);
+	const guint nz = ncm_vector_len (xc->z_nodes);
+	NcXcorPowerRows rows = {xc, cosmo};
+	guint i;
+
+	if (!xc->T2_stale && (ncm_vector_len (xc->ell_T2) == nell))
+	{
+		for (i = 0; i < nell; i++)
+		{
+			if (ncm_vector_get (xc->ell_T2, i) != ncm_vector_get (ell, i))
+				break;
+		}
+		if (i == nell)
+			return;
+	}
+
+	if ((xc->T2_ell_z == NULL) || (ncm_matrix_nrows (xc->T2_ell_z) != nell) || (ncm_matrix_ncols (xc->T2_ell_z) != nz))
+	{
+		ncm_matrix_clear (&xc->T2_ell_z);
+		ncm_vector_clear (&xc->ell_T2);
+
+		xc->T2_ell_z = ncm_matrix_new (nell, nz);
+		xc->ell_T2 = ncm_vector_new (nell);
+	}
+
+	ncm_vector_memcpy (xc->ell_T2, ell);
+
+	if (xc->threaded)
+		ncm_func_eval_parallel_for (&_nc_xcor_power_rows, 0, nell, NC_XCOR_ELL_BLOCK, &rows);
+	else
+		_nc_xcor_power_rows (0, nell, &rows);
+
+	xc->T2_stale = FALSE;
+}
+
+static void _nc_xcor_limber_cl (NcXcor* xc, NcXcorLimber* xcl1, NcXcorLimber* xcl2, NcHICosmo* cosmo, NcmVector* ell, NcmVector* vp, guint lmin_idx, gdouble cons_factor)
 {
-	xcor_limber_cross_cl_int* xcli = (xcor_limber_cross_cl_int*)ptr;
+	const guint nell = ncm_vector_len (ell);
+	const guint nz = ncm_vector_len (xc->z_nodes);
+	NcmVector* vp_ell;
+	gint ret;
+	guint j;
 
-	gdouble k1z = nc_xcor_limber_eval_kernel (xcli->xcl1, xcli->cosmo, z, xcli->l);
-	gdouble k2z = nc_xcor_limber_eval_kernel (xcli->xcl2, xcli->cosmo, z, xcli->l);
+	_nc_xcor_power_prepare (xc, cosmo, ell);
 
-	gdouble xi_z = nc_distance_comoving (xcli->dist, xcli->cosmo, z); // dimensionless, ie it's in unit of hubble radius
-	gdouble kh = xcli->l / (xi_z * ncm_c_hubble_radius_hm1_Mpc ()); // in h Mpc-1, hubble
-	gdouble power_spec_init = 1.0;/*nc_hicosmo_powspec (xcli->cosmo, kh);*/ // k^ns
-	gdouble t_k = nc_transfer_func_eval (xcli->tf, xcli->cosmo, kh);
-	gdouble D_z = nc_growth_func_eval (xcli->gf, xcli->cosmo, z);
-	gdouble power_spec = power_spec_init * t_k * t_k * D_z * D_z;
+	for (j = 0; j < nz; j++)
+	{
+		const gdouble z = ncm_vector_get (xc->z_nodes, j);
+		const gdouble xi_z = ncm_vector_get (xc->xi_z, j);
+		const gdouble k1z = nc_xcor_limber_eval_kernel (xcl1, cosmo, z, 0);
+		const gdouble k2z = (xcl2 == xcl1) ? k1z : nc_xcor_limber_eval_kernel (xcl2, cosmo, z, 0);
 
-	gdouble E_z = nc_hicosmo_E (xcli->cosmo, z);
+		ncm_vector_set (xc->g_z, j, ncm_vector_get (xc->w_nodes, j) * ncm_vector_get (xc->E_z, j) * k1z * k2z * ncm_vector_get (xc->D2_z, j) / (xi_z * xi_z));
+	}
 
-g_assert_not_reached ();
-  
-	return E_z * k1z * k2z * power_spec / (xi_z * xi_z);
+	vp_ell = ncm_vector_get_subvector (vp, lmin_idx, nell);
+	ret = gsl_blas_dgemv (CblasNoTrans, cons_factor * xc->normPS, ncm_matrix_gsl (xc->T2_ell_z), ncm_vector_gsl (xc->g_z), 0.0, ncm_vector_gsl (vp_ell));
+	if (ret != 0)
+		g_error ("_nc_xcor_limber_cl: %i", ret);
+
+	ncm_vector_free (vp_ell);
 }
 
 /**
@@ -161,7 +418,8 @@ g_assert_not_reached ();
  * @vp: a #NcmVector
  * @lmin_idx: a #guint
  *
- * FIXME
+ * Computes the cross spectrum of @xcl1 and @xcl2 for all multipoles in @ell
+ * and stores it in @vp starting at @lmin_idx.
  *
  */
 void 
@@ -174,83 +432,20 @@ nc_xcor_limber_cross_cl (NcXcor* xc, NcXcorLimber* xcl1, NcXcorLimber* xcl2, NcH
 		g_error ("vector vp too short");
 	}
 
-	gboolean xcl1_up = ncm_model_ctrl_update (xc->ctrl1, NCM_MODEL (xcl1));
-	gboolean xcl2_up = ncm_model_ctrl_update (xc->ctrl2, NCM_MODEL (xcl2));
-	gboolean cosmo_up = ncm_model_ctrl_update (xc->ctrlcosmo, NCM_MODEL (cosmo));
-
-	if (xcl1_up || xcl2_up || cosmo_up)
-	{
-		nc_xcor_limber_prepare (xcl1, cosmo);
-		nc_xcor_limber_prepare (xcl2, cosmo);
-		nc_xcor_prepare (xc, cosmo);
-	}
-
-	gdouble cl, cons_factor, err;
-	xcor_limber_cross_cl_int xcli;
-	gsl_function F;
-	gsl_integration_workspace** w = ncm_integral_get_workspace ();
+	nc_xcor_limber_prepare (xcl1, cosmo);
+	nc_xcor_limber_prepare (xcl2, cosmo);
 
-	xcli.xcl1 = xcl1;
-	xcli.xcl2 = xcl2;
-	xcli.cosmo = cosmo;
-	xcli.dist = xc->dist;
-	// xcli.l     = l;
-	xcli.tf = xc->tf;
-	xcli.gf = xc->gf;
+	_nc_xcor_add_z_lim (xc, xcl1);
+	_nc_xcor_add_z_lim (xc, xcl2);
 
-
-	F.function = &_xcor_limber_cross_cl_int_z;
-	F.params = &xcli;
+	if (ncm_model_ctrl_update (xc->ctrlcosmo, NCM_MODEL (cosmo)))
+		nc_xcor_prepare (xc, cosmo);
 
 	// H0/c in h Mpc-1:
 	gdouble H0_c = 1e5 / ncm_c_c ();
-	cons_factor = xcl1->cons_factor * xcl2->cons_factor * pow (H0_c, 3.0); // power spectrum is in (h^-1 Mpc)^3 integrand.xi_lss = nc_distance_comoving_lss (dist, model);
+	gdouble cons_factor = xcl1->cons_factor * xcl2->cons_factor * pow (H0_c, 3.0); // power spectrum is in (h^-1 Mpc)^3
 
-	gdouble r = 0.0;
-	guint i;
-
-	for (i = 0; i < nell; i++)
-	{
-		xcli.l = ncm_vector_get (ell, i);
-		gsl_integration_qag (&F, xc->zl, xc->zu, 0.0, NCM_DEFAULT_PRECISION, NCM_INTEGRAL_PARTITION, 6, *w, &cl, &err);
-		r = cl * cons_factor * xc->normPS;
-		ncm_vector_set (vp, i + lmin_idx, r);
-	}
-
-	ncm_memory_pool_return (w);
-}
-
-typedef struct _xcor_limber_auto_cl_int
-{
-	NcHICosmo* cosmo;
-	NcTransferFunc* tf;
-	NcDistance* dist;
-	NcGrowthFunc* gf;
-
-	NcXcorLimber* xcl;
-	gint l;
-
-} xcor_limber_auto_cl_int;
-
-static gdouble _xcor_limber_auto_cl_int_z (gdouble z, gpointer ptr)
-{
-	xcor_limber_auto_cl_int* xcli = (xcor_limber_auto_cl_int*)ptr;
-
-	gdouble k1z = nc_xcor_limber_eval_kernel (xcli->xcl, xcli->cosmo, z, xcli->l);
-
-	gdouble xi_z = nc_distance_comoving (xcli->dist, xcli->cosmo, z); // dimensionless, ie it's in unit of hubble radius
-	gdouble kh = (xcli->l + 0.5) / (xi_z * ncm_c_hubble_radius_hm1_Mpc ()); // in h Mpc-1, hubble
-	// radius = c[m/s] / (the +0.5 is not to be forgotten, cf. LoVerde, M., & Afshordi, N. (2008). Extended Limber approximation. Physical Review D, 78(1), 123506. http://doi.org/10.1103/PhysRevD.78.123506)
-	gdouble power_spec_init = 1.0;/*nc_hicosmo_powspec (xcli->cosmo, kh);*/ // k^ns
-	gdouble t_k = nc_transfer_func_eval (xcli->tf, xcli->cosmo, kh);
-	gdouble D_z = nc_growth_func_eval (xcli->gf, xcli->cosmo, z);
-	gdouble power_spec = power_spec_init * t_k * t_k * D_z * D_z;
-
-	gdouble E_z = nc_hicosmo_E (xcli->cosmo, z);
-
-g_assert_not_reached ();
-  
-	return E_z * k1z * k1z * power_spec / (xi_z * xi_z);
+	_nc_xcor_limber_cl (xc, xcl1, xcl2, cosmo, ell, vp, lmin_idx, cons_factor);
 }
 
 /**
@@ -263,7 +458,9 @@ g_assert_not_reached ();
  * @lmin_idx: a #guint
  * @withnoise: a #gboolean
  *
- * FIXME
+ * Computes the auto spectrum of @xcl for all multipoles in @ell and stores it
+ * in @vp starting at @lmin_idx, adding the noise spectrum when @withnoise is
+ * TRUE.
  *
  */
 void 
@@ -276,64 +473,52 @@ nc_xcor_limber_auto_cl (NcXcor* xc, NcXcorLimber* xcl, NcHICosmo* cosmo, NcmVect
 		g_error ("vector vp too short");
 	}
 
-	gboolean xcl_up = ncm_model_ctrl_update (xc->ctrl1, NCM_MODEL (xcl));
-	gboolean cosmo_up = ncm_model_ctrl_update (xc->ctrlcosmo, NCM_MODEL (cosmo));
-
-	if (xcl_up || cosmo_up)
-	{
-		nc_xcor_limber_prepare (xcl, cosmo);
-		nc_xcor_prepare (xc, cosmo);
-	}
+	nc_xcor_limber_prepare (xcl, cosmo);
 
-	gdouble cl, cons_factor, err;
-	xcor_limber_auto_cl_int xcli;
-	gsl_function F;
-	gsl_integration_workspace** w = ncm_integral_get_workspace ();
+	_nc_xcor_add_z_lim (xc, xcl);
 
-	xcli.xcl = xcl;
-	xcli.cosmo = cosmo;
-	xcli.dist = xc->dist;
-	xcli.tf = xc->tf;
-	xcli.gf = xc->gf;
-
-
-	F.function = &_xcor_limber_auto_cl_int_z;
-	F.params = &xcli;
+	if (ncm_model_ctrl_update (xc->ctrlcosmo, NCM_MODEL (cosmo)))
+		nc_xcor_prepare (xc, cosmo);
 
 	// H0/c in h Mpc-1:
 	gdouble H0_c = 1e5 / ncm_c_c ();
-	cons_factor = pow (xcl->cons_factor, 2.0) * pow (H0_c, 3.0); // power spectrum is in (h^-1 Mpc)^3 integrand.xi_lss = nc_distance_comoving_lss (dist, model);
+	gdouble cons_factor = pow (xcl->cons_factor, 2.0) * pow (H0_c, 3.0); // power spectrum is in (h^-1 Mpc)^3
 
-	gdouble r = 0.0;
-	guint i, l;
+	_nc_xcor_limber_cl (xc, xcl, xcl, cosmo, ell, vp, lmin_idx, cons_factor);
 
-	for (i = 0; i < nell; i++)
+	if (withnoise)
 	{
-		l = ncm_vector_get (ell, i);
-		xcli.l = l;
-		gsl_integration_qag (&F, xc->zl, xc->zu, 0.0, NCM_DEFAULT_PRECISION, NCM_INTEGRAL_PARTITION, 6, *w, &cl, &err);
-		r = cl * cons_factor * xc->normPS;
-		if (withnoise)
+		guint i;
+
+		for (i = 0; i < nell; i++)
 		{
-			r += nc_xcor_limber_noise_spec (xcl, l);
+			const guint l = ncm_vector_get (ell, i);
+			ncm_vector_addto (vp, i + lmin_idx, nc_xcor_limber_noise_spec (xcl, l));
 		}
-		ncm_vector_set (vp, i + lmin_idx, r);
 	}
-
-	ncm_memory_pool_return (w);
 }
 
 static void nc_xcor_init (NcXcor* xc)
 {
 	xc->ctrlcosmo = ncm_model_ctrl_new (NULL);
-	xc->ctrl1 = ncm_model_ctrl_new (NULL);
-	xc->ctrl2 = ncm_model_ctrl_new (NULL);
 	xc->tf = NULL;
 	xc->gf = NULL;
 	xc->dist = NULL;
 	xc->zl = 0.0;
 	xc->zu = 0.0;
 	xc->normPS = 0.0;
+	xc->npanels = 0;
+	xc->threaded = FALSE;
+	xc->z_lim = g_array_new (FALSE, FALSE, sizeof (gdouble));
+	xc->z_nodes = NULL;
+	xc->w_nodes = NULL;
+	xc->xi_z = NULL;
+	xc->E_z = NULL;
+	xc->D2_z = NULL;
+	xc->g_z = NULL;
+	xc->ell_T2 = NULL;
+	xc->T2_ell_z = NULL;
+	xc->T2_stale = TRUE;
 }
 
 static void _nc_xcor_dispose (GObject* object)
@@ -341,8 +526,15 @@ static void _nc_xcor_dispose (GObject* object)
 	NcXcor* xc = NC_XCOR (object);
 
 	ncm_model_ctrl_clear (&xc->ctrlcosmo);
-	ncm_model_ctrl_clear (&xc->ctrl1);
-	ncm_model_ctrl_clear (&xc->ctrl2);
+
+	ncm_vector_clear (&xc->z_nodes);
+	ncm_vector_clear (&xc->w_nodes);
+	ncm_vector_clear (&xc->xi_z);
+	ncm_vector_clear (&xc->E_z);
+	ncm_vector_clear (&xc->D2_z);
+	ncm_vector_clear (&xc->g_z);
+	ncm_vector_clear (&xc->ell_T2);
+	ncm_matrix_clear (&xc->T2_ell_z);
 
 
 	/* Chain up : end */
@@ -352,6 +544,9 @@ static void _nc_xcor_dispose (GObject* object)
 
 static void _nc_xcor_finalize (GObject* object)
 {
+	NcXcor* xc = NC_XCOR (object);
+
+	g_clear_pointer (&xc->z_lim, g_array_unref);
 
 	/* Chain up : end */
 	G_OBJECT_CLASS (nc_xcor_parent_class)
@@ -377,9 +572,17 @@ _nc_xcor_set_property (GObject* object, guint prop_id, const GValue* value, GPar
 		break;
 	case PROP_ZL:
 		xc->zl = g_value_get_double (value);
+		ncm_model_ctrl_force_update (xc->ctrlcosmo);
 		break;
 	case PROP_ZU:
 		xc->zu = g_value_get_double (value);
+		ncm_model_ctrl_force_update (xc->ctrlcosmo);
+		break;
+	case PROP_NPANELS:
+		nc_xcor_set_npanels (xc, g_value_get_uint (value));
+		break;
+	case PROP_THREADED:
+		nc_xcor_set_threaded (xc, g_value_get_boolean (value));
 		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -410,6 +613,12 @@ _nc_xcor_get_property (GObject* object, guint prop_id, GValue* value, GParamSpec
 	case PROP_ZU:
 		g_value_set_double (value, xc->zu);
 		break;
+	case PROP_NPANELS:
+		g_value_set_uint (value, xc->npanels);
+		break;
+	case PROP_THREADED:
+		g_value_set_boolean (value, xc->threaded);
+		break;
 	default:
 		G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 		break;
@@ -490,4 +699,31 @@ nc_xcor_class_init (NcXcorClass* klass)
 	                                                      "Upper",
 	                                                      0.0, G_MAXDOUBLE, 0.0,
 	                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+	/**
+	* NcXcor:npanels:
+	*
+	* Approximate number of panels of the redshift quadrature grid, each one
+	* with #NC_XCOR_GL_ORDER Gauss-Legendre nodes, see nc_xcor_set_npanels().
+	*/
+	g_object_class_install_property (object_class,
+	                                 PROP_NPANELS,
+	                                 g_param_spec_uint ("npanels",
+	                                                    NULL,
+	                                                    "Number of redshift quadrature panels",
+	                                                    1, G_MAXUINT, 50,
+	                                                    G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
+
+	/**
+	* NcXcor:threaded:
+	*
+	* Whether to compute the power spectrum in parallel over blocks of multipoles.
+	*/
+	g_object_class_install_property (object_class,
+	                                 PROP_THREADED,
+	                                 g_param_spec_boolean ("threaded",
+	                                                       NULL,
+	                                                       "Compute the power spectrum in parallel",
+	                                                       FALSE,
+	                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT | G_PARAM_STATIC_NAME | G_PARAM_STATIC_BLURB));
 }
@@ -55,8 +55,6 @@ struct _NcXcor
 	GObject parent_instance;
 
 	NcmModelCtrl* ctrlcosmo;
-	NcmModelCtrl* ctrl1;
-	NcmModelCtrl* ctrl2;
 
 	NcDistance* dist;
 	NcTransferFunc* tf;
@@ -64,6 +62,19 @@ struct _NcXcor
 
 	gdouble normPS;
 	gdouble zl, zu;
+
+	guint npanels;
+	gboolean threaded;
+	GArray* z_lim;
+	NcmVector* z_nodes;
+	NcmVector* w_nodes;
+	NcmVector* xi_z;
+	NcmVector* E_z;
+	NcmVector* D2_z;
+	NcmVector* g_z;
+	NcmVector* ell_T2;
+	NcmMatrix* T2_ell_z;
+	gboolean T2_stale;
 };
 
 struct _NcXcorClass
@@ -73,6 +84,13 @@ struct _NcXcorClass
 	gpointer (*alloc) (void);
 };
 
+/**
+ * NC_XCOR_GL_ORDER:
+ *
+ * Number of Gauss-Legendre nodes in each panel of the redshift quadrature grid.
+ */
+#define NC_XCOR_GL_ORDER (8)
+
 GType nc_xcor_get_type (void) G_GNUC_CONST;
 
 
@@ -82,6 +100,9 @@ NcXcor* nc_xcor_ref (NcXcor* xcl);
 void nc_xcor_free (NcXcor* xcl);
 void nc_xcor_clear (NcXcor** xcl);
 
+void nc_xcor_set_npanels (NcXcor* xc, guint npanels);
+void nc_xcor_set_threaded (NcXcor* xc, gboolean threaded);
+
 void nc_xcor_limber_cross_cl (NcXcor* xc, NcXcorLimber* xcl1, NcXcorLimber* xcl2, NcHICosmo* cosmo, NcmVector* ell, NcmVector* vp, guint lmin_idx);
 void nc_xcor_limber_auto_cl (NcXcor* xc, NcXcorLimber* xcl, NcHICosmo* cosmo, NcmVector* ell, NcmVector* vp, guint lmin_idx, gboolean withnoise);
 
@@ -152,6 +152,28 @@ gdouble nc_xcor_limber_noise_spec (NcXcorLimber* xcl, guint l)
 	return NC_XCOR_LIMBER_GET_CLASS (xcl)->noise_spec (xcl, l);
 }
 
+/**
+ * nc_xcor_limber_get_z_lim:
+ * @xcl: a #NcXcorLimber
+ * @z_min: (out): the lower limit of the kernel support
+ * @z_max: (out): the upper limit of the kernel support
+ *
+ * Gets the redshift interval outside of which the kernel of @xcl vanishes.
+ *
+ * Returns: TRUE if the kernel of @xcl has a compact support, FALSE otherwise
+ * (@z_min and @z_max are then left untouched).
+ *
+*/
+gboolean nc_xcor_limber_get_z_lim (NcXcorLimber* xcl, gdouble* z_min, gdouble* z_max)
+{
+	NcXcorLimberClass* xcl_class = NC_XCOR_LIMBER_GET_CLASS (xcl);
+
+	if (xcl_class->get_z_lim == NULL)
+		return FALSE;
+	else
+		return xcl_class->get_z_lim (xcl, z_min, z_max);
+}
+
 
 /**
  * nc_xcor_limber_prepare:
@@ -77,6 +77,7 @@ struct _NcXcorLimberClass
 	gdouble (*eval_kernel)(NcXcorLimber* xcl, NcHICosmo* cosmo, gdouble z, gint l);
 	void (*prepare)(NcXcorLimber* xcl, NcHICosmo* cosmo);
 	gdouble (*noise_spec)(NcXcorLimber* xcl, guint l);
+	gboolean (*get_z_lim)(NcXcorLimber* xcl, gdouble* z_min, gdouble* z_max);
 
 	guint (*obs_len)(NcXcorLimber* xcl);
 	guint (*obs_params_len)(NcXcorLimber* xcl);
@@ -97,6 +98,7 @@ guint nc_xcor_limber_obs_params_len (NcXcorLimber* xcl);
 gdouble nc_xcor_limber_eval_kernel (NcXcorLimber* xcl, NcHICosmo* cosmo, gdouble z, gint l);
 void nc_xcor_limber_prepare (NcXcorLimber* xcl, NcHICosmo* cosmo);
 gdouble nc_xcor_limber_noise_spec (NcXcorLimber* xcl, guint l);
+gboolean nc_xcor_limber_get_z_lim (NcXcorLimber* xcl, gdouble* z_min, gdouble* z_max);
 
 void nc_xcor_limber_log_all_models (void);
 
@@ -72,6 +72,16 @@ static void _nc_xcor_limber_gal_prepare (NcXcorLimber* xcl, NcHICosmo* cosmo)
 	NCM_UNUSED (cosmo);
 }
 
+static gboolean _nc_xcor_limber_gal_get_z_lim (NcXcorLimber* xcl, gdouble* z_min, gdouble* z_max)
+{
+	NcXcorLimberGal* xclg = NC_XCOR_LIMBER_GAL (xcl);
+
+	*z_min = xclg->z_min;
+	*z_max = xclg->z_max;
+
+	return TRUE;
+}
+
 static gdouble _nc_xcor_limber_gal_noise_spec (NcXcorLimber* xcl, guint l)
 {
 	NcXcorLimberGal* xclg = NC_XCOR_LIMBER_GAL (xcl);
@@ -189,6 +199,7 @@ nc_xcor_limber_gal_class_init (NcXcorLimberGalClass* klass)
 	parent_class->eval_kernel    = &_nc_xcor_limber_gal_eval_kernel;
 	parent_class->prepare        = &_nc_xcor_limber_gal_prepare;
 	parent_class->noise_spec     = &_nc_xcor_limber_gal_noise_spec;
+	parent_class->get_z_lim      = &_nc_xcor_limber_gal_get_z_lim;
 
 	parent_class->obs_len        = &_nc_xcor_limber_gal_obs_len;
 	parent_class->obs_params_len = &_nc_xcor_limber_gal_obs_params_len;
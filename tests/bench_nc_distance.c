@@ -0,0 +1,154 @@
+/***************************************************************************
+ *            bench_nc_distance.c
+ *
+ *  Fri October 16 19:40:05 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Usage: bench_nc_distance [nrep] [nsn] [zf]
+ *
+ * Times the distance moduli of a supernova catalog (1048 objects by default,
+ * 0.01 < z < 2.3) as computed in nc_snia_dist_cov_mean():
+ *
+ * - scalar: one nc_distance_dmodulus_hef() call per object;
+ * - vec: a single nc_distance_dmodulus_hef_vec() call.
+ *
+ * Each mode is timed with a fixed model (eval) and changing the model at
+ * every repetition (prepare+eval), the latter also includes the spline
+ * preparation. The #NcDistance is created with the given zf (1.0 by default)
+ * so that the first evaluation extends the spline range. The largest relative
+ * difference with respect to the scalar mode is also reported.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <stdlib.h>
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef enum _BenchMode
+{
+  BENCH_MODE_SCALAR = 0,
+  BENCH_MODE_VEC,
+} BenchMode;
+
+static void
+_bench_eval (BenchMode mode, NcDistance *dist, NcHICosmo *cosmo, NcmVector *z_he, NcmVector *z_cmb, NcmVector *dmu)
+{
+  switch (mode)
+  {
+    case BENCH_MODE_SCALAR:
+    {
+      guint i;
+
+      for (i = 0; i < ncm_vector_len (z_cmb); i++)
+        ncm_vector_set (dmu, i, nc_distance_dmodulus_hef (dist, cosmo, ncm_vector_get (z_he, i), ncm_vector_get (z_cmb, i)));
+      break;
+    }
+    case BENCH_MODE_VEC:
+      nc_distance_dmodulus_hef_vec (dist, cosmo, z_he, z_cmb, dmu);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+  const guint nrep     = (argc > 1) ? atoi (argv[1]) : 1000;
+  const guint nsn      = (argc > 2) ? atoi (argv[2]) : 1048;
+  const gdouble zf     = (argc > 3) ? atof (argv[3]) : 1.0;
+  const gchar *names[] = {"scalar", "vec"};
+  NcHICosmo *cosmo;
+  NcmVector *z_he, *z_cmb, *dmu_ref;
+  NcmRNG *rng;
+  guint m, i;
+
+  ncm_cfg_init ();
+
+  rng     = ncm_rng_seeded_new (NULL, 123);
+  cosmo   = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  z_he    = ncm_vector_new (nsn);
+  z_cmb   = ncm_vector_new (nsn);
+  dmu_ref = ncm_vector_new (nsn);
+
+  for (i = 0; i < nsn; i++)
+  {
+    const gdouble z = expm1 (gsl_ran_flat (rng->r, log1p (0.01), log1p (2.3)));
+
+    ncm_vector_set (z_cmb, i, z);
+    ncm_vector_set (z_he, i, z + gsl_ran_gaussian (rng->r, 1.0e-3));
+  }
+
+  g_print ("# nrep %u nsn %u zf %.2f\n", nrep, nsn, zf);
+  g_print ("# %-10s %14s %14s %14s\n", "mode", "eval[s]", "prepare+eval[s]", "max-rel-diff");
+
+  for (m = 0; m < G_N_ELEMENTS (names); m++)
+  {
+    NcDistance *dist = nc_distance_new (zf);
+    NcmVector *dmu   = ncm_vector_new (nsn);
+    gdouble wall_eval, wall_prep, max_rel = 0.0;
+    gint64 t0;
+
+    ncm_model_param_set_by_name (NCM_MODEL (cosmo), "w", -1.0);
+
+    /* Warm up, prepares the distance and extends the spline range. */
+    _bench_eval (m, dist, cosmo, z_he, z_cmb, dmu);
+
+    t0 = g_get_monotonic_time ();
+    for (i = 0; i < nrep; i++)
+      _bench_eval (m, dist, cosmo, z_he, z_cmb, dmu);
+    wall_eval = (g_get_monotonic_time () - t0) * 1.0e-6 / nrep;
+
+    if (m == BENCH_MODE_SCALAR)
+      ncm_vector_memcpy (dmu_ref, dmu);
+
+    for (i = 0; i < nsn; i++)
+      max_rel = GSL_MAX (max_rel, fabs (ncm_vector_get (dmu, i) / ncm_vector_get (dmu_ref, i) - 1.0));
+
+    t0 = g_get_monotonic_time ();
+    for (i = 0; i < nrep; i++)
+    {
+      ncm_model_param_set_by_name (NCM_MODEL (cosmo), "w", -1.0 + 1.0e-3 * ((i % 2) ? 1.0 : -1.0));
+      _bench_eval (m, dist, cosmo, z_he, z_cmb, dmu);
+    }
+    wall_prep = (g_get_monotonic_time () - t0) * 1.0e-6 / nrep;
+
+    g_print ("  %-10s % 14.6e % 14.6e % 14.4e\n", names[m], wall_eval, wall_prep, max_rel);
+
+    ncm_vector_free (dmu);
+    nc_distance_free (dist);
+  }
+
+  ncm_vector_free (z_he);
+  ncm_vector_free (z_cmb);
+  ncm_vector_free (dmu_ref);
+  nc_hicosmo_free (cosmo);
+  ncm_rng_free (rng);
+
+  return 0;
+}
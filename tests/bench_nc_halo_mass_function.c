@@ -0,0 +1,142 @@
+/***************************************************************************
+ *            bench_nc_halo_mass_function.c
+ *
+ *  Fri October 16 09:41:12 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Usage: bench_nc_halo_mass_function [nrep] [nthreads]
+ *
+ * Times nc_halo_mass_function_prepare() (the d2N/dz/dlnM grid fill) for the
+ * Tinker and Sheth-Tormen multiplicity functions at several grid sizes,
+ * controlled through nc_halo_mass_function_set_prec(). The knots are built
+ * once before the timings; for each grid the largest relative difference
+ * between the grid and the point by point nc_halo_mass_function_dn_dlnM()
+ * is also reported.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <stdlib.h>
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+gint
+main (gint argc, gchar *argv[])
+{
+  const guint nrep     = (argc > 1) ? atoi (argv[1]) : 20;
+  const gint nthreads  = (argc > 2) ? atoi (argv[2]) : 4;
+  const gchar *mulfs[] = {
+    "NcMultiplicityFuncTinker",
+    "NcMultiplicityFuncST"
+  };
+  const gdouble precs[] = {1.0e-3, 1.0e-5, 1.0e-7};
+  NcHICosmo *cosmo;
+  NcHIReion *reion;
+  NcHIPrim *prim;
+  NcDistance *dist;
+  NcTransferFunc *tf;
+  NcPowspecML *ps_ml;
+  NcmPowspecFilter *psf;
+  guint m, p;
+
+  ncm_cfg_init ();
+  ncm_func_eval_set_max_threads (nthreads);
+
+  cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  reion = NC_HIREION (nc_hireion_camb_new ());
+  prim  = NC_HIPRIM (nc_hiprim_power_law_new ());
+  dist  = nc_distance_new (3.0);
+  tf    = nc_transfer_func_new_from_name ("NcTransferFuncEH");
+  ps_ml = NC_POWSPEC_ML (nc_powspec_ml_transfer_new (tf));
+  psf   = ncm_powspec_filter_new (NCM_POWSPEC (ps_ml), NCM_POWSPEC_FILTER_TYPE_TOPHAT);
+
+  ncm_model_add_submodel (NCM_MODEL (cosmo), NCM_MODEL (reion));
+  ncm_model_add_submodel (NCM_MODEL (cosmo), NCM_MODEL (prim));
+
+  g_print ("# nthreads %d nrep %u\n", nthreads, nrep);
+  g_print ("# %-26s %8s %6s %6s %12s %12s\n", "multiplicity", "prec", "nz", "nlnM", "prepare[s]", "max-rel-diff");
+
+  for (m = 0; m < G_N_ELEMENTS (mulfs); m++)
+  {
+    NcMultiplicityFunc *mulf = nc_multiplicity_func_new_from_name ((gchar *) mulfs[m]);
+
+    for (p = 0; p < G_N_ELEMENTS (precs); p++)
+    {
+      NcHaloMassFunction *mfp = nc_halo_mass_function_new (dist, psf, mulf);
+      NcmSpline2d *s2d;
+      gdouble wall, max_rel = 0.0;
+      gint64 t0;
+      guint nz, nlnM, i, j;
+
+      nc_halo_mass_function_set_area_sd (mfp, 200.0);
+      nc_halo_mass_function_set_prec (mfp, precs[p]);
+      nc_halo_mass_function_set_eval_limits (mfp, cosmo, log (1.0e14), log (1.0e16), 0.0, 2.0);
+
+      /* The first call also builds the knots and prepares psf and dist. */
+      nc_halo_mass_function_prepare (mfp, cosmo);
+
+      t0 = g_get_monotonic_time ();
+      for (i = 0; i < nrep; i++)
+        nc_halo_mass_function_prepare (mfp, cosmo);
+      wall = (g_get_monotonic_time () - t0) * 1.0e-6 / nrep;
+
+      s2d  = mfp->d2NdzdlnM;
+      nz   = ncm_vector_len (s2d->yv);
+      nlnM = ncm_vector_len (s2d->xv);
+
+      for (i = 0; i < nz; i++)
+      {
+        const gdouble z    = ncm_vector_get (s2d->yv, i);
+        const gdouble dVdz = 200.0 * M_PI * M_PI / (180.0 * 180.0) * nc_halo_mass_function_dv_dzdomega (mfp, cosmo, z);
+
+        for (j = 0; j < nlnM; j++)
+        {
+          const gdouble lnM = ncm_vector_get (s2d->xv, j);
+          const gdouble d2N = dVdz * nc_halo_mass_function_dn_dlnM (mfp, cosmo, lnM, z);
+
+          if (d2N != 0.0)
+            max_rel = GSL_MAX (max_rel, fabs (ncm_matrix_get (s2d->zm, i, j) / d2N - 1.0));
+        }
+      }
+
+      g_print ("  %-26s %8.1e %6u %6u % 12.6f % 12.4e\n", mulfs[m], precs[p], nz, nlnM, wall, max_rel);
+
+      nc_halo_mass_function_free (mfp);
+    }
+
+    nc_multiplicity_func_free (mulf);
+  }
+
+  ncm_powspec_filter_free (psf);
+  nc_powspec_ml_free (ps_ml);
+  nc_transfer_func_free (tf);
+  nc_distance_free (dist);
+  nc_hiprim_free (prim);
+  nc_hireion_free (reion);
+  nc_hicosmo_free (cosmo);
+
+  return 0;
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+ *            bench_ncm_fit_esmcmc.c
+ *
+ *  Thu October 15 10:12:40 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Usage: bench_ncm_fit_esmcmc [niter] [nwalkers] [nthreads]
+ *
+ * Runs an ensemble sampler over a small BAO likelihood and reports, for
+ * each iteration, the wall time and the fraction of the worker cores that
+ * were busy evaluating the likelihood (ncm_fit_esmcmc_get_core_usage()).
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <stdlib.h>
+#include <glib.h>
+#include <glib-object.h>
+
+gint
+main (gint argc, gchar *argv[])
+{
+  const guint niter    = (argc > 1) ? atoi (argv[1]) : 50;
+  const guint nwalkers = (argc > 2) ? atoi (argv[2]) : 64;
+  const guint nthreads = (argc > 3) ? atoi (argv[3]) : 4;
+  const NcDataBaoId bao_ids[] = {
+    NC_DATA_BAO_RDV_PERCIVAL2010,
+    NC_DATA_BAO_RDV_BEUTLER2011,
+    NC_DATA_BAO_RDV_PADMANABHAN2012,
+    NC_DATA_BAO_RDV_ANDERSON2012,
+    NC_DATA_BAO_RDV_BLAKE2012
+  };
+  NcHICosmo *cosmo;
+  NcDistance *dist;
+  NcmMSet *mset;
+  NcmDataset *dset;
+  NcmLikelihood *lh;
+  NcmFit *fit;
+  NcmMSetTransKernGauss *init_sampler;
+  NcmFitESMCMCWalkerStretch *stretch;
+  NcmFitESMCMC *esmcmc;
+  gdouble usage_mean = 0.0;
+  gdouble wall_total = 0.0;
+  guint i;
+
+  ncm_cfg_init ();
+
+  cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  dist  = nc_distance_new (3.0);
+  mset  = ncm_mset_new (cosmo, NULL);
+  dset  = ncm_dataset_new ();
+
+  for (i = 0; i < G_N_ELEMENTS (bao_ids); i++)
+  {
+    NcmData *bao = NCM_DATA (nc_data_bao_rdv_new_from_id (dist, bao_ids[i]));
+    ncm_dataset_append_data (dset, bao);
+    ncm_data_free (bao);
+  }
+
+  ncm_mset_param_set_ftype (mset, nc_hicosmo_id (), NC_HICOSMO_DE_OMEGA_C, NCM_PARAM_TYPE_FREE);
+  ncm_mset_param_set_ftype (mset, nc_hicosmo_id (), NC_HICOSMO_DE_OMEGA_X, NCM_PARAM_TYPE_FREE);
+  ncm_mset_param_set_ftype (mset, nc_hicosmo_id (), NC_HICOSMO_DE_XCDM_W,  NCM_PARAM_TYPE_FREE);
+
+  lh  = ncm_likelihood_new (dset);
+  fit = ncm_fit_new (NCM_FIT_TYPE_NLOPT, "ln-neldermead", lh, mset, NCM_FIT_GRAD_NUMDIFF_FORWARD);
+
+  init_sampler = ncm_mset_trans_kern_gauss_new (0);
+  stretch      = ncm_fit_esmcmc_walker_stretch_new (nwalkers, ncm_mset_fparams_len (mset));
+  esmcmc       = ncm_fit_esmcmc_new (fit,
+                                     nwalkers,
+                                     NCM_MSET_TRANS_KERN (init_sampler),
+                                     NCM_FIT_ESMCMC_WALKER (stretch),
+                                     NCM_FIT_RUN_MSGS_NONE);
+
+  ncm_mset_trans_kern_set_mset (NCM_MSET_TRANS_KERN (init_sampler), mset);
+  ncm_mset_trans_kern_set_prior_from_mset (NCM_MSET_TRANS_KERN (init_sampler));
+  ncm_mset_trans_kern_gauss_set_cov_from_rescale (init_sampler, 0.01);
+
+  ncm_fit_esmcmc_set_nthreads (esmcmc, nthreads);
+
+  ncm_fit_esmcmc_start_run (esmcmc);
+  /* The first call only samples the initial ensemble. */
+  ncm_fit_esmcmc_run (esmcmc, 1);
+
+  g_print ("# iter     wall[s]   core-usage\n");
+  for (i = 2; i <= niter + 1; i++)
+  {
+    const gint64 t0 = g_get_monotonic_time ();
+    gdouble wall, usage;
+
+    ncm_fit_esmcmc_run (esmcmc, i);
+
+    wall  = (g_get_monotonic_time () - t0) * 1.0e-6;
+    usage = ncm_fit_esmcmc_get_core_usage (esmcmc);
+
+    wall_total += wall;
+    usage_mean += usage;
+
+    g_print ("  %5u  % 10.6f  % 10.4f\n", i - 1, wall, usage);
+  }
+  ncm_fit_esmcmc_end_run (esmcmc);
+
+  g_print ("# nwalkers %u nthreads %u: mean wall % 10.6f s, mean core-usage % 10.4f\n",
+           nwalkers, nthreads, wall_total / niter, usage_mean / niter);
+
+  ncm_fit_esmcmc_clear (&esmcmc);
+  ncm_fit_esmcmc_walker_free (NCM_FIT_ESMCMC_WALKER (stretch));
+  ncm_mset_trans_kern_free (NCM_MSET_TRANS_KERN (init_sampler));
+  ncm_fit_clear (&fit);
+  ncm_likelihood_free (lh);
+  ncm_dataset_free (dset);
+  ncm_mset_free (mset);
+  nc_distance_free (dist);
+  nc_hicosmo_free (cosmo);
+
+  return 0;
+}
@@ -0,0 +1,347 @@
+/***************************************************************************
+ *            bench_ncm_vector_view.c
+ *
+ *  Fri October 16 15:20:48 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Usage: bench_ncm_vector_view [nrep] [nparticles] [dim]
+ *
+ * Times the evaluation of a Gaussian mixture over the rows of a particle
+ * catalog, the same access pattern used by the NcmABC weights and by the
+ * NcmMSetCatalog row evaluations. Each row holds two additional values
+ * followed by the parameters, and each evaluation visits every row:
+ *
+ * - subvector: a new #NcmVector per row, ncm_vector_get_subvector() (the
+ *   code path used before #NcmVectorView);
+ * - view: a single #NcmVector moved between rows with ncm_vector_set_view();
+ * - gsl: only the stack allocated #NcmVectorView and gsl_blas.
+ *
+ * The second table times the likelihood evaluations of a BAO data set
+ * (#NcmDataGaussCov and #NcmDataGauss data) with the particles as the free
+ * parameters:
+ *
+ * - fixed: ncm_fit_m2lnL_val() with the same parameters, i.e., only the data
+ *   part of the evaluation;
+ * - changing: ncm_fit_m2lnL_val() after changing the parameters, including
+ *   the model preparation;
+ * - batch: ncm_likelihood_m2lnL_val_batch() over all particles, the values
+ *   are per particle and nrep / nparticles batches are evaluated.
+ *
+ * On glibc systems the calls to malloc/calloc/realloc are counted and the
+ * number of allocations per evaluation is also reported (GSlice is set to
+ * always-malloc so that the GObject instances are counted as well).
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <stdlib.h>
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <gsl/gsl_blas.h>
+
+#ifdef __GLIBC__
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+static volatile gint _bench_nalloc = 0;
+
+void *
+malloc (size_t size)
+{
+  g_atomic_int_inc (&_bench_nalloc);
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t nmemb, size_t size)
+{
+  g_atomic_int_inc (&_bench_nalloc);
+  return __libc_calloc (nmemb, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+  g_atomic_int_inc (&_bench_nalloc);
+  return __libc_realloc (ptr, size);
+}
+
+#define BENCH_NALLOC() ((gdouble) g_atomic_int_get (&_bench_nalloc))
+#else
+#define BENCH_NALLOC() (GSL_NAN)
+#endif /* __GLIBC__ */
+
+typedef enum _BenchMode
+{
+  BENCH_MODE_SUBVECTOR = 0,
+  BENCH_MODE_VIEW,
+  BENCH_MODE_GSL,
+} BenchMode;
+
+static gdouble
+_bench_kernel (const gsl_vector *theta, const gsl_vector *x)
+{
+  gdouble tx, tt;
+
+  gsl_blas_ddot (theta, x, &tx);
+  gsl_blas_ddot (theta, theta, &tt);
+
+  return exp (-0.5 * (tt - 2.0 * tx));
+}
+
+static gdouble
+_bench_eval (BenchMode mode, GPtrArray *rows, NcmVector *x, NcmVector **theta)
+{
+  gdouble res = 0.0;
+  guint j;
+
+  for (j = 0; j < rows->len; j++)
+  {
+    NcmVector *row = g_ptr_array_index (rows, j);
+
+    switch (mode)
+    {
+      case BENCH_MODE_SUBVECTOR:
+      {
+        NcmVector *theta_j = ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2);
+
+        res += ncm_vector_get (row, 0) * _bench_kernel (ncm_vector_gsl (theta_j), ncm_vector_gsl (x));
+        ncm_vector_free (theta_j);
+        break;
+      }
+      case BENCH_MODE_VIEW:
+      {
+        NcmVectorView theta_view = ncm_vector_get_subvector_view (row, 2, ncm_vector_len (row) - 2);
+
+        if (*theta == NULL)
+          *theta = ncm_vector_new_view (&theta_view);
+        else
+          ncm_vector_set_view (*theta, &theta_view);
+
+        res += ncm_vector_get (row, 0) * _bench_kernel (ncm_vector_gsl (*theta), ncm_vector_gsl (x));
+        break;
+      }
+      case BENCH_MODE_GSL:
+      {
+        NcmVectorView theta_view = ncm_vector_get_subvector_view (row, 2, ncm_vector_len (row) - 2);
+
+        res += ncm_vector_get (row, 0) * _bench_kernel (ncm_vector_view_gsl (&theta_view), ncm_vector_gsl (x));
+        break;
+      }
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  }
+
+  return res;
+}
+
+typedef enum _BenchLhMode
+{
+  BENCH_LH_MODE_FIXED = 0,
+  BENCH_LH_MODE_CHANGING,
+  BENCH_LH_MODE_BATCH,
+} BenchLhMode;
+
+static void
+_bench_m2lnL (BenchLhMode mode, NcmFit *fit, NcmMatrix *fparams, NcmVector *m2lnL_v, guint i)
+{
+  switch (mode)
+  {
+    case BENCH_LH_MODE_FIXED:
+      ncm_fit_m2lnL_val (fit, ncm_vector_ptr (m2lnL_v, 0));
+      break;
+    case BENCH_LH_MODE_CHANGING:
+    {
+      NcmVectorView x_view = ncm_matrix_get_row_view (fparams, i % ncm_matrix_nrows (fparams));
+      guint k;
+
+      for (k = 0; k < ncm_vector_view_len (&x_view); k++)
+        ncm_mset_fparam_set (fit->mset, k, ncm_vector_view_get (&x_view, k));
+
+      ncm_fit_m2lnL_val (fit, ncm_vector_ptr (m2lnL_v, 0));
+      break;
+    }
+    case BENCH_LH_MODE_BATCH:
+      ncm_likelihood_m2lnL_val_batch (fit->lh, fit->mset, fparams, m2lnL_v);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+static void
+_bench_likelihood (guint nrep, guint nparticles, NcmRNG *rng)
+{
+  const NcDataBaoId rdv_ids[] = {
+    NC_DATA_BAO_RDV_BEUTLER2011,
+    NC_DATA_BAO_RDV_PADMANABHAN2012,
+    NC_DATA_BAO_RDV_ANDERSON2012,
+  };
+  const gchar *names[] = {"fixed", "changing", "batch"};
+  NcHICosmo *cosmo     = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  NcDistance *dist     = nc_distance_new (3.0);
+  NcmMSet *mset        = ncm_mset_new (cosmo, NULL);
+  NcmDataset *dset     = ncm_dataset_new ();
+  NcmData *dmr_hr      = NCM_DATA (nc_data_bao_dmr_hr_new_from_id (dist, NC_DATA_BAO_DMR_HR_SDSS_DR12_2016));
+  NcmLikelihood *lh;
+  NcmFit *fit;
+  NcmMatrix *fparams;
+  NcmVector *m2lnL_v;
+  guint m, i, k;
+
+  ncm_dataset_append_data (dset, dmr_hr);
+  ncm_data_free (dmr_hr);
+
+  for (i = 0; i < G_N_ELEMENTS (rdv_ids); i++)
+  {
+    NcmData *bao = NCM_DATA (nc_data_bao_rdv_new_from_id (dist, rdv_ids[i]));
+    ncm_dataset_append_data (dset, bao);
+    ncm_data_free (bao);
+  }
+
+  ncm_mset_param_set_ftype (mset, nc_hicosmo_id (), NC_HICOSMO_DE_OMEGA_C, NCM_PARAM_TYPE_FREE);
+  ncm_mset_param_set_ftype (mset, nc_hicosmo_id (), NC_HICOSMO_DE_OMEGA_X, NCM_PARAM_TYPE_FREE);
+  ncm_mset_param_set_ftype (mset, nc_hicosmo_id (), NC_HICOSMO_DE_XCDM_W,  NCM_PARAM_TYPE_FREE);
+
+  lh      = ncm_likelihood_new (dset);
+  fit     = ncm_fit_new (NCM_FIT_TYPE_NLOPT, "ln-neldermead", lh, mset, NCM_FIT_GRAD_NUMDIFF_FORWARD);
+  fparams = ncm_matrix_new (nparticles, ncm_mset_fparams_len (mset));
+  m2lnL_v = ncm_vector_new (nparticles);
+
+  for (i = 0; i < nparticles; i++)
+  {
+    for (k = 0; k < ncm_mset_fparams_len (mset); k++)
+      ncm_matrix_set (fparams, i, k, ncm_mset_fparam_get (mset, k) + gsl_ran_gaussian (rng->r, 1.0e-2));
+  }
+
+  g_print ("# likelihood: %u data sets, %u free parameters\n", ncm_dataset_get_length (dset), ncm_mset_fparams_len (mset));
+  g_print ("# %-10s %14s %14s\n", "m2lnL", "eval[s]", "allocs/eval");
+
+  for (m = 0; m < G_N_ELEMENTS (names); m++)
+  {
+    /* A batch evaluates all particles, keeps the total number of evaluations. */
+    const guint neval  = (m == BENCH_LH_MODE_BATCH) ? nparticles : 1;
+    const guint nrep_m = GSL_MAX (nrep / neval, 1);
+    gdouble nalloc, wall;
+    gint64 t0;
+
+    /* Warm up, prepares the models and the data workspaces. */
+    _bench_m2lnL (m, fit, fparams, m2lnL_v, 0);
+
+    nalloc = BENCH_NALLOC ();
+    t0     = g_get_monotonic_time ();
+    for (i = 0; i < nrep_m; i++)
+      _bench_m2lnL (m, fit, fparams, m2lnL_v, i);
+    wall   = (g_get_monotonic_time () - t0) * 1.0e-6 / (nrep_m * neval);
+    nalloc = (BENCH_NALLOC () - nalloc) / (nrep_m * neval);
+
+    g_print ("  %-10s % 14.6e % 14.2f\n", names[m], wall, nalloc);
+  }
+
+  ncm_vector_free (m2lnL_v);
+  ncm_matrix_free (fparams);
+  ncm_fit_clear (&fit);
+  ncm_likelihood_free (lh);
+  ncm_dataset_free (dset);
+  ncm_mset_free (mset);
+  nc_distance_free (dist);
+  nc_hicosmo_free (cosmo);
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+  const guint nrep       = (argc > 1) ? atoi (argv[1]) : 2000;
+  const guint nparticles = (argc > 2) ? atoi (argv[2]) : 1000;
+  const guint dim        = (argc > 3) ? atoi (argv[3]) : 6;
+  const gchar *names[]   = {"subvector", "view", "gsl"};
+  GPtrArray *rows;
+  NcmVector *x;
+  NcmRNG *rng;
+  gdouble ref = 0.0;
+  guint m, i, j;
+
+  g_setenv ("G_SLICE", "always-malloc", TRUE);
+  ncm_cfg_init ();
+
+  rng  = ncm_rng_seeded_new (NULL, 123);
+  rows = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_vector_free);
+  x    = ncm_vector_new (dim);
+
+  for (i = 0; i < dim; i++)
+    ncm_vector_set (x, i, gsl_ran_gaussian (rng->r, 0.1));
+
+  for (j = 0; j < nparticles; j++)
+  {
+    NcmVector *row = ncm_vector_new (dim + 2);
+
+    ncm_vector_set (row, 0, 1.0 / nparticles);
+    ncm_vector_set (row, 1, 0.0);
+    for (i = 0; i < dim; i++)
+      ncm_vector_set (row, 2 + i, gsl_ran_gaussian (rng->r, 0.1));
+
+    g_ptr_array_add (rows, row);
+  }
+
+  g_print ("# nrep %u nparticles %u dim %u\n", nrep, nparticles, dim);
+  g_print ("# %-10s %14s %14s %14s\n", "mode", "eval[s]", "allocs/eval", "rel-diff");
+
+  for (m = 0; m < G_N_ELEMENTS (names); m++)
+  {
+    NcmVector *theta = NULL;
+    gdouble res = 0.0, nalloc, wall;
+    gint64 t0;
+
+    /* Warm up, creates the reusable vector in the view mode. */
+    _bench_eval (m, rows, x, &theta);
+
+    nalloc = BENCH_NALLOC ();
+    t0     = g_get_monotonic_time ();
+    for (i = 0; i < nrep; i++)
+      res = _bench_eval (m, rows, x, &theta);
+    wall   = (g_get_monotonic_time () - t0) * 1.0e-6 / nrep;
+    nalloc = (BENCH_NALLOC () - nalloc) / nrep;
+
+    if (m == BENCH_MODE_SUBVECTOR)
+      ref = res;
+
+    g_print ("  %-10s % 14.6e % 14.2f % 14.4e\n", names[m], wall, nalloc, fabs (res / ref - 1.0));
+
+    ncm_vector_clear (&theta);
+  }
+
+  _bench_likelihood (nrep, nparticles, rng);
+
+  g_ptr_array_unref (rows);
+  ncm_vector_free (x);
+  ncm_rng_free (rng);
+
+  return 0;
+}
@@ -39,11 +39,15 @@ ncm_data_gauss_cov_test_init (NcmDataGaussCovTest *gcov_test)
   gcov_test->b = 0.0;
   gcov_test->c = 0.0;
   gcov_test->d = 0.0;
+  gcov_test->S = NULL;
 }
 
 static void
 ncm_data_gauss_cov_test_finalize (GObject *object)
 {
+  NcmDataGaussCovTest *gcov_test = NCM_DATA_GAUSS_COV_TEST (object);
+
+  ncm_matrix_clear (&gcov_test->S);
 
   /* Chain up : end */
   G_OBJECT_CLASS (ncm_data_gauss_cov_test_parent_class)->finalize (object);
@@ -51,6 +55,7 @@ ncm_data_gauss_cov_test_finalize (GObject *object)
 
 static void _ncm_data_gauss_cov_test_prepare (NcmData *data, NcmMSet *mset);
 static gboolean _ncm_data_gauss_cov_test_cov_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmMatrix *cov);
+static void _ncm_data_gauss_cov_test_cov_lowrank_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmMatrix *S);
 
 static void
 ncm_data_gauss_cov_test_class_init (NcmDataGaussCovTestClass *klass)
@@ -64,6 +69,7 @@ ncm_data_gauss_cov_test_class_init (NcmDataGaussCovTestClass *klass)
   data_class->prepare    = &_ncm_data_gauss_cov_test_prepare;
   gauss_class->mean_func = &ncm_data_gauss_cov_test_mean_func;
   gauss_class->cov_func  = NULL;
+  gauss_class->cov_lowrank_func = &_ncm_data_gauss_cov_test_cov_lowrank_func;
 }
 
 static void
@@ -115,6 +121,14 @@ _ncm_data_gauss_cov_test_cov_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmMat
   return FALSE;
 }
 
+static void 
+_ncm_data_gauss_cov_test_cov_lowrank_func (NcmDataGaussCov *gauss, NcmMSet *mset, NcmMatrix *S)
+{
+  NcmDataGaussCovTest *gcov_test = NCM_DATA_GAUSS_COV_TEST (gauss);
+  g_assert (gcov_test->S != NULL);
+  ncm_matrix_memcpy (S, gcov_test->S);
+}
+
 #define _TEST_NCM_DATA_GAUSS_COV_MIN_SIZE 10
 #define _TEST_NCM_DATA_GAUSS_COV_MAX_SIZE 20
 
@@ -50,6 +50,7 @@ struct _NcmDataGaussCovTest
 {
   NcmDataGaussCov parent_instance;
   gdouble a, b, c, d;
+  NcmMatrix *S;
 };
 
 GType ncm_data_gauss_cov_test_get_type (void) G_GNUC_CONST;
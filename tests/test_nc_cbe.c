@@ -54,6 +54,7 @@ static void test_nc_cbe_pad_new (TestNcCBE *test, gconstpointer pdata);
 static void test_nc_cbe_free (TestNcCBE *test, gconstpointer pdata);
 
 static void test_nc_cbe_compare_bg (TestNcCBE *test, gconstpointer pdata);
+static void test_nc_cbe_prepare_if_needed (TestNcCBE *test, gconstpointer pdata);
 
 static void test_nc_cbe_traps (TestNcCBE *test, gconstpointer pdata);
 /*static void test_nc_cbe_invalid_model (TestNcCBE *test, gconstpointer pdata);*/
@@ -105,6 +106,11 @@ main (gint argc, gchar *argv[])
               &test_nc_cbe_compare_bg,
               &test_nc_cbe_free);
 
+  g_test_add ("/nc/cbe/lcdm/prepare_if_needed", TestNcCBE, NULL,
+              &test_nc_cbe_lcdm_new,
+              &test_nc_cbe_prepare_if_needed,
+              &test_nc_cbe_free);
+
   g_test_add ("/nc/cbe/traps", TestNcCBE, NULL,
               &test_nc_cbe_lcdm_new,
               &test_nc_cbe_traps,
@@ -363,6 +369,47 @@ test_nc_cbe_compare_bg (TestNcCBE *test, gconstpointer pdata)
 }
 
 
+void
+test_nc_cbe_prepare_if_needed (TestNcCBE *test, gconstpointer pdata)
+{
+  NcCBE *cbe       = test->cbe;
+  NcHICosmo *cosmo = test->cosmo;
+  NcmModel *prim   = NCM_MODEL (nc_hicosmo_peek_prim (cosmo));
+  NcmModel *reion  = NCM_MODEL (nc_hicosmo_peek_reion (cosmo));
+  const guint lmax = 500;
+  NcmVector *TT_inc = ncm_vector_new (lmax + 1);
+  NcmVector *TT     = ncm_vector_new (lmax + 1);
+  guint i, l;
+
+  nc_cbe_set_target_Cls (cbe, NC_DATA_CMB_TYPE_TT);
+  nc_cbe_set_scalar_lmax (cbe, lmax);
+  nc_cbe_prepare_if_needed (cbe, cosmo);
+
+  /*
+   * Changes only the primordial and then only the reionization parameters,
+   * the partially recomputed Cls must match a full preparation.
+   */
+  for (i = 0; i < 2; i++)
+  {
+    if (i == 0)
+      ncm_model_orig_param_set (prim, NC_HIPRIM_POWER_LAW_N_SA, 0.95);
+    else
+      ncm_model_orig_param_set (reion, 0, ncm_model_orig_param_get (reion, 0) * 1.1);
+
+    nc_cbe_prepare_if_needed (cbe, cosmo);
+    nc_cbe_get_all_Cls (cbe, TT_inc, NULL, NULL, NULL);
+
+    nc_cbe_prepare (cbe, cosmo);
+    nc_cbe_get_all_Cls (cbe, TT, NULL, NULL, NULL);
+
+    for (l = 2; l <= lmax; l++)
+      ncm_assert_cmpdouble_e (ncm_vector_get (TT_inc, l), ==, ncm_vector_get (TT, l), 1.0e-10);
+  }
+
+  ncm_vector_free (TT_inc);
+  ncm_vector_free (TT);
+}
+
 void
 test_nc_cbe_traps (TestNcCBE *test, gconstpointer pdata)
 {
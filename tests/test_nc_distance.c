@@ -0,0 +1,228 @@
+/***************************************************************************
+ *            test_nc_distance.c
+ *
+ *  Fri October 16 19:12:40 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcDistance
+{
+  NcHICosmo *cosmo;
+  NcDistance *dist;
+  NcDistance *dist_ref;
+} TestNcDistance;
+
+static void test_nc_distance_new (TestNcDistance *test, gconstpointer pdata);
+static void test_nc_distance_vec (TestNcDistance *test, gconstpointer pdata);
+static void test_nc_distance_extend (TestNcDistance *test, gconstpointer pdata);
+static void test_nc_distance_threads (TestNcDistance *test, gconstpointer pdata);
+static void test_nc_distance_free (TestNcDistance *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/nc/distance/vec", TestNcDistance, NULL,
+              &test_nc_distance_new,
+              &test_nc_distance_vec,
+              &test_nc_distance_free);
+
+  g_test_add ("/nc/distance/extend", TestNcDistance, NULL,
+              &test_nc_distance_new,
+              &test_nc_distance_extend,
+              &test_nc_distance_free);
+
+  g_test_add ("/nc/distance/threads", TestNcDistance, NULL,
+              &test_nc_distance_new,
+              &test_nc_distance_threads,
+              &test_nc_distance_free);
+
+  g_test_run ();
+}
+
+static void
+test_nc_distance_new (TestNcDistance *test, gconstpointer pdata)
+{
+  test->cosmo    = NC_HICOSMO (nc_hicosmo_de_xcdm_new ());
+  test->dist     = nc_distance_new (0.5);
+  test->dist_ref = nc_distance_new (20.0);
+
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "Omegax", g_test_rand_double_range (0.65, 0.75));
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "w", g_test_rand_double_range (-1.2, -0.8));
+
+  nc_distance_prepare (test->dist, test->cosmo);
+  nc_distance_prepare (test->dist_ref, test->cosmo);
+}
+
+static void
+test_nc_distance_free (TestNcDistance *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (nc_distance_free, test->dist);
+  NCM_TEST_FREE (nc_distance_free, test->dist_ref);
+  NCM_TEST_FREE (nc_hicosmo_free, test->cosmo);
+}
+
+static void
+test_nc_distance_vec (TestNcDistance *test, gconstpointer pdata)
+{
+  const guint len  = 100 + g_test_rand_int_range (0, 1000);
+  NcmVector *z_he  = ncm_vector_new (len);
+  NcmVector *z_cmb = ncm_vector_new (len);
+  NcmVector *Dc    = ncm_vector_new (len);
+  NcmVector *Dt    = ncm_vector_new (len);
+  NcmVector *Dl    = ncm_vector_new (len);
+  NcmVector *DA    = ncm_vector_new (len);
+  NcmVector *dmu   = ncm_vector_new (len);
+  NcmVector *dmu_h = ncm_vector_new (len);
+  guint i;
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble z = g_test_rand_double_range (1.0e-3, 2.5);
+
+    ncm_vector_set (z_cmb, i, z);
+    ncm_vector_set (z_he, i, z + g_test_rand_double_range (-1.0e-3, 1.0e-3));
+  }
+
+  /* The vector calls extend the spline beyond zf = 0.5 first. */
+  nc_distance_comoving_vec (test->dist, test->cosmo, z_cmb, Dc);
+  nc_distance_transverse_vec (test->dist, test->cosmo, z_cmb, Dt);
+  nc_distance_luminosity_vec (test->dist, test->cosmo, z_cmb, Dl);
+  nc_distance_angular_diameter_vec (test->dist, test->cosmo, z_cmb, DA);
+  nc_distance_dmodulus_vec (test->dist, test->cosmo, z_cmb, dmu);
+  nc_distance_dmodulus_hef_vec (test->dist, test->cosmo, z_he, z_cmb, dmu_h);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble z   = ncm_vector_get (z_cmb, i);
+    const gdouble zhe = ncm_vector_get (z_he, i);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (Dc, i), ==, nc_distance_comoving (test->dist, test->cosmo, z), 1.0e-15);
+    ncm_assert_cmpdouble_e (ncm_vector_get (Dt, i), ==, nc_distance_transverse (test->dist, test->cosmo, z), 1.0e-15);
+    ncm_assert_cmpdouble_e (ncm_vector_get (Dl, i), ==, nc_distance_luminosity (test->dist, test->cosmo, z), 1.0e-15);
+    ncm_assert_cmpdouble_e (ncm_vector_get (DA, i), ==, nc_distance_angular_diameter (test->dist, test->cosmo, z), 1.0e-15);
+    ncm_assert_cmpdouble_e (ncm_vector_get (dmu, i), ==, nc_distance_dmodulus (test->dist, test->cosmo, z), 1.0e-15);
+    ncm_assert_cmpdouble_e (ncm_vector_get (dmu_h, i), ==, nc_distance_dmodulus_hef (test->dist, test->cosmo, zhe, z), 1.0e-15);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (dmu, i), ==, nc_distance_dmodulus (test->dist_ref, test->cosmo, z), 1.0e-7);
+  }
+
+  ncm_vector_free (z_he);
+  ncm_vector_free (z_cmb);
+  ncm_vector_free (Dc);
+  ncm_vector_free (Dt);
+  ncm_vector_free (Dl);
+  ncm_vector_free (DA);
+  ncm_vector_free (dmu);
+  ncm_vector_free (dmu_h);
+}
+
+static void
+test_nc_distance_extend (TestNcDistance *test, gconstpointer pdata)
+{
+  guint i;
+
+  for (i = 0; i < 100; i++)
+  {
+    const gdouble z = 0.1 * (i + 1);
+
+    ncm_assert_cmpdouble_e (nc_distance_comoving (test->dist, test->cosmo, z), ==,
+                            nc_distance_comoving (test->dist_ref, test->cosmo, z), 1.0e-7);
+  }
+
+  g_assert_cmpfloat (test->dist->comoving_distance_spline->xf, >=, 10.0);
+
+  /* The extended range survives a new model when E^2 is still positive. */
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "w", -1.0);
+  nc_distance_prepare_if_needed (test->dist, test->cosmo);
+  g_assert_cmpfloat (test->dist->comoving_distance_spline->xf, >=, 10.0);
+
+  for (i = 0; i < 100; i++)
+  {
+    const gdouble z = 0.1 * (i + 1);
+
+    ncm_assert_cmpdouble_e (nc_distance_comoving (test->dist, test->cosmo, z), ==,
+                            nc_distance_comoving (test->dist_ref, test->cosmo, z), 1.0e-7);
+  }
+
+  /* Beyond the maximum extension the integral is used. */
+  g_assert (gsl_finite (nc_distance_comoving (test->dist, test->cosmo, 2.0e4)));
+  g_assert_cmpfloat (test->dist->comoving_distance_spline->xf, <=, 1.0e4);
+}
+
+typedef struct _TestNcDistanceThread
+{
+  TestNcDistance *test;
+  guint seed;
+} TestNcDistanceThread;
+
+static gpointer
+_test_nc_distance_reader (gpointer data)
+{
+  TestNcDistanceThread *tt = (TestNcDistanceThread *) data;
+  GRand *rand              = g_rand_new_with_seed (tt->seed);
+  guint i;
+
+  /* Increasing redshifts, every reader forces extensions. */
+  for (i = 0; i < 2000; i++)
+  {
+    const gdouble z  = g_rand_double_range (rand, 0.0, 1.0e-2 * (i + 1));
+    const gdouble Dc = nc_distance_comoving (tt->test->dist, tt->test->cosmo, z);
+
+    ncm_assert_cmpdouble_e (Dc, ==, nc_distance_comoving (tt->test->dist_ref, tt->test->cosmo, z), 1.0e-7);
+  }
+
+  g_rand_free (rand);
+
+  return NULL;
+}
+
+static void
+test_nc_distance_threads (TestNcDistance *test, gconstpointer pdata)
+{
+  TestNcDistanceThread tt[4];
+  GThread *readers[4];
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (readers); i++)
+  {
+    tt[i].test = test;
+    tt[i].seed = g_test_rand_int ();
+    readers[i] = g_thread_new ("reader", &_test_nc_distance_reader, &tt[i]);
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (readers); i++)
+    g_thread_join (readers[i]);
+
+  g_assert_cmpfloat (test->dist->comoving_distance_spline->xf, >, 0.5);
+}
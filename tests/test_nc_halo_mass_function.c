@@ -0,0 +1,142 @@
+/***************************************************************************
+ *            test_nc_halo_mass_function.c
+ *
+ *  Fri October 16 22:41:09 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcHaloMassFunction
+{
+  NcHICosmo *cosmo;
+  NcDistance *dist;
+  NcTransferFunc *tf;
+  NcPowspecML *ps_ml;
+  NcmPowspecFilter *psf;
+  NcMultiplicityFunc *mulf;
+  NcHaloMassFunction *mfp;
+} TestNcHaloMassFunction;
+
+void test_nc_halo_mass_function_new (TestNcHaloMassFunction *test, gconstpointer pdata);
+void test_nc_halo_mass_function_free (TestNcHaloMassFunction *test, gconstpointer pdata);
+void test_nc_halo_mass_function_dn_dlnM_vec (TestNcHaloMassFunction *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/nc/halo_mass_function/tinker/dn_dlnM_vec", TestNcHaloMassFunction, "NcMultiplicityFuncTinker",
+              &test_nc_halo_mass_function_new,
+              &test_nc_halo_mass_function_dn_dlnM_vec,
+              &test_nc_halo_mass_function_free);
+
+  g_test_add ("/nc/halo_mass_function/st/dn_dlnM_vec", TestNcHaloMassFunction, "NcMultiplicityFuncST",
+              &test_nc_halo_mass_function_new,
+              &test_nc_halo_mass_function_dn_dlnM_vec,
+              &test_nc_halo_mass_function_free);
+
+  /* No eval_vec implementation, uses the default point by point loop. */
+  g_test_add ("/nc/halo_mass_function/ps/dn_dlnM_vec", TestNcHaloMassFunction, "NcMultiplicityFuncPS",
+              &test_nc_halo_mass_function_new,
+              &test_nc_halo_mass_function_dn_dlnM_vec,
+              &test_nc_halo_mass_function_free);
+
+  g_test_run ();
+}
+
+void
+test_nc_halo_mass_function_new (TestNcHaloMassFunction *test, gconstpointer pdata)
+{
+  const gchar *mulf_name = pdata;
+  NcHIReion *reion       = NC_HIREION (nc_hireion_camb_new ());
+  NcHIPrim *prim         = NC_HIPRIM (nc_hiprim_power_law_new ());
+
+  test->cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  test->dist  = nc_distance_new (3.0);
+  test->tf    = nc_transfer_func_new_from_name ("NcTransferFuncEH");
+  test->ps_ml = NC_POWSPEC_ML (nc_powspec_ml_transfer_new (test->tf));
+  test->psf   = ncm_powspec_filter_new (NCM_POWSPEC (test->ps_ml), NCM_POWSPEC_FILTER_TYPE_TOPHAT);
+  test->mulf  = nc_multiplicity_func_new_from_name ((gchar *) mulf_name);
+  test->mfp   = nc_halo_mass_function_new (test->dist, test->psf, test->mulf);
+
+  ncm_model_add_submodel (NCM_MODEL (test->cosmo), NCM_MODEL (reion));
+  ncm_model_add_submodel (NCM_MODEL (test->cosmo), NCM_MODEL (prim));
+
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "Omegac", g_test_rand_double_range (0.2, 0.3));
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "w", g_test_rand_double_range (-1.2, -0.8));
+
+  nc_distance_prepare (test->dist, test->cosmo);
+  ncm_powspec_filter_prepare (test->psf, NCM_MODEL (test->cosmo));
+
+  nc_hireion_free (reion);
+  nc_hiprim_free (prim);
+}
+
+void
+test_nc_halo_mass_function_free (TestNcHaloMassFunction *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (nc_halo_mass_function_free, test->mfp);
+  NCM_TEST_FREE (nc_multiplicity_func_free, test->mulf);
+  NCM_TEST_FREE (ncm_powspec_filter_free, test->psf);
+  NCM_TEST_FREE (nc_powspec_ml_free, test->ps_ml);
+  NCM_TEST_FREE (nc_transfer_func_free, test->tf);
+  NCM_TEST_FREE (nc_distance_free, test->dist);
+  NCM_TEST_FREE (nc_hicosmo_free, test->cosmo);
+}
+
+void
+test_nc_halo_mass_function_dn_dlnM_vec (TestNcHaloMassFunction *test, gconstpointer pdata)
+{
+  /* Several full blocks and a partial one. */
+  const guint np = 3 * NCM_SPLINE_VEC_BLOCK + 1 + g_test_rand_int_range (0, NCM_SPLINE_VEC_BLOCK - 1);
+  gdouble *lnM   = g_new (gdouble, np);
+  gdouble *res   = g_new (gdouble, np);
+  guint ntest;
+
+  for (ntest = 0; ntest < 10; ntest++)
+  {
+    const gdouble z = g_test_rand_double_range (0.0, 2.0);
+    guint i;
+
+    /* Unsorted masses, the blocks must not depend on the order. */
+    for (i = 0; i < np; i++)
+      lnM[i] = g_test_rand_double_range (log (1.0e13), log (1.0e16));
+
+    nc_halo_mass_function_dn_dlnM_vec (test->mfp, test->cosmo, lnM, z, np, res);
+
+    for (i = 0; i < np; i++)
+      ncm_assert_cmpdouble_e (res[i], ==, nc_halo_mass_function_dn_dlnM (test->mfp, test->cosmo, lnM[i], z), 1.0e-12);
+  }
+
+  g_free (lnM);
+  g_free (res);
+}
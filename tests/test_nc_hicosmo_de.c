@@ -34,9 +34,12 @@ typedef struct _TestNcHICosmoDE
 } TestNcHICosmoDE;
 
 void test_nc_hicosmo_de_xcdm_new (TestNcHICosmoDE *test, gconstpointer pdata);
+void test_nc_hicosmo_de_xcdm_massnu_new (TestNcHICosmoDE *test, gconstpointer pdata);
+void test_nc_hicosmo_lcdm_new (TestNcHICosmoDE *test, gconstpointer pdata);
 void test_nc_hicosmo_de_free (TestNcHICosmoDE *test, gconstpointer pdata);
 
 void test_nc_hicosmo_de_omega_x2omega_k (TestNcHICosmoDE *test, gconstpointer pdata);
+void test_nc_hicosmo_de_vec (TestNcHICosmoDE *test, gconstpointer pdata);
 
 gint
 main (gint argc, gchar *argv[])
@@ -50,6 +53,21 @@ main (gint argc, gchar *argv[])
               &test_nc_hicosmo_de_omega_x2omega_k,
               &test_nc_hicosmo_de_free);
 
+  g_test_add ("/nc/hicosmo_de/xcdm/vec", TestNcHICosmoDE, NULL,
+              &test_nc_hicosmo_de_xcdm_new,
+              &test_nc_hicosmo_de_vec,
+              &test_nc_hicosmo_de_free);
+
+  g_test_add ("/nc/hicosmo_de/xcdm/massnu/vec", TestNcHICosmoDE, NULL,
+              &test_nc_hicosmo_de_xcdm_massnu_new,
+              &test_nc_hicosmo_de_vec,
+              &test_nc_hicosmo_de_free);
+
+  g_test_add ("/nc/hicosmo_de/lcdm/vec", TestNcHICosmoDE, NULL,
+              &test_nc_hicosmo_lcdm_new,
+              &test_nc_hicosmo_de_vec,
+              &test_nc_hicosmo_de_free);
+
   g_test_run ();
 }
 
@@ -63,6 +81,25 @@ test_nc_hicosmo_de_xcdm_new (TestNcHICosmoDE *test, gconstpointer pdata)
   g_assert (NC_IS_HICOSMO_DE_XCDM (test->cosmo));
 }
 
+void
+test_nc_hicosmo_de_xcdm_massnu_new (TestNcHICosmoDE *test, gconstpointer pdata)
+{
+  test->cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm{'massnu-length':<1>}");
+
+  g_assert (test->cosmo != NULL);
+  g_assert (NC_IS_HICOSMO_DE_XCDM (test->cosmo));
+  g_assert_cmpuint (nc_hicosmo_NMassNu (test->cosmo), ==, 1);
+}
+
+void
+test_nc_hicosmo_lcdm_new (TestNcHICosmoDE *test, gconstpointer pdata)
+{
+  test->cosmo = NC_HICOSMO (nc_hicosmo_lcdm_new ());
+
+  g_assert (test->cosmo != NULL);
+  g_assert (NC_IS_HICOSMO_LCDM (test->cosmo));
+}
+
 void
 test_nc_hicosmo_de_free (TestNcHICosmoDE *test, gconstpointer pdata)
 {
@@ -99,3 +136,55 @@ test_nc_hicosmo_de_omega_x2omega_k (TestNcHICosmoDE *test, gconstpointer pdata)
     ncm_assert_cmpdouble_e (Omega_k0, ==, 0.0, 1.0e-7);
   }
 }
+
+void
+test_nc_hicosmo_de_vec (TestNcHICosmoDE *test, gconstpointer pdata)
+{
+  const guint len   = 100 + g_test_rand_int_range (0, 100);
+  NcmVector *z      = ncm_vector_new (len);
+  NcmVector *f      = ncm_vector_new (len);
+  NcmMatrix *m      = ncm_matrix_new (len, 2);
+  NcmVector *f_col  = ncm_matrix_get_col (m, 1);
+  guint ntests      = 10;
+  guint i;
+
+  /* The strided output exercises the fallback loop. */
+  g_assert_cmpuint (ncm_vector_stride (f_col), !=, 1);
+
+  while (ntests--)
+  {
+    ncm_model_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_OMEGA_C, g_test_rand_double_range (0.2, 0.3));
+    ncm_model_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_OMEGA_X, g_test_rand_double_range (0.6, 0.8));
+    if (NC_IS_HICOSMO_DE_XCDM (test->cosmo))
+      ncm_model_param_set (NCM_MODEL (test->cosmo), NC_HICOSMO_DE_XCDM_W, g_test_rand_double_range (-1.5, -0.5));
+
+    for (i = 0; i < len; i++)
+      ncm_vector_set (z, i, g_test_rand_double_range (0.0, 1.0e3));
+
+    nc_hicosmo_E2_vec (test->cosmo, z, f);
+    nc_hicosmo_E2_vec (test->cosmo, z, f_col);
+    for (i = 0; i < len; i++)
+    {
+      const gdouble E2 = nc_hicosmo_E2 (test->cosmo, ncm_vector_get (z, i));
+      ncm_assert_cmpdouble_e (ncm_vector_get (f, i), ==, E2, 1.0e-13);
+      ncm_assert_cmpdouble_e (ncm_vector_get (f_col, i), ==, E2, 1.0e-15);
+    }
+
+    nc_hicosmo_E_vec (test->cosmo, z, f);
+    for (i = 0; i < len; i++)
+      ncm_assert_cmpdouble_e (ncm_vector_get (f, i), ==, nc_hicosmo_E (test->cosmo, ncm_vector_get (z, i)), 1.0e-13);
+
+    nc_hicosmo_dE2_dz_vec (test->cosmo, z, f);
+    for (i = 0; i < len; i++)
+      ncm_assert_cmpdouble_e (ncm_vector_get (f, i), ==, nc_hicosmo_dE2_dz (test->cosmo, ncm_vector_get (z, i)), 1.0e-13);
+
+    nc_hicosmo_E2Omega_m_vec (test->cosmo, z, f);
+    for (i = 0; i < len; i++)
+      ncm_assert_cmpdouble_e (ncm_vector_get (f, i), ==, nc_hicosmo_E2Omega_m (test->cosmo, ncm_vector_get (z, i)), 1.0e-13);
+  }
+
+  ncm_vector_free (f_col);
+  ncm_matrix_free (m);
+  ncm_vector_free (f);
+  ncm_vector_free (z);
+}
@@ -0,0 +1,272 @@
+/***************************************************************************
+ *            test_nc_snia_dist_cov.c
+ *
+ *  Fri October 16 23:58:41 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcSNIADistCov
+{
+  NcDistance *dist;
+  NcSNIADistCov *dcov;
+  NcDataSNIACov *snia_cov;
+  NcmMatrix *cov_full;
+  guint mu_len;
+} TestNcSNIADistCov;
+
+static void test_nc_snia_dist_cov_new (TestNcSNIADistCov *test, gconstpointer pdata);
+static void test_nc_snia_dist_cov_packed (TestNcSNIADistCov *test, gconstpointer pdata);
+static void test_nc_snia_dist_cov_calc (TestNcSNIADistCov *test, gconstpointer pdata);
+static void test_nc_snia_dist_cov_free (TestNcSNIADistCov *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/nc/snia_dist_cov/packed", TestNcSNIADistCov, NULL,
+              &test_nc_snia_dist_cov_new,
+              &test_nc_snia_dist_cov_packed,
+              &test_nc_snia_dist_cov_free);
+
+  g_test_add ("/nc/snia_dist_cov/calc", TestNcSNIADistCov, NULL,
+              &test_nc_snia_dist_cov_new,
+              &test_nc_snia_dist_cov_calc,
+              &test_nc_snia_dist_cov_free);
+
+  g_test_run ();
+}
+
+static NcmVector *
+_test_nc_snia_dist_cov_rand_vector (const guint len, const gdouble min, const gdouble max)
+{
+  NcmVector *v = ncm_vector_new (len);
+  guint i;
+
+  for (i = 0; i < len; i++)
+    ncm_vector_set (v, i, g_test_rand_double_range (min, max));
+
+  return v;
+}
+
+static void
+test_nc_snia_dist_cov_new (TestNcSNIADistCov *test, gconstpointer pdata)
+{
+  const guint sigma_int_len = 2;
+  NcmModel *model;
+  GArray *abs_mag_set;
+  NcmMatrix *A;
+  NcmVector *v;
+  guint i;
+
+  /* Odd sizes leave a remainder in every vectorized row. */
+  test->mu_len   = 17 + g_test_rand_int_range (0, 40);
+  test->dist     = nc_distance_new (3.0);
+  test->dcov     = nc_snia_dist_cov_new (test->dist, sigma_int_len);
+  test->snia_cov = NC_DATA_SNIA_COV (nc_data_snia_cov_new (FALSE));
+
+  ncm_data_gauss_cov_set_size (NCM_DATA_GAUSS_COV (test->snia_cov), test->mu_len);
+
+  v = _test_nc_snia_dist_cov_rand_vector (test->mu_len, 0.01, 1.5);
+  nc_data_snia_cov_set_z_cmb (test->snia_cov, v);
+  nc_data_snia_cov_set_z_he (test->snia_cov, v);
+  ncm_vector_free (v);
+
+  v = _test_nc_snia_dist_cov_rand_vector (test->mu_len, 1.0e-4, 1.0e-3);
+  nc_data_snia_cov_set_sigma_z (test->snia_cov, v);
+  ncm_vector_free (v);
+
+  v = _test_nc_snia_dist_cov_rand_vector (test->mu_len, 14.0, 24.0);
+  nc_data_snia_cov_set_mag (test->snia_cov, v);
+  ncm_vector_free (v);
+
+  v = _test_nc_snia_dist_cov_rand_vector (test->mu_len, -3.0, 3.0);
+  nc_data_snia_cov_set_width (test->snia_cov, v);
+  ncm_vector_free (v);
+
+  v = _test_nc_snia_dist_cov_rand_vector (test->mu_len, -0.3, 0.3);
+  nc_data_snia_cov_set_colour (test->snia_cov, v);
+  ncm_vector_free (v);
+
+  v = _test_nc_snia_dist_cov_rand_vector (test->mu_len, 9.0, 11.0);
+  nc_data_snia_cov_set_thirdpar (test->snia_cov, v);
+  ncm_vector_free (v);
+
+  abs_mag_set = g_array_sized_new (FALSE, FALSE, sizeof (guint32), test->mu_len);
+  for (i = 0; i < test->mu_len; i++)
+  {
+    const guint32 dset_id = i % sigma_int_len;
+    g_array_append_val (abs_mag_set, dset_id);
+  }
+  nc_data_snia_cov_set_abs_mag_set (test->snia_cov, abs_mag_set);
+  g_array_unref (abs_mag_set);
+
+  /* Dense positive definite covariance, all the per-SN blocks are filled. */
+  A              = ncm_matrix_new (3 * test->mu_len, 3 * test->mu_len);
+  test->cov_full = ncm_matrix_new (3 * test->mu_len, 3 * test->mu_len);
+  for (i = 0; i < 3 * test->mu_len; i++)
+  {
+    guint j;
+
+    for (j = 0; j < 3 * test->mu_len; j++)
+      ncm_matrix_set (A, i, j, g_test_rand_double_range (-1.0e-2, 1.0e-2));
+  }
+  for (i = 0; i < 3 * test->mu_len; i++)
+  {
+    guint j, k;
+
+    for (j = 0; j < 3 * test->mu_len; j++)
+    {
+      gdouble AAT_ij = (i == j) ? 1.0e-2 : 0.0;
+
+      for (k = 0; k < 3 * test->mu_len; k++)
+        AAT_ij += ncm_matrix_get (A, i, k) * ncm_matrix_get (A, j, k);
+
+      ncm_matrix_set (test->cov_full, i, j, AAT_ij);
+    }
+  }
+  ncm_matrix_free (A);
+
+  nc_data_snia_cov_set_cov_full (test->snia_cov, test->cov_full);
+  g_assert (NCM_DATA (test->snia_cov)->init);
+
+  model = NCM_MODEL (test->dcov);
+  ncm_model_orig_param_set (model, NC_SNIA_DIST_COV_ALPHA, g_test_rand_double_range (0.1, 0.2));
+  ncm_model_orig_param_set (model, NC_SNIA_DIST_COV_BETA, g_test_rand_double_range (2.5, 3.5));
+  ncm_model_orig_param_set (model, NC_SNIA_DIST_COV_LNSIGMA_PECZ, log (g_test_rand_double_range (1.0e-4, 1.0e-3)));
+  ncm_model_orig_param_set (model, NC_SNIA_DIST_COV_LNSIGMA_LENS, log (g_test_rand_double_range (0.05, 0.1)));
+  for (i = 0; i < sigma_int_len; i++)
+    ncm_model_orig_vparam_set (model, NC_SNIA_DIST_COV_LNSIGMA_INT, i, log (g_test_rand_double_range (0.05, 0.15)));
+}
+
+static void
+test_nc_snia_dist_cov_free (TestNcSNIADistCov *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (ncm_matrix_free, test->cov_full);
+  NCM_TEST_FREE (ncm_data_free, NCM_DATA (test->snia_cov));
+  NCM_TEST_FREE (nc_snia_dist_cov_free, test->dcov);
+  NCM_TEST_FREE (nc_distance_free, test->dist);
+}
+
+/*
+ * Each component of cov_packed is a contiguous upper triangle of length
+ * uppertri_len, the element (i, j) of component c is at
+ * c * uppertri_len + ij.
+ */
+static void
+test_nc_snia_dist_cov_packed (TestNcSNIADistCov *test, gconstpointer pdata)
+{
+  const guint mu_len                = test->mu_len;
+  const guint tri_len               = test->snia_cov->uppertri_len;
+  const guint comp[][2]             = {{0, 0}, {0, 1}, {0, 2}, {1, 1}, {1, 2}, {2, 2}};
+  const NcDataSNIACovOrder order[]  = {
+    NC_DATA_SNIA_COV_ORDER_MAG_MAG,     NC_DATA_SNIA_COV_ORDER_MAG_WIDTH,    NC_DATA_SNIA_COV_ORDER_MAG_COLOUR,
+    NC_DATA_SNIA_COV_ORDER_WIDTH_WIDTH, NC_DATA_SNIA_COV_ORDER_WIDTH_COLOUR, NC_DATA_SNIA_COV_ORDER_COLOUR_COLOUR,
+  };
+  guint c;
+
+  g_assert_cmpuint (tri_len, ==, mu_len * (mu_len + 1) / 2);
+  g_assert_cmpuint (ncm_vector_len (test->snia_cov->cov_packed), ==, NC_DATA_SNIA_COV_ORDER_LENGTH * tri_len);
+
+  for (c = 0; c < NC_DATA_SNIA_COV_ORDER_LENGTH; c++)
+  {
+    const guint a = comp[c][0];
+    const guint b = comp[c][1];
+    guint i, j, ij = 0;
+
+    for (i = 0; i < mu_len; i++)
+    {
+      for (j = i; j < mu_len; j++)
+      {
+        const gdouble C_ij = 0.5 * (ncm_matrix_get (test->cov_full, a * mu_len + i, b * mu_len + j) +
+                                    ncm_matrix_get (test->cov_full, a * mu_len + j, b * mu_len + i));
+
+        ncm_assert_cmpdouble (ncm_vector_get (test->snia_cov->cov_packed, order[c] * tri_len + ij), ==, C_ij);
+        ij++;
+      }
+    }
+  }
+}
+
+/*
+ * Builds the upper triangle directly from the per-SN blocks of cov_full,
+ * Cov (mu_i, mu_j) = v^T C_ij v with v = (1, alpha, -beta), and compares
+ * it element-wise with nc_snia_dist_cov_calc().
+ */
+static void
+test_nc_snia_dist_cov_calc (TestNcSNIADistCov *test, gconstpointer pdata)
+{
+  const guint mu_len = test->mu_len;
+  NcmMatrix *cov     = ncm_matrix_new (mu_len, mu_len);
+  gdouble alpha, beta;
+  guint i, j;
+
+  nc_snia_dist_cov_alpha_beta (test->dcov, &alpha, &beta);
+  nc_snia_dist_cov_calc (test->dcov, test->snia_cov, cov);
+
+  {
+    const gdouble v[3] = {1.0, alpha, -beta};
+
+    for (i = 0; i < mu_len; i++)
+    {
+      for (j = i; j < mu_len; j++)
+      {
+        gdouble cov_ij = 0.0;
+        gdouble scale  = 0.0;
+        guint a, b;
+
+        for (a = 0; a < 3; a++)
+        {
+          for (b = 0; b < 3; b++)
+          {
+            const gdouble t = v[a] * v[b] * ncm_matrix_get (test->cov_full, a * mu_len + i, b * mu_len + j);
+
+            cov_ij += t;
+            scale  += fabs (t);
+          }
+        }
+
+        if (i == j)
+        {
+          const gdouble var_tot = nc_snia_dist_cov_extra_var (test->dcov, test->snia_cov, i);
+
+          cov_ij += var_tot;
+          scale  += var_tot;
+        }
+
+        g_assert_cmpfloat (fabs (ncm_matrix_get (cov, i, j) - cov_ij), <=, 1.0e-13 * scale);
+      }
+    }
+  }
+
+  ncm_matrix_free (cov);
+}
@@ -0,0 +1,263 @@
+/***************************************************************************
+ *            test_nc_xcor.c
+ *
+ *  Fri October 16 21:05:12 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <gsl/gsl_integration.h>
+
+/* Relative tolerance of the shared grid with respect to the adaptive integral. */
+#define TEST_NC_XCOR_RELTOL (1.0e-6)
+
+typedef struct _TestNcXcor
+{
+  NcHICosmo *cosmo;
+  NcDistance *dist;
+  NcTransferFunc *tf;
+  NcGrowthFunc *gf;
+  NcXcor *xc;
+  NcXcor *xc_mt;
+  NcXcorLimber *gal1;
+  NcXcorLimber *gal2;
+  NcmVector *ell;
+} TestNcXcor;
+
+static void test_nc_xcor_new (TestNcXcor *test, gconstpointer pdata);
+static void test_nc_xcor_auto_cl (TestNcXcor *test, gconstpointer pdata);
+static void test_nc_xcor_cross_cl (TestNcXcor *test, gconstpointer pdata);
+static void test_nc_xcor_threaded (TestNcXcor *test, gconstpointer pdata);
+static void test_nc_xcor_free (TestNcXcor *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  ncm_func_eval_set_max_threads (4);
+
+  g_test_add ("/nc/xcor/limber/auto_cl", TestNcXcor, NULL,
+              &test_nc_xcor_new,
+              &test_nc_xcor_auto_cl,
+              &test_nc_xcor_free);
+
+  g_test_add ("/nc/xcor/limber/cross_cl", TestNcXcor, NULL,
+              &test_nc_xcor_new,
+              &test_nc_xcor_cross_cl,
+              &test_nc_xcor_free);
+
+  g_test_add ("/nc/xcor/limber/threaded", TestNcXcor, NULL,
+              &test_nc_xcor_new,
+              &test_nc_xcor_threaded,
+              &test_nc_xcor_free);
+
+  g_test_run ();
+}
+
+static NcXcorLimber *
+_test_nc_xcor_gal_new (gdouble z_min, gdouble z_max)
+{
+  NcXcorLimber *gal = g_object_new (NC_TYPE_XCOR_LIMBER_GAL, "zmin", z_min, "zmax", z_max, NULL);
+  GArray *z         = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  GArray *dN_dz     = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  const gdouble z_c = 0.5 * (z_min + z_max);
+  const gdouble sz  = 0.5 * (z_max - z_min);
+  guint i;
+
+  /* Does not vanish at the support limits, the kernel is discontinuous there. */
+  for (i = 0; i < 200; i++)
+  {
+    const gdouble z_i = z_min + (z_max - z_min) * i / 199.0;
+    const gdouble n_i = exp (-0.5 * gsl_pow_2 ((z_i - z_c) / sz));
+
+    g_array_append_val (z, z_i);
+    g_array_append_val (dN_dz, n_i);
+  }
+
+  nc_xcor_limber_gal_set_dNdz (NC_XCOR_LIMBER_GAL (gal), z, dN_dz);
+
+  g_array_unref (z);
+  g_array_unref (dN_dz);
+
+  return gal;
+}
+
+static void
+test_nc_xcor_new (TestNcXcor *test, gconstpointer pdata)
+{
+  const guint nell = 50;
+  guint i;
+
+  test->cosmo = NC_HICOSMO (nc_hicosmo_de_xcdm_new ());
+  test->dist  = nc_distance_new (3.0);
+  test->tf    = nc_transfer_func_eh_new ();
+  test->gf    = nc_growth_func_new ();
+  test->xc    = nc_xcor_new (test->dist, test->tf, test->gf, 0.1, 3.0);
+  test->xc_mt = nc_xcor_new (test->dist, test->tf, test->gf, 0.1, 3.0);
+  test->gal1  = _test_nc_xcor_gal_new (0.3, 1.2);
+  test->gal2  = _test_nc_xcor_gal_new (0.8, 2.0);
+  test->ell   = ncm_vector_new (nell);
+
+  /* The normalization is not set by NcXcor, any value works for the comparisons. */
+  test->xc->normPS    = 1.0;
+  test->xc_mt->normPS = 1.0;
+
+  nc_xcor_set_threaded (test->xc_mt, TRUE);
+
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "Omegax", g_test_rand_double_range (0.65, 0.75));
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "w", g_test_rand_double_range (-1.2, -0.8));
+
+  for (i = 0; i < nell; i++)
+    ncm_vector_set (test->ell, i, 2 + 20 * i);
+}
+
+static void
+test_nc_xcor_free (TestNcXcor *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (nc_xcor_free, test->xc);
+  NCM_TEST_FREE (nc_xcor_free, test->xc_mt);
+  NCM_TEST_FREE (nc_xcor_limber_free, test->gal1);
+  NCM_TEST_FREE (nc_xcor_limber_free, test->gal2);
+  NCM_TEST_FREE (nc_growth_func_free, test->gf);
+  NCM_TEST_FREE (nc_transfer_func_free, test->tf);
+  NCM_TEST_FREE (nc_distance_free, test->dist);
+  NCM_TEST_FREE (nc_hicosmo_free, test->cosmo);
+
+  ncm_vector_free (test->ell);
+}
+
+typedef struct _TestNcXcorInt
+{
+  TestNcXcor *test;
+  NcXcorLimber *xcl1;
+  NcXcorLimber *xcl2;
+  gdouble ell;
+} TestNcXcorInt;
+
+static gdouble
+_test_nc_xcor_cl_int (gdouble z, gpointer userdata)
+{
+  TestNcXcorInt *ci  = (TestNcXcorInt *) userdata;
+  TestNcXcor *test   = ci->test;
+  const gdouble xi_z = nc_distance_comoving (test->dist, test->cosmo, z);
+  const gdouble kh   = (ci->ell + 0.5) / (xi_z * ncm_c_hubble_radius_hm1_Mpc ());
+  const gdouble t_k  = nc_transfer_func_eval (test->tf, test->cosmo, kh);
+  const gdouble D_z  = nc_growth_func_eval (test->gf, test->cosmo, z);
+  const gdouble k1z  = nc_xcor_limber_eval_kernel (ci->xcl1, test->cosmo, z, 0);
+  const gdouble k2z  = nc_xcor_limber_eval_kernel (ci->xcl2, test->cosmo, z, 0);
+
+  return nc_hicosmo_E (test->cosmo, z) * k1z * k2z * gsl_pow_2 (t_k * D_z / xi_z);
+}
+
+static void
+_test_nc_xcor_cmp_qag (TestNcXcor *test, NcXcorLimber *xcl1, NcXcorLimber *xcl2, NcmVector *vp, guint lmin_idx, gdouble za, gdouble zb)
+{
+  gsl_integration_workspace *ws = gsl_integration_workspace_alloc (1000);
+  const gdouble cons_factor     = xcl1->cons_factor * xcl2->cons_factor * gsl_pow_3 (1.0e5 / ncm_c_c ());
+  TestNcXcorInt ci              = {test, xcl1, xcl2, 0.0};
+  gsl_function F;
+  guint i;
+
+  F.function = &_test_nc_xcor_cl_int;
+  F.params   = &ci;
+
+  for (i = 0; i < ncm_vector_len (test->ell); i++)
+  {
+    gdouble cl, err;
+
+    ci.ell = ncm_vector_get (test->ell, i);
+    gsl_integration_qag (&F, za, zb, 0.0, 1.0e-10, 1000, GSL_INTEG_GAUSS61, ws, &cl, &err);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (vp, lmin_idx + i), ==, cons_factor * test->xc->normPS * cl, TEST_NC_XCOR_RELTOL);
+  }
+
+  gsl_integration_workspace_free (ws);
+}
+
+static void
+test_nc_xcor_auto_cl (TestNcXcor *test, gconstpointer pdata)
+{
+  const guint lmin_idx = 3;
+  NcmVector *vp        = ncm_vector_new (ncm_vector_len (test->ell) + lmin_idx);
+
+  nc_xcor_limber_auto_cl (test->xc, test->gal1, test->cosmo, test->ell, vp, lmin_idx, FALSE);
+  _test_nc_xcor_cmp_qag (test, test->gal1, test->gal1, vp, lmin_idx, 0.3, 1.2);
+
+  /* A second tracer adds panel edges, the first spectrum is recomputed on the new grid. */
+  nc_xcor_limber_auto_cl (test->xc, test->gal2, test->cosmo, test->ell, vp, lmin_idx, FALSE);
+  _test_nc_xcor_cmp_qag (test, test->gal2, test->gal2, vp, lmin_idx, 0.8, 2.0);
+
+  nc_xcor_limber_auto_cl (test->xc, test->gal1, test->cosmo, test->ell, vp, lmin_idx, FALSE);
+  _test_nc_xcor_cmp_qag (test, test->gal1, test->gal1, vp, lmin_idx, 0.3, 1.2);
+
+  ncm_vector_free (vp);
+}
+
+static void
+test_nc_xcor_cross_cl (TestNcXcor *test, gconstpointer pdata)
+{
+  NcmVector *vp = ncm_vector_new (ncm_vector_len (test->ell));
+
+  nc_xcor_limber_cross_cl (test->xc, test->gal1, test->gal2, test->cosmo, test->ell, vp, 0);
+  _test_nc_xcor_cmp_qag (test, test->gal1, test->gal2, vp, 0, 0.8, 1.2);
+
+  /* New model. */
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "w", -1.0);
+
+  nc_xcor_limber_cross_cl (test->xc, test->gal1, test->gal2, test->cosmo, test->ell, vp, 0);
+  _test_nc_xcor_cmp_qag (test, test->gal1, test->gal2, vp, 0, 0.8, 1.2);
+
+  ncm_vector_free (vp);
+}
+
+static void
+test_nc_xcor_threaded (TestNcXcor *test, gconstpointer pdata)
+{
+  const guint nell = ncm_vector_len (test->ell);
+  NcmVector *vp    = ncm_vector_new (nell);
+  NcmVector *vp_mt = ncm_vector_new (nell);
+  guint i;
+
+  nc_xcor_limber_auto_cl (test->xc, test->gal1, test->cosmo, test->ell, vp, 0, FALSE);
+  nc_xcor_limber_auto_cl (test->xc_mt, test->gal1, test->cosmo, test->ell, vp_mt, 0, FALSE);
+
+  for (i = 0; i < nell; i++)
+    g_assert_cmpfloat (ncm_vector_get (vp, i), ==, ncm_vector_get (vp_mt, i));
+
+  nc_xcor_limber_cross_cl (test->xc, test->gal1, test->gal2, test->cosmo, test->ell, vp, 0);
+  nc_xcor_limber_cross_cl (test->xc_mt, test->gal1, test->gal2, test->cosmo, test->ell, vp_mt, 0);
+
+  for (i = 0; i < nell; i++)
+    g_assert_cmpfloat (ncm_vector_get (vp, i), ==, ncm_vector_get (vp_mt, i));
+
+  ncm_vector_free (vp);
+  ncm_vector_free (vp_mt);
+}
@@ -0,0 +1,306 @@
+/***************************************************************************
+ *            test_ncm_abc.c
+ *
+ *  Fri October 16 21:05:12 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+/*
+ * Minimal ABC implementation: the distance is the normalized distance
+ * of the try point to a fixed point plus a small noise, the dataset is
+ * empty.
+ */
+
+#define TEST_TYPE_NCM_ABC (test_ncm_abc_get_type ())
+
+typedef struct _TestNcmABCClass
+{
+  NcmABCClass parent_class;
+} TestNcmABCClass;
+
+typedef struct _TestNcmABC
+{
+  NcmABC parent_instance;
+} TestNcmABC;
+
+GType test_ncm_abc_get_type (void) G_GNUC_CONST;
+
+G_DEFINE_TYPE (TestNcmABC, test_ncm_abc, NCM_TYPE_ABC);
+
+static const gdouble test_ncm_abc_theta0[] = {0.7, -1.0};
+static const gdouble test_ncm_abc_sigma[]  = {0.1, 0.3};
+
+static void
+test_ncm_abc_init (TestNcmABC *tabc)
+{
+}
+
+static gboolean
+_test_ncm_abc_data_summary (NcmABC *abc)
+{
+  return TRUE;
+}
+
+static gdouble
+_test_ncm_abc_mock_distance (NcmABC *abc, NcmDataset *dset, NcmVector *theta, NcmVector *thetastar, NcmRNG *rng)
+{
+  gdouble d2 = 0.0;
+  guint i;
+
+  for (i = 0; i < ncm_vector_len (thetastar); i++)
+    d2 += gsl_pow_2 ((ncm_vector_get (thetastar, i) - test_ncm_abc_theta0[i]) / test_ncm_abc_sigma[i]);
+
+  return sqrt (d2) + fabs (gsl_ran_gaussian (rng->r, 1.0e-2));
+}
+
+static gdouble
+_test_ncm_abc_distance_prob (NcmABC *abc, gdouble distance)
+{
+  return (distance < abc->epsilon) ? 1.0 : 0.0;
+}
+
+static void
+_test_ncm_abc_update_tkern (NcmABC *abc)
+{
+  ncm_mset_catalog_get_covar (abc->mcat, &abc->covar);
+  ncm_matrix_scale (abc->covar, 2.0);
+  ncm_mset_trans_kern_gauss_set_cov (NCM_MSET_TRANS_KERN_GAUSS (abc->tkern), abc->covar);
+
+  ncm_abc_update_epsilon (abc, ncm_abc_get_dist_quantile (abc, 0.5));
+}
+
+static const gchar *
+_test_ncm_abc_get_desc (NcmABC *abc)
+{
+  return "TestNcmABC";
+}
+
+static const gchar *
+_test_ncm_abc_log_info (NcmABC *abc)
+{
+  return "TestNcmABC";
+}
+
+static void
+test_ncm_abc_class_init (TestNcmABCClass *klass)
+{
+  NcmABCClass *abc_class = NCM_ABC_CLASS (klass);
+
+  abc_class->data_summary  = &_test_ncm_abc_data_summary;
+  abc_class->mock_distance = &_test_ncm_abc_mock_distance;
+  abc_class->distance_prob = &_test_ncm_abc_distance_prob;
+  abc_class->update_tkern  = &_test_ncm_abc_update_tkern;
+  abc_class->get_desc      = &_test_ncm_abc_get_desc;
+  abc_class->log_info      = &_test_ncm_abc_log_info;
+}
+
+typedef struct _TestNcmABCConf
+{
+  gdouble nsigma;
+  guint nthreads;
+} TestNcmABCConf;
+
+typedef struct _TestNcmABCFix
+{
+  NcmMSet *mset;
+  NcmMSetTransKern *prior;
+  NcmMSetTransKernGauss *tkerng;
+  NcmDataset *dset;
+  NcmABC *abc;
+  guint nparticles;
+} TestNcmABCFix;
+
+static void test_ncm_abc_new (TestNcmABCFix *test, gconstpointer pdata);
+static void test_ncm_abc_batch_weights (TestNcmABCFix *test, gconstpointer pdata);
+static void test_ncm_abc_batch_weights_small_trunc (TestNcmABCFix *test, gconstpointer pdata);
+static void test_ncm_abc_free (TestNcmABCFix *test, gconstpointer pdata);
+
+static const TestNcmABCConf test_ncm_abc_full     = {0.0, 1};
+static const TestNcmABCConf test_ncm_abc_trunc    = {10.0, 1};
+static const TestNcmABCConf test_ncm_abc_full_mt  = {0.0, 4};
+static const TestNcmABCConf test_ncm_abc_trunc_mt = {10.0, 4};
+static const TestNcmABCConf test_ncm_abc_small    = {1.0, 1};
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/abc/batch_weights/full", TestNcmABCFix, &test_ncm_abc_full,
+              &test_ncm_abc_new,
+              &test_ncm_abc_batch_weights,
+              &test_ncm_abc_free);
+
+  g_test_add ("/ncm/abc/batch_weights/trunc", TestNcmABCFix, &test_ncm_abc_trunc,
+              &test_ncm_abc_new,
+              &test_ncm_abc_batch_weights,
+              &test_ncm_abc_free);
+
+  g_test_add ("/ncm/abc/batch_weights/full/mt", TestNcmABCFix, &test_ncm_abc_full_mt,
+              &test_ncm_abc_new,
+              &test_ncm_abc_batch_weights,
+              &test_ncm_abc_free);
+
+  g_test_add ("/ncm/abc/batch_weights/trunc/mt", TestNcmABCFix, &test_ncm_abc_trunc_mt,
+              &test_ncm_abc_new,
+              &test_ncm_abc_batch_weights,
+              &test_ncm_abc_free);
+
+  g_test_add ("/ncm/abc/batch_weights/small_trunc", TestNcmABCFix, &test_ncm_abc_small,
+              &test_ncm_abc_new,
+              &test_ncm_abc_batch_weights_small_trunc,
+              &test_ncm_abc_free);
+
+  g_test_run ();
+}
+
+static void
+test_ncm_abc_new (TestNcmABCFix *test, gconstpointer pdata)
+{
+  const TestNcmABCConf *conf = pdata;
+  NcHICosmo *cosmo           = NC_HICOSMO (nc_hicosmo_de_xcdm_new ());
+  NcmRNG *rng                = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+
+  test->nparticles = 200 + g_test_rand_int_range (0, 100);
+  test->mset       = ncm_mset_new (cosmo, NULL);
+  test->dset       = ncm_dataset_new ();
+
+  ncm_mset_param_set_ftype (test->mset, nc_hicosmo_id (), NC_HICOSMO_DE_OMEGA_X, NCM_PARAM_TYPE_FREE);
+  ncm_mset_param_set_ftype (test->mset, nc_hicosmo_id (), NC_HICOSMO_DE_XCDM_W,  NCM_PARAM_TYPE_FREE);
+  ncm_mset_prepare_fparam_map (test->mset);
+
+  test->prior = NCM_MSET_TRANS_KERN (ncm_mset_trans_kern_flat_new ());
+  ncm_mset_trans_kern_set_mset (test->prior, test->mset);
+  ncm_mset_trans_kern_set_prior_from_mset (test->prior);
+
+  test->tkerng = ncm_mset_trans_kern_gauss_new (0);
+  ncm_mset_trans_kern_set_mset (NCM_MSET_TRANS_KERN (test->tkerng), test->mset);
+  ncm_mset_trans_kern_gauss_set_cov_from_scale (test->tkerng);
+
+  test->abc = g_object_new (TEST_TYPE_NCM_ABC,
+                            "mset", test->mset,
+                            "prior", test->prior,
+                            "data-set", test->dset,
+                            NULL);
+
+  ncm_abc_set_trans_kern (test->abc, NCM_MSET_TRANS_KERN (test->tkerng));
+  ncm_abc_set_rng (test->abc, rng);
+  ncm_abc_set_nthreads (test->abc, conf->nthreads);
+  ncm_abc_set_weight_trunc (test->abc, conf->nsigma);
+
+  /* Initial population sampled from the prior, then one update. */
+  ncm_abc_start_run (test->abc);
+  ncm_abc_run (test->abc, test->nparticles);
+  ncm_abc_end_run (test->abc);
+
+  ncm_abc_start_update (test->abc);
+  ncm_abc_update (test->abc);
+
+  g_assert_cmpuint (ncm_mset_catalog_len (test->abc->mcat), ==, 2 * test->nparticles);
+
+  ncm_rng_free (rng);
+  nc_hicosmo_free (cosmo);
+}
+
+static void
+test_ncm_abc_free (TestNcmABCFix *test, gconstpointer pdata)
+{
+  ncm_abc_end_update (test->abc);
+
+  NCM_TEST_FREE (ncm_abc_free, test->abc);
+  NCM_TEST_FREE (ncm_mset_trans_kern_free, NCM_MSET_TRANS_KERN (test->tkerng));
+  NCM_TEST_FREE (ncm_mset_trans_kern_free, test->prior);
+  NCM_TEST_FREE (ncm_dataset_free, test->dset);
+  NCM_TEST_FREE (ncm_mset_free, test->mset);
+}
+
+/*
+ * Direct (unnormalized) weight of the np-th particle of the update:
+ * prior (theta*) / sum_k w_k K (theta_k, theta*).
+ */
+static gdouble
+_test_ncm_abc_direct_weight (TestNcmABCFix *test, guint np)
+{
+  NcmABC *abc            = test->abc;
+  NcmVector *row_star    = ncm_mset_catalog_peek_row (abc->mcat, test->nparticles + np);
+  NcmVector *thetastar   = ncm_vector_get_subvector (row_star, 2, ncm_vector_len (row_star) - 2);
+  gdouble denom          = 0.0;
+  gdouble weight;
+  guint k;
+
+  for (k = 0; k < test->nparticles; k++)
+  {
+    NcmVector *row   = ncm_mset_catalog_peek_row (abc->mcat, k);
+    NcmVector *theta = ncm_vector_get_subvector (row, 2, ncm_vector_len (row) - 2);
+
+    denom += g_array_index (abc->weights_tm1, gdouble, k) * ncm_mset_trans_kern_pdf (abc->tkern, theta, thetastar);
+    ncm_vector_free (theta);
+  }
+
+  weight = ncm_mset_trans_kern_prior_pdf (abc->prior, thetastar) / denom;
+  ncm_vector_free (thetastar);
+
+  return weight;
+}
+
+static void
+test_ncm_abc_batch_weights (TestNcmABCFix *test, gconstpointer pdata)
+{
+  guint j;
+
+  /* Before ncm_abc_end_update() the weights are not normalized. */
+  for (j = 0; j < test->nparticles; j++)
+  {
+    const gdouble w_batch  = g_array_index (test->abc->weights, gdouble, j);
+    const gdouble w_direct = _test_ncm_abc_direct_weight (test, j);
+
+    g_assert (gsl_finite (w_batch));
+    ncm_assert_cmpdouble_e (w_batch, ==, w_direct, 1.0e-8);
+  }
+}
+
+static void
+test_ncm_abc_batch_weights_small_trunc (TestNcmABCFix *test, gconstpointer pdata)
+{
+  guint j;
+
+  /* Truncation removes positive terms from the kernel sum. */
+  for (j = 0; j < test->nparticles; j++)
+  {
+    const gdouble w_batch  = g_array_index (test->abc->weights, gdouble, j);
+    const gdouble w_direct = _test_ncm_abc_direct_weight (test, j);
+
+    g_assert (gsl_finite (w_batch));
+    g_assert_cmpfloat (w_batch, >, 0.0);
+    g_assert_cmpfloat (w_batch, >=, w_direct * (1.0 - 1.0e-8));
+  }
+}
@@ -42,6 +42,9 @@ void test_ncm_data_gauss_cov_test_new (TestNcmDataGaussCovTest *test, gconstpoin
 void test_ncm_data_gauss_cov_test_free (TestNcmDataGaussCovTest *test, gconstpointer pdata);
 void test_ncm_data_gauss_cov_test_sanity (TestNcmDataGaussCovTest *test, gconstpointer pdata);
 void test_ncm_data_gauss_cov_test_resample (TestNcmDataGaussCovTest *test, gconstpointer pdata);
+void test_ncm_data_gauss_cov_test_share_immutable (TestNcmDataGaussCovTest *test, gconstpointer pdata);
+void test_ncm_data_gauss_cov_test_lowrank (TestNcmDataGaussCovTest *test, gconstpointer pdata);
+void test_ncm_data_gauss_cov_test_batch (TestNcmDataGaussCovTest *test, gconstpointer pdata);
 
 gint
 main (gint argc, gchar *argv[])
@@ -60,6 +63,21 @@ main (gint argc, gchar *argv[])
               &test_ncm_data_gauss_cov_test_resample,
               &test_ncm_data_gauss_cov_test_free);
 
+  g_test_add ("/ncm/data_gauss_cov_test/share_immutable", TestNcmDataGaussCovTest, NULL,
+              &test_ncm_data_gauss_cov_test_new,
+              &test_ncm_data_gauss_cov_test_share_immutable,
+              &test_ncm_data_gauss_cov_test_free);
+
+  g_test_add ("/ncm/data_gauss_cov_test/lowrank", TestNcmDataGaussCovTest, NULL,
+              &test_ncm_data_gauss_cov_test_new,
+              &test_ncm_data_gauss_cov_test_lowrank,
+              &test_ncm_data_gauss_cov_test_free);
+
+  g_test_add ("/ncm/data_gauss_cov_test/batch", TestNcmDataGaussCovTest, NULL,
+              &test_ncm_data_gauss_cov_test_new,
+              &test_ncm_data_gauss_cov_test_batch,
+              &test_ncm_data_gauss_cov_test_free);
+
   g_test_run ();
 }
 
@@ -160,3 +178,156 @@ test_ncm_data_gauss_cov_test_resample (TestNcmDataGaussCovTest *test, gconstpoin
   ncm_stats_vec_clear (&stat);
   ncm_vector_clear (&mean);
 }
+
+void
+test_ncm_data_gauss_cov_test_share_immutable (TestNcmDataGaussCovTest *test, gconstpointer pdata)
+{
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (test->data);
+  NcmSerialize *ser      = ncm_serialize_new (NCM_SERIALIZE_OPT_CLEAN_DUP);
+  NcmData *data_dup      = ncm_data_dup (test->data, ser);
+  NcmDataGaussCov *gauss_dup;
+
+  gauss_dup = NCM_DATA_GAUSS_COV (data_dup);
+  g_assert (gauss_dup->y != gauss->y);
+  g_assert (gauss_dup->cov != gauss->cov);
+  NCM_TEST_FREE (ncm_data_free, data_dup);
+
+  ncm_serialize_reset (ser, TRUE);
+  ncm_data_share_immutable (test->data, ser);
+
+  data_dup  = ncm_data_dup (test->data, ser);
+  gauss_dup = NCM_DATA_GAUSS_COV (data_dup);
+  g_assert (gauss_dup->y == gauss->y);
+  g_assert (gauss_dup->cov == gauss->cov);
+
+  /* The scratch space is allocated during the evaluation and must not be shared. */
+  {
+    gdouble m2lnL, m2lnL_dup;
+
+    ncm_data_m2lnL_val (test->data, NULL, &m2lnL);
+    ncm_data_m2lnL_val (data_dup, NULL, &m2lnL_dup);
+    ncm_assert_cmpdouble (m2lnL, ==, m2lnL_dup);
+
+    g_assert (gauss->v != NULL);
+    g_assert (gauss->LLT != NULL);
+    g_assert (gauss_dup->v != gauss->v);
+    g_assert (gauss_dup->LLT != gauss->LLT);
+  }
+
+  NCM_TEST_FREE (ncm_data_free, data_dup);
+  ncm_serialize_clear (&ser);
+}
+
+void
+test_ncm_data_gauss_cov_test_lowrank (TestNcmDataGaussCovTest *test, gconstpointer pdata)
+{
+  NcmDataGaussCov *gauss = NCM_DATA_GAUSS_COV (test->data);
+  const guint r          = g_test_rand_int_range (1, 5);
+  NcmMatrix *U           = ncm_matrix_new (gauss->np, r);
+  NcmMatrix *A           = ncm_matrix_new (r, r);
+  NcmMatrix *cov0        = ncm_matrix_dup (gauss->cov);
+  NcmVector *f           = ncm_vector_new (gauss->np);
+  gdouble m2lnL_lr, m2lnL, chi2_lr, chi2_f;
+  gdouble var_min = GSL_POSINF;
+  gint ret;
+  guint i, j;
+
+  for (i = 0; i < gauss->np; i++)
+    var_min = GSL_MIN (var_min, ncm_matrix_get (gauss->cov, i, i));
+
+  for (i = 0; i < gauss->np; i++)
+    for (j = 0; j < r; j++)
+      ncm_matrix_set (U, i, j, g_test_rand_double_range (-1.0, 1.0) * sqrt (var_min));
+
+  for (i = 0; i < r; i++)
+    for (j = 0; j < r; j++)
+      ncm_matrix_set (A, i, j, g_test_rand_double_range (-1.0, 1.0));
+
+  /* S = A A^T is positive semi-definite, so C_0 + U S U^T is positive definite. */
+  test->gcov_test->S = ncm_matrix_new (r, r);
+  ret = gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1.0, ncm_matrix_gsl (A), ncm_matrix_gsl (A), 0.0, ncm_matrix_gsl (test->gcov_test->S));
+  NCM_TEST_GSL_RESULT ("test_ncm_data_gauss_cov_test_lowrank", ret);
+
+  g_object_set (test->data, "use-norma", TRUE, NULL);
+  ncm_data_gauss_cov_set_lowrank (gauss, U);
+  g_assert (ncm_data_gauss_cov_peek_lowrank (gauss) == U);
+
+  ncm_data_m2lnL_val (test->data, NULL, &m2lnL_lr);
+
+  /* Second evaluation reuses the cached decomposition of C_0. */
+  ncm_data_m2lnL_val (test->data, NULL, &m2lnL);
+  ncm_assert_cmpdouble_e (m2lnL, ==, m2lnL_lr, 1.0e-14);
+
+  g_object_set (test->data, "use-norma", FALSE, NULL);
+  ncm_data_m2lnL_val (test->data, NULL, &chi2_lr);
+  ncm_data_leastsquares_f (test->data, NULL, f);
+  ret = gsl_blas_ddot (ncm_vector_gsl (f), ncm_vector_gsl (f), &chi2_f);
+  NCM_TEST_GSL_RESULT ("test_ncm_data_gauss_cov_test_lowrank", ret);
+  ncm_assert_cmpdouble_e (chi2_f, ==, chi2_lr, 1.0e-10);
+
+  /* Same likelihood computed with the complete covariance. */
+  ncm_data_gauss_cov_set_lowrank (gauss, NULL);
+  {
+    NcmMatrix *US = ncm_matrix_new (gauss->np, r);
+
+    ret = gsl_blas_dgemm (CblasNoTrans, CblasNoTrans, 1.0, ncm_matrix_gsl (U), ncm_matrix_gsl (test->gcov_test->S), 0.0, ncm_matrix_gsl (US));
+    NCM_TEST_GSL_RESULT ("test_ncm_data_gauss_cov_test_lowrank", ret);
+    ret = gsl_blas_dgemm (CblasNoTrans, CblasTrans, 1.0, ncm_matrix_gsl (US), ncm_matrix_gsl (U), 1.0, ncm_matrix_gsl (gauss->cov));
+    NCM_TEST_GSL_RESULT ("test_ncm_data_gauss_cov_test_lowrank", ret);
+
+    ncm_matrix_free (US);
+  }
+
+  ncm_data_m2lnL_val (test->data, NULL, &m2lnL);
+  ncm_assert_cmpdouble_e (m2lnL, ==, chi2_lr, 1.0e-10);
+
+  g_object_set (test->data, "use-norma", TRUE, NULL);
+  ncm_data_m2lnL_val (test->data, NULL, &m2lnL);
+  ncm_assert_cmpdouble_e (m2lnL, ==, m2lnL_lr, 1.0e-10);
+
+  ncm_matrix_memcpy (gauss->cov, cov0);
+
+  ncm_vector_free (f);
+  ncm_matrix_free (cov0);
+  ncm_matrix_free (A);
+  ncm_matrix_free (U);
+}
+
+void
+test_ncm_data_gauss_cov_test_batch (TestNcmDataGaussCovTest *test, gconstpointer pdata)
+{
+  const guint k     = g_test_rand_int_range (1, 40);
+  const gdouble a0  = test->gcov_test->a;
+  NcmVector *m2lnL  = ncm_vector_new (k);
+  NcmVector *a      = ncm_vector_new (k);
+  guint i;
+
+  g_assert (ncm_data_has_m2lnL_val_batch (test->data));
+  g_object_set (test->data, "use-norma", TRUE, NULL);
+
+  for (i = 0; i < k; i++)
+  {
+    ncm_vector_set (a, i, a0 * g_test_rand_double_range (0.99, 1.01));
+    test->gcov_test->a = ncm_vector_get (a, i);
+
+    ncm_data_m2lnL_val_batch_add (test->data, NULL);
+  }
+
+  ncm_vector_set_zero (m2lnL);
+  ncm_data_m2lnL_val_batch_eval (test->data, NULL, m2lnL);
+
+  for (i = 0; i < k; i++)
+  {
+    gdouble m2lnL_i;
+
+    test->gcov_test->a = ncm_vector_get (a, i);
+    ncm_data_m2lnL_val (test->data, NULL, &m2lnL_i);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (m2lnL, i), ==, m2lnL_i, 1.0e-10);
+  }
+
+  test->gcov_test->a = a0;
+
+  ncm_vector_free (a);
+  ncm_vector_free (m2lnL);
+}
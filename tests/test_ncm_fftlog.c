@@ -0,0 +1,129 @@
+/***************************************************************************
+ *            test_ncm_fftlog.c
+ *
+ *  Fri October 16 11:02:37 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcmFftlog
+{
+  NcmFftlog *fftlog;
+  guint nrows;
+} TestNcmFftlog;
+
+static void test_ncm_fftlog_tophatwin2_new (TestNcmFftlog *test, gconstpointer pdata);
+static void test_ncm_fftlog_eval_by_matrix (TestNcmFftlog *test, gconstpointer pdata);
+static void test_ncm_fftlog_free (TestNcmFftlog *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/fftlog/tophatwin2/eval_by_matrix", TestNcmFftlog, NULL,
+              &test_ncm_fftlog_tophatwin2_new,
+              &test_ncm_fftlog_eval_by_matrix,
+              &test_ncm_fftlog_free);
+
+  g_test_run ();
+}
+
+static void
+test_ncm_fftlog_tophatwin2_new (TestNcmFftlog *test, gconstpointer pdata)
+{
+  test->fftlog = NCM_FFTLOG (ncm_fftlog_tophatwin2_new (0.0, 0.0, 20.0, 100 + g_test_rand_int_range (0, 100)));
+  test->nrows  = 2 + g_test_rand_int_range (0, 8);
+
+  ncm_fftlog_set_nderivs (test->fftlog, 1);
+}
+
+static void
+test_ncm_fftlog_free (TestNcmFftlog *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (ncm_fftlog_free, test->fftlog);
+}
+
+static void
+test_ncm_fftlog_eval_by_matrix (TestNcmFftlog *test, gconstpointer pdata)
+{
+  const guint N    = ncm_fftlog_get_size (test->fftlog);
+  const guint nd   = ncm_fftlog_get_nderivs (test->fftlog);
+  NcmVector *lnk   = ncm_vector_new (N);
+  NcmVector *Fk_i  = ncm_vector_new (N);
+  NcmMatrix *Fk    = ncm_matrix_new (test->nrows, N);
+  GPtrArray *Gr    = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_matrix_free);
+  guint i, j, n;
+
+  ncm_fftlog_get_lnk_vector (test->fftlog, lnk);
+
+  for (i = 0; i < test->nrows; i++)
+  {
+    const gdouble lnk_c = g_test_rand_double_range (-3.0, 3.0);
+    const gdouble amp   = g_test_rand_double_range (0.5, 2.0);
+
+    for (j = 0; j < N; j++)
+    {
+      const gdouble x = ncm_vector_get (lnk, j) - lnk_c;
+      ncm_matrix_set (Fk, i, j, amp * exp (-x * x));
+    }
+  }
+
+  for (n = 0; n <= nd; n++)
+    g_ptr_array_add (Gr, ncm_matrix_new (test->nrows, N));
+
+  ncm_fftlog_eval_by_matrix (test->fftlog, Fk, Gr);
+
+  for (i = 0; i < test->nrows; i++)
+  {
+    for (j = 0; j < N; j++)
+      ncm_vector_set (Fk_i, j, ncm_matrix_get (Fk, i, j));
+
+    ncm_fftlog_eval_by_vector (test->fftlog, Fk_i);
+
+    for (n = 0; n <= nd; n++)
+    {
+      NcmVector *Gr_n = ncm_fftlog_peek_output_vector (test->fftlog, n);
+      NcmMatrix *Gr_m = g_ptr_array_index (Gr, n);
+      gdouble absmin, absmax;
+
+      ncm_vector_get_absminmax (Gr_n, &absmin, &absmax);
+
+      for (j = 0; j < N; j++)
+        g_assert_cmpfloat (fabs (ncm_matrix_get (Gr_m, i, j) - ncm_vector_get (Gr_n, j)), <=, 1.0e-11 * absmax);
+    }
+  }
+
+  g_ptr_array_unref (Gr);
+  ncm_matrix_free (Fk);
+  ncm_vector_free (Fk_i);
+  ncm_vector_free (lnk);
+}
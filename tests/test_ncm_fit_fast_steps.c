@@ -0,0 +1,354 @@
+/***************************************************************************
+ *            test_ncm_fit_fast_steps.c
+ *
+ *  Fri October 16 23:41:27 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+/*
+ * The target is a Gaussian likelihood built from Gaussian priors on two
+ * parameters of a slow model (NcHICosmo) and two of a cheap nuisance
+ * model (NcSNIADistCov).
+ */
+
+typedef struct _TestNcmFitFastSteps
+{
+  NcHICosmo *cosmo;
+  NcDistance *dist;
+  NcSNIADistCov *dcov;
+  NcmMSet *mset;
+  NcmDataset *dset;
+  NcmLikelihood *lh;
+  NcmFit *fit;
+  NcmVector *mu;
+  NcmVector *sigma;
+} TestNcmFitFastSteps;
+
+#define TEST_NCM_FIT_FAST_STEPS_NSLOW (2)
+
+static void test_ncm_fit_fast_steps_new (TestNcmFitFastSteps *test, gconstpointer pdata);
+static void test_ncm_fit_fast_steps_mcmc (TestNcmFitFastSteps *test, gconstpointer pdata);
+static void test_ncm_fit_fast_steps_esmcmc (TestNcmFitFastSteps *test, gconstpointer pdata);
+static void test_ncm_fit_fast_steps_measure_model_costs (TestNcmFitFastSteps *test, gconstpointer pdata);
+static void test_ncm_fit_fast_steps_free (TestNcmFitFastSteps *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/fit/fast_steps/mcmc", TestNcmFitFastSteps, GINT_TO_POINTER (FALSE),
+              &test_ncm_fit_fast_steps_new,
+              &test_ncm_fit_fast_steps_mcmc,
+              &test_ncm_fit_fast_steps_free);
+
+  g_test_add ("/ncm/fit/fast_steps/esmcmc", TestNcmFitFastSteps, GINT_TO_POINTER (FALSE),
+              &test_ncm_fit_fast_steps_new,
+              &test_ncm_fit_fast_steps_esmcmc,
+              &test_ncm_fit_fast_steps_free);
+
+  /* The slow model must cost something, the BAO data depends on the distances. */
+  g_test_add ("/ncm/fit/fast_steps/measure_model_costs", TestNcmFitFastSteps, GINT_TO_POINTER (TRUE),
+              &test_ncm_fit_fast_steps_new,
+              &test_ncm_fit_fast_steps_measure_model_costs,
+              &test_ncm_fit_fast_steps_free);
+
+  g_test_run ();
+}
+
+static void
+test_ncm_fit_fast_steps_new (TestNcmFitFastSteps *test, gconstpointer pdata)
+{
+  const gboolean use_bao = GPOINTER_TO_INT (pdata);
+  const struct
+  {
+    NcmModelID mid;
+    guint pid;
+    gdouble mu;
+    gdouble sigma;
+  } target[] = {
+    {nc_hicosmo_id (),       NC_HICOSMO_DE_OMEGA_C,  0.25, 0.01},
+    {nc_hicosmo_id (),       NC_HICOSMO_DE_XCDM_W,  -1.00, 0.05},
+    {nc_snia_dist_cov_id (), NC_SNIA_DIST_COV_ALPHA, 0.14, 0.01},
+    {nc_snia_dist_cov_id (), NC_SNIA_DIST_COV_BETA,  3.10, 0.10},
+  };
+  guint i;
+
+  test->cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  test->dist  = nc_distance_new (3.0);
+  test->dcov  = nc_snia_dist_cov_new (test->dist, 1);
+  test->mset  = ncm_mset_new (test->cosmo, test->dcov, NULL);
+  test->dset  = ncm_dataset_new ();
+
+  if (use_bao)
+  {
+    NcmData *bao = NCM_DATA (nc_data_bao_rdv_new_from_id (test->dist, NC_DATA_BAO_RDV_PERCIVAL2010));
+
+    ncm_dataset_append_data (test->dset, bao);
+    ncm_data_free (bao);
+  }
+
+  ncm_mset_param_set_all_ftype (test->mset, NCM_PARAM_TYPE_FIXED);
+  for (i = 0; i < G_N_ELEMENTS (target); i++)
+  {
+    ncm_mset_param_set_ftype (test->mset, target[i].mid, target[i].pid, NCM_PARAM_TYPE_FREE);
+    ncm_mset_param_set (test->mset, target[i].mid, target[i].pid, target[i].mu);
+  }
+  ncm_mset_prepare_fparam_map (test->mset);
+
+  g_assert_cmpuint (ncm_mset_fparam_len (test->mset), ==, G_N_ELEMENTS (target));
+
+  test->lh    = ncm_likelihood_new (test->dset);
+  test->mu    = ncm_vector_new (G_N_ELEMENTS (target));
+  test->sigma = ncm_vector_new (G_N_ELEMENTS (target));
+
+  for (i = 0; i < G_N_ELEMENTS (target); i++)
+  {
+    const gint fpi = ncm_mset_fparam_get_fpi (test->mset, target[i].mid, target[i].pid);
+
+    g_assert_cmpint (fpi, >=, 0);
+
+    ncm_vector_set (test->mu, fpi, target[i].mu);
+    ncm_vector_set (test->sigma, fpi, target[i].sigma);
+
+    ncm_likelihood_priors_add_gauss_param (test->lh, target[i].mid, target[i].pid, target[i].mu, target[i].sigma);
+  }
+
+  test->fit = ncm_fit_new (NCM_FIT_TYPE_GSL_MMS, "nmsimplex", test->lh, test->mset, NCM_FIT_GRAD_NUMDIFF_FORWARD);
+}
+
+static void
+test_ncm_fit_fast_steps_free (TestNcmFitFastSteps *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (ncm_fit_free, test->fit);
+  NCM_TEST_FREE (ncm_likelihood_free, test->lh);
+  NCM_TEST_FREE (ncm_dataset_free, test->dset);
+  NCM_TEST_FREE (ncm_mset_free, test->mset);
+  NCM_TEST_FREE (nc_snia_dist_cov_free, test->dcov);
+  NCM_TEST_FREE (nc_distance_free, test->dist);
+  NCM_TEST_FREE (nc_hicosmo_free, test->cosmo);
+
+  ncm_vector_free (test->mu);
+  ncm_vector_free (test->sigma);
+}
+
+static void
+_test_ncm_fit_fast_steps_check_fast_fpi (TestNcmFitFastSteps *test, GArray *fast_fpi)
+{
+  guint i;
+
+  g_assert_cmpuint (fast_fpi->len, ==, ncm_mset_fparam_len (test->mset) - TEST_NCM_FIT_FAST_STEPS_NSLOW);
+  for (i = 0; i < fast_fpi->len; i++)
+  {
+    const NcmMSetPIndex *pi = ncm_mset_fparam_get_pi (test->mset, g_array_index (fast_fpi, guint, i));
+    g_assert_cmpuint (pi->mid, ==, nc_snia_dist_cov_id ());
+  }
+}
+
+/*
+ * The tolerances are a few times the expected Monte Carlo errors for an
+ * effective sample size of a few hundred points.
+ */
+static void
+_test_ncm_fit_fast_steps_check_catalog (TestNcmFitFastSteps *test, NcmMSetCatalog *mcat)
+{
+  const guint len = ncm_vector_len (test->mu);
+  NcmVector *mean = NULL;
+  NcmMatrix *cov  = NULL;
+  guint i, j;
+
+  ncm_mset_catalog_get_mean (mcat, &mean);
+  ncm_mset_catalog_get_covar (mcat, &cov);
+
+  g_assert_cmpuint (ncm_vector_len (mean), ==, len);
+
+  for (i = 0; i < len; i++)
+  {
+    const gdouble sigma_i = ncm_vector_get (test->sigma, i);
+
+    g_assert_cmpfloat (fabs (ncm_vector_get (mean, i) - ncm_vector_get (test->mu, i)), <, 0.25 * sigma_i);
+
+    for (j = 0; j < len; j++)
+    {
+      const gdouble sigma_j = ncm_vector_get (test->sigma, j);
+      const gdouble cov_ij  = (i == j) ? sigma_i * sigma_i : 0.0;
+
+      g_assert_cmpfloat (fabs (ncm_matrix_get (cov, i, j) - cov_ij), <, 0.3 * sigma_i * sigma_j);
+    }
+  }
+
+  ncm_vector_free (mean);
+  ncm_matrix_free (cov);
+}
+
+static NcmMSetTransKernGauss *
+_test_ncm_fit_fast_steps_tkern (TestNcmFitFastSteps *test, const gdouble scale)
+{
+  const guint len               = ncm_vector_len (test->sigma);
+  NcmMSetTransKernGauss *tkerng = ncm_mset_trans_kern_gauss_new (0);
+  NcmMatrix *cov                = ncm_matrix_new (len, len);
+  guint i;
+
+  ncm_matrix_set_zero (cov);
+  for (i = 0; i < len; i++)
+    ncm_matrix_set (cov, i, i, gsl_pow_2 (scale * ncm_vector_get (test->sigma, i)));
+
+  ncm_mset_trans_kern_set_mset (NCM_MSET_TRANS_KERN (tkerng), test->mset);
+  ncm_mset_trans_kern_set_prior_from_mset (NCM_MSET_TRANS_KERN (tkerng));
+  ncm_mset_trans_kern_gauss_set_cov (tkerng, cov);
+
+  ncm_matrix_free (cov);
+
+  return tkerng;
+}
+
+static void
+test_ncm_fit_fast_steps_mcmc (TestNcmFitFastSteps *test, gconstpointer pdata)
+{
+  const guint fast_steps        = 4;
+  const guint nsteps            = 200;
+  const guint ntotal            = 20000;
+  NcmModel *slow                = ncm_mset_peek (test->mset, nc_hicosmo_id ());
+  NcmModel *fast                = ncm_mset_peek (test->mset, nc_snia_dist_cov_id ());
+  NcmMSetTransKernGauss *tkerng = _test_ncm_fit_fast_steps_tkern (test, 2.38 / sqrt (ncm_vector_len (test->sigma)));
+  NcmRNG *rng                   = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmFitMCMC *mcmc;
+  NcmMSetCatalog *mcat;
+  guint k;
+
+  ncm_mset_set_model_cost (test->mset, nc_hicosmo_id (), 100.0);
+
+  mcmc = ncm_fit_mcmc_new (test->fit, NCM_MSET_TRANS_KERN (tkerng), NCM_FIT_RUN_MSGS_NONE);
+  ncm_fit_mcmc_set_fast_steps (mcmc, fast_steps);
+  ncm_fit_mcmc_set_rng (mcmc, rng);
+
+  ncm_fit_mcmc_start_run (mcmc);
+  _test_ncm_fit_fast_steps_check_fast_fpi (test, mcmc->fast_fpi);
+
+  /*
+   * A full step sets the slow parameters once, and once more when it is
+   * rejected. The fast steps must not touch the slow model.
+   */
+  for (k = 1; k <= nsteps; k++)
+  {
+    const guint64 slow_pkey = slow->pkey;
+    const guint64 fast_pkey = fast->pkey;
+
+    ncm_fit_mcmc_run (mcmc, k);
+
+    g_assert_cmpuint (slow->pkey - slow_pkey, >=, TEST_NCM_FIT_FAST_STEPS_NSLOW);
+    g_assert_cmpuint (slow->pkey - slow_pkey, <=, 2 * TEST_NCM_FIT_FAST_STEPS_NSLOW);
+    g_assert_cmpuint (fast->pkey - fast_pkey, >=, fast_steps);
+  }
+
+  g_assert_cmpuint (mcmc->nfast_total, ==, nsteps * fast_steps);
+  g_assert_cmpfloat (ncm_fit_mcmc_get_fast_accept_ratio (mcmc), >, 0.0);
+  g_assert_cmpfloat (ncm_fit_mcmc_get_fast_accept_ratio (mcmc), <, 1.0);
+
+  ncm_fit_mcmc_run (mcmc, ntotal);
+  ncm_fit_mcmc_end_run (mcmc);
+
+  mcat = ncm_fit_mcmc_get_catalog (mcmc);
+  g_assert_cmpuint (ncm_mset_catalog_len (mcat), ==, ntotal);
+  _test_ncm_fit_fast_steps_check_catalog (test, mcat);
+
+  ncm_mset_catalog_free (mcat);
+  ncm_fit_mcmc_free (mcmc);
+  ncm_mset_trans_kern_free (NCM_MSET_TRANS_KERN (tkerng));
+  ncm_rng_free (rng);
+}
+
+static void
+test_ncm_fit_fast_steps_esmcmc (TestNcmFitFastSteps *test, gconstpointer pdata)
+{
+  const guint fast_steps               = 3;
+  const guint nwalkers                 = 40;
+  const guint n                        = 1000;
+  NcmMSetTransKernGauss *init_sampler  = _test_ncm_fit_fast_steps_tkern (test, 1.0);
+  NcmFitESMCMCWalkerStretch *stretch   = ncm_fit_esmcmc_walker_stretch_new (nwalkers, ncm_mset_fparam_len (test->mset));
+  NcmRNG *rng                          = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  NcmFitESMCMC *esmcmc;
+  NcmMSetCatalog *mcat;
+
+  ncm_mset_set_model_cost (test->mset, nc_hicosmo_id (), 100.0);
+
+  esmcmc = ncm_fit_esmcmc_new (test->fit, nwalkers, NCM_MSET_TRANS_KERN (init_sampler), NCM_FIT_ESMCMC_WALKER (stretch), NCM_FIT_RUN_MSGS_NONE);
+  ncm_fit_esmcmc_set_fast_steps (esmcmc, fast_steps);
+  ncm_fit_esmcmc_set_rng (esmcmc, rng);
+
+  ncm_fit_esmcmc_start_run (esmcmc);
+  _test_ncm_fit_fast_steps_check_fast_fpi (test, esmcmc->fast_fpi);
+
+  ncm_fit_esmcmc_run (esmcmc, n);
+  ncm_fit_esmcmc_end_run (esmcmc);
+
+  /* The first iteration only samples the initial ensemble. */
+  g_assert_cmpuint (esmcmc->nfast_total, >=, (n - 1) * nwalkers * fast_steps);
+  g_assert_cmpuint (esmcmc->nfast_total, <=, n * nwalkers * fast_steps);
+  g_assert_cmpfloat (ncm_fit_esmcmc_get_fast_accept_ratio (esmcmc), >, 0.0);
+  g_assert_cmpfloat (ncm_fit_esmcmc_get_fast_accept_ratio (esmcmc), <, 1.0);
+
+  mcat = ncm_fit_esmcmc_get_catalog (esmcmc);
+  g_assert_cmpuint (ncm_mset_catalog_len (mcat), ==, n * nwalkers);
+  _test_ncm_fit_fast_steps_check_catalog (test, mcat);
+
+  ncm_mset_catalog_free (mcat);
+  ncm_fit_esmcmc_free (esmcmc);
+  ncm_fit_esmcmc_walker_free (NCM_FIT_ESMCMC_WALKER (stretch));
+  ncm_mset_trans_kern_free (NCM_MSET_TRANS_KERN (init_sampler));
+  ncm_rng_free (rng);
+}
+
+static void
+test_ncm_fit_fast_steps_measure_model_costs (TestNcmFitFastSteps *test, gconstpointer pdata)
+{
+  GArray *fast_fpi = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  /* All models have the same cost, there is no fast block. */
+  g_assert_cmpuint (ncm_mset_fparams_get_fast (test->mset, NCM_MSET_FAST_COST_RATIO, fast_fpi), ==, 0);
+
+  ncm_fit_measure_model_costs (test->fit, 20);
+
+  g_assert_cmpfloat (ncm_mset_get_model_cost (test->mset, nc_hicosmo_id ()), >, 0.0);
+  g_assert_cmpfloat (ncm_mset_get_model_cost (test->mset, nc_snia_dist_cov_id ()), >, 0.0);
+
+  /* Only the cosmological model recomputes the distances. */
+  g_assert_cmpfloat (ncm_mset_get_model_cost (test->mset, nc_hicosmo_id ()), >,
+                     ncm_mset_get_model_cost (test->mset, nc_snia_dist_cov_id ()));
+
+  /* Whatever the measured ratio, the fast block never contains the slow model. */
+  ncm_mset_fparams_get_fast (test->mset, NCM_MSET_FAST_COST_RATIO, fast_fpi);
+  if (fast_fpi->len > 0)
+    _test_ncm_fit_fast_steps_check_fast_fpi (test, fast_fpi);
+
+  g_array_unref (fast_fpi);
+}
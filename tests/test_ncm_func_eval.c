@@ -29,6 +29,7 @@
 #include <numcosmo/numcosmo.h>
 
 #include <math.h>
+#include <string.h>
 #include <glib.h>
 #include <glib-object.h>
 
@@ -41,6 +42,8 @@ void test_ncm_func_eval_new (TestNcmSparam *test, gconstpointer pdata);
 void test_ncm_func_eval_free (TestNcmSparam *test, gconstpointer pdata);
 
 void test_ncm_func_eval_run (TestNcmSparam *test, gconstpointer pdata);
+void test_ncm_func_eval_parallel_for (TestNcmSparam *test, gconstpointer pdata);
+void test_ncm_func_eval_parallel_for_nested (TestNcmSparam *test, gconstpointer pdata);
 
 gint
 main (gint argc, gchar *argv[])
@@ -54,6 +57,16 @@ main (gint argc, gchar *argv[])
               &test_ncm_func_eval_run, 
               &test_ncm_func_eval_free);
 
+  g_test_add ("/ncm/func_eval/parallel_for", TestNcmSparam, NULL, 
+              &test_ncm_func_eval_new, 
+              &test_ncm_func_eval_parallel_for, 
+              &test_ncm_func_eval_free);
+
+  g_test_add ("/ncm/func_eval/parallel_for/nested", TestNcmSparam, NULL, 
+              &test_ncm_func_eval_new, 
+              &test_ncm_func_eval_parallel_for_nested, 
+              &test_ncm_func_eval_free);
+
   g_test_run ();
 }
 
@@ -95,3 +108,59 @@ test_ncm_func_eval_run (TestNcmSparam *test, gconstpointer pdata)
   gdouble res = 0.0;
   ncm_func_eval_threaded_loop_full (test_ncm_func_eval_run_func, 0, test->ntests, &res);
 }
+
+void 
+test_ncm_func_eval_count_func (glong i, glong f, gpointer data)
+{
+  gint *count = (gint *)data;
+  glong k;
+
+  for (k = i; k < f; k++)
+    g_atomic_int_inc (&count[k]);
+}
+
+void
+test_ncm_func_eval_parallel_for (TestNcmSparam *test, gconstpointer pdata)
+{
+  gint *count = g_new (gint, test->ntests);
+  glong grain;
+
+  for (grain = 0; grain < 7; grain++)
+  {
+    const glong i = g_test_rand_int_range (0, test->ntests / 2);
+    const glong f = g_test_rand_int_range (i + 1, test->ntests + 1);
+    glong k;
+
+    memset (count, 0, sizeof (gint) * test->ntests);
+    ncm_func_eval_parallel_for (test_ncm_func_eval_count_func, i, f, grain, count);
+
+    for (k = 0; k < test->ntests; k++)
+      g_assert_cmpint (count[k], ==, ((k >= i) && (k < f)) ? 1 : 0);
+  }
+
+  g_free (count);
+}
+
+void 
+test_ncm_func_eval_nested_func (glong i, glong f, gpointer data)
+{
+  glong k;
+
+  for (k = i; k < f; k++)
+    ncm_func_eval_parallel_for (test_ncm_func_eval_count_func, 0, 100, 0, data);
+}
+
+void
+test_ncm_func_eval_parallel_for_nested (TestNcmSparam *test, gconstpointer pdata)
+{
+  const glong nouter = 4 * ncm_func_eval_get_nworkers ();
+  gint *count        = g_new0 (gint, 100);
+  glong k;
+
+  ncm_func_eval_parallel_for (test_ncm_func_eval_nested_func, 0, nouter, 1, count);
+
+  for (k = 0; k < 100; k++)
+    g_assert_cmpint (count[k], ==, nouter);
+
+  g_free (count);
+}
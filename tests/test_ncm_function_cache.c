@@ -0,0 +1,280 @@
+/***************************************************************************
+ *            test_ncm_function_cache.c
+ *
+ *  Fri October 16 16:05:12 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcmFunctionCache
+{
+  NcmFunctionCache *cache;
+  GArray *keys;
+  guint max_size;
+} TestNcmFunctionCache;
+
+static void test_ncm_function_cache_new (TestNcmFunctionCache *test, gconstpointer pdata);
+static void test_ncm_function_cache_get (TestNcmFunctionCache *test, gconstpointer pdata);
+static void test_ncm_function_cache_get_near (TestNcmFunctionCache *test, gconstpointer pdata);
+static void test_ncm_function_cache_evict (TestNcmFunctionCache *test, gconstpointer pdata);
+static void test_ncm_function_cache_threads (TestNcmFunctionCache *test, gconstpointer pdata);
+static void test_ncm_function_cache_free (TestNcmFunctionCache *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/function_cache/get", TestNcmFunctionCache, NULL,
+              &test_ncm_function_cache_new,
+              &test_ncm_function_cache_get,
+              &test_ncm_function_cache_free);
+
+  g_test_add ("/ncm/function_cache/get_near", TestNcmFunctionCache, NULL,
+              &test_ncm_function_cache_new,
+              &test_ncm_function_cache_get_near,
+              &test_ncm_function_cache_free);
+
+  g_test_add ("/ncm/function_cache/evict", TestNcmFunctionCache, NULL,
+              &test_ncm_function_cache_new,
+              &test_ncm_function_cache_evict,
+              &test_ncm_function_cache_free);
+
+  g_test_add ("/ncm/function_cache/threads", TestNcmFunctionCache, NULL,
+              &test_ncm_function_cache_new,
+              &test_ncm_function_cache_threads,
+              &test_ncm_function_cache_free);
+
+  g_test_run ();
+}
+
+static void
+test_ncm_function_cache_new (TestNcmFunctionCache *test, gconstpointer pdata)
+{
+  guint i;
+
+  test->max_size = 50 + g_test_rand_int_range (0, 50);
+  test->cache    = ncm_function_cache_new_full (2, test->max_size, 0.0, 1.0e-7);
+  test->keys     = g_array_new (FALSE, FALSE, sizeof (gdouble));
+
+  for (i = 0; i < test->max_size; i++)
+  {
+    const gdouble x = g_test_rand_double_range (-10.0, 10.0);
+
+    ncm_function_cache_insert (test->cache, x, sin (x), cos (x));
+    g_array_append_val (test->keys, x);
+  }
+
+  g_assert_cmpuint (ncm_function_cache_len (test->cache), ==, test->max_size);
+}
+
+static void
+test_ncm_function_cache_free (TestNcmFunctionCache *test, gconstpointer pdata)
+{
+  ncm_function_cache_clear (&test->cache);
+  g_array_unref (test->keys);
+}
+
+static void
+test_ncm_function_cache_get (TestNcmFunctionCache *test, gconstpointer pdata)
+{
+  gsl_vector *v = gsl_vector_alloc (2);
+  guint i;
+
+  for (i = 0; i < test->keys->len; i++)
+  {
+    gdouble x = g_array_index (test->keys, gdouble, i);
+
+    g_assert (ncm_function_cache_get (test->cache, &x, v));
+    ncm_assert_cmpdouble (gsl_vector_get (v, 0), ==, sin (x));
+    ncm_assert_cmpdouble (gsl_vector_get (v, 1), ==, cos (x));
+  }
+
+  {
+    gdouble x = 20.0;
+    g_assert (!ncm_function_cache_get (test->cache, &x, v));
+  }
+
+  ncm_function_cache_empty (test->cache);
+  g_assert_cmpuint (ncm_function_cache_len (test->cache), ==, 0);
+
+  {
+    gdouble x = g_array_index (test->keys, gdouble, 0);
+    g_assert (!ncm_function_cache_get (test->cache, &x, v));
+  }
+
+  gsl_vector_free (v);
+}
+
+static void
+test_ncm_function_cache_get_near (TestNcmFunctionCache *test, gconstpointer pdata)
+{
+  gsl_vector *v = gsl_vector_alloc (2);
+  guint ntests  = 1000;
+
+  while (ntests--)
+  {
+    const gdouble x = g_test_rand_double_range (-12.0, 12.0);
+    gdouble near_both = GSL_NAN, near_gt = GSL_NAN, near_lt = GSL_NAN;
+    gdouble x_found;
+    guint i;
+
+    for (i = 0; i < test->keys->len; i++)
+    {
+      const gdouble x_i = g_array_index (test->keys, gdouble, i);
+
+      if (gsl_isnan (near_both) || (fabs (x_i - x) < fabs (near_both - x)))
+        near_both = x_i;
+      if ((x_i >= x) && (gsl_isnan (near_gt) || (x_i < near_gt)))
+        near_gt = x_i;
+      if ((x_i <= x) && (gsl_isnan (near_lt) || (x_i > near_lt)))
+        near_lt = x_i;
+    }
+
+    g_assert (ncm_function_cache_get_near (test->cache, x, &x_found, v, NC_FUNCTION_CACHE_SEARCH_BOTH));
+    g_assert_cmpfloat (fabs (x_found - x), ==, fabs (near_both - x));
+    ncm_assert_cmpdouble (gsl_vector_get (v, 0), ==, sin (x_found));
+
+    if (gsl_isnan (near_gt))
+      g_assert (!ncm_function_cache_get_near (test->cache, x, &x_found, v, NC_FUNCTION_CACHE_SEARCH_GT));
+    else
+    {
+      g_assert (ncm_function_cache_get_near (test->cache, x, &x_found, v, NC_FUNCTION_CACHE_SEARCH_GT));
+      g_assert_cmpfloat (x_found, ==, near_gt);
+      ncm_assert_cmpdouble (gsl_vector_get (v, 1), ==, cos (x_found));
+    }
+
+    if (gsl_isnan (near_lt))
+      g_assert (!ncm_function_cache_get_near (test->cache, x, &x_found, v, NC_FUNCTION_CACHE_SEARCH_LT));
+    else
+    {
+      g_assert (ncm_function_cache_get_near (test->cache, x, &x_found, v, NC_FUNCTION_CACHE_SEARCH_LT));
+      g_assert_cmpfloat (x_found, ==, near_lt);
+      ncm_assert_cmpdouble (gsl_vector_get (v, 1), ==, cos (x_found));
+    }
+  }
+
+  gsl_vector_free (v);
+}
+
+static void
+test_ncm_function_cache_evict (TestNcmFunctionCache *test, gconstpointer pdata)
+{
+  gsl_vector *v = gsl_vector_alloc (2);
+  const guint nnew = test->max_size / 2;
+  guint i;
+
+  /* The cache is full, the oldest keys must be evicted first. */
+  for (i = 0; i < nnew; i++)
+  {
+    const gdouble x = 20.0 + i;
+    ncm_function_cache_insert (test->cache, x, sin (x), cos (x));
+  }
+
+  g_assert_cmpuint (ncm_function_cache_len (test->cache), ==, test->max_size);
+
+  for (i = 0; i < test->keys->len; i++)
+  {
+    gdouble x = g_array_index (test->keys, gdouble, i);
+
+    if (i < nnew)
+      g_assert (!ncm_function_cache_get (test->cache, &x, v));
+    else
+      g_assert (ncm_function_cache_get (test->cache, &x, v));
+  }
+
+  for (i = 0; i < nnew; i++)
+  {
+    gdouble x = 20.0 + i;
+
+    g_assert (ncm_function_cache_get (test->cache, &x, v));
+    ncm_assert_cmpdouble (gsl_vector_get (v, 0), ==, sin (x));
+  }
+
+  gsl_vector_free (v);
+}
+
+typedef struct _TestNcmFunctionCacheThread
+{
+  NcmFunctionCache *cache;
+  gint done;
+} TestNcmFunctionCacheThread;
+
+static gpointer
+_test_ncm_function_cache_reader (gpointer data)
+{
+  TestNcmFunctionCacheThread *tt = (TestNcmFunctionCacheThread *) data;
+  gsl_vector *v = gsl_vector_alloc (2);
+
+  while (!g_atomic_int_get (&tt->done))
+  {
+    const gdouble x = g_random_double_range (-12.0, 12.0);
+    gdouble x_found;
+
+    /* The values read must always be consistent with the key found. */
+    if (ncm_function_cache_get_near (tt->cache, x, &x_found, v, NC_FUNCTION_CACHE_SEARCH_BOTH))
+    {
+      g_assert_cmpfloat (gsl_vector_get (v, 0), ==, sin (x_found));
+      g_assert_cmpfloat (gsl_vector_get (v, 1), ==, cos (x_found));
+    }
+  }
+
+  gsl_vector_free (v);
+
+  return NULL;
+}
+
+static void
+test_ncm_function_cache_threads (TestNcmFunctionCache *test, gconstpointer pdata)
+{
+  TestNcmFunctionCacheThread tt = {test->cache, 0};
+  GThread *readers[4];
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (readers); i++)
+    readers[i] = g_thread_new ("reader", &_test_ncm_function_cache_reader, &tt);
+
+  for (i = 0; i < 20000; i++)
+  {
+    const gdouble x = g_test_rand_double_range (-10.0, 10.0);
+
+    ncm_function_cache_insert (test->cache, x, sin (x), cos (x));
+    if (i % 5000 == 0)
+      ncm_function_cache_empty (test->cache);
+  }
+
+  g_atomic_int_set (&tt.done, 1);
+
+  for (i = 0; i < G_N_ELEMENTS (readers); i++)
+    g_thread_join (readers[i]);
+
+  g_assert_cmpuint (ncm_function_cache_len (test->cache), ==, test->max_size);
+}
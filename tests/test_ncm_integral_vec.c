@@ -0,0 +1,201 @@
+/***************************************************************************
+ *            test_ncm_integral_vec.c
+ *
+ *  Fri October 16 22:14:37 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcmIntegralVec
+{
+  gdouble xi, xf;
+  gdouble yi, yf;
+  gdouble zi, zf;
+  guint ncalls;
+  guint npoints;
+} TestNcmIntegralVec;
+
+void test_ncm_integral_vec_new (TestNcmIntegralVec *test, gconstpointer pdata);
+void test_ncm_integral_vec_free (TestNcmIntegralVec *test, gconstpointer pdata);
+
+void test_ncm_integral_vec_2dim (TestNcmIntegralVec *test, gconstpointer pdata);
+void test_ncm_integral_vec_2dim_divonne (TestNcmIntegralVec *test, gconstpointer pdata);
+void test_ncm_integral_vec_2dim_vegas (TestNcmIntegralVec *test, gconstpointer pdata);
+void test_ncm_integral_vec_3dim (TestNcmIntegralVec *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/integral/vec/2dim", TestNcmIntegralVec, NULL,
+              &test_ncm_integral_vec_new,
+              &test_ncm_integral_vec_2dim,
+              &test_ncm_integral_vec_free);
+
+#ifdef HAVE_LIBCUBA_4_0
+  g_test_add ("/ncm/integral/vec/2dim/divonne", TestNcmIntegralVec, NULL,
+              &test_ncm_integral_vec_new,
+              &test_ncm_integral_vec_2dim_divonne,
+              &test_ncm_integral_vec_free);
+
+  g_test_add ("/ncm/integral/vec/2dim/vegas", TestNcmIntegralVec, NULL,
+              &test_ncm_integral_vec_new,
+              &test_ncm_integral_vec_2dim_vegas,
+              &test_ncm_integral_vec_free);
+#endif /* HAVE_LIBCUBA_4_0 */
+
+  g_test_add ("/ncm/integral/vec/3dim", TestNcmIntegralVec, NULL,
+              &test_ncm_integral_vec_new,
+              &test_ncm_integral_vec_3dim,
+              &test_ncm_integral_vec_free);
+
+  g_test_run ();
+}
+
+void
+test_ncm_integral_vec_new (TestNcmIntegralVec *test, gconstpointer pdata)
+{
+  test->xi      = g_test_rand_double_range (-1.0, 0.0);
+  test->xf      = g_test_rand_double_range (1.0, 2.0);
+  test->yi      = g_test_rand_double_range (-1.0, 0.0);
+  test->yf      = g_test_rand_double_range (0.5, 1.5);
+  test->zi      = g_test_rand_double_range (0.0, 1.0);
+  test->zf      = g_test_rand_double_range (2.0, 3.0);
+  test->ncalls  = 0;
+  test->npoints = 0;
+}
+
+void
+test_ncm_integral_vec_free (TestNcmIntegralVec *test, gconstpointer pdata)
+{
+}
+
+/*
+ * f(x, y) = exp(-x) cos(y) and f(x, y, z) = exp(-x) cos(y) z^2, whose
+ * integrals over the boxes are the products of the one dimensional ones.
+ */
+
+static gdouble
+_test_ncm_integral_vec_2dim_exact (TestNcmIntegralVec *test)
+{
+  return (exp (-test->xi) - exp (-test->xf)) * (sin (test->yf) - sin (test->yi));
+}
+
+static gdouble
+_test_ncm_integral_vec_3dim_exact (TestNcmIntegralVec *test)
+{
+  return _test_ncm_integral_vec_2dim_exact (test) * (gsl_pow_3 (test->zf) - gsl_pow_3 (test->zi)) / 3.0;
+}
+
+static void
+_test_ncm_integral_vec_check_block (TestNcmIntegralVec *test, const guint np)
+{
+  g_assert_cmpuint (np, >, 0);
+  g_assert_cmpuint (np, <=, NCM_INTEGRAL_NVEC);
+
+  test->ncalls++;
+  test->npoints += np;
+}
+
+static void
+_test_ncm_integral_vec_2dim_f (const gdouble *x, const gdouble *y, const guint np, gdouble *f, gpointer userdata)
+{
+  TestNcmIntegralVec *test = (TestNcmIntegralVec *) userdata;
+  guint i;
+
+  _test_ncm_integral_vec_check_block (test, np);
+
+  for (i = 0; i < np; i++)
+    f[i] = exp (-x[i]) * cos (y[i]);
+}
+
+static void
+_test_ncm_integral_vec_3dim_f (const gdouble *x, const gdouble *y, const gdouble *z, const guint np, gdouble *f, gpointer userdata)
+{
+  TestNcmIntegralVec *test = (TestNcmIntegralVec *) userdata;
+  guint i;
+
+  _test_ncm_integral_vec_check_block (test, np);
+
+  for (i = 0; i < np; i++)
+    f[i] = exp (-x[i]) * cos (y[i]) * z[i] * z[i];
+}
+
+void
+test_ncm_integral_vec_2dim (TestNcmIntegralVec *test, gconstpointer pdata)
+{
+  NcmIntegrand2dimVec integ = {test, &_test_ncm_integral_vec_2dim_f};
+  gdouble result, error;
+
+  g_assert (ncm_integrate_2dim_vec (&integ, test->xi, test->yi, test->xf, test->yf, 1.0e-10, 0.0, &result, &error));
+
+  ncm_assert_cmpdouble_e (result, ==, _test_ncm_integral_vec_2dim_exact (test), 1.0e-9);
+  g_assert_cmpuint (test->npoints, >=, test->ncalls);
+}
+
+void
+test_ncm_integral_vec_2dim_divonne (TestNcmIntegralVec *test, gconstpointer pdata)
+{
+  NcmIntegrand2dimVec integ = {test, &_test_ncm_integral_vec_2dim_f};
+  gdouble result, error;
+
+  g_assert (ncm_integrate_2dim_vec_divonne (&integ, test->xi, test->yi, test->xf, test->yf, 1.0e-6, 0.0, 0, 2, NULL, &result, &error));
+
+  ncm_assert_cmpdouble_e (result, ==, _test_ncm_integral_vec_2dim_exact (test), 1.0e-5);
+}
+
+void
+test_ncm_integral_vec_2dim_vegas (TestNcmIntegralVec *test, gconstpointer pdata)
+{
+  NcmIntegrand2dimVec integ = {test, &_test_ncm_integral_vec_2dim_f};
+  const gdouble exact       = _test_ncm_integral_vec_2dim_exact (test);
+  gdouble result, error;
+
+  /* Monte Carlo estimate with at most 10^4 points, only the error estimate is meaningful. */
+  ncm_integrate_2dim_vec_vegas (&integ, test->xi, test->yi, test->xf, test->yf, 1.0e-3, 0.0, 1000, &result, &error);
+
+  g_assert_cmpfloat (error, >, 0.0);
+  g_assert_cmpfloat (fabs (result - exact), <=, 5.0 * error);
+  ncm_assert_cmpdouble_e (result, ==, exact, 1.0e-2);
+}
+
+void
+test_ncm_integral_vec_3dim (TestNcmIntegralVec *test, gconstpointer pdata)
+{
+  NcmIntegrand3dimVec integ = {test, &_test_ncm_integral_vec_3dim_f};
+  gdouble result, error;
+
+  g_assert (ncm_integrate_3dim_vec (&integ, test->xi, test->yi, test->zi, test->xf, test->yf, test->zf, 1.0e-8, 0.0, &result, &error));
+
+  ncm_assert_cmpdouble_e (result, ==, _test_ncm_integral_vec_3dim_exact (test), 1.0e-7);
+  g_assert_cmpuint (test->npoints, >=, test->ncalls);
+}
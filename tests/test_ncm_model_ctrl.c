@@ -46,6 +46,7 @@ void test_ncm_model_ctrl_free (TestNcmModelCtrl *test, gconstpointer pdata);
 void test_ncm_model_ctrl_model_update (TestNcmModelCtrl *test, gconstpointer pdata);
 void test_ncm_model_ctrl_update (TestNcmModelCtrl *test, gconstpointer pdata);
 void test_ncm_model_ctrl_submodel_update (TestNcmModelCtrl *test, gconstpointer pdata);
+void test_ncm_model_ctrl_model_replace (TestNcmModelCtrl *test, gconstpointer pdata);
 
 void test_ncm_model_ctrl_traps (TestNcmModelCtrl *test, gconstpointer pdata);
 void test_ncm_model_ctrl_invalid_submodel_last_update (TestNcmModelCtrl *test, gconstpointer pdata);
@@ -72,6 +73,11 @@ main (gint argc, gchar *argv[])
               &test_ncm_model_ctrl_submodel_update, 
               &test_ncm_model_ctrl_free);
 
+  g_test_add ("/ncm/model_ctrl/model_replace", TestNcmModelCtrl, NULL, 
+              &test_ncm_model_ctrl_new, 
+              &test_ncm_model_ctrl_model_replace, 
+              &test_ncm_model_ctrl_free);
+
   g_test_add ("/ncm/model_ctrl/traps", TestNcmModelCtrl, NULL,
               &test_ncm_model_ctrl_new,
               &test_ncm_model_ctrl_traps,
@@ -284,6 +290,41 @@ test_ncm_model_ctrl_submodel_update (TestNcmModelCtrl *test, gconstpointer pdata
   }
 }
 
+void
+test_ncm_model_ctrl_model_replace (TestNcmModelCtrl *test, gconstpointer pdata)
+{
+  guint i;
+
+  ncm_model_add_submodel (test->model, test->submodel1);
+  g_assert (ncm_model_ctrl_update (test->ctrl, test->model));
+  g_assert (!ncm_model_ctrl_update (test->ctrl, test->model));
+
+  /*
+   * Models created after the one being tracked, even if they end up at the
+   * same address, must always be detected as a different model.
+   */
+  for (i = 0; i < 10; i++)
+  {
+    NcmModel *model = NCM_MODEL (nc_hicosmo_lcdm_new ());
+
+    g_assert (ncm_model_ctrl_update (test->ctrl, model));
+    g_assert (ncm_model_ctrl_model_last_update (test->ctrl));
+    g_assert (!ncm_model_ctrl_update (test->ctrl, model));
+    g_assert (!ncm_model_ctrl_model_has_submodel (test->ctrl, nc_hiprim_id ()));
+
+    ncm_model_free (model);
+  }
+
+  g_assert (ncm_model_ctrl_update (test->ctrl, test->model));
+  g_assert (ncm_model_ctrl_model_last_update (test->ctrl));
+  g_assert (ncm_model_ctrl_model_has_submodel (test->ctrl, nc_hiprim_id ()));
+
+  ncm_model_ctrl_force_update (test->ctrl);
+  g_assert (ncm_model_ctrl_update (test->ctrl, test->model));
+  g_assert (!ncm_model_ctrl_update (test->ctrl, test->model));
+  g_assert (!ncm_model_ctrl_submodel_last_update (test->ctrl, nc_hiprim_id ()));
+}
+
 void
 test_ncm_model_ctrl_traps (TestNcmModelCtrl *test, gconstpointer pdata)
 {
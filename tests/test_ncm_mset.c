@@ -46,6 +46,7 @@ void test_ncm_mset_setpeek (TestNcmMSet *test, gconstpointer pdata);
 void test_ncm_mset_setpospeek (TestNcmMSet *test, gconstpointer pdata);
 void test_ncm_mset_pushpeek (TestNcmMSet *test, gconstpointer pdata);
 void test_ncm_mset_fparams (TestNcmMSet *test, gconstpointer pdata);
+void test_ncm_mset_fparams_fast (TestNcmMSet *test, gconstpointer pdata);
 void test_ncm_mset_dup (TestNcmMSet *test, gconstpointer pdata);
 void test_ncm_mset_shallow_copy (TestNcmMSet *test, gconstpointer pdata);
 void test_ncm_mset_saveload (TestNcmMSet *test, gconstpointer pdata);
@@ -81,6 +82,11 @@ main (gint argc, gchar *argv[])
               &test_ncm_mset_fparams, 
               &test_ncm_mset_free);
 
+  g_test_add ("/ncm/mset/fparams/fast", TestNcmMSet, NULL, 
+              &test_ncm_mset_new, 
+              &test_ncm_mset_fparams_fast, 
+              &test_ncm_mset_free);
+
   g_test_add ("/ncm/mset/dup", TestNcmMSet, NULL, 
               &test_ncm_mset_new, 
               &test_ncm_mset_dup, 
@@ -294,6 +300,68 @@ test_ncm_mset_fparams (TestNcmMSet *test, gconstpointer pdata)
   nc_cluster_mass_free (benson);
 }
 
+void
+test_ncm_mset_fparams_fast (TestNcmMSet *test, gconstpointer pdata)
+{
+  NcClusterMass *mass  = nc_cluster_mass_new_from_name ("NcClusterMassLnnormal");
+  NcmModel *cosmo      = ncm_mset_peek (test->mset, nc_hicosmo_id ());
+  GArray *fast_fpi     = g_array_new (FALSE, FALSE, sizeof (guint));
+  const NcmModelID mid = NCM_MSET_MID (nc_cluster_mass_id (), 0);
+  gboolean f = FALSE;
+  NcmVector *x;
+  guint64 cosmo_pkey, mass_pkey;
+  guint i;
+
+  ncm_mset_set (test->mset, NCM_MODEL (mass));
+  g_ptr_array_add (test->ma, mass);
+  g_array_append_val (test->ma_destroyed, f);
+
+  ncm_mset_param_set_all_ftype (test->mset, NCM_PARAM_TYPE_FIXED);
+  ncm_mset_param_set_ftype (test->mset, nc_hicosmo_id (), 0, NCM_PARAM_TYPE_FREE);
+  ncm_mset_param_set_ftype (test->mset, mid, 0, NCM_PARAM_TYPE_FREE);
+  ncm_mset_param_set_ftype (test->mset, mid, 1, NCM_PARAM_TYPE_FREE);
+  ncm_mset_prepare_fparam_map (test->mset);
+
+  g_assert_cmpuint (ncm_mset_fparam_len (test->mset), ==, 3);
+
+  /* All models have the same cost, there is no fast block. */
+  g_assert_cmpuint (ncm_mset_fparams_get_fast (test->mset, NCM_MSET_FAST_COST_RATIO, fast_fpi), ==, 0);
+
+  ncm_mset_set_model_cost (test->mset, nc_hicosmo_id (), 100.0);
+  ncm_assert_cmpdouble (ncm_mset_get_model_cost (test->mset, nc_hicosmo_id ()), ==, 100.0);
+  ncm_assert_cmpdouble (ncm_mset_get_model_cost (test->mset, mid), ==, 1.0);
+
+  g_assert_cmpuint (ncm_mset_fparams_get_fast (test->mset, NCM_MSET_FAST_COST_RATIO, fast_fpi), ==, 2);
+  for (i = 0; i < fast_fpi->len; i++)
+  {
+    const NcmMSetPIndex *pi = ncm_mset_fparam_get_pi (test->mset, g_array_index (fast_fpi, guint, i));
+    g_assert_cmpuint (pi->mid, ==, mid);
+  }
+
+  /* Only the fast parameters change, the slow model must keep its pkey. */
+  x = ncm_vector_new (ncm_mset_fparam_len (test->mset));
+  ncm_mset_fparams_get_vector (test->mset, x);
+  for (i = 0; i < fast_fpi->len; i++)
+  {
+    const guint fpi = g_array_index (fast_fpi, guint, i);
+    ncm_vector_set (x, fpi, ncm_vector_get (x, fpi) * 1.01 + 0.01);
+  }
+
+  cosmo_pkey = cosmo->pkey;
+  mass_pkey  = NCM_MODEL (mass)->pkey;
+
+  ncm_mset_fparams_update_vector (test->mset, x);
+
+  g_assert_cmpuint (cosmo->pkey, ==, cosmo_pkey);
+  g_assert_cmpuint (NCM_MODEL (mass)->pkey, >, mass_pkey);
+  for (i = 0; i < ncm_vector_len (x); i++)
+    ncm_assert_cmpdouble (ncm_mset_fparam_get (test->mset, i), ==, ncm_vector_get (x, i));
+
+  ncm_vector_free (x);
+  g_array_unref (fast_fpi);
+  nc_cluster_mass_free (mass);
+}
+
 void
 test_ncm_mset_dup (TestNcmMSet *test, gconstpointer pdata)
 {
@@ -317,6 +385,12 @@ test_ncm_mset_dup (TestNcmMSet *test, gconstpointer pdata)
     }
   }
   ncm_mset_prepare_fparam_map (test->mset);
+
+  {
+    guint i;
+    for (i = 0; i < ncm_mset_nmodels (test->mset); i++)
+      ncm_mset_set_model_cost (test->mset, ncm_mset_get_mid_array_pos (test->mset, i), g_test_rand_double_range (1.0, 100.0));
+  }
   
   {
     NcClusterMass *benson = nc_cluster_mass_new_from_name ("NcClusterMassBenson");
@@ -341,6 +415,10 @@ test_ncm_mset_dup (TestNcmMSet *test, gconstpointer pdata)
         {
           ncm_assert_cmpdouble (ncm_model_param_get (model0, pid), ==, ncm_model_param_get (model1, pid));
         }
+
+        g_assert_cmpint (ncm_mset_get_mid_array_pos (test->mset, i), ==, ncm_mset_get_mid_array_pos (mset_dup, i));
+        ncm_assert_cmpdouble (ncm_mset_get_model_cost (test->mset, ncm_mset_get_mid_array_pos (test->mset, i)), ==,
+                              ncm_mset_get_model_cost (mset_dup, ncm_mset_get_mid_array_pos (mset_dup, i)));
       }
 
       g_assert_cmpuint (ncm_mset_fparams_len (test->mset), ==, ncm_mset_fparams_len (mset_dup));
@@ -476,6 +554,10 @@ test_ncm_mset_saveload (TestNcmMSet *test, gconstpointer pdata)
         {
           ncm_assert_cmpdouble (ncm_model_param_get (model0, pid), ==, ncm_model_param_get (model1, pid));
         }
+
+        g_assert_cmpint (ncm_mset_get_mid_array_pos (test->mset, i), ==, ncm_mset_get_mid_array_pos (mset_dup, i));
+        ncm_assert_cmpdouble (ncm_mset_get_model_cost (test->mset, ncm_mset_get_mid_array_pos (test->mset, i)), ==,
+                              ncm_mset_get_model_cost (mset_dup, ncm_mset_get_mid_array_pos (mset_dup, i)));
       }
     }
     
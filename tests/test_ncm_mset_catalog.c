@@ -0,0 +1,364 @@
+/***************************************************************************
+ *            test_ncm_mset_catalog.c
+ *
+ *  Thu October 15 14:02:11 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <glib-object.h>
+#include <gsl/gsl_math.h>
+
+typedef struct _TestNcmMSetCatalog
+{
+  NcmMSet *mset;
+  NcmMSetCatalog *mcat;
+  NcmRNG *rng;
+  gchar *tmp_dir;
+  gchar *col_file;
+  guint nrows;
+} TestNcmMSetCatalog;
+
+void test_ncm_mset_catalog_new (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_free (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_col_file (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_col_file_append (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_calc_ci_direct (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_calc_ci_sketch (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_calc_distrib (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_traps (TestNcmMSetCatalog *test, gconstpointer pdata);
+void test_ncm_mset_catalog_invalid_calc_empty (TestNcmMSetCatalog *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/mset_catalog/col_file", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_col_file,
+              &test_ncm_mset_catalog_free);
+
+  g_test_add ("/ncm/mset_catalog/col_file/append", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_col_file_append,
+              &test_ncm_mset_catalog_free);
+
+  g_test_add ("/ncm/mset_catalog/calc/ci_direct", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_calc_ci_direct,
+              &test_ncm_mset_catalog_free);
+
+  g_test_add ("/ncm/mset_catalog/calc/ci_sketch", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_calc_ci_sketch,
+              &test_ncm_mset_catalog_free);
+
+  g_test_add ("/ncm/mset_catalog/calc/distrib", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_calc_distrib,
+              &test_ncm_mset_catalog_free);
+
+  g_test_add ("/ncm/mset_catalog/traps", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_traps,
+              &test_ncm_mset_catalog_free);
+
+  g_test_add ("/ncm/mset_catalog/invalid/calc/empty/subprocess", TestNcmMSetCatalog, NULL,
+              &test_ncm_mset_catalog_new,
+              &test_ncm_mset_catalog_invalid_calc_empty,
+              &test_ncm_mset_catalog_free);
+
+  g_test_run ();
+}
+
+static void
+_test_ncm_mset_catalog_add_rows (TestNcmMSetCatalog *test, guint nrows)
+{
+  const guint len = ncm_mset_fparams_len (test->mset) + 1;
+  NcmVector *row  = ncm_vector_new (len);
+  gdouble x       = 0.0;
+  guint i, j;
+
+  for (i = 0; i < nrows; i++)
+  {
+    /* AR(1) chain, so that the autocorrelation time is not trivial. */
+    x = 0.9 * x + ncm_rng_gaussian_gen (test->rng, 0.0, 1.0);
+    ncm_vector_set (row, 0, x * x);
+    for (j = 1; j < len; j++)
+      ncm_vector_set (row, j, x + j);
+
+    ncm_mset_catalog_add_from_vector (test->mcat, row);
+  }
+
+  ncm_vector_free (row);
+}
+
+void
+test_ncm_mset_catalog_new (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcHICosmo *cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  GError *error    = NULL;
+
+  test->mset = ncm_mset_new (cosmo, NULL);
+  ncm_mset_param_set_ftype (test->mset, nc_hicosmo_id (), NC_HICOSMO_DE_OMEGA_C, NCM_PARAM_TYPE_FREE);
+  ncm_mset_param_set_ftype (test->mset, nc_hicosmo_id (), NC_HICOSMO_DE_XCDM_W,  NCM_PARAM_TYPE_FREE);
+  ncm_mset_prepare_fparam_map (test->mset);
+
+  test->rng      = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  test->mcat     = ncm_mset_catalog_new (test->mset, 1, 1, FALSE, NCM_MSET_CATALOG_M2LNL_COLNAME, NCM_MSET_CATALOG_M2LNL_SYMBOL, NULL);
+  test->tmp_dir  = g_dir_make_tmp ("test_ncm_mset_catalog_XXXXXX", &error);
+  g_assert_no_error (error);
+  test->col_file = g_build_filename (test->tmp_dir, "catalog"NCM_MSET_CATALOG_COL_EXT, NULL);
+  test->nrows    = 1000 + g_test_rand_int_range (0, 40000);
+
+  ncm_mset_catalog_set_sync_mode (test->mcat, NCM_MSET_CATALOG_SYNC_DISABLE);
+
+  nc_hicosmo_free (cosmo);
+}
+
+void
+test_ncm_mset_catalog_free (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  ncm_mset_catalog_clear (&test->mcat);
+  ncm_mset_free (test->mset);
+  ncm_rng_free (test->rng);
+
+  g_unlink (test->col_file);
+  g_rmdir (test->tmp_dir);
+
+  g_free (test->col_file);
+  g_free (test->tmp_dir);
+}
+
+static void
+_test_ncm_mset_catalog_cmp (NcmMSetCatalog *mcat, NcmMSetCatalog *mcat_file)
+{
+  const guint len = ncm_mset_catalog_len (mcat);
+  guint i, j;
+
+  g_assert_cmpuint (ncm_mset_catalog_len (mcat_file), ==, len);
+  g_assert_cmpint (ncm_mset_catalog_get_first_id (mcat_file), ==, ncm_mset_catalog_get_first_id (mcat));
+  g_assert_cmpint (ncm_mset_catalog_get_cur_id (mcat_file), ==, ncm_mset_catalog_get_cur_id (mcat));
+  g_assert_cmpuint (ncm_mset_fparams_len (ncm_mset_catalog_get_mset (mcat_file)), ==, ncm_mset_fparams_len (ncm_mset_catalog_get_mset (mcat)));
+
+  for (i = 0; i < len; i++)
+  {
+    NcmVector *row      = ncm_mset_catalog_peek_row (mcat, i);
+    NcmVector *row_file = ncm_mset_catalog_peek_row (mcat_file, i);
+
+    for (j = 0; j < ncm_vector_len (row); j++)
+      ncm_assert_cmpdouble (ncm_vector_get (row_file, j), ==, ncm_vector_get (row, j));
+  }
+
+  for (j = 0; j < ncm_vector_len (ncm_mset_catalog_peek_row (mcat, 0)); j++)
+  {
+    const gdouble tau      = ncm_stats_vec_get_autocorr_tau (mcat->pstats, j, 0);
+    const gdouble tau_file = ncm_stats_vec_get_autocorr_tau (mcat_file->pstats, j, 0);
+
+    ncm_assert_cmpdouble_e (tau_file, ==, tau, 1.0e-10);
+  }
+
+  /* The columns of the file are read in place, same input as the saved rows. */
+  ncm_mset_catalog_set_tau_method (mcat_file, NCM_MSET_CATALOG_TAU_METHOD_ACOR);
+  ncm_mset_catalog_estimate_autocorrelation_tau (mcat_file, TRUE);
+  {
+    NcmVector *tau_rows = ncm_stats_vec_get_autocorr_tau_all (mcat_file->pstats, 0);
+    NcmVector *tau_cols = ncm_mset_catalog_peek_autocorrelation_tau (mcat_file);
+
+    for (j = 0; j < ncm_vector_len (tau_rows); j++)
+      ncm_assert_cmpdouble_e (ncm_vector_get (tau_cols, j), ==, ncm_vector_get (tau_rows, j), 1.0e-14);
+
+    ncm_vector_free (tau_rows);
+  }
+}
+
+void
+test_ncm_mset_catalog_col_file (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcmMSetCatalog *mcat_file;
+
+  ncm_mset_catalog_set_file (test->mcat, test->col_file);
+  _test_ncm_mset_catalog_add_rows (test, test->nrows);
+  ncm_mset_catalog_sync (test->mcat, TRUE);
+
+  g_assert (g_file_test (test->col_file, G_FILE_TEST_EXISTS));
+
+  mcat_file = ncm_mset_catalog_new_from_file_ro (test->col_file, 0);
+  _test_ncm_mset_catalog_cmp (test->mcat, mcat_file);
+  ncm_mset_catalog_free (mcat_file);
+}
+
+void
+test_ncm_mset_catalog_col_file_append (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcmMSetCatalog *mcat_file;
+
+  ncm_mset_catalog_set_file (test->mcat, test->col_file);
+  _test_ncm_mset_catalog_add_rows (test, test->nrows / 2);
+  ncm_mset_catalog_sync (test->mcat, TRUE);
+
+  /* Reopen the file in read-write mode and keep appending. */
+  mcat_file = ncm_mset_catalog_new_from_file (test->col_file, 0);
+  _test_ncm_mset_catalog_cmp (test->mcat, mcat_file);
+  ncm_mset_catalog_clear (&test->mcat);
+
+  test->mcat = mcat_file;
+  _test_ncm_mset_catalog_add_rows (test, test->nrows - test->nrows / 2);
+  ncm_mset_catalog_sync (test->mcat, TRUE);
+
+  mcat_file = ncm_mset_catalog_new_from_file_ro (test->col_file, 0);
+  g_assert_cmpuint (ncm_mset_catalog_len (mcat_file), ==, test->nrows);
+  _test_ncm_mset_catalog_cmp (test->mcat, mcat_file);
+  ncm_mset_catalog_free (mcat_file);
+}
+
+void
+test_ncm_mset_catalog_calc_ci_direct (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcmMSetFunc *func   = NCM_MSET_FUNC (ncm_mset_func_list_new ("NcHICosmo:E2Omega_c", NULL));
+  NcmVector *z_v      = ncm_vector_new (20);
+  GArray *p_val       = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  const gdouble p[]   = {0.6827, 0.9545};
+  const gdouble Oc    = ncm_mset_param_get (test->mset, nc_hicosmo_id (), NC_HICOSMO_DE_OMEGA_C);
+  NcmMatrix *res;
+  gdouble Oc_mean;
+  guint i;
+
+  g_array_append_vals (p_val, p, G_N_ELEMENTS (p));
+  for (i = 0; i < ncm_vector_len (z_v); i++)
+    ncm_vector_set (z_v, i, 0.1 * i);
+
+  _test_ncm_mset_catalog_add_rows (test, test->nrows / 10);
+  Oc_mean = ncm_stats_vec_get_mean (test->mcat->pstats, test->mcat->nadd_vals + 0);
+
+  res = ncm_mset_catalog_calc_ci_direct (test->mcat, func, z_v, p_val);
+
+  /* E2Omega_c = Omega_c (1 + z)^3 */
+  for (i = 0; i < ncm_vector_len (z_v); i++)
+  {
+    const gdouble x3 = gsl_pow_3 (1.0 + ncm_vector_get (z_v, i));
+
+    ncm_assert_cmpdouble_e (ncm_matrix_get (res, i, 0), ==, Oc_mean * x3, 1.0e-10);
+    g_assert_cmpfloat (ncm_matrix_get (res, i, 1), <=, ncm_matrix_get (res, i, 0));
+    g_assert_cmpfloat (ncm_matrix_get (res, i, 2), >=, ncm_matrix_get (res, i, 0));
+    g_assert_cmpfloat (ncm_matrix_get (res, i, 3), <=, ncm_matrix_get (res, i, 1));
+    g_assert_cmpfloat (ncm_matrix_get (res, i, 4), >=, ncm_matrix_get (res, i, 2));
+  }
+
+  /* The catalog mset must be untouched. */
+  g_assert_cmpfloat (ncm_mset_param_get (test->mset, nc_hicosmo_id (), NC_HICOSMO_DE_OMEGA_C), ==, Oc);
+
+  ncm_matrix_free (res);
+  ncm_vector_free (z_v);
+  g_array_unref (p_val);
+  ncm_mset_func_free (func);
+}
+
+void
+test_ncm_mset_catalog_calc_ci_sketch (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcmMSetFunc *func = NCM_MSET_FUNC (ncm_mset_func_list_new ("NcHICosmo:E2Omega_c", NULL));
+  NcmVector *z_v    = ncm_vector_new (10);
+  GArray *p_val     = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  const gdouble p[] = {0.6827, 0.9545};
+  NcmMatrix *res_direct, *res_sketch;
+  guint i, j;
+
+  g_array_append_vals (p_val, p, G_N_ELEMENTS (p));
+  for (i = 0; i < ncm_vector_len (z_v); i++)
+    ncm_vector_set (z_v, i, 0.2 * i);
+
+  _test_ncm_mset_catalog_add_rows (test, test->nrows);
+
+  res_direct = ncm_mset_catalog_calc_ci_direct (test->mcat, func, z_v, p_val);
+  res_sketch = ncm_mset_catalog_calc_ci_sketch (test->mcat, func, z_v, p_val, NCM_STATS_QSKETCH_DEFAULT_COMPRESSION, NCM_FIT_RUN_MSGS_NONE);
+
+  for (i = 0; i < ncm_vector_len (z_v); i++)
+  {
+    const gdouble scale = ncm_matrix_get (res_direct, i, 4) - ncm_matrix_get (res_direct, i, 3);
+
+    ncm_assert_cmpdouble_e (ncm_matrix_get (res_sketch, i, 0), ==, ncm_matrix_get (res_direct, i, 0), 1.0e-10);
+    for (j = 1; j < 1 + 2 * p_val->len; j++)
+      g_assert_cmpfloat (fabs (ncm_matrix_get (res_sketch, i, j) - ncm_matrix_get (res_direct, i, j)), <, 2.0e-2 * scale);
+  }
+
+  ncm_matrix_free (res_direct);
+  ncm_matrix_free (res_sketch);
+  ncm_vector_free (z_v);
+  g_array_unref (p_val);
+  ncm_mset_func_free (func);
+}
+
+void
+test_ncm_mset_catalog_calc_distrib (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcmMSetFunc *func = NCM_MSET_FUNC (ncm_mset_func_list_new ("NcHICosmo:Omega_c0", NULL));
+  NcmStatsDist1d *sd1;
+  gdouble Oc_mean;
+
+  _test_ncm_mset_catalog_add_rows (test, test->nrows / 10);
+  Oc_mean = ncm_stats_vec_get_mean (test->mcat->pstats, test->mcat->nadd_vals + 0);
+
+  sd1 = ncm_mset_catalog_calc_distrib (test->mcat, func, NCM_FIT_RUN_MSGS_NONE);
+
+  ncm_assert_cmpdouble_e (ncm_stats_dist1d_epdf_get_obs_mean (NCM_STATS_DIST1D_EPDF (sd1)), ==, Oc_mean, 1.0e-10);
+
+  ncm_stats_dist1d_free (sd1);
+  ncm_mset_func_free (func);
+}
+
+void
+test_ncm_mset_catalog_traps (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+#if GLIB_CHECK_VERSION(2,38,0)
+  g_test_trap_subprocess ("/ncm/mset_catalog/invalid/calc/empty/subprocess", 0, 0);
+  g_test_trap_assert_failed ();
+#endif
+}
+
+void
+test_ncm_mset_catalog_invalid_calc_empty (TestNcmMSetCatalog *test, gconstpointer pdata)
+{
+  NcmMSetFunc *func = NCM_MSET_FUNC (ncm_mset_func_list_new ("NcHICosmo:E2Omega_c", NULL));
+  NcmVector *z_v    = ncm_vector_new (5);
+  GArray *p_val     = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  const gdouble p[] = {0.6827, 0.9545};
+
+  g_array_append_vals (p_val, p, G_N_ELEMENTS (p));
+  ncm_vector_set_all (z_v, 0.5);
+
+  /* No rows were added. */
+  ncm_matrix_free (ncm_mset_catalog_calc_ci_direct (test->mcat, func, z_v, p_val));
+
+  ncm_vector_free (z_v);
+  g_array_unref (p_val);
+  ncm_mset_func_free (func);
+}
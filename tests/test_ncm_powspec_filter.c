@@ -0,0 +1,191 @@
+/***************************************************************************
+ *            test_ncm_powspec_filter.c
+ *
+ *  Fri October 16 23:52:18 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+
+typedef struct _TestNcmPowspecFilter
+{
+  NcHICosmo *cosmo;
+  NcTransferFunc *tf;
+  NcPowspecML *ps_ml;
+  NcmPowspec *ps;
+  NcmPowspecFilter *psf;
+} TestNcmPowspecFilter;
+
+static void test_ncm_powspec_filter_ml_new (TestNcmPowspecFilter *test, gconstpointer pdata);
+static void test_ncm_powspec_filter_halofit_new (TestNcmPowspecFilter *test, gconstpointer pdata);
+static void test_ncm_powspec_filter_z_knots (TestNcmPowspecFilter *test, gconstpointer pdata);
+static void test_ncm_powspec_filter_free (TestNcmPowspecFilter *test, gconstpointer pdata);
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  /* Separable, a single transform rescaled by the growth function. */
+  g_test_add ("/ncm/powspec_filter/ml_transfer/z_knots", TestNcmPowspecFilter, NULL,
+              &test_ncm_powspec_filter_ml_new,
+              &test_ncm_powspec_filter_z_knots,
+              &test_ncm_powspec_filter_free);
+
+  /* Non-separable, all redshifts in a single batched transform. */
+  g_test_add ("/ncm/powspec_filter/halofit/z_knots", TestNcmPowspecFilter, NULL,
+              &test_ncm_powspec_filter_halofit_new,
+              &test_ncm_powspec_filter_z_knots,
+              &test_ncm_powspec_filter_free);
+
+  g_test_run ();
+}
+
+static void
+_test_ncm_powspec_filter_new (TestNcmPowspecFilter *test, NcmPowspec *ps)
+{
+  NcHIReion *reion = NC_HIREION (nc_hireion_camb_new ());
+  NcHIPrim *prim   = NC_HIPRIM (nc_hiprim_power_law_new ());
+
+  test->cosmo = nc_hicosmo_new_from_name (NC_TYPE_HICOSMO, "NcHICosmoDEXcdm");
+  test->ps    = ps;
+  test->psf   = ncm_powspec_filter_new (test->ps, NCM_POWSPEC_FILTER_TYPE_TOPHAT);
+
+  ncm_model_add_submodel (NCM_MODEL (test->cosmo), NCM_MODEL (reion));
+  ncm_model_add_submodel (NCM_MODEL (test->cosmo), NCM_MODEL (prim));
+
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "Omegac", g_test_rand_double_range (0.2, 0.3));
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "w", g_test_rand_double_range (-1.2, -0.8));
+
+#ifdef HAVE_FFTW3_THREADS
+  g_object_set (test->psf, "fft-nthreads", 2, NULL);
+  g_assert_cmpuint (ncm_fftlog_get_fft_nthreads (test->psf->fftlog), ==, 2);
+#endif /* HAVE_FFTW3_THREADS */
+
+  nc_hireion_free (reion);
+  nc_hiprim_free (prim);
+}
+
+static void
+test_ncm_powspec_filter_ml_new (TestNcmPowspecFilter *test, gconstpointer pdata)
+{
+  test->tf    = nc_transfer_func_new_from_name ("NcTransferFuncEH");
+  test->ps_ml = NC_POWSPEC_ML (nc_powspec_ml_transfer_new (test->tf));
+
+  _test_ncm_powspec_filter_new (test, ncm_powspec_ref (NCM_POWSPEC (test->ps_ml)));
+  g_assert (ncm_powspec_is_separable (test->ps));
+}
+
+static void
+test_ncm_powspec_filter_halofit_new (TestNcmPowspecFilter *test, gconstpointer pdata)
+{
+  test->tf    = nc_transfer_func_new_from_name ("NcTransferFuncEH");
+  test->ps_ml = NC_POWSPEC_ML (nc_powspec_ml_transfer_new (test->tf));
+
+  _test_ncm_powspec_filter_new (test, NCM_POWSPEC (nc_powspec_mnl_halofit_new (test->ps_ml, 3.0, 1.0e-3)));
+  g_assert (!ncm_powspec_is_separable (test->ps));
+}
+
+static void
+test_ncm_powspec_filter_free (TestNcmPowspecFilter *test, gconstpointer pdata)
+{
+  NCM_TEST_FREE (ncm_powspec_filter_free, test->psf);
+  NCM_TEST_FREE (ncm_powspec_free, test->ps);
+  NCM_TEST_FREE (nc_powspec_ml_free, test->ps_ml);
+  NCM_TEST_FREE (nc_transfer_func_free, test->tf);
+  NCM_TEST_FREE (nc_hicosmo_free, test->cosmo);
+}
+
+/*
+ * Compares the knots computed by ncm_powspec_filter_prepare() with
+ * one ncm_fftlog_eval_by_vector() per redshift knot.
+ */
+static void
+_test_ncm_powspec_filter_cmp_knots (TestNcmPowspecFilter *test)
+{
+  NcmFftlog *fftlog = test->psf->fftlog;
+  NcmVector *z_vec  = test->psf->var->yv;
+  const guint N_k   = ncm_fftlog_get_size (fftlog);
+  const guint N_z   = ncm_vector_len (z_vec);
+  NcmVector *k_vec  = ncm_vector_new (N_k);
+  NcmVector *Pk_vec = ncm_vector_new (N_k);
+  guint i, j;
+
+  g_assert_cmpuint (ncm_matrix_nrows (test->psf->var->zm), ==, N_z);
+  g_assert_cmpuint (ncm_matrix_ncols (test->psf->var->zm), ==, N_k);
+
+  ncm_fftlog_get_lnk_vector (fftlog, k_vec);
+  for (j = 0; j < N_k; j++)
+    ncm_vector_set (k_vec, j, exp (ncm_vector_get (k_vec, j)));
+
+  for (i = 0; i < N_z; i++)
+  {
+    NcmVector *var_i  = ncm_matrix_get_row (test->psf->var->zm, i);
+    NcmVector *dvar_i = ncm_matrix_get_row (test->psf->dvar->zm, i);
+    gdouble absmin, var_absmax, dvar_absmax;
+
+    ncm_powspec_eval_vec (test->ps, NCM_MODEL (test->cosmo), ncm_vector_get (z_vec, i), k_vec, Pk_vec);
+    for (j = 0; j < N_k; j++)
+    {
+      const gdouble k = ncm_vector_get (k_vec, j);
+      ncm_vector_set (Pk_vec, j, ncm_vector_get (Pk_vec, j) * k * k / (2.0 * M_PI * M_PI));
+    }
+
+    ncm_fftlog_eval_by_vector (fftlog, Pk_vec);
+
+    ncm_vector_get_absminmax (var_i, &absmin, &var_absmax);
+    ncm_vector_get_absminmax (dvar_i, &absmin, &dvar_absmax);
+
+    for (j = 0; j < N_k; j++)
+    {
+      g_assert_cmpfloat (fabs (ncm_vector_get (var_i, j) - ncm_vector_get (ncm_fftlog_peek_output_vector (fftlog, 0), j)), <=, 1.0e-10 * var_absmax);
+      g_assert_cmpfloat (fabs (ncm_vector_get (dvar_i, j) - ncm_vector_get (ncm_fftlog_peek_output_vector (fftlog, 1), j)), <=, 1.0e-10 * dvar_absmax);
+    }
+
+    ncm_vector_free (var_i);
+    ncm_vector_free (dvar_i);
+  }
+
+  ncm_vector_free (k_vec);
+  ncm_vector_free (Pk_vec);
+}
+
+static void
+test_ncm_powspec_filter_z_knots (TestNcmPowspecFilter *test, gconstpointer pdata)
+{
+  /* First prepare calibrates the knots. */
+  ncm_powspec_filter_prepare (test->psf, NCM_MODEL (test->cosmo));
+  _test_ncm_powspec_filter_cmp_knots (test);
+
+  /* Second prepare reuses the calibrated knots. */
+  ncm_model_param_set_by_name (NCM_MODEL (test->cosmo), "Omegac", g_test_rand_double_range (0.2, 0.3));
+  ncm_powspec_filter_prepare (test->psf, NCM_MODEL (test->cosmo));
+  _test_ncm_powspec_filter_cmp_knots (test);
+}
@@ -136,6 +136,8 @@ void test_ncm_spline_eval (TestNcmSpline *test, gconstpointer pdata);
 void test_ncm_spline_eval_deriv (TestNcmSpline *test, gconstpointer pdata);
 void test_ncm_spline_eval_deriv2 (TestNcmSpline *test, gconstpointer pdata);
 void test_ncm_spline_eval_int (TestNcmSpline *test, gconstpointer pdata);
+void test_ncm_spline_eval_vec (TestNcmSpline *test, gconstpointer pdata);
+void test_ncm_spline_get_index (TestNcmSpline *test, gconstpointer pdata);
 void test_ncm_spline_free_empty (TestNcmSpline *test, gconstpointer pdata);
 
 void test_ncm_spline_invalid_vector_sizes (TestNcmSpline *test, gconstpointer pdata);
@@ -182,6 +184,8 @@ TestNcmSplineFunc _test_ncm_spline_tests[] = {
   {&test_ncm_spline_eval_deriv,  "/eval/deriv"},
   {&test_ncm_spline_eval_deriv2, "/eval/deriv2"},
   {&test_ncm_spline_eval_int,    "/int"},
+  {&test_ncm_spline_eval_vec,    "/eval/vec"},
+  {&test_ncm_spline_get_index,   "/get_index"},
   {&test_ncm_spline_traps,       "/traps"},
   {NULL}
 };
@@ -773,6 +777,105 @@ test_ncm_spline_eval_int (TestNcmSpline *test, gconstpointer pdata)
   }
 }
 
+void
+test_ncm_spline_eval_vec (TestNcmSpline *test, gconstpointer pdata)
+{
+  const guint np = 3 * NCM_SPLINE_VEC_BLOCK + 7;
+  const gdouble xf = test->xi + (test->dx * (test->nknots - 1));
+  NcmSpline *s = ncm_spline_copy (test->s_base);
+  gdouble *xp = g_new (gdouble, np);
+  gdouble *x0 = g_new (gdouble, np);
+  gdouble *yp = g_new (gdouble, np);
+  gsl_function F;
+  guint i;
+  gdouble d[4];
+  d[0] = g_test_rand_double ();
+  d[1] = g_test_rand_double ();
+  d[2] = g_test_rand_double ();
+  d[3] = g_test_rand_double ();
+
+  F.function = &F_sin_poly;
+  F.params = d;
+  ncm_spline_set_func (s, NCM_SPLINE_FUNCTION_SPLINE, &F, test->xi, test->xi + (test->dx * (test->nknots - 1)) * _TEST_EPSILON, test->nknots, test->prec);
+
+  /* First half sorted, second half in random order. */
+  for (i = 0; i < np; i++)
+  {
+    if (i < np / 2)
+      xp[i] = test->xi + (xf - test->xi) * i / (np / 2.0);
+    else
+      xp[i] = g_test_rand_double_range (test->xi, xf);
+    x0[i] = g_test_rand_double_range (test->xi, xp[i]);
+  }
+
+  ncm_spline_eval_vec (s, xp, yp, np);
+  for (i = 0; i < np; i++)
+    ncm_assert_cmpdouble_e (yp[i], ==, ncm_spline_eval (s, xp[i]), 1.0e-15);
+
+  ncm_spline_eval_deriv_vec (s, xp, yp, np);
+  for (i = 0; i < np; i++)
+    ncm_assert_cmpdouble_e (yp[i], ==, ncm_spline_eval_deriv (s, xp[i]), 1.0e-15);
+
+  if (test->deriv2)
+  {
+    ncm_spline_eval_deriv2_vec (s, xp, yp, np);
+    for (i = 0; i < np; i++)
+      ncm_assert_cmpdouble_e (yp[i], ==, ncm_spline_eval_deriv2 (s, xp[i]), 1.0e-15);
+  }
+
+  ncm_spline_eval_integ_vec (s, x0, xp, yp, np);
+  for (i = 0; i < np; i++)
+    ncm_assert_cmpdouble_e (yp[i], ==, ncm_spline_eval_integ (s, x0[i], xp[i]), 1.0e-15);
+
+  ncm_spline_free (s);
+  g_free (xp);
+  g_free (x0);
+  g_free (yp);
+}
+
+void
+test_ncm_spline_get_index (TestNcmSpline *test, gconstpointer pdata)
+{
+  NcmVector *x = ncm_vector_new (test->nknots);
+  NcmVector *y = ncm_vector_new (test->nknots);
+  const gdouble *xa = ncm_vector_const_ptr (x, 0);
+  NcmSpline *s;
+  gdouble xl, xu;
+  gint i;
+
+  /* Strongly non-uniform knots, so that most buckets are empty or crowded. */
+  for (i = 0; i < test->nknots; i++)
+  {
+    const gdouble t = test->dx * i;
+    ncm_vector_set (x, i, test->xi + expm1 (10.0 * t));
+    ncm_vector_set (y, i, sin (t));
+  }
+
+  s = ncm_spline_new (test->s_base, x, y, TRUE);
+  g_assert (s->acc);
+
+  xl = ncm_vector_get (x, 0);
+  xu = ncm_vector_get (x, test->nknots - 1);
+
+  for (i = 0; i < test->nknots; i++)
+  {
+    const gdouble xk = ncm_vector_get (x, i);
+    g_assert_cmpuint (ncm_spline_get_index (s, xk), ==, gsl_interp_bsearch (xa, xk, 0, test->nknots - 1));
+  }
+
+  for (i = 0; i < 10 * test->nknots; i++)
+  {
+    const gdouble xr = g_test_rand_double_range (xl - 1.0, xu + 1.0);
+    g_assert_cmpuint (ncm_spline_get_index (s, xr), ==, gsl_interp_bsearch (xa, xr, 0, test->nknots - 1));
+  }
+
+  ncm_spline_acc (s, FALSE);
+  g_assert (!s->acc);
+  g_assert_cmpuint (s->bucket->len, ==, 0);
+
+  ncm_spline_free (s);
+}
+
 void
 test_ncm_spline_invalid_vector_sizes (TestNcmSpline *test, gconstpointer pdata)
 {
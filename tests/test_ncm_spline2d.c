@@ -156,6 +156,7 @@ void test_ncm_spline2d_new (void);
 void test_ncm_spline2d_copy_empty (void);
 void test_ncm_spline2d_copy (void);
 void test_ncm_spline2d_eval (void);
+void test_ncm_spline2d_eval_vec (void);
 void test_ncm_spline2d_eval_integ_dx (void);
 void test_ncm_spline2d_eval_integ_dy (void);
 void test_ncm_spline2d_eval_integ_dxdy (void);
@@ -179,6 +180,7 @@ main (gint argc, gchar *argv[])
   g_test_add_func ("/ncm/spline2d_bicubic/notaknot/copy_empty", &test_ncm_spline2d_copy_empty);
   g_test_add_func ("/ncm/spline2d_bicubic/notaknot/copy", &test_ncm_spline2d_copy);
   g_test_add_func ("/ncm/spline2d_bicubic/notaknot/eval", &test_ncm_spline2d_eval);
+  g_test_add_func ("/ncm/spline2d_bicubic/notaknot/eval_vec", &test_ncm_spline2d_eval_vec);
   g_test_add_func ("/ncm/spline2d_bicubic/notaknot/eval_integ_dx", &test_ncm_spline2d_eval_integ_dx);
   g_test_add_func ("/ncm/spline2d_bicubic/notaknot/eval_integ_dy", &test_ncm_spline2d_eval_integ_dy);
   g_test_add_func ("/ncm/spline2d_bicubic/notaknot/eval_integ_dxdy", &test_ncm_spline2d_eval_integ_dxdy);
@@ -190,6 +192,7 @@ main (gint argc, gchar *argv[])
   g_test_add_func ("/ncm/spline2d_gsl/cspline/copy_empty", &test_ncm_spline2d_copy_empty);
   g_test_add_func ("/ncm/spline2d_gsl/cspline/copy", &test_ncm_spline2d_copy);
   g_test_add_func ("/ncm/spline2d_gsl/cspline/eval", &test_ncm_spline2d_eval);
+  g_test_add_func ("/ncm/spline2d_gsl/cspline/eval_vec", &test_ncm_spline2d_eval_vec);
   g_test_add_func ("/ncm/spline2d_gsl/cspline/eval_integ_dx", &test_ncm_spline2d_eval_integ_dx);
   g_test_add_func ("/ncm/spline2d_gsl/cspline/eval_integ_dy", &test_ncm_spline2d_eval_integ_dy);
   g_test_add_func ("/ncm/spline2d_gsl/cspline/eval_integ_dxdy", &test_ncm_spline2d_eval_integ_dxdy);
@@ -200,6 +203,7 @@ main (gint argc, gchar *argv[])
   g_test_add_func ("/ncm/spline2d_spline/copy_empty", &test_ncm_spline2d_copy_empty);
   g_test_add_func ("/ncm/spline2d_spline/copy", &test_ncm_spline2d_copy);
   g_test_add_func ("/ncm/spline2d_spline/eval", &test_ncm_spline2d_eval);
+  g_test_add_func ("/ncm/spline2d_spline/eval_vec", &test_ncm_spline2d_eval_vec);
   g_test_add_func ("/ncm/spline2d_spline/eval_integ_dx", &test_ncm_spline2d_eval_integ_dx);
   g_test_add_func ("/ncm/spline2d_spline/eval_integ_dy", &test_ncm_spline2d_eval_integ_dy);
   g_test_add_func ("/ncm/spline2d_spline/eval_integ_dxdy", &test_ncm_spline2d_eval_integ_dxdy);
@@ -479,6 +483,72 @@ test_ncm_spline2d_eval (void)
 
 }
 
+void
+test_ncm_spline2d_eval_vec (void)
+{
+  const guint np = 3 * NCM_SPLINE_VEC_BLOCK + 7;
+  gdouble *xp = g_new (gdouble, np);
+  gdouble *yp = g_new (gdouble, np);
+  gdouble *zp = g_new (gdouble, np);
+  const gdouble xf = _NCM_SPLINE2D_TEST_XI + _NCM_SPLINE2D_TEST_DX * (_NCM_SPLINE2D_TEST_NKNOTS_X - 1.0);
+  const gdouble yf = _NCM_SPLINE2D_TEST_YI + _NCM_SPLINE2D_TEST_DY * (_NCM_SPLINE2D_TEST_NKNOTS_Y - 1.0);
+  NcmVector *xv = ncm_vector_new (_NCM_SPLINE2D_TEST_NKNOTS_X);
+  NcmVector *yv = ncm_vector_new (_NCM_SPLINE2D_TEST_NKNOTS_Y);
+  NcmMatrix *zm = ncm_matrix_new (_NCM_SPLINE2D_TEST_NKNOTS_Y, _NCM_SPLINE2D_TEST_NKNOTS_X);
+  NcmSpline2d *s2d = ncm_spline2d_new (s2d_base, xv, yv, zm, FALSE);
+  guint i, j;
+  gdouble d[5];
+  d[0] = g_test_rand_double ();
+  d[1] = g_test_rand_double ();
+  d[2] = g_test_rand_double ();
+  d[3] = g_test_rand_double ();
+  d[4] = g_test_rand_double ();
+
+  for (j = 0; j < _NCM_SPLINE2D_TEST_NKNOTS_Y; j++)
+  {
+    gdouble y = _NCM_SPLINE2D_TEST_YI + _NCM_SPLINE2D_TEST_DY * j;
+    ncm_vector_set (s2d->yv, j, y);
+    for (i = 0; i < _NCM_SPLINE2D_TEST_NKNOTS_X; i++)
+    {
+      gdouble x = _NCM_SPLINE2D_TEST_XI + _NCM_SPLINE2D_TEST_DX * i;
+      ncm_vector_set (s2d->xv, i, x);
+      ncm_matrix_set (s2d->zm, j, i, F_poly (x, y, d));
+    }
+  }
+
+  ncm_spline2d_prepare (s2d);
+
+  /* First half sorted in x, second half in random order. */
+  for (i = 0; i < np; i++)
+  {
+    if (i < np / 2)
+      xp[i] = _NCM_SPLINE2D_TEST_XI + (xf - _NCM_SPLINE2D_TEST_XI) * i / (np / 2.0);
+    else
+      xp[i] = g_test_rand_double_range (_NCM_SPLINE2D_TEST_XI, xf);
+    yp[i] = g_test_rand_double_range (_NCM_SPLINE2D_TEST_YI, yf);
+  }
+
+  ncm_spline2d_eval_vec (s2d, xp, yp, zp, np);
+  for (i = 0; i < np; i++)
+    ncm_assert_cmpdouble_e (zp[i], ==, ncm_spline2d_eval (s2d, xp[i], yp[i]), 1.0e-15);
+
+  if (NCM_IS_SPLINE2D_BICUBIC (s2d))
+  {
+    ncm_spline2d_deriv_dzdx_vec (s2d, xp, yp, zp, np);
+    for (i = 0; i < np; i++)
+      ncm_assert_cmpdouble_e (zp[i], ==, ncm_spline2d_deriv_dzdx (s2d, xp[i], yp[i]), 1.0e-15);
+
+    ncm_spline2d_deriv_dzdy_vec (s2d, xp, yp, zp, np);
+    for (i = 0; i < np; i++)
+      ncm_assert_cmpdouble_e (zp[i], ==, ncm_spline2d_deriv_dzdy (s2d, xp[i], yp[i]), 1.0e-15);
+  }
+
+  ncm_spline2d_free (s2d);
+  g_free (xp);
+  g_free (yp);
+  g_free (zp);
+}
+
 void
 test_ncm_spline2d_eval_integ_dx (void)
 {
@@ -0,0 +1,295 @@
+/***************************************************************************
+ *            test_ncm_stats_qsketch.c
+ *
+ *  Thu October 15 18:21:07 2026
+ *  Copyright  2026  Sandro Dias Pinto Vitenti
+ *  <sandro@isoftware.com.br>
+ ****************************************************************************/
+/*
+ * numcosmo
+ * Copyright (C) Sandro Dias Pinto Vitenti 2026 <sandro@isoftware.com.br>
+ * numcosmo is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * numcosmo is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#undef GSL_RANGE_CHECK_OFF
+#endif /* HAVE_CONFIG_H */
+#include <numcosmo/numcosmo.h>
+
+#include <math.h>
+#include <glib.h>
+#include <glib-object.h>
+#include <gsl/gsl_sort.h>
+
+typedef struct _TestNcmStatsQSketch
+{
+  NcmStatsQSketch *qs;
+  NcmRNG *rng;
+  GArray *data;
+  guint ntest;
+} TestNcmStatsQSketch;
+
+static void test_ncm_stats_qsketch_new (TestNcmStatsQSketch *test, gconstpointer pdata);
+static void test_ncm_stats_qsketch_gauss (TestNcmStatsQSketch *test, gconstpointer pdata);
+static void test_ncm_stats_qsketch_merge (TestNcmStatsQSketch *test, gconstpointer pdata);
+static void test_ncm_stats_qsketch_weight (TestNcmStatsQSketch *test, gconstpointer pdata);
+static void test_ncm_stats_qsketch_stats_vec (TestNcmStatsQSketch *test, gconstpointer pdata);
+static void test_ncm_stats_qsketch_free (TestNcmStatsQSketch *test, gconstpointer pdata);
+
+static const gdouble _test_p[] = {1.0e-3, 1.0e-2, 0.02275, 0.15865, 0.5, 0.84135, 0.97725, 0.99, 0.999};
+
+gint
+main (gint argc, gchar *argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+  ncm_cfg_init ();
+  ncm_cfg_enable_gsl_err_handler ();
+
+  g_test_add ("/ncm/stats_qsketch/gauss", TestNcmStatsQSketch, NULL,
+              &test_ncm_stats_qsketch_new,
+              &test_ncm_stats_qsketch_gauss,
+              &test_ncm_stats_qsketch_free);
+
+  g_test_add ("/ncm/stats_qsketch/merge", TestNcmStatsQSketch, NULL,
+              &test_ncm_stats_qsketch_new,
+              &test_ncm_stats_qsketch_merge,
+              &test_ncm_stats_qsketch_free);
+
+  g_test_add ("/ncm/stats_qsketch/weight", TestNcmStatsQSketch, NULL,
+              &test_ncm_stats_qsketch_new,
+              &test_ncm_stats_qsketch_weight,
+              &test_ncm_stats_qsketch_free);
+
+  g_test_add ("/ncm/stats_qsketch/stats_vec", TestNcmStatsQSketch, NULL,
+              &test_ncm_stats_qsketch_new,
+              &test_ncm_stats_qsketch_stats_vec,
+              &test_ncm_stats_qsketch_free);
+
+  g_test_run ();
+}
+
+static void
+test_ncm_stats_qsketch_new (TestNcmStatsQSketch *test, gconstpointer pdata)
+{
+  test->qs    = ncm_stats_qsketch_new (NCM_STATS_QSKETCH_DEFAULT_COMPRESSION);
+  test->rng   = ncm_rng_seeded_new (NULL, g_test_rand_int ());
+  test->data  = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  test->ntest = 50000 + g_test_rand_int_range (0, 50000);
+}
+
+static void
+test_ncm_stats_qsketch_free (TestNcmStatsQSketch *test, gconstpointer pdata)
+{
+  ncm_stats_qsketch_free (test->qs);
+  ncm_rng_free (test->rng);
+  g_array_unref (test->data);
+}
+
+/* Fraction of the sorted samples smaller than x. */
+static gdouble
+_test_ncm_stats_qsketch_rank (GArray *data, const gdouble x)
+{
+  const gdouble *d = (const gdouble *) data->data;
+  guint lo         = 0;
+  guint hi         = data->len;
+
+  while (lo < hi)
+  {
+    const guint mid = (lo + hi) / 2;
+
+    if (d[mid] < x)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo / (1.0 * data->len);
+}
+
+static void
+_test_ncm_stats_qsketch_gen (TestNcmStatsQSketch *test, const guint n)
+{
+  guint i;
+
+  for (i = 0; i < n; i++)
+  {
+    const gdouble x = ncm_rng_gaussian_gen (test->rng, 0.0, 1.0) + ((i % 3 == 0) ? ncm_rng_uniform_gen (test->rng, 0.0, 5.0) : 0.0);
+    g_array_append_val (test->data, x);
+  }
+}
+
+static void
+_test_ncm_stats_qsketch_check (TestNcmStatsQSketch *test, NcmStatsQSketch *qs)
+{
+  guint i;
+
+  gsl_sort ((gdouble *) test->data->data, 1, test->data->len);
+
+  g_assert_cmpuint (ncm_stats_qsketch_get_n (qs), ==, test->data->len);
+  g_assert_cmpuint (ncm_stats_qsketch_get_ncentroids (qs), <=, 2 * ncm_stats_qsketch_get_compression (qs));
+  g_assert_cmpfloat (ncm_stats_qsketch_get_min (qs), ==, g_array_index (test->data, gdouble, 0));
+  g_assert_cmpfloat (ncm_stats_qsketch_get_max (qs), ==, g_array_index (test->data, gdouble, test->data->len - 1));
+
+  for (i = 0; i < G_N_ELEMENTS (_test_p); i++)
+  {
+    const gdouble p    = _test_p[i];
+    const gdouble q    = ncm_stats_qsketch_get_quantile (qs, p);
+    const gdouble rank = _test_ncm_stats_qsketch_rank (test->data, q);
+
+    /* The rank error of the merging t-digest is smaller close to the tails. */
+    g_assert_cmpfloat (fabs (rank - p), <, 2.0e-3 + 2.0e-2 * p * (1.0 - p));
+    ncm_assert_cmpdouble_e (ncm_stats_qsketch_get_cdf (qs, q), ==, p, 1.0e-7);
+  }
+}
+
+static void
+test_ncm_stats_qsketch_gauss (TestNcmStatsQSketch *test, gconstpointer pdata)
+{
+  gdouble mean = 0.0;
+  guint i;
+
+  g_assert (gsl_isnan (ncm_stats_qsketch_get_quantile (test->qs, 0.5)));
+
+  _test_ncm_stats_qsketch_gen (test, test->ntest);
+
+  for (i = 0; i < test->data->len; i++)
+  {
+    const gdouble x = g_array_index (test->data, gdouble, i);
+    ncm_stats_qsketch_add (test->qs, x);
+    mean += x;
+  }
+  mean /= test->data->len;
+
+  ncm_assert_cmpdouble_e (ncm_stats_qsketch_get_mean (test->qs), ==, mean, 1.0e-10);
+  _test_ncm_stats_qsketch_check (test, test->qs);
+
+  /* Incremental updates after the sketch was queried. */
+  {
+    const guint len0 = test->data->len;
+
+    _test_ncm_stats_qsketch_gen (test, test->ntest);
+
+    for (i = len0; i < test->data->len; i++)
+      ncm_stats_qsketch_add (test->qs, g_array_index (test->data, gdouble, i));
+
+    _test_ncm_stats_qsketch_check (test, test->qs);
+  }
+
+  ncm_stats_qsketch_reset (test->qs);
+  g_assert_cmpuint (ncm_stats_qsketch_get_n (test->qs), ==, 0);
+}
+
+static void
+test_ncm_stats_qsketch_merge (TestNcmStatsQSketch *test, gconstpointer pdata)
+{
+  const guint nparts = 2 + g_test_rand_int_range (0, 14);
+  GPtrArray *qs_a    = g_ptr_array_new_with_free_func ((GDestroyNotify) ncm_stats_qsketch_free);
+  guint i;
+
+  for (i = 0; i < nparts; i++)
+    g_ptr_array_add (qs_a, ncm_stats_qsketch_new (NCM_STATS_QSKETCH_DEFAULT_COMPRESSION));
+
+  _test_ncm_stats_qsketch_gen (test, test->ntest);
+
+  /* Uneven parts, as in different threads or chains. */
+  for (i = 0; i < test->data->len; i++)
+  {
+    const guint part = g_test_rand_int_range (0, nparts);
+    ncm_stats_qsketch_add (g_ptr_array_index (qs_a, part), g_array_index (test->data, gdouble, i));
+  }
+
+  for (i = 0; i < nparts; i++)
+  {
+    NcmStatsQSketch *qs_i = g_ptr_array_index (qs_a, i);
+    gulong n_i            = ncm_stats_qsketch_get_n (qs_i);
+
+    ncm_stats_qsketch_merge (test->qs, qs_i);
+    g_assert_cmpuint (ncm_stats_qsketch_get_n (qs_i), ==, n_i);
+  }
+
+  _test_ncm_stats_qsketch_check (test, test->qs);
+
+  {
+    NcmStatsQSketch *qs_dup = ncm_stats_qsketch_dup (test->qs);
+
+    for (i = 0; i < G_N_ELEMENTS (_test_p); i++)
+      g_assert_cmpfloat (ncm_stats_qsketch_get_quantile (qs_dup, _test_p[i]), ==, ncm_stats_qsketch_get_quantile (test->qs, _test_p[i]));
+
+    ncm_stats_qsketch_free (qs_dup);
+  }
+
+  g_ptr_array_unref (qs_a);
+}
+
+static void
+test_ncm_stats_qsketch_weight (TestNcmStatsQSketch *test, gconstpointer pdata)
+{
+  NcmStatsQSketch *qs_w = ncm_stats_qsketch_new (NCM_STATS_QSKETCH_DEFAULT_COMPRESSION);
+  guint i;
+
+  _test_ncm_stats_qsketch_gen (test, test->ntest);
+
+  /* A sample with weight 3 is equivalent to three repeated samples. */
+  for (i = 0; i < test->data->len; i++)
+  {
+    const gdouble x = g_array_index (test->data, gdouble, i);
+
+    ncm_stats_qsketch_add_weight (qs_w, x, 3.0);
+    ncm_stats_qsketch_add (test->qs, x);
+    ncm_stats_qsketch_add (test->qs, x);
+    ncm_stats_qsketch_add (test->qs, x);
+  }
+
+  ncm_assert_cmpdouble_e (ncm_stats_qsketch_get_weight (qs_w), ==, ncm_stats_qsketch_get_weight (test->qs), 1.0e-15);
+  ncm_assert_cmpdouble_e (ncm_stats_qsketch_get_mean (qs_w), ==, ncm_stats_qsketch_get_mean (test->qs), 1.0e-10);
+  _test_ncm_stats_qsketch_check (test, qs_w);
+
+  ncm_stats_qsketch_free (qs_w);
+}
+
+static void
+test_ncm_stats_qsketch_stats_vec (TestNcmStatsQSketch *test, gconstpointer pdata)
+{
+  NcmStatsVec *svec = ncm_stats_vec_new (2, NCM_STATS_VEC_VAR, FALSE);
+  guint i;
+
+  ncm_stats_vec_enable_qsketch (svec, NCM_STATS_QSKETCH_DEFAULT_COMPRESSION);
+
+  _test_ncm_stats_qsketch_gen (test, test->ntest);
+
+  for (i = 0; i < test->data->len; i++)
+  {
+    const gdouble x = g_array_index (test->data, gdouble, i);
+
+    ncm_stats_vec_set (svec, 0, x);
+    ncm_stats_vec_set (svec, 1, 2.0 * x + 1.0);
+    ncm_stats_vec_update (svec);
+  }
+
+  _test_ncm_stats_qsketch_check (test, ncm_stats_vec_peek_qsketch (svec, 0));
+
+  for (i = 0; i < G_N_ELEMENTS (_test_p); i++)
+  {
+    const gdouble q0 = ncm_stats_vec_get_qsketch_quantile (svec, 0, _test_p[i]);
+    const gdouble q1 = ncm_stats_vec_get_qsketch_quantile (svec, 1, _test_p[i]);
+
+    g_assert_cmpfloat (fabs (q1 - (2.0 * q0 + 1.0)), <, 1.0e-10 * (1.0 + fabs (q1)));
+  }
+
+  ncm_stats_vec_reset (svec, TRUE);
+  g_assert_cmpuint (ncm_stats_qsketch_get_n (ncm_stats_vec_peek_qsketch (svec, 0)), ==, 0);
+
+  ncm_stats_vec_free (svec);
+}
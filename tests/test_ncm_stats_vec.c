@@ -60,6 +60,8 @@ void test_ncm_stats_vec_var_test (TestNcmStatsVec *test, gconstpointer pdata);
 void test_ncm_stats_vec_cov_test (TestNcmStatsVec *test, gconstpointer pdata);
 void test_ncm_stats_vec_autocorr_test (TestNcmStatsVec *test, gconstpointer pdata);
 void test_ncm_stats_vec_subsample_autocorr_test (TestNcmStatsVec *test, gconstpointer pdata);
+void test_ncm_stats_vec_autocorr_all_test (TestNcmStatsVec *test, gconstpointer pdata);
+void test_ncm_stats_vec_online_diag_test (TestNcmStatsVec *test, gconstpointer pdata);
 void test_ncm_stats_vec_free (TestNcmStatsVec *test, gconstpointer pdata);
 
 void test_ncm_stats_vec_traps (TestNcmStatsVec *test, gconstpointer pdata);
@@ -95,6 +97,14 @@ main (gint argc, gchar *argv[])
               &test_ncm_stats_vec_autocorr_new, 
               &test_ncm_stats_vec_subsample_autocorr_test, 
               &test_ncm_stats_vec_free);
+  g_test_add ("/ncm/stats_vec/autocorr/all", TestNcmStatsVec, NULL, 
+              &test_ncm_stats_vec_autocorr_new, 
+              &test_ncm_stats_vec_autocorr_all_test, 
+              &test_ncm_stats_vec_free);
+  g_test_add ("/ncm/stats_vec/online_diag", TestNcmStatsVec, NULL, 
+              &test_ncm_stats_vec_autocorr_new, 
+              &test_ncm_stats_vec_online_diag_test, 
+              &test_ncm_stats_vec_free);
   
 #if GLIB_CHECK_VERSION(2,38,0)
   g_test_add ("/ncm/stats_vec/mean/get_var/subprocess", TestNcmStatsVec, NULL, 
@@ -455,6 +465,133 @@ test_ncm_stats_vec_subsample_autocorr_test (TestNcmStatsVec *test, gconstpointer
   ncm_matrix_free (last);
 }
 
+void
+test_ncm_stats_vec_autocorr_all_test (TestNcmStatsVec *test, gconstpointer pdata)
+{
+  NcmRNG *rng         = ncm_rng_pool_get ("test_ncm_stats_vec");
+  const gdouble a     = 0.9 + fabs (g_test_rand_double ()) * 1.0e-2;
+  const gdouble sigma = fabs (g_test_rand_double ()) * 1.0e-1;
+  const guint nitens  = test->ntests / 100;
+  const guint nchains = g_test_rand_int_range (10, 20);
+  NcmVector *last     = ncm_vector_new (test->v_size);
+  NcmVector *spec0    = ncm_vector_new (test->v_size);
+  GArray *c_order     = g_array_new (FALSE, FALSE, sizeof (guint));
+  NcmVector *tau_all, *stau_all, *ess_all;
+  guint i;
+
+  for (i = 0; i < test->v_size; i++)
+  {
+    ncm_vector_set (test->mu, i, 1.0 + fabs (g_test_rand_double ()));
+    ncm_vector_set (last, i, 0.0);
+  }
+
+  for (i = 0; i < nitens; i++)
+  {  
+    guint j;
+    for (j = 0; j < test->v_size; j++)
+    {
+      const gdouble epsilon_j = ncm_vector_get (test->mu, j) + sigma * gsl_ran_ugaussian (rng->r);
+      const gdouble x_j       = (a * ncm_vector_get (last, j) + epsilon_j);
+
+      ncm_vector_set (last, j, x_j);
+      ncm_stats_vec_set (test->svec, j, x_j);
+    }
+    ncm_stats_vec_update (test->svec);
+  }
+
+  tau_all  = ncm_stats_vec_get_autocorr_tau_all (test->svec, 0);
+  stau_all = ncm_stats_vec_get_subsample_autocorr_tau_all (test->svec, nchains, 0);
+  ess_all  = ncm_stats_vec_ar_ess_all (test->svec, NCM_STATS_VEC_AR_AICC, spec0, c_order);
+
+  g_assert_cmpuint (c_order->len, ==, test->v_size);
+
+  for (i = 0; i < test->v_size; i++)
+  {
+    const gdouble tau  = ncm_stats_vec_get_autocorr_tau (test->svec, i, 0);
+    const gdouble stau = ncm_stats_vec_get_subsample_autocorr_tau (test->svec, i, nchains, 0);
+    gdouble spec0_i    = 0.0;
+    guint c_order_i    = 0;
+    const gdouble ess  = ncm_stats_vec_ar_ess (test->svec, i, NCM_STATS_VEC_AR_AICC, &spec0_i, &c_order_i);
+
+    ncm_assert_cmpdouble_e (ncm_vector_get (tau_all, i), ==, tau, _TEST_NCM_STATS_VEC_PREC);
+    ncm_assert_cmpdouble_e (ncm_vector_get (stau_all, i), ==, stau, _TEST_NCM_STATS_VEC_PREC);
+    ncm_assert_cmpdouble_e (ncm_vector_get (ess_all, i), ==, ess, _TEST_NCM_STATS_VEC_PREC);
+    ncm_assert_cmpdouble_e (ncm_vector_get (spec0, i), ==, spec0_i, _TEST_NCM_STATS_VEC_PREC);
+    g_assert_cmpuint (g_array_index (c_order, guint, i), ==, c_order_i);
+  }
+
+  ncm_vector_free (tau_all);
+  ncm_vector_free (stau_all);
+  ncm_vector_free (ess_all);
+  ncm_vector_free (spec0);
+  ncm_vector_free (last);
+  g_array_unref (c_order);
+}
+
+void
+test_ncm_stats_vec_online_diag_test (TestNcmStatsVec *test, gconstpointer pdata)
+{
+  NcmRNG *rng         = ncm_rng_pool_get ("test_ncm_stats_vec");
+  const gdouble a     = 0.5 + fabs (g_test_rand_double ()) * 1.0e-1;
+  const gdouble sigma = 0.1 + fabs (g_test_rand_double ()) * 1.0e-1;
+  const gdouble tau_a = (1.0 + a) / (1.0 - a);
+  const guint nitens  = test->ntests / 10;
+  NcmVector *last     = ncm_vector_new (test->v_size);
+  guint i;
+
+  ncm_stats_vec_enable_online_diag (test->svec, 0, 256);
+  g_assert (ncm_stats_vec_online_diag_enabled (test->svec));
+
+  for (i = 0; i < test->v_size; i++)
+  {
+    ncm_vector_set (test->mu, i, 1.0 + fabs (g_test_rand_double ()));
+    ncm_vector_set (last, i, 0.0);
+  }
+
+  for (i = 0; i < nitens; i++)
+  {  
+    guint j;
+    for (j = 0; j < test->v_size; j++)
+    {
+      const gdouble epsilon_j = ncm_vector_get (test->mu, j) + sigma * gsl_ran_ugaussian (rng->r);
+      const gdouble x_j       = (a * ncm_vector_get (last, j) + epsilon_j);
+
+      ncm_vector_set (last, j, x_j);
+      ncm_stats_vec_set (test->svec, j, x_j);
+    }
+    ncm_stats_vec_update (test->svec);
+  }
+
+  for (i = 0; i < test->v_size; i++)
+  {
+    const gdouble acor_tau = ncm_stats_vec_get_online_autocorr_tau (test->svec, i);
+    const gdouble bm_tau   = ncm_stats_vec_get_online_bm_tau (test->svec, i);
+
+    ncm_assert_cmpdouble_e (acor_tau, ==, tau_a, 2.0e-1);
+    ncm_assert_cmpdouble_e (bm_tau, ==, tau_a, 5.0e-1);
+    ncm_assert_cmpdouble_e (ncm_stats_vec_get_online_bm_var (test->svec, i), ==, bm_tau * ncm_stats_vec_get_var (test->svec, i), 1.0e-3);
+  }
+
+  /* Enabling after the fact must replay the saved rows. */
+  {
+    const gdouble acor_tau0 = ncm_stats_vec_get_online_autocorr_tau (test->svec, 0);
+    const gdouble bm_tau0   = ncm_stats_vec_get_online_bm_tau (test->svec, 0);
+
+    ncm_stats_vec_disable_online_diag (test->svec);
+    g_assert (!ncm_stats_vec_online_diag_enabled (test->svec));
+    ncm_stats_vec_enable_online_diag (test->svec, 0, 256);
+
+    ncm_assert_cmpdouble_e (ncm_stats_vec_get_online_autocorr_tau (test->svec, 0), ==, acor_tau0, _TEST_NCM_STATS_VEC_PREC);
+    ncm_assert_cmpdouble_e (ncm_stats_vec_get_online_bm_tau (test->svec, 0), ==, bm_tau0, _TEST_NCM_STATS_VEC_PREC);
+  }
+
+  ncm_stats_vec_reset (test->svec, TRUE);
+  g_assert (ncm_stats_vec_online_diag_enabled (test->svec));
+  g_assert_cmpfloat (ncm_stats_vec_get_online_autocorr_tau (test->svec, 0), ==, 1.0);
+
+  ncm_vector_free (last);
+}
+
 void
 test_ncm_stats_vec_invalid_get_var (TestNcmStatsVec *test, gconstpointer pdata)
 {
@@ -60,6 +60,7 @@ void test_ncm_vector_data_const_free (TestNcmVector *test, gconstpointer pdata);
 void test_ncm_vector_sanity (TestNcmVector *test, gconstpointer pdata);
 void test_ncm_vector_operations (TestNcmVector *test, gconstpointer pdata);
 void test_ncm_vector_subvector (TestNcmVector *test, gconstpointer pdata);
+void test_ncm_vector_subvector_view (TestNcmVector *test, gconstpointer pdata);
 void test_ncm_vector_variant (TestNcmVector *test, gconstpointer pdata);
 void test_ncm_vector_serialization (TestNcmVector *test, gconstpointer pdata);
 void test_ncm_vector_data_const_sanity (TestNcmVector *test, gconstpointer pdata);
@@ -88,6 +89,11 @@ main (gint argc, gchar *argv[])
               &test_ncm_vector_subvector,
               &test_ncm_vector_free);
 
+  g_test_add ("/ncm/vector/default/subvector_view", TestNcmVector, NULL, 
+              &test_ncm_vector_new, 
+              &test_ncm_vector_subvector_view,
+              &test_ncm_vector_free);
+
   g_test_add ("/ncm/vector/default/variant", TestNcmVector, NULL, 
               &test_ncm_vector_new, 
               &test_ncm_vector_variant,
@@ -566,6 +572,65 @@ test_ncm_vector_subvector (TestNcmVector *test, gconstpointer pdata)
   NCM_TEST_FREE (ncm_vector_free, sv);
 }
 
+void
+test_ncm_vector_subvector_view (TestNcmVector *test, gconstpointer pdata)
+{
+  guint v_size       = test->v_size;
+  NcmVector *v       = test->v;
+  NcmVectorView view = ncm_vector_get_subvector_view (v, 1, v_size - 1);
+  NcmVector *sv      = ncm_vector_new_view (&view);
+  guint ntests       = 20 * v_size;
+
+  g_assert_cmpuint (ncm_vector_view_len (&view), ==, (v_size - 1));
+  g_assert_cmpuint (ncm_vector_len (sv), ==, (v_size - 1));
+
+  while (ntests--)
+  {
+    guint i = g_test_rand_int_range (0, v_size - 1);
+    ncm_vector_view_set (&view, i, g_test_rand_double ());
+    ncm_assert_cmpdouble (ncm_vector_view_get (&view, i), ==, ncm_vector_get (v, i + 1));
+    ncm_assert_cmpdouble (ncm_vector_get (sv, i), ==, ncm_vector_get (v, i + 1));
+    g_assert (ncm_vector_view_ptr (&view, i) == ncm_vector_ptr (v, i + 1));
+  }
+
+  {
+    NcmMatrix *m = ncm_matrix_new (3, v_size);
+    guint i, j;
+
+    for (i = 0; i < 3; i++)
+    {
+      for (j = 0; j < v_size; j++)
+        ncm_matrix_set (m, i, j, g_test_rand_double ());
+    }
+
+    for (i = 0; i < 3; i++)
+    {
+      NcmVectorView row = ncm_matrix_get_row_view (m, i);
+
+      ncm_vector_set_view (sv, &row);
+      g_assert_cmpuint (ncm_vector_len (sv), ==, v_size);
+
+      for (j = 0; j < v_size; j++)
+        ncm_assert_cmpdouble (ncm_vector_get (sv, j), ==, ncm_matrix_get (m, i, j));
+    }
+
+    for (j = 0; j < v_size; j++)
+    {
+      NcmVectorView col = ncm_matrix_get_col_view (m, j);
+
+      ncm_vector_set_view (sv, &col);
+      g_assert_cmpuint (ncm_vector_len (sv), ==, 3);
+
+      for (i = 0; i < 3; i++)
+        ncm_assert_cmpdouble (ncm_vector_get (sv, i), ==, ncm_matrix_get (m, i, j));
+    }
+
+    ncm_matrix_free (m);
+  }
+
+  NCM_TEST_FREE (ncm_vector_free, sv);
+}
+
 void
 test_ncm_vector_variant (TestNcmVector *test, gconstpointer pdata)
 {
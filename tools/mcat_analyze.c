@@ -88,6 +88,7 @@ main (gint argc, gchar *argv[])
   gboolean list_dist      = FALSE;
   gboolean list_dist_z    = FALSE;
   gboolean use_direct     = FALSE;
+  gboolean use_sketch     = FALSE;
   gboolean dump           = FALSE;
   gint dump_chain         = -1;
   gint trim               = -1;
@@ -96,6 +97,7 @@ main (gint argc, gchar *argv[])
   gint nsteps = 100;
   gint burnin = 0;
   gint ntests = 100;
+  gint nthreads = 0;
   gchar **funcs          = NULL;
   gchar **distribs       = NULL;
   gchar **params         = NULL;
@@ -124,6 +126,7 @@ main (gint argc, gchar *argv[])
     { "list-dist",        0, 0, G_OPTION_ARG_NONE,         &list_dist,      "Print available constant functions from NcDistance.", NULL },
     { "list-dist-z",      0, 0, G_OPTION_ARG_NONE,         &list_dist_z,    "Print available redshift functions from NcDistance.", NULL },
     { "use-direct",       0, 0, G_OPTION_ARG_NONE,         &use_direct,     "Whether to use the direct quantile algorithm (much more memory intensive but faster for small samples).", NULL },
+    { "use-sketch",       0, 0, G_OPTION_ARG_NONE,         &use_sketch,     "Whether to use streaming quantile sketches (bounded memory, mergeable across threads).", NULL },
     { "burn-in",        'b', 0, G_OPTION_ARG_INT,          &burnin,         "Burn-in size (default 0).", NULL },
     { "zi",               0, 0, G_OPTION_ARG_DOUBLE,       &zi,             "Initial redshift (default 0).", NULL },
     { "zf",               0, 0, G_OPTION_ARG_DOUBLE,       &zf,             "Final redshift (default 1).", NULL },
@@ -140,6 +143,7 @@ main (gint argc, gchar *argv[])
     { "dump",           'D', 0, G_OPTION_ARG_NONE,         &dump,           "Print all chains interweaved.", NULL },
     { "dump-chain",       0, 0, G_OPTION_ARG_INT,          &dump_chain,     "Print all points from the N-th chain.", "N"},
     { "trim",           't', 0, G_OPTION_ARG_INT,          &trim,           "Trim the catalog at T.", "T" },
+    { "nthreads",         0, 0, G_OPTION_ARG_INT,          &nthreads,       "Number of threads used to evaluate the functions and the autocorrelation FFTs (default: all cores for the functions, one for the FFTs).", "N" },
     { NULL }
   };
 
@@ -157,6 +161,9 @@ main (gint argc, gchar *argv[])
     exit (1);
   }
 
+  if (nthreads > 0)
+    ncm_func_eval_set_max_threads (nthreads);
+
   if (list_hicosmo || list_all)
   {
     GArray *func_table = ncm_mset_func_list_select ("NcHICosmo", 0, 1); 
@@ -223,6 +230,9 @@ main (gint argc, gchar *argv[])
     NcmMSetCatalog *mcat = ncm_mset_catalog_new_from_file_ro (cat_filename, burnin);
     NcmMSet *mset = ncm_mset_catalog_get_mset (mcat);
 
+    if (nthreads > 0)
+      ncm_mset_catalog_set_fft_nthreads (mcat, nthreads);
+
     if (auto_trim)
     {
       ncm_mset_catalog_trim_by_type (mcat, ntests, NCM_MSET_CATALOG_TRIM_TYPE_ESS, NCM_FIT_RUN_MSGS_FULL);
@@ -366,6 +376,8 @@ main (gint argc, gchar *argv[])
 
         if (use_direct)
           res = ncm_mset_catalog_calc_ci_direct (mcat, mset_func, z_vec, p_val);
+        else if (use_sketch)
+          res = ncm_mset_catalog_calc_ci_sketch (mcat, mset_func, z_vec, p_val, NCM_STATS_QSKETCH_DEFAULT_COMPRESSION, NCM_FIT_RUN_MSGS_SIMPLE);
         else
           res = ncm_mset_catalog_calc_ci_interp (mcat, mset_func, z_vec, p_val, 100, NCM_FIT_RUN_MSGS_SIMPLE);
 